@@ -44,6 +44,8 @@ template <typename ElemType>
 void DoEdit(const ConfigParameters& config);
 template <typename ElemType>
 void DoBatchNormalizationStat(const ConfigParameters& config);
+template <typename ElemType>
+void DoInt8Quantization(const ConfigParameters& config);
 
 // evaluation (EvalActions.cpp)
 template <typename ElemType>
@@ -27,6 +27,8 @@
 #include "BrainScriptEvaluator.h"
 #include "BrainScriptParser.h"
 #include "PostComputingActions.h"
+#include "DataReaderHelpers.h"
+#include "LinearAlgebraNodes.h"
 
 #include <string>
 #include <chrono>
@@ -310,3 +312,109 @@ void DoBatchNormalizationStat(const ConfigParameters& config)
 template void DoBatchNormalizationStat<double>(const ConfigParameters& config);
 template void DoBatchNormalizationStat<float>(const ConfigParameters& config);
 
+// ===========================================================================
+// DoInt8Quantization() - implements CNTK "quantize" command
+// ===========================================================================
+
+// Times the forward passes of the eval nodes over up to 'iters' minibatches, in milliseconds, sorted.
+template <typename ElemType>
+static vector<double> MeasureForwardLatency(ComputationNetworkPtr net, IDataReader* dataReader, const vector<ComputationNodeBasePtr>& evalNodes, size_t mbSize, int iters)
+{
+    ScopedNetworkOperationMode modeGuard(net, NetworkOperationMode::inferring);
+    net->AllocateAllMatrices(evalNodes, vector<ComputationNodeBasePtr>(), nullptr);
+
+    auto& featureNodes = net->FeatureNodes();
+    StreamMinibatchInputs inputMatrices;
+    for (auto& node : featureNodes)
+        inputMatrices.AddInput(node->NodeName(), node->ValuePtr(), node->GetMBLayout(), node->GetSampleLayout());
+
+    net->StartEvaluateMinibatchLoop(evalNodes);
+    dataReader->StartMinibatchLoop(mbSize, 0, inputMatrices.GetStreamDescriptions(), mbSize * iters);
+
+    vector<double> latencies;
+    for (int iter = 0; iter < iters; iter++)
+    {
+        size_t actualMBSize = 0;
+        if (!DataReaderHelpers::GetMinibatchIntoNetwork<ElemType>(*dataReader, net, nullptr, false, false, inputMatrices, actualMBSize, nullptr))
+            break;
+
+        ComputationNetwork::BumpEvalTimeStamp(featureNodes);
+        auto start = chrono::steady_clock::now();
+        net->ForwardProp(evalNodes);
+        latencies.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+    }
+    dataReader->DataEnd();
+
+    sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+static double Percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    return sorted[min(sorted.size() - 1, (size_t) (p * sorted.size()))];
+}
+
+// Post-training int8 quantization: replaces the products of weight matrices and activations by int8 QuantizedTimes
+// nodes, calibrates their input ranges on data from the reader, and saves the model. Then reports the memory taken
+// by the weights and the latency of the forward pass, in float and in int8.
+template <typename ElemType>
+void DoInt8Quantization(const ConfigParameters& config)
+{
+    ConfigParameters readerConfig(config(L"reader"));
+    readerConfig.Insert("traceLevel", config(L"traceLevel", "0"));
+
+    auto dataReader = make_shared<DataReader>(readerConfig);
+
+    int traceLevel = config(L"traceLevel", "0");
+    int iterations = config(L"iterations", 30);
+    size_t mbSize = config(L"minibatchSize", "16");
+    wstring nodeNameRegex = config(L"nodeNameRegex", L".*");
+
+    wstring curModelPath = config(L"modelPath", L"");
+    wstring newModelPath = config(L"newModelPath", L"");
+    if (newModelPath == L"")
+    {
+        newModelPath = curModelPath + L".int8";
+    }
+
+    // the original network, for reference
+    std::vector<std::wstring> evalNodeNames;
+    let floatNet = GetModelFromConfig<ConfigParameters, ElemType>(config, L"evalNodeNames", evalNodeNames);
+    if (floatNet->GetDeviceId() != CPUDEVICE)
+        InvalidArgument("quantize: The int8 quantization is for evaluation on the CPU, please set deviceId=-1.");
+
+    let net = GetModelFromConfig<ConfigParameters, ElemType>(config, L"evalNodeNames", evalNodeNames);
+    size_t numQuantized = net->template QuantizeTimesNodesToInt8<ElemType>(nodeNameRegex);
+    LOGPRINTF(stderr, "quantize: %d Times nodes replaced by int8 QuantizedTimes nodes.\n", (int) numQuantized);
+    if (numQuantized == 0)
+        return;
+
+    PostComputingActions<ElemType> postComputingActions(net, nullptr, false, traceLevel);
+    postComputingActions.Int8QuantizationCalibration(dataReader.get(), evalNodeNames, newModelPath, mbSize, iterations);
+
+    auto floatLatencies = MeasureForwardLatency<ElemType>(floatNet, dataReader.get(), floatNet->GetEvalNodesWithName(evalNodeNames), mbSize, iterations);
+    auto int8Latencies = MeasureForwardLatency<ElemType>(net, dataReader.get(), net->GetEvalNodesWithName(evalNodeNames), mbSize, iterations);
+
+    // the float weights also stay in the quantized model, only the products use the int8 copies
+    size_t floatBytes = 0, int8Bytes = 0;
+    for (let& node : net->GetAllNodes())
+    {
+        let quantizedNode = dynamic_pointer_cast<QuantizedTimesNode<ElemType>>(node);
+        if (quantizedNode && quantizedNode->IsInt8())
+        {
+            floatBytes += quantizedNode->GetInputs()[0]->GetSampleLayout().GetNumElements() * sizeof(ElemType);
+            int8Bytes += quantizedNode->QuantizedWeightBytes();
+        }
+    }
+
+    LOGPRINTF(stderr, "quantize: weights of the quantized products: %.2f MB in float, %.2f MB in int8\n", floatBytes / 1e6, int8Bytes / 1e6);
+    LOGPRINTF(stderr, "quantize: forward pass latency over %d minibatches of %d: float p50 = %.3f ms, p99 = %.3f ms; int8 p50 = %.3f ms, p99 = %.3f ms\n",
+              (int) int8Latencies.size(), (int) mbSize,
+              Percentile(floatLatencies, 0.5), Percentile(floatLatencies, 0.99), Percentile(int8Latencies, 0.5), Percentile(int8Latencies, 0.99));
+}
+
+template void DoInt8Quantization<double>(const ConfigParameters& config);
+template void DoInt8Quantization<float>(const ConfigParameters& config);
+
@@ -23,6 +23,7 @@
 #include "NDLNetworkBuilder.h"
 #include "ModelEditLanguage.h"
 #include "CPUMatrix.h" // used for SetNumThreads()
+#include "CPUVectorizedTensorOps.h"
 #include "CommonMatrix.h"
 #include "SGD.h"
 #include "MPIWrapper.h"
@@ -81,9 +82,34 @@ void SetupProfiling(ProfilerContext& profilerContext, const ConfigParamType& con
                              config(L"profilerBufferSize", static_cast<uint64_t>(32 * 1024 * 1024)),
                              std::to_wstring(nodeRank),
                              config(L"profilerSyncGpu", true));
+
+        // per-node forward/backward timing of the network traversal (nodes/trace reports)
+        ProfilerEnableNodeTracing(config(L"profilerNodeTracing", false));
     }
 }
 
+// Select the implementation of MPIWrapper::AllReduce() for large buffers
+template <typename ConfigParamType>
+void SetupAllReduce(const shared_ptr<MPIWrapper>& mpi, const ConfigParamType& config)
+{
+    wstring algorithmName = config(L"allReduceAlgorithm", L"mpi");
+    AllReduceAlgorithm algorithm;
+    if (EqualCI(algorithmName, L"mpi"))
+        algorithm = AllReduceAlgorithm::Mpi;
+    else if (EqualCI(algorithmName, L"ring"))
+        algorithm = AllReduceAlgorithm::Ring;
+    else if (EqualCI(algorithmName, L"hierarchical"))
+        algorithm = AllReduceAlgorithm::Hierarchical;
+    else if (EqualCI(algorithmName, L"auto"))
+        algorithm = AllReduceAlgorithm::Auto;
+    else
+        InvalidArgument("allReduceAlgorithm: Invalid value '%ls', must be one of 'mpi', 'ring', 'hierarchical' or 'auto'.", algorithmName.c_str());
+
+    mpi->SetAllReduceAlgorithm(algorithm,
+                               config(L"allReduceMinSizeInKB", DEFAULT_ALLREDUCE_MIN_SIZE_IN_KB) * 1024,
+                               config(L"allReduceChunkSizeInKB", DEFAULT_ALLREDUCE_CHUNK_SIZE_IN_KB) * 1024);
+}
+
 void RedirectStdErr(wstring logpath)
 {
     // TODO: if there is already a file, rename it
@@ -339,6 +365,10 @@ void DoCommands(const ConfigParameters& config, const shared_ptr<MPIWrapper>& mp
                 {
                     DoParameterSVD<ElemType>(commandParams);
                 }
+                else if (thisAction == "quantize")
+                {
+                    DoInt8Quantization<ElemType>(commandParams);
+                }
                 else
                 {
                     RuntimeError("unknown action: %s  in command set: %s", thisAction.c_str(), command[i].c_str());
@@ -506,10 +536,19 @@ int wmainWithBS(int argc, wchar_t* argv[]) // called from wmain which is a wrapp
     if (paralleltrain)
     {
         mpi = MPIWrapper::GetInstance(true /*create*/);
+        SetupAllReduce(mpi, config);
     }  
 
     Globals::SetShareNodeValueMatrices(config(L"shareNodeValueMatrices", true));
     Globals::SetGradientAccumulationOptimization(config(L"optimizeGradientAccumulation", true));
+    Globals::SetElementwiseNodeFusion(config(L"fuseElementwiseNodes", false));
+    Globals::SetMinibatchAwareMemoryPlanning(config(L"planMemoryPerMinibatch", false));
+    Globals::SetMemoryArena(config(L"useMemoryArena", false));
+    if (Globals::ShouldUseMemoryArena() && !Globals::ShouldPlanMemoryPerMinibatch())
+        InvalidArgument("useMemoryArena=true requires planMemoryPerMinibatch=true.");
+    Globals::SetMemoryArenaHugePages(config(L"memoryArenaHugePages", false));
+    CPUMatrix<float /*any type will do*/>::SetCounterBasedRandomGenerator(config(L"cpuCounterBasedRNG", false));
+    CPUVectorizedTensorOps::SetApproximateTranscendentals(config(L"cpuApproximateTranscendentals", false));
 
     TracingGPUMemoryAllocator::SetTraceLevel(config(L"traceGPUMemoryAllocations", 0));
 
@@ -654,10 +693,19 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
     if (paralleltrain)
     {
        mpi = MPIWrapper::GetInstance(true /*create*/);
+       SetupAllReduce(mpi, config);
     } 
 
     Globals::SetShareNodeValueMatrices(config(L"shareNodeValueMatrices", true));
     Globals::SetGradientAccumulationOptimization(config(L"optimizeGradientAccumulation", true));
+    Globals::SetElementwiseNodeFusion(config(L"fuseElementwiseNodes", false));
+    Globals::SetMinibatchAwareMemoryPlanning(config(L"planMemoryPerMinibatch", false));
+    Globals::SetMemoryArena(config(L"useMemoryArena", false));
+    if (Globals::ShouldUseMemoryArena() && !Globals::ShouldPlanMemoryPerMinibatch())
+        InvalidArgument("useMemoryArena=true requires planMemoryPerMinibatch=true.");
+    Globals::SetMemoryArenaHugePages(config(L"memoryArenaHugePages", false));
+    CPUMatrix<float /*any type will do*/>::SetCounterBasedRandomGenerator(config(L"cpuCounterBasedRNG", false));
+    CPUVectorizedTensorOps::SetApproximateTranscendentals(config(L"cpuApproximateTranscendentals", false));
 
     TracingGPUMemoryAllocator::SetTraceLevel(config(L"traceGPUMemoryAllocations", 0));
 
@@ -193,7 +193,7 @@ void MELScript<ElemType>::CallFunction(const std::string& p_name, const ConfigPa
 
         // validate the network before we save it out
         ProcessNDLScript(m_netNdlDefault, ndlPassAll, true);
-        cn->SaveEdited(fileName);
+        cn->SaveEdited(fileName, SaveFileOptions(modelFormat));
     }
     else if (EqualInsensitive(name, "SaveModel"))
     {
@@ -212,7 +212,7 @@ void MELScript<ElemType>::CallFunction(const std::string& p_name, const ConfigPa
 
         // validate and finish the second pass through NDL if any in-line NDL was defined
         ProcessNDLScript(netNdl, ndlPassAll, true);
-        netNdl->cn->SaveEdited(fileName);
+        netNdl->cn->SaveEdited(fileName, SaveFileOptions(modelFormat));
     }
     else if (EqualInsensitive(name, "SetDefaultModel"))
     {
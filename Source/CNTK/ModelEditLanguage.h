@@ -456,9 +456,13 @@ public:
                     {
                         modelFormat = L"cntk_legacy_no_tensorlib";
                     }
+                    else if (EqualInsensitive(value, "cntk_mappable")) // for saving: page-aligned parameters that are memory-mapped when loaded on the CPU
+                    {
+                        modelFormat = L"cntk_mappable";
+                    }
                     else
                     {
-                        RuntimeError("Invalid optional parameter value %s, valid values are: format=(cntk)", value.c_str());
+                        RuntimeError("Invalid optional parameter value %s, valid values are: format=(cntk|cntk_mappable)", value.c_str());
                     }
                 }
                 else
@@ -471,6 +475,14 @@ public:
         return modelFormat;
     }
 
+    // file options for saving a model in the given format
+    static FileOptions SaveFileOptions(const wstring& modelFormat)
+    {
+        if (modelFormat == L"cntk_mappable")
+            return (FileOptions) (fileOptionsBinary | fileOptionsMappable);
+        return fileOptionsBinary;
+    }
+
     std::string GetOptionalSnippetSection(const ConfigParamList& params, const size_t numFixedParams)
     {
         // process optional parameter if it exists
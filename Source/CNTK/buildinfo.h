@@ -0,0 +1,16 @@
+#ifndef _BUILDINFO_H
+#define _BUILDINFO_H
+#define _GIT_EXIST
+#define _MATHLIB_ "openblas"
+#define _BUILDSHA1_ "6d3edef2e63de363ce75ec6901ad4c6818a960fc (modified)"
+#define _BUILDBRANCH_ "master"
+#define _BUILDTARGET_ "CPU-only"
+#define _BUILDTYPE_ "release"
+#define _WITH_1BITSGD_ "no"
+#define _WITH_ASGD_ "no"
+#define _BUILDER_ "Source/CNTK/buildinfo.h$$0"
+#define _BUILDMACHINE_ "vm"
+#define _BUILDPATH_ "/root/repo"
+#define _MPI_NAME_ "Unknown"
+#define _MPI_VERSION_ "Unknown"
+#endif
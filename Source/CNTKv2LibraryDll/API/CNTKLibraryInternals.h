@@ -252,7 +252,9 @@ namespace CNTK
                                          bool transpose, const NDShape& outputShape, size_t maxTempMemSizeInSamples, const std::wstring& name = L"");
 
         // This is meant for debugging purposes only and is very likely to be deprecated in the future.
-        CNTK_API void SaveAsLegacyModel(const FunctionPtr& rootFunction, const std::wstring& modelFile);
+        // With mappable = true, the parameters are stored page-aligned, so that Function::Load() maps them from the file
+        // on the CPU instead of reading them.
+        CNTK_API void SaveAsLegacyModel(const FunctionPtr& rootFunction, const std::wstring& modelFile, bool mappable = false);
 
         CNTK_API size_t NewUniqueId();
 
@@ -297,10 +299,18 @@ namespace CNTK
         CNTK_API void EnableGradientAccumulationOptimization();
         CNTK_API void DisableGradientAccumulationOptimization();
 
+        CNTK_API void EnableCounterBasedCPURandomGenerator();
+        CNTK_API void DisableCounterBasedCPURandomGenerator();
+
+        CNTK_API void EnableApproximateCPUTranscendentals();
+        CNTK_API void DisableApproximateCPUTranscendentals();
+
         static const uint64_t DefaultProfilerBufferSize = 32 * 1024 * 1024;
         CNTK_API void StartProfiler(const std::wstring& profilerDir = L"profiler", bool profilerSyncGpu = false, size_t profilerBufferSize = DefaultProfilerBufferSize);
         CNTK_API void EnableProfiler();
         CNTK_API void DisableProfiler();
+        CNTK_API void EnableNodeProfiler();
+        CNTK_API void DisableNodeProfiler();
         CNTK_API void StopProfiler();
 
         CNTK_API bool AreEquivalent(const ::CNTK::FunctionPtr& f1, const ::CNTK::FunctionPtr& f2);
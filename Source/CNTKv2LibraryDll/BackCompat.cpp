@@ -613,7 +613,7 @@ namespace CNTK
             return rootComposite;
         }
 
-        void SaveAsLegacyModel(const FunctionPtr& rootFunction, const std::wstring& modelFile)
+        void SaveAsLegacyModel(const FunctionPtr& rootFunction, const std::wstring& modelFile, bool mappable)
         {
             CompositeFunction* compositeFunction = dynamic_cast<CompositeFunction*>(rootFunction.get());
             if (compositeFunction == nullptr)
@@ -657,7 +657,7 @@ namespace CNTK
                 LogicError("SaveAsLegacyModel: Function '%S' has unknown DataType %s.", rootFunction->AsString().c_str(), DataTypeName(dataType));
             }
 
-            computationNetwork->Save(modelFile);
+            computationNetwork->Save(modelFile, mappable ? (FileOptions) (fileOptionsBinary | fileOptionsMappable) : fileOptionsBinary);
         }
 
         LegacyModelDataType DetectLegacyModelDataType(const std::wstring& modelFile)
@@ -11,6 +11,7 @@
 #include <memory>
 #include <algorithm>
 #include <CPUMatrix.h> // For CPUMatrix::SetNumThreads
+#include <CPUVectorizedTensorOps.h>
 #include <thread>
 #include "GPUMatrix.h"
 #include "Globals.h"
@@ -170,6 +171,26 @@ namespace CNTK
             Microsoft::MSR::CNTK::Globals::SetGradientAccumulationOptimization(/* enable = */ false);
         }
 
+        void EnableCounterBasedCPURandomGenerator()
+        {
+            Microsoft::MSR::CNTK::CPUMatrix<float>::SetCounterBasedRandomGenerator(/* enable = */ true);
+        }
+
+        void DisableCounterBasedCPURandomGenerator()
+        {
+            Microsoft::MSR::CNTK::CPUMatrix<float>::SetCounterBasedRandomGenerator(/* enable = */ false);
+        }
+
+        void EnableApproximateCPUTranscendentals()
+        {
+            Microsoft::MSR::CNTK::CPUVectorizedTensorOps::SetApproximateTranscendentals(/* enable = */ true);
+        }
+
+        void DisableApproximateCPUTranscendentals()
+        {
+            Microsoft::MSR::CNTK::CPUVectorizedTensorOps::SetApproximateTranscendentals(/* enable = */ false);
+        }
+
         void StartProfiler(const wstring& profilerDir, bool profilerSyncGpu, size_t profilerBufferSize)
         {
             std::wstring logSuffix = L"";
@@ -196,6 +217,16 @@ namespace CNTK
             Microsoft::MSR::CNTK::ProfilerEnable(false);
         }
 
+        void EnableNodeProfiler()
+        {
+            Microsoft::MSR::CNTK::ProfilerEnableNodeTracing(true);
+        }
+
+        void DisableNodeProfiler()
+        {
+            Microsoft::MSR::CNTK::ProfilerEnableNodeTracing(false);
+        }
+
         void StopProfiler()
         {
             Microsoft::MSR::CNTK::ProfilerClose();
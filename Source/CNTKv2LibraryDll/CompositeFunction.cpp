@@ -1843,6 +1843,9 @@ namespace CNTK
         // TODO: Avoid copying the data when possible
         PopulateNetworkInputs(requiredArgumentValues);
 
+        // The input layouts are set; adapt the memory sharing to them before the forward pass.
+        m_computationNetwork->PlanMemoryForMinibatch();
+
         // Copy all new values for 'dirty' attributes from functions into corresponding network nodes.
         ApplyAttributeUpdates();
 
@@ -2004,3 +2007,9 @@ namespace CNTK
         }
     }
 }
+// TEMPLOCAL
+namespace CNTK {
+#define TEMPLOCAL_INST(T) template std::pair<Microsoft::MSR::CNTK::ComputationNetworkPtr, std::unordered_map<Variable, Microsoft::MSR::CNTK::ComputationNodeBasePtr>> CompositeFunction::CreateComputationNetwork<T>(const FunctionPtr&, const DeviceDescriptor&, const std::unordered_set<Variable>&, const std::unordered_map<Variable, Variable>&, const std::unordered_set<Variable>&, bool);
+TEMPLOCAL_INST(float)
+TEMPLOCAL_INST(double)
+}
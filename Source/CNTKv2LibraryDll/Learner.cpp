@@ -108,6 +108,18 @@ namespace CNTK
             else
                 LogicError("Unsupported DataType %s", DataTypeName(v.second->GetDataType()));
         }
+        m_lastUpdateSteps.clear();
+    }
+
+    shared_ptr<Matrix<double>> LearnerBase::LastUpdateSteps(const Parameter& parameter, const NDArrayViewPtr& gradientValue) const
+    {
+        if (!gradientValue->IsSparse() || gradientValue->Device().Type() != DeviceKind::CPU)
+            return nullptr;
+
+        auto& steps = m_lastUpdateSteps[parameter];
+        if (!steps)
+            steps = MakeSharedObject<NDArrayView>(0.0, DataType::Double, NDShape({ GetMatrixShape(parameter)[1] }), DeviceDescriptor::CPUDevice());
+        return GetWritableMatrix<double>(steps);
     }
 
     // Clipping gradients to prevent outliers,
@@ -268,41 +280,44 @@ namespace CNTK
 
         UpdateOnMinibatch(trainingSampleCount);
 
-        for (const auto& parameter : Parameters())
+        if (!MultiTensorUpdate(gradientValues, trainingSampleCount))
         {
-            const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
-            const auto& gradientValue = gradientValues.at(parameter);
-            // TODO: make this a runtime parameter.
+            for (const auto& parameter : Parameters())
+            {
+                const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
+                const auto& gradientValue = gradientValues.at(parameter);
+                // TODO: make this a runtime parameter.
 #if DUMPOUTPUT
-            LOGPRINTF(stderr, "Update_%ls\n", parameter.Uid().c_str());
+                LOGPRINTF(stderr, "Update_%ls\n", parameter.Uid().c_str());
 #endif
 
 #ifdef _DEBUG
-            if (HasNan(smoothedGradientValue, "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
-                LogicError("%ls has NaNs in smoothedGradient.", parameter.Uid().c_str());
+                if (HasNan(smoothedGradientValue, "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
+                    LogicError("%ls has NaNs in smoothedGradient.", parameter.Uid().c_str());
 #endif
 
 #if DUMPOUTPUT
-            const auto learningRate = LearningRate(trainingSampleCount);
-            const auto momentum = MomentumValueForMB(trainingSampleCount);
-            LOGPRINTF(stderr, "learnRatePerSample=%0.8f, momentum=%0.8f, actualMBSize=%ld\n",
-                      learningRate, momentum, trainingSampleCount);
-            LOGPRINTF(stderr, "GradUpdateType()=%s, GradientUpdateNoiseStd()=%0.8f\n",
-                      LearnerType().c_str(), m_additionalOptions.gaussianNoiseInjectionStdDev);
-            Print(gradientValue, "Gradient Update");
-            Print(smoothedGradientValue, "Smoothed Gradient Input");
+                const auto learningRate = LearningRate(trainingSampleCount);
+                const auto momentum = MomentumValueForMB(trainingSampleCount);
+                LOGPRINTF(stderr, "learnRatePerSample=%0.8f, momentum=%0.8f, actualMBSize=%ld\n",
+                          learningRate, momentum, trainingSampleCount);
+                LOGPRINTF(stderr, "GradUpdateType()=%s, GradientUpdateNoiseStd()=%0.8f\n",
+                          LearnerType().c_str(), m_additionalOptions.gaussianNoiseInjectionStdDev);
+                Print(gradientValue, "Gradient Update");
+                Print(smoothedGradientValue, "Smoothed Gradient Input");
 #endif
-            DISPATCH_TO_TYPED_UPDATE_FUNCTION;
+                DISPATCH_TO_TYPED_UPDATE_FUNCTION;
 
 #if DUMPOUTPUT
-            Print(parameter.Value(), "Parameter Update");
+                Print(parameter.Value(), "Parameter Update");
 #endif
 
 #ifdef _DEBUG
-            const auto& parameterValue = parameter.Value();
-            if (HasNan(parameterValue, "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
-                LogicError("%ls has NaNs in parameter values after parameter update.", parameter.Uid().c_str());
+                const auto& parameterValue = parameter.Value();
+                if (HasNan(parameterValue, "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
+                    LogicError("%ls has NaNs in parameter values after parameter update.", parameter.Uid().c_str());
 #endif
+            }
         }
         m_sampleCount += trainingSampleCount;
         m_minibatchCount++;
@@ -327,6 +342,84 @@ namespace CNTK
         paramRef.RecordValueUpdate();
     }
 
+    bool LearnerBase::MultiTensorSGDUpdate(unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount,
+                                           bool useSmoothedGradients, double momentum, bool unitGainMomentum, bool nesterov)
+    {
+        const auto& parameters = Parameters();
+        const auto dataType = parameters.front().GetDataType();
+        for (const auto& parameter : parameters)
+        {
+            const auto& parameterValue = parameter.Value();
+            const auto& gradientValue = gradientValues.at(parameter);
+            if (parameterValue->GetDataType() != dataType || parameterValue->Device().Type() != DeviceKind::CPU || parameterValue->IsSparse() ||
+                gradientValue->Device().Type() != DeviceKind::CPU || gradientValue->IsSparse() ||
+                gradientValue->Shape().TotalSize() != parameterValue->Shape().TotalSize())
+                return false;
+
+            if (useSmoothedGradients && m_smoothedGradientValues.at(parameter)->Shape().TotalSize() != parameterValue->Shape().TotalSize())
+                return false;
+        }
+
+        switch (dataType)
+        {
+        case DataType::Float:
+            MultiTensorSGDUpdate<float>(gradientValues, trainingSampleCount, useSmoothedGradients, momentum, unitGainMomentum, nesterov);
+            return true;
+        case DataType::Double:
+            MultiTensorSGDUpdate<double>(gradientValues, trainingSampleCount, useSmoothedGradients, momentum, unitGainMomentum, nesterov);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Same as PreProcess(), Update() and PostProcess() for each parameter, except that the preprocessing and
+    // the update of all parameters is done by a single fused operation.
+    template <typename ElementType>
+    void LearnerBase::MultiTensorSGDUpdate(unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount,
+                                           bool useSmoothedGradients, double momentum, bool unitGainMomentum, bool nesterov)
+    {
+        // keeps the matrix views alive
+        vector<shared_ptr<Matrix<ElementType>>> matrices;
+        vector<Matrix<ElementType>*> parameterMatrices, gradientMatrices, smoothedGradientMatrices;
+        for (const auto& parameter : Parameters())
+        {
+            matrices.push_back(GetWritableMatrix<ElementType>(parameter.Value()));
+            parameterMatrices.push_back(matrices.back().get());
+            matrices.push_back(GetWritableMatrix<ElementType>(gradientValues.at(parameter)));
+            gradientMatrices.push_back(matrices.back().get());
+            if (useSmoothedGradients)
+            {
+                matrices.push_back(GetWritableMatrix<ElementType>(m_smoothedGradientValues.at(parameter)));
+                smoothedGradientMatrices.push_back(matrices.back().get());
+            }
+        }
+
+        // same scaling of the hyperparameters as in PreProcess() and ClipGradient()
+        const size_t actualMBSize = m_additionalOptions.useMeanGradient ? 1 : trainingSampleCount;
+        MultiTensorSGDOptions options;
+        if (m_additionalOptions.useMeanGradient)
+            options.gradientScale = 1.0 / trainingSampleCount;
+        options.clippingThreshold = m_additionalOptions.gradientClippingThresholdPerSample * actualMBSize;
+        options.clippingWithTruncation = m_additionalOptions.gradientClippingWithTruncation;
+        if (m_additionalOptions.l2RegularizationWeight > 0)
+            options.l2RegularizationWeight = m_additionalOptions.l2RegularizationWeight * actualMBSize;
+        options.learnRatePerSample = LearningRate(trainingSampleCount);
+        options.momentum = momentum;
+        options.unitGainMomentum = unitGainMomentum;
+        options.nesterov = nesterov;
+
+        Matrix<ElementType>::MultiTensorSGDUpdate(parameterMatrices, gradientMatrices, smoothedGradientMatrices, options);
+
+        for (const auto& parameter : Parameters())
+        {
+            PostProcess<ElementType>(parameter, gradientValues.at(parameter), trainingSampleCount);
+
+            auto paramRef = parameter;
+            paramRef.RecordValueUpdate();
+        }
+    }
+
     string LearnerBase::LearnerType() const
     {
         return Typename(this);
@@ -357,6 +450,18 @@ namespace CNTK
 
         checkpoint[smoothedGradientsKey] = serializedSmoothedGradients;
 
+        // keyed by the index of the parameter, for the parameters that have them
+        Dictionary lastUpdateSteps;
+        const auto& parameters = Parameters();
+        for (size_t i = 0; i < parameters.size(); i++)
+        {
+            auto steps = m_lastUpdateSteps.find(parameters[i]);
+            if (steps != m_lastUpdateSteps.end())
+                lastUpdateSteps[std::to_wstring(i)] = *steps->second;
+        }
+        if (lastUpdateSteps.Size() > 0)
+            checkpoint[lastUpdateStepsKey] = lastUpdateSteps;
+
         return checkpoint;
     }
 
@@ -426,6 +531,25 @@ namespace CNTK
 
             smoothedGradientValue->CopyFrom(checkpointedValue);
         }
+
+        // Optional: without it (e.g. a checkpoint of an older version), the columns absent from the gradients
+        // before the checkpoint was taken are not decayed for the steps they missed.
+        m_lastUpdateSteps.clear();
+        if (checkpoint.Contains(lastUpdateStepsKey))
+        {
+            const auto& lastUpdateSteps = checkpoint[lastUpdateStepsKey].Value<Dictionary>();
+            for (size_t i = 0; i < parameters.size(); i++)
+            {
+                if (!lastUpdateSteps.Contains(std::to_wstring(i)))
+                    continue;
+
+                const auto& checkpointedValue = lastUpdateSteps[std::to_wstring(i)].Value<NDArrayView>();
+                if (checkpointedValue.GetDataType() != DataType::Double || checkpointedValue.Shape() != NDShape({ GetMatrixShape(parameters[i])[1] }))
+                    LogicError("The last update steps of parameter '%S' in the checkpoint do not match the parameter.", parameters[i].AsString().c_str());
+
+                m_lastUpdateSteps[parameters[i]] = checkpointedValue.DeepClone(DeviceDescriptor::CPUDevice());
+            }
+        }
     }
 
     void LearnerBase::ReportTrainingParameterValue(const TrainingParameterSchedule<double>& schedule, const wstring& name) const
@@ -485,6 +609,11 @@ namespace CNTK
         parameterMatrix->SGDUpdate(*gradientMatrix, learningRate);
     }
 
+    /*virtual*/ bool LearnerSGD::MultiTensorUpdate(unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) /*override*/
+    {
+        return MultiTensorSGDUpdate(gradientValues, trainingSampleCount, /*useSmoothedGradients*/ false);
+    }
+
     double LearnerMomentumSGD::MomentumValueForMB(const MomentumSchedule& schedule, size_t minibatchSize) const
     {
         double currentMomentum = GetCurrentTrainingParameterValue(schedule);
@@ -520,6 +649,18 @@ namespace CNTK
                                            learningRate, momentum, UseUnitGainMomentum());
     }
 
+    /*virtual*/ bool LearnerMomentumSGD::MultiTensorUpdate(unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) /*override*/
+    {
+        // derived learners (FSAdaGrad, Adam) have their own update rule
+        if (typeid(*this) != typeid(LearnerMomentumSGD))
+            return false;
+
+        ReportTrainingParameterValue(m_momentumSchedule, L"Momentum");
+
+        return MultiTensorSGDUpdate(gradientValues, trainingSampleCount, /*useSmoothedGradients*/ true,
+                                    MomentumValueForMB(trainingSampleCount), UseUnitGainMomentum());
+    }
+
     /*virtual*/ void LearnerNesterov::Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, 
                                              const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const /*override*/
     {
@@ -539,6 +680,15 @@ namespace CNTK
                                                               learningRate, momentum, UseUnitGainMomentum());
     }
 
+    /*virtual*/ bool LearnerNesterov::MultiTensorUpdate(unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) /*override*/
+    {
+        if (typeid(*this) != typeid(LearnerNesterov))
+            return false;
+
+        return MultiTensorSGDUpdate(gradientValues, trainingSampleCount, /*useSmoothedGradients*/ true,
+                                    MomentumValueForMB(trainingSampleCount), UseUnitGainMomentum(), /*nesterov*/ true);
+    }
+
     LearnerAdaGrad::LearnerAdaGrad(const std::vector<Parameter>& parameters,
                                    const LearningRateSchedule& learningRateSchedule,
                                    bool needAveMultiplier,
@@ -683,8 +833,11 @@ namespace CNTK
         const auto momentum = MomentumValueForMB(trainingSampleCount);
         const auto varMomentum = VarianceMomentumValueForMB(trainingSampleCount);
 
+        const auto lastUpdateSteps = LastUpdateSteps(parameter, gradientValue);
+
+        // the minibatch count is incremented after the update
         smoothedGradientMatrix->FSAdagradUpdate(*gradientMatrix, *parameterMatrix, m_targetAdagradAvDenom_x_sqrtAdagradSqrFrames, learningRate,
-                                                momentum, varMomentum, UseUnitGainMomentum());
+                                                momentum, varMomentum, UseUnitGainMomentum(), lastUpdateSteps.get(), (double) (m_minibatchCount + 1));
     }
 
     LearnerAdam::LearnerAdam(const vector<Parameter>& parameters,
@@ -756,8 +909,10 @@ namespace CNTK
 
         const auto varMomentum = VarianceMomentumValueForMB(trainingSampleCount);
 
+        const auto lastUpdateSteps = LastUpdateSteps(parameter, gradientValue);
+
         smoothedGradientMatrix->AdamUpdate(*gradientMatrix, *parameterMatrix, m_smoothedCount, learningRate,
-                                           momentum, varMomentum, (ElementType)m_epsilon, UseUnitGainMomentum(), m_adamax);
+                                           momentum, varMomentum, (ElementType)m_epsilon, UseUnitGainMomentum(), m_adamax, lastUpdateSteps.get());
     }
 
     LearnerRMSProp::LearnerRMSProp(const vector<Parameter>& parameters,
@@ -838,6 +993,7 @@ namespace CNTK
         GET_WRITABLE_MATRICES;
 
         const auto learningRate = LearningRate(trainingSampleCount);
+        const auto lastUpdateSteps = LastUpdateSteps(parameter, gradientValue);
 
         const auto aveMultiplier = smoothedGradientMatrix->RmsProp(*gradientMatrix,
                                                                    ElementType(m_gamma),
@@ -846,7 +1002,9 @@ namespace CNTK
                                                                    ElementType(m_dec),
                                                                    ElementType(m_min),
                                                                    m_needAveMultiplier,
-                                                                   m_smoothedCount > 1);
+                                                                   m_smoothedCount > 1,
+                                                                   lastUpdateSteps.get(),
+                                                                   m_smoothedCount);
 
         Matrix<ElementType>::ScaleAndAdd(ElementType(-learningRate / aveMultiplier), *gradientMatrix, *parameterMatrix);
     }
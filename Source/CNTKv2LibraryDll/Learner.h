@@ -43,6 +43,15 @@ namespace CNTK
         // Allows derived class may override this to perform per-minibatch update actions
         virtual void UpdateOnMinibatch(size_t /*trainingSampleCount*/) {}
 
+        // Allows derived classes to update all parameters at once instead of one by one.
+        // Returns false if the parameters have not been updated.
+        virtual bool MultiTensorUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& /*gradientValues*/, size_t /*trainingSampleCount*/) { return false; }
+
+        // Fused SGD, momentum SGD or Nesterov update of all parameters in a single pass (see Matrix::MultiTensorSGDUpdate()),
+        // including the pre- and postprocessing. Returns false if not all parameters and gradients are dense and on the CPU.
+        bool MultiTensorSGDUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount,
+                                  bool useSmoothedGradients, double momentum = 0.0, bool unitGainMomentum = true, bool nesterov = false);
+
         std::string LearnerType() const;
 
         // Returns current (per-sample) learning rate.
@@ -87,6 +96,13 @@ namespace CNTK
         template <typename ElementType>
         void ClipGradient(Microsoft::MSR::CNTK::Matrix<ElementType>& gradient, size_t actualMBSize) const;
 
+        // Returns the step of the last update of each column of the parameter if the gradient is block sparse and on the CPU,
+        // whose update is lazy (see CPUSparseMatrix::Adam()), nullptr otherwise. Created with the first such gradient and
+        // saved in the checkpoint.
+        std::shared_ptr<Microsoft::MSR::CNTK::Matrix<double>> LastUpdateSteps(const Parameter& parameter, const NDArrayViewPtr& gradientValue) const;
+
+        mutable std::unordered_map<Parameter, NDArrayViewPtr> m_lastUpdateSteps;
+
         // Performs additional preprocessing before calling the update method 
         // (gradient clipping and L2 regularization depending on the additional learning parameters).
         template <typename ElementType>
@@ -110,6 +126,10 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        template <typename ElementType>
+        void MultiTensorSGDUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount,
+                                  bool useSmoothedGradients, double momentum, bool unitGainMomentum, bool nesterov);
+
         // TODO: make these functions friends of NDViewArray and move to Utils?
         static bool HasNan(const NDArrayViewPtr& value, const char* name);
         static void Print(const NDArrayViewPtr& value, const char* msg);
@@ -136,6 +156,8 @@ namespace CNTK
 
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        virtual bool MultiTensorUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) override;
     };
 
     // SGD optimization with momentum. 
@@ -165,6 +187,8 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        virtual bool MultiTensorUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) override;
+
         // returns current per-minibatch momentum value from the provided schedule.
         double MomentumValueForMB(const MomentumSchedule& schedule, size_t minibatchSize) const;
 
@@ -198,6 +222,8 @@ namespace CNTK
 
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        virtual bool MultiTensorUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) override;
     };
 
     class LearnerAdaGrad : public LearnerBase
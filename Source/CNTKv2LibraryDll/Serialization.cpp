@@ -105,7 +105,7 @@ namespace CNTK
         {
             delete m_codedInputPtr.release();
             m_codedInputPtr = make_unique<io::CodedInputStream>(&m_input);
-            m_codedInputPtr->SetTotalBytesLimit(INT_MAX, INT_MAX);
+            m_codedInputPtr->SetTotalBytesLimit(INT_MAX);
         }
 
         io::ZeroCopyInputStream& m_input;
@@ -624,7 +624,7 @@ namespace CNTK
             // and store the payload separately, outside of the protobuf.
             // Prefix the metadata protobuf with a magic number and its bytes size.
             output.WriteLittleEndian32(MAGIC_NUMBER);
-            output.WriteLittleEndian32(m_proto->ByteSize());
+            output.WriteLittleEndian32((int) m_proto->ByteSizeLong());
             m_proto->SerializeToCodedStream(&output);
             WriteNDArrayViewData(output);
         }
@@ -682,7 +682,7 @@ namespace CNTK
             input.BackUp(size);
 
         io::CodedInputStream codedInput(&input);
-        codedInput.SetTotalBytesLimit(limit, limit);
+        codedInput.SetTotalBytesLimit(limit);
 
         return msg.ParseFromCodedStream(&codedInput) && codedInput.ConsumedEntireMessage();
     }
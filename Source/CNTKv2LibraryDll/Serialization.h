@@ -36,6 +36,7 @@ namespace CNTK
     const std::wstring smoothedGradientsKey = L"smoothed_gradients";
     const std::wstring noiseInjectionSeedKey = L"noise_injection_seed";
     const std::wstring smoothedCountKey = L"smoothed_count";
+    const std::wstring lastUpdateStepsKey = L"last_update_steps";
     const std::wstring stateKey = L"state";
     const std::wstring rngSeedKey = L"rng_seed";
     const std::wstring rngOffsetKey = L"rng_offset";
@@ -0,0 +1,7626 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: tensorboard.proto
+
+#include "tensorboard.pb.h"
+
+#include <algorithm>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/wire_format.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+
+PROTOBUF_PRAGMA_INIT_SEG
+
+namespace _pb = ::PROTOBUF_NAMESPACE_ID;
+namespace _pbi = _pb::internal;
+
+namespace tensorflow {
+PROTOBUF_CONSTEXPR TensorShapeProto_Dim::TensorShapeProto_Dim(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.size_)*/int64_t{0}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct TensorShapeProto_DimDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR TensorShapeProto_DimDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~TensorShapeProto_DimDefaultTypeInternal() {}
+  union {
+    TensorShapeProto_Dim _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 TensorShapeProto_DimDefaultTypeInternal _TensorShapeProto_Dim_default_instance_;
+PROTOBUF_CONSTEXPR TensorShapeProto::TensorShapeProto(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.dim_)*/{}
+  , /*decltype(_impl_.unknown_rank_)*/false
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct TensorShapeProtoDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR TensorShapeProtoDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~TensorShapeProtoDefaultTypeInternal() {}
+  union {
+    TensorShapeProto _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 TensorShapeProtoDefaultTypeInternal _TensorShapeProto_default_instance_;
+PROTOBUF_CONSTEXPR TensorProto::TensorProto(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.float_val_)*/{}
+  , /*decltype(_impl_.double_val_)*/{}
+  , /*decltype(_impl_.int_val_)*/{}
+  , /*decltype(_impl_._int_val_cached_byte_size_)*/{0}
+  , /*decltype(_impl_.string_val_)*/{}
+  , /*decltype(_impl_.scomplex_val_)*/{}
+  , /*decltype(_impl_.int64_val_)*/{}
+  , /*decltype(_impl_._int64_val_cached_byte_size_)*/{0}
+  , /*decltype(_impl_.bool_val_)*/{}
+  , /*decltype(_impl_.dcomplex_val_)*/{}
+  , /*decltype(_impl_.half_val_)*/{}
+  , /*decltype(_impl_._half_val_cached_byte_size_)*/{0}
+  , /*decltype(_impl_.tensor_content_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.tensor_shape_)*/nullptr
+  , /*decltype(_impl_.dtype_)*/0
+  , /*decltype(_impl_.version_number_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct TensorProtoDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR TensorProtoDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~TensorProtoDefaultTypeInternal() {}
+  union {
+    TensorProto _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 TensorProtoDefaultTypeInternal _TensorProto_default_instance_;
+PROTOBUF_CONSTEXPR VersionDef::VersionDef(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.bad_consumers_)*/{}
+  , /*decltype(_impl_._bad_consumers_cached_byte_size_)*/{0}
+  , /*decltype(_impl_.producer_)*/0
+  , /*decltype(_impl_.min_consumer_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct VersionDefDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR VersionDefDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~VersionDefDefaultTypeInternal() {}
+  union {
+    VersionDef _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 VersionDefDefaultTypeInternal _VersionDef_default_instance_;
+PROTOBUF_CONSTEXPR SummaryDescription::SummaryDescription(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.type_hint_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct SummaryDescriptionDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR SummaryDescriptionDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~SummaryDescriptionDefaultTypeInternal() {}
+  union {
+    SummaryDescription _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 SummaryDescriptionDefaultTypeInternal _SummaryDescription_default_instance_;
+PROTOBUF_CONSTEXPR HistogramProto::HistogramProto(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.bucket_limit_)*/{}
+  , /*decltype(_impl_.bucket_)*/{}
+  , /*decltype(_impl_.min_)*/0
+  , /*decltype(_impl_.max_)*/0
+  , /*decltype(_impl_.num_)*/0
+  , /*decltype(_impl_.sum_)*/0
+  , /*decltype(_impl_.sum_squares_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct HistogramProtoDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR HistogramProtoDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~HistogramProtoDefaultTypeInternal() {}
+  union {
+    HistogramProto _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 HistogramProtoDefaultTypeInternal _HistogramProto_default_instance_;
+PROTOBUF_CONSTEXPR Summary_Image::Summary_Image(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.encoded_image_string_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.height_)*/0
+  , /*decltype(_impl_.width_)*/0
+  , /*decltype(_impl_.colorspace_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct Summary_ImageDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR Summary_ImageDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~Summary_ImageDefaultTypeInternal() {}
+  union {
+    Summary_Image _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 Summary_ImageDefaultTypeInternal _Summary_Image_default_instance_;
+PROTOBUF_CONSTEXPR Summary_Audio::Summary_Audio(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.encoded_audio_string_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.content_type_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.num_channels_)*/int64_t{0}
+  , /*decltype(_impl_.length_frames_)*/int64_t{0}
+  , /*decltype(_impl_.sample_rate_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct Summary_AudioDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR Summary_AudioDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~Summary_AudioDefaultTypeInternal() {}
+  union {
+    Summary_Audio _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 Summary_AudioDefaultTypeInternal _Summary_Audio_default_instance_;
+PROTOBUF_CONSTEXPR Summary_Value::Summary_Value(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.tag_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.node_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.value_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_._oneof_case_)*/{}} {}
+struct Summary_ValueDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR Summary_ValueDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~Summary_ValueDefaultTypeInternal() {}
+  union {
+    Summary_Value _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 Summary_ValueDefaultTypeInternal _Summary_Value_default_instance_;
+PROTOBUF_CONSTEXPR Summary::Summary(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.value_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct SummaryDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR SummaryDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~SummaryDefaultTypeInternal() {}
+  union {
+    Summary _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 SummaryDefaultTypeInternal _Summary_default_instance_;
+PROTOBUF_CONSTEXPR AttrValue_ListValue::AttrValue_ListValue(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.s_)*/{}
+  , /*decltype(_impl_.i_)*/{}
+  , /*decltype(_impl_._i_cached_byte_size_)*/{0}
+  , /*decltype(_impl_.f_)*/{}
+  , /*decltype(_impl_.b_)*/{}
+  , /*decltype(_impl_.type_)*/{}
+  , /*decltype(_impl_._type_cached_byte_size_)*/{0}
+  , /*decltype(_impl_.shape_)*/{}
+  , /*decltype(_impl_.tensor_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct AttrValue_ListValueDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR AttrValue_ListValueDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~AttrValue_ListValueDefaultTypeInternal() {}
+  union {
+    AttrValue_ListValue _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 AttrValue_ListValueDefaultTypeInternal _AttrValue_ListValue_default_instance_;
+PROTOBUF_CONSTEXPR AttrValue::AttrValue(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.value_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_._oneof_case_)*/{}} {}
+struct AttrValueDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR AttrValueDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~AttrValueDefaultTypeInternal() {}
+  union {
+    AttrValue _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 AttrValueDefaultTypeInternal _AttrValue_default_instance_;
+PROTOBUF_CONSTEXPR NameAttrList_AttrEntry_DoNotUse::NameAttrList_AttrEntry_DoNotUse(
+    ::_pbi::ConstantInitialized) {}
+struct NameAttrList_AttrEntry_DoNotUseDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR NameAttrList_AttrEntry_DoNotUseDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~NameAttrList_AttrEntry_DoNotUseDefaultTypeInternal() {}
+  union {
+    NameAttrList_AttrEntry_DoNotUse _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 NameAttrList_AttrEntry_DoNotUseDefaultTypeInternal _NameAttrList_AttrEntry_DoNotUse_default_instance_;
+PROTOBUF_CONSTEXPR NameAttrList::NameAttrList(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.attr_)*/{::_pbi::ConstantInitialized()}
+  , /*decltype(_impl_.name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct NameAttrListDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR NameAttrListDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~NameAttrListDefaultTypeInternal() {}
+  union {
+    NameAttrList _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 NameAttrListDefaultTypeInternal _NameAttrList_default_instance_;
+PROTOBUF_CONSTEXPR NodeDef_AttrEntry_DoNotUse::NodeDef_AttrEntry_DoNotUse(
+    ::_pbi::ConstantInitialized) {}
+struct NodeDef_AttrEntry_DoNotUseDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR NodeDef_AttrEntry_DoNotUseDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~NodeDef_AttrEntry_DoNotUseDefaultTypeInternal() {}
+  union {
+    NodeDef_AttrEntry_DoNotUse _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 NodeDef_AttrEntry_DoNotUseDefaultTypeInternal _NodeDef_AttrEntry_DoNotUse_default_instance_;
+PROTOBUF_CONSTEXPR NodeDef::NodeDef(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.input_)*/{}
+  , /*decltype(_impl_.attr_)*/{::_pbi::ConstantInitialized()}
+  , /*decltype(_impl_.name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.op_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.device_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct NodeDefDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR NodeDefDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~NodeDefDefaultTypeInternal() {}
+  union {
+    NodeDef _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 NodeDefDefaultTypeInternal _NodeDef_default_instance_;
+PROTOBUF_CONSTEXPR GraphDef::GraphDef(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.node_)*/{}
+  , /*decltype(_impl_.versions_)*/nullptr
+  , /*decltype(_impl_.version_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct GraphDefDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR GraphDefDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~GraphDefDefaultTypeInternal() {}
+  union {
+    GraphDef _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GraphDefDefaultTypeInternal _GraphDef_default_instance_;
+PROTOBUF_CONSTEXPR Event::Event(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.wall_time_)*/0
+  , /*decltype(_impl_.step_)*/int64_t{0}
+  , /*decltype(_impl_.what_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_._oneof_case_)*/{}} {}
+struct EventDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR EventDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~EventDefaultTypeInternal() {}
+  union {
+    Event _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 EventDefaultTypeInternal _Event_default_instance_;
+PROTOBUF_CONSTEXPR LogMessage::LogMessage(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.message_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.level_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct LogMessageDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR LogMessageDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~LogMessageDefaultTypeInternal() {}
+  union {
+    LogMessage _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 LogMessageDefaultTypeInternal _LogMessage_default_instance_;
+PROTOBUF_CONSTEXPR SessionLog::SessionLog(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.checkpoint_path_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.msg_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.status_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct SessionLogDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR SessionLogDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~SessionLogDefaultTypeInternal() {}
+  union {
+    SessionLog _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 SessionLogDefaultTypeInternal _SessionLog_default_instance_;
+PROTOBUF_CONSTEXPR TaggedRunMetadata::TaggedRunMetadata(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.tag_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.run_metadata_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct TaggedRunMetadataDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR TaggedRunMetadataDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~TaggedRunMetadataDefaultTypeInternal() {}
+  union {
+    TaggedRunMetadata _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 TaggedRunMetadataDefaultTypeInternal _TaggedRunMetadata_default_instance_;
+}  // namespace tensorflow
+static ::_pb::Metadata file_level_metadata_tensorboard_2eproto[21];
+static const ::_pb::EnumDescriptor* file_level_enum_descriptors_tensorboard_2eproto[3];
+static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_tensorboard_2eproto = nullptr;
+
+const uint32_t TableStruct_tensorboard_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorShapeProto_Dim, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorShapeProto_Dim, _impl_.size_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorShapeProto_Dim, _impl_.name_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorShapeProto, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorShapeProto, _impl_.dim_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorShapeProto, _impl_.unknown_rank_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.dtype_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.tensor_shape_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.version_number_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.tensor_content_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.half_val_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.float_val_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.double_val_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.int_val_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.string_val_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.scomplex_val_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.int64_val_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.bool_val_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TensorProto, _impl_.dcomplex_val_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::VersionDef, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::VersionDef, _impl_.producer_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::VersionDef, _impl_.min_consumer_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::VersionDef, _impl_.bad_consumers_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::SummaryDescription, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::SummaryDescription, _impl_.type_hint_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::HistogramProto, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::HistogramProto, _impl_.min_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::HistogramProto, _impl_.max_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::HistogramProto, _impl_.num_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::HistogramProto, _impl_.sum_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::HistogramProto, _impl_.sum_squares_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::HistogramProto, _impl_.bucket_limit_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::HistogramProto, _impl_.bucket_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Image, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Image, _impl_.height_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Image, _impl_.width_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Image, _impl_.colorspace_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Image, _impl_.encoded_image_string_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Audio, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Audio, _impl_.sample_rate_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Audio, _impl_.num_channels_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Audio, _impl_.length_frames_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Audio, _impl_.encoded_audio_string_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Audio, _impl_.content_type_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Value, _internal_metadata_),
+  ~0u,  // no _extensions_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Value, _impl_._oneof_case_[0]),
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Value, _impl_.node_name_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Value, _impl_.tag_),
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary_Value, _impl_.value_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Summary, _impl_.value_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue_ListValue, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue_ListValue, _impl_.s_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue_ListValue, _impl_.i_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue_ListValue, _impl_.f_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue_ListValue, _impl_.b_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue_ListValue, _impl_.type_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue_ListValue, _impl_.shape_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue_ListValue, _impl_.tensor_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue, _internal_metadata_),
+  ~0u,  // no _extensions_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue, _impl_._oneof_case_[0]),
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  PROTOBUF_FIELD_OFFSET(::tensorflow::AttrValue, _impl_.value_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NameAttrList_AttrEntry_DoNotUse, _has_bits_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NameAttrList_AttrEntry_DoNotUse, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NameAttrList_AttrEntry_DoNotUse, key_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NameAttrList_AttrEntry_DoNotUse, value_),
+  0,
+  1,
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NameAttrList, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NameAttrList, _impl_.name_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NameAttrList, _impl_.attr_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef_AttrEntry_DoNotUse, _has_bits_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef_AttrEntry_DoNotUse, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef_AttrEntry_DoNotUse, key_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef_AttrEntry_DoNotUse, value_),
+  0,
+  1,
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef, _impl_.name_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef, _impl_.op_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef, _impl_.input_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef, _impl_.device_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::NodeDef, _impl_.attr_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::GraphDef, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::GraphDef, _impl_.node_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::GraphDef, _impl_.versions_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::GraphDef, _impl_.version_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Event, _internal_metadata_),
+  ~0u,  // no _extensions_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Event, _impl_._oneof_case_[0]),
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Event, _impl_.wall_time_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Event, _impl_.step_),
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  PROTOBUF_FIELD_OFFSET(::tensorflow::Event, _impl_.what_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::LogMessage, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::LogMessage, _impl_.level_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::LogMessage, _impl_.message_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::SessionLog, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::SessionLog, _impl_.status_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::SessionLog, _impl_.checkpoint_path_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::SessionLog, _impl_.msg_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TaggedRunMetadata, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TaggedRunMetadata, _impl_.tag_),
+  PROTOBUF_FIELD_OFFSET(::tensorflow::TaggedRunMetadata, _impl_.run_metadata_),
+};
+static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  { 0, -1, -1, sizeof(::tensorflow::TensorShapeProto_Dim)},
+  { 8, -1, -1, sizeof(::tensorflow::TensorShapeProto)},
+  { 16, -1, -1, sizeof(::tensorflow::TensorProto)},
+  { 35, -1, -1, sizeof(::tensorflow::VersionDef)},
+  { 44, -1, -1, sizeof(::tensorflow::SummaryDescription)},
+  { 51, -1, -1, sizeof(::tensorflow::HistogramProto)},
+  { 64, -1, -1, sizeof(::tensorflow::Summary_Image)},
+  { 74, -1, -1, sizeof(::tensorflow::Summary_Audio)},
+  { 85, -1, -1, sizeof(::tensorflow::Summary_Value)},
+  { 100, -1, -1, sizeof(::tensorflow::Summary)},
+  { 107, -1, -1, sizeof(::tensorflow::AttrValue_ListValue)},
+  { 120, -1, -1, sizeof(::tensorflow::AttrValue)},
+  { 137, 145, -1, sizeof(::tensorflow::NameAttrList_AttrEntry_DoNotUse)},
+  { 147, -1, -1, sizeof(::tensorflow::NameAttrList)},
+  { 155, 163, -1, sizeof(::tensorflow::NodeDef_AttrEntry_DoNotUse)},
+  { 165, -1, -1, sizeof(::tensorflow::NodeDef)},
+  { 176, -1, -1, sizeof(::tensorflow::GraphDef)},
+  { 185, -1, -1, sizeof(::tensorflow::Event)},
+  { 201, -1, -1, sizeof(::tensorflow::LogMessage)},
+  { 209, -1, -1, sizeof(::tensorflow::SessionLog)},
+  { 218, -1, -1, sizeof(::tensorflow::TaggedRunMetadata)},
+};
+
+static const ::_pb::Message* const file_default_instances[] = {
+  &::tensorflow::_TensorShapeProto_Dim_default_instance_._instance,
+  &::tensorflow::_TensorShapeProto_default_instance_._instance,
+  &::tensorflow::_TensorProto_default_instance_._instance,
+  &::tensorflow::_VersionDef_default_instance_._instance,
+  &::tensorflow::_SummaryDescription_default_instance_._instance,
+  &::tensorflow::_HistogramProto_default_instance_._instance,
+  &::tensorflow::_Summary_Image_default_instance_._instance,
+  &::tensorflow::_Summary_Audio_default_instance_._instance,
+  &::tensorflow::_Summary_Value_default_instance_._instance,
+  &::tensorflow::_Summary_default_instance_._instance,
+  &::tensorflow::_AttrValue_ListValue_default_instance_._instance,
+  &::tensorflow::_AttrValue_default_instance_._instance,
+  &::tensorflow::_NameAttrList_AttrEntry_DoNotUse_default_instance_._instance,
+  &::tensorflow::_NameAttrList_default_instance_._instance,
+  &::tensorflow::_NodeDef_AttrEntry_DoNotUse_default_instance_._instance,
+  &::tensorflow::_NodeDef_default_instance_._instance,
+  &::tensorflow::_GraphDef_default_instance_._instance,
+  &::tensorflow::_Event_default_instance_._instance,
+  &::tensorflow::_LogMessage_default_instance_._instance,
+  &::tensorflow::_SessionLog_default_instance_._instance,
+  &::tensorflow::_TaggedRunMetadata_default_instance_._instance,
+};
+
+const char descriptor_table_protodef_tensorboard_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
+  "\n\021tensorboard.proto\022\ntensorflow\"z\n\020Tenso"
+  "rShapeProto\022-\n\003dim\030\002 \003(\0132 .tensorflow.Te"
+  "nsorShapeProto.Dim\022\024\n\014unknown_rank\030\003 \001(\010"
+  "\032!\n\003Dim\022\014\n\004size\030\001 \001(\003\022\014\n\004name\030\002 \001(\t\"\345\002\n\013"
+  "TensorProto\022#\n\005dtype\030\001 \001(\0162\024.tensorflow."
+  "DataType\0222\n\014tensor_shape\030\002 \001(\0132\034.tensorf"
+  "low.TensorShapeProto\022\026\n\016version_number\030\003"
+  " \001(\005\022\026\n\016tensor_content\030\004 \001(\014\022\024\n\010half_val"
+  "\030\r \003(\005B\002\020\001\022\025\n\tfloat_val\030\005 \003(\002B\002\020\001\022\026\n\ndou"
+  "ble_val\030\006 \003(\001B\002\020\001\022\023\n\007int_val\030\007 \003(\005B\002\020\001\022\022"
+  "\n\nstring_val\030\010 \003(\014\022\030\n\014scomplex_val\030\t \003(\002"
+  "B\002\020\001\022\025\n\tint64_val\030\n \003(\003B\002\020\001\022\024\n\010bool_val\030"
+  "\013 \003(\010B\002\020\001\022\030\n\014dcomplex_val\030\014 \003(\001B\002\020\001\"K\n\nV"
+  "ersionDef\022\020\n\010producer\030\001 \001(\005\022\024\n\014min_consu"
+  "mer\030\002 \001(\005\022\025\n\rbad_consumers\030\003 \003(\005\"\'\n\022Summ"
+  "aryDescription\022\021\n\ttype_hint\030\001 \001(\t\"\207\001\n\016Hi"
+  "stogramProto\022\013\n\003min\030\001 \001(\001\022\013\n\003max\030\002 \001(\001\022\013"
+  "\n\003num\030\003 \001(\001\022\013\n\003sum\030\004 \001(\001\022\023\n\013sum_squares\030"
+  "\005 \001(\001\022\030\n\014bucket_limit\030\006 \003(\001B\002\020\001\022\022\n\006bucke"
+  "t\030\007 \003(\001B\002\020\001\"\257\004\n\007Summary\022(\n\005value\030\001 \003(\0132\031"
+  ".tensorflow.Summary.Value\032X\n\005Image\022\016\n\006he"
+  "ight\030\001 \001(\005\022\r\n\005width\030\002 \001(\005\022\022\n\ncolorspace\030"
+  "\003 \001(\005\022\034\n\024encoded_image_string\030\004 \001(\014\032}\n\005A"
+  "udio\022\023\n\013sample_rate\030\001 \001(\002\022\024\n\014num_channel"
+  "s\030\002 \001(\003\022\025\n\rlength_frames\030\003 \001(\003\022\034\n\024encode"
+  "d_audio_string\030\004 \001(\014\022\024\n\014content_type\030\005 \001"
+  "(\t\032\240\002\n\005Value\022\021\n\tnode_name\030\007 \001(\t\022\013\n\003tag\030\001"
+  " \001(\t\022\026\n\014simple_value\030\002 \001(\002H\000\022&\n\034obsolete"
+  "_old_style_histogram\030\003 \001(\014H\000\022*\n\005image\030\004 "
+  "\001(\0132\031.tensorflow.Summary.ImageH\000\022+\n\005hist"
+  "o\030\005 \001(\0132\032.tensorflow.HistogramProtoH\000\022*\n"
+  "\005audio\030\006 \001(\0132\031.tensorflow.Summary.AudioH"
+  "\000\022)\n\006tensor\030\010 \001(\0132\027.tensorflow.TensorPro"
+  "toH\000B\007\n\005value\"\376\003\n\tAttrValue\022\013\n\001s\030\002 \001(\014H\000"
+  "\022\013\n\001i\030\003 \001(\003H\000\022\013\n\001f\030\004 \001(\002H\000\022\013\n\001b\030\005 \001(\010H\000\022"
+  "$\n\004type\030\006 \001(\0162\024.tensorflow.DataTypeH\000\022-\n"
+  "\005shape\030\007 \001(\0132\034.tensorflow.TensorShapePro"
+  "toH\000\022)\n\006tensor\030\010 \001(\0132\027.tensorflow.Tensor"
+  "ProtoH\000\022/\n\004list\030\001 \001(\0132\037.tensorflow.AttrV"
+  "alue.ListValueH\000\022(\n\004func\030\n \001(\0132\030.tensorf"
+  "low.NameAttrListH\000\022\025\n\013placeholder\030\t \001(\tH"
+  "\000\032\301\001\n\tListValue\022\t\n\001s\030\002 \003(\014\022\r\n\001i\030\003 \003(\003B\002\020"
+  "\001\022\r\n\001f\030\004 \003(\002B\002\020\001\022\r\n\001b\030\005 \003(\010B\002\020\001\022&\n\004type\030"
+  "\006 \003(\0162\024.tensorflow.DataTypeB\002\020\001\022+\n\005shape"
+  "\030\007 \003(\0132\034.tensorflow.TensorShapeProto\022\'\n\006"
+  "tensor\030\010 \003(\0132\027.tensorflow.TensorProtoB\007\n"
+  "\005value\"\222\001\n\014NameAttrList\022\014\n\004name\030\001 \001(\t\0220\n"
+  "\004attr\030\002 \003(\0132\".tensorflow.NameAttrList.At"
+  "trEntry\032B\n\tAttrEntry\022\013\n\003key\030\001 \001(\t\022$\n\005val"
+  "ue\030\002 \001(\0132\025.tensorflow.AttrValue:\0028\001\"\263\001\n\007"
+  "NodeDef\022\014\n\004name\030\001 \001(\t\022\n\n\002op\030\002 \001(\t\022\r\n\005inp"
+  "ut\030\003 \003(\t\022\016\n\006device\030\004 \001(\t\022+\n\004attr\030\005 \003(\0132\035"
+  ".tensorflow.NodeDef.AttrEntry\032B\n\tAttrEnt"
+  "ry\022\013\n\003key\030\001 \001(\t\022$\n\005value\030\002 \001(\0132\025.tensorf"
+  "low.AttrValue:\0028\001\"l\n\010GraphDef\022!\n\004node\030\001 "
+  "\003(\0132\023.tensorflow.NodeDef\022(\n\010versions\030\004 \001"
+  "(\0132\026.tensorflow.VersionDef\022\023\n\007version\030\003 "
+  "\001(\005B\002\030\001\"\273\002\n\005Event\022\021\n\twall_time\030\001 \001(\001\022\014\n\004"
+  "step\030\002 \001(\003\022\026\n\014file_version\030\003 \001(\tH\000\022\023\n\tgr"
+  "aph_def\030\004 \001(\014H\000\022&\n\007summary\030\005 \001(\0132\023.tenso"
+  "rflow.SummaryH\000\022-\n\013log_message\030\006 \001(\0132\026.t"
+  "ensorflow.LogMessageH\000\022-\n\013session_log\030\007 "
+  "\001(\0132\026.tensorflow.SessionLogH\000\022<\n\023tagged_"
+  "run_metadata\030\010 \001(\0132\035.tensorflow.TaggedRu"
+  "nMetadataH\000\022\030\n\016meta_graph_def\030\t \001(\014H\000B\006\n"
+  "\004what\"\225\001\n\nLogMessage\022+\n\005level\030\001 \001(\0162\034.te"
+  "nsorflow.LogMessage.Level\022\017\n\007message\030\002 \001"
+  "(\t\"I\n\005Level\022\013\n\007UNKNOWN\020\000\022\t\n\005DEBUG\020\n\022\010\n\004I"
+  "NFO\020\024\022\010\n\004WARN\020\036\022\t\n\005ERROR\020(\022\t\n\005FATAL\0202\"\266\001"
+  "\n\nSessionLog\0224\n\006status\030\001 \001(\0162$.tensorflo"
+  "w.SessionLog.SessionStatus\022\027\n\017checkpoint"
+  "_path\030\002 \001(\t\022\013\n\003msg\030\003 \001(\t\"L\n\rSessionStatu"
+  "s\022\026\n\022STATUS_UNSPECIFIED\020\000\022\t\n\005START\020\001\022\010\n\004"
+  "STOP\020\002\022\016\n\nCHECKPOINT\020\003\"6\n\021TaggedRunMetad"
+  "ata\022\013\n\003tag\030\001 \001(\t\022\024\n\014run_metadata\030\002 \001(\014*\302"
+  "\005\n\010DataType\022\016\n\nDT_INVALID\020\000\022\014\n\010DT_FLOAT\020"
+  "\001\022\r\n\tDT_DOUBLE\020\002\022\014\n\010DT_INT32\020\003\022\014\n\010DT_UIN"
+  "T8\020\004\022\014\n\010DT_INT16\020\005\022\013\n\007DT_INT8\020\006\022\r\n\tDT_ST"
+  "RING\020\007\022\020\n\014DT_COMPLEX64\020\010\022\014\n\010DT_INT64\020\t\022\013"
+  "\n\007DT_BOOL\020\n\022\014\n\010DT_QINT8\020\013\022\r\n\tDT_QUINT8\020\014"
+  "\022\r\n\tDT_QINT32\020\r\022\017\n\013DT_BFLOAT16\020\016\022\r\n\tDT_Q"
+  "INT16\020\017\022\016\n\nDT_QUINT16\020\020\022\r\n\tDT_UINT16\020\021\022\021"
+  "\n\rDT_COMPLEX128\020\022\022\013\n\007DT_HALF\020\023\022\017\n\013DT_RES"
+  "OURCE\020\024\022\020\n\014DT_FLOAT_REF\020e\022\021\n\rDT_DOUBLE_R"
+  "EF\020f\022\020\n\014DT_INT32_REF\020g\022\020\n\014DT_UINT8_REF\020h"
+  "\022\020\n\014DT_INT16_REF\020i\022\017\n\013DT_INT8_REF\020j\022\021\n\rD"
+  "T_STRING_REF\020k\022\024\n\020DT_COMPLEX64_REF\020l\022\020\n\014"
+  "DT_INT64_REF\020m\022\017\n\013DT_BOOL_REF\020n\022\020\n\014DT_QI"
+  "NT8_REF\020o\022\021\n\rDT_QUINT8_REF\020p\022\021\n\rDT_QINT3"
+  "2_REF\020q\022\023\n\017DT_BFLOAT16_REF\020r\022\021\n\rDT_QINT1"
+  "6_REF\020s\022\022\n\016DT_QUINT16_REF\020t\022\021\n\rDT_UINT16"
+  "_REF\020u\022\025\n\021DT_COMPLEX128_REF\020v\022\017\n\013DT_HALF"
+  "_REF\020w\022\023\n\017DT_RESOURCE_REF\020xB\003\370\001\001b\006proto3"
+  ;
+static ::_pbi::once_flag descriptor_table_tensorboard_2eproto_once;
+const ::_pbi::DescriptorTable descriptor_table_tensorboard_2eproto = {
+    false, false, 3720, descriptor_table_protodef_tensorboard_2eproto,
+    "tensorboard.proto",
+    &descriptor_table_tensorboard_2eproto_once, nullptr, 0, 21,
+    schemas, file_default_instances, TableStruct_tensorboard_2eproto::offsets,
+    file_level_metadata_tensorboard_2eproto, file_level_enum_descriptors_tensorboard_2eproto,
+    file_level_service_descriptors_tensorboard_2eproto,
+};
+PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_tensorboard_2eproto_getter() {
+  return &descriptor_table_tensorboard_2eproto;
+}
+
+// Force running AddDescriptors() at dynamic initialization time.
+PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_tensorboard_2eproto(&descriptor_table_tensorboard_2eproto);
+namespace tensorflow {
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* LogMessage_Level_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_tensorboard_2eproto);
+  return file_level_enum_descriptors_tensorboard_2eproto[0];
+}
+bool LogMessage_Level_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 10:
+    case 20:
+    case 30:
+    case 40:
+    case 50:
+      return true;
+    default:
+      return false;
+  }
+}
+
+#if (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+constexpr LogMessage_Level LogMessage::UNKNOWN;
+constexpr LogMessage_Level LogMessage::DEBUG;
+constexpr LogMessage_Level LogMessage::INFO;
+constexpr LogMessage_Level LogMessage::WARN;
+constexpr LogMessage_Level LogMessage::ERROR;
+constexpr LogMessage_Level LogMessage::FATAL;
+constexpr LogMessage_Level LogMessage::Level_MIN;
+constexpr LogMessage_Level LogMessage::Level_MAX;
+constexpr int LogMessage::Level_ARRAYSIZE;
+#endif  // (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* SessionLog_SessionStatus_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_tensorboard_2eproto);
+  return file_level_enum_descriptors_tensorboard_2eproto[1];
+}
+bool SessionLog_SessionStatus_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+      return true;
+    default:
+      return false;
+  }
+}
+
+#if (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+constexpr SessionLog_SessionStatus SessionLog::STATUS_UNSPECIFIED;
+constexpr SessionLog_SessionStatus SessionLog::START;
+constexpr SessionLog_SessionStatus SessionLog::STOP;
+constexpr SessionLog_SessionStatus SessionLog::CHECKPOINT;
+constexpr SessionLog_SessionStatus SessionLog::SessionStatus_MIN;
+constexpr SessionLog_SessionStatus SessionLog::SessionStatus_MAX;
+constexpr int SessionLog::SessionStatus_ARRAYSIZE;
+#endif  // (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* DataType_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_tensorboard_2eproto);
+  return file_level_enum_descriptors_tensorboard_2eproto[2];
+}
+bool DataType_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+    case 6:
+    case 7:
+    case 8:
+    case 9:
+    case 10:
+    case 11:
+    case 12:
+    case 13:
+    case 14:
+    case 15:
+    case 16:
+    case 17:
+    case 18:
+    case 19:
+    case 20:
+    case 101:
+    case 102:
+    case 103:
+    case 104:
+    case 105:
+    case 106:
+    case 107:
+    case 108:
+    case 109:
+    case 110:
+    case 111:
+    case 112:
+    case 113:
+    case 114:
+    case 115:
+    case 116:
+    case 117:
+    case 118:
+    case 119:
+    case 120:
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+// ===================================================================
+
+class TensorShapeProto_Dim::_Internal {
+ public:
+};
+
+TensorShapeProto_Dim::TensorShapeProto_Dim(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.TensorShapeProto.Dim)
+}
+TensorShapeProto_Dim::TensorShapeProto_Dim(const TensorShapeProto_Dim& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  TensorShapeProto_Dim* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.name_){}
+    , decltype(_impl_.size_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_name().empty()) {
+    _this->_impl_.name_.Set(from._internal_name(), 
+      _this->GetArenaForAllocation());
+  }
+  _this->_impl_.size_ = from._impl_.size_;
+  // @@protoc_insertion_point(copy_constructor:tensorflow.TensorShapeProto.Dim)
+}
+
+inline void TensorShapeProto_Dim::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.name_){}
+    , decltype(_impl_.size_){int64_t{0}}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+TensorShapeProto_Dim::~TensorShapeProto_Dim() {
+  // @@protoc_insertion_point(destructor:tensorflow.TensorShapeProto.Dim)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void TensorShapeProto_Dim::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.name_.Destroy();
+}
+
+void TensorShapeProto_Dim::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void TensorShapeProto_Dim::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.TensorShapeProto.Dim)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.name_.ClearToEmpty();
+  _impl_.size_ = int64_t{0};
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* TensorShapeProto_Dim::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // int64 size = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string name = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_name();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.TensorShapeProto.Dim.name"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* TensorShapeProto_Dim::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.TensorShapeProto.Dim)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // int64 size = 1;
+  if (this->_internal_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(1, this->_internal_size(), target);
+  }
+
+  // string name = 2;
+  if (!this->_internal_name().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_name().data(), static_cast<int>(this->_internal_name().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.TensorShapeProto.Dim.name");
+    target = stream->WriteStringMaybeAliased(
+        2, this->_internal_name(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.TensorShapeProto.Dim)
+  return target;
+}
+
+size_t TensorShapeProto_Dim::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.TensorShapeProto.Dim)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string name = 2;
+  if (!this->_internal_name().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_name());
+  }
+
+  // int64 size = 1;
+  if (this->_internal_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_size());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData TensorShapeProto_Dim::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    TensorShapeProto_Dim::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*TensorShapeProto_Dim::GetClassData() const { return &_class_data_; }
+
+
+void TensorShapeProto_Dim::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<TensorShapeProto_Dim*>(&to_msg);
+  auto& from = static_cast<const TensorShapeProto_Dim&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.TensorShapeProto.Dim)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_name().empty()) {
+    _this->_internal_set_name(from._internal_name());
+  }
+  if (from._internal_size() != 0) {
+    _this->_internal_set_size(from._internal_size());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void TensorShapeProto_Dim::CopyFrom(const TensorShapeProto_Dim& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.TensorShapeProto.Dim)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool TensorShapeProto_Dim::IsInitialized() const {
+  return true;
+}
+
+void TensorShapeProto_Dim::InternalSwap(TensorShapeProto_Dim* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.name_, lhs_arena,
+      &other->_impl_.name_, rhs_arena
+  );
+  swap(_impl_.size_, other->_impl_.size_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata TensorShapeProto_Dim::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[0]);
+}
+
+// ===================================================================
+
+class TensorShapeProto::_Internal {
+ public:
+};
+
+TensorShapeProto::TensorShapeProto(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.TensorShapeProto)
+}
+TensorShapeProto::TensorShapeProto(const TensorShapeProto& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  TensorShapeProto* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.dim_){from._impl_.dim_}
+    , decltype(_impl_.unknown_rank_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_impl_.unknown_rank_ = from._impl_.unknown_rank_;
+  // @@protoc_insertion_point(copy_constructor:tensorflow.TensorShapeProto)
+}
+
+inline void TensorShapeProto::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.dim_){arena}
+    , decltype(_impl_.unknown_rank_){false}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+TensorShapeProto::~TensorShapeProto() {
+  // @@protoc_insertion_point(destructor:tensorflow.TensorShapeProto)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void TensorShapeProto::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.dim_.~RepeatedPtrField();
+}
+
+void TensorShapeProto::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void TensorShapeProto::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.TensorShapeProto)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.dim_.Clear();
+  _impl_.unknown_rank_ = false;
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* TensorShapeProto::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .tensorflow.TensorShapeProto.Dim dim = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_dim(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<18>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // bool unknown_rank = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.unknown_rank_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* TensorShapeProto::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.TensorShapeProto)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .tensorflow.TensorShapeProto.Dim dim = 2;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_dim_size()); i < n; i++) {
+    const auto& repfield = this->_internal_dim(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(2, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  // bool unknown_rank = 3;
+  if (this->_internal_unknown_rank() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(3, this->_internal_unknown_rank(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.TensorShapeProto)
+  return target;
+}
+
+size_t TensorShapeProto::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.TensorShapeProto)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .tensorflow.TensorShapeProto.Dim dim = 2;
+  total_size += 1UL * this->_internal_dim_size();
+  for (const auto& msg : this->_impl_.dim_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  // bool unknown_rank = 3;
+  if (this->_internal_unknown_rank() != 0) {
+    total_size += 1 + 1;
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData TensorShapeProto::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    TensorShapeProto::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*TensorShapeProto::GetClassData() const { return &_class_data_; }
+
+
+void TensorShapeProto::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<TensorShapeProto*>(&to_msg);
+  auto& from = static_cast<const TensorShapeProto&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.TensorShapeProto)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.dim_.MergeFrom(from._impl_.dim_);
+  if (from._internal_unknown_rank() != 0) {
+    _this->_internal_set_unknown_rank(from._internal_unknown_rank());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void TensorShapeProto::CopyFrom(const TensorShapeProto& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.TensorShapeProto)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool TensorShapeProto::IsInitialized() const {
+  return true;
+}
+
+void TensorShapeProto::InternalSwap(TensorShapeProto* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.dim_.InternalSwap(&other->_impl_.dim_);
+  swap(_impl_.unknown_rank_, other->_impl_.unknown_rank_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata TensorShapeProto::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[1]);
+}
+
+// ===================================================================
+
+class TensorProto::_Internal {
+ public:
+  static const ::tensorflow::TensorShapeProto& tensor_shape(const TensorProto* msg);
+};
+
+const ::tensorflow::TensorShapeProto&
+TensorProto::_Internal::tensor_shape(const TensorProto* msg) {
+  return *msg->_impl_.tensor_shape_;
+}
+TensorProto::TensorProto(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.TensorProto)
+}
+TensorProto::TensorProto(const TensorProto& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  TensorProto* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.float_val_){from._impl_.float_val_}
+    , decltype(_impl_.double_val_){from._impl_.double_val_}
+    , decltype(_impl_.int_val_){from._impl_.int_val_}
+    , /*decltype(_impl_._int_val_cached_byte_size_)*/{0}
+    , decltype(_impl_.string_val_){from._impl_.string_val_}
+    , decltype(_impl_.scomplex_val_){from._impl_.scomplex_val_}
+    , decltype(_impl_.int64_val_){from._impl_.int64_val_}
+    , /*decltype(_impl_._int64_val_cached_byte_size_)*/{0}
+    , decltype(_impl_.bool_val_){from._impl_.bool_val_}
+    , decltype(_impl_.dcomplex_val_){from._impl_.dcomplex_val_}
+    , decltype(_impl_.half_val_){from._impl_.half_val_}
+    , /*decltype(_impl_._half_val_cached_byte_size_)*/{0}
+    , decltype(_impl_.tensor_content_){}
+    , decltype(_impl_.tensor_shape_){nullptr}
+    , decltype(_impl_.dtype_){}
+    , decltype(_impl_.version_number_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.tensor_content_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.tensor_content_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_tensor_content().empty()) {
+    _this->_impl_.tensor_content_.Set(from._internal_tensor_content(), 
+      _this->GetArenaForAllocation());
+  }
+  if (from._internal_has_tensor_shape()) {
+    _this->_impl_.tensor_shape_ = new ::tensorflow::TensorShapeProto(*from._impl_.tensor_shape_);
+  }
+  ::memcpy(&_impl_.dtype_, &from._impl_.dtype_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.version_number_) -
+    reinterpret_cast<char*>(&_impl_.dtype_)) + sizeof(_impl_.version_number_));
+  // @@protoc_insertion_point(copy_constructor:tensorflow.TensorProto)
+}
+
+inline void TensorProto::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.float_val_){arena}
+    , decltype(_impl_.double_val_){arena}
+    , decltype(_impl_.int_val_){arena}
+    , /*decltype(_impl_._int_val_cached_byte_size_)*/{0}
+    , decltype(_impl_.string_val_){arena}
+    , decltype(_impl_.scomplex_val_){arena}
+    , decltype(_impl_.int64_val_){arena}
+    , /*decltype(_impl_._int64_val_cached_byte_size_)*/{0}
+    , decltype(_impl_.bool_val_){arena}
+    , decltype(_impl_.dcomplex_val_){arena}
+    , decltype(_impl_.half_val_){arena}
+    , /*decltype(_impl_._half_val_cached_byte_size_)*/{0}
+    , decltype(_impl_.tensor_content_){}
+    , decltype(_impl_.tensor_shape_){nullptr}
+    , decltype(_impl_.dtype_){0}
+    , decltype(_impl_.version_number_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.tensor_content_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.tensor_content_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+TensorProto::~TensorProto() {
+  // @@protoc_insertion_point(destructor:tensorflow.TensorProto)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void TensorProto::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.float_val_.~RepeatedField();
+  _impl_.double_val_.~RepeatedField();
+  _impl_.int_val_.~RepeatedField();
+  _impl_.string_val_.~RepeatedPtrField();
+  _impl_.scomplex_val_.~RepeatedField();
+  _impl_.int64_val_.~RepeatedField();
+  _impl_.bool_val_.~RepeatedField();
+  _impl_.dcomplex_val_.~RepeatedField();
+  _impl_.half_val_.~RepeatedField();
+  _impl_.tensor_content_.Destroy();
+  if (this != internal_default_instance()) delete _impl_.tensor_shape_;
+}
+
+void TensorProto::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void TensorProto::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.TensorProto)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.float_val_.Clear();
+  _impl_.double_val_.Clear();
+  _impl_.int_val_.Clear();
+  _impl_.string_val_.Clear();
+  _impl_.scomplex_val_.Clear();
+  _impl_.int64_val_.Clear();
+  _impl_.bool_val_.Clear();
+  _impl_.dcomplex_val_.Clear();
+  _impl_.half_val_.Clear();
+  _impl_.tensor_content_.ClearToEmpty();
+  if (GetArenaForAllocation() == nullptr && _impl_.tensor_shape_ != nullptr) {
+    delete _impl_.tensor_shape_;
+  }
+  _impl_.tensor_shape_ = nullptr;
+  ::memset(&_impl_.dtype_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.version_number_) -
+      reinterpret_cast<char*>(&_impl_.dtype_)) + sizeof(_impl_.version_number_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* TensorProto::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // .tensorflow.DataType dtype = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_dtype(static_cast<::tensorflow::DataType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.TensorShapeProto tensor_shape = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          ptr = ctx->ParseMessage(_internal_mutable_tensor_shape(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 version_number = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.version_number_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes tensor_content = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          auto str = _internal_mutable_tensor_content();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated float float_val = 5 [packed = true];
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedFloatParser(_internal_mutable_float_val(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 45) {
+          _internal_add_float_val(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<float>(ptr));
+          ptr += sizeof(float);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated double double_val = 6 [packed = true];
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedDoubleParser(_internal_mutable_double_val(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 49) {
+          _internal_add_double_val(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr));
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated int32 int_val = 7 [packed = true];
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 58)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedInt32Parser(_internal_mutable_int_val(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 56) {
+          _internal_add_int_val(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated bytes string_val = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 66)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            auto str = _internal_add_string_val();
+            ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<66>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated float scomplex_val = 9 [packed = true];
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 74)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedFloatParser(_internal_mutable_scomplex_val(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 77) {
+          _internal_add_scomplex_val(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<float>(ptr));
+          ptr += sizeof(float);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated int64 int64_val = 10 [packed = true];
+      case 10:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 82)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedInt64Parser(_internal_mutable_int64_val(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 80) {
+          _internal_add_int64_val(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated bool bool_val = 11 [packed = true];
+      case 11:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 90)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedBoolParser(_internal_mutable_bool_val(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 88) {
+          _internal_add_bool_val(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated double dcomplex_val = 12 [packed = true];
+      case 12:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 98)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedDoubleParser(_internal_mutable_dcomplex_val(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 97) {
+          _internal_add_dcomplex_val(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr));
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated int32 half_val = 13 [packed = true];
+      case 13:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 106)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedInt32Parser(_internal_mutable_half_val(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 104) {
+          _internal_add_half_val(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* TensorProto::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.TensorProto)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .tensorflow.DataType dtype = 1;
+  if (this->_internal_dtype() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      1, this->_internal_dtype(), target);
+  }
+
+  // .tensorflow.TensorShapeProto tensor_shape = 2;
+  if (this->_internal_has_tensor_shape()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(2, _Internal::tensor_shape(this),
+        _Internal::tensor_shape(this).GetCachedSize(), target, stream);
+  }
+
+  // int32 version_number = 3;
+  if (this->_internal_version_number() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(3, this->_internal_version_number(), target);
+  }
+
+  // bytes tensor_content = 4;
+  if (!this->_internal_tensor_content().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        4, this->_internal_tensor_content(), target);
+  }
+
+  // repeated float float_val = 5 [packed = true];
+  if (this->_internal_float_val_size() > 0) {
+    target = stream->WriteFixedPacked(5, _internal_float_val(), target);
+  }
+
+  // repeated double double_val = 6 [packed = true];
+  if (this->_internal_double_val_size() > 0) {
+    target = stream->WriteFixedPacked(6, _internal_double_val(), target);
+  }
+
+  // repeated int32 int_val = 7 [packed = true];
+  {
+    int byte_size = _impl_._int_val_cached_byte_size_.load(std::memory_order_relaxed);
+    if (byte_size > 0) {
+      target = stream->WriteInt32Packed(
+          7, _internal_int_val(), byte_size, target);
+    }
+  }
+
+  // repeated bytes string_val = 8;
+  for (int i = 0, n = this->_internal_string_val_size(); i < n; i++) {
+    const auto& s = this->_internal_string_val(i);
+    target = stream->WriteBytes(8, s, target);
+  }
+
+  // repeated float scomplex_val = 9 [packed = true];
+  if (this->_internal_scomplex_val_size() > 0) {
+    target = stream->WriteFixedPacked(9, _internal_scomplex_val(), target);
+  }
+
+  // repeated int64 int64_val = 10 [packed = true];
+  {
+    int byte_size = _impl_._int64_val_cached_byte_size_.load(std::memory_order_relaxed);
+    if (byte_size > 0) {
+      target = stream->WriteInt64Packed(
+          10, _internal_int64_val(), byte_size, target);
+    }
+  }
+
+  // repeated bool bool_val = 11 [packed = true];
+  if (this->_internal_bool_val_size() > 0) {
+    target = stream->WriteFixedPacked(11, _internal_bool_val(), target);
+  }
+
+  // repeated double dcomplex_val = 12 [packed = true];
+  if (this->_internal_dcomplex_val_size() > 0) {
+    target = stream->WriteFixedPacked(12, _internal_dcomplex_val(), target);
+  }
+
+  // repeated int32 half_val = 13 [packed = true];
+  {
+    int byte_size = _impl_._half_val_cached_byte_size_.load(std::memory_order_relaxed);
+    if (byte_size > 0) {
+      target = stream->WriteInt32Packed(
+          13, _internal_half_val(), byte_size, target);
+    }
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.TensorProto)
+  return target;
+}
+
+size_t TensorProto::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.TensorProto)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated float float_val = 5 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_float_val_size());
+    size_t data_size = 4UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // repeated double double_val = 6 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_double_val_size());
+    size_t data_size = 8UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // repeated int32 int_val = 7 [packed = true];
+  {
+    size_t data_size = ::_pbi::WireFormatLite::
+      Int32Size(this->_impl_.int_val_);
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    int cached_size = ::_pbi::ToCachedSize(data_size);
+    _impl_._int_val_cached_byte_size_.store(cached_size,
+                                    std::memory_order_relaxed);
+    total_size += data_size;
+  }
+
+  // repeated bytes string_val = 8;
+  total_size += 1 *
+      ::PROTOBUF_NAMESPACE_ID::internal::FromIntSize(_impl_.string_val_.size());
+  for (int i = 0, n = _impl_.string_val_.size(); i < n; i++) {
+    total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+      _impl_.string_val_.Get(i));
+  }
+
+  // repeated float scomplex_val = 9 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_scomplex_val_size());
+    size_t data_size = 4UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // repeated int64 int64_val = 10 [packed = true];
+  {
+    size_t data_size = ::_pbi::WireFormatLite::
+      Int64Size(this->_impl_.int64_val_);
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    int cached_size = ::_pbi::ToCachedSize(data_size);
+    _impl_._int64_val_cached_byte_size_.store(cached_size,
+                                    std::memory_order_relaxed);
+    total_size += data_size;
+  }
+
+  // repeated bool bool_val = 11 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_bool_val_size());
+    size_t data_size = 1UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // repeated double dcomplex_val = 12 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_dcomplex_val_size());
+    size_t data_size = 8UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // repeated int32 half_val = 13 [packed = true];
+  {
+    size_t data_size = ::_pbi::WireFormatLite::
+      Int32Size(this->_impl_.half_val_);
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    int cached_size = ::_pbi::ToCachedSize(data_size);
+    _impl_._half_val_cached_byte_size_.store(cached_size,
+                                    std::memory_order_relaxed);
+    total_size += data_size;
+  }
+
+  // bytes tensor_content = 4;
+  if (!this->_internal_tensor_content().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_tensor_content());
+  }
+
+  // .tensorflow.TensorShapeProto tensor_shape = 2;
+  if (this->_internal_has_tensor_shape()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.tensor_shape_);
+  }
+
+  // .tensorflow.DataType dtype = 1;
+  if (this->_internal_dtype() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_dtype());
+  }
+
+  // int32 version_number = 3;
+  if (this->_internal_version_number() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_version_number());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData TensorProto::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    TensorProto::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*TensorProto::GetClassData() const { return &_class_data_; }
+
+
+void TensorProto::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<TensorProto*>(&to_msg);
+  auto& from = static_cast<const TensorProto&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.TensorProto)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.float_val_.MergeFrom(from._impl_.float_val_);
+  _this->_impl_.double_val_.MergeFrom(from._impl_.double_val_);
+  _this->_impl_.int_val_.MergeFrom(from._impl_.int_val_);
+  _this->_impl_.string_val_.MergeFrom(from._impl_.string_val_);
+  _this->_impl_.scomplex_val_.MergeFrom(from._impl_.scomplex_val_);
+  _this->_impl_.int64_val_.MergeFrom(from._impl_.int64_val_);
+  _this->_impl_.bool_val_.MergeFrom(from._impl_.bool_val_);
+  _this->_impl_.dcomplex_val_.MergeFrom(from._impl_.dcomplex_val_);
+  _this->_impl_.half_val_.MergeFrom(from._impl_.half_val_);
+  if (!from._internal_tensor_content().empty()) {
+    _this->_internal_set_tensor_content(from._internal_tensor_content());
+  }
+  if (from._internal_has_tensor_shape()) {
+    _this->_internal_mutable_tensor_shape()->::tensorflow::TensorShapeProto::MergeFrom(
+        from._internal_tensor_shape());
+  }
+  if (from._internal_dtype() != 0) {
+    _this->_internal_set_dtype(from._internal_dtype());
+  }
+  if (from._internal_version_number() != 0) {
+    _this->_internal_set_version_number(from._internal_version_number());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void TensorProto::CopyFrom(const TensorProto& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.TensorProto)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool TensorProto::IsInitialized() const {
+  return true;
+}
+
+void TensorProto::InternalSwap(TensorProto* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.float_val_.InternalSwap(&other->_impl_.float_val_);
+  _impl_.double_val_.InternalSwap(&other->_impl_.double_val_);
+  _impl_.int_val_.InternalSwap(&other->_impl_.int_val_);
+  _impl_.string_val_.InternalSwap(&other->_impl_.string_val_);
+  _impl_.scomplex_val_.InternalSwap(&other->_impl_.scomplex_val_);
+  _impl_.int64_val_.InternalSwap(&other->_impl_.int64_val_);
+  _impl_.bool_val_.InternalSwap(&other->_impl_.bool_val_);
+  _impl_.dcomplex_val_.InternalSwap(&other->_impl_.dcomplex_val_);
+  _impl_.half_val_.InternalSwap(&other->_impl_.half_val_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.tensor_content_, lhs_arena,
+      &other->_impl_.tensor_content_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(TensorProto, _impl_.version_number_)
+      + sizeof(TensorProto::_impl_.version_number_)
+      - PROTOBUF_FIELD_OFFSET(TensorProto, _impl_.tensor_shape_)>(
+          reinterpret_cast<char*>(&_impl_.tensor_shape_),
+          reinterpret_cast<char*>(&other->_impl_.tensor_shape_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata TensorProto::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[2]);
+}
+
+// ===================================================================
+
+class VersionDef::_Internal {
+ public:
+};
+
+VersionDef::VersionDef(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.VersionDef)
+}
+VersionDef::VersionDef(const VersionDef& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  VersionDef* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.bad_consumers_){from._impl_.bad_consumers_}
+    , /*decltype(_impl_._bad_consumers_cached_byte_size_)*/{0}
+    , decltype(_impl_.producer_){}
+    , decltype(_impl_.min_consumer_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.producer_, &from._impl_.producer_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.min_consumer_) -
+    reinterpret_cast<char*>(&_impl_.producer_)) + sizeof(_impl_.min_consumer_));
+  // @@protoc_insertion_point(copy_constructor:tensorflow.VersionDef)
+}
+
+inline void VersionDef::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.bad_consumers_){arena}
+    , /*decltype(_impl_._bad_consumers_cached_byte_size_)*/{0}
+    , decltype(_impl_.producer_){0}
+    , decltype(_impl_.min_consumer_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+VersionDef::~VersionDef() {
+  // @@protoc_insertion_point(destructor:tensorflow.VersionDef)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void VersionDef::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.bad_consumers_.~RepeatedField();
+}
+
+void VersionDef::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void VersionDef::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.VersionDef)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.bad_consumers_.Clear();
+  ::memset(&_impl_.producer_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.min_consumer_) -
+      reinterpret_cast<char*>(&_impl_.producer_)) + sizeof(_impl_.min_consumer_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* VersionDef::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // int32 producer = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.producer_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 min_consumer = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.min_consumer_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated int32 bad_consumers = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedInt32Parser(_internal_mutable_bad_consumers(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 24) {
+          _internal_add_bad_consumers(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* VersionDef::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.VersionDef)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // int32 producer = 1;
+  if (this->_internal_producer() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(1, this->_internal_producer(), target);
+  }
+
+  // int32 min_consumer = 2;
+  if (this->_internal_min_consumer() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(2, this->_internal_min_consumer(), target);
+  }
+
+  // repeated int32 bad_consumers = 3;
+  {
+    int byte_size = _impl_._bad_consumers_cached_byte_size_.load(std::memory_order_relaxed);
+    if (byte_size > 0) {
+      target = stream->WriteInt32Packed(
+          3, _internal_bad_consumers(), byte_size, target);
+    }
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.VersionDef)
+  return target;
+}
+
+size_t VersionDef::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.VersionDef)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated int32 bad_consumers = 3;
+  {
+    size_t data_size = ::_pbi::WireFormatLite::
+      Int32Size(this->_impl_.bad_consumers_);
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    int cached_size = ::_pbi::ToCachedSize(data_size);
+    _impl_._bad_consumers_cached_byte_size_.store(cached_size,
+                                    std::memory_order_relaxed);
+    total_size += data_size;
+  }
+
+  // int32 producer = 1;
+  if (this->_internal_producer() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_producer());
+  }
+
+  // int32 min_consumer = 2;
+  if (this->_internal_min_consumer() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_min_consumer());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData VersionDef::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    VersionDef::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*VersionDef::GetClassData() const { return &_class_data_; }
+
+
+void VersionDef::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<VersionDef*>(&to_msg);
+  auto& from = static_cast<const VersionDef&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.VersionDef)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.bad_consumers_.MergeFrom(from._impl_.bad_consumers_);
+  if (from._internal_producer() != 0) {
+    _this->_internal_set_producer(from._internal_producer());
+  }
+  if (from._internal_min_consumer() != 0) {
+    _this->_internal_set_min_consumer(from._internal_min_consumer());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void VersionDef::CopyFrom(const VersionDef& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.VersionDef)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool VersionDef::IsInitialized() const {
+  return true;
+}
+
+void VersionDef::InternalSwap(VersionDef* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.bad_consumers_.InternalSwap(&other->_impl_.bad_consumers_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(VersionDef, _impl_.min_consumer_)
+      + sizeof(VersionDef::_impl_.min_consumer_)
+      - PROTOBUF_FIELD_OFFSET(VersionDef, _impl_.producer_)>(
+          reinterpret_cast<char*>(&_impl_.producer_),
+          reinterpret_cast<char*>(&other->_impl_.producer_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata VersionDef::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[3]);
+}
+
+// ===================================================================
+
+class SummaryDescription::_Internal {
+ public:
+};
+
+SummaryDescription::SummaryDescription(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.SummaryDescription)
+}
+SummaryDescription::SummaryDescription(const SummaryDescription& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  SummaryDescription* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.type_hint_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.type_hint_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.type_hint_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_type_hint().empty()) {
+    _this->_impl_.type_hint_.Set(from._internal_type_hint(), 
+      _this->GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:tensorflow.SummaryDescription)
+}
+
+inline void SummaryDescription::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.type_hint_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.type_hint_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.type_hint_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+SummaryDescription::~SummaryDescription() {
+  // @@protoc_insertion_point(destructor:tensorflow.SummaryDescription)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void SummaryDescription::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.type_hint_.Destroy();
+}
+
+void SummaryDescription::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void SummaryDescription::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.SummaryDescription)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.type_hint_.ClearToEmpty();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* SummaryDescription::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string type_hint = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_type_hint();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.SummaryDescription.type_hint"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* SummaryDescription::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.SummaryDescription)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string type_hint = 1;
+  if (!this->_internal_type_hint().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_type_hint().data(), static_cast<int>(this->_internal_type_hint().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.SummaryDescription.type_hint");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_type_hint(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.SummaryDescription)
+  return target;
+}
+
+size_t SummaryDescription::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.SummaryDescription)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string type_hint = 1;
+  if (!this->_internal_type_hint().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_type_hint());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData SummaryDescription::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    SummaryDescription::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*SummaryDescription::GetClassData() const { return &_class_data_; }
+
+
+void SummaryDescription::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<SummaryDescription*>(&to_msg);
+  auto& from = static_cast<const SummaryDescription&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.SummaryDescription)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_type_hint().empty()) {
+    _this->_internal_set_type_hint(from._internal_type_hint());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void SummaryDescription::CopyFrom(const SummaryDescription& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.SummaryDescription)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool SummaryDescription::IsInitialized() const {
+  return true;
+}
+
+void SummaryDescription::InternalSwap(SummaryDescription* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.type_hint_, lhs_arena,
+      &other->_impl_.type_hint_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata SummaryDescription::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[4]);
+}
+
+// ===================================================================
+
+class HistogramProto::_Internal {
+ public:
+};
+
+HistogramProto::HistogramProto(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.HistogramProto)
+}
+HistogramProto::HistogramProto(const HistogramProto& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  HistogramProto* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.bucket_limit_){from._impl_.bucket_limit_}
+    , decltype(_impl_.bucket_){from._impl_.bucket_}
+    , decltype(_impl_.min_){}
+    , decltype(_impl_.max_){}
+    , decltype(_impl_.num_){}
+    , decltype(_impl_.sum_){}
+    , decltype(_impl_.sum_squares_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.min_, &from._impl_.min_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.sum_squares_) -
+    reinterpret_cast<char*>(&_impl_.min_)) + sizeof(_impl_.sum_squares_));
+  // @@protoc_insertion_point(copy_constructor:tensorflow.HistogramProto)
+}
+
+inline void HistogramProto::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.bucket_limit_){arena}
+    , decltype(_impl_.bucket_){arena}
+    , decltype(_impl_.min_){0}
+    , decltype(_impl_.max_){0}
+    , decltype(_impl_.num_){0}
+    , decltype(_impl_.sum_){0}
+    , decltype(_impl_.sum_squares_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+HistogramProto::~HistogramProto() {
+  // @@protoc_insertion_point(destructor:tensorflow.HistogramProto)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void HistogramProto::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.bucket_limit_.~RepeatedField();
+  _impl_.bucket_.~RepeatedField();
+}
+
+void HistogramProto::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void HistogramProto::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.HistogramProto)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.bucket_limit_.Clear();
+  _impl_.bucket_.Clear();
+  ::memset(&_impl_.min_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.sum_squares_) -
+      reinterpret_cast<char*>(&_impl_.min_)) + sizeof(_impl_.sum_squares_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* HistogramProto::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // double min = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 9)) {
+          _impl_.min_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr);
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // double max = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 17)) {
+          _impl_.max_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr);
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // double num = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 25)) {
+          _impl_.num_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr);
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // double sum = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 33)) {
+          _impl_.sum_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr);
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // double sum_squares = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 41)) {
+          _impl_.sum_squares_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr);
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated double bucket_limit = 6 [packed = true];
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedDoubleParser(_internal_mutable_bucket_limit(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 49) {
+          _internal_add_bucket_limit(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr));
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated double bucket = 7 [packed = true];
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 58)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedDoubleParser(_internal_mutable_bucket(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 57) {
+          _internal_add_bucket(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr));
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* HistogramProto::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.HistogramProto)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // double min = 1;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_min = this->_internal_min();
+  uint64_t raw_min;
+  memcpy(&raw_min, &tmp_min, sizeof(tmp_min));
+  if (raw_min != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteDoubleToArray(1, this->_internal_min(), target);
+  }
+
+  // double max = 2;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_max = this->_internal_max();
+  uint64_t raw_max;
+  memcpy(&raw_max, &tmp_max, sizeof(tmp_max));
+  if (raw_max != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteDoubleToArray(2, this->_internal_max(), target);
+  }
+
+  // double num = 3;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_num = this->_internal_num();
+  uint64_t raw_num;
+  memcpy(&raw_num, &tmp_num, sizeof(tmp_num));
+  if (raw_num != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteDoubleToArray(3, this->_internal_num(), target);
+  }
+
+  // double sum = 4;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_sum = this->_internal_sum();
+  uint64_t raw_sum;
+  memcpy(&raw_sum, &tmp_sum, sizeof(tmp_sum));
+  if (raw_sum != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteDoubleToArray(4, this->_internal_sum(), target);
+  }
+
+  // double sum_squares = 5;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_sum_squares = this->_internal_sum_squares();
+  uint64_t raw_sum_squares;
+  memcpy(&raw_sum_squares, &tmp_sum_squares, sizeof(tmp_sum_squares));
+  if (raw_sum_squares != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteDoubleToArray(5, this->_internal_sum_squares(), target);
+  }
+
+  // repeated double bucket_limit = 6 [packed = true];
+  if (this->_internal_bucket_limit_size() > 0) {
+    target = stream->WriteFixedPacked(6, _internal_bucket_limit(), target);
+  }
+
+  // repeated double bucket = 7 [packed = true];
+  if (this->_internal_bucket_size() > 0) {
+    target = stream->WriteFixedPacked(7, _internal_bucket(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.HistogramProto)
+  return target;
+}
+
+size_t HistogramProto::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.HistogramProto)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated double bucket_limit = 6 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_bucket_limit_size());
+    size_t data_size = 8UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // repeated double bucket = 7 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_bucket_size());
+    size_t data_size = 8UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // double min = 1;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_min = this->_internal_min();
+  uint64_t raw_min;
+  memcpy(&raw_min, &tmp_min, sizeof(tmp_min));
+  if (raw_min != 0) {
+    total_size += 1 + 8;
+  }
+
+  // double max = 2;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_max = this->_internal_max();
+  uint64_t raw_max;
+  memcpy(&raw_max, &tmp_max, sizeof(tmp_max));
+  if (raw_max != 0) {
+    total_size += 1 + 8;
+  }
+
+  // double num = 3;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_num = this->_internal_num();
+  uint64_t raw_num;
+  memcpy(&raw_num, &tmp_num, sizeof(tmp_num));
+  if (raw_num != 0) {
+    total_size += 1 + 8;
+  }
+
+  // double sum = 4;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_sum = this->_internal_sum();
+  uint64_t raw_sum;
+  memcpy(&raw_sum, &tmp_sum, sizeof(tmp_sum));
+  if (raw_sum != 0) {
+    total_size += 1 + 8;
+  }
+
+  // double sum_squares = 5;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_sum_squares = this->_internal_sum_squares();
+  uint64_t raw_sum_squares;
+  memcpy(&raw_sum_squares, &tmp_sum_squares, sizeof(tmp_sum_squares));
+  if (raw_sum_squares != 0) {
+    total_size += 1 + 8;
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData HistogramProto::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    HistogramProto::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*HistogramProto::GetClassData() const { return &_class_data_; }
+
+
+void HistogramProto::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<HistogramProto*>(&to_msg);
+  auto& from = static_cast<const HistogramProto&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.HistogramProto)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.bucket_limit_.MergeFrom(from._impl_.bucket_limit_);
+  _this->_impl_.bucket_.MergeFrom(from._impl_.bucket_);
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_min = from._internal_min();
+  uint64_t raw_min;
+  memcpy(&raw_min, &tmp_min, sizeof(tmp_min));
+  if (raw_min != 0) {
+    _this->_internal_set_min(from._internal_min());
+  }
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_max = from._internal_max();
+  uint64_t raw_max;
+  memcpy(&raw_max, &tmp_max, sizeof(tmp_max));
+  if (raw_max != 0) {
+    _this->_internal_set_max(from._internal_max());
+  }
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_num = from._internal_num();
+  uint64_t raw_num;
+  memcpy(&raw_num, &tmp_num, sizeof(tmp_num));
+  if (raw_num != 0) {
+    _this->_internal_set_num(from._internal_num());
+  }
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_sum = from._internal_sum();
+  uint64_t raw_sum;
+  memcpy(&raw_sum, &tmp_sum, sizeof(tmp_sum));
+  if (raw_sum != 0) {
+    _this->_internal_set_sum(from._internal_sum());
+  }
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_sum_squares = from._internal_sum_squares();
+  uint64_t raw_sum_squares;
+  memcpy(&raw_sum_squares, &tmp_sum_squares, sizeof(tmp_sum_squares));
+  if (raw_sum_squares != 0) {
+    _this->_internal_set_sum_squares(from._internal_sum_squares());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void HistogramProto::CopyFrom(const HistogramProto& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.HistogramProto)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool HistogramProto::IsInitialized() const {
+  return true;
+}
+
+void HistogramProto::InternalSwap(HistogramProto* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.bucket_limit_.InternalSwap(&other->_impl_.bucket_limit_);
+  _impl_.bucket_.InternalSwap(&other->_impl_.bucket_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(HistogramProto, _impl_.sum_squares_)
+      + sizeof(HistogramProto::_impl_.sum_squares_)
+      - PROTOBUF_FIELD_OFFSET(HistogramProto, _impl_.min_)>(
+          reinterpret_cast<char*>(&_impl_.min_),
+          reinterpret_cast<char*>(&other->_impl_.min_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata HistogramProto::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[5]);
+}
+
+// ===================================================================
+
+class Summary_Image::_Internal {
+ public:
+};
+
+Summary_Image::Summary_Image(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.Summary.Image)
+}
+Summary_Image::Summary_Image(const Summary_Image& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Summary_Image* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.encoded_image_string_){}
+    , decltype(_impl_.height_){}
+    , decltype(_impl_.width_){}
+    , decltype(_impl_.colorspace_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.encoded_image_string_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.encoded_image_string_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_encoded_image_string().empty()) {
+    _this->_impl_.encoded_image_string_.Set(from._internal_encoded_image_string(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.height_, &from._impl_.height_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.colorspace_) -
+    reinterpret_cast<char*>(&_impl_.height_)) + sizeof(_impl_.colorspace_));
+  // @@protoc_insertion_point(copy_constructor:tensorflow.Summary.Image)
+}
+
+inline void Summary_Image::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.encoded_image_string_){}
+    , decltype(_impl_.height_){0}
+    , decltype(_impl_.width_){0}
+    , decltype(_impl_.colorspace_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.encoded_image_string_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.encoded_image_string_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+Summary_Image::~Summary_Image() {
+  // @@protoc_insertion_point(destructor:tensorflow.Summary.Image)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void Summary_Image::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.encoded_image_string_.Destroy();
+}
+
+void Summary_Image::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void Summary_Image::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.Summary.Image)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.encoded_image_string_.ClearToEmpty();
+  ::memset(&_impl_.height_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.colorspace_) -
+      reinterpret_cast<char*>(&_impl_.height_)) + sizeof(_impl_.colorspace_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Summary_Image::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // int32 height = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.height_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 width = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.width_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 colorspace = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.colorspace_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes encoded_image_string = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          auto str = _internal_mutable_encoded_image_string();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Summary_Image::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.Summary.Image)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // int32 height = 1;
+  if (this->_internal_height() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(1, this->_internal_height(), target);
+  }
+
+  // int32 width = 2;
+  if (this->_internal_width() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(2, this->_internal_width(), target);
+  }
+
+  // int32 colorspace = 3;
+  if (this->_internal_colorspace() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(3, this->_internal_colorspace(), target);
+  }
+
+  // bytes encoded_image_string = 4;
+  if (!this->_internal_encoded_image_string().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        4, this->_internal_encoded_image_string(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.Summary.Image)
+  return target;
+}
+
+size_t Summary_Image::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.Summary.Image)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes encoded_image_string = 4;
+  if (!this->_internal_encoded_image_string().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_encoded_image_string());
+  }
+
+  // int32 height = 1;
+  if (this->_internal_height() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_height());
+  }
+
+  // int32 width = 2;
+  if (this->_internal_width() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_width());
+  }
+
+  // int32 colorspace = 3;
+  if (this->_internal_colorspace() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_colorspace());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Summary_Image::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Summary_Image::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Summary_Image::GetClassData() const { return &_class_data_; }
+
+
+void Summary_Image::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Summary_Image*>(&to_msg);
+  auto& from = static_cast<const Summary_Image&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.Summary.Image)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_encoded_image_string().empty()) {
+    _this->_internal_set_encoded_image_string(from._internal_encoded_image_string());
+  }
+  if (from._internal_height() != 0) {
+    _this->_internal_set_height(from._internal_height());
+  }
+  if (from._internal_width() != 0) {
+    _this->_internal_set_width(from._internal_width());
+  }
+  if (from._internal_colorspace() != 0) {
+    _this->_internal_set_colorspace(from._internal_colorspace());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void Summary_Image::CopyFrom(const Summary_Image& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.Summary.Image)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Summary_Image::IsInitialized() const {
+  return true;
+}
+
+void Summary_Image::InternalSwap(Summary_Image* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.encoded_image_string_, lhs_arena,
+      &other->_impl_.encoded_image_string_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(Summary_Image, _impl_.colorspace_)
+      + sizeof(Summary_Image::_impl_.colorspace_)
+      - PROTOBUF_FIELD_OFFSET(Summary_Image, _impl_.height_)>(
+          reinterpret_cast<char*>(&_impl_.height_),
+          reinterpret_cast<char*>(&other->_impl_.height_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Summary_Image::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[6]);
+}
+
+// ===================================================================
+
+class Summary_Audio::_Internal {
+ public:
+};
+
+Summary_Audio::Summary_Audio(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.Summary.Audio)
+}
+Summary_Audio::Summary_Audio(const Summary_Audio& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Summary_Audio* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.encoded_audio_string_){}
+    , decltype(_impl_.content_type_){}
+    , decltype(_impl_.num_channels_){}
+    , decltype(_impl_.length_frames_){}
+    , decltype(_impl_.sample_rate_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.encoded_audio_string_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.encoded_audio_string_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_encoded_audio_string().empty()) {
+    _this->_impl_.encoded_audio_string_.Set(from._internal_encoded_audio_string(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.content_type_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.content_type_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_content_type().empty()) {
+    _this->_impl_.content_type_.Set(from._internal_content_type(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.num_channels_, &from._impl_.num_channels_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.sample_rate_) -
+    reinterpret_cast<char*>(&_impl_.num_channels_)) + sizeof(_impl_.sample_rate_));
+  // @@protoc_insertion_point(copy_constructor:tensorflow.Summary.Audio)
+}
+
+inline void Summary_Audio::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.encoded_audio_string_){}
+    , decltype(_impl_.content_type_){}
+    , decltype(_impl_.num_channels_){int64_t{0}}
+    , decltype(_impl_.length_frames_){int64_t{0}}
+    , decltype(_impl_.sample_rate_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.encoded_audio_string_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.encoded_audio_string_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.content_type_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.content_type_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+Summary_Audio::~Summary_Audio() {
+  // @@protoc_insertion_point(destructor:tensorflow.Summary.Audio)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void Summary_Audio::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.encoded_audio_string_.Destroy();
+  _impl_.content_type_.Destroy();
+}
+
+void Summary_Audio::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void Summary_Audio::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.Summary.Audio)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.encoded_audio_string_.ClearToEmpty();
+  _impl_.content_type_.ClearToEmpty();
+  ::memset(&_impl_.num_channels_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.sample_rate_) -
+      reinterpret_cast<char*>(&_impl_.num_channels_)) + sizeof(_impl_.sample_rate_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Summary_Audio::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // float sample_rate = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 13)) {
+          _impl_.sample_rate_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<float>(ptr);
+          ptr += sizeof(float);
+        } else
+          goto handle_unusual;
+        continue;
+      // int64 num_channels = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.num_channels_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int64 length_frames = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.length_frames_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes encoded_audio_string = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          auto str = _internal_mutable_encoded_audio_string();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string content_type = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          auto str = _internal_mutable_content_type();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.Summary.Audio.content_type"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Summary_Audio::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.Summary.Audio)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // float sample_rate = 1;
+  static_assert(sizeof(uint32_t) == sizeof(float), "Code assumes uint32_t and float are the same size.");
+  float tmp_sample_rate = this->_internal_sample_rate();
+  uint32_t raw_sample_rate;
+  memcpy(&raw_sample_rate, &tmp_sample_rate, sizeof(tmp_sample_rate));
+  if (raw_sample_rate != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFloatToArray(1, this->_internal_sample_rate(), target);
+  }
+
+  // int64 num_channels = 2;
+  if (this->_internal_num_channels() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(2, this->_internal_num_channels(), target);
+  }
+
+  // int64 length_frames = 3;
+  if (this->_internal_length_frames() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(3, this->_internal_length_frames(), target);
+  }
+
+  // bytes encoded_audio_string = 4;
+  if (!this->_internal_encoded_audio_string().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        4, this->_internal_encoded_audio_string(), target);
+  }
+
+  // string content_type = 5;
+  if (!this->_internal_content_type().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_content_type().data(), static_cast<int>(this->_internal_content_type().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.Summary.Audio.content_type");
+    target = stream->WriteStringMaybeAliased(
+        5, this->_internal_content_type(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.Summary.Audio)
+  return target;
+}
+
+size_t Summary_Audio::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.Summary.Audio)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes encoded_audio_string = 4;
+  if (!this->_internal_encoded_audio_string().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_encoded_audio_string());
+  }
+
+  // string content_type = 5;
+  if (!this->_internal_content_type().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_content_type());
+  }
+
+  // int64 num_channels = 2;
+  if (this->_internal_num_channels() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_num_channels());
+  }
+
+  // int64 length_frames = 3;
+  if (this->_internal_length_frames() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_length_frames());
+  }
+
+  // float sample_rate = 1;
+  static_assert(sizeof(uint32_t) == sizeof(float), "Code assumes uint32_t and float are the same size.");
+  float tmp_sample_rate = this->_internal_sample_rate();
+  uint32_t raw_sample_rate;
+  memcpy(&raw_sample_rate, &tmp_sample_rate, sizeof(tmp_sample_rate));
+  if (raw_sample_rate != 0) {
+    total_size += 1 + 4;
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Summary_Audio::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Summary_Audio::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Summary_Audio::GetClassData() const { return &_class_data_; }
+
+
+void Summary_Audio::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Summary_Audio*>(&to_msg);
+  auto& from = static_cast<const Summary_Audio&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.Summary.Audio)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_encoded_audio_string().empty()) {
+    _this->_internal_set_encoded_audio_string(from._internal_encoded_audio_string());
+  }
+  if (!from._internal_content_type().empty()) {
+    _this->_internal_set_content_type(from._internal_content_type());
+  }
+  if (from._internal_num_channels() != 0) {
+    _this->_internal_set_num_channels(from._internal_num_channels());
+  }
+  if (from._internal_length_frames() != 0) {
+    _this->_internal_set_length_frames(from._internal_length_frames());
+  }
+  static_assert(sizeof(uint32_t) == sizeof(float), "Code assumes uint32_t and float are the same size.");
+  float tmp_sample_rate = from._internal_sample_rate();
+  uint32_t raw_sample_rate;
+  memcpy(&raw_sample_rate, &tmp_sample_rate, sizeof(tmp_sample_rate));
+  if (raw_sample_rate != 0) {
+    _this->_internal_set_sample_rate(from._internal_sample_rate());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void Summary_Audio::CopyFrom(const Summary_Audio& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.Summary.Audio)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Summary_Audio::IsInitialized() const {
+  return true;
+}
+
+void Summary_Audio::InternalSwap(Summary_Audio* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.encoded_audio_string_, lhs_arena,
+      &other->_impl_.encoded_audio_string_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.content_type_, lhs_arena,
+      &other->_impl_.content_type_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(Summary_Audio, _impl_.sample_rate_)
+      + sizeof(Summary_Audio::_impl_.sample_rate_)
+      - PROTOBUF_FIELD_OFFSET(Summary_Audio, _impl_.num_channels_)>(
+          reinterpret_cast<char*>(&_impl_.num_channels_),
+          reinterpret_cast<char*>(&other->_impl_.num_channels_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Summary_Audio::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[7]);
+}
+
+// ===================================================================
+
+class Summary_Value::_Internal {
+ public:
+  static const ::tensorflow::Summary_Image& image(const Summary_Value* msg);
+  static const ::tensorflow::HistogramProto& histo(const Summary_Value* msg);
+  static const ::tensorflow::Summary_Audio& audio(const Summary_Value* msg);
+  static const ::tensorflow::TensorProto& tensor(const Summary_Value* msg);
+};
+
+const ::tensorflow::Summary_Image&
+Summary_Value::_Internal::image(const Summary_Value* msg) {
+  return *msg->_impl_.value_.image_;
+}
+const ::tensorflow::HistogramProto&
+Summary_Value::_Internal::histo(const Summary_Value* msg) {
+  return *msg->_impl_.value_.histo_;
+}
+const ::tensorflow::Summary_Audio&
+Summary_Value::_Internal::audio(const Summary_Value* msg) {
+  return *msg->_impl_.value_.audio_;
+}
+const ::tensorflow::TensorProto&
+Summary_Value::_Internal::tensor(const Summary_Value* msg) {
+  return *msg->_impl_.value_.tensor_;
+}
+void Summary_Value::set_allocated_image(::tensorflow::Summary_Image* image) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_value();
+  if (image) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(image);
+    if (message_arena != submessage_arena) {
+      image = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, image, submessage_arena);
+    }
+    set_has_image();
+    _impl_.value_.image_ = image;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Value.image)
+}
+void Summary_Value::set_allocated_histo(::tensorflow::HistogramProto* histo) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_value();
+  if (histo) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(histo);
+    if (message_arena != submessage_arena) {
+      histo = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, histo, submessage_arena);
+    }
+    set_has_histo();
+    _impl_.value_.histo_ = histo;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Value.histo)
+}
+void Summary_Value::set_allocated_audio(::tensorflow::Summary_Audio* audio) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_value();
+  if (audio) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(audio);
+    if (message_arena != submessage_arena) {
+      audio = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, audio, submessage_arena);
+    }
+    set_has_audio();
+    _impl_.value_.audio_ = audio;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Value.audio)
+}
+void Summary_Value::set_allocated_tensor(::tensorflow::TensorProto* tensor) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_value();
+  if (tensor) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(tensor);
+    if (message_arena != submessage_arena) {
+      tensor = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, tensor, submessage_arena);
+    }
+    set_has_tensor();
+    _impl_.value_.tensor_ = tensor;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Value.tensor)
+}
+Summary_Value::Summary_Value(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.Summary.Value)
+}
+Summary_Value::Summary_Value(const Summary_Value& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Summary_Value* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.tag_){}
+    , decltype(_impl_.node_name_){}
+    , decltype(_impl_.value_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.tag_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.tag_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_tag().empty()) {
+    _this->_impl_.tag_.Set(from._internal_tag(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.node_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.node_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_node_name().empty()) {
+    _this->_impl_.node_name_.Set(from._internal_node_name(), 
+      _this->GetArenaForAllocation());
+  }
+  clear_has_value();
+  switch (from.value_case()) {
+    case kSimpleValue: {
+      _this->_internal_set_simple_value(from._internal_simple_value());
+      break;
+    }
+    case kObsoleteOldStyleHistogram: {
+      _this->_internal_set_obsolete_old_style_histogram(from._internal_obsolete_old_style_histogram());
+      break;
+    }
+    case kImage: {
+      _this->_internal_mutable_image()->::tensorflow::Summary_Image::MergeFrom(
+          from._internal_image());
+      break;
+    }
+    case kHisto: {
+      _this->_internal_mutable_histo()->::tensorflow::HistogramProto::MergeFrom(
+          from._internal_histo());
+      break;
+    }
+    case kAudio: {
+      _this->_internal_mutable_audio()->::tensorflow::Summary_Audio::MergeFrom(
+          from._internal_audio());
+      break;
+    }
+    case kTensor: {
+      _this->_internal_mutable_tensor()->::tensorflow::TensorProto::MergeFrom(
+          from._internal_tensor());
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  // @@protoc_insertion_point(copy_constructor:tensorflow.Summary.Value)
+}
+
+inline void Summary_Value::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.tag_){}
+    , decltype(_impl_.node_name_){}
+    , decltype(_impl_.value_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}
+  };
+  _impl_.tag_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.tag_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.node_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.node_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  clear_has_value();
+}
+
+Summary_Value::~Summary_Value() {
+  // @@protoc_insertion_point(destructor:tensorflow.Summary.Value)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void Summary_Value::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.tag_.Destroy();
+  _impl_.node_name_.Destroy();
+  if (has_value()) {
+    clear_value();
+  }
+}
+
+void Summary_Value::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void Summary_Value::clear_value() {
+// @@protoc_insertion_point(one_of_clear_start:tensorflow.Summary.Value)
+  switch (value_case()) {
+    case kSimpleValue: {
+      // No need to clear
+      break;
+    }
+    case kObsoleteOldStyleHistogram: {
+      _impl_.value_.obsolete_old_style_histogram_.Destroy();
+      break;
+    }
+    case kImage: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.value_.image_;
+      }
+      break;
+    }
+    case kHisto: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.value_.histo_;
+      }
+      break;
+    }
+    case kAudio: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.value_.audio_;
+      }
+      break;
+    }
+    case kTensor: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.value_.tensor_;
+      }
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  _impl_._oneof_case_[0] = VALUE_NOT_SET;
+}
+
+
+void Summary_Value::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.Summary.Value)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.tag_.ClearToEmpty();
+  _impl_.node_name_.ClearToEmpty();
+  clear_value();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Summary_Value::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string tag = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_tag();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.Summary.Value.tag"));
+        } else
+          goto handle_unusual;
+        continue;
+      // float simple_value = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 21)) {
+          _internal_set_simple_value(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<float>(ptr));
+          ptr += sizeof(float);
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes obsolete_old_style_histogram = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          auto str = _internal_mutable_obsolete_old_style_histogram();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.Summary.Image image = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          ptr = ctx->ParseMessage(_internal_mutable_image(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.HistogramProto histo = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr = ctx->ParseMessage(_internal_mutable_histo(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.Summary.Audio audio = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          ptr = ctx->ParseMessage(_internal_mutable_audio(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string node_name = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 58)) {
+          auto str = _internal_mutable_node_name();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.Summary.Value.node_name"));
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.TensorProto tensor = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 66)) {
+          ptr = ctx->ParseMessage(_internal_mutable_tensor(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Summary_Value::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.Summary.Value)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string tag = 1;
+  if (!this->_internal_tag().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_tag().data(), static_cast<int>(this->_internal_tag().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.Summary.Value.tag");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_tag(), target);
+  }
+
+  // float simple_value = 2;
+  if (_internal_has_simple_value()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFloatToArray(2, this->_internal_simple_value(), target);
+  }
+
+  // bytes obsolete_old_style_histogram = 3;
+  if (_internal_has_obsolete_old_style_histogram()) {
+    target = stream->WriteBytesMaybeAliased(
+        3, this->_internal_obsolete_old_style_histogram(), target);
+  }
+
+  // .tensorflow.Summary.Image image = 4;
+  if (_internal_has_image()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(4, _Internal::image(this),
+        _Internal::image(this).GetCachedSize(), target, stream);
+  }
+
+  // .tensorflow.HistogramProto histo = 5;
+  if (_internal_has_histo()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(5, _Internal::histo(this),
+        _Internal::histo(this).GetCachedSize(), target, stream);
+  }
+
+  // .tensorflow.Summary.Audio audio = 6;
+  if (_internal_has_audio()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(6, _Internal::audio(this),
+        _Internal::audio(this).GetCachedSize(), target, stream);
+  }
+
+  // string node_name = 7;
+  if (!this->_internal_node_name().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_node_name().data(), static_cast<int>(this->_internal_node_name().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.Summary.Value.node_name");
+    target = stream->WriteStringMaybeAliased(
+        7, this->_internal_node_name(), target);
+  }
+
+  // .tensorflow.TensorProto tensor = 8;
+  if (_internal_has_tensor()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(8, _Internal::tensor(this),
+        _Internal::tensor(this).GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.Summary.Value)
+  return target;
+}
+
+size_t Summary_Value::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.Summary.Value)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string tag = 1;
+  if (!this->_internal_tag().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_tag());
+  }
+
+  // string node_name = 7;
+  if (!this->_internal_node_name().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_node_name());
+  }
+
+  switch (value_case()) {
+    // float simple_value = 2;
+    case kSimpleValue: {
+      total_size += 1 + 4;
+      break;
+    }
+    // bytes obsolete_old_style_histogram = 3;
+    case kObsoleteOldStyleHistogram: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_obsolete_old_style_histogram());
+      break;
+    }
+    // .tensorflow.Summary.Image image = 4;
+    case kImage: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.value_.image_);
+      break;
+    }
+    // .tensorflow.HistogramProto histo = 5;
+    case kHisto: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.value_.histo_);
+      break;
+    }
+    // .tensorflow.Summary.Audio audio = 6;
+    case kAudio: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.value_.audio_);
+      break;
+    }
+    // .tensorflow.TensorProto tensor = 8;
+    case kTensor: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.value_.tensor_);
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Summary_Value::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Summary_Value::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Summary_Value::GetClassData() const { return &_class_data_; }
+
+
+void Summary_Value::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Summary_Value*>(&to_msg);
+  auto& from = static_cast<const Summary_Value&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.Summary.Value)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_tag().empty()) {
+    _this->_internal_set_tag(from._internal_tag());
+  }
+  if (!from._internal_node_name().empty()) {
+    _this->_internal_set_node_name(from._internal_node_name());
+  }
+  switch (from.value_case()) {
+    case kSimpleValue: {
+      _this->_internal_set_simple_value(from._internal_simple_value());
+      break;
+    }
+    case kObsoleteOldStyleHistogram: {
+      _this->_internal_set_obsolete_old_style_histogram(from._internal_obsolete_old_style_histogram());
+      break;
+    }
+    case kImage: {
+      _this->_internal_mutable_image()->::tensorflow::Summary_Image::MergeFrom(
+          from._internal_image());
+      break;
+    }
+    case kHisto: {
+      _this->_internal_mutable_histo()->::tensorflow::HistogramProto::MergeFrom(
+          from._internal_histo());
+      break;
+    }
+    case kAudio: {
+      _this->_internal_mutable_audio()->::tensorflow::Summary_Audio::MergeFrom(
+          from._internal_audio());
+      break;
+    }
+    case kTensor: {
+      _this->_internal_mutable_tensor()->::tensorflow::TensorProto::MergeFrom(
+          from._internal_tensor());
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void Summary_Value::CopyFrom(const Summary_Value& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.Summary.Value)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Summary_Value::IsInitialized() const {
+  return true;
+}
+
+void Summary_Value::InternalSwap(Summary_Value* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.tag_, lhs_arena,
+      &other->_impl_.tag_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.node_name_, lhs_arena,
+      &other->_impl_.node_name_, rhs_arena
+  );
+  swap(_impl_.value_, other->_impl_.value_);
+  swap(_impl_._oneof_case_[0], other->_impl_._oneof_case_[0]);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Summary_Value::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[8]);
+}
+
+// ===================================================================
+
+class Summary::_Internal {
+ public:
+};
+
+Summary::Summary(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.Summary)
+}
+Summary::Summary(const Summary& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Summary* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.value_){from._impl_.value_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:tensorflow.Summary)
+}
+
+inline void Summary::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.value_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+Summary::~Summary() {
+  // @@protoc_insertion_point(destructor:tensorflow.Summary)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void Summary::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.value_.~RepeatedPtrField();
+}
+
+void Summary::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void Summary::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.Summary)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.value_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Summary::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .tensorflow.Summary.Value value = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_value(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Summary::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.Summary)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .tensorflow.Summary.Value value = 1;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_value_size()); i < n; i++) {
+    const auto& repfield = this->_internal_value(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(1, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.Summary)
+  return target;
+}
+
+size_t Summary::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.Summary)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .tensorflow.Summary.Value value = 1;
+  total_size += 1UL * this->_internal_value_size();
+  for (const auto& msg : this->_impl_.value_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Summary::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Summary::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Summary::GetClassData() const { return &_class_data_; }
+
+
+void Summary::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Summary*>(&to_msg);
+  auto& from = static_cast<const Summary&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.Summary)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.value_.MergeFrom(from._impl_.value_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void Summary::CopyFrom(const Summary& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.Summary)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Summary::IsInitialized() const {
+  return true;
+}
+
+void Summary::InternalSwap(Summary* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.value_.InternalSwap(&other->_impl_.value_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Summary::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[9]);
+}
+
+// ===================================================================
+
+class AttrValue_ListValue::_Internal {
+ public:
+};
+
+AttrValue_ListValue::AttrValue_ListValue(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.AttrValue.ListValue)
+}
+AttrValue_ListValue::AttrValue_ListValue(const AttrValue_ListValue& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  AttrValue_ListValue* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.s_){from._impl_.s_}
+    , decltype(_impl_.i_){from._impl_.i_}
+    , /*decltype(_impl_._i_cached_byte_size_)*/{0}
+    , decltype(_impl_.f_){from._impl_.f_}
+    , decltype(_impl_.b_){from._impl_.b_}
+    , decltype(_impl_.type_){from._impl_.type_}
+    , /*decltype(_impl_._type_cached_byte_size_)*/{0}
+    , decltype(_impl_.shape_){from._impl_.shape_}
+    , decltype(_impl_.tensor_){from._impl_.tensor_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:tensorflow.AttrValue.ListValue)
+}
+
+inline void AttrValue_ListValue::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.s_){arena}
+    , decltype(_impl_.i_){arena}
+    , /*decltype(_impl_._i_cached_byte_size_)*/{0}
+    , decltype(_impl_.f_){arena}
+    , decltype(_impl_.b_){arena}
+    , decltype(_impl_.type_){arena}
+    , /*decltype(_impl_._type_cached_byte_size_)*/{0}
+    , decltype(_impl_.shape_){arena}
+    , decltype(_impl_.tensor_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+AttrValue_ListValue::~AttrValue_ListValue() {
+  // @@protoc_insertion_point(destructor:tensorflow.AttrValue.ListValue)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void AttrValue_ListValue::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.s_.~RepeatedPtrField();
+  _impl_.i_.~RepeatedField();
+  _impl_.f_.~RepeatedField();
+  _impl_.b_.~RepeatedField();
+  _impl_.type_.~RepeatedField();
+  _impl_.shape_.~RepeatedPtrField();
+  _impl_.tensor_.~RepeatedPtrField();
+}
+
+void AttrValue_ListValue::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void AttrValue_ListValue::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.AttrValue.ListValue)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.s_.Clear();
+  _impl_.i_.Clear();
+  _impl_.f_.Clear();
+  _impl_.b_.Clear();
+  _impl_.type_.Clear();
+  _impl_.shape_.Clear();
+  _impl_.tensor_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* AttrValue_ListValue::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated bytes s = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            auto str = _internal_add_s();
+            ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<18>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated int64 i = 3 [packed = true];
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedInt64Parser(_internal_mutable_i(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 24) {
+          _internal_add_i(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated float f = 4 [packed = true];
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedFloatParser(_internal_mutable_f(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 37) {
+          _internal_add_f(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<float>(ptr));
+          ptr += sizeof(float);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated bool b = 5 [packed = true];
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedBoolParser(_internal_mutable_b(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 40) {
+          _internal_add_b(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated .tensorflow.DataType type = 6 [packed = true];
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedEnumParser(_internal_mutable_type(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 48) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_add_type(static_cast<::tensorflow::DataType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated .tensorflow.TensorShapeProto shape = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 58)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_shape(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<58>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated .tensorflow.TensorProto tensor = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 66)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_tensor(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<66>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* AttrValue_ListValue::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.AttrValue.ListValue)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated bytes s = 2;
+  for (int i = 0, n = this->_internal_s_size(); i < n; i++) {
+    const auto& s = this->_internal_s(i);
+    target = stream->WriteBytes(2, s, target);
+  }
+
+  // repeated int64 i = 3 [packed = true];
+  {
+    int byte_size = _impl_._i_cached_byte_size_.load(std::memory_order_relaxed);
+    if (byte_size > 0) {
+      target = stream->WriteInt64Packed(
+          3, _internal_i(), byte_size, target);
+    }
+  }
+
+  // repeated float f = 4 [packed = true];
+  if (this->_internal_f_size() > 0) {
+    target = stream->WriteFixedPacked(4, _internal_f(), target);
+  }
+
+  // repeated bool b = 5 [packed = true];
+  if (this->_internal_b_size() > 0) {
+    target = stream->WriteFixedPacked(5, _internal_b(), target);
+  }
+
+  // repeated .tensorflow.DataType type = 6 [packed = true];
+  {
+    int byte_size = _impl_._type_cached_byte_size_.load(std::memory_order_relaxed);
+    if (byte_size > 0) {
+      target = stream->WriteEnumPacked(
+          6, _impl_.type_, byte_size, target);
+    }
+  }
+
+  // repeated .tensorflow.TensorShapeProto shape = 7;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_shape_size()); i < n; i++) {
+    const auto& repfield = this->_internal_shape(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(7, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  // repeated .tensorflow.TensorProto tensor = 8;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_tensor_size()); i < n; i++) {
+    const auto& repfield = this->_internal_tensor(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(8, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.AttrValue.ListValue)
+  return target;
+}
+
+size_t AttrValue_ListValue::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.AttrValue.ListValue)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated bytes s = 2;
+  total_size += 1 *
+      ::PROTOBUF_NAMESPACE_ID::internal::FromIntSize(_impl_.s_.size());
+  for (int i = 0, n = _impl_.s_.size(); i < n; i++) {
+    total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+      _impl_.s_.Get(i));
+  }
+
+  // repeated int64 i = 3 [packed = true];
+  {
+    size_t data_size = ::_pbi::WireFormatLite::
+      Int64Size(this->_impl_.i_);
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    int cached_size = ::_pbi::ToCachedSize(data_size);
+    _impl_._i_cached_byte_size_.store(cached_size,
+                                    std::memory_order_relaxed);
+    total_size += data_size;
+  }
+
+  // repeated float f = 4 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_f_size());
+    size_t data_size = 4UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // repeated bool b = 5 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_b_size());
+    size_t data_size = 1UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // repeated .tensorflow.DataType type = 6 [packed = true];
+  {
+    size_t data_size = 0;
+    unsigned int count = static_cast<unsigned int>(this->_internal_type_size());for (unsigned int i = 0; i < count; i++) {
+      data_size += ::_pbi::WireFormatLite::EnumSize(
+        this->_internal_type(static_cast<int>(i)));
+    }
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    int cached_size = ::_pbi::ToCachedSize(data_size);
+    _impl_._type_cached_byte_size_.store(cached_size,
+                                    std::memory_order_relaxed);
+    total_size += data_size;
+  }
+
+  // repeated .tensorflow.TensorShapeProto shape = 7;
+  total_size += 1UL * this->_internal_shape_size();
+  for (const auto& msg : this->_impl_.shape_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  // repeated .tensorflow.TensorProto tensor = 8;
+  total_size += 1UL * this->_internal_tensor_size();
+  for (const auto& msg : this->_impl_.tensor_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData AttrValue_ListValue::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    AttrValue_ListValue::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*AttrValue_ListValue::GetClassData() const { return &_class_data_; }
+
+
+void AttrValue_ListValue::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<AttrValue_ListValue*>(&to_msg);
+  auto& from = static_cast<const AttrValue_ListValue&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.AttrValue.ListValue)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.s_.MergeFrom(from._impl_.s_);
+  _this->_impl_.i_.MergeFrom(from._impl_.i_);
+  _this->_impl_.f_.MergeFrom(from._impl_.f_);
+  _this->_impl_.b_.MergeFrom(from._impl_.b_);
+  _this->_impl_.type_.MergeFrom(from._impl_.type_);
+  _this->_impl_.shape_.MergeFrom(from._impl_.shape_);
+  _this->_impl_.tensor_.MergeFrom(from._impl_.tensor_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void AttrValue_ListValue::CopyFrom(const AttrValue_ListValue& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.AttrValue.ListValue)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool AttrValue_ListValue::IsInitialized() const {
+  return true;
+}
+
+void AttrValue_ListValue::InternalSwap(AttrValue_ListValue* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.s_.InternalSwap(&other->_impl_.s_);
+  _impl_.i_.InternalSwap(&other->_impl_.i_);
+  _impl_.f_.InternalSwap(&other->_impl_.f_);
+  _impl_.b_.InternalSwap(&other->_impl_.b_);
+  _impl_.type_.InternalSwap(&other->_impl_.type_);
+  _impl_.shape_.InternalSwap(&other->_impl_.shape_);
+  _impl_.tensor_.InternalSwap(&other->_impl_.tensor_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata AttrValue_ListValue::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[10]);
+}
+
+// ===================================================================
+
+class AttrValue::_Internal {
+ public:
+  static const ::tensorflow::TensorShapeProto& shape(const AttrValue* msg);
+  static const ::tensorflow::TensorProto& tensor(const AttrValue* msg);
+  static const ::tensorflow::AttrValue_ListValue& list(const AttrValue* msg);
+  static const ::tensorflow::NameAttrList& func(const AttrValue* msg);
+};
+
+const ::tensorflow::TensorShapeProto&
+AttrValue::_Internal::shape(const AttrValue* msg) {
+  return *msg->_impl_.value_.shape_;
+}
+const ::tensorflow::TensorProto&
+AttrValue::_Internal::tensor(const AttrValue* msg) {
+  return *msg->_impl_.value_.tensor_;
+}
+const ::tensorflow::AttrValue_ListValue&
+AttrValue::_Internal::list(const AttrValue* msg) {
+  return *msg->_impl_.value_.list_;
+}
+const ::tensorflow::NameAttrList&
+AttrValue::_Internal::func(const AttrValue* msg) {
+  return *msg->_impl_.value_.func_;
+}
+void AttrValue::set_allocated_shape(::tensorflow::TensorShapeProto* shape) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_value();
+  if (shape) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(shape);
+    if (message_arena != submessage_arena) {
+      shape = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, shape, submessage_arena);
+    }
+    set_has_shape();
+    _impl_.value_.shape_ = shape;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.AttrValue.shape)
+}
+void AttrValue::set_allocated_tensor(::tensorflow::TensorProto* tensor) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_value();
+  if (tensor) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(tensor);
+    if (message_arena != submessage_arena) {
+      tensor = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, tensor, submessage_arena);
+    }
+    set_has_tensor();
+    _impl_.value_.tensor_ = tensor;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.AttrValue.tensor)
+}
+void AttrValue::set_allocated_list(::tensorflow::AttrValue_ListValue* list) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_value();
+  if (list) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(list);
+    if (message_arena != submessage_arena) {
+      list = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, list, submessage_arena);
+    }
+    set_has_list();
+    _impl_.value_.list_ = list;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.AttrValue.list)
+}
+void AttrValue::set_allocated_func(::tensorflow::NameAttrList* func) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_value();
+  if (func) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(func);
+    if (message_arena != submessage_arena) {
+      func = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, func, submessage_arena);
+    }
+    set_has_func();
+    _impl_.value_.func_ = func;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.AttrValue.func)
+}
+AttrValue::AttrValue(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.AttrValue)
+}
+AttrValue::AttrValue(const AttrValue& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  AttrValue* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.value_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  clear_has_value();
+  switch (from.value_case()) {
+    case kS: {
+      _this->_internal_set_s(from._internal_s());
+      break;
+    }
+    case kI: {
+      _this->_internal_set_i(from._internal_i());
+      break;
+    }
+    case kF: {
+      _this->_internal_set_f(from._internal_f());
+      break;
+    }
+    case kB: {
+      _this->_internal_set_b(from._internal_b());
+      break;
+    }
+    case kType: {
+      _this->_internal_set_type(from._internal_type());
+      break;
+    }
+    case kShape: {
+      _this->_internal_mutable_shape()->::tensorflow::TensorShapeProto::MergeFrom(
+          from._internal_shape());
+      break;
+    }
+    case kTensor: {
+      _this->_internal_mutable_tensor()->::tensorflow::TensorProto::MergeFrom(
+          from._internal_tensor());
+      break;
+    }
+    case kList: {
+      _this->_internal_mutable_list()->::tensorflow::AttrValue_ListValue::MergeFrom(
+          from._internal_list());
+      break;
+    }
+    case kFunc: {
+      _this->_internal_mutable_func()->::tensorflow::NameAttrList::MergeFrom(
+          from._internal_func());
+      break;
+    }
+    case kPlaceholder: {
+      _this->_internal_set_placeholder(from._internal_placeholder());
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  // @@protoc_insertion_point(copy_constructor:tensorflow.AttrValue)
+}
+
+inline void AttrValue::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.value_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}
+  };
+  clear_has_value();
+}
+
+AttrValue::~AttrValue() {
+  // @@protoc_insertion_point(destructor:tensorflow.AttrValue)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void AttrValue::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  if (has_value()) {
+    clear_value();
+  }
+}
+
+void AttrValue::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void AttrValue::clear_value() {
+// @@protoc_insertion_point(one_of_clear_start:tensorflow.AttrValue)
+  switch (value_case()) {
+    case kS: {
+      _impl_.value_.s_.Destroy();
+      break;
+    }
+    case kI: {
+      // No need to clear
+      break;
+    }
+    case kF: {
+      // No need to clear
+      break;
+    }
+    case kB: {
+      // No need to clear
+      break;
+    }
+    case kType: {
+      // No need to clear
+      break;
+    }
+    case kShape: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.value_.shape_;
+      }
+      break;
+    }
+    case kTensor: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.value_.tensor_;
+      }
+      break;
+    }
+    case kList: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.value_.list_;
+      }
+      break;
+    }
+    case kFunc: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.value_.func_;
+      }
+      break;
+    }
+    case kPlaceholder: {
+      _impl_.value_.placeholder_.Destroy();
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  _impl_._oneof_case_[0] = VALUE_NOT_SET;
+}
+
+
+void AttrValue::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.AttrValue)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  clear_value();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* AttrValue::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // .tensorflow.AttrValue.ListValue list = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr = ctx->ParseMessage(_internal_mutable_list(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes s = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_s();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int64 i = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _internal_set_i(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // float f = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 37)) {
+          _internal_set_f(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<float>(ptr));
+          ptr += sizeof(float);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool b = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _internal_set_b(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.DataType type = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_type(static_cast<::tensorflow::DataType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.TensorShapeProto shape = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 58)) {
+          ptr = ctx->ParseMessage(_internal_mutable_shape(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.TensorProto tensor = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 66)) {
+          ptr = ctx->ParseMessage(_internal_mutable_tensor(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string placeholder = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 74)) {
+          auto str = _internal_mutable_placeholder();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.AttrValue.placeholder"));
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.NameAttrList func = 10;
+      case 10:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 82)) {
+          ptr = ctx->ParseMessage(_internal_mutable_func(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* AttrValue::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.AttrValue)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .tensorflow.AttrValue.ListValue list = 1;
+  if (_internal_has_list()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(1, _Internal::list(this),
+        _Internal::list(this).GetCachedSize(), target, stream);
+  }
+
+  // bytes s = 2;
+  if (_internal_has_s()) {
+    target = stream->WriteBytesMaybeAliased(
+        2, this->_internal_s(), target);
+  }
+
+  // int64 i = 3;
+  if (_internal_has_i()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(3, this->_internal_i(), target);
+  }
+
+  // float f = 4;
+  if (_internal_has_f()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFloatToArray(4, this->_internal_f(), target);
+  }
+
+  // bool b = 5;
+  if (_internal_has_b()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(5, this->_internal_b(), target);
+  }
+
+  // .tensorflow.DataType type = 6;
+  if (_internal_has_type()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      6, this->_internal_type(), target);
+  }
+
+  // .tensorflow.TensorShapeProto shape = 7;
+  if (_internal_has_shape()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(7, _Internal::shape(this),
+        _Internal::shape(this).GetCachedSize(), target, stream);
+  }
+
+  // .tensorflow.TensorProto tensor = 8;
+  if (_internal_has_tensor()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(8, _Internal::tensor(this),
+        _Internal::tensor(this).GetCachedSize(), target, stream);
+  }
+
+  // string placeholder = 9;
+  if (_internal_has_placeholder()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_placeholder().data(), static_cast<int>(this->_internal_placeholder().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.AttrValue.placeholder");
+    target = stream->WriteStringMaybeAliased(
+        9, this->_internal_placeholder(), target);
+  }
+
+  // .tensorflow.NameAttrList func = 10;
+  if (_internal_has_func()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(10, _Internal::func(this),
+        _Internal::func(this).GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.AttrValue)
+  return target;
+}
+
+size_t AttrValue::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.AttrValue)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  switch (value_case()) {
+    // bytes s = 2;
+    case kS: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_s());
+      break;
+    }
+    // int64 i = 3;
+    case kI: {
+      total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_i());
+      break;
+    }
+    // float f = 4;
+    case kF: {
+      total_size += 1 + 4;
+      break;
+    }
+    // bool b = 5;
+    case kB: {
+      total_size += 1 + 1;
+      break;
+    }
+    // .tensorflow.DataType type = 6;
+    case kType: {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::EnumSize(this->_internal_type());
+      break;
+    }
+    // .tensorflow.TensorShapeProto shape = 7;
+    case kShape: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.value_.shape_);
+      break;
+    }
+    // .tensorflow.TensorProto tensor = 8;
+    case kTensor: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.value_.tensor_);
+      break;
+    }
+    // .tensorflow.AttrValue.ListValue list = 1;
+    case kList: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.value_.list_);
+      break;
+    }
+    // .tensorflow.NameAttrList func = 10;
+    case kFunc: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.value_.func_);
+      break;
+    }
+    // string placeholder = 9;
+    case kPlaceholder: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+          this->_internal_placeholder());
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData AttrValue::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    AttrValue::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*AttrValue::GetClassData() const { return &_class_data_; }
+
+
+void AttrValue::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<AttrValue*>(&to_msg);
+  auto& from = static_cast<const AttrValue&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.AttrValue)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  switch (from.value_case()) {
+    case kS: {
+      _this->_internal_set_s(from._internal_s());
+      break;
+    }
+    case kI: {
+      _this->_internal_set_i(from._internal_i());
+      break;
+    }
+    case kF: {
+      _this->_internal_set_f(from._internal_f());
+      break;
+    }
+    case kB: {
+      _this->_internal_set_b(from._internal_b());
+      break;
+    }
+    case kType: {
+      _this->_internal_set_type(from._internal_type());
+      break;
+    }
+    case kShape: {
+      _this->_internal_mutable_shape()->::tensorflow::TensorShapeProto::MergeFrom(
+          from._internal_shape());
+      break;
+    }
+    case kTensor: {
+      _this->_internal_mutable_tensor()->::tensorflow::TensorProto::MergeFrom(
+          from._internal_tensor());
+      break;
+    }
+    case kList: {
+      _this->_internal_mutable_list()->::tensorflow::AttrValue_ListValue::MergeFrom(
+          from._internal_list());
+      break;
+    }
+    case kFunc: {
+      _this->_internal_mutable_func()->::tensorflow::NameAttrList::MergeFrom(
+          from._internal_func());
+      break;
+    }
+    case kPlaceholder: {
+      _this->_internal_set_placeholder(from._internal_placeholder());
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void AttrValue::CopyFrom(const AttrValue& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.AttrValue)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool AttrValue::IsInitialized() const {
+  return true;
+}
+
+void AttrValue::InternalSwap(AttrValue* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_.value_, other->_impl_.value_);
+  swap(_impl_._oneof_case_[0], other->_impl_._oneof_case_[0]);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata AttrValue::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[11]);
+}
+
+// ===================================================================
+
+NameAttrList_AttrEntry_DoNotUse::NameAttrList_AttrEntry_DoNotUse() {}
+NameAttrList_AttrEntry_DoNotUse::NameAttrList_AttrEntry_DoNotUse(::PROTOBUF_NAMESPACE_ID::Arena* arena)
+    : SuperType(arena) {}
+void NameAttrList_AttrEntry_DoNotUse::MergeFrom(const NameAttrList_AttrEntry_DoNotUse& other) {
+  MergeFromInternal(other);
+}
+::PROTOBUF_NAMESPACE_ID::Metadata NameAttrList_AttrEntry_DoNotUse::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[12]);
+}
+
+// ===================================================================
+
+class NameAttrList::_Internal {
+ public:
+};
+
+NameAttrList::NameAttrList(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  if (arena != nullptr && !is_message_owned) {
+    arena->OwnCustomDestructor(this, &NameAttrList::ArenaDtor);
+  }
+  // @@protoc_insertion_point(arena_constructor:tensorflow.NameAttrList)
+}
+NameAttrList::NameAttrList(const NameAttrList& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  NameAttrList* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      /*decltype(_impl_.attr_)*/{}
+    , decltype(_impl_.name_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_impl_.attr_.MergeFrom(from._impl_.attr_);
+  _impl_.name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_name().empty()) {
+    _this->_impl_.name_.Set(from._internal_name(), 
+      _this->GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:tensorflow.NameAttrList)
+}
+
+inline void NameAttrList::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      /*decltype(_impl_.attr_)*/{::_pbi::ArenaInitialized(), arena}
+    , decltype(_impl_.name_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+NameAttrList::~NameAttrList() {
+  // @@protoc_insertion_point(destructor:tensorflow.NameAttrList)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    ArenaDtor(this);
+    return;
+  }
+  SharedDtor();
+}
+
+inline void NameAttrList::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.attr_.Destruct();
+  _impl_.attr_.~MapField();
+  _impl_.name_.Destroy();
+}
+
+void NameAttrList::ArenaDtor(void* object) {
+  NameAttrList* _this = reinterpret_cast< NameAttrList* >(object);
+  _this->_impl_.attr_.Destruct();
+}
+void NameAttrList::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void NameAttrList::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.NameAttrList)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.attr_.Clear();
+  _impl_.name_.ClearToEmpty();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* NameAttrList::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string name = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_name();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.NameAttrList.name"));
+        } else
+          goto handle_unusual;
+        continue;
+      // map<string, .tensorflow.AttrValue> attr = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(&_impl_.attr_, ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<18>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* NameAttrList::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.NameAttrList)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string name = 1;
+  if (!this->_internal_name().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_name().data(), static_cast<int>(this->_internal_name().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.NameAttrList.name");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_name(), target);
+  }
+
+  // map<string, .tensorflow.AttrValue> attr = 2;
+  if (!this->_internal_attr().empty()) {
+    using MapType = ::_pb::Map<std::string, ::tensorflow::AttrValue>;
+    using WireHelper = NameAttrList_AttrEntry_DoNotUse::Funcs;
+    const auto& map_field = this->_internal_attr();
+    auto check_utf8 = [](const MapType::value_type& entry) {
+      (void)entry;
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+        entry.first.data(), static_cast<int>(entry.first.length()),
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+        "tensorflow.NameAttrList.AttrEntry.key");
+    };
+
+    if (stream->IsSerializationDeterministic() && map_field.size() > 1) {
+      for (const auto& entry : ::_pbi::MapSorterPtr<MapType>(map_field)) {
+        target = WireHelper::InternalSerialize(2, entry.first, entry.second, target, stream);
+        check_utf8(entry);
+      }
+    } else {
+      for (const auto& entry : map_field) {
+        target = WireHelper::InternalSerialize(2, entry.first, entry.second, target, stream);
+        check_utf8(entry);
+      }
+    }
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.NameAttrList)
+  return target;
+}
+
+size_t NameAttrList::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.NameAttrList)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // map<string, .tensorflow.AttrValue> attr = 2;
+  total_size += 1 *
+      ::PROTOBUF_NAMESPACE_ID::internal::FromIntSize(this->_internal_attr_size());
+  for (::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >::const_iterator
+      it = this->_internal_attr().begin();
+      it != this->_internal_attr().end(); ++it) {
+    total_size += NameAttrList_AttrEntry_DoNotUse::Funcs::ByteSizeLong(it->first, it->second);
+  }
+
+  // string name = 1;
+  if (!this->_internal_name().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_name());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData NameAttrList::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    NameAttrList::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*NameAttrList::GetClassData() const { return &_class_data_; }
+
+
+void NameAttrList::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<NameAttrList*>(&to_msg);
+  auto& from = static_cast<const NameAttrList&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.NameAttrList)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.attr_.MergeFrom(from._impl_.attr_);
+  if (!from._internal_name().empty()) {
+    _this->_internal_set_name(from._internal_name());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void NameAttrList::CopyFrom(const NameAttrList& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.NameAttrList)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool NameAttrList::IsInitialized() const {
+  return true;
+}
+
+void NameAttrList::InternalSwap(NameAttrList* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.attr_.InternalSwap(&other->_impl_.attr_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.name_, lhs_arena,
+      &other->_impl_.name_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata NameAttrList::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[13]);
+}
+
+// ===================================================================
+
+NodeDef_AttrEntry_DoNotUse::NodeDef_AttrEntry_DoNotUse() {}
+NodeDef_AttrEntry_DoNotUse::NodeDef_AttrEntry_DoNotUse(::PROTOBUF_NAMESPACE_ID::Arena* arena)
+    : SuperType(arena) {}
+void NodeDef_AttrEntry_DoNotUse::MergeFrom(const NodeDef_AttrEntry_DoNotUse& other) {
+  MergeFromInternal(other);
+}
+::PROTOBUF_NAMESPACE_ID::Metadata NodeDef_AttrEntry_DoNotUse::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[14]);
+}
+
+// ===================================================================
+
+class NodeDef::_Internal {
+ public:
+};
+
+NodeDef::NodeDef(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  if (arena != nullptr && !is_message_owned) {
+    arena->OwnCustomDestructor(this, &NodeDef::ArenaDtor);
+  }
+  // @@protoc_insertion_point(arena_constructor:tensorflow.NodeDef)
+}
+NodeDef::NodeDef(const NodeDef& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  NodeDef* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.input_){from._impl_.input_}
+    , /*decltype(_impl_.attr_)*/{}
+    , decltype(_impl_.name_){}
+    , decltype(_impl_.op_){}
+    , decltype(_impl_.device_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_impl_.attr_.MergeFrom(from._impl_.attr_);
+  _impl_.name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_name().empty()) {
+    _this->_impl_.name_.Set(from._internal_name(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.op_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.op_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_op().empty()) {
+    _this->_impl_.op_.Set(from._internal_op(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.device_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.device_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_device().empty()) {
+    _this->_impl_.device_.Set(from._internal_device(), 
+      _this->GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:tensorflow.NodeDef)
+}
+
+inline void NodeDef::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.input_){arena}
+    , /*decltype(_impl_.attr_)*/{::_pbi::ArenaInitialized(), arena}
+    , decltype(_impl_.name_){}
+    , decltype(_impl_.op_){}
+    , decltype(_impl_.device_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.op_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.op_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.device_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.device_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+NodeDef::~NodeDef() {
+  // @@protoc_insertion_point(destructor:tensorflow.NodeDef)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    ArenaDtor(this);
+    return;
+  }
+  SharedDtor();
+}
+
+inline void NodeDef::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.input_.~RepeatedPtrField();
+  _impl_.attr_.Destruct();
+  _impl_.attr_.~MapField();
+  _impl_.name_.Destroy();
+  _impl_.op_.Destroy();
+  _impl_.device_.Destroy();
+}
+
+void NodeDef::ArenaDtor(void* object) {
+  NodeDef* _this = reinterpret_cast< NodeDef* >(object);
+  _this->_impl_.attr_.Destruct();
+}
+void NodeDef::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void NodeDef::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.NodeDef)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.input_.Clear();
+  _impl_.attr_.Clear();
+  _impl_.name_.ClearToEmpty();
+  _impl_.op_.ClearToEmpty();
+  _impl_.device_.ClearToEmpty();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* NodeDef::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string name = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_name();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.NodeDef.name"));
+        } else
+          goto handle_unusual;
+        continue;
+      // string op = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_op();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.NodeDef.op"));
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated string input = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            auto str = _internal_add_input();
+            ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+            CHK_(ptr);
+            CHK_(::_pbi::VerifyUTF8(str, "tensorflow.NodeDef.input"));
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<26>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // string device = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          auto str = _internal_mutable_device();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.NodeDef.device"));
+        } else
+          goto handle_unusual;
+        continue;
+      // map<string, .tensorflow.AttrValue> attr = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(&_impl_.attr_, ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<42>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* NodeDef::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.NodeDef)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string name = 1;
+  if (!this->_internal_name().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_name().data(), static_cast<int>(this->_internal_name().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.NodeDef.name");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_name(), target);
+  }
+
+  // string op = 2;
+  if (!this->_internal_op().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_op().data(), static_cast<int>(this->_internal_op().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.NodeDef.op");
+    target = stream->WriteStringMaybeAliased(
+        2, this->_internal_op(), target);
+  }
+
+  // repeated string input = 3;
+  for (int i = 0, n = this->_internal_input_size(); i < n; i++) {
+    const auto& s = this->_internal_input(i);
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      s.data(), static_cast<int>(s.length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.NodeDef.input");
+    target = stream->WriteString(3, s, target);
+  }
+
+  // string device = 4;
+  if (!this->_internal_device().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_device().data(), static_cast<int>(this->_internal_device().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.NodeDef.device");
+    target = stream->WriteStringMaybeAliased(
+        4, this->_internal_device(), target);
+  }
+
+  // map<string, .tensorflow.AttrValue> attr = 5;
+  if (!this->_internal_attr().empty()) {
+    using MapType = ::_pb::Map<std::string, ::tensorflow::AttrValue>;
+    using WireHelper = NodeDef_AttrEntry_DoNotUse::Funcs;
+    const auto& map_field = this->_internal_attr();
+    auto check_utf8 = [](const MapType::value_type& entry) {
+      (void)entry;
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+        entry.first.data(), static_cast<int>(entry.first.length()),
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+        "tensorflow.NodeDef.AttrEntry.key");
+    };
+
+    if (stream->IsSerializationDeterministic() && map_field.size() > 1) {
+      for (const auto& entry : ::_pbi::MapSorterPtr<MapType>(map_field)) {
+        target = WireHelper::InternalSerialize(5, entry.first, entry.second, target, stream);
+        check_utf8(entry);
+      }
+    } else {
+      for (const auto& entry : map_field) {
+        target = WireHelper::InternalSerialize(5, entry.first, entry.second, target, stream);
+        check_utf8(entry);
+      }
+    }
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.NodeDef)
+  return target;
+}
+
+size_t NodeDef::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.NodeDef)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated string input = 3;
+  total_size += 1 *
+      ::PROTOBUF_NAMESPACE_ID::internal::FromIntSize(_impl_.input_.size());
+  for (int i = 0, n = _impl_.input_.size(); i < n; i++) {
+    total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+      _impl_.input_.Get(i));
+  }
+
+  // map<string, .tensorflow.AttrValue> attr = 5;
+  total_size += 1 *
+      ::PROTOBUF_NAMESPACE_ID::internal::FromIntSize(this->_internal_attr_size());
+  for (::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >::const_iterator
+      it = this->_internal_attr().begin();
+      it != this->_internal_attr().end(); ++it) {
+    total_size += NodeDef_AttrEntry_DoNotUse::Funcs::ByteSizeLong(it->first, it->second);
+  }
+
+  // string name = 1;
+  if (!this->_internal_name().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_name());
+  }
+
+  // string op = 2;
+  if (!this->_internal_op().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_op());
+  }
+
+  // string device = 4;
+  if (!this->_internal_device().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_device());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData NodeDef::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    NodeDef::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*NodeDef::GetClassData() const { return &_class_data_; }
+
+
+void NodeDef::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<NodeDef*>(&to_msg);
+  auto& from = static_cast<const NodeDef&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.NodeDef)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.input_.MergeFrom(from._impl_.input_);
+  _this->_impl_.attr_.MergeFrom(from._impl_.attr_);
+  if (!from._internal_name().empty()) {
+    _this->_internal_set_name(from._internal_name());
+  }
+  if (!from._internal_op().empty()) {
+    _this->_internal_set_op(from._internal_op());
+  }
+  if (!from._internal_device().empty()) {
+    _this->_internal_set_device(from._internal_device());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void NodeDef::CopyFrom(const NodeDef& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.NodeDef)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool NodeDef::IsInitialized() const {
+  return true;
+}
+
+void NodeDef::InternalSwap(NodeDef* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.input_.InternalSwap(&other->_impl_.input_);
+  _impl_.attr_.InternalSwap(&other->_impl_.attr_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.name_, lhs_arena,
+      &other->_impl_.name_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.op_, lhs_arena,
+      &other->_impl_.op_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.device_, lhs_arena,
+      &other->_impl_.device_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata NodeDef::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[15]);
+}
+
+// ===================================================================
+
+class GraphDef::_Internal {
+ public:
+  static const ::tensorflow::VersionDef& versions(const GraphDef* msg);
+};
+
+const ::tensorflow::VersionDef&
+GraphDef::_Internal::versions(const GraphDef* msg) {
+  return *msg->_impl_.versions_;
+}
+GraphDef::GraphDef(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.GraphDef)
+}
+GraphDef::GraphDef(const GraphDef& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  GraphDef* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.node_){from._impl_.node_}
+    , decltype(_impl_.versions_){nullptr}
+    , decltype(_impl_.version_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  if (from._internal_has_versions()) {
+    _this->_impl_.versions_ = new ::tensorflow::VersionDef(*from._impl_.versions_);
+  }
+  _this->_impl_.version_ = from._impl_.version_;
+  // @@protoc_insertion_point(copy_constructor:tensorflow.GraphDef)
+}
+
+inline void GraphDef::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.node_){arena}
+    , decltype(_impl_.versions_){nullptr}
+    , decltype(_impl_.version_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+GraphDef::~GraphDef() {
+  // @@protoc_insertion_point(destructor:tensorflow.GraphDef)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void GraphDef::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.node_.~RepeatedPtrField();
+  if (this != internal_default_instance()) delete _impl_.versions_;
+}
+
+void GraphDef::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void GraphDef::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.GraphDef)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.node_.Clear();
+  if (GetArenaForAllocation() == nullptr && _impl_.versions_ != nullptr) {
+    delete _impl_.versions_;
+  }
+  _impl_.versions_ = nullptr;
+  _impl_.version_ = 0;
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* GraphDef::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .tensorflow.NodeDef node = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_node(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 version = 3 [deprecated = true];
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.version_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.VersionDef versions = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          ptr = ctx->ParseMessage(_internal_mutable_versions(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* GraphDef::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.GraphDef)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .tensorflow.NodeDef node = 1;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_node_size()); i < n; i++) {
+    const auto& repfield = this->_internal_node(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(1, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  // int32 version = 3 [deprecated = true];
+  if (this->_internal_version() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(3, this->_internal_version(), target);
+  }
+
+  // .tensorflow.VersionDef versions = 4;
+  if (this->_internal_has_versions()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(4, _Internal::versions(this),
+        _Internal::versions(this).GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.GraphDef)
+  return target;
+}
+
+size_t GraphDef::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.GraphDef)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .tensorflow.NodeDef node = 1;
+  total_size += 1UL * this->_internal_node_size();
+  for (const auto& msg : this->_impl_.node_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  // .tensorflow.VersionDef versions = 4;
+  if (this->_internal_has_versions()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.versions_);
+  }
+
+  // int32 version = 3 [deprecated = true];
+  if (this->_internal_version() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_version());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData GraphDef::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    GraphDef::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GraphDef::GetClassData() const { return &_class_data_; }
+
+
+void GraphDef::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<GraphDef*>(&to_msg);
+  auto& from = static_cast<const GraphDef&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.GraphDef)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.node_.MergeFrom(from._impl_.node_);
+  if (from._internal_has_versions()) {
+    _this->_internal_mutable_versions()->::tensorflow::VersionDef::MergeFrom(
+        from._internal_versions());
+  }
+  if (from._internal_version() != 0) {
+    _this->_internal_set_version(from._internal_version());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void GraphDef::CopyFrom(const GraphDef& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.GraphDef)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool GraphDef::IsInitialized() const {
+  return true;
+}
+
+void GraphDef::InternalSwap(GraphDef* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.node_.InternalSwap(&other->_impl_.node_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(GraphDef, _impl_.version_)
+      + sizeof(GraphDef::_impl_.version_)
+      - PROTOBUF_FIELD_OFFSET(GraphDef, _impl_.versions_)>(
+          reinterpret_cast<char*>(&_impl_.versions_),
+          reinterpret_cast<char*>(&other->_impl_.versions_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata GraphDef::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[16]);
+}
+
+// ===================================================================
+
+class Event::_Internal {
+ public:
+  static const ::tensorflow::Summary& summary(const Event* msg);
+  static const ::tensorflow::LogMessage& log_message(const Event* msg);
+  static const ::tensorflow::SessionLog& session_log(const Event* msg);
+  static const ::tensorflow::TaggedRunMetadata& tagged_run_metadata(const Event* msg);
+};
+
+const ::tensorflow::Summary&
+Event::_Internal::summary(const Event* msg) {
+  return *msg->_impl_.what_.summary_;
+}
+const ::tensorflow::LogMessage&
+Event::_Internal::log_message(const Event* msg) {
+  return *msg->_impl_.what_.log_message_;
+}
+const ::tensorflow::SessionLog&
+Event::_Internal::session_log(const Event* msg) {
+  return *msg->_impl_.what_.session_log_;
+}
+const ::tensorflow::TaggedRunMetadata&
+Event::_Internal::tagged_run_metadata(const Event* msg) {
+  return *msg->_impl_.what_.tagged_run_metadata_;
+}
+void Event::set_allocated_summary(::tensorflow::Summary* summary) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_what();
+  if (summary) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(summary);
+    if (message_arena != submessage_arena) {
+      summary = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, summary, submessage_arena);
+    }
+    set_has_summary();
+    _impl_.what_.summary_ = summary;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Event.summary)
+}
+void Event::set_allocated_log_message(::tensorflow::LogMessage* log_message) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_what();
+  if (log_message) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(log_message);
+    if (message_arena != submessage_arena) {
+      log_message = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, log_message, submessage_arena);
+    }
+    set_has_log_message();
+    _impl_.what_.log_message_ = log_message;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Event.log_message)
+}
+void Event::set_allocated_session_log(::tensorflow::SessionLog* session_log) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_what();
+  if (session_log) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(session_log);
+    if (message_arena != submessage_arena) {
+      session_log = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, session_log, submessage_arena);
+    }
+    set_has_session_log();
+    _impl_.what_.session_log_ = session_log;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Event.session_log)
+}
+void Event::set_allocated_tagged_run_metadata(::tensorflow::TaggedRunMetadata* tagged_run_metadata) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_what();
+  if (tagged_run_metadata) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(tagged_run_metadata);
+    if (message_arena != submessage_arena) {
+      tagged_run_metadata = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, tagged_run_metadata, submessage_arena);
+    }
+    set_has_tagged_run_metadata();
+    _impl_.what_.tagged_run_metadata_ = tagged_run_metadata;
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Event.tagged_run_metadata)
+}
+Event::Event(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.Event)
+}
+Event::Event(const Event& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Event* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.wall_time_){}
+    , decltype(_impl_.step_){}
+    , decltype(_impl_.what_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.wall_time_, &from._impl_.wall_time_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.step_) -
+    reinterpret_cast<char*>(&_impl_.wall_time_)) + sizeof(_impl_.step_));
+  clear_has_what();
+  switch (from.what_case()) {
+    case kFileVersion: {
+      _this->_internal_set_file_version(from._internal_file_version());
+      break;
+    }
+    case kGraphDef: {
+      _this->_internal_set_graph_def(from._internal_graph_def());
+      break;
+    }
+    case kSummary: {
+      _this->_internal_mutable_summary()->::tensorflow::Summary::MergeFrom(
+          from._internal_summary());
+      break;
+    }
+    case kLogMessage: {
+      _this->_internal_mutable_log_message()->::tensorflow::LogMessage::MergeFrom(
+          from._internal_log_message());
+      break;
+    }
+    case kSessionLog: {
+      _this->_internal_mutable_session_log()->::tensorflow::SessionLog::MergeFrom(
+          from._internal_session_log());
+      break;
+    }
+    case kTaggedRunMetadata: {
+      _this->_internal_mutable_tagged_run_metadata()->::tensorflow::TaggedRunMetadata::MergeFrom(
+          from._internal_tagged_run_metadata());
+      break;
+    }
+    case kMetaGraphDef: {
+      _this->_internal_set_meta_graph_def(from._internal_meta_graph_def());
+      break;
+    }
+    case WHAT_NOT_SET: {
+      break;
+    }
+  }
+  // @@protoc_insertion_point(copy_constructor:tensorflow.Event)
+}
+
+inline void Event::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.wall_time_){0}
+    , decltype(_impl_.step_){int64_t{0}}
+    , decltype(_impl_.what_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}
+  };
+  clear_has_what();
+}
+
+Event::~Event() {
+  // @@protoc_insertion_point(destructor:tensorflow.Event)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void Event::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  if (has_what()) {
+    clear_what();
+  }
+}
+
+void Event::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void Event::clear_what() {
+// @@protoc_insertion_point(one_of_clear_start:tensorflow.Event)
+  switch (what_case()) {
+    case kFileVersion: {
+      _impl_.what_.file_version_.Destroy();
+      break;
+    }
+    case kGraphDef: {
+      _impl_.what_.graph_def_.Destroy();
+      break;
+    }
+    case kSummary: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.what_.summary_;
+      }
+      break;
+    }
+    case kLogMessage: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.what_.log_message_;
+      }
+      break;
+    }
+    case kSessionLog: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.what_.session_log_;
+      }
+      break;
+    }
+    case kTaggedRunMetadata: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.what_.tagged_run_metadata_;
+      }
+      break;
+    }
+    case kMetaGraphDef: {
+      _impl_.what_.meta_graph_def_.Destroy();
+      break;
+    }
+    case WHAT_NOT_SET: {
+      break;
+    }
+  }
+  _impl_._oneof_case_[0] = WHAT_NOT_SET;
+}
+
+
+void Event::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.Event)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  ::memset(&_impl_.wall_time_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.step_) -
+      reinterpret_cast<char*>(&_impl_.wall_time_)) + sizeof(_impl_.step_));
+  clear_what();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Event::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // double wall_time = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 9)) {
+          _impl_.wall_time_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr);
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      // int64 step = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.step_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string file_version = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          auto str = _internal_mutable_file_version();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.Event.file_version"));
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes graph_def = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          auto str = _internal_mutable_graph_def();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.Summary summary = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr = ctx->ParseMessage(_internal_mutable_summary(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.LogMessage log_message = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          ptr = ctx->ParseMessage(_internal_mutable_log_message(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.SessionLog session_log = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 58)) {
+          ptr = ctx->ParseMessage(_internal_mutable_session_log(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .tensorflow.TaggedRunMetadata tagged_run_metadata = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 66)) {
+          ptr = ctx->ParseMessage(_internal_mutable_tagged_run_metadata(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes meta_graph_def = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 74)) {
+          auto str = _internal_mutable_meta_graph_def();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Event::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.Event)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // double wall_time = 1;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_wall_time = this->_internal_wall_time();
+  uint64_t raw_wall_time;
+  memcpy(&raw_wall_time, &tmp_wall_time, sizeof(tmp_wall_time));
+  if (raw_wall_time != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteDoubleToArray(1, this->_internal_wall_time(), target);
+  }
+
+  // int64 step = 2;
+  if (this->_internal_step() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(2, this->_internal_step(), target);
+  }
+
+  // string file_version = 3;
+  if (_internal_has_file_version()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_file_version().data(), static_cast<int>(this->_internal_file_version().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.Event.file_version");
+    target = stream->WriteStringMaybeAliased(
+        3, this->_internal_file_version(), target);
+  }
+
+  // bytes graph_def = 4;
+  if (_internal_has_graph_def()) {
+    target = stream->WriteBytesMaybeAliased(
+        4, this->_internal_graph_def(), target);
+  }
+
+  // .tensorflow.Summary summary = 5;
+  if (_internal_has_summary()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(5, _Internal::summary(this),
+        _Internal::summary(this).GetCachedSize(), target, stream);
+  }
+
+  // .tensorflow.LogMessage log_message = 6;
+  if (_internal_has_log_message()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(6, _Internal::log_message(this),
+        _Internal::log_message(this).GetCachedSize(), target, stream);
+  }
+
+  // .tensorflow.SessionLog session_log = 7;
+  if (_internal_has_session_log()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(7, _Internal::session_log(this),
+        _Internal::session_log(this).GetCachedSize(), target, stream);
+  }
+
+  // .tensorflow.TaggedRunMetadata tagged_run_metadata = 8;
+  if (_internal_has_tagged_run_metadata()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(8, _Internal::tagged_run_metadata(this),
+        _Internal::tagged_run_metadata(this).GetCachedSize(), target, stream);
+  }
+
+  // bytes meta_graph_def = 9;
+  if (_internal_has_meta_graph_def()) {
+    target = stream->WriteBytesMaybeAliased(
+        9, this->_internal_meta_graph_def(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.Event)
+  return target;
+}
+
+size_t Event::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.Event)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // double wall_time = 1;
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_wall_time = this->_internal_wall_time();
+  uint64_t raw_wall_time;
+  memcpy(&raw_wall_time, &tmp_wall_time, sizeof(tmp_wall_time));
+  if (raw_wall_time != 0) {
+    total_size += 1 + 8;
+  }
+
+  // int64 step = 2;
+  if (this->_internal_step() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_step());
+  }
+
+  switch (what_case()) {
+    // string file_version = 3;
+    case kFileVersion: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+          this->_internal_file_version());
+      break;
+    }
+    // bytes graph_def = 4;
+    case kGraphDef: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_graph_def());
+      break;
+    }
+    // .tensorflow.Summary summary = 5;
+    case kSummary: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.what_.summary_);
+      break;
+    }
+    // .tensorflow.LogMessage log_message = 6;
+    case kLogMessage: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.what_.log_message_);
+      break;
+    }
+    // .tensorflow.SessionLog session_log = 7;
+    case kSessionLog: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.what_.session_log_);
+      break;
+    }
+    // .tensorflow.TaggedRunMetadata tagged_run_metadata = 8;
+    case kTaggedRunMetadata: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.what_.tagged_run_metadata_);
+      break;
+    }
+    // bytes meta_graph_def = 9;
+    case kMetaGraphDef: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_meta_graph_def());
+      break;
+    }
+    case WHAT_NOT_SET: {
+      break;
+    }
+  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Event::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Event::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Event::GetClassData() const { return &_class_data_; }
+
+
+void Event::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Event*>(&to_msg);
+  auto& from = static_cast<const Event&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.Event)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  static_assert(sizeof(uint64_t) == sizeof(double), "Code assumes uint64_t and double are the same size.");
+  double tmp_wall_time = from._internal_wall_time();
+  uint64_t raw_wall_time;
+  memcpy(&raw_wall_time, &tmp_wall_time, sizeof(tmp_wall_time));
+  if (raw_wall_time != 0) {
+    _this->_internal_set_wall_time(from._internal_wall_time());
+  }
+  if (from._internal_step() != 0) {
+    _this->_internal_set_step(from._internal_step());
+  }
+  switch (from.what_case()) {
+    case kFileVersion: {
+      _this->_internal_set_file_version(from._internal_file_version());
+      break;
+    }
+    case kGraphDef: {
+      _this->_internal_set_graph_def(from._internal_graph_def());
+      break;
+    }
+    case kSummary: {
+      _this->_internal_mutable_summary()->::tensorflow::Summary::MergeFrom(
+          from._internal_summary());
+      break;
+    }
+    case kLogMessage: {
+      _this->_internal_mutable_log_message()->::tensorflow::LogMessage::MergeFrom(
+          from._internal_log_message());
+      break;
+    }
+    case kSessionLog: {
+      _this->_internal_mutable_session_log()->::tensorflow::SessionLog::MergeFrom(
+          from._internal_session_log());
+      break;
+    }
+    case kTaggedRunMetadata: {
+      _this->_internal_mutable_tagged_run_metadata()->::tensorflow::TaggedRunMetadata::MergeFrom(
+          from._internal_tagged_run_metadata());
+      break;
+    }
+    case kMetaGraphDef: {
+      _this->_internal_set_meta_graph_def(from._internal_meta_graph_def());
+      break;
+    }
+    case WHAT_NOT_SET: {
+      break;
+    }
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void Event::CopyFrom(const Event& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.Event)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Event::IsInitialized() const {
+  return true;
+}
+
+void Event::InternalSwap(Event* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(Event, _impl_.step_)
+      + sizeof(Event::_impl_.step_)
+      - PROTOBUF_FIELD_OFFSET(Event, _impl_.wall_time_)>(
+          reinterpret_cast<char*>(&_impl_.wall_time_),
+          reinterpret_cast<char*>(&other->_impl_.wall_time_));
+  swap(_impl_.what_, other->_impl_.what_);
+  swap(_impl_._oneof_case_[0], other->_impl_._oneof_case_[0]);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Event::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[17]);
+}
+
+// ===================================================================
+
+class LogMessage::_Internal {
+ public:
+};
+
+LogMessage::LogMessage(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.LogMessage)
+}
+LogMessage::LogMessage(const LogMessage& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  LogMessage* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.message_){}
+    , decltype(_impl_.level_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.message_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.message_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_message().empty()) {
+    _this->_impl_.message_.Set(from._internal_message(), 
+      _this->GetArenaForAllocation());
+  }
+  _this->_impl_.level_ = from._impl_.level_;
+  // @@protoc_insertion_point(copy_constructor:tensorflow.LogMessage)
+}
+
+inline void LogMessage::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.message_){}
+    , decltype(_impl_.level_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.message_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.message_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+LogMessage::~LogMessage() {
+  // @@protoc_insertion_point(destructor:tensorflow.LogMessage)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void LogMessage::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.message_.Destroy();
+}
+
+void LogMessage::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void LogMessage::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.LogMessage)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.message_.ClearToEmpty();
+  _impl_.level_ = 0;
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* LogMessage::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // .tensorflow.LogMessage.Level level = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_level(static_cast<::tensorflow::LogMessage_Level>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // string message = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_message();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.LogMessage.message"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* LogMessage::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.LogMessage)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .tensorflow.LogMessage.Level level = 1;
+  if (this->_internal_level() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      1, this->_internal_level(), target);
+  }
+
+  // string message = 2;
+  if (!this->_internal_message().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_message().data(), static_cast<int>(this->_internal_message().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.LogMessage.message");
+    target = stream->WriteStringMaybeAliased(
+        2, this->_internal_message(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.LogMessage)
+  return target;
+}
+
+size_t LogMessage::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.LogMessage)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string message = 2;
+  if (!this->_internal_message().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_message());
+  }
+
+  // .tensorflow.LogMessage.Level level = 1;
+  if (this->_internal_level() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_level());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData LogMessage::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    LogMessage::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*LogMessage::GetClassData() const { return &_class_data_; }
+
+
+void LogMessage::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<LogMessage*>(&to_msg);
+  auto& from = static_cast<const LogMessage&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.LogMessage)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_message().empty()) {
+    _this->_internal_set_message(from._internal_message());
+  }
+  if (from._internal_level() != 0) {
+    _this->_internal_set_level(from._internal_level());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void LogMessage::CopyFrom(const LogMessage& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.LogMessage)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool LogMessage::IsInitialized() const {
+  return true;
+}
+
+void LogMessage::InternalSwap(LogMessage* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.message_, lhs_arena,
+      &other->_impl_.message_, rhs_arena
+  );
+  swap(_impl_.level_, other->_impl_.level_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata LogMessage::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[18]);
+}
+
+// ===================================================================
+
+class SessionLog::_Internal {
+ public:
+};
+
+SessionLog::SessionLog(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.SessionLog)
+}
+SessionLog::SessionLog(const SessionLog& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  SessionLog* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.checkpoint_path_){}
+    , decltype(_impl_.msg_){}
+    , decltype(_impl_.status_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.checkpoint_path_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.checkpoint_path_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_checkpoint_path().empty()) {
+    _this->_impl_.checkpoint_path_.Set(from._internal_checkpoint_path(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.msg_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.msg_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_msg().empty()) {
+    _this->_impl_.msg_.Set(from._internal_msg(), 
+      _this->GetArenaForAllocation());
+  }
+  _this->_impl_.status_ = from._impl_.status_;
+  // @@protoc_insertion_point(copy_constructor:tensorflow.SessionLog)
+}
+
+inline void SessionLog::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.checkpoint_path_){}
+    , decltype(_impl_.msg_){}
+    , decltype(_impl_.status_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.checkpoint_path_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.checkpoint_path_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.msg_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.msg_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+SessionLog::~SessionLog() {
+  // @@protoc_insertion_point(destructor:tensorflow.SessionLog)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void SessionLog::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.checkpoint_path_.Destroy();
+  _impl_.msg_.Destroy();
+}
+
+void SessionLog::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void SessionLog::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.SessionLog)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.checkpoint_path_.ClearToEmpty();
+  _impl_.msg_.ClearToEmpty();
+  _impl_.status_ = 0;
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* SessionLog::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // .tensorflow.SessionLog.SessionStatus status = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_status(static_cast<::tensorflow::SessionLog_SessionStatus>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // string checkpoint_path = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_checkpoint_path();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.SessionLog.checkpoint_path"));
+        } else
+          goto handle_unusual;
+        continue;
+      // string msg = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          auto str = _internal_mutable_msg();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.SessionLog.msg"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* SessionLog::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.SessionLog)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .tensorflow.SessionLog.SessionStatus status = 1;
+  if (this->_internal_status() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      1, this->_internal_status(), target);
+  }
+
+  // string checkpoint_path = 2;
+  if (!this->_internal_checkpoint_path().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_checkpoint_path().data(), static_cast<int>(this->_internal_checkpoint_path().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.SessionLog.checkpoint_path");
+    target = stream->WriteStringMaybeAliased(
+        2, this->_internal_checkpoint_path(), target);
+  }
+
+  // string msg = 3;
+  if (!this->_internal_msg().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_msg().data(), static_cast<int>(this->_internal_msg().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.SessionLog.msg");
+    target = stream->WriteStringMaybeAliased(
+        3, this->_internal_msg(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.SessionLog)
+  return target;
+}
+
+size_t SessionLog::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.SessionLog)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string checkpoint_path = 2;
+  if (!this->_internal_checkpoint_path().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_checkpoint_path());
+  }
+
+  // string msg = 3;
+  if (!this->_internal_msg().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_msg());
+  }
+
+  // .tensorflow.SessionLog.SessionStatus status = 1;
+  if (this->_internal_status() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_status());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData SessionLog::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    SessionLog::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*SessionLog::GetClassData() const { return &_class_data_; }
+
+
+void SessionLog::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<SessionLog*>(&to_msg);
+  auto& from = static_cast<const SessionLog&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.SessionLog)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_checkpoint_path().empty()) {
+    _this->_internal_set_checkpoint_path(from._internal_checkpoint_path());
+  }
+  if (!from._internal_msg().empty()) {
+    _this->_internal_set_msg(from._internal_msg());
+  }
+  if (from._internal_status() != 0) {
+    _this->_internal_set_status(from._internal_status());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void SessionLog::CopyFrom(const SessionLog& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.SessionLog)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool SessionLog::IsInitialized() const {
+  return true;
+}
+
+void SessionLog::InternalSwap(SessionLog* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.checkpoint_path_, lhs_arena,
+      &other->_impl_.checkpoint_path_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.msg_, lhs_arena,
+      &other->_impl_.msg_, rhs_arena
+  );
+  swap(_impl_.status_, other->_impl_.status_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata SessionLog::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[19]);
+}
+
+// ===================================================================
+
+class TaggedRunMetadata::_Internal {
+ public:
+};
+
+TaggedRunMetadata::TaggedRunMetadata(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:tensorflow.TaggedRunMetadata)
+}
+TaggedRunMetadata::TaggedRunMetadata(const TaggedRunMetadata& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  TaggedRunMetadata* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.tag_){}
+    , decltype(_impl_.run_metadata_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.tag_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.tag_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_tag().empty()) {
+    _this->_impl_.tag_.Set(from._internal_tag(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.run_metadata_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.run_metadata_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_run_metadata().empty()) {
+    _this->_impl_.run_metadata_.Set(from._internal_run_metadata(), 
+      _this->GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:tensorflow.TaggedRunMetadata)
+}
+
+inline void TaggedRunMetadata::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.tag_){}
+    , decltype(_impl_.run_metadata_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.tag_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.tag_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.run_metadata_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.run_metadata_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+TaggedRunMetadata::~TaggedRunMetadata() {
+  // @@protoc_insertion_point(destructor:tensorflow.TaggedRunMetadata)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void TaggedRunMetadata::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.tag_.Destroy();
+  _impl_.run_metadata_.Destroy();
+}
+
+void TaggedRunMetadata::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void TaggedRunMetadata::Clear() {
+// @@protoc_insertion_point(message_clear_start:tensorflow.TaggedRunMetadata)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.tag_.ClearToEmpty();
+  _impl_.run_metadata_.ClearToEmpty();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* TaggedRunMetadata::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string tag = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_tag();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "tensorflow.TaggedRunMetadata.tag"));
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes run_metadata = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_run_metadata();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* TaggedRunMetadata::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:tensorflow.TaggedRunMetadata)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string tag = 1;
+  if (!this->_internal_tag().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_tag().data(), static_cast<int>(this->_internal_tag().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "tensorflow.TaggedRunMetadata.tag");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_tag(), target);
+  }
+
+  // bytes run_metadata = 2;
+  if (!this->_internal_run_metadata().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        2, this->_internal_run_metadata(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:tensorflow.TaggedRunMetadata)
+  return target;
+}
+
+size_t TaggedRunMetadata::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:tensorflow.TaggedRunMetadata)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string tag = 1;
+  if (!this->_internal_tag().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_tag());
+  }
+
+  // bytes run_metadata = 2;
+  if (!this->_internal_run_metadata().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_run_metadata());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData TaggedRunMetadata::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    TaggedRunMetadata::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*TaggedRunMetadata::GetClassData() const { return &_class_data_; }
+
+
+void TaggedRunMetadata::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<TaggedRunMetadata*>(&to_msg);
+  auto& from = static_cast<const TaggedRunMetadata&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:tensorflow.TaggedRunMetadata)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_tag().empty()) {
+    _this->_internal_set_tag(from._internal_tag());
+  }
+  if (!from._internal_run_metadata().empty()) {
+    _this->_internal_set_run_metadata(from._internal_run_metadata());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void TaggedRunMetadata::CopyFrom(const TaggedRunMetadata& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:tensorflow.TaggedRunMetadata)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool TaggedRunMetadata::IsInitialized() const {
+  return true;
+}
+
+void TaggedRunMetadata::InternalSwap(TaggedRunMetadata* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.tag_, lhs_arena,
+      &other->_impl_.tag_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.run_metadata_, lhs_arena,
+      &other->_impl_.run_metadata_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata TaggedRunMetadata::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_tensorboard_2eproto_getter, &descriptor_table_tensorboard_2eproto_once,
+      file_level_metadata_tensorboard_2eproto[20]);
+}
+
+// @@protoc_insertion_point(namespace_scope)
+}  // namespace tensorflow
+PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::tensorflow::TensorShapeProto_Dim*
+Arena::CreateMaybeMessage< ::tensorflow::TensorShapeProto_Dim >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::TensorShapeProto_Dim >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::TensorShapeProto*
+Arena::CreateMaybeMessage< ::tensorflow::TensorShapeProto >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::TensorShapeProto >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::TensorProto*
+Arena::CreateMaybeMessage< ::tensorflow::TensorProto >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::TensorProto >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::VersionDef*
+Arena::CreateMaybeMessage< ::tensorflow::VersionDef >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::VersionDef >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::SummaryDescription*
+Arena::CreateMaybeMessage< ::tensorflow::SummaryDescription >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::SummaryDescription >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::HistogramProto*
+Arena::CreateMaybeMessage< ::tensorflow::HistogramProto >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::HistogramProto >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::Summary_Image*
+Arena::CreateMaybeMessage< ::tensorflow::Summary_Image >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::Summary_Image >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::Summary_Audio*
+Arena::CreateMaybeMessage< ::tensorflow::Summary_Audio >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::Summary_Audio >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::Summary_Value*
+Arena::CreateMaybeMessage< ::tensorflow::Summary_Value >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::Summary_Value >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::Summary*
+Arena::CreateMaybeMessage< ::tensorflow::Summary >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::Summary >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::AttrValue_ListValue*
+Arena::CreateMaybeMessage< ::tensorflow::AttrValue_ListValue >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::AttrValue_ListValue >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::AttrValue*
+Arena::CreateMaybeMessage< ::tensorflow::AttrValue >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::AttrValue >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::NameAttrList_AttrEntry_DoNotUse*
+Arena::CreateMaybeMessage< ::tensorflow::NameAttrList_AttrEntry_DoNotUse >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::NameAttrList_AttrEntry_DoNotUse >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::NameAttrList*
+Arena::CreateMaybeMessage< ::tensorflow::NameAttrList >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::NameAttrList >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::NodeDef_AttrEntry_DoNotUse*
+Arena::CreateMaybeMessage< ::tensorflow::NodeDef_AttrEntry_DoNotUse >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::NodeDef_AttrEntry_DoNotUse >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::NodeDef*
+Arena::CreateMaybeMessage< ::tensorflow::NodeDef >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::NodeDef >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::GraphDef*
+Arena::CreateMaybeMessage< ::tensorflow::GraphDef >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::GraphDef >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::Event*
+Arena::CreateMaybeMessage< ::tensorflow::Event >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::Event >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::LogMessage*
+Arena::CreateMaybeMessage< ::tensorflow::LogMessage >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::LogMessage >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::SessionLog*
+Arena::CreateMaybeMessage< ::tensorflow::SessionLog >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::SessionLog >(arena);
+}
+template<> PROTOBUF_NOINLINE ::tensorflow::TaggedRunMetadata*
+Arena::CreateMaybeMessage< ::tensorflow::TaggedRunMetadata >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::tensorflow::TaggedRunMetadata >(arena);
+}
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+#include <google/protobuf/port_undef.inc>
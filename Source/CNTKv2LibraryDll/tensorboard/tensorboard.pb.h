@@ -0,0 +1,9046 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: tensorboard.proto
+
+#ifndef GOOGLE_PROTOBUF_INCLUDED_tensorboard_2eproto
+#define GOOGLE_PROTOBUF_INCLUDED_tensorboard_2eproto
+
+#include <limits>
+#include <string>
+
+#include <google/protobuf/port_def.inc>
+#if PROTOBUF_VERSION < 3021000
+#error This file was generated by a newer version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please update
+#error your headers.
+#endif
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
+#error This file was generated by an older version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please
+#error regenerate this file with a newer version of protoc.
+#endif
+
+#include <google/protobuf/port_undef.inc>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/arenastring.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/metadata_lite.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>  // IWYU pragma: export
+#include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/map.h>  // IWYU pragma: export
+#include <google/protobuf/map_entry.h>
+#include <google/protobuf/map_field_inl.h>
+#include <google/protobuf/generated_enum_reflection.h>
+#include <google/protobuf/unknown_field_set.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+#define PROTOBUF_INTERNAL_EXPORT_tensorboard_2eproto
+PROTOBUF_NAMESPACE_OPEN
+namespace internal {
+class AnyMetadata;
+}  // namespace internal
+PROTOBUF_NAMESPACE_CLOSE
+
+// Internal implementation detail -- do not use these members.
+struct TableStruct_tensorboard_2eproto {
+  static const uint32_t offsets[];
+};
+extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_tensorboard_2eproto;
+namespace tensorflow {
+class AttrValue;
+struct AttrValueDefaultTypeInternal;
+extern AttrValueDefaultTypeInternal _AttrValue_default_instance_;
+class AttrValue_ListValue;
+struct AttrValue_ListValueDefaultTypeInternal;
+extern AttrValue_ListValueDefaultTypeInternal _AttrValue_ListValue_default_instance_;
+class Event;
+struct EventDefaultTypeInternal;
+extern EventDefaultTypeInternal _Event_default_instance_;
+class GraphDef;
+struct GraphDefDefaultTypeInternal;
+extern GraphDefDefaultTypeInternal _GraphDef_default_instance_;
+class HistogramProto;
+struct HistogramProtoDefaultTypeInternal;
+extern HistogramProtoDefaultTypeInternal _HistogramProto_default_instance_;
+class LogMessage;
+struct LogMessageDefaultTypeInternal;
+extern LogMessageDefaultTypeInternal _LogMessage_default_instance_;
+class NameAttrList;
+struct NameAttrListDefaultTypeInternal;
+extern NameAttrListDefaultTypeInternal _NameAttrList_default_instance_;
+class NameAttrList_AttrEntry_DoNotUse;
+struct NameAttrList_AttrEntry_DoNotUseDefaultTypeInternal;
+extern NameAttrList_AttrEntry_DoNotUseDefaultTypeInternal _NameAttrList_AttrEntry_DoNotUse_default_instance_;
+class NodeDef;
+struct NodeDefDefaultTypeInternal;
+extern NodeDefDefaultTypeInternal _NodeDef_default_instance_;
+class NodeDef_AttrEntry_DoNotUse;
+struct NodeDef_AttrEntry_DoNotUseDefaultTypeInternal;
+extern NodeDef_AttrEntry_DoNotUseDefaultTypeInternal _NodeDef_AttrEntry_DoNotUse_default_instance_;
+class SessionLog;
+struct SessionLogDefaultTypeInternal;
+extern SessionLogDefaultTypeInternal _SessionLog_default_instance_;
+class Summary;
+struct SummaryDefaultTypeInternal;
+extern SummaryDefaultTypeInternal _Summary_default_instance_;
+class SummaryDescription;
+struct SummaryDescriptionDefaultTypeInternal;
+extern SummaryDescriptionDefaultTypeInternal _SummaryDescription_default_instance_;
+class Summary_Audio;
+struct Summary_AudioDefaultTypeInternal;
+extern Summary_AudioDefaultTypeInternal _Summary_Audio_default_instance_;
+class Summary_Image;
+struct Summary_ImageDefaultTypeInternal;
+extern Summary_ImageDefaultTypeInternal _Summary_Image_default_instance_;
+class Summary_Value;
+struct Summary_ValueDefaultTypeInternal;
+extern Summary_ValueDefaultTypeInternal _Summary_Value_default_instance_;
+class TaggedRunMetadata;
+struct TaggedRunMetadataDefaultTypeInternal;
+extern TaggedRunMetadataDefaultTypeInternal _TaggedRunMetadata_default_instance_;
+class TensorProto;
+struct TensorProtoDefaultTypeInternal;
+extern TensorProtoDefaultTypeInternal _TensorProto_default_instance_;
+class TensorShapeProto;
+struct TensorShapeProtoDefaultTypeInternal;
+extern TensorShapeProtoDefaultTypeInternal _TensorShapeProto_default_instance_;
+class TensorShapeProto_Dim;
+struct TensorShapeProto_DimDefaultTypeInternal;
+extern TensorShapeProto_DimDefaultTypeInternal _TensorShapeProto_Dim_default_instance_;
+class VersionDef;
+struct VersionDefDefaultTypeInternal;
+extern VersionDefDefaultTypeInternal _VersionDef_default_instance_;
+}  // namespace tensorflow
+PROTOBUF_NAMESPACE_OPEN
+template<> ::tensorflow::AttrValue* Arena::CreateMaybeMessage<::tensorflow::AttrValue>(Arena*);
+template<> ::tensorflow::AttrValue_ListValue* Arena::CreateMaybeMessage<::tensorflow::AttrValue_ListValue>(Arena*);
+template<> ::tensorflow::Event* Arena::CreateMaybeMessage<::tensorflow::Event>(Arena*);
+template<> ::tensorflow::GraphDef* Arena::CreateMaybeMessage<::tensorflow::GraphDef>(Arena*);
+template<> ::tensorflow::HistogramProto* Arena::CreateMaybeMessage<::tensorflow::HistogramProto>(Arena*);
+template<> ::tensorflow::LogMessage* Arena::CreateMaybeMessage<::tensorflow::LogMessage>(Arena*);
+template<> ::tensorflow::NameAttrList* Arena::CreateMaybeMessage<::tensorflow::NameAttrList>(Arena*);
+template<> ::tensorflow::NameAttrList_AttrEntry_DoNotUse* Arena::CreateMaybeMessage<::tensorflow::NameAttrList_AttrEntry_DoNotUse>(Arena*);
+template<> ::tensorflow::NodeDef* Arena::CreateMaybeMessage<::tensorflow::NodeDef>(Arena*);
+template<> ::tensorflow::NodeDef_AttrEntry_DoNotUse* Arena::CreateMaybeMessage<::tensorflow::NodeDef_AttrEntry_DoNotUse>(Arena*);
+template<> ::tensorflow::SessionLog* Arena::CreateMaybeMessage<::tensorflow::SessionLog>(Arena*);
+template<> ::tensorflow::Summary* Arena::CreateMaybeMessage<::tensorflow::Summary>(Arena*);
+template<> ::tensorflow::SummaryDescription* Arena::CreateMaybeMessage<::tensorflow::SummaryDescription>(Arena*);
+template<> ::tensorflow::Summary_Audio* Arena::CreateMaybeMessage<::tensorflow::Summary_Audio>(Arena*);
+template<> ::tensorflow::Summary_Image* Arena::CreateMaybeMessage<::tensorflow::Summary_Image>(Arena*);
+template<> ::tensorflow::Summary_Value* Arena::CreateMaybeMessage<::tensorflow::Summary_Value>(Arena*);
+template<> ::tensorflow::TaggedRunMetadata* Arena::CreateMaybeMessage<::tensorflow::TaggedRunMetadata>(Arena*);
+template<> ::tensorflow::TensorProto* Arena::CreateMaybeMessage<::tensorflow::TensorProto>(Arena*);
+template<> ::tensorflow::TensorShapeProto* Arena::CreateMaybeMessage<::tensorflow::TensorShapeProto>(Arena*);
+template<> ::tensorflow::TensorShapeProto_Dim* Arena::CreateMaybeMessage<::tensorflow::TensorShapeProto_Dim>(Arena*);
+template<> ::tensorflow::VersionDef* Arena::CreateMaybeMessage<::tensorflow::VersionDef>(Arena*);
+PROTOBUF_NAMESPACE_CLOSE
+namespace tensorflow {
+
+enum LogMessage_Level : int {
+  LogMessage_Level_UNKNOWN = 0,
+  LogMessage_Level_DEBUG = 10,
+  LogMessage_Level_INFO = 20,
+  LogMessage_Level_WARN = 30,
+  LogMessage_Level_ERROR = 40,
+  LogMessage_Level_FATAL = 50,
+  LogMessage_Level_LogMessage_Level_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  LogMessage_Level_LogMessage_Level_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool LogMessage_Level_IsValid(int value);
+constexpr LogMessage_Level LogMessage_Level_Level_MIN = LogMessage_Level_UNKNOWN;
+constexpr LogMessage_Level LogMessage_Level_Level_MAX = LogMessage_Level_FATAL;
+constexpr int LogMessage_Level_Level_ARRAYSIZE = LogMessage_Level_Level_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* LogMessage_Level_descriptor();
+template<typename T>
+inline const std::string& LogMessage_Level_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, LogMessage_Level>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function LogMessage_Level_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    LogMessage_Level_descriptor(), enum_t_value);
+}
+inline bool LogMessage_Level_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, LogMessage_Level* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<LogMessage_Level>(
+    LogMessage_Level_descriptor(), name, value);
+}
+enum SessionLog_SessionStatus : int {
+  SessionLog_SessionStatus_STATUS_UNSPECIFIED = 0,
+  SessionLog_SessionStatus_START = 1,
+  SessionLog_SessionStatus_STOP = 2,
+  SessionLog_SessionStatus_CHECKPOINT = 3,
+  SessionLog_SessionStatus_SessionLog_SessionStatus_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  SessionLog_SessionStatus_SessionLog_SessionStatus_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool SessionLog_SessionStatus_IsValid(int value);
+constexpr SessionLog_SessionStatus SessionLog_SessionStatus_SessionStatus_MIN = SessionLog_SessionStatus_STATUS_UNSPECIFIED;
+constexpr SessionLog_SessionStatus SessionLog_SessionStatus_SessionStatus_MAX = SessionLog_SessionStatus_CHECKPOINT;
+constexpr int SessionLog_SessionStatus_SessionStatus_ARRAYSIZE = SessionLog_SessionStatus_SessionStatus_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* SessionLog_SessionStatus_descriptor();
+template<typename T>
+inline const std::string& SessionLog_SessionStatus_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, SessionLog_SessionStatus>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function SessionLog_SessionStatus_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    SessionLog_SessionStatus_descriptor(), enum_t_value);
+}
+inline bool SessionLog_SessionStatus_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, SessionLog_SessionStatus* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<SessionLog_SessionStatus>(
+    SessionLog_SessionStatus_descriptor(), name, value);
+}
+enum DataType : int {
+  DT_INVALID = 0,
+  DT_FLOAT = 1,
+  DT_DOUBLE = 2,
+  DT_INT32 = 3,
+  DT_UINT8 = 4,
+  DT_INT16 = 5,
+  DT_INT8 = 6,
+  DT_STRING = 7,
+  DT_COMPLEX64 = 8,
+  DT_INT64 = 9,
+  DT_BOOL = 10,
+  DT_QINT8 = 11,
+  DT_QUINT8 = 12,
+  DT_QINT32 = 13,
+  DT_BFLOAT16 = 14,
+  DT_QINT16 = 15,
+  DT_QUINT16 = 16,
+  DT_UINT16 = 17,
+  DT_COMPLEX128 = 18,
+  DT_HALF = 19,
+  DT_RESOURCE = 20,
+  DT_FLOAT_REF = 101,
+  DT_DOUBLE_REF = 102,
+  DT_INT32_REF = 103,
+  DT_UINT8_REF = 104,
+  DT_INT16_REF = 105,
+  DT_INT8_REF = 106,
+  DT_STRING_REF = 107,
+  DT_COMPLEX64_REF = 108,
+  DT_INT64_REF = 109,
+  DT_BOOL_REF = 110,
+  DT_QINT8_REF = 111,
+  DT_QUINT8_REF = 112,
+  DT_QINT32_REF = 113,
+  DT_BFLOAT16_REF = 114,
+  DT_QINT16_REF = 115,
+  DT_QUINT16_REF = 116,
+  DT_UINT16_REF = 117,
+  DT_COMPLEX128_REF = 118,
+  DT_HALF_REF = 119,
+  DT_RESOURCE_REF = 120,
+  DataType_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  DataType_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool DataType_IsValid(int value);
+constexpr DataType DataType_MIN = DT_INVALID;
+constexpr DataType DataType_MAX = DT_RESOURCE_REF;
+constexpr int DataType_ARRAYSIZE = DataType_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* DataType_descriptor();
+template<typename T>
+inline const std::string& DataType_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, DataType>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function DataType_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    DataType_descriptor(), enum_t_value);
+}
+inline bool DataType_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, DataType* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<DataType>(
+    DataType_descriptor(), name, value);
+}
+// ===================================================================
+
+class TensorShapeProto_Dim final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.TensorShapeProto.Dim) */ {
+ public:
+  inline TensorShapeProto_Dim() : TensorShapeProto_Dim(nullptr) {}
+  ~TensorShapeProto_Dim() override;
+  explicit PROTOBUF_CONSTEXPR TensorShapeProto_Dim(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  TensorShapeProto_Dim(const TensorShapeProto_Dim& from);
+  TensorShapeProto_Dim(TensorShapeProto_Dim&& from) noexcept
+    : TensorShapeProto_Dim() {
+    *this = ::std::move(from);
+  }
+
+  inline TensorShapeProto_Dim& operator=(const TensorShapeProto_Dim& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline TensorShapeProto_Dim& operator=(TensorShapeProto_Dim&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const TensorShapeProto_Dim& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const TensorShapeProto_Dim* internal_default_instance() {
+    return reinterpret_cast<const TensorShapeProto_Dim*>(
+               &_TensorShapeProto_Dim_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(TensorShapeProto_Dim& a, TensorShapeProto_Dim& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(TensorShapeProto_Dim* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(TensorShapeProto_Dim* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  TensorShapeProto_Dim* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<TensorShapeProto_Dim>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const TensorShapeProto_Dim& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const TensorShapeProto_Dim& from) {
+    TensorShapeProto_Dim::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(TensorShapeProto_Dim* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.TensorShapeProto.Dim";
+  }
+  protected:
+  explicit TensorShapeProto_Dim(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kNameFieldNumber = 2,
+    kSizeFieldNumber = 1,
+  };
+  // string name = 2;
+  void clear_name();
+  const std::string& name() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_name(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_name();
+  PROTOBUF_NODISCARD std::string* release_name();
+  void set_allocated_name(std::string* name);
+  private:
+  const std::string& _internal_name() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_name(const std::string& value);
+  std::string* _internal_mutable_name();
+  public:
+
+  // int64 size = 1;
+  void clear_size();
+  int64_t size() const;
+  void set_size(int64_t value);
+  private:
+  int64_t _internal_size() const;
+  void _internal_set_size(int64_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.TensorShapeProto.Dim)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr name_;
+    int64_t size_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class TensorShapeProto final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.TensorShapeProto) */ {
+ public:
+  inline TensorShapeProto() : TensorShapeProto(nullptr) {}
+  ~TensorShapeProto() override;
+  explicit PROTOBUF_CONSTEXPR TensorShapeProto(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  TensorShapeProto(const TensorShapeProto& from);
+  TensorShapeProto(TensorShapeProto&& from) noexcept
+    : TensorShapeProto() {
+    *this = ::std::move(from);
+  }
+
+  inline TensorShapeProto& operator=(const TensorShapeProto& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline TensorShapeProto& operator=(TensorShapeProto&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const TensorShapeProto& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const TensorShapeProto* internal_default_instance() {
+    return reinterpret_cast<const TensorShapeProto*>(
+               &_TensorShapeProto_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(TensorShapeProto& a, TensorShapeProto& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(TensorShapeProto* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(TensorShapeProto* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  TensorShapeProto* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<TensorShapeProto>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const TensorShapeProto& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const TensorShapeProto& from) {
+    TensorShapeProto::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(TensorShapeProto* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.TensorShapeProto";
+  }
+  protected:
+  explicit TensorShapeProto(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef TensorShapeProto_Dim Dim;
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kDimFieldNumber = 2,
+    kUnknownRankFieldNumber = 3,
+  };
+  // repeated .tensorflow.TensorShapeProto.Dim dim = 2;
+  int dim_size() const;
+  private:
+  int _internal_dim_size() const;
+  public:
+  void clear_dim();
+  ::tensorflow::TensorShapeProto_Dim* mutable_dim(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto_Dim >*
+      mutable_dim();
+  private:
+  const ::tensorflow::TensorShapeProto_Dim& _internal_dim(int index) const;
+  ::tensorflow::TensorShapeProto_Dim* _internal_add_dim();
+  public:
+  const ::tensorflow::TensorShapeProto_Dim& dim(int index) const;
+  ::tensorflow::TensorShapeProto_Dim* add_dim();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto_Dim >&
+      dim() const;
+
+  // bool unknown_rank = 3;
+  void clear_unknown_rank();
+  bool unknown_rank() const;
+  void set_unknown_rank(bool value);
+  private:
+  bool _internal_unknown_rank() const;
+  void _internal_set_unknown_rank(bool value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.TensorShapeProto)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto_Dim > dim_;
+    bool unknown_rank_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class TensorProto final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.TensorProto) */ {
+ public:
+  inline TensorProto() : TensorProto(nullptr) {}
+  ~TensorProto() override;
+  explicit PROTOBUF_CONSTEXPR TensorProto(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  TensorProto(const TensorProto& from);
+  TensorProto(TensorProto&& from) noexcept
+    : TensorProto() {
+    *this = ::std::move(from);
+  }
+
+  inline TensorProto& operator=(const TensorProto& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline TensorProto& operator=(TensorProto&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const TensorProto& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const TensorProto* internal_default_instance() {
+    return reinterpret_cast<const TensorProto*>(
+               &_TensorProto_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    2;
+
+  friend void swap(TensorProto& a, TensorProto& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(TensorProto* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(TensorProto* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  TensorProto* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<TensorProto>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const TensorProto& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const TensorProto& from) {
+    TensorProto::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(TensorProto* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.TensorProto";
+  }
+  protected:
+  explicit TensorProto(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kFloatValFieldNumber = 5,
+    kDoubleValFieldNumber = 6,
+    kIntValFieldNumber = 7,
+    kStringValFieldNumber = 8,
+    kScomplexValFieldNumber = 9,
+    kInt64ValFieldNumber = 10,
+    kBoolValFieldNumber = 11,
+    kDcomplexValFieldNumber = 12,
+    kHalfValFieldNumber = 13,
+    kTensorContentFieldNumber = 4,
+    kTensorShapeFieldNumber = 2,
+    kDtypeFieldNumber = 1,
+    kVersionNumberFieldNumber = 3,
+  };
+  // repeated float float_val = 5 [packed = true];
+  int float_val_size() const;
+  private:
+  int _internal_float_val_size() const;
+  public:
+  void clear_float_val();
+  private:
+  float _internal_float_val(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+      _internal_float_val() const;
+  void _internal_add_float_val(float value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+      _internal_mutable_float_val();
+  public:
+  float float_val(int index) const;
+  void set_float_val(int index, float value);
+  void add_float_val(float value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+      float_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+      mutable_float_val();
+
+  // repeated double double_val = 6 [packed = true];
+  int double_val_size() const;
+  private:
+  int _internal_double_val_size() const;
+  public:
+  void clear_double_val();
+  private:
+  double _internal_double_val(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+      _internal_double_val() const;
+  void _internal_add_double_val(double value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+      _internal_mutable_double_val();
+  public:
+  double double_val(int index) const;
+  void set_double_val(int index, double value);
+  void add_double_val(double value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+      double_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+      mutable_double_val();
+
+  // repeated int32 int_val = 7 [packed = true];
+  int int_val_size() const;
+  private:
+  int _internal_int_val_size() const;
+  public:
+  void clear_int_val();
+  private:
+  int32_t _internal_int_val(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+      _internal_int_val() const;
+  void _internal_add_int_val(int32_t value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+      _internal_mutable_int_val();
+  public:
+  int32_t int_val(int index) const;
+  void set_int_val(int index, int32_t value);
+  void add_int_val(int32_t value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+      int_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+      mutable_int_val();
+
+  // repeated bytes string_val = 8;
+  int string_val_size() const;
+  private:
+  int _internal_string_val_size() const;
+  public:
+  void clear_string_val();
+  const std::string& string_val(int index) const;
+  std::string* mutable_string_val(int index);
+  void set_string_val(int index, const std::string& value);
+  void set_string_val(int index, std::string&& value);
+  void set_string_val(int index, const char* value);
+  void set_string_val(int index, const void* value, size_t size);
+  std::string* add_string_val();
+  void add_string_val(const std::string& value);
+  void add_string_val(std::string&& value);
+  void add_string_val(const char* value);
+  void add_string_val(const void* value, size_t size);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>& string_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>* mutable_string_val();
+  private:
+  const std::string& _internal_string_val(int index) const;
+  std::string* _internal_add_string_val();
+  public:
+
+  // repeated float scomplex_val = 9 [packed = true];
+  int scomplex_val_size() const;
+  private:
+  int _internal_scomplex_val_size() const;
+  public:
+  void clear_scomplex_val();
+  private:
+  float _internal_scomplex_val(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+      _internal_scomplex_val() const;
+  void _internal_add_scomplex_val(float value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+      _internal_mutable_scomplex_val();
+  public:
+  float scomplex_val(int index) const;
+  void set_scomplex_val(int index, float value);
+  void add_scomplex_val(float value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+      scomplex_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+      mutable_scomplex_val();
+
+  // repeated int64 int64_val = 10 [packed = true];
+  int int64_val_size() const;
+  private:
+  int _internal_int64_val_size() const;
+  public:
+  void clear_int64_val();
+  private:
+  int64_t _internal_int64_val(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+      _internal_int64_val() const;
+  void _internal_add_int64_val(int64_t value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+      _internal_mutable_int64_val();
+  public:
+  int64_t int64_val(int index) const;
+  void set_int64_val(int index, int64_t value);
+  void add_int64_val(int64_t value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+      int64_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+      mutable_int64_val();
+
+  // repeated bool bool_val = 11 [packed = true];
+  int bool_val_size() const;
+  private:
+  int _internal_bool_val_size() const;
+  public:
+  void clear_bool_val();
+  private:
+  bool _internal_bool_val(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+      _internal_bool_val() const;
+  void _internal_add_bool_val(bool value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+      _internal_mutable_bool_val();
+  public:
+  bool bool_val(int index) const;
+  void set_bool_val(int index, bool value);
+  void add_bool_val(bool value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+      bool_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+      mutable_bool_val();
+
+  // repeated double dcomplex_val = 12 [packed = true];
+  int dcomplex_val_size() const;
+  private:
+  int _internal_dcomplex_val_size() const;
+  public:
+  void clear_dcomplex_val();
+  private:
+  double _internal_dcomplex_val(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+      _internal_dcomplex_val() const;
+  void _internal_add_dcomplex_val(double value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+      _internal_mutable_dcomplex_val();
+  public:
+  double dcomplex_val(int index) const;
+  void set_dcomplex_val(int index, double value);
+  void add_dcomplex_val(double value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+      dcomplex_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+      mutable_dcomplex_val();
+
+  // repeated int32 half_val = 13 [packed = true];
+  int half_val_size() const;
+  private:
+  int _internal_half_val_size() const;
+  public:
+  void clear_half_val();
+  private:
+  int32_t _internal_half_val(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+      _internal_half_val() const;
+  void _internal_add_half_val(int32_t value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+      _internal_mutable_half_val();
+  public:
+  int32_t half_val(int index) const;
+  void set_half_val(int index, int32_t value);
+  void add_half_val(int32_t value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+      half_val() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+      mutable_half_val();
+
+  // bytes tensor_content = 4;
+  void clear_tensor_content();
+  const std::string& tensor_content() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_tensor_content(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_tensor_content();
+  PROTOBUF_NODISCARD std::string* release_tensor_content();
+  void set_allocated_tensor_content(std::string* tensor_content);
+  private:
+  const std::string& _internal_tensor_content() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_tensor_content(const std::string& value);
+  std::string* _internal_mutable_tensor_content();
+  public:
+
+  // .tensorflow.TensorShapeProto tensor_shape = 2;
+  bool has_tensor_shape() const;
+  private:
+  bool _internal_has_tensor_shape() const;
+  public:
+  void clear_tensor_shape();
+  const ::tensorflow::TensorShapeProto& tensor_shape() const;
+  PROTOBUF_NODISCARD ::tensorflow::TensorShapeProto* release_tensor_shape();
+  ::tensorflow::TensorShapeProto* mutable_tensor_shape();
+  void set_allocated_tensor_shape(::tensorflow::TensorShapeProto* tensor_shape);
+  private:
+  const ::tensorflow::TensorShapeProto& _internal_tensor_shape() const;
+  ::tensorflow::TensorShapeProto* _internal_mutable_tensor_shape();
+  public:
+  void unsafe_arena_set_allocated_tensor_shape(
+      ::tensorflow::TensorShapeProto* tensor_shape);
+  ::tensorflow::TensorShapeProto* unsafe_arena_release_tensor_shape();
+
+  // .tensorflow.DataType dtype = 1;
+  void clear_dtype();
+  ::tensorflow::DataType dtype() const;
+  void set_dtype(::tensorflow::DataType value);
+  private:
+  ::tensorflow::DataType _internal_dtype() const;
+  void _internal_set_dtype(::tensorflow::DataType value);
+  public:
+
+  // int32 version_number = 3;
+  void clear_version_number();
+  int32_t version_number() const;
+  void set_version_number(int32_t value);
+  private:
+  int32_t _internal_version_number() const;
+  void _internal_set_version_number(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.TensorProto)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< float > float_val_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< double > double_val_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t > int_val_;
+    mutable std::atomic<int> _int_val_cached_byte_size_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string> string_val_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< float > scomplex_val_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t > int64_val_;
+    mutable std::atomic<int> _int64_val_cached_byte_size_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool > bool_val_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< double > dcomplex_val_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t > half_val_;
+    mutable std::atomic<int> _half_val_cached_byte_size_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr tensor_content_;
+    ::tensorflow::TensorShapeProto* tensor_shape_;
+    int dtype_;
+    int32_t version_number_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class VersionDef final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.VersionDef) */ {
+ public:
+  inline VersionDef() : VersionDef(nullptr) {}
+  ~VersionDef() override;
+  explicit PROTOBUF_CONSTEXPR VersionDef(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  VersionDef(const VersionDef& from);
+  VersionDef(VersionDef&& from) noexcept
+    : VersionDef() {
+    *this = ::std::move(from);
+  }
+
+  inline VersionDef& operator=(const VersionDef& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline VersionDef& operator=(VersionDef&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const VersionDef& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const VersionDef* internal_default_instance() {
+    return reinterpret_cast<const VersionDef*>(
+               &_VersionDef_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    3;
+
+  friend void swap(VersionDef& a, VersionDef& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(VersionDef* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(VersionDef* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  VersionDef* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<VersionDef>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const VersionDef& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const VersionDef& from) {
+    VersionDef::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(VersionDef* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.VersionDef";
+  }
+  protected:
+  explicit VersionDef(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kBadConsumersFieldNumber = 3,
+    kProducerFieldNumber = 1,
+    kMinConsumerFieldNumber = 2,
+  };
+  // repeated int32 bad_consumers = 3;
+  int bad_consumers_size() const;
+  private:
+  int _internal_bad_consumers_size() const;
+  public:
+  void clear_bad_consumers();
+  private:
+  int32_t _internal_bad_consumers(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+      _internal_bad_consumers() const;
+  void _internal_add_bad_consumers(int32_t value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+      _internal_mutable_bad_consumers();
+  public:
+  int32_t bad_consumers(int index) const;
+  void set_bad_consumers(int index, int32_t value);
+  void add_bad_consumers(int32_t value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+      bad_consumers() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+      mutable_bad_consumers();
+
+  // int32 producer = 1;
+  void clear_producer();
+  int32_t producer() const;
+  void set_producer(int32_t value);
+  private:
+  int32_t _internal_producer() const;
+  void _internal_set_producer(int32_t value);
+  public:
+
+  // int32 min_consumer = 2;
+  void clear_min_consumer();
+  int32_t min_consumer() const;
+  void set_min_consumer(int32_t value);
+  private:
+  int32_t _internal_min_consumer() const;
+  void _internal_set_min_consumer(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.VersionDef)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t > bad_consumers_;
+    mutable std::atomic<int> _bad_consumers_cached_byte_size_;
+    int32_t producer_;
+    int32_t min_consumer_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class SummaryDescription final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.SummaryDescription) */ {
+ public:
+  inline SummaryDescription() : SummaryDescription(nullptr) {}
+  ~SummaryDescription() override;
+  explicit PROTOBUF_CONSTEXPR SummaryDescription(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  SummaryDescription(const SummaryDescription& from);
+  SummaryDescription(SummaryDescription&& from) noexcept
+    : SummaryDescription() {
+    *this = ::std::move(from);
+  }
+
+  inline SummaryDescription& operator=(const SummaryDescription& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline SummaryDescription& operator=(SummaryDescription&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const SummaryDescription& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const SummaryDescription* internal_default_instance() {
+    return reinterpret_cast<const SummaryDescription*>(
+               &_SummaryDescription_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    4;
+
+  friend void swap(SummaryDescription& a, SummaryDescription& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(SummaryDescription* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(SummaryDescription* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  SummaryDescription* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<SummaryDescription>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const SummaryDescription& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const SummaryDescription& from) {
+    SummaryDescription::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(SummaryDescription* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.SummaryDescription";
+  }
+  protected:
+  explicit SummaryDescription(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kTypeHintFieldNumber = 1,
+  };
+  // string type_hint = 1;
+  void clear_type_hint();
+  const std::string& type_hint() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_type_hint(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_type_hint();
+  PROTOBUF_NODISCARD std::string* release_type_hint();
+  void set_allocated_type_hint(std::string* type_hint);
+  private:
+  const std::string& _internal_type_hint() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_type_hint(const std::string& value);
+  std::string* _internal_mutable_type_hint();
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.SummaryDescription)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr type_hint_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class HistogramProto final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.HistogramProto) */ {
+ public:
+  inline HistogramProto() : HistogramProto(nullptr) {}
+  ~HistogramProto() override;
+  explicit PROTOBUF_CONSTEXPR HistogramProto(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  HistogramProto(const HistogramProto& from);
+  HistogramProto(HistogramProto&& from) noexcept
+    : HistogramProto() {
+    *this = ::std::move(from);
+  }
+
+  inline HistogramProto& operator=(const HistogramProto& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline HistogramProto& operator=(HistogramProto&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const HistogramProto& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const HistogramProto* internal_default_instance() {
+    return reinterpret_cast<const HistogramProto*>(
+               &_HistogramProto_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    5;
+
+  friend void swap(HistogramProto& a, HistogramProto& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(HistogramProto* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(HistogramProto* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  HistogramProto* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<HistogramProto>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const HistogramProto& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const HistogramProto& from) {
+    HistogramProto::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(HistogramProto* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.HistogramProto";
+  }
+  protected:
+  explicit HistogramProto(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kBucketLimitFieldNumber = 6,
+    kBucketFieldNumber = 7,
+    kMinFieldNumber = 1,
+    kMaxFieldNumber = 2,
+    kNumFieldNumber = 3,
+    kSumFieldNumber = 4,
+    kSumSquaresFieldNumber = 5,
+  };
+  // repeated double bucket_limit = 6 [packed = true];
+  int bucket_limit_size() const;
+  private:
+  int _internal_bucket_limit_size() const;
+  public:
+  void clear_bucket_limit();
+  private:
+  double _internal_bucket_limit(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+      _internal_bucket_limit() const;
+  void _internal_add_bucket_limit(double value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+      _internal_mutable_bucket_limit();
+  public:
+  double bucket_limit(int index) const;
+  void set_bucket_limit(int index, double value);
+  void add_bucket_limit(double value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+      bucket_limit() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+      mutable_bucket_limit();
+
+  // repeated double bucket = 7 [packed = true];
+  int bucket_size() const;
+  private:
+  int _internal_bucket_size() const;
+  public:
+  void clear_bucket();
+  private:
+  double _internal_bucket(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+      _internal_bucket() const;
+  void _internal_add_bucket(double value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+      _internal_mutable_bucket();
+  public:
+  double bucket(int index) const;
+  void set_bucket(int index, double value);
+  void add_bucket(double value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+      bucket() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+      mutable_bucket();
+
+  // double min = 1;
+  void clear_min();
+  double min() const;
+  void set_min(double value);
+  private:
+  double _internal_min() const;
+  void _internal_set_min(double value);
+  public:
+
+  // double max = 2;
+  void clear_max();
+  double max() const;
+  void set_max(double value);
+  private:
+  double _internal_max() const;
+  void _internal_set_max(double value);
+  public:
+
+  // double num = 3;
+  void clear_num();
+  double num() const;
+  void set_num(double value);
+  private:
+  double _internal_num() const;
+  void _internal_set_num(double value);
+  public:
+
+  // double sum = 4;
+  void clear_sum();
+  double sum() const;
+  void set_sum(double value);
+  private:
+  double _internal_sum() const;
+  void _internal_set_sum(double value);
+  public:
+
+  // double sum_squares = 5;
+  void clear_sum_squares();
+  double sum_squares() const;
+  void set_sum_squares(double value);
+  private:
+  double _internal_sum_squares() const;
+  void _internal_set_sum_squares(double value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.HistogramProto)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< double > bucket_limit_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< double > bucket_;
+    double min_;
+    double max_;
+    double num_;
+    double sum_;
+    double sum_squares_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class Summary_Image final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.Summary.Image) */ {
+ public:
+  inline Summary_Image() : Summary_Image(nullptr) {}
+  ~Summary_Image() override;
+  explicit PROTOBUF_CONSTEXPR Summary_Image(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  Summary_Image(const Summary_Image& from);
+  Summary_Image(Summary_Image&& from) noexcept
+    : Summary_Image() {
+    *this = ::std::move(from);
+  }
+
+  inline Summary_Image& operator=(const Summary_Image& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline Summary_Image& operator=(Summary_Image&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Summary_Image& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const Summary_Image* internal_default_instance() {
+    return reinterpret_cast<const Summary_Image*>(
+               &_Summary_Image_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    6;
+
+  friend void swap(Summary_Image& a, Summary_Image& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(Summary_Image* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Summary_Image* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  Summary_Image* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<Summary_Image>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const Summary_Image& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Summary_Image& from) {
+    Summary_Image::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(Summary_Image* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.Summary.Image";
+  }
+  protected:
+  explicit Summary_Image(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kEncodedImageStringFieldNumber = 4,
+    kHeightFieldNumber = 1,
+    kWidthFieldNumber = 2,
+    kColorspaceFieldNumber = 3,
+  };
+  // bytes encoded_image_string = 4;
+  void clear_encoded_image_string();
+  const std::string& encoded_image_string() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_encoded_image_string(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_encoded_image_string();
+  PROTOBUF_NODISCARD std::string* release_encoded_image_string();
+  void set_allocated_encoded_image_string(std::string* encoded_image_string);
+  private:
+  const std::string& _internal_encoded_image_string() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_encoded_image_string(const std::string& value);
+  std::string* _internal_mutable_encoded_image_string();
+  public:
+
+  // int32 height = 1;
+  void clear_height();
+  int32_t height() const;
+  void set_height(int32_t value);
+  private:
+  int32_t _internal_height() const;
+  void _internal_set_height(int32_t value);
+  public:
+
+  // int32 width = 2;
+  void clear_width();
+  int32_t width() const;
+  void set_width(int32_t value);
+  private:
+  int32_t _internal_width() const;
+  void _internal_set_width(int32_t value);
+  public:
+
+  // int32 colorspace = 3;
+  void clear_colorspace();
+  int32_t colorspace() const;
+  void set_colorspace(int32_t value);
+  private:
+  int32_t _internal_colorspace() const;
+  void _internal_set_colorspace(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.Summary.Image)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr encoded_image_string_;
+    int32_t height_;
+    int32_t width_;
+    int32_t colorspace_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class Summary_Audio final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.Summary.Audio) */ {
+ public:
+  inline Summary_Audio() : Summary_Audio(nullptr) {}
+  ~Summary_Audio() override;
+  explicit PROTOBUF_CONSTEXPR Summary_Audio(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  Summary_Audio(const Summary_Audio& from);
+  Summary_Audio(Summary_Audio&& from) noexcept
+    : Summary_Audio() {
+    *this = ::std::move(from);
+  }
+
+  inline Summary_Audio& operator=(const Summary_Audio& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline Summary_Audio& operator=(Summary_Audio&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Summary_Audio& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const Summary_Audio* internal_default_instance() {
+    return reinterpret_cast<const Summary_Audio*>(
+               &_Summary_Audio_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    7;
+
+  friend void swap(Summary_Audio& a, Summary_Audio& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(Summary_Audio* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Summary_Audio* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  Summary_Audio* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<Summary_Audio>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const Summary_Audio& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Summary_Audio& from) {
+    Summary_Audio::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(Summary_Audio* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.Summary.Audio";
+  }
+  protected:
+  explicit Summary_Audio(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kEncodedAudioStringFieldNumber = 4,
+    kContentTypeFieldNumber = 5,
+    kNumChannelsFieldNumber = 2,
+    kLengthFramesFieldNumber = 3,
+    kSampleRateFieldNumber = 1,
+  };
+  // bytes encoded_audio_string = 4;
+  void clear_encoded_audio_string();
+  const std::string& encoded_audio_string() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_encoded_audio_string(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_encoded_audio_string();
+  PROTOBUF_NODISCARD std::string* release_encoded_audio_string();
+  void set_allocated_encoded_audio_string(std::string* encoded_audio_string);
+  private:
+  const std::string& _internal_encoded_audio_string() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_encoded_audio_string(const std::string& value);
+  std::string* _internal_mutable_encoded_audio_string();
+  public:
+
+  // string content_type = 5;
+  void clear_content_type();
+  const std::string& content_type() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_content_type(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_content_type();
+  PROTOBUF_NODISCARD std::string* release_content_type();
+  void set_allocated_content_type(std::string* content_type);
+  private:
+  const std::string& _internal_content_type() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_content_type(const std::string& value);
+  std::string* _internal_mutable_content_type();
+  public:
+
+  // int64 num_channels = 2;
+  void clear_num_channels();
+  int64_t num_channels() const;
+  void set_num_channels(int64_t value);
+  private:
+  int64_t _internal_num_channels() const;
+  void _internal_set_num_channels(int64_t value);
+  public:
+
+  // int64 length_frames = 3;
+  void clear_length_frames();
+  int64_t length_frames() const;
+  void set_length_frames(int64_t value);
+  private:
+  int64_t _internal_length_frames() const;
+  void _internal_set_length_frames(int64_t value);
+  public:
+
+  // float sample_rate = 1;
+  void clear_sample_rate();
+  float sample_rate() const;
+  void set_sample_rate(float value);
+  private:
+  float _internal_sample_rate() const;
+  void _internal_set_sample_rate(float value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.Summary.Audio)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr encoded_audio_string_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr content_type_;
+    int64_t num_channels_;
+    int64_t length_frames_;
+    float sample_rate_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class Summary_Value final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.Summary.Value) */ {
+ public:
+  inline Summary_Value() : Summary_Value(nullptr) {}
+  ~Summary_Value() override;
+  explicit PROTOBUF_CONSTEXPR Summary_Value(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  Summary_Value(const Summary_Value& from);
+  Summary_Value(Summary_Value&& from) noexcept
+    : Summary_Value() {
+    *this = ::std::move(from);
+  }
+
+  inline Summary_Value& operator=(const Summary_Value& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline Summary_Value& operator=(Summary_Value&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Summary_Value& default_instance() {
+    return *internal_default_instance();
+  }
+  enum ValueCase {
+    kSimpleValue = 2,
+    kObsoleteOldStyleHistogram = 3,
+    kImage = 4,
+    kHisto = 5,
+    kAudio = 6,
+    kTensor = 8,
+    VALUE_NOT_SET = 0,
+  };
+
+  static inline const Summary_Value* internal_default_instance() {
+    return reinterpret_cast<const Summary_Value*>(
+               &_Summary_Value_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    8;
+
+  friend void swap(Summary_Value& a, Summary_Value& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(Summary_Value* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Summary_Value* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  Summary_Value* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<Summary_Value>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const Summary_Value& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Summary_Value& from) {
+    Summary_Value::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(Summary_Value* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.Summary.Value";
+  }
+  protected:
+  explicit Summary_Value(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kTagFieldNumber = 1,
+    kNodeNameFieldNumber = 7,
+    kSimpleValueFieldNumber = 2,
+    kObsoleteOldStyleHistogramFieldNumber = 3,
+    kImageFieldNumber = 4,
+    kHistoFieldNumber = 5,
+    kAudioFieldNumber = 6,
+    kTensorFieldNumber = 8,
+  };
+  // string tag = 1;
+  void clear_tag();
+  const std::string& tag() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_tag(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_tag();
+  PROTOBUF_NODISCARD std::string* release_tag();
+  void set_allocated_tag(std::string* tag);
+  private:
+  const std::string& _internal_tag() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_tag(const std::string& value);
+  std::string* _internal_mutable_tag();
+  public:
+
+  // string node_name = 7;
+  void clear_node_name();
+  const std::string& node_name() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_node_name(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_node_name();
+  PROTOBUF_NODISCARD std::string* release_node_name();
+  void set_allocated_node_name(std::string* node_name);
+  private:
+  const std::string& _internal_node_name() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_node_name(const std::string& value);
+  std::string* _internal_mutable_node_name();
+  public:
+
+  // float simple_value = 2;
+  bool has_simple_value() const;
+  private:
+  bool _internal_has_simple_value() const;
+  public:
+  void clear_simple_value();
+  float simple_value() const;
+  void set_simple_value(float value);
+  private:
+  float _internal_simple_value() const;
+  void _internal_set_simple_value(float value);
+  public:
+
+  // bytes obsolete_old_style_histogram = 3;
+  bool has_obsolete_old_style_histogram() const;
+  private:
+  bool _internal_has_obsolete_old_style_histogram() const;
+  public:
+  void clear_obsolete_old_style_histogram();
+  const std::string& obsolete_old_style_histogram() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_obsolete_old_style_histogram(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_obsolete_old_style_histogram();
+  PROTOBUF_NODISCARD std::string* release_obsolete_old_style_histogram();
+  void set_allocated_obsolete_old_style_histogram(std::string* obsolete_old_style_histogram);
+  private:
+  const std::string& _internal_obsolete_old_style_histogram() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_obsolete_old_style_histogram(const std::string& value);
+  std::string* _internal_mutable_obsolete_old_style_histogram();
+  public:
+
+  // .tensorflow.Summary.Image image = 4;
+  bool has_image() const;
+  private:
+  bool _internal_has_image() const;
+  public:
+  void clear_image();
+  const ::tensorflow::Summary_Image& image() const;
+  PROTOBUF_NODISCARD ::tensorflow::Summary_Image* release_image();
+  ::tensorflow::Summary_Image* mutable_image();
+  void set_allocated_image(::tensorflow::Summary_Image* image);
+  private:
+  const ::tensorflow::Summary_Image& _internal_image() const;
+  ::tensorflow::Summary_Image* _internal_mutable_image();
+  public:
+  void unsafe_arena_set_allocated_image(
+      ::tensorflow::Summary_Image* image);
+  ::tensorflow::Summary_Image* unsafe_arena_release_image();
+
+  // .tensorflow.HistogramProto histo = 5;
+  bool has_histo() const;
+  private:
+  bool _internal_has_histo() const;
+  public:
+  void clear_histo();
+  const ::tensorflow::HistogramProto& histo() const;
+  PROTOBUF_NODISCARD ::tensorflow::HistogramProto* release_histo();
+  ::tensorflow::HistogramProto* mutable_histo();
+  void set_allocated_histo(::tensorflow::HistogramProto* histo);
+  private:
+  const ::tensorflow::HistogramProto& _internal_histo() const;
+  ::tensorflow::HistogramProto* _internal_mutable_histo();
+  public:
+  void unsafe_arena_set_allocated_histo(
+      ::tensorflow::HistogramProto* histo);
+  ::tensorflow::HistogramProto* unsafe_arena_release_histo();
+
+  // .tensorflow.Summary.Audio audio = 6;
+  bool has_audio() const;
+  private:
+  bool _internal_has_audio() const;
+  public:
+  void clear_audio();
+  const ::tensorflow::Summary_Audio& audio() const;
+  PROTOBUF_NODISCARD ::tensorflow::Summary_Audio* release_audio();
+  ::tensorflow::Summary_Audio* mutable_audio();
+  void set_allocated_audio(::tensorflow::Summary_Audio* audio);
+  private:
+  const ::tensorflow::Summary_Audio& _internal_audio() const;
+  ::tensorflow::Summary_Audio* _internal_mutable_audio();
+  public:
+  void unsafe_arena_set_allocated_audio(
+      ::tensorflow::Summary_Audio* audio);
+  ::tensorflow::Summary_Audio* unsafe_arena_release_audio();
+
+  // .tensorflow.TensorProto tensor = 8;
+  bool has_tensor() const;
+  private:
+  bool _internal_has_tensor() const;
+  public:
+  void clear_tensor();
+  const ::tensorflow::TensorProto& tensor() const;
+  PROTOBUF_NODISCARD ::tensorflow::TensorProto* release_tensor();
+  ::tensorflow::TensorProto* mutable_tensor();
+  void set_allocated_tensor(::tensorflow::TensorProto* tensor);
+  private:
+  const ::tensorflow::TensorProto& _internal_tensor() const;
+  ::tensorflow::TensorProto* _internal_mutable_tensor();
+  public:
+  void unsafe_arena_set_allocated_tensor(
+      ::tensorflow::TensorProto* tensor);
+  ::tensorflow::TensorProto* unsafe_arena_release_tensor();
+
+  void clear_value();
+  ValueCase value_case() const;
+  // @@protoc_insertion_point(class_scope:tensorflow.Summary.Value)
+ private:
+  class _Internal;
+  void set_has_simple_value();
+  void set_has_obsolete_old_style_histogram();
+  void set_has_image();
+  void set_has_histo();
+  void set_has_audio();
+  void set_has_tensor();
+
+  inline bool has_value() const;
+  inline void clear_has_value();
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr tag_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr node_name_;
+    union ValueUnion {
+      constexpr ValueUnion() : _constinit_{} {}
+        ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized _constinit_;
+      float simple_value_;
+      ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr obsolete_old_style_histogram_;
+      ::tensorflow::Summary_Image* image_;
+      ::tensorflow::HistogramProto* histo_;
+      ::tensorflow::Summary_Audio* audio_;
+      ::tensorflow::TensorProto* tensor_;
+    } value_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    uint32_t _oneof_case_[1];
+
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class Summary final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.Summary) */ {
+ public:
+  inline Summary() : Summary(nullptr) {}
+  ~Summary() override;
+  explicit PROTOBUF_CONSTEXPR Summary(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  Summary(const Summary& from);
+  Summary(Summary&& from) noexcept
+    : Summary() {
+    *this = ::std::move(from);
+  }
+
+  inline Summary& operator=(const Summary& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline Summary& operator=(Summary&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Summary& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const Summary* internal_default_instance() {
+    return reinterpret_cast<const Summary*>(
+               &_Summary_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    9;
+
+  friend void swap(Summary& a, Summary& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(Summary* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Summary* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  Summary* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<Summary>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const Summary& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Summary& from) {
+    Summary::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(Summary* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.Summary";
+  }
+  protected:
+  explicit Summary(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef Summary_Image Image;
+  typedef Summary_Audio Audio;
+  typedef Summary_Value Value;
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kValueFieldNumber = 1,
+  };
+  // repeated .tensorflow.Summary.Value value = 1;
+  int value_size() const;
+  private:
+  int _internal_value_size() const;
+  public:
+  void clear_value();
+  ::tensorflow::Summary_Value* mutable_value(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::Summary_Value >*
+      mutable_value();
+  private:
+  const ::tensorflow::Summary_Value& _internal_value(int index) const;
+  ::tensorflow::Summary_Value* _internal_add_value();
+  public:
+  const ::tensorflow::Summary_Value& value(int index) const;
+  ::tensorflow::Summary_Value* add_value();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::Summary_Value >&
+      value() const;
+
+  // @@protoc_insertion_point(class_scope:tensorflow.Summary)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::Summary_Value > value_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class AttrValue_ListValue final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.AttrValue.ListValue) */ {
+ public:
+  inline AttrValue_ListValue() : AttrValue_ListValue(nullptr) {}
+  ~AttrValue_ListValue() override;
+  explicit PROTOBUF_CONSTEXPR AttrValue_ListValue(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  AttrValue_ListValue(const AttrValue_ListValue& from);
+  AttrValue_ListValue(AttrValue_ListValue&& from) noexcept
+    : AttrValue_ListValue() {
+    *this = ::std::move(from);
+  }
+
+  inline AttrValue_ListValue& operator=(const AttrValue_ListValue& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline AttrValue_ListValue& operator=(AttrValue_ListValue&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const AttrValue_ListValue& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const AttrValue_ListValue* internal_default_instance() {
+    return reinterpret_cast<const AttrValue_ListValue*>(
+               &_AttrValue_ListValue_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    10;
+
+  friend void swap(AttrValue_ListValue& a, AttrValue_ListValue& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(AttrValue_ListValue* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(AttrValue_ListValue* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  AttrValue_ListValue* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<AttrValue_ListValue>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const AttrValue_ListValue& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const AttrValue_ListValue& from) {
+    AttrValue_ListValue::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(AttrValue_ListValue* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.AttrValue.ListValue";
+  }
+  protected:
+  explicit AttrValue_ListValue(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kSFieldNumber = 2,
+    kIFieldNumber = 3,
+    kFFieldNumber = 4,
+    kBFieldNumber = 5,
+    kTypeFieldNumber = 6,
+    kShapeFieldNumber = 7,
+    kTensorFieldNumber = 8,
+  };
+  // repeated bytes s = 2;
+  int s_size() const;
+  private:
+  int _internal_s_size() const;
+  public:
+  void clear_s();
+  const std::string& s(int index) const;
+  std::string* mutable_s(int index);
+  void set_s(int index, const std::string& value);
+  void set_s(int index, std::string&& value);
+  void set_s(int index, const char* value);
+  void set_s(int index, const void* value, size_t size);
+  std::string* add_s();
+  void add_s(const std::string& value);
+  void add_s(std::string&& value);
+  void add_s(const char* value);
+  void add_s(const void* value, size_t size);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>& s() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>* mutable_s();
+  private:
+  const std::string& _internal_s(int index) const;
+  std::string* _internal_add_s();
+  public:
+
+  // repeated int64 i = 3 [packed = true];
+  int i_size() const;
+  private:
+  int _internal_i_size() const;
+  public:
+  void clear_i();
+  private:
+  int64_t _internal_i(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+      _internal_i() const;
+  void _internal_add_i(int64_t value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+      _internal_mutable_i();
+  public:
+  int64_t i(int index) const;
+  void set_i(int index, int64_t value);
+  void add_i(int64_t value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+      i() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+      mutable_i();
+
+  // repeated float f = 4 [packed = true];
+  int f_size() const;
+  private:
+  int _internal_f_size() const;
+  public:
+  void clear_f();
+  private:
+  float _internal_f(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+      _internal_f() const;
+  void _internal_add_f(float value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+      _internal_mutable_f();
+  public:
+  float f(int index) const;
+  void set_f(int index, float value);
+  void add_f(float value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+      f() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+      mutable_f();
+
+  // repeated bool b = 5 [packed = true];
+  int b_size() const;
+  private:
+  int _internal_b_size() const;
+  public:
+  void clear_b();
+  private:
+  bool _internal_b(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+      _internal_b() const;
+  void _internal_add_b(bool value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+      _internal_mutable_b();
+  public:
+  bool b(int index) const;
+  void set_b(int index, bool value);
+  void add_b(bool value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+      b() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+      mutable_b();
+
+  // repeated .tensorflow.DataType type = 6 [packed = true];
+  int type_size() const;
+  private:
+  int _internal_type_size() const;
+  public:
+  void clear_type();
+  private:
+  ::tensorflow::DataType _internal_type(int index) const;
+  void _internal_add_type(::tensorflow::DataType value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField<int>* _internal_mutable_type();
+  public:
+  ::tensorflow::DataType type(int index) const;
+  void set_type(int index, ::tensorflow::DataType value);
+  void add_type(::tensorflow::DataType value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField<int>& type() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField<int>* mutable_type();
+
+  // repeated .tensorflow.TensorShapeProto shape = 7;
+  int shape_size() const;
+  private:
+  int _internal_shape_size() const;
+  public:
+  void clear_shape();
+  ::tensorflow::TensorShapeProto* mutable_shape(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto >*
+      mutable_shape();
+  private:
+  const ::tensorflow::TensorShapeProto& _internal_shape(int index) const;
+  ::tensorflow::TensorShapeProto* _internal_add_shape();
+  public:
+  const ::tensorflow::TensorShapeProto& shape(int index) const;
+  ::tensorflow::TensorShapeProto* add_shape();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto >&
+      shape() const;
+
+  // repeated .tensorflow.TensorProto tensor = 8;
+  int tensor_size() const;
+  private:
+  int _internal_tensor_size() const;
+  public:
+  void clear_tensor();
+  ::tensorflow::TensorProto* mutable_tensor(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorProto >*
+      mutable_tensor();
+  private:
+  const ::tensorflow::TensorProto& _internal_tensor(int index) const;
+  ::tensorflow::TensorProto* _internal_add_tensor();
+  public:
+  const ::tensorflow::TensorProto& tensor(int index) const;
+  ::tensorflow::TensorProto* add_tensor();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorProto >&
+      tensor() const;
+
+  // @@protoc_insertion_point(class_scope:tensorflow.AttrValue.ListValue)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string> s_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t > i_;
+    mutable std::atomic<int> _i_cached_byte_size_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< float > f_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool > b_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField<int> type_;
+    mutable std::atomic<int> _type_cached_byte_size_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto > shape_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorProto > tensor_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class AttrValue final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.AttrValue) */ {
+ public:
+  inline AttrValue() : AttrValue(nullptr) {}
+  ~AttrValue() override;
+  explicit PROTOBUF_CONSTEXPR AttrValue(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  AttrValue(const AttrValue& from);
+  AttrValue(AttrValue&& from) noexcept
+    : AttrValue() {
+    *this = ::std::move(from);
+  }
+
+  inline AttrValue& operator=(const AttrValue& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline AttrValue& operator=(AttrValue&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const AttrValue& default_instance() {
+    return *internal_default_instance();
+  }
+  enum ValueCase {
+    kS = 2,
+    kI = 3,
+    kF = 4,
+    kB = 5,
+    kType = 6,
+    kShape = 7,
+    kTensor = 8,
+    kList = 1,
+    kFunc = 10,
+    kPlaceholder = 9,
+    VALUE_NOT_SET = 0,
+  };
+
+  static inline const AttrValue* internal_default_instance() {
+    return reinterpret_cast<const AttrValue*>(
+               &_AttrValue_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    11;
+
+  friend void swap(AttrValue& a, AttrValue& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(AttrValue* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(AttrValue* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  AttrValue* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<AttrValue>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const AttrValue& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const AttrValue& from) {
+    AttrValue::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(AttrValue* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.AttrValue";
+  }
+  protected:
+  explicit AttrValue(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef AttrValue_ListValue ListValue;
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kSFieldNumber = 2,
+    kIFieldNumber = 3,
+    kFFieldNumber = 4,
+    kBFieldNumber = 5,
+    kTypeFieldNumber = 6,
+    kShapeFieldNumber = 7,
+    kTensorFieldNumber = 8,
+    kListFieldNumber = 1,
+    kFuncFieldNumber = 10,
+    kPlaceholderFieldNumber = 9,
+  };
+  // bytes s = 2;
+  bool has_s() const;
+  private:
+  bool _internal_has_s() const;
+  public:
+  void clear_s();
+  const std::string& s() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_s(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_s();
+  PROTOBUF_NODISCARD std::string* release_s();
+  void set_allocated_s(std::string* s);
+  private:
+  const std::string& _internal_s() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_s(const std::string& value);
+  std::string* _internal_mutable_s();
+  public:
+
+  // int64 i = 3;
+  bool has_i() const;
+  private:
+  bool _internal_has_i() const;
+  public:
+  void clear_i();
+  int64_t i() const;
+  void set_i(int64_t value);
+  private:
+  int64_t _internal_i() const;
+  void _internal_set_i(int64_t value);
+  public:
+
+  // float f = 4;
+  bool has_f() const;
+  private:
+  bool _internal_has_f() const;
+  public:
+  void clear_f();
+  float f() const;
+  void set_f(float value);
+  private:
+  float _internal_f() const;
+  void _internal_set_f(float value);
+  public:
+
+  // bool b = 5;
+  bool has_b() const;
+  private:
+  bool _internal_has_b() const;
+  public:
+  void clear_b();
+  bool b() const;
+  void set_b(bool value);
+  private:
+  bool _internal_b() const;
+  void _internal_set_b(bool value);
+  public:
+
+  // .tensorflow.DataType type = 6;
+  bool has_type() const;
+  private:
+  bool _internal_has_type() const;
+  public:
+  void clear_type();
+  ::tensorflow::DataType type() const;
+  void set_type(::tensorflow::DataType value);
+  private:
+  ::tensorflow::DataType _internal_type() const;
+  void _internal_set_type(::tensorflow::DataType value);
+  public:
+
+  // .tensorflow.TensorShapeProto shape = 7;
+  bool has_shape() const;
+  private:
+  bool _internal_has_shape() const;
+  public:
+  void clear_shape();
+  const ::tensorflow::TensorShapeProto& shape() const;
+  PROTOBUF_NODISCARD ::tensorflow::TensorShapeProto* release_shape();
+  ::tensorflow::TensorShapeProto* mutable_shape();
+  void set_allocated_shape(::tensorflow::TensorShapeProto* shape);
+  private:
+  const ::tensorflow::TensorShapeProto& _internal_shape() const;
+  ::tensorflow::TensorShapeProto* _internal_mutable_shape();
+  public:
+  void unsafe_arena_set_allocated_shape(
+      ::tensorflow::TensorShapeProto* shape);
+  ::tensorflow::TensorShapeProto* unsafe_arena_release_shape();
+
+  // .tensorflow.TensorProto tensor = 8;
+  bool has_tensor() const;
+  private:
+  bool _internal_has_tensor() const;
+  public:
+  void clear_tensor();
+  const ::tensorflow::TensorProto& tensor() const;
+  PROTOBUF_NODISCARD ::tensorflow::TensorProto* release_tensor();
+  ::tensorflow::TensorProto* mutable_tensor();
+  void set_allocated_tensor(::tensorflow::TensorProto* tensor);
+  private:
+  const ::tensorflow::TensorProto& _internal_tensor() const;
+  ::tensorflow::TensorProto* _internal_mutable_tensor();
+  public:
+  void unsafe_arena_set_allocated_tensor(
+      ::tensorflow::TensorProto* tensor);
+  ::tensorflow::TensorProto* unsafe_arena_release_tensor();
+
+  // .tensorflow.AttrValue.ListValue list = 1;
+  bool has_list() const;
+  private:
+  bool _internal_has_list() const;
+  public:
+  void clear_list();
+  const ::tensorflow::AttrValue_ListValue& list() const;
+  PROTOBUF_NODISCARD ::tensorflow::AttrValue_ListValue* release_list();
+  ::tensorflow::AttrValue_ListValue* mutable_list();
+  void set_allocated_list(::tensorflow::AttrValue_ListValue* list);
+  private:
+  const ::tensorflow::AttrValue_ListValue& _internal_list() const;
+  ::tensorflow::AttrValue_ListValue* _internal_mutable_list();
+  public:
+  void unsafe_arena_set_allocated_list(
+      ::tensorflow::AttrValue_ListValue* list);
+  ::tensorflow::AttrValue_ListValue* unsafe_arena_release_list();
+
+  // .tensorflow.NameAttrList func = 10;
+  bool has_func() const;
+  private:
+  bool _internal_has_func() const;
+  public:
+  void clear_func();
+  const ::tensorflow::NameAttrList& func() const;
+  PROTOBUF_NODISCARD ::tensorflow::NameAttrList* release_func();
+  ::tensorflow::NameAttrList* mutable_func();
+  void set_allocated_func(::tensorflow::NameAttrList* func);
+  private:
+  const ::tensorflow::NameAttrList& _internal_func() const;
+  ::tensorflow::NameAttrList* _internal_mutable_func();
+  public:
+  void unsafe_arena_set_allocated_func(
+      ::tensorflow::NameAttrList* func);
+  ::tensorflow::NameAttrList* unsafe_arena_release_func();
+
+  // string placeholder = 9;
+  bool has_placeholder() const;
+  private:
+  bool _internal_has_placeholder() const;
+  public:
+  void clear_placeholder();
+  const std::string& placeholder() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_placeholder(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_placeholder();
+  PROTOBUF_NODISCARD std::string* release_placeholder();
+  void set_allocated_placeholder(std::string* placeholder);
+  private:
+  const std::string& _internal_placeholder() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_placeholder(const std::string& value);
+  std::string* _internal_mutable_placeholder();
+  public:
+
+  void clear_value();
+  ValueCase value_case() const;
+  // @@protoc_insertion_point(class_scope:tensorflow.AttrValue)
+ private:
+  class _Internal;
+  void set_has_s();
+  void set_has_i();
+  void set_has_f();
+  void set_has_b();
+  void set_has_type();
+  void set_has_shape();
+  void set_has_tensor();
+  void set_has_list();
+  void set_has_func();
+  void set_has_placeholder();
+
+  inline bool has_value() const;
+  inline void clear_has_value();
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    union ValueUnion {
+      constexpr ValueUnion() : _constinit_{} {}
+        ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized _constinit_;
+      ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr s_;
+      int64_t i_;
+      float f_;
+      bool b_;
+      int type_;
+      ::tensorflow::TensorShapeProto* shape_;
+      ::tensorflow::TensorProto* tensor_;
+      ::tensorflow::AttrValue_ListValue* list_;
+      ::tensorflow::NameAttrList* func_;
+      ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr placeholder_;
+    } value_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    uint32_t _oneof_case_[1];
+
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class NameAttrList_AttrEntry_DoNotUse : public ::PROTOBUF_NAMESPACE_ID::internal::MapEntry<NameAttrList_AttrEntry_DoNotUse, 
+    std::string, ::tensorflow::AttrValue,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_STRING,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_MESSAGE> {
+public:
+  typedef ::PROTOBUF_NAMESPACE_ID::internal::MapEntry<NameAttrList_AttrEntry_DoNotUse, 
+    std::string, ::tensorflow::AttrValue,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_STRING,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_MESSAGE> SuperType;
+  NameAttrList_AttrEntry_DoNotUse();
+  explicit PROTOBUF_CONSTEXPR NameAttrList_AttrEntry_DoNotUse(
+      ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+  explicit NameAttrList_AttrEntry_DoNotUse(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  void MergeFrom(const NameAttrList_AttrEntry_DoNotUse& other);
+  static const NameAttrList_AttrEntry_DoNotUse* internal_default_instance() { return reinterpret_cast<const NameAttrList_AttrEntry_DoNotUse*>(&_NameAttrList_AttrEntry_DoNotUse_default_instance_); }
+  static bool ValidateKey(std::string* s) {
+    return ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(s->data(), static_cast<int>(s->size()), ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::PARSE, "tensorflow.NameAttrList.AttrEntry.key");
+ }
+  static bool ValidateValue(void*) { return true; }
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+
+// -------------------------------------------------------------------
+
+class NameAttrList final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.NameAttrList) */ {
+ public:
+  inline NameAttrList() : NameAttrList(nullptr) {}
+  ~NameAttrList() override;
+  explicit PROTOBUF_CONSTEXPR NameAttrList(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  NameAttrList(const NameAttrList& from);
+  NameAttrList(NameAttrList&& from) noexcept
+    : NameAttrList() {
+    *this = ::std::move(from);
+  }
+
+  inline NameAttrList& operator=(const NameAttrList& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline NameAttrList& operator=(NameAttrList&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const NameAttrList& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const NameAttrList* internal_default_instance() {
+    return reinterpret_cast<const NameAttrList*>(
+               &_NameAttrList_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    13;
+
+  friend void swap(NameAttrList& a, NameAttrList& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(NameAttrList* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(NameAttrList* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  NameAttrList* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<NameAttrList>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const NameAttrList& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const NameAttrList& from) {
+    NameAttrList::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(NameAttrList* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.NameAttrList";
+  }
+  protected:
+  explicit NameAttrList(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kAttrFieldNumber = 2,
+    kNameFieldNumber = 1,
+  };
+  // map<string, .tensorflow.AttrValue> attr = 2;
+  int attr_size() const;
+  private:
+  int _internal_attr_size() const;
+  public:
+  void clear_attr();
+  private:
+  const ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >&
+      _internal_attr() const;
+  ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >*
+      _internal_mutable_attr();
+  public:
+  const ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >&
+      attr() const;
+  ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >*
+      mutable_attr();
+
+  // string name = 1;
+  void clear_name();
+  const std::string& name() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_name(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_name();
+  PROTOBUF_NODISCARD std::string* release_name();
+  void set_allocated_name(std::string* name);
+  private:
+  const std::string& _internal_name() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_name(const std::string& value);
+  std::string* _internal_mutable_name();
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.NameAttrList)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::MapField<
+        NameAttrList_AttrEntry_DoNotUse,
+        std::string, ::tensorflow::AttrValue,
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_STRING,
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_MESSAGE> attr_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr name_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class NodeDef_AttrEntry_DoNotUse : public ::PROTOBUF_NAMESPACE_ID::internal::MapEntry<NodeDef_AttrEntry_DoNotUse, 
+    std::string, ::tensorflow::AttrValue,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_STRING,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_MESSAGE> {
+public:
+  typedef ::PROTOBUF_NAMESPACE_ID::internal::MapEntry<NodeDef_AttrEntry_DoNotUse, 
+    std::string, ::tensorflow::AttrValue,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_STRING,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_MESSAGE> SuperType;
+  NodeDef_AttrEntry_DoNotUse();
+  explicit PROTOBUF_CONSTEXPR NodeDef_AttrEntry_DoNotUse(
+      ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+  explicit NodeDef_AttrEntry_DoNotUse(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  void MergeFrom(const NodeDef_AttrEntry_DoNotUse& other);
+  static const NodeDef_AttrEntry_DoNotUse* internal_default_instance() { return reinterpret_cast<const NodeDef_AttrEntry_DoNotUse*>(&_NodeDef_AttrEntry_DoNotUse_default_instance_); }
+  static bool ValidateKey(std::string* s) {
+    return ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(s->data(), static_cast<int>(s->size()), ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::PARSE, "tensorflow.NodeDef.AttrEntry.key");
+ }
+  static bool ValidateValue(void*) { return true; }
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+
+// -------------------------------------------------------------------
+
+class NodeDef final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.NodeDef) */ {
+ public:
+  inline NodeDef() : NodeDef(nullptr) {}
+  ~NodeDef() override;
+  explicit PROTOBUF_CONSTEXPR NodeDef(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  NodeDef(const NodeDef& from);
+  NodeDef(NodeDef&& from) noexcept
+    : NodeDef() {
+    *this = ::std::move(from);
+  }
+
+  inline NodeDef& operator=(const NodeDef& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline NodeDef& operator=(NodeDef&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const NodeDef& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const NodeDef* internal_default_instance() {
+    return reinterpret_cast<const NodeDef*>(
+               &_NodeDef_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    15;
+
+  friend void swap(NodeDef& a, NodeDef& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(NodeDef* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(NodeDef* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  NodeDef* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<NodeDef>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const NodeDef& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const NodeDef& from) {
+    NodeDef::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(NodeDef* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.NodeDef";
+  }
+  protected:
+  explicit NodeDef(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kInputFieldNumber = 3,
+    kAttrFieldNumber = 5,
+    kNameFieldNumber = 1,
+    kOpFieldNumber = 2,
+    kDeviceFieldNumber = 4,
+  };
+  // repeated string input = 3;
+  int input_size() const;
+  private:
+  int _internal_input_size() const;
+  public:
+  void clear_input();
+  const std::string& input(int index) const;
+  std::string* mutable_input(int index);
+  void set_input(int index, const std::string& value);
+  void set_input(int index, std::string&& value);
+  void set_input(int index, const char* value);
+  void set_input(int index, const char* value, size_t size);
+  std::string* add_input();
+  void add_input(const std::string& value);
+  void add_input(std::string&& value);
+  void add_input(const char* value);
+  void add_input(const char* value, size_t size);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>& input() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>* mutable_input();
+  private:
+  const std::string& _internal_input(int index) const;
+  std::string* _internal_add_input();
+  public:
+
+  // map<string, .tensorflow.AttrValue> attr = 5;
+  int attr_size() const;
+  private:
+  int _internal_attr_size() const;
+  public:
+  void clear_attr();
+  private:
+  const ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >&
+      _internal_attr() const;
+  ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >*
+      _internal_mutable_attr();
+  public:
+  const ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >&
+      attr() const;
+  ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >*
+      mutable_attr();
+
+  // string name = 1;
+  void clear_name();
+  const std::string& name() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_name(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_name();
+  PROTOBUF_NODISCARD std::string* release_name();
+  void set_allocated_name(std::string* name);
+  private:
+  const std::string& _internal_name() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_name(const std::string& value);
+  std::string* _internal_mutable_name();
+  public:
+
+  // string op = 2;
+  void clear_op();
+  const std::string& op() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_op(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_op();
+  PROTOBUF_NODISCARD std::string* release_op();
+  void set_allocated_op(std::string* op);
+  private:
+  const std::string& _internal_op() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_op(const std::string& value);
+  std::string* _internal_mutable_op();
+  public:
+
+  // string device = 4;
+  void clear_device();
+  const std::string& device() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_device(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_device();
+  PROTOBUF_NODISCARD std::string* release_device();
+  void set_allocated_device(std::string* device);
+  private:
+  const std::string& _internal_device() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_device(const std::string& value);
+  std::string* _internal_mutable_device();
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.NodeDef)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string> input_;
+    ::PROTOBUF_NAMESPACE_ID::internal::MapField<
+        NodeDef_AttrEntry_DoNotUse,
+        std::string, ::tensorflow::AttrValue,
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_STRING,
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::TYPE_MESSAGE> attr_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr name_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr op_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr device_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class GraphDef final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.GraphDef) */ {
+ public:
+  inline GraphDef() : GraphDef(nullptr) {}
+  ~GraphDef() override;
+  explicit PROTOBUF_CONSTEXPR GraphDef(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  GraphDef(const GraphDef& from);
+  GraphDef(GraphDef&& from) noexcept
+    : GraphDef() {
+    *this = ::std::move(from);
+  }
+
+  inline GraphDef& operator=(const GraphDef& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline GraphDef& operator=(GraphDef&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const GraphDef& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const GraphDef* internal_default_instance() {
+    return reinterpret_cast<const GraphDef*>(
+               &_GraphDef_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    16;
+
+  friend void swap(GraphDef& a, GraphDef& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(GraphDef* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(GraphDef* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  GraphDef* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<GraphDef>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const GraphDef& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const GraphDef& from) {
+    GraphDef::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(GraphDef* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.GraphDef";
+  }
+  protected:
+  explicit GraphDef(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kNodeFieldNumber = 1,
+    kVersionsFieldNumber = 4,
+    kVersionFieldNumber = 3,
+  };
+  // repeated .tensorflow.NodeDef node = 1;
+  int node_size() const;
+  private:
+  int _internal_node_size() const;
+  public:
+  void clear_node();
+  ::tensorflow::NodeDef* mutable_node(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::NodeDef >*
+      mutable_node();
+  private:
+  const ::tensorflow::NodeDef& _internal_node(int index) const;
+  ::tensorflow::NodeDef* _internal_add_node();
+  public:
+  const ::tensorflow::NodeDef& node(int index) const;
+  ::tensorflow::NodeDef* add_node();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::NodeDef >&
+      node() const;
+
+  // .tensorflow.VersionDef versions = 4;
+  bool has_versions() const;
+  private:
+  bool _internal_has_versions() const;
+  public:
+  void clear_versions();
+  const ::tensorflow::VersionDef& versions() const;
+  PROTOBUF_NODISCARD ::tensorflow::VersionDef* release_versions();
+  ::tensorflow::VersionDef* mutable_versions();
+  void set_allocated_versions(::tensorflow::VersionDef* versions);
+  private:
+  const ::tensorflow::VersionDef& _internal_versions() const;
+  ::tensorflow::VersionDef* _internal_mutable_versions();
+  public:
+  void unsafe_arena_set_allocated_versions(
+      ::tensorflow::VersionDef* versions);
+  ::tensorflow::VersionDef* unsafe_arena_release_versions();
+
+  // int32 version = 3 [deprecated = true];
+  PROTOBUF_DEPRECATED void clear_version();
+  PROTOBUF_DEPRECATED int32_t version() const;
+  PROTOBUF_DEPRECATED void set_version(int32_t value);
+  private:
+  int32_t _internal_version() const;
+  void _internal_set_version(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.GraphDef)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::NodeDef > node_;
+    ::tensorflow::VersionDef* versions_;
+    int32_t version_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class Event final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.Event) */ {
+ public:
+  inline Event() : Event(nullptr) {}
+  ~Event() override;
+  explicit PROTOBUF_CONSTEXPR Event(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  Event(const Event& from);
+  Event(Event&& from) noexcept
+    : Event() {
+    *this = ::std::move(from);
+  }
+
+  inline Event& operator=(const Event& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline Event& operator=(Event&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Event& default_instance() {
+    return *internal_default_instance();
+  }
+  enum WhatCase {
+    kFileVersion = 3,
+    kGraphDef = 4,
+    kSummary = 5,
+    kLogMessage = 6,
+    kSessionLog = 7,
+    kTaggedRunMetadata = 8,
+    kMetaGraphDef = 9,
+    WHAT_NOT_SET = 0,
+  };
+
+  static inline const Event* internal_default_instance() {
+    return reinterpret_cast<const Event*>(
+               &_Event_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    17;
+
+  friend void swap(Event& a, Event& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(Event* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Event* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  Event* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<Event>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const Event& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Event& from) {
+    Event::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(Event* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.Event";
+  }
+  protected:
+  explicit Event(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kWallTimeFieldNumber = 1,
+    kStepFieldNumber = 2,
+    kFileVersionFieldNumber = 3,
+    kGraphDefFieldNumber = 4,
+    kSummaryFieldNumber = 5,
+    kLogMessageFieldNumber = 6,
+    kSessionLogFieldNumber = 7,
+    kTaggedRunMetadataFieldNumber = 8,
+    kMetaGraphDefFieldNumber = 9,
+  };
+  // double wall_time = 1;
+  void clear_wall_time();
+  double wall_time() const;
+  void set_wall_time(double value);
+  private:
+  double _internal_wall_time() const;
+  void _internal_set_wall_time(double value);
+  public:
+
+  // int64 step = 2;
+  void clear_step();
+  int64_t step() const;
+  void set_step(int64_t value);
+  private:
+  int64_t _internal_step() const;
+  void _internal_set_step(int64_t value);
+  public:
+
+  // string file_version = 3;
+  bool has_file_version() const;
+  private:
+  bool _internal_has_file_version() const;
+  public:
+  void clear_file_version();
+  const std::string& file_version() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_file_version(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_file_version();
+  PROTOBUF_NODISCARD std::string* release_file_version();
+  void set_allocated_file_version(std::string* file_version);
+  private:
+  const std::string& _internal_file_version() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_file_version(const std::string& value);
+  std::string* _internal_mutable_file_version();
+  public:
+
+  // bytes graph_def = 4;
+  bool has_graph_def() const;
+  private:
+  bool _internal_has_graph_def() const;
+  public:
+  void clear_graph_def();
+  const std::string& graph_def() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_graph_def(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_graph_def();
+  PROTOBUF_NODISCARD std::string* release_graph_def();
+  void set_allocated_graph_def(std::string* graph_def);
+  private:
+  const std::string& _internal_graph_def() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_graph_def(const std::string& value);
+  std::string* _internal_mutable_graph_def();
+  public:
+
+  // .tensorflow.Summary summary = 5;
+  bool has_summary() const;
+  private:
+  bool _internal_has_summary() const;
+  public:
+  void clear_summary();
+  const ::tensorflow::Summary& summary() const;
+  PROTOBUF_NODISCARD ::tensorflow::Summary* release_summary();
+  ::tensorflow::Summary* mutable_summary();
+  void set_allocated_summary(::tensorflow::Summary* summary);
+  private:
+  const ::tensorflow::Summary& _internal_summary() const;
+  ::tensorflow::Summary* _internal_mutable_summary();
+  public:
+  void unsafe_arena_set_allocated_summary(
+      ::tensorflow::Summary* summary);
+  ::tensorflow::Summary* unsafe_arena_release_summary();
+
+  // .tensorflow.LogMessage log_message = 6;
+  bool has_log_message() const;
+  private:
+  bool _internal_has_log_message() const;
+  public:
+  void clear_log_message();
+  const ::tensorflow::LogMessage& log_message() const;
+  PROTOBUF_NODISCARD ::tensorflow::LogMessage* release_log_message();
+  ::tensorflow::LogMessage* mutable_log_message();
+  void set_allocated_log_message(::tensorflow::LogMessage* log_message);
+  private:
+  const ::tensorflow::LogMessage& _internal_log_message() const;
+  ::tensorflow::LogMessage* _internal_mutable_log_message();
+  public:
+  void unsafe_arena_set_allocated_log_message(
+      ::tensorflow::LogMessage* log_message);
+  ::tensorflow::LogMessage* unsafe_arena_release_log_message();
+
+  // .tensorflow.SessionLog session_log = 7;
+  bool has_session_log() const;
+  private:
+  bool _internal_has_session_log() const;
+  public:
+  void clear_session_log();
+  const ::tensorflow::SessionLog& session_log() const;
+  PROTOBUF_NODISCARD ::tensorflow::SessionLog* release_session_log();
+  ::tensorflow::SessionLog* mutable_session_log();
+  void set_allocated_session_log(::tensorflow::SessionLog* session_log);
+  private:
+  const ::tensorflow::SessionLog& _internal_session_log() const;
+  ::tensorflow::SessionLog* _internal_mutable_session_log();
+  public:
+  void unsafe_arena_set_allocated_session_log(
+      ::tensorflow::SessionLog* session_log);
+  ::tensorflow::SessionLog* unsafe_arena_release_session_log();
+
+  // .tensorflow.TaggedRunMetadata tagged_run_metadata = 8;
+  bool has_tagged_run_metadata() const;
+  private:
+  bool _internal_has_tagged_run_metadata() const;
+  public:
+  void clear_tagged_run_metadata();
+  const ::tensorflow::TaggedRunMetadata& tagged_run_metadata() const;
+  PROTOBUF_NODISCARD ::tensorflow::TaggedRunMetadata* release_tagged_run_metadata();
+  ::tensorflow::TaggedRunMetadata* mutable_tagged_run_metadata();
+  void set_allocated_tagged_run_metadata(::tensorflow::TaggedRunMetadata* tagged_run_metadata);
+  private:
+  const ::tensorflow::TaggedRunMetadata& _internal_tagged_run_metadata() const;
+  ::tensorflow::TaggedRunMetadata* _internal_mutable_tagged_run_metadata();
+  public:
+  void unsafe_arena_set_allocated_tagged_run_metadata(
+      ::tensorflow::TaggedRunMetadata* tagged_run_metadata);
+  ::tensorflow::TaggedRunMetadata* unsafe_arena_release_tagged_run_metadata();
+
+  // bytes meta_graph_def = 9;
+  bool has_meta_graph_def() const;
+  private:
+  bool _internal_has_meta_graph_def() const;
+  public:
+  void clear_meta_graph_def();
+  const std::string& meta_graph_def() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_meta_graph_def(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_meta_graph_def();
+  PROTOBUF_NODISCARD std::string* release_meta_graph_def();
+  void set_allocated_meta_graph_def(std::string* meta_graph_def);
+  private:
+  const std::string& _internal_meta_graph_def() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_meta_graph_def(const std::string& value);
+  std::string* _internal_mutable_meta_graph_def();
+  public:
+
+  void clear_what();
+  WhatCase what_case() const;
+  // @@protoc_insertion_point(class_scope:tensorflow.Event)
+ private:
+  class _Internal;
+  void set_has_file_version();
+  void set_has_graph_def();
+  void set_has_summary();
+  void set_has_log_message();
+  void set_has_session_log();
+  void set_has_tagged_run_metadata();
+  void set_has_meta_graph_def();
+
+  inline bool has_what() const;
+  inline void clear_has_what();
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    double wall_time_;
+    int64_t step_;
+    union WhatUnion {
+      constexpr WhatUnion() : _constinit_{} {}
+        ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized _constinit_;
+      ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr file_version_;
+      ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr graph_def_;
+      ::tensorflow::Summary* summary_;
+      ::tensorflow::LogMessage* log_message_;
+      ::tensorflow::SessionLog* session_log_;
+      ::tensorflow::TaggedRunMetadata* tagged_run_metadata_;
+      ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr meta_graph_def_;
+    } what_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    uint32_t _oneof_case_[1];
+
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class LogMessage final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.LogMessage) */ {
+ public:
+  inline LogMessage() : LogMessage(nullptr) {}
+  ~LogMessage() override;
+  explicit PROTOBUF_CONSTEXPR LogMessage(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  LogMessage(const LogMessage& from);
+  LogMessage(LogMessage&& from) noexcept
+    : LogMessage() {
+    *this = ::std::move(from);
+  }
+
+  inline LogMessage& operator=(const LogMessage& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline LogMessage& operator=(LogMessage&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const LogMessage& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const LogMessage* internal_default_instance() {
+    return reinterpret_cast<const LogMessage*>(
+               &_LogMessage_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    18;
+
+  friend void swap(LogMessage& a, LogMessage& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(LogMessage* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(LogMessage* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  LogMessage* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<LogMessage>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const LogMessage& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const LogMessage& from) {
+    LogMessage::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(LogMessage* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.LogMessage";
+  }
+  protected:
+  explicit LogMessage(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef LogMessage_Level Level;
+  static constexpr Level UNKNOWN =
+    LogMessage_Level_UNKNOWN;
+  static constexpr Level DEBUG =
+    LogMessage_Level_DEBUG;
+  static constexpr Level INFO =
+    LogMessage_Level_INFO;
+  static constexpr Level WARN =
+    LogMessage_Level_WARN;
+  static constexpr Level ERROR =
+    LogMessage_Level_ERROR;
+  static constexpr Level FATAL =
+    LogMessage_Level_FATAL;
+  static inline bool Level_IsValid(int value) {
+    return LogMessage_Level_IsValid(value);
+  }
+  static constexpr Level Level_MIN =
+    LogMessage_Level_Level_MIN;
+  static constexpr Level Level_MAX =
+    LogMessage_Level_Level_MAX;
+  static constexpr int Level_ARRAYSIZE =
+    LogMessage_Level_Level_ARRAYSIZE;
+  static inline const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor*
+  Level_descriptor() {
+    return LogMessage_Level_descriptor();
+  }
+  template<typename T>
+  static inline const std::string& Level_Name(T enum_t_value) {
+    static_assert(::std::is_same<T, Level>::value ||
+      ::std::is_integral<T>::value,
+      "Incorrect type passed to function Level_Name.");
+    return LogMessage_Level_Name(enum_t_value);
+  }
+  static inline bool Level_Parse(::PROTOBUF_NAMESPACE_ID::ConstStringParam name,
+      Level* value) {
+    return LogMessage_Level_Parse(name, value);
+  }
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kMessageFieldNumber = 2,
+    kLevelFieldNumber = 1,
+  };
+  // string message = 2;
+  void clear_message();
+  const std::string& message() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_message(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_message();
+  PROTOBUF_NODISCARD std::string* release_message();
+  void set_allocated_message(std::string* message);
+  private:
+  const std::string& _internal_message() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_message(const std::string& value);
+  std::string* _internal_mutable_message();
+  public:
+
+  // .tensorflow.LogMessage.Level level = 1;
+  void clear_level();
+  ::tensorflow::LogMessage_Level level() const;
+  void set_level(::tensorflow::LogMessage_Level value);
+  private:
+  ::tensorflow::LogMessage_Level _internal_level() const;
+  void _internal_set_level(::tensorflow::LogMessage_Level value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.LogMessage)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr message_;
+    int level_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class SessionLog final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.SessionLog) */ {
+ public:
+  inline SessionLog() : SessionLog(nullptr) {}
+  ~SessionLog() override;
+  explicit PROTOBUF_CONSTEXPR SessionLog(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  SessionLog(const SessionLog& from);
+  SessionLog(SessionLog&& from) noexcept
+    : SessionLog() {
+    *this = ::std::move(from);
+  }
+
+  inline SessionLog& operator=(const SessionLog& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline SessionLog& operator=(SessionLog&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const SessionLog& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const SessionLog* internal_default_instance() {
+    return reinterpret_cast<const SessionLog*>(
+               &_SessionLog_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    19;
+
+  friend void swap(SessionLog& a, SessionLog& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(SessionLog* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(SessionLog* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  SessionLog* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<SessionLog>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const SessionLog& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const SessionLog& from) {
+    SessionLog::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(SessionLog* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.SessionLog";
+  }
+  protected:
+  explicit SessionLog(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef SessionLog_SessionStatus SessionStatus;
+  static constexpr SessionStatus STATUS_UNSPECIFIED =
+    SessionLog_SessionStatus_STATUS_UNSPECIFIED;
+  static constexpr SessionStatus START =
+    SessionLog_SessionStatus_START;
+  static constexpr SessionStatus STOP =
+    SessionLog_SessionStatus_STOP;
+  static constexpr SessionStatus CHECKPOINT =
+    SessionLog_SessionStatus_CHECKPOINT;
+  static inline bool SessionStatus_IsValid(int value) {
+    return SessionLog_SessionStatus_IsValid(value);
+  }
+  static constexpr SessionStatus SessionStatus_MIN =
+    SessionLog_SessionStatus_SessionStatus_MIN;
+  static constexpr SessionStatus SessionStatus_MAX =
+    SessionLog_SessionStatus_SessionStatus_MAX;
+  static constexpr int SessionStatus_ARRAYSIZE =
+    SessionLog_SessionStatus_SessionStatus_ARRAYSIZE;
+  static inline const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor*
+  SessionStatus_descriptor() {
+    return SessionLog_SessionStatus_descriptor();
+  }
+  template<typename T>
+  static inline const std::string& SessionStatus_Name(T enum_t_value) {
+    static_assert(::std::is_same<T, SessionStatus>::value ||
+      ::std::is_integral<T>::value,
+      "Incorrect type passed to function SessionStatus_Name.");
+    return SessionLog_SessionStatus_Name(enum_t_value);
+  }
+  static inline bool SessionStatus_Parse(::PROTOBUF_NAMESPACE_ID::ConstStringParam name,
+      SessionStatus* value) {
+    return SessionLog_SessionStatus_Parse(name, value);
+  }
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kCheckpointPathFieldNumber = 2,
+    kMsgFieldNumber = 3,
+    kStatusFieldNumber = 1,
+  };
+  // string checkpoint_path = 2;
+  void clear_checkpoint_path();
+  const std::string& checkpoint_path() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_checkpoint_path(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_checkpoint_path();
+  PROTOBUF_NODISCARD std::string* release_checkpoint_path();
+  void set_allocated_checkpoint_path(std::string* checkpoint_path);
+  private:
+  const std::string& _internal_checkpoint_path() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_checkpoint_path(const std::string& value);
+  std::string* _internal_mutable_checkpoint_path();
+  public:
+
+  // string msg = 3;
+  void clear_msg();
+  const std::string& msg() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_msg(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_msg();
+  PROTOBUF_NODISCARD std::string* release_msg();
+  void set_allocated_msg(std::string* msg);
+  private:
+  const std::string& _internal_msg() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_msg(const std::string& value);
+  std::string* _internal_mutable_msg();
+  public:
+
+  // .tensorflow.SessionLog.SessionStatus status = 1;
+  void clear_status();
+  ::tensorflow::SessionLog_SessionStatus status() const;
+  void set_status(::tensorflow::SessionLog_SessionStatus value);
+  private:
+  ::tensorflow::SessionLog_SessionStatus _internal_status() const;
+  void _internal_set_status(::tensorflow::SessionLog_SessionStatus value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.SessionLog)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr checkpoint_path_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr msg_;
+    int status_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// -------------------------------------------------------------------
+
+class TaggedRunMetadata final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:tensorflow.TaggedRunMetadata) */ {
+ public:
+  inline TaggedRunMetadata() : TaggedRunMetadata(nullptr) {}
+  ~TaggedRunMetadata() override;
+  explicit PROTOBUF_CONSTEXPR TaggedRunMetadata(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  TaggedRunMetadata(const TaggedRunMetadata& from);
+  TaggedRunMetadata(TaggedRunMetadata&& from) noexcept
+    : TaggedRunMetadata() {
+    *this = ::std::move(from);
+  }
+
+  inline TaggedRunMetadata& operator=(const TaggedRunMetadata& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline TaggedRunMetadata& operator=(TaggedRunMetadata&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const TaggedRunMetadata& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const TaggedRunMetadata* internal_default_instance() {
+    return reinterpret_cast<const TaggedRunMetadata*>(
+               &_TaggedRunMetadata_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    20;
+
+  friend void swap(TaggedRunMetadata& a, TaggedRunMetadata& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(TaggedRunMetadata* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(TaggedRunMetadata* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  TaggedRunMetadata* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<TaggedRunMetadata>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const TaggedRunMetadata& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const TaggedRunMetadata& from) {
+    TaggedRunMetadata::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(TaggedRunMetadata* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "tensorflow.TaggedRunMetadata";
+  }
+  protected:
+  explicit TaggedRunMetadata(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kTagFieldNumber = 1,
+    kRunMetadataFieldNumber = 2,
+  };
+  // string tag = 1;
+  void clear_tag();
+  const std::string& tag() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_tag(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_tag();
+  PROTOBUF_NODISCARD std::string* release_tag();
+  void set_allocated_tag(std::string* tag);
+  private:
+  const std::string& _internal_tag() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_tag(const std::string& value);
+  std::string* _internal_mutable_tag();
+  public:
+
+  // bytes run_metadata = 2;
+  void clear_run_metadata();
+  const std::string& run_metadata() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_run_metadata(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_run_metadata();
+  PROTOBUF_NODISCARD std::string* release_run_metadata();
+  void set_allocated_run_metadata(std::string* run_metadata);
+  private:
+  const std::string& _internal_run_metadata() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_run_metadata(const std::string& value);
+  std::string* _internal_mutable_run_metadata();
+  public:
+
+  // @@protoc_insertion_point(class_scope:tensorflow.TaggedRunMetadata)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr tag_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr run_metadata_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_tensorboard_2eproto;
+};
+// ===================================================================
+
+
+// ===================================================================
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif  // __GNUC__
+// TensorShapeProto_Dim
+
+// int64 size = 1;
+inline void TensorShapeProto_Dim::clear_size() {
+  _impl_.size_ = int64_t{0};
+}
+inline int64_t TensorShapeProto_Dim::_internal_size() const {
+  return _impl_.size_;
+}
+inline int64_t TensorShapeProto_Dim::size() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorShapeProto.Dim.size)
+  return _internal_size();
+}
+inline void TensorShapeProto_Dim::_internal_set_size(int64_t value) {
+  
+  _impl_.size_ = value;
+}
+inline void TensorShapeProto_Dim::set_size(int64_t value) {
+  _internal_set_size(value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorShapeProto.Dim.size)
+}
+
+// string name = 2;
+inline void TensorShapeProto_Dim::clear_name() {
+  _impl_.name_.ClearToEmpty();
+}
+inline const std::string& TensorShapeProto_Dim::name() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorShapeProto.Dim.name)
+  return _internal_name();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void TensorShapeProto_Dim::set_name(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.name_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.TensorShapeProto.Dim.name)
+}
+inline std::string* TensorShapeProto_Dim::mutable_name() {
+  std::string* _s = _internal_mutable_name();
+  // @@protoc_insertion_point(field_mutable:tensorflow.TensorShapeProto.Dim.name)
+  return _s;
+}
+inline const std::string& TensorShapeProto_Dim::_internal_name() const {
+  return _impl_.name_.Get();
+}
+inline void TensorShapeProto_Dim::_internal_set_name(const std::string& value) {
+  
+  _impl_.name_.Set(value, GetArenaForAllocation());
+}
+inline std::string* TensorShapeProto_Dim::_internal_mutable_name() {
+  
+  return _impl_.name_.Mutable(GetArenaForAllocation());
+}
+inline std::string* TensorShapeProto_Dim::release_name() {
+  // @@protoc_insertion_point(field_release:tensorflow.TensorShapeProto.Dim.name)
+  return _impl_.name_.Release();
+}
+inline void TensorShapeProto_Dim::set_allocated_name(std::string* name) {
+  if (name != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.name_.SetAllocated(name, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.name_.IsDefault()) {
+    _impl_.name_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.TensorShapeProto.Dim.name)
+}
+
+// -------------------------------------------------------------------
+
+// TensorShapeProto
+
+// repeated .tensorflow.TensorShapeProto.Dim dim = 2;
+inline int TensorShapeProto::_internal_dim_size() const {
+  return _impl_.dim_.size();
+}
+inline int TensorShapeProto::dim_size() const {
+  return _internal_dim_size();
+}
+inline void TensorShapeProto::clear_dim() {
+  _impl_.dim_.Clear();
+}
+inline ::tensorflow::TensorShapeProto_Dim* TensorShapeProto::mutable_dim(int index) {
+  // @@protoc_insertion_point(field_mutable:tensorflow.TensorShapeProto.dim)
+  return _impl_.dim_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto_Dim >*
+TensorShapeProto::mutable_dim() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorShapeProto.dim)
+  return &_impl_.dim_;
+}
+inline const ::tensorflow::TensorShapeProto_Dim& TensorShapeProto::_internal_dim(int index) const {
+  return _impl_.dim_.Get(index);
+}
+inline const ::tensorflow::TensorShapeProto_Dim& TensorShapeProto::dim(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorShapeProto.dim)
+  return _internal_dim(index);
+}
+inline ::tensorflow::TensorShapeProto_Dim* TensorShapeProto::_internal_add_dim() {
+  return _impl_.dim_.Add();
+}
+inline ::tensorflow::TensorShapeProto_Dim* TensorShapeProto::add_dim() {
+  ::tensorflow::TensorShapeProto_Dim* _add = _internal_add_dim();
+  // @@protoc_insertion_point(field_add:tensorflow.TensorShapeProto.dim)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto_Dim >&
+TensorShapeProto::dim() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorShapeProto.dim)
+  return _impl_.dim_;
+}
+
+// bool unknown_rank = 3;
+inline void TensorShapeProto::clear_unknown_rank() {
+  _impl_.unknown_rank_ = false;
+}
+inline bool TensorShapeProto::_internal_unknown_rank() const {
+  return _impl_.unknown_rank_;
+}
+inline bool TensorShapeProto::unknown_rank() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorShapeProto.unknown_rank)
+  return _internal_unknown_rank();
+}
+inline void TensorShapeProto::_internal_set_unknown_rank(bool value) {
+  
+  _impl_.unknown_rank_ = value;
+}
+inline void TensorShapeProto::set_unknown_rank(bool value) {
+  _internal_set_unknown_rank(value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorShapeProto.unknown_rank)
+}
+
+// -------------------------------------------------------------------
+
+// TensorProto
+
+// .tensorflow.DataType dtype = 1;
+inline void TensorProto::clear_dtype() {
+  _impl_.dtype_ = 0;
+}
+inline ::tensorflow::DataType TensorProto::_internal_dtype() const {
+  return static_cast< ::tensorflow::DataType >(_impl_.dtype_);
+}
+inline ::tensorflow::DataType TensorProto::dtype() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.dtype)
+  return _internal_dtype();
+}
+inline void TensorProto::_internal_set_dtype(::tensorflow::DataType value) {
+  
+  _impl_.dtype_ = value;
+}
+inline void TensorProto::set_dtype(::tensorflow::DataType value) {
+  _internal_set_dtype(value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.dtype)
+}
+
+// .tensorflow.TensorShapeProto tensor_shape = 2;
+inline bool TensorProto::_internal_has_tensor_shape() const {
+  return this != internal_default_instance() && _impl_.tensor_shape_ != nullptr;
+}
+inline bool TensorProto::has_tensor_shape() const {
+  return _internal_has_tensor_shape();
+}
+inline void TensorProto::clear_tensor_shape() {
+  if (GetArenaForAllocation() == nullptr && _impl_.tensor_shape_ != nullptr) {
+    delete _impl_.tensor_shape_;
+  }
+  _impl_.tensor_shape_ = nullptr;
+}
+inline const ::tensorflow::TensorShapeProto& TensorProto::_internal_tensor_shape() const {
+  const ::tensorflow::TensorShapeProto* p = _impl_.tensor_shape_;
+  return p != nullptr ? *p : reinterpret_cast<const ::tensorflow::TensorShapeProto&>(
+      ::tensorflow::_TensorShapeProto_default_instance_);
+}
+inline const ::tensorflow::TensorShapeProto& TensorProto::tensor_shape() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.tensor_shape)
+  return _internal_tensor_shape();
+}
+inline void TensorProto::unsafe_arena_set_allocated_tensor_shape(
+    ::tensorflow::TensorShapeProto* tensor_shape) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.tensor_shape_);
+  }
+  _impl_.tensor_shape_ = tensor_shape;
+  if (tensor_shape) {
+    
+  } else {
+    
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.TensorProto.tensor_shape)
+}
+inline ::tensorflow::TensorShapeProto* TensorProto::release_tensor_shape() {
+  
+  ::tensorflow::TensorShapeProto* temp = _impl_.tensor_shape_;
+  _impl_.tensor_shape_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::tensorflow::TensorShapeProto* TensorProto::unsafe_arena_release_tensor_shape() {
+  // @@protoc_insertion_point(field_release:tensorflow.TensorProto.tensor_shape)
+  
+  ::tensorflow::TensorShapeProto* temp = _impl_.tensor_shape_;
+  _impl_.tensor_shape_ = nullptr;
+  return temp;
+}
+inline ::tensorflow::TensorShapeProto* TensorProto::_internal_mutable_tensor_shape() {
+  
+  if (_impl_.tensor_shape_ == nullptr) {
+    auto* p = CreateMaybeMessage<::tensorflow::TensorShapeProto>(GetArenaForAllocation());
+    _impl_.tensor_shape_ = p;
+  }
+  return _impl_.tensor_shape_;
+}
+inline ::tensorflow::TensorShapeProto* TensorProto::mutable_tensor_shape() {
+  ::tensorflow::TensorShapeProto* _msg = _internal_mutable_tensor_shape();
+  // @@protoc_insertion_point(field_mutable:tensorflow.TensorProto.tensor_shape)
+  return _msg;
+}
+inline void TensorProto::set_allocated_tensor_shape(::tensorflow::TensorShapeProto* tensor_shape) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.tensor_shape_;
+  }
+  if (tensor_shape) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(tensor_shape);
+    if (message_arena != submessage_arena) {
+      tensor_shape = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, tensor_shape, submessage_arena);
+    }
+    
+  } else {
+    
+  }
+  _impl_.tensor_shape_ = tensor_shape;
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.TensorProto.tensor_shape)
+}
+
+// int32 version_number = 3;
+inline void TensorProto::clear_version_number() {
+  _impl_.version_number_ = 0;
+}
+inline int32_t TensorProto::_internal_version_number() const {
+  return _impl_.version_number_;
+}
+inline int32_t TensorProto::version_number() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.version_number)
+  return _internal_version_number();
+}
+inline void TensorProto::_internal_set_version_number(int32_t value) {
+  
+  _impl_.version_number_ = value;
+}
+inline void TensorProto::set_version_number(int32_t value) {
+  _internal_set_version_number(value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.version_number)
+}
+
+// bytes tensor_content = 4;
+inline void TensorProto::clear_tensor_content() {
+  _impl_.tensor_content_.ClearToEmpty();
+}
+inline const std::string& TensorProto::tensor_content() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.tensor_content)
+  return _internal_tensor_content();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void TensorProto::set_tensor_content(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.tensor_content_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.tensor_content)
+}
+inline std::string* TensorProto::mutable_tensor_content() {
+  std::string* _s = _internal_mutable_tensor_content();
+  // @@protoc_insertion_point(field_mutable:tensorflow.TensorProto.tensor_content)
+  return _s;
+}
+inline const std::string& TensorProto::_internal_tensor_content() const {
+  return _impl_.tensor_content_.Get();
+}
+inline void TensorProto::_internal_set_tensor_content(const std::string& value) {
+  
+  _impl_.tensor_content_.Set(value, GetArenaForAllocation());
+}
+inline std::string* TensorProto::_internal_mutable_tensor_content() {
+  
+  return _impl_.tensor_content_.Mutable(GetArenaForAllocation());
+}
+inline std::string* TensorProto::release_tensor_content() {
+  // @@protoc_insertion_point(field_release:tensorflow.TensorProto.tensor_content)
+  return _impl_.tensor_content_.Release();
+}
+inline void TensorProto::set_allocated_tensor_content(std::string* tensor_content) {
+  if (tensor_content != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.tensor_content_.SetAllocated(tensor_content, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.tensor_content_.IsDefault()) {
+    _impl_.tensor_content_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.TensorProto.tensor_content)
+}
+
+// repeated int32 half_val = 13 [packed = true];
+inline int TensorProto::_internal_half_val_size() const {
+  return _impl_.half_val_.size();
+}
+inline int TensorProto::half_val_size() const {
+  return _internal_half_val_size();
+}
+inline void TensorProto::clear_half_val() {
+  _impl_.half_val_.Clear();
+}
+inline int32_t TensorProto::_internal_half_val(int index) const {
+  return _impl_.half_val_.Get(index);
+}
+inline int32_t TensorProto::half_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.half_val)
+  return _internal_half_val(index);
+}
+inline void TensorProto::set_half_val(int index, int32_t value) {
+  _impl_.half_val_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.half_val)
+}
+inline void TensorProto::_internal_add_half_val(int32_t value) {
+  _impl_.half_val_.Add(value);
+}
+inline void TensorProto::add_half_val(int32_t value) {
+  _internal_add_half_val(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.half_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+TensorProto::_internal_half_val() const {
+  return _impl_.half_val_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+TensorProto::half_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.half_val)
+  return _internal_half_val();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+TensorProto::_internal_mutable_half_val() {
+  return &_impl_.half_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+TensorProto::mutable_half_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.half_val)
+  return _internal_mutable_half_val();
+}
+
+// repeated float float_val = 5 [packed = true];
+inline int TensorProto::_internal_float_val_size() const {
+  return _impl_.float_val_.size();
+}
+inline int TensorProto::float_val_size() const {
+  return _internal_float_val_size();
+}
+inline void TensorProto::clear_float_val() {
+  _impl_.float_val_.Clear();
+}
+inline float TensorProto::_internal_float_val(int index) const {
+  return _impl_.float_val_.Get(index);
+}
+inline float TensorProto::float_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.float_val)
+  return _internal_float_val(index);
+}
+inline void TensorProto::set_float_val(int index, float value) {
+  _impl_.float_val_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.float_val)
+}
+inline void TensorProto::_internal_add_float_val(float value) {
+  _impl_.float_val_.Add(value);
+}
+inline void TensorProto::add_float_val(float value) {
+  _internal_add_float_val(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.float_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+TensorProto::_internal_float_val() const {
+  return _impl_.float_val_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+TensorProto::float_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.float_val)
+  return _internal_float_val();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+TensorProto::_internal_mutable_float_val() {
+  return &_impl_.float_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+TensorProto::mutable_float_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.float_val)
+  return _internal_mutable_float_val();
+}
+
+// repeated double double_val = 6 [packed = true];
+inline int TensorProto::_internal_double_val_size() const {
+  return _impl_.double_val_.size();
+}
+inline int TensorProto::double_val_size() const {
+  return _internal_double_val_size();
+}
+inline void TensorProto::clear_double_val() {
+  _impl_.double_val_.Clear();
+}
+inline double TensorProto::_internal_double_val(int index) const {
+  return _impl_.double_val_.Get(index);
+}
+inline double TensorProto::double_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.double_val)
+  return _internal_double_val(index);
+}
+inline void TensorProto::set_double_val(int index, double value) {
+  _impl_.double_val_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.double_val)
+}
+inline void TensorProto::_internal_add_double_val(double value) {
+  _impl_.double_val_.Add(value);
+}
+inline void TensorProto::add_double_val(double value) {
+  _internal_add_double_val(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.double_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+TensorProto::_internal_double_val() const {
+  return _impl_.double_val_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+TensorProto::double_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.double_val)
+  return _internal_double_val();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+TensorProto::_internal_mutable_double_val() {
+  return &_impl_.double_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+TensorProto::mutable_double_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.double_val)
+  return _internal_mutable_double_val();
+}
+
+// repeated int32 int_val = 7 [packed = true];
+inline int TensorProto::_internal_int_val_size() const {
+  return _impl_.int_val_.size();
+}
+inline int TensorProto::int_val_size() const {
+  return _internal_int_val_size();
+}
+inline void TensorProto::clear_int_val() {
+  _impl_.int_val_.Clear();
+}
+inline int32_t TensorProto::_internal_int_val(int index) const {
+  return _impl_.int_val_.Get(index);
+}
+inline int32_t TensorProto::int_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.int_val)
+  return _internal_int_val(index);
+}
+inline void TensorProto::set_int_val(int index, int32_t value) {
+  _impl_.int_val_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.int_val)
+}
+inline void TensorProto::_internal_add_int_val(int32_t value) {
+  _impl_.int_val_.Add(value);
+}
+inline void TensorProto::add_int_val(int32_t value) {
+  _internal_add_int_val(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.int_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+TensorProto::_internal_int_val() const {
+  return _impl_.int_val_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+TensorProto::int_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.int_val)
+  return _internal_int_val();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+TensorProto::_internal_mutable_int_val() {
+  return &_impl_.int_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+TensorProto::mutable_int_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.int_val)
+  return _internal_mutable_int_val();
+}
+
+// repeated bytes string_val = 8;
+inline int TensorProto::_internal_string_val_size() const {
+  return _impl_.string_val_.size();
+}
+inline int TensorProto::string_val_size() const {
+  return _internal_string_val_size();
+}
+inline void TensorProto::clear_string_val() {
+  _impl_.string_val_.Clear();
+}
+inline std::string* TensorProto::add_string_val() {
+  std::string* _s = _internal_add_string_val();
+  // @@protoc_insertion_point(field_add_mutable:tensorflow.TensorProto.string_val)
+  return _s;
+}
+inline const std::string& TensorProto::_internal_string_val(int index) const {
+  return _impl_.string_val_.Get(index);
+}
+inline const std::string& TensorProto::string_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.string_val)
+  return _internal_string_val(index);
+}
+inline std::string* TensorProto::mutable_string_val(int index) {
+  // @@protoc_insertion_point(field_mutable:tensorflow.TensorProto.string_val)
+  return _impl_.string_val_.Mutable(index);
+}
+inline void TensorProto::set_string_val(int index, const std::string& value) {
+  _impl_.string_val_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.string_val)
+}
+inline void TensorProto::set_string_val(int index, std::string&& value) {
+  _impl_.string_val_.Mutable(index)->assign(std::move(value));
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.string_val)
+}
+inline void TensorProto::set_string_val(int index, const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  _impl_.string_val_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set_char:tensorflow.TensorProto.string_val)
+}
+inline void TensorProto::set_string_val(int index, const void* value, size_t size) {
+  _impl_.string_val_.Mutable(index)->assign(
+    reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:tensorflow.TensorProto.string_val)
+}
+inline std::string* TensorProto::_internal_add_string_val() {
+  return _impl_.string_val_.Add();
+}
+inline void TensorProto::add_string_val(const std::string& value) {
+  _impl_.string_val_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.string_val)
+}
+inline void TensorProto::add_string_val(std::string&& value) {
+  _impl_.string_val_.Add(std::move(value));
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.string_val)
+}
+inline void TensorProto::add_string_val(const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  _impl_.string_val_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add_char:tensorflow.TensorProto.string_val)
+}
+inline void TensorProto::add_string_val(const void* value, size_t size) {
+  _impl_.string_val_.Add()->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_add_pointer:tensorflow.TensorProto.string_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>&
+TensorProto::string_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.string_val)
+  return _impl_.string_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>*
+TensorProto::mutable_string_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.string_val)
+  return &_impl_.string_val_;
+}
+
+// repeated float scomplex_val = 9 [packed = true];
+inline int TensorProto::_internal_scomplex_val_size() const {
+  return _impl_.scomplex_val_.size();
+}
+inline int TensorProto::scomplex_val_size() const {
+  return _internal_scomplex_val_size();
+}
+inline void TensorProto::clear_scomplex_val() {
+  _impl_.scomplex_val_.Clear();
+}
+inline float TensorProto::_internal_scomplex_val(int index) const {
+  return _impl_.scomplex_val_.Get(index);
+}
+inline float TensorProto::scomplex_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.scomplex_val)
+  return _internal_scomplex_val(index);
+}
+inline void TensorProto::set_scomplex_val(int index, float value) {
+  _impl_.scomplex_val_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.scomplex_val)
+}
+inline void TensorProto::_internal_add_scomplex_val(float value) {
+  _impl_.scomplex_val_.Add(value);
+}
+inline void TensorProto::add_scomplex_val(float value) {
+  _internal_add_scomplex_val(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.scomplex_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+TensorProto::_internal_scomplex_val() const {
+  return _impl_.scomplex_val_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+TensorProto::scomplex_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.scomplex_val)
+  return _internal_scomplex_val();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+TensorProto::_internal_mutable_scomplex_val() {
+  return &_impl_.scomplex_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+TensorProto::mutable_scomplex_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.scomplex_val)
+  return _internal_mutable_scomplex_val();
+}
+
+// repeated int64 int64_val = 10 [packed = true];
+inline int TensorProto::_internal_int64_val_size() const {
+  return _impl_.int64_val_.size();
+}
+inline int TensorProto::int64_val_size() const {
+  return _internal_int64_val_size();
+}
+inline void TensorProto::clear_int64_val() {
+  _impl_.int64_val_.Clear();
+}
+inline int64_t TensorProto::_internal_int64_val(int index) const {
+  return _impl_.int64_val_.Get(index);
+}
+inline int64_t TensorProto::int64_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.int64_val)
+  return _internal_int64_val(index);
+}
+inline void TensorProto::set_int64_val(int index, int64_t value) {
+  _impl_.int64_val_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.int64_val)
+}
+inline void TensorProto::_internal_add_int64_val(int64_t value) {
+  _impl_.int64_val_.Add(value);
+}
+inline void TensorProto::add_int64_val(int64_t value) {
+  _internal_add_int64_val(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.int64_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+TensorProto::_internal_int64_val() const {
+  return _impl_.int64_val_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+TensorProto::int64_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.int64_val)
+  return _internal_int64_val();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+TensorProto::_internal_mutable_int64_val() {
+  return &_impl_.int64_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+TensorProto::mutable_int64_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.int64_val)
+  return _internal_mutable_int64_val();
+}
+
+// repeated bool bool_val = 11 [packed = true];
+inline int TensorProto::_internal_bool_val_size() const {
+  return _impl_.bool_val_.size();
+}
+inline int TensorProto::bool_val_size() const {
+  return _internal_bool_val_size();
+}
+inline void TensorProto::clear_bool_val() {
+  _impl_.bool_val_.Clear();
+}
+inline bool TensorProto::_internal_bool_val(int index) const {
+  return _impl_.bool_val_.Get(index);
+}
+inline bool TensorProto::bool_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.bool_val)
+  return _internal_bool_val(index);
+}
+inline void TensorProto::set_bool_val(int index, bool value) {
+  _impl_.bool_val_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.bool_val)
+}
+inline void TensorProto::_internal_add_bool_val(bool value) {
+  _impl_.bool_val_.Add(value);
+}
+inline void TensorProto::add_bool_val(bool value) {
+  _internal_add_bool_val(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.bool_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+TensorProto::_internal_bool_val() const {
+  return _impl_.bool_val_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+TensorProto::bool_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.bool_val)
+  return _internal_bool_val();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+TensorProto::_internal_mutable_bool_val() {
+  return &_impl_.bool_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+TensorProto::mutable_bool_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.bool_val)
+  return _internal_mutable_bool_val();
+}
+
+// repeated double dcomplex_val = 12 [packed = true];
+inline int TensorProto::_internal_dcomplex_val_size() const {
+  return _impl_.dcomplex_val_.size();
+}
+inline int TensorProto::dcomplex_val_size() const {
+  return _internal_dcomplex_val_size();
+}
+inline void TensorProto::clear_dcomplex_val() {
+  _impl_.dcomplex_val_.Clear();
+}
+inline double TensorProto::_internal_dcomplex_val(int index) const {
+  return _impl_.dcomplex_val_.Get(index);
+}
+inline double TensorProto::dcomplex_val(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.TensorProto.dcomplex_val)
+  return _internal_dcomplex_val(index);
+}
+inline void TensorProto::set_dcomplex_val(int index, double value) {
+  _impl_.dcomplex_val_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.TensorProto.dcomplex_val)
+}
+inline void TensorProto::_internal_add_dcomplex_val(double value) {
+  _impl_.dcomplex_val_.Add(value);
+}
+inline void TensorProto::add_dcomplex_val(double value) {
+  _internal_add_dcomplex_val(value);
+  // @@protoc_insertion_point(field_add:tensorflow.TensorProto.dcomplex_val)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+TensorProto::_internal_dcomplex_val() const {
+  return _impl_.dcomplex_val_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+TensorProto::dcomplex_val() const {
+  // @@protoc_insertion_point(field_list:tensorflow.TensorProto.dcomplex_val)
+  return _internal_dcomplex_val();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+TensorProto::_internal_mutable_dcomplex_val() {
+  return &_impl_.dcomplex_val_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+TensorProto::mutable_dcomplex_val() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.TensorProto.dcomplex_val)
+  return _internal_mutable_dcomplex_val();
+}
+
+// -------------------------------------------------------------------
+
+// VersionDef
+
+// int32 producer = 1;
+inline void VersionDef::clear_producer() {
+  _impl_.producer_ = 0;
+}
+inline int32_t VersionDef::_internal_producer() const {
+  return _impl_.producer_;
+}
+inline int32_t VersionDef::producer() const {
+  // @@protoc_insertion_point(field_get:tensorflow.VersionDef.producer)
+  return _internal_producer();
+}
+inline void VersionDef::_internal_set_producer(int32_t value) {
+  
+  _impl_.producer_ = value;
+}
+inline void VersionDef::set_producer(int32_t value) {
+  _internal_set_producer(value);
+  // @@protoc_insertion_point(field_set:tensorflow.VersionDef.producer)
+}
+
+// int32 min_consumer = 2;
+inline void VersionDef::clear_min_consumer() {
+  _impl_.min_consumer_ = 0;
+}
+inline int32_t VersionDef::_internal_min_consumer() const {
+  return _impl_.min_consumer_;
+}
+inline int32_t VersionDef::min_consumer() const {
+  // @@protoc_insertion_point(field_get:tensorflow.VersionDef.min_consumer)
+  return _internal_min_consumer();
+}
+inline void VersionDef::_internal_set_min_consumer(int32_t value) {
+  
+  _impl_.min_consumer_ = value;
+}
+inline void VersionDef::set_min_consumer(int32_t value) {
+  _internal_set_min_consumer(value);
+  // @@protoc_insertion_point(field_set:tensorflow.VersionDef.min_consumer)
+}
+
+// repeated int32 bad_consumers = 3;
+inline int VersionDef::_internal_bad_consumers_size() const {
+  return _impl_.bad_consumers_.size();
+}
+inline int VersionDef::bad_consumers_size() const {
+  return _internal_bad_consumers_size();
+}
+inline void VersionDef::clear_bad_consumers() {
+  _impl_.bad_consumers_.Clear();
+}
+inline int32_t VersionDef::_internal_bad_consumers(int index) const {
+  return _impl_.bad_consumers_.Get(index);
+}
+inline int32_t VersionDef::bad_consumers(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.VersionDef.bad_consumers)
+  return _internal_bad_consumers(index);
+}
+inline void VersionDef::set_bad_consumers(int index, int32_t value) {
+  _impl_.bad_consumers_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.VersionDef.bad_consumers)
+}
+inline void VersionDef::_internal_add_bad_consumers(int32_t value) {
+  _impl_.bad_consumers_.Add(value);
+}
+inline void VersionDef::add_bad_consumers(int32_t value) {
+  _internal_add_bad_consumers(value);
+  // @@protoc_insertion_point(field_add:tensorflow.VersionDef.bad_consumers)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+VersionDef::_internal_bad_consumers() const {
+  return _impl_.bad_consumers_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >&
+VersionDef::bad_consumers() const {
+  // @@protoc_insertion_point(field_list:tensorflow.VersionDef.bad_consumers)
+  return _internal_bad_consumers();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+VersionDef::_internal_mutable_bad_consumers() {
+  return &_impl_.bad_consumers_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int32_t >*
+VersionDef::mutable_bad_consumers() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.VersionDef.bad_consumers)
+  return _internal_mutable_bad_consumers();
+}
+
+// -------------------------------------------------------------------
+
+// SummaryDescription
+
+// string type_hint = 1;
+inline void SummaryDescription::clear_type_hint() {
+  _impl_.type_hint_.ClearToEmpty();
+}
+inline const std::string& SummaryDescription::type_hint() const {
+  // @@protoc_insertion_point(field_get:tensorflow.SummaryDescription.type_hint)
+  return _internal_type_hint();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void SummaryDescription::set_type_hint(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.type_hint_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.SummaryDescription.type_hint)
+}
+inline std::string* SummaryDescription::mutable_type_hint() {
+  std::string* _s = _internal_mutable_type_hint();
+  // @@protoc_insertion_point(field_mutable:tensorflow.SummaryDescription.type_hint)
+  return _s;
+}
+inline const std::string& SummaryDescription::_internal_type_hint() const {
+  return _impl_.type_hint_.Get();
+}
+inline void SummaryDescription::_internal_set_type_hint(const std::string& value) {
+  
+  _impl_.type_hint_.Set(value, GetArenaForAllocation());
+}
+inline std::string* SummaryDescription::_internal_mutable_type_hint() {
+  
+  return _impl_.type_hint_.Mutable(GetArenaForAllocation());
+}
+inline std::string* SummaryDescription::release_type_hint() {
+  // @@protoc_insertion_point(field_release:tensorflow.SummaryDescription.type_hint)
+  return _impl_.type_hint_.Release();
+}
+inline void SummaryDescription::set_allocated_type_hint(std::string* type_hint) {
+  if (type_hint != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.type_hint_.SetAllocated(type_hint, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.type_hint_.IsDefault()) {
+    _impl_.type_hint_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.SummaryDescription.type_hint)
+}
+
+// -------------------------------------------------------------------
+
+// HistogramProto
+
+// double min = 1;
+inline void HistogramProto::clear_min() {
+  _impl_.min_ = 0;
+}
+inline double HistogramProto::_internal_min() const {
+  return _impl_.min_;
+}
+inline double HistogramProto::min() const {
+  // @@protoc_insertion_point(field_get:tensorflow.HistogramProto.min)
+  return _internal_min();
+}
+inline void HistogramProto::_internal_set_min(double value) {
+  
+  _impl_.min_ = value;
+}
+inline void HistogramProto::set_min(double value) {
+  _internal_set_min(value);
+  // @@protoc_insertion_point(field_set:tensorflow.HistogramProto.min)
+}
+
+// double max = 2;
+inline void HistogramProto::clear_max() {
+  _impl_.max_ = 0;
+}
+inline double HistogramProto::_internal_max() const {
+  return _impl_.max_;
+}
+inline double HistogramProto::max() const {
+  // @@protoc_insertion_point(field_get:tensorflow.HistogramProto.max)
+  return _internal_max();
+}
+inline void HistogramProto::_internal_set_max(double value) {
+  
+  _impl_.max_ = value;
+}
+inline void HistogramProto::set_max(double value) {
+  _internal_set_max(value);
+  // @@protoc_insertion_point(field_set:tensorflow.HistogramProto.max)
+}
+
+// double num = 3;
+inline void HistogramProto::clear_num() {
+  _impl_.num_ = 0;
+}
+inline double HistogramProto::_internal_num() const {
+  return _impl_.num_;
+}
+inline double HistogramProto::num() const {
+  // @@protoc_insertion_point(field_get:tensorflow.HistogramProto.num)
+  return _internal_num();
+}
+inline void HistogramProto::_internal_set_num(double value) {
+  
+  _impl_.num_ = value;
+}
+inline void HistogramProto::set_num(double value) {
+  _internal_set_num(value);
+  // @@protoc_insertion_point(field_set:tensorflow.HistogramProto.num)
+}
+
+// double sum = 4;
+inline void HistogramProto::clear_sum() {
+  _impl_.sum_ = 0;
+}
+inline double HistogramProto::_internal_sum() const {
+  return _impl_.sum_;
+}
+inline double HistogramProto::sum() const {
+  // @@protoc_insertion_point(field_get:tensorflow.HistogramProto.sum)
+  return _internal_sum();
+}
+inline void HistogramProto::_internal_set_sum(double value) {
+  
+  _impl_.sum_ = value;
+}
+inline void HistogramProto::set_sum(double value) {
+  _internal_set_sum(value);
+  // @@protoc_insertion_point(field_set:tensorflow.HistogramProto.sum)
+}
+
+// double sum_squares = 5;
+inline void HistogramProto::clear_sum_squares() {
+  _impl_.sum_squares_ = 0;
+}
+inline double HistogramProto::_internal_sum_squares() const {
+  return _impl_.sum_squares_;
+}
+inline double HistogramProto::sum_squares() const {
+  // @@protoc_insertion_point(field_get:tensorflow.HistogramProto.sum_squares)
+  return _internal_sum_squares();
+}
+inline void HistogramProto::_internal_set_sum_squares(double value) {
+  
+  _impl_.sum_squares_ = value;
+}
+inline void HistogramProto::set_sum_squares(double value) {
+  _internal_set_sum_squares(value);
+  // @@protoc_insertion_point(field_set:tensorflow.HistogramProto.sum_squares)
+}
+
+// repeated double bucket_limit = 6 [packed = true];
+inline int HistogramProto::_internal_bucket_limit_size() const {
+  return _impl_.bucket_limit_.size();
+}
+inline int HistogramProto::bucket_limit_size() const {
+  return _internal_bucket_limit_size();
+}
+inline void HistogramProto::clear_bucket_limit() {
+  _impl_.bucket_limit_.Clear();
+}
+inline double HistogramProto::_internal_bucket_limit(int index) const {
+  return _impl_.bucket_limit_.Get(index);
+}
+inline double HistogramProto::bucket_limit(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.HistogramProto.bucket_limit)
+  return _internal_bucket_limit(index);
+}
+inline void HistogramProto::set_bucket_limit(int index, double value) {
+  _impl_.bucket_limit_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.HistogramProto.bucket_limit)
+}
+inline void HistogramProto::_internal_add_bucket_limit(double value) {
+  _impl_.bucket_limit_.Add(value);
+}
+inline void HistogramProto::add_bucket_limit(double value) {
+  _internal_add_bucket_limit(value);
+  // @@protoc_insertion_point(field_add:tensorflow.HistogramProto.bucket_limit)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+HistogramProto::_internal_bucket_limit() const {
+  return _impl_.bucket_limit_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+HistogramProto::bucket_limit() const {
+  // @@protoc_insertion_point(field_list:tensorflow.HistogramProto.bucket_limit)
+  return _internal_bucket_limit();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+HistogramProto::_internal_mutable_bucket_limit() {
+  return &_impl_.bucket_limit_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+HistogramProto::mutable_bucket_limit() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.HistogramProto.bucket_limit)
+  return _internal_mutable_bucket_limit();
+}
+
+// repeated double bucket = 7 [packed = true];
+inline int HistogramProto::_internal_bucket_size() const {
+  return _impl_.bucket_.size();
+}
+inline int HistogramProto::bucket_size() const {
+  return _internal_bucket_size();
+}
+inline void HistogramProto::clear_bucket() {
+  _impl_.bucket_.Clear();
+}
+inline double HistogramProto::_internal_bucket(int index) const {
+  return _impl_.bucket_.Get(index);
+}
+inline double HistogramProto::bucket(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.HistogramProto.bucket)
+  return _internal_bucket(index);
+}
+inline void HistogramProto::set_bucket(int index, double value) {
+  _impl_.bucket_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.HistogramProto.bucket)
+}
+inline void HistogramProto::_internal_add_bucket(double value) {
+  _impl_.bucket_.Add(value);
+}
+inline void HistogramProto::add_bucket(double value) {
+  _internal_add_bucket(value);
+  // @@protoc_insertion_point(field_add:tensorflow.HistogramProto.bucket)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+HistogramProto::_internal_bucket() const {
+  return _impl_.bucket_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >&
+HistogramProto::bucket() const {
+  // @@protoc_insertion_point(field_list:tensorflow.HistogramProto.bucket)
+  return _internal_bucket();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+HistogramProto::_internal_mutable_bucket() {
+  return &_impl_.bucket_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< double >*
+HistogramProto::mutable_bucket() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.HistogramProto.bucket)
+  return _internal_mutable_bucket();
+}
+
+// -------------------------------------------------------------------
+
+// Summary_Image
+
+// int32 height = 1;
+inline void Summary_Image::clear_height() {
+  _impl_.height_ = 0;
+}
+inline int32_t Summary_Image::_internal_height() const {
+  return _impl_.height_;
+}
+inline int32_t Summary_Image::height() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Image.height)
+  return _internal_height();
+}
+inline void Summary_Image::_internal_set_height(int32_t value) {
+  
+  _impl_.height_ = value;
+}
+inline void Summary_Image::set_height(int32_t value) {
+  _internal_set_height(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Image.height)
+}
+
+// int32 width = 2;
+inline void Summary_Image::clear_width() {
+  _impl_.width_ = 0;
+}
+inline int32_t Summary_Image::_internal_width() const {
+  return _impl_.width_;
+}
+inline int32_t Summary_Image::width() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Image.width)
+  return _internal_width();
+}
+inline void Summary_Image::_internal_set_width(int32_t value) {
+  
+  _impl_.width_ = value;
+}
+inline void Summary_Image::set_width(int32_t value) {
+  _internal_set_width(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Image.width)
+}
+
+// int32 colorspace = 3;
+inline void Summary_Image::clear_colorspace() {
+  _impl_.colorspace_ = 0;
+}
+inline int32_t Summary_Image::_internal_colorspace() const {
+  return _impl_.colorspace_;
+}
+inline int32_t Summary_Image::colorspace() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Image.colorspace)
+  return _internal_colorspace();
+}
+inline void Summary_Image::_internal_set_colorspace(int32_t value) {
+  
+  _impl_.colorspace_ = value;
+}
+inline void Summary_Image::set_colorspace(int32_t value) {
+  _internal_set_colorspace(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Image.colorspace)
+}
+
+// bytes encoded_image_string = 4;
+inline void Summary_Image::clear_encoded_image_string() {
+  _impl_.encoded_image_string_.ClearToEmpty();
+}
+inline const std::string& Summary_Image::encoded_image_string() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Image.encoded_image_string)
+  return _internal_encoded_image_string();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Summary_Image::set_encoded_image_string(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.encoded_image_string_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Image.encoded_image_string)
+}
+inline std::string* Summary_Image::mutable_encoded_image_string() {
+  std::string* _s = _internal_mutable_encoded_image_string();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Image.encoded_image_string)
+  return _s;
+}
+inline const std::string& Summary_Image::_internal_encoded_image_string() const {
+  return _impl_.encoded_image_string_.Get();
+}
+inline void Summary_Image::_internal_set_encoded_image_string(const std::string& value) {
+  
+  _impl_.encoded_image_string_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Summary_Image::_internal_mutable_encoded_image_string() {
+  
+  return _impl_.encoded_image_string_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Summary_Image::release_encoded_image_string() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Image.encoded_image_string)
+  return _impl_.encoded_image_string_.Release();
+}
+inline void Summary_Image::set_allocated_encoded_image_string(std::string* encoded_image_string) {
+  if (encoded_image_string != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.encoded_image_string_.SetAllocated(encoded_image_string, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.encoded_image_string_.IsDefault()) {
+    _impl_.encoded_image_string_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Image.encoded_image_string)
+}
+
+// -------------------------------------------------------------------
+
+// Summary_Audio
+
+// float sample_rate = 1;
+inline void Summary_Audio::clear_sample_rate() {
+  _impl_.sample_rate_ = 0;
+}
+inline float Summary_Audio::_internal_sample_rate() const {
+  return _impl_.sample_rate_;
+}
+inline float Summary_Audio::sample_rate() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Audio.sample_rate)
+  return _internal_sample_rate();
+}
+inline void Summary_Audio::_internal_set_sample_rate(float value) {
+  
+  _impl_.sample_rate_ = value;
+}
+inline void Summary_Audio::set_sample_rate(float value) {
+  _internal_set_sample_rate(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Audio.sample_rate)
+}
+
+// int64 num_channels = 2;
+inline void Summary_Audio::clear_num_channels() {
+  _impl_.num_channels_ = int64_t{0};
+}
+inline int64_t Summary_Audio::_internal_num_channels() const {
+  return _impl_.num_channels_;
+}
+inline int64_t Summary_Audio::num_channels() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Audio.num_channels)
+  return _internal_num_channels();
+}
+inline void Summary_Audio::_internal_set_num_channels(int64_t value) {
+  
+  _impl_.num_channels_ = value;
+}
+inline void Summary_Audio::set_num_channels(int64_t value) {
+  _internal_set_num_channels(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Audio.num_channels)
+}
+
+// int64 length_frames = 3;
+inline void Summary_Audio::clear_length_frames() {
+  _impl_.length_frames_ = int64_t{0};
+}
+inline int64_t Summary_Audio::_internal_length_frames() const {
+  return _impl_.length_frames_;
+}
+inline int64_t Summary_Audio::length_frames() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Audio.length_frames)
+  return _internal_length_frames();
+}
+inline void Summary_Audio::_internal_set_length_frames(int64_t value) {
+  
+  _impl_.length_frames_ = value;
+}
+inline void Summary_Audio::set_length_frames(int64_t value) {
+  _internal_set_length_frames(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Audio.length_frames)
+}
+
+// bytes encoded_audio_string = 4;
+inline void Summary_Audio::clear_encoded_audio_string() {
+  _impl_.encoded_audio_string_.ClearToEmpty();
+}
+inline const std::string& Summary_Audio::encoded_audio_string() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Audio.encoded_audio_string)
+  return _internal_encoded_audio_string();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Summary_Audio::set_encoded_audio_string(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.encoded_audio_string_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Audio.encoded_audio_string)
+}
+inline std::string* Summary_Audio::mutable_encoded_audio_string() {
+  std::string* _s = _internal_mutable_encoded_audio_string();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Audio.encoded_audio_string)
+  return _s;
+}
+inline const std::string& Summary_Audio::_internal_encoded_audio_string() const {
+  return _impl_.encoded_audio_string_.Get();
+}
+inline void Summary_Audio::_internal_set_encoded_audio_string(const std::string& value) {
+  
+  _impl_.encoded_audio_string_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Summary_Audio::_internal_mutable_encoded_audio_string() {
+  
+  return _impl_.encoded_audio_string_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Summary_Audio::release_encoded_audio_string() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Audio.encoded_audio_string)
+  return _impl_.encoded_audio_string_.Release();
+}
+inline void Summary_Audio::set_allocated_encoded_audio_string(std::string* encoded_audio_string) {
+  if (encoded_audio_string != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.encoded_audio_string_.SetAllocated(encoded_audio_string, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.encoded_audio_string_.IsDefault()) {
+    _impl_.encoded_audio_string_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Audio.encoded_audio_string)
+}
+
+// string content_type = 5;
+inline void Summary_Audio::clear_content_type() {
+  _impl_.content_type_.ClearToEmpty();
+}
+inline const std::string& Summary_Audio::content_type() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Audio.content_type)
+  return _internal_content_type();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Summary_Audio::set_content_type(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.content_type_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Audio.content_type)
+}
+inline std::string* Summary_Audio::mutable_content_type() {
+  std::string* _s = _internal_mutable_content_type();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Audio.content_type)
+  return _s;
+}
+inline const std::string& Summary_Audio::_internal_content_type() const {
+  return _impl_.content_type_.Get();
+}
+inline void Summary_Audio::_internal_set_content_type(const std::string& value) {
+  
+  _impl_.content_type_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Summary_Audio::_internal_mutable_content_type() {
+  
+  return _impl_.content_type_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Summary_Audio::release_content_type() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Audio.content_type)
+  return _impl_.content_type_.Release();
+}
+inline void Summary_Audio::set_allocated_content_type(std::string* content_type) {
+  if (content_type != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.content_type_.SetAllocated(content_type, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.content_type_.IsDefault()) {
+    _impl_.content_type_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Audio.content_type)
+}
+
+// -------------------------------------------------------------------
+
+// Summary_Value
+
+// string node_name = 7;
+inline void Summary_Value::clear_node_name() {
+  _impl_.node_name_.ClearToEmpty();
+}
+inline const std::string& Summary_Value::node_name() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Value.node_name)
+  return _internal_node_name();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Summary_Value::set_node_name(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.node_name_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Value.node_name)
+}
+inline std::string* Summary_Value::mutable_node_name() {
+  std::string* _s = _internal_mutable_node_name();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Value.node_name)
+  return _s;
+}
+inline const std::string& Summary_Value::_internal_node_name() const {
+  return _impl_.node_name_.Get();
+}
+inline void Summary_Value::_internal_set_node_name(const std::string& value) {
+  
+  _impl_.node_name_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Summary_Value::_internal_mutable_node_name() {
+  
+  return _impl_.node_name_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Summary_Value::release_node_name() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Value.node_name)
+  return _impl_.node_name_.Release();
+}
+inline void Summary_Value::set_allocated_node_name(std::string* node_name) {
+  if (node_name != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.node_name_.SetAllocated(node_name, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.node_name_.IsDefault()) {
+    _impl_.node_name_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Value.node_name)
+}
+
+// string tag = 1;
+inline void Summary_Value::clear_tag() {
+  _impl_.tag_.ClearToEmpty();
+}
+inline const std::string& Summary_Value::tag() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Value.tag)
+  return _internal_tag();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Summary_Value::set_tag(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.tag_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Value.tag)
+}
+inline std::string* Summary_Value::mutable_tag() {
+  std::string* _s = _internal_mutable_tag();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Value.tag)
+  return _s;
+}
+inline const std::string& Summary_Value::_internal_tag() const {
+  return _impl_.tag_.Get();
+}
+inline void Summary_Value::_internal_set_tag(const std::string& value) {
+  
+  _impl_.tag_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Summary_Value::_internal_mutable_tag() {
+  
+  return _impl_.tag_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Summary_Value::release_tag() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Value.tag)
+  return _impl_.tag_.Release();
+}
+inline void Summary_Value::set_allocated_tag(std::string* tag) {
+  if (tag != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.tag_.SetAllocated(tag, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.tag_.IsDefault()) {
+    _impl_.tag_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Value.tag)
+}
+
+// float simple_value = 2;
+inline bool Summary_Value::_internal_has_simple_value() const {
+  return value_case() == kSimpleValue;
+}
+inline bool Summary_Value::has_simple_value() const {
+  return _internal_has_simple_value();
+}
+inline void Summary_Value::set_has_simple_value() {
+  _impl_._oneof_case_[0] = kSimpleValue;
+}
+inline void Summary_Value::clear_simple_value() {
+  if (_internal_has_simple_value()) {
+    _impl_.value_.simple_value_ = 0;
+    clear_has_value();
+  }
+}
+inline float Summary_Value::_internal_simple_value() const {
+  if (_internal_has_simple_value()) {
+    return _impl_.value_.simple_value_;
+  }
+  return 0;
+}
+inline void Summary_Value::_internal_set_simple_value(float value) {
+  if (!_internal_has_simple_value()) {
+    clear_value();
+    set_has_simple_value();
+  }
+  _impl_.value_.simple_value_ = value;
+}
+inline float Summary_Value::simple_value() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Value.simple_value)
+  return _internal_simple_value();
+}
+inline void Summary_Value::set_simple_value(float value) {
+  _internal_set_simple_value(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Value.simple_value)
+}
+
+// bytes obsolete_old_style_histogram = 3;
+inline bool Summary_Value::_internal_has_obsolete_old_style_histogram() const {
+  return value_case() == kObsoleteOldStyleHistogram;
+}
+inline bool Summary_Value::has_obsolete_old_style_histogram() const {
+  return _internal_has_obsolete_old_style_histogram();
+}
+inline void Summary_Value::set_has_obsolete_old_style_histogram() {
+  _impl_._oneof_case_[0] = kObsoleteOldStyleHistogram;
+}
+inline void Summary_Value::clear_obsolete_old_style_histogram() {
+  if (_internal_has_obsolete_old_style_histogram()) {
+    _impl_.value_.obsolete_old_style_histogram_.Destroy();
+    clear_has_value();
+  }
+}
+inline const std::string& Summary_Value::obsolete_old_style_histogram() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Value.obsolete_old_style_histogram)
+  return _internal_obsolete_old_style_histogram();
+}
+template <typename ArgT0, typename... ArgT>
+inline void Summary_Value::set_obsolete_old_style_histogram(ArgT0&& arg0, ArgT... args) {
+  if (!_internal_has_obsolete_old_style_histogram()) {
+    clear_value();
+    set_has_obsolete_old_style_histogram();
+    _impl_.value_.obsolete_old_style_histogram_.InitDefault();
+  }
+  _impl_.value_.obsolete_old_style_histogram_.SetBytes( static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Summary.Value.obsolete_old_style_histogram)
+}
+inline std::string* Summary_Value::mutable_obsolete_old_style_histogram() {
+  std::string* _s = _internal_mutable_obsolete_old_style_histogram();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Value.obsolete_old_style_histogram)
+  return _s;
+}
+inline const std::string& Summary_Value::_internal_obsolete_old_style_histogram() const {
+  if (_internal_has_obsolete_old_style_histogram()) {
+    return _impl_.value_.obsolete_old_style_histogram_.Get();
+  }
+  return ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited();
+}
+inline void Summary_Value::_internal_set_obsolete_old_style_histogram(const std::string& value) {
+  if (!_internal_has_obsolete_old_style_histogram()) {
+    clear_value();
+    set_has_obsolete_old_style_histogram();
+    _impl_.value_.obsolete_old_style_histogram_.InitDefault();
+  }
+  _impl_.value_.obsolete_old_style_histogram_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Summary_Value::_internal_mutable_obsolete_old_style_histogram() {
+  if (!_internal_has_obsolete_old_style_histogram()) {
+    clear_value();
+    set_has_obsolete_old_style_histogram();
+    _impl_.value_.obsolete_old_style_histogram_.InitDefault();
+  }
+  return _impl_.value_.obsolete_old_style_histogram_.Mutable(      GetArenaForAllocation());
+}
+inline std::string* Summary_Value::release_obsolete_old_style_histogram() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Value.obsolete_old_style_histogram)
+  if (_internal_has_obsolete_old_style_histogram()) {
+    clear_has_value();
+    return _impl_.value_.obsolete_old_style_histogram_.Release();
+  } else {
+    return nullptr;
+  }
+}
+inline void Summary_Value::set_allocated_obsolete_old_style_histogram(std::string* obsolete_old_style_histogram) {
+  if (has_value()) {
+    clear_value();
+  }
+  if (obsolete_old_style_histogram != nullptr) {
+    set_has_obsolete_old_style_histogram();
+    _impl_.value_.obsolete_old_style_histogram_.InitAllocated(obsolete_old_style_histogram, GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Summary.Value.obsolete_old_style_histogram)
+}
+
+// .tensorflow.Summary.Image image = 4;
+inline bool Summary_Value::_internal_has_image() const {
+  return value_case() == kImage;
+}
+inline bool Summary_Value::has_image() const {
+  return _internal_has_image();
+}
+inline void Summary_Value::set_has_image() {
+  _impl_._oneof_case_[0] = kImage;
+}
+inline void Summary_Value::clear_image() {
+  if (_internal_has_image()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.value_.image_;
+    }
+    clear_has_value();
+  }
+}
+inline ::tensorflow::Summary_Image* Summary_Value::release_image() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Value.image)
+  if (_internal_has_image()) {
+    clear_has_value();
+    ::tensorflow::Summary_Image* temp = _impl_.value_.image_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.value_.image_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::Summary_Image& Summary_Value::_internal_image() const {
+  return _internal_has_image()
+      ? *_impl_.value_.image_
+      : reinterpret_cast< ::tensorflow::Summary_Image&>(::tensorflow::_Summary_Image_default_instance_);
+}
+inline const ::tensorflow::Summary_Image& Summary_Value::image() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Value.image)
+  return _internal_image();
+}
+inline ::tensorflow::Summary_Image* Summary_Value::unsafe_arena_release_image() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.Summary.Value.image)
+  if (_internal_has_image()) {
+    clear_has_value();
+    ::tensorflow::Summary_Image* temp = _impl_.value_.image_;
+    _impl_.value_.image_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Summary_Value::unsafe_arena_set_allocated_image(::tensorflow::Summary_Image* image) {
+  clear_value();
+  if (image) {
+    set_has_image();
+    _impl_.value_.image_ = image;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.Summary.Value.image)
+}
+inline ::tensorflow::Summary_Image* Summary_Value::_internal_mutable_image() {
+  if (!_internal_has_image()) {
+    clear_value();
+    set_has_image();
+    _impl_.value_.image_ = CreateMaybeMessage< ::tensorflow::Summary_Image >(GetArenaForAllocation());
+  }
+  return _impl_.value_.image_;
+}
+inline ::tensorflow::Summary_Image* Summary_Value::mutable_image() {
+  ::tensorflow::Summary_Image* _msg = _internal_mutable_image();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Value.image)
+  return _msg;
+}
+
+// .tensorflow.HistogramProto histo = 5;
+inline bool Summary_Value::_internal_has_histo() const {
+  return value_case() == kHisto;
+}
+inline bool Summary_Value::has_histo() const {
+  return _internal_has_histo();
+}
+inline void Summary_Value::set_has_histo() {
+  _impl_._oneof_case_[0] = kHisto;
+}
+inline void Summary_Value::clear_histo() {
+  if (_internal_has_histo()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.value_.histo_;
+    }
+    clear_has_value();
+  }
+}
+inline ::tensorflow::HistogramProto* Summary_Value::release_histo() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Value.histo)
+  if (_internal_has_histo()) {
+    clear_has_value();
+    ::tensorflow::HistogramProto* temp = _impl_.value_.histo_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.value_.histo_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::HistogramProto& Summary_Value::_internal_histo() const {
+  return _internal_has_histo()
+      ? *_impl_.value_.histo_
+      : reinterpret_cast< ::tensorflow::HistogramProto&>(::tensorflow::_HistogramProto_default_instance_);
+}
+inline const ::tensorflow::HistogramProto& Summary_Value::histo() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Value.histo)
+  return _internal_histo();
+}
+inline ::tensorflow::HistogramProto* Summary_Value::unsafe_arena_release_histo() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.Summary.Value.histo)
+  if (_internal_has_histo()) {
+    clear_has_value();
+    ::tensorflow::HistogramProto* temp = _impl_.value_.histo_;
+    _impl_.value_.histo_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Summary_Value::unsafe_arena_set_allocated_histo(::tensorflow::HistogramProto* histo) {
+  clear_value();
+  if (histo) {
+    set_has_histo();
+    _impl_.value_.histo_ = histo;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.Summary.Value.histo)
+}
+inline ::tensorflow::HistogramProto* Summary_Value::_internal_mutable_histo() {
+  if (!_internal_has_histo()) {
+    clear_value();
+    set_has_histo();
+    _impl_.value_.histo_ = CreateMaybeMessage< ::tensorflow::HistogramProto >(GetArenaForAllocation());
+  }
+  return _impl_.value_.histo_;
+}
+inline ::tensorflow::HistogramProto* Summary_Value::mutable_histo() {
+  ::tensorflow::HistogramProto* _msg = _internal_mutable_histo();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Value.histo)
+  return _msg;
+}
+
+// .tensorflow.Summary.Audio audio = 6;
+inline bool Summary_Value::_internal_has_audio() const {
+  return value_case() == kAudio;
+}
+inline bool Summary_Value::has_audio() const {
+  return _internal_has_audio();
+}
+inline void Summary_Value::set_has_audio() {
+  _impl_._oneof_case_[0] = kAudio;
+}
+inline void Summary_Value::clear_audio() {
+  if (_internal_has_audio()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.value_.audio_;
+    }
+    clear_has_value();
+  }
+}
+inline ::tensorflow::Summary_Audio* Summary_Value::release_audio() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Value.audio)
+  if (_internal_has_audio()) {
+    clear_has_value();
+    ::tensorflow::Summary_Audio* temp = _impl_.value_.audio_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.value_.audio_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::Summary_Audio& Summary_Value::_internal_audio() const {
+  return _internal_has_audio()
+      ? *_impl_.value_.audio_
+      : reinterpret_cast< ::tensorflow::Summary_Audio&>(::tensorflow::_Summary_Audio_default_instance_);
+}
+inline const ::tensorflow::Summary_Audio& Summary_Value::audio() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Value.audio)
+  return _internal_audio();
+}
+inline ::tensorflow::Summary_Audio* Summary_Value::unsafe_arena_release_audio() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.Summary.Value.audio)
+  if (_internal_has_audio()) {
+    clear_has_value();
+    ::tensorflow::Summary_Audio* temp = _impl_.value_.audio_;
+    _impl_.value_.audio_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Summary_Value::unsafe_arena_set_allocated_audio(::tensorflow::Summary_Audio* audio) {
+  clear_value();
+  if (audio) {
+    set_has_audio();
+    _impl_.value_.audio_ = audio;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.Summary.Value.audio)
+}
+inline ::tensorflow::Summary_Audio* Summary_Value::_internal_mutable_audio() {
+  if (!_internal_has_audio()) {
+    clear_value();
+    set_has_audio();
+    _impl_.value_.audio_ = CreateMaybeMessage< ::tensorflow::Summary_Audio >(GetArenaForAllocation());
+  }
+  return _impl_.value_.audio_;
+}
+inline ::tensorflow::Summary_Audio* Summary_Value::mutable_audio() {
+  ::tensorflow::Summary_Audio* _msg = _internal_mutable_audio();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Value.audio)
+  return _msg;
+}
+
+// .tensorflow.TensorProto tensor = 8;
+inline bool Summary_Value::_internal_has_tensor() const {
+  return value_case() == kTensor;
+}
+inline bool Summary_Value::has_tensor() const {
+  return _internal_has_tensor();
+}
+inline void Summary_Value::set_has_tensor() {
+  _impl_._oneof_case_[0] = kTensor;
+}
+inline void Summary_Value::clear_tensor() {
+  if (_internal_has_tensor()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.value_.tensor_;
+    }
+    clear_has_value();
+  }
+}
+inline ::tensorflow::TensorProto* Summary_Value::release_tensor() {
+  // @@protoc_insertion_point(field_release:tensorflow.Summary.Value.tensor)
+  if (_internal_has_tensor()) {
+    clear_has_value();
+    ::tensorflow::TensorProto* temp = _impl_.value_.tensor_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.value_.tensor_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::TensorProto& Summary_Value::_internal_tensor() const {
+  return _internal_has_tensor()
+      ? *_impl_.value_.tensor_
+      : reinterpret_cast< ::tensorflow::TensorProto&>(::tensorflow::_TensorProto_default_instance_);
+}
+inline const ::tensorflow::TensorProto& Summary_Value::tensor() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.Value.tensor)
+  return _internal_tensor();
+}
+inline ::tensorflow::TensorProto* Summary_Value::unsafe_arena_release_tensor() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.Summary.Value.tensor)
+  if (_internal_has_tensor()) {
+    clear_has_value();
+    ::tensorflow::TensorProto* temp = _impl_.value_.tensor_;
+    _impl_.value_.tensor_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Summary_Value::unsafe_arena_set_allocated_tensor(::tensorflow::TensorProto* tensor) {
+  clear_value();
+  if (tensor) {
+    set_has_tensor();
+    _impl_.value_.tensor_ = tensor;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.Summary.Value.tensor)
+}
+inline ::tensorflow::TensorProto* Summary_Value::_internal_mutable_tensor() {
+  if (!_internal_has_tensor()) {
+    clear_value();
+    set_has_tensor();
+    _impl_.value_.tensor_ = CreateMaybeMessage< ::tensorflow::TensorProto >(GetArenaForAllocation());
+  }
+  return _impl_.value_.tensor_;
+}
+inline ::tensorflow::TensorProto* Summary_Value::mutable_tensor() {
+  ::tensorflow::TensorProto* _msg = _internal_mutable_tensor();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.Value.tensor)
+  return _msg;
+}
+
+inline bool Summary_Value::has_value() const {
+  return value_case() != VALUE_NOT_SET;
+}
+inline void Summary_Value::clear_has_value() {
+  _impl_._oneof_case_[0] = VALUE_NOT_SET;
+}
+inline Summary_Value::ValueCase Summary_Value::value_case() const {
+  return Summary_Value::ValueCase(_impl_._oneof_case_[0]);
+}
+// -------------------------------------------------------------------
+
+// Summary
+
+// repeated .tensorflow.Summary.Value value = 1;
+inline int Summary::_internal_value_size() const {
+  return _impl_.value_.size();
+}
+inline int Summary::value_size() const {
+  return _internal_value_size();
+}
+inline void Summary::clear_value() {
+  _impl_.value_.Clear();
+}
+inline ::tensorflow::Summary_Value* Summary::mutable_value(int index) {
+  // @@protoc_insertion_point(field_mutable:tensorflow.Summary.value)
+  return _impl_.value_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::Summary_Value >*
+Summary::mutable_value() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.Summary.value)
+  return &_impl_.value_;
+}
+inline const ::tensorflow::Summary_Value& Summary::_internal_value(int index) const {
+  return _impl_.value_.Get(index);
+}
+inline const ::tensorflow::Summary_Value& Summary::value(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.Summary.value)
+  return _internal_value(index);
+}
+inline ::tensorflow::Summary_Value* Summary::_internal_add_value() {
+  return _impl_.value_.Add();
+}
+inline ::tensorflow::Summary_Value* Summary::add_value() {
+  ::tensorflow::Summary_Value* _add = _internal_add_value();
+  // @@protoc_insertion_point(field_add:tensorflow.Summary.value)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::Summary_Value >&
+Summary::value() const {
+  // @@protoc_insertion_point(field_list:tensorflow.Summary.value)
+  return _impl_.value_;
+}
+
+// -------------------------------------------------------------------
+
+// AttrValue_ListValue
+
+// repeated bytes s = 2;
+inline int AttrValue_ListValue::_internal_s_size() const {
+  return _impl_.s_.size();
+}
+inline int AttrValue_ListValue::s_size() const {
+  return _internal_s_size();
+}
+inline void AttrValue_ListValue::clear_s() {
+  _impl_.s_.Clear();
+}
+inline std::string* AttrValue_ListValue::add_s() {
+  std::string* _s = _internal_add_s();
+  // @@protoc_insertion_point(field_add_mutable:tensorflow.AttrValue.ListValue.s)
+  return _s;
+}
+inline const std::string& AttrValue_ListValue::_internal_s(int index) const {
+  return _impl_.s_.Get(index);
+}
+inline const std::string& AttrValue_ListValue::s(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.ListValue.s)
+  return _internal_s(index);
+}
+inline std::string* AttrValue_ListValue::mutable_s(int index) {
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.ListValue.s)
+  return _impl_.s_.Mutable(index);
+}
+inline void AttrValue_ListValue::set_s(int index, const std::string& value) {
+  _impl_.s_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.ListValue.s)
+}
+inline void AttrValue_ListValue::set_s(int index, std::string&& value) {
+  _impl_.s_.Mutable(index)->assign(std::move(value));
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.ListValue.s)
+}
+inline void AttrValue_ListValue::set_s(int index, const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  _impl_.s_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set_char:tensorflow.AttrValue.ListValue.s)
+}
+inline void AttrValue_ListValue::set_s(int index, const void* value, size_t size) {
+  _impl_.s_.Mutable(index)->assign(
+    reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:tensorflow.AttrValue.ListValue.s)
+}
+inline std::string* AttrValue_ListValue::_internal_add_s() {
+  return _impl_.s_.Add();
+}
+inline void AttrValue_ListValue::add_s(const std::string& value) {
+  _impl_.s_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add:tensorflow.AttrValue.ListValue.s)
+}
+inline void AttrValue_ListValue::add_s(std::string&& value) {
+  _impl_.s_.Add(std::move(value));
+  // @@protoc_insertion_point(field_add:tensorflow.AttrValue.ListValue.s)
+}
+inline void AttrValue_ListValue::add_s(const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  _impl_.s_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add_char:tensorflow.AttrValue.ListValue.s)
+}
+inline void AttrValue_ListValue::add_s(const void* value, size_t size) {
+  _impl_.s_.Add()->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_add_pointer:tensorflow.AttrValue.ListValue.s)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>&
+AttrValue_ListValue::s() const {
+  // @@protoc_insertion_point(field_list:tensorflow.AttrValue.ListValue.s)
+  return _impl_.s_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>*
+AttrValue_ListValue::mutable_s() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.AttrValue.ListValue.s)
+  return &_impl_.s_;
+}
+
+// repeated int64 i = 3 [packed = true];
+inline int AttrValue_ListValue::_internal_i_size() const {
+  return _impl_.i_.size();
+}
+inline int AttrValue_ListValue::i_size() const {
+  return _internal_i_size();
+}
+inline void AttrValue_ListValue::clear_i() {
+  _impl_.i_.Clear();
+}
+inline int64_t AttrValue_ListValue::_internal_i(int index) const {
+  return _impl_.i_.Get(index);
+}
+inline int64_t AttrValue_ListValue::i(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.ListValue.i)
+  return _internal_i(index);
+}
+inline void AttrValue_ListValue::set_i(int index, int64_t value) {
+  _impl_.i_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.ListValue.i)
+}
+inline void AttrValue_ListValue::_internal_add_i(int64_t value) {
+  _impl_.i_.Add(value);
+}
+inline void AttrValue_ListValue::add_i(int64_t value) {
+  _internal_add_i(value);
+  // @@protoc_insertion_point(field_add:tensorflow.AttrValue.ListValue.i)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+AttrValue_ListValue::_internal_i() const {
+  return _impl_.i_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+AttrValue_ListValue::i() const {
+  // @@protoc_insertion_point(field_list:tensorflow.AttrValue.ListValue.i)
+  return _internal_i();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+AttrValue_ListValue::_internal_mutable_i() {
+  return &_impl_.i_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+AttrValue_ListValue::mutable_i() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.AttrValue.ListValue.i)
+  return _internal_mutable_i();
+}
+
+// repeated float f = 4 [packed = true];
+inline int AttrValue_ListValue::_internal_f_size() const {
+  return _impl_.f_.size();
+}
+inline int AttrValue_ListValue::f_size() const {
+  return _internal_f_size();
+}
+inline void AttrValue_ListValue::clear_f() {
+  _impl_.f_.Clear();
+}
+inline float AttrValue_ListValue::_internal_f(int index) const {
+  return _impl_.f_.Get(index);
+}
+inline float AttrValue_ListValue::f(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.ListValue.f)
+  return _internal_f(index);
+}
+inline void AttrValue_ListValue::set_f(int index, float value) {
+  _impl_.f_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.ListValue.f)
+}
+inline void AttrValue_ListValue::_internal_add_f(float value) {
+  _impl_.f_.Add(value);
+}
+inline void AttrValue_ListValue::add_f(float value) {
+  _internal_add_f(value);
+  // @@protoc_insertion_point(field_add:tensorflow.AttrValue.ListValue.f)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+AttrValue_ListValue::_internal_f() const {
+  return _impl_.f_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+AttrValue_ListValue::f() const {
+  // @@protoc_insertion_point(field_list:tensorflow.AttrValue.ListValue.f)
+  return _internal_f();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+AttrValue_ListValue::_internal_mutable_f() {
+  return &_impl_.f_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+AttrValue_ListValue::mutable_f() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.AttrValue.ListValue.f)
+  return _internal_mutable_f();
+}
+
+// repeated bool b = 5 [packed = true];
+inline int AttrValue_ListValue::_internal_b_size() const {
+  return _impl_.b_.size();
+}
+inline int AttrValue_ListValue::b_size() const {
+  return _internal_b_size();
+}
+inline void AttrValue_ListValue::clear_b() {
+  _impl_.b_.Clear();
+}
+inline bool AttrValue_ListValue::_internal_b(int index) const {
+  return _impl_.b_.Get(index);
+}
+inline bool AttrValue_ListValue::b(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.ListValue.b)
+  return _internal_b(index);
+}
+inline void AttrValue_ListValue::set_b(int index, bool value) {
+  _impl_.b_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.ListValue.b)
+}
+inline void AttrValue_ListValue::_internal_add_b(bool value) {
+  _impl_.b_.Add(value);
+}
+inline void AttrValue_ListValue::add_b(bool value) {
+  _internal_add_b(value);
+  // @@protoc_insertion_point(field_add:tensorflow.AttrValue.ListValue.b)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+AttrValue_ListValue::_internal_b() const {
+  return _impl_.b_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+AttrValue_ListValue::b() const {
+  // @@protoc_insertion_point(field_list:tensorflow.AttrValue.ListValue.b)
+  return _internal_b();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+AttrValue_ListValue::_internal_mutable_b() {
+  return &_impl_.b_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+AttrValue_ListValue::mutable_b() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.AttrValue.ListValue.b)
+  return _internal_mutable_b();
+}
+
+// repeated .tensorflow.DataType type = 6 [packed = true];
+inline int AttrValue_ListValue::_internal_type_size() const {
+  return _impl_.type_.size();
+}
+inline int AttrValue_ListValue::type_size() const {
+  return _internal_type_size();
+}
+inline void AttrValue_ListValue::clear_type() {
+  _impl_.type_.Clear();
+}
+inline ::tensorflow::DataType AttrValue_ListValue::_internal_type(int index) const {
+  return static_cast< ::tensorflow::DataType >(_impl_.type_.Get(index));
+}
+inline ::tensorflow::DataType AttrValue_ListValue::type(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.ListValue.type)
+  return _internal_type(index);
+}
+inline void AttrValue_ListValue::set_type(int index, ::tensorflow::DataType value) {
+  _impl_.type_.Set(index, value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.ListValue.type)
+}
+inline void AttrValue_ListValue::_internal_add_type(::tensorflow::DataType value) {
+  _impl_.type_.Add(value);
+}
+inline void AttrValue_ListValue::add_type(::tensorflow::DataType value) {
+  _internal_add_type(value);
+  // @@protoc_insertion_point(field_add:tensorflow.AttrValue.ListValue.type)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField<int>&
+AttrValue_ListValue::type() const {
+  // @@protoc_insertion_point(field_list:tensorflow.AttrValue.ListValue.type)
+  return _impl_.type_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField<int>*
+AttrValue_ListValue::_internal_mutable_type() {
+  return &_impl_.type_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField<int>*
+AttrValue_ListValue::mutable_type() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.AttrValue.ListValue.type)
+  return _internal_mutable_type();
+}
+
+// repeated .tensorflow.TensorShapeProto shape = 7;
+inline int AttrValue_ListValue::_internal_shape_size() const {
+  return _impl_.shape_.size();
+}
+inline int AttrValue_ListValue::shape_size() const {
+  return _internal_shape_size();
+}
+inline void AttrValue_ListValue::clear_shape() {
+  _impl_.shape_.Clear();
+}
+inline ::tensorflow::TensorShapeProto* AttrValue_ListValue::mutable_shape(int index) {
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.ListValue.shape)
+  return _impl_.shape_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto >*
+AttrValue_ListValue::mutable_shape() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.AttrValue.ListValue.shape)
+  return &_impl_.shape_;
+}
+inline const ::tensorflow::TensorShapeProto& AttrValue_ListValue::_internal_shape(int index) const {
+  return _impl_.shape_.Get(index);
+}
+inline const ::tensorflow::TensorShapeProto& AttrValue_ListValue::shape(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.ListValue.shape)
+  return _internal_shape(index);
+}
+inline ::tensorflow::TensorShapeProto* AttrValue_ListValue::_internal_add_shape() {
+  return _impl_.shape_.Add();
+}
+inline ::tensorflow::TensorShapeProto* AttrValue_ListValue::add_shape() {
+  ::tensorflow::TensorShapeProto* _add = _internal_add_shape();
+  // @@protoc_insertion_point(field_add:tensorflow.AttrValue.ListValue.shape)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorShapeProto >&
+AttrValue_ListValue::shape() const {
+  // @@protoc_insertion_point(field_list:tensorflow.AttrValue.ListValue.shape)
+  return _impl_.shape_;
+}
+
+// repeated .tensorflow.TensorProto tensor = 8;
+inline int AttrValue_ListValue::_internal_tensor_size() const {
+  return _impl_.tensor_.size();
+}
+inline int AttrValue_ListValue::tensor_size() const {
+  return _internal_tensor_size();
+}
+inline void AttrValue_ListValue::clear_tensor() {
+  _impl_.tensor_.Clear();
+}
+inline ::tensorflow::TensorProto* AttrValue_ListValue::mutable_tensor(int index) {
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.ListValue.tensor)
+  return _impl_.tensor_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorProto >*
+AttrValue_ListValue::mutable_tensor() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.AttrValue.ListValue.tensor)
+  return &_impl_.tensor_;
+}
+inline const ::tensorflow::TensorProto& AttrValue_ListValue::_internal_tensor(int index) const {
+  return _impl_.tensor_.Get(index);
+}
+inline const ::tensorflow::TensorProto& AttrValue_ListValue::tensor(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.ListValue.tensor)
+  return _internal_tensor(index);
+}
+inline ::tensorflow::TensorProto* AttrValue_ListValue::_internal_add_tensor() {
+  return _impl_.tensor_.Add();
+}
+inline ::tensorflow::TensorProto* AttrValue_ListValue::add_tensor() {
+  ::tensorflow::TensorProto* _add = _internal_add_tensor();
+  // @@protoc_insertion_point(field_add:tensorflow.AttrValue.ListValue.tensor)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::TensorProto >&
+AttrValue_ListValue::tensor() const {
+  // @@protoc_insertion_point(field_list:tensorflow.AttrValue.ListValue.tensor)
+  return _impl_.tensor_;
+}
+
+// -------------------------------------------------------------------
+
+// AttrValue
+
+// bytes s = 2;
+inline bool AttrValue::_internal_has_s() const {
+  return value_case() == kS;
+}
+inline bool AttrValue::has_s() const {
+  return _internal_has_s();
+}
+inline void AttrValue::set_has_s() {
+  _impl_._oneof_case_[0] = kS;
+}
+inline void AttrValue::clear_s() {
+  if (_internal_has_s()) {
+    _impl_.value_.s_.Destroy();
+    clear_has_value();
+  }
+}
+inline const std::string& AttrValue::s() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.s)
+  return _internal_s();
+}
+template <typename ArgT0, typename... ArgT>
+inline void AttrValue::set_s(ArgT0&& arg0, ArgT... args) {
+  if (!_internal_has_s()) {
+    clear_value();
+    set_has_s();
+    _impl_.value_.s_.InitDefault();
+  }
+  _impl_.value_.s_.SetBytes( static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.s)
+}
+inline std::string* AttrValue::mutable_s() {
+  std::string* _s = _internal_mutable_s();
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.s)
+  return _s;
+}
+inline const std::string& AttrValue::_internal_s() const {
+  if (_internal_has_s()) {
+    return _impl_.value_.s_.Get();
+  }
+  return ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited();
+}
+inline void AttrValue::_internal_set_s(const std::string& value) {
+  if (!_internal_has_s()) {
+    clear_value();
+    set_has_s();
+    _impl_.value_.s_.InitDefault();
+  }
+  _impl_.value_.s_.Set(value, GetArenaForAllocation());
+}
+inline std::string* AttrValue::_internal_mutable_s() {
+  if (!_internal_has_s()) {
+    clear_value();
+    set_has_s();
+    _impl_.value_.s_.InitDefault();
+  }
+  return _impl_.value_.s_.Mutable(      GetArenaForAllocation());
+}
+inline std::string* AttrValue::release_s() {
+  // @@protoc_insertion_point(field_release:tensorflow.AttrValue.s)
+  if (_internal_has_s()) {
+    clear_has_value();
+    return _impl_.value_.s_.Release();
+  } else {
+    return nullptr;
+  }
+}
+inline void AttrValue::set_allocated_s(std::string* s) {
+  if (has_value()) {
+    clear_value();
+  }
+  if (s != nullptr) {
+    set_has_s();
+    _impl_.value_.s_.InitAllocated(s, GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.AttrValue.s)
+}
+
+// int64 i = 3;
+inline bool AttrValue::_internal_has_i() const {
+  return value_case() == kI;
+}
+inline bool AttrValue::has_i() const {
+  return _internal_has_i();
+}
+inline void AttrValue::set_has_i() {
+  _impl_._oneof_case_[0] = kI;
+}
+inline void AttrValue::clear_i() {
+  if (_internal_has_i()) {
+    _impl_.value_.i_ = int64_t{0};
+    clear_has_value();
+  }
+}
+inline int64_t AttrValue::_internal_i() const {
+  if (_internal_has_i()) {
+    return _impl_.value_.i_;
+  }
+  return int64_t{0};
+}
+inline void AttrValue::_internal_set_i(int64_t value) {
+  if (!_internal_has_i()) {
+    clear_value();
+    set_has_i();
+  }
+  _impl_.value_.i_ = value;
+}
+inline int64_t AttrValue::i() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.i)
+  return _internal_i();
+}
+inline void AttrValue::set_i(int64_t value) {
+  _internal_set_i(value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.i)
+}
+
+// float f = 4;
+inline bool AttrValue::_internal_has_f() const {
+  return value_case() == kF;
+}
+inline bool AttrValue::has_f() const {
+  return _internal_has_f();
+}
+inline void AttrValue::set_has_f() {
+  _impl_._oneof_case_[0] = kF;
+}
+inline void AttrValue::clear_f() {
+  if (_internal_has_f()) {
+    _impl_.value_.f_ = 0;
+    clear_has_value();
+  }
+}
+inline float AttrValue::_internal_f() const {
+  if (_internal_has_f()) {
+    return _impl_.value_.f_;
+  }
+  return 0;
+}
+inline void AttrValue::_internal_set_f(float value) {
+  if (!_internal_has_f()) {
+    clear_value();
+    set_has_f();
+  }
+  _impl_.value_.f_ = value;
+}
+inline float AttrValue::f() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.f)
+  return _internal_f();
+}
+inline void AttrValue::set_f(float value) {
+  _internal_set_f(value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.f)
+}
+
+// bool b = 5;
+inline bool AttrValue::_internal_has_b() const {
+  return value_case() == kB;
+}
+inline bool AttrValue::has_b() const {
+  return _internal_has_b();
+}
+inline void AttrValue::set_has_b() {
+  _impl_._oneof_case_[0] = kB;
+}
+inline void AttrValue::clear_b() {
+  if (_internal_has_b()) {
+    _impl_.value_.b_ = false;
+    clear_has_value();
+  }
+}
+inline bool AttrValue::_internal_b() const {
+  if (_internal_has_b()) {
+    return _impl_.value_.b_;
+  }
+  return false;
+}
+inline void AttrValue::_internal_set_b(bool value) {
+  if (!_internal_has_b()) {
+    clear_value();
+    set_has_b();
+  }
+  _impl_.value_.b_ = value;
+}
+inline bool AttrValue::b() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.b)
+  return _internal_b();
+}
+inline void AttrValue::set_b(bool value) {
+  _internal_set_b(value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.b)
+}
+
+// .tensorflow.DataType type = 6;
+inline bool AttrValue::_internal_has_type() const {
+  return value_case() == kType;
+}
+inline bool AttrValue::has_type() const {
+  return _internal_has_type();
+}
+inline void AttrValue::set_has_type() {
+  _impl_._oneof_case_[0] = kType;
+}
+inline void AttrValue::clear_type() {
+  if (_internal_has_type()) {
+    _impl_.value_.type_ = 0;
+    clear_has_value();
+  }
+}
+inline ::tensorflow::DataType AttrValue::_internal_type() const {
+  if (_internal_has_type()) {
+    return static_cast< ::tensorflow::DataType >(_impl_.value_.type_);
+  }
+  return static_cast< ::tensorflow::DataType >(0);
+}
+inline ::tensorflow::DataType AttrValue::type() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.type)
+  return _internal_type();
+}
+inline void AttrValue::_internal_set_type(::tensorflow::DataType value) {
+  if (!_internal_has_type()) {
+    clear_value();
+    set_has_type();
+  }
+  _impl_.value_.type_ = value;
+}
+inline void AttrValue::set_type(::tensorflow::DataType value) {
+  _internal_set_type(value);
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.type)
+}
+
+// .tensorflow.TensorShapeProto shape = 7;
+inline bool AttrValue::_internal_has_shape() const {
+  return value_case() == kShape;
+}
+inline bool AttrValue::has_shape() const {
+  return _internal_has_shape();
+}
+inline void AttrValue::set_has_shape() {
+  _impl_._oneof_case_[0] = kShape;
+}
+inline void AttrValue::clear_shape() {
+  if (_internal_has_shape()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.value_.shape_;
+    }
+    clear_has_value();
+  }
+}
+inline ::tensorflow::TensorShapeProto* AttrValue::release_shape() {
+  // @@protoc_insertion_point(field_release:tensorflow.AttrValue.shape)
+  if (_internal_has_shape()) {
+    clear_has_value();
+    ::tensorflow::TensorShapeProto* temp = _impl_.value_.shape_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.value_.shape_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::TensorShapeProto& AttrValue::_internal_shape() const {
+  return _internal_has_shape()
+      ? *_impl_.value_.shape_
+      : reinterpret_cast< ::tensorflow::TensorShapeProto&>(::tensorflow::_TensorShapeProto_default_instance_);
+}
+inline const ::tensorflow::TensorShapeProto& AttrValue::shape() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.shape)
+  return _internal_shape();
+}
+inline ::tensorflow::TensorShapeProto* AttrValue::unsafe_arena_release_shape() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.AttrValue.shape)
+  if (_internal_has_shape()) {
+    clear_has_value();
+    ::tensorflow::TensorShapeProto* temp = _impl_.value_.shape_;
+    _impl_.value_.shape_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void AttrValue::unsafe_arena_set_allocated_shape(::tensorflow::TensorShapeProto* shape) {
+  clear_value();
+  if (shape) {
+    set_has_shape();
+    _impl_.value_.shape_ = shape;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.AttrValue.shape)
+}
+inline ::tensorflow::TensorShapeProto* AttrValue::_internal_mutable_shape() {
+  if (!_internal_has_shape()) {
+    clear_value();
+    set_has_shape();
+    _impl_.value_.shape_ = CreateMaybeMessage< ::tensorflow::TensorShapeProto >(GetArenaForAllocation());
+  }
+  return _impl_.value_.shape_;
+}
+inline ::tensorflow::TensorShapeProto* AttrValue::mutable_shape() {
+  ::tensorflow::TensorShapeProto* _msg = _internal_mutable_shape();
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.shape)
+  return _msg;
+}
+
+// .tensorflow.TensorProto tensor = 8;
+inline bool AttrValue::_internal_has_tensor() const {
+  return value_case() == kTensor;
+}
+inline bool AttrValue::has_tensor() const {
+  return _internal_has_tensor();
+}
+inline void AttrValue::set_has_tensor() {
+  _impl_._oneof_case_[0] = kTensor;
+}
+inline void AttrValue::clear_tensor() {
+  if (_internal_has_tensor()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.value_.tensor_;
+    }
+    clear_has_value();
+  }
+}
+inline ::tensorflow::TensorProto* AttrValue::release_tensor() {
+  // @@protoc_insertion_point(field_release:tensorflow.AttrValue.tensor)
+  if (_internal_has_tensor()) {
+    clear_has_value();
+    ::tensorflow::TensorProto* temp = _impl_.value_.tensor_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.value_.tensor_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::TensorProto& AttrValue::_internal_tensor() const {
+  return _internal_has_tensor()
+      ? *_impl_.value_.tensor_
+      : reinterpret_cast< ::tensorflow::TensorProto&>(::tensorflow::_TensorProto_default_instance_);
+}
+inline const ::tensorflow::TensorProto& AttrValue::tensor() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.tensor)
+  return _internal_tensor();
+}
+inline ::tensorflow::TensorProto* AttrValue::unsafe_arena_release_tensor() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.AttrValue.tensor)
+  if (_internal_has_tensor()) {
+    clear_has_value();
+    ::tensorflow::TensorProto* temp = _impl_.value_.tensor_;
+    _impl_.value_.tensor_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void AttrValue::unsafe_arena_set_allocated_tensor(::tensorflow::TensorProto* tensor) {
+  clear_value();
+  if (tensor) {
+    set_has_tensor();
+    _impl_.value_.tensor_ = tensor;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.AttrValue.tensor)
+}
+inline ::tensorflow::TensorProto* AttrValue::_internal_mutable_tensor() {
+  if (!_internal_has_tensor()) {
+    clear_value();
+    set_has_tensor();
+    _impl_.value_.tensor_ = CreateMaybeMessage< ::tensorflow::TensorProto >(GetArenaForAllocation());
+  }
+  return _impl_.value_.tensor_;
+}
+inline ::tensorflow::TensorProto* AttrValue::mutable_tensor() {
+  ::tensorflow::TensorProto* _msg = _internal_mutable_tensor();
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.tensor)
+  return _msg;
+}
+
+// .tensorflow.AttrValue.ListValue list = 1;
+inline bool AttrValue::_internal_has_list() const {
+  return value_case() == kList;
+}
+inline bool AttrValue::has_list() const {
+  return _internal_has_list();
+}
+inline void AttrValue::set_has_list() {
+  _impl_._oneof_case_[0] = kList;
+}
+inline void AttrValue::clear_list() {
+  if (_internal_has_list()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.value_.list_;
+    }
+    clear_has_value();
+  }
+}
+inline ::tensorflow::AttrValue_ListValue* AttrValue::release_list() {
+  // @@protoc_insertion_point(field_release:tensorflow.AttrValue.list)
+  if (_internal_has_list()) {
+    clear_has_value();
+    ::tensorflow::AttrValue_ListValue* temp = _impl_.value_.list_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.value_.list_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::AttrValue_ListValue& AttrValue::_internal_list() const {
+  return _internal_has_list()
+      ? *_impl_.value_.list_
+      : reinterpret_cast< ::tensorflow::AttrValue_ListValue&>(::tensorflow::_AttrValue_ListValue_default_instance_);
+}
+inline const ::tensorflow::AttrValue_ListValue& AttrValue::list() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.list)
+  return _internal_list();
+}
+inline ::tensorflow::AttrValue_ListValue* AttrValue::unsafe_arena_release_list() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.AttrValue.list)
+  if (_internal_has_list()) {
+    clear_has_value();
+    ::tensorflow::AttrValue_ListValue* temp = _impl_.value_.list_;
+    _impl_.value_.list_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void AttrValue::unsafe_arena_set_allocated_list(::tensorflow::AttrValue_ListValue* list) {
+  clear_value();
+  if (list) {
+    set_has_list();
+    _impl_.value_.list_ = list;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.AttrValue.list)
+}
+inline ::tensorflow::AttrValue_ListValue* AttrValue::_internal_mutable_list() {
+  if (!_internal_has_list()) {
+    clear_value();
+    set_has_list();
+    _impl_.value_.list_ = CreateMaybeMessage< ::tensorflow::AttrValue_ListValue >(GetArenaForAllocation());
+  }
+  return _impl_.value_.list_;
+}
+inline ::tensorflow::AttrValue_ListValue* AttrValue::mutable_list() {
+  ::tensorflow::AttrValue_ListValue* _msg = _internal_mutable_list();
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.list)
+  return _msg;
+}
+
+// .tensorflow.NameAttrList func = 10;
+inline bool AttrValue::_internal_has_func() const {
+  return value_case() == kFunc;
+}
+inline bool AttrValue::has_func() const {
+  return _internal_has_func();
+}
+inline void AttrValue::set_has_func() {
+  _impl_._oneof_case_[0] = kFunc;
+}
+inline void AttrValue::clear_func() {
+  if (_internal_has_func()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.value_.func_;
+    }
+    clear_has_value();
+  }
+}
+inline ::tensorflow::NameAttrList* AttrValue::release_func() {
+  // @@protoc_insertion_point(field_release:tensorflow.AttrValue.func)
+  if (_internal_has_func()) {
+    clear_has_value();
+    ::tensorflow::NameAttrList* temp = _impl_.value_.func_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.value_.func_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::NameAttrList& AttrValue::_internal_func() const {
+  return _internal_has_func()
+      ? *_impl_.value_.func_
+      : reinterpret_cast< ::tensorflow::NameAttrList&>(::tensorflow::_NameAttrList_default_instance_);
+}
+inline const ::tensorflow::NameAttrList& AttrValue::func() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.func)
+  return _internal_func();
+}
+inline ::tensorflow::NameAttrList* AttrValue::unsafe_arena_release_func() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.AttrValue.func)
+  if (_internal_has_func()) {
+    clear_has_value();
+    ::tensorflow::NameAttrList* temp = _impl_.value_.func_;
+    _impl_.value_.func_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void AttrValue::unsafe_arena_set_allocated_func(::tensorflow::NameAttrList* func) {
+  clear_value();
+  if (func) {
+    set_has_func();
+    _impl_.value_.func_ = func;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.AttrValue.func)
+}
+inline ::tensorflow::NameAttrList* AttrValue::_internal_mutable_func() {
+  if (!_internal_has_func()) {
+    clear_value();
+    set_has_func();
+    _impl_.value_.func_ = CreateMaybeMessage< ::tensorflow::NameAttrList >(GetArenaForAllocation());
+  }
+  return _impl_.value_.func_;
+}
+inline ::tensorflow::NameAttrList* AttrValue::mutable_func() {
+  ::tensorflow::NameAttrList* _msg = _internal_mutable_func();
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.func)
+  return _msg;
+}
+
+// string placeholder = 9;
+inline bool AttrValue::_internal_has_placeholder() const {
+  return value_case() == kPlaceholder;
+}
+inline bool AttrValue::has_placeholder() const {
+  return _internal_has_placeholder();
+}
+inline void AttrValue::set_has_placeholder() {
+  _impl_._oneof_case_[0] = kPlaceholder;
+}
+inline void AttrValue::clear_placeholder() {
+  if (_internal_has_placeholder()) {
+    _impl_.value_.placeholder_.Destroy();
+    clear_has_value();
+  }
+}
+inline const std::string& AttrValue::placeholder() const {
+  // @@protoc_insertion_point(field_get:tensorflow.AttrValue.placeholder)
+  return _internal_placeholder();
+}
+template <typename ArgT0, typename... ArgT>
+inline void AttrValue::set_placeholder(ArgT0&& arg0, ArgT... args) {
+  if (!_internal_has_placeholder()) {
+    clear_value();
+    set_has_placeholder();
+    _impl_.value_.placeholder_.InitDefault();
+  }
+  _impl_.value_.placeholder_.Set( static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.AttrValue.placeholder)
+}
+inline std::string* AttrValue::mutable_placeholder() {
+  std::string* _s = _internal_mutable_placeholder();
+  // @@protoc_insertion_point(field_mutable:tensorflow.AttrValue.placeholder)
+  return _s;
+}
+inline const std::string& AttrValue::_internal_placeholder() const {
+  if (_internal_has_placeholder()) {
+    return _impl_.value_.placeholder_.Get();
+  }
+  return ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited();
+}
+inline void AttrValue::_internal_set_placeholder(const std::string& value) {
+  if (!_internal_has_placeholder()) {
+    clear_value();
+    set_has_placeholder();
+    _impl_.value_.placeholder_.InitDefault();
+  }
+  _impl_.value_.placeholder_.Set(value, GetArenaForAllocation());
+}
+inline std::string* AttrValue::_internal_mutable_placeholder() {
+  if (!_internal_has_placeholder()) {
+    clear_value();
+    set_has_placeholder();
+    _impl_.value_.placeholder_.InitDefault();
+  }
+  return _impl_.value_.placeholder_.Mutable(      GetArenaForAllocation());
+}
+inline std::string* AttrValue::release_placeholder() {
+  // @@protoc_insertion_point(field_release:tensorflow.AttrValue.placeholder)
+  if (_internal_has_placeholder()) {
+    clear_has_value();
+    return _impl_.value_.placeholder_.Release();
+  } else {
+    return nullptr;
+  }
+}
+inline void AttrValue::set_allocated_placeholder(std::string* placeholder) {
+  if (has_value()) {
+    clear_value();
+  }
+  if (placeholder != nullptr) {
+    set_has_placeholder();
+    _impl_.value_.placeholder_.InitAllocated(placeholder, GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.AttrValue.placeholder)
+}
+
+inline bool AttrValue::has_value() const {
+  return value_case() != VALUE_NOT_SET;
+}
+inline void AttrValue::clear_has_value() {
+  _impl_._oneof_case_[0] = VALUE_NOT_SET;
+}
+inline AttrValue::ValueCase AttrValue::value_case() const {
+  return AttrValue::ValueCase(_impl_._oneof_case_[0]);
+}
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// NameAttrList
+
+// string name = 1;
+inline void NameAttrList::clear_name() {
+  _impl_.name_.ClearToEmpty();
+}
+inline const std::string& NameAttrList::name() const {
+  // @@protoc_insertion_point(field_get:tensorflow.NameAttrList.name)
+  return _internal_name();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void NameAttrList::set_name(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.name_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.NameAttrList.name)
+}
+inline std::string* NameAttrList::mutable_name() {
+  std::string* _s = _internal_mutable_name();
+  // @@protoc_insertion_point(field_mutable:tensorflow.NameAttrList.name)
+  return _s;
+}
+inline const std::string& NameAttrList::_internal_name() const {
+  return _impl_.name_.Get();
+}
+inline void NameAttrList::_internal_set_name(const std::string& value) {
+  
+  _impl_.name_.Set(value, GetArenaForAllocation());
+}
+inline std::string* NameAttrList::_internal_mutable_name() {
+  
+  return _impl_.name_.Mutable(GetArenaForAllocation());
+}
+inline std::string* NameAttrList::release_name() {
+  // @@protoc_insertion_point(field_release:tensorflow.NameAttrList.name)
+  return _impl_.name_.Release();
+}
+inline void NameAttrList::set_allocated_name(std::string* name) {
+  if (name != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.name_.SetAllocated(name, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.name_.IsDefault()) {
+    _impl_.name_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.NameAttrList.name)
+}
+
+// map<string, .tensorflow.AttrValue> attr = 2;
+inline int NameAttrList::_internal_attr_size() const {
+  return _impl_.attr_.size();
+}
+inline int NameAttrList::attr_size() const {
+  return _internal_attr_size();
+}
+inline void NameAttrList::clear_attr() {
+  _impl_.attr_.Clear();
+}
+inline const ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >&
+NameAttrList::_internal_attr() const {
+  return _impl_.attr_.GetMap();
+}
+inline const ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >&
+NameAttrList::attr() const {
+  // @@protoc_insertion_point(field_map:tensorflow.NameAttrList.attr)
+  return _internal_attr();
+}
+inline ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >*
+NameAttrList::_internal_mutable_attr() {
+  return _impl_.attr_.MutableMap();
+}
+inline ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >*
+NameAttrList::mutable_attr() {
+  // @@protoc_insertion_point(field_mutable_map:tensorflow.NameAttrList.attr)
+  return _internal_mutable_attr();
+}
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// NodeDef
+
+// string name = 1;
+inline void NodeDef::clear_name() {
+  _impl_.name_.ClearToEmpty();
+}
+inline const std::string& NodeDef::name() const {
+  // @@protoc_insertion_point(field_get:tensorflow.NodeDef.name)
+  return _internal_name();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void NodeDef::set_name(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.name_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.NodeDef.name)
+}
+inline std::string* NodeDef::mutable_name() {
+  std::string* _s = _internal_mutable_name();
+  // @@protoc_insertion_point(field_mutable:tensorflow.NodeDef.name)
+  return _s;
+}
+inline const std::string& NodeDef::_internal_name() const {
+  return _impl_.name_.Get();
+}
+inline void NodeDef::_internal_set_name(const std::string& value) {
+  
+  _impl_.name_.Set(value, GetArenaForAllocation());
+}
+inline std::string* NodeDef::_internal_mutable_name() {
+  
+  return _impl_.name_.Mutable(GetArenaForAllocation());
+}
+inline std::string* NodeDef::release_name() {
+  // @@protoc_insertion_point(field_release:tensorflow.NodeDef.name)
+  return _impl_.name_.Release();
+}
+inline void NodeDef::set_allocated_name(std::string* name) {
+  if (name != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.name_.SetAllocated(name, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.name_.IsDefault()) {
+    _impl_.name_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.NodeDef.name)
+}
+
+// string op = 2;
+inline void NodeDef::clear_op() {
+  _impl_.op_.ClearToEmpty();
+}
+inline const std::string& NodeDef::op() const {
+  // @@protoc_insertion_point(field_get:tensorflow.NodeDef.op)
+  return _internal_op();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void NodeDef::set_op(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.op_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.NodeDef.op)
+}
+inline std::string* NodeDef::mutable_op() {
+  std::string* _s = _internal_mutable_op();
+  // @@protoc_insertion_point(field_mutable:tensorflow.NodeDef.op)
+  return _s;
+}
+inline const std::string& NodeDef::_internal_op() const {
+  return _impl_.op_.Get();
+}
+inline void NodeDef::_internal_set_op(const std::string& value) {
+  
+  _impl_.op_.Set(value, GetArenaForAllocation());
+}
+inline std::string* NodeDef::_internal_mutable_op() {
+  
+  return _impl_.op_.Mutable(GetArenaForAllocation());
+}
+inline std::string* NodeDef::release_op() {
+  // @@protoc_insertion_point(field_release:tensorflow.NodeDef.op)
+  return _impl_.op_.Release();
+}
+inline void NodeDef::set_allocated_op(std::string* op) {
+  if (op != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.op_.SetAllocated(op, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.op_.IsDefault()) {
+    _impl_.op_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.NodeDef.op)
+}
+
+// repeated string input = 3;
+inline int NodeDef::_internal_input_size() const {
+  return _impl_.input_.size();
+}
+inline int NodeDef::input_size() const {
+  return _internal_input_size();
+}
+inline void NodeDef::clear_input() {
+  _impl_.input_.Clear();
+}
+inline std::string* NodeDef::add_input() {
+  std::string* _s = _internal_add_input();
+  // @@protoc_insertion_point(field_add_mutable:tensorflow.NodeDef.input)
+  return _s;
+}
+inline const std::string& NodeDef::_internal_input(int index) const {
+  return _impl_.input_.Get(index);
+}
+inline const std::string& NodeDef::input(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.NodeDef.input)
+  return _internal_input(index);
+}
+inline std::string* NodeDef::mutable_input(int index) {
+  // @@protoc_insertion_point(field_mutable:tensorflow.NodeDef.input)
+  return _impl_.input_.Mutable(index);
+}
+inline void NodeDef::set_input(int index, const std::string& value) {
+  _impl_.input_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set:tensorflow.NodeDef.input)
+}
+inline void NodeDef::set_input(int index, std::string&& value) {
+  _impl_.input_.Mutable(index)->assign(std::move(value));
+  // @@protoc_insertion_point(field_set:tensorflow.NodeDef.input)
+}
+inline void NodeDef::set_input(int index, const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  _impl_.input_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set_char:tensorflow.NodeDef.input)
+}
+inline void NodeDef::set_input(int index, const char* value, size_t size) {
+  _impl_.input_.Mutable(index)->assign(
+    reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:tensorflow.NodeDef.input)
+}
+inline std::string* NodeDef::_internal_add_input() {
+  return _impl_.input_.Add();
+}
+inline void NodeDef::add_input(const std::string& value) {
+  _impl_.input_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add:tensorflow.NodeDef.input)
+}
+inline void NodeDef::add_input(std::string&& value) {
+  _impl_.input_.Add(std::move(value));
+  // @@protoc_insertion_point(field_add:tensorflow.NodeDef.input)
+}
+inline void NodeDef::add_input(const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  _impl_.input_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add_char:tensorflow.NodeDef.input)
+}
+inline void NodeDef::add_input(const char* value, size_t size) {
+  _impl_.input_.Add()->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_add_pointer:tensorflow.NodeDef.input)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>&
+NodeDef::input() const {
+  // @@protoc_insertion_point(field_list:tensorflow.NodeDef.input)
+  return _impl_.input_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>*
+NodeDef::mutable_input() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.NodeDef.input)
+  return &_impl_.input_;
+}
+
+// string device = 4;
+inline void NodeDef::clear_device() {
+  _impl_.device_.ClearToEmpty();
+}
+inline const std::string& NodeDef::device() const {
+  // @@protoc_insertion_point(field_get:tensorflow.NodeDef.device)
+  return _internal_device();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void NodeDef::set_device(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.device_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.NodeDef.device)
+}
+inline std::string* NodeDef::mutable_device() {
+  std::string* _s = _internal_mutable_device();
+  // @@protoc_insertion_point(field_mutable:tensorflow.NodeDef.device)
+  return _s;
+}
+inline const std::string& NodeDef::_internal_device() const {
+  return _impl_.device_.Get();
+}
+inline void NodeDef::_internal_set_device(const std::string& value) {
+  
+  _impl_.device_.Set(value, GetArenaForAllocation());
+}
+inline std::string* NodeDef::_internal_mutable_device() {
+  
+  return _impl_.device_.Mutable(GetArenaForAllocation());
+}
+inline std::string* NodeDef::release_device() {
+  // @@protoc_insertion_point(field_release:tensorflow.NodeDef.device)
+  return _impl_.device_.Release();
+}
+inline void NodeDef::set_allocated_device(std::string* device) {
+  if (device != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.device_.SetAllocated(device, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.device_.IsDefault()) {
+    _impl_.device_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.NodeDef.device)
+}
+
+// map<string, .tensorflow.AttrValue> attr = 5;
+inline int NodeDef::_internal_attr_size() const {
+  return _impl_.attr_.size();
+}
+inline int NodeDef::attr_size() const {
+  return _internal_attr_size();
+}
+inline void NodeDef::clear_attr() {
+  _impl_.attr_.Clear();
+}
+inline const ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >&
+NodeDef::_internal_attr() const {
+  return _impl_.attr_.GetMap();
+}
+inline const ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >&
+NodeDef::attr() const {
+  // @@protoc_insertion_point(field_map:tensorflow.NodeDef.attr)
+  return _internal_attr();
+}
+inline ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >*
+NodeDef::_internal_mutable_attr() {
+  return _impl_.attr_.MutableMap();
+}
+inline ::PROTOBUF_NAMESPACE_ID::Map< std::string, ::tensorflow::AttrValue >*
+NodeDef::mutable_attr() {
+  // @@protoc_insertion_point(field_mutable_map:tensorflow.NodeDef.attr)
+  return _internal_mutable_attr();
+}
+
+// -------------------------------------------------------------------
+
+// GraphDef
+
+// repeated .tensorflow.NodeDef node = 1;
+inline int GraphDef::_internal_node_size() const {
+  return _impl_.node_.size();
+}
+inline int GraphDef::node_size() const {
+  return _internal_node_size();
+}
+inline void GraphDef::clear_node() {
+  _impl_.node_.Clear();
+}
+inline ::tensorflow::NodeDef* GraphDef::mutable_node(int index) {
+  // @@protoc_insertion_point(field_mutable:tensorflow.GraphDef.node)
+  return _impl_.node_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::NodeDef >*
+GraphDef::mutable_node() {
+  // @@protoc_insertion_point(field_mutable_list:tensorflow.GraphDef.node)
+  return &_impl_.node_;
+}
+inline const ::tensorflow::NodeDef& GraphDef::_internal_node(int index) const {
+  return _impl_.node_.Get(index);
+}
+inline const ::tensorflow::NodeDef& GraphDef::node(int index) const {
+  // @@protoc_insertion_point(field_get:tensorflow.GraphDef.node)
+  return _internal_node(index);
+}
+inline ::tensorflow::NodeDef* GraphDef::_internal_add_node() {
+  return _impl_.node_.Add();
+}
+inline ::tensorflow::NodeDef* GraphDef::add_node() {
+  ::tensorflow::NodeDef* _add = _internal_add_node();
+  // @@protoc_insertion_point(field_add:tensorflow.GraphDef.node)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::tensorflow::NodeDef >&
+GraphDef::node() const {
+  // @@protoc_insertion_point(field_list:tensorflow.GraphDef.node)
+  return _impl_.node_;
+}
+
+// .tensorflow.VersionDef versions = 4;
+inline bool GraphDef::_internal_has_versions() const {
+  return this != internal_default_instance() && _impl_.versions_ != nullptr;
+}
+inline bool GraphDef::has_versions() const {
+  return _internal_has_versions();
+}
+inline void GraphDef::clear_versions() {
+  if (GetArenaForAllocation() == nullptr && _impl_.versions_ != nullptr) {
+    delete _impl_.versions_;
+  }
+  _impl_.versions_ = nullptr;
+}
+inline const ::tensorflow::VersionDef& GraphDef::_internal_versions() const {
+  const ::tensorflow::VersionDef* p = _impl_.versions_;
+  return p != nullptr ? *p : reinterpret_cast<const ::tensorflow::VersionDef&>(
+      ::tensorflow::_VersionDef_default_instance_);
+}
+inline const ::tensorflow::VersionDef& GraphDef::versions() const {
+  // @@protoc_insertion_point(field_get:tensorflow.GraphDef.versions)
+  return _internal_versions();
+}
+inline void GraphDef::unsafe_arena_set_allocated_versions(
+    ::tensorflow::VersionDef* versions) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.versions_);
+  }
+  _impl_.versions_ = versions;
+  if (versions) {
+    
+  } else {
+    
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.GraphDef.versions)
+}
+inline ::tensorflow::VersionDef* GraphDef::release_versions() {
+  
+  ::tensorflow::VersionDef* temp = _impl_.versions_;
+  _impl_.versions_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::tensorflow::VersionDef* GraphDef::unsafe_arena_release_versions() {
+  // @@protoc_insertion_point(field_release:tensorflow.GraphDef.versions)
+  
+  ::tensorflow::VersionDef* temp = _impl_.versions_;
+  _impl_.versions_ = nullptr;
+  return temp;
+}
+inline ::tensorflow::VersionDef* GraphDef::_internal_mutable_versions() {
+  
+  if (_impl_.versions_ == nullptr) {
+    auto* p = CreateMaybeMessage<::tensorflow::VersionDef>(GetArenaForAllocation());
+    _impl_.versions_ = p;
+  }
+  return _impl_.versions_;
+}
+inline ::tensorflow::VersionDef* GraphDef::mutable_versions() {
+  ::tensorflow::VersionDef* _msg = _internal_mutable_versions();
+  // @@protoc_insertion_point(field_mutable:tensorflow.GraphDef.versions)
+  return _msg;
+}
+inline void GraphDef::set_allocated_versions(::tensorflow::VersionDef* versions) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.versions_;
+  }
+  if (versions) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(versions);
+    if (message_arena != submessage_arena) {
+      versions = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, versions, submessage_arena);
+    }
+    
+  } else {
+    
+  }
+  _impl_.versions_ = versions;
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.GraphDef.versions)
+}
+
+// int32 version = 3 [deprecated = true];
+inline void GraphDef::clear_version() {
+  _impl_.version_ = 0;
+}
+inline int32_t GraphDef::_internal_version() const {
+  return _impl_.version_;
+}
+inline int32_t GraphDef::version() const {
+  // @@protoc_insertion_point(field_get:tensorflow.GraphDef.version)
+  return _internal_version();
+}
+inline void GraphDef::_internal_set_version(int32_t value) {
+  
+  _impl_.version_ = value;
+}
+inline void GraphDef::set_version(int32_t value) {
+  _internal_set_version(value);
+  // @@protoc_insertion_point(field_set:tensorflow.GraphDef.version)
+}
+
+// -------------------------------------------------------------------
+
+// Event
+
+// double wall_time = 1;
+inline void Event::clear_wall_time() {
+  _impl_.wall_time_ = 0;
+}
+inline double Event::_internal_wall_time() const {
+  return _impl_.wall_time_;
+}
+inline double Event::wall_time() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.wall_time)
+  return _internal_wall_time();
+}
+inline void Event::_internal_set_wall_time(double value) {
+  
+  _impl_.wall_time_ = value;
+}
+inline void Event::set_wall_time(double value) {
+  _internal_set_wall_time(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Event.wall_time)
+}
+
+// int64 step = 2;
+inline void Event::clear_step() {
+  _impl_.step_ = int64_t{0};
+}
+inline int64_t Event::_internal_step() const {
+  return _impl_.step_;
+}
+inline int64_t Event::step() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.step)
+  return _internal_step();
+}
+inline void Event::_internal_set_step(int64_t value) {
+  
+  _impl_.step_ = value;
+}
+inline void Event::set_step(int64_t value) {
+  _internal_set_step(value);
+  // @@protoc_insertion_point(field_set:tensorflow.Event.step)
+}
+
+// string file_version = 3;
+inline bool Event::_internal_has_file_version() const {
+  return what_case() == kFileVersion;
+}
+inline bool Event::has_file_version() const {
+  return _internal_has_file_version();
+}
+inline void Event::set_has_file_version() {
+  _impl_._oneof_case_[0] = kFileVersion;
+}
+inline void Event::clear_file_version() {
+  if (_internal_has_file_version()) {
+    _impl_.what_.file_version_.Destroy();
+    clear_has_what();
+  }
+}
+inline const std::string& Event::file_version() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.file_version)
+  return _internal_file_version();
+}
+template <typename ArgT0, typename... ArgT>
+inline void Event::set_file_version(ArgT0&& arg0, ArgT... args) {
+  if (!_internal_has_file_version()) {
+    clear_what();
+    set_has_file_version();
+    _impl_.what_.file_version_.InitDefault();
+  }
+  _impl_.what_.file_version_.Set( static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Event.file_version)
+}
+inline std::string* Event::mutable_file_version() {
+  std::string* _s = _internal_mutable_file_version();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Event.file_version)
+  return _s;
+}
+inline const std::string& Event::_internal_file_version() const {
+  if (_internal_has_file_version()) {
+    return _impl_.what_.file_version_.Get();
+  }
+  return ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited();
+}
+inline void Event::_internal_set_file_version(const std::string& value) {
+  if (!_internal_has_file_version()) {
+    clear_what();
+    set_has_file_version();
+    _impl_.what_.file_version_.InitDefault();
+  }
+  _impl_.what_.file_version_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Event::_internal_mutable_file_version() {
+  if (!_internal_has_file_version()) {
+    clear_what();
+    set_has_file_version();
+    _impl_.what_.file_version_.InitDefault();
+  }
+  return _impl_.what_.file_version_.Mutable(      GetArenaForAllocation());
+}
+inline std::string* Event::release_file_version() {
+  // @@protoc_insertion_point(field_release:tensorflow.Event.file_version)
+  if (_internal_has_file_version()) {
+    clear_has_what();
+    return _impl_.what_.file_version_.Release();
+  } else {
+    return nullptr;
+  }
+}
+inline void Event::set_allocated_file_version(std::string* file_version) {
+  if (has_what()) {
+    clear_what();
+  }
+  if (file_version != nullptr) {
+    set_has_file_version();
+    _impl_.what_.file_version_.InitAllocated(file_version, GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Event.file_version)
+}
+
+// bytes graph_def = 4;
+inline bool Event::_internal_has_graph_def() const {
+  return what_case() == kGraphDef;
+}
+inline bool Event::has_graph_def() const {
+  return _internal_has_graph_def();
+}
+inline void Event::set_has_graph_def() {
+  _impl_._oneof_case_[0] = kGraphDef;
+}
+inline void Event::clear_graph_def() {
+  if (_internal_has_graph_def()) {
+    _impl_.what_.graph_def_.Destroy();
+    clear_has_what();
+  }
+}
+inline const std::string& Event::graph_def() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.graph_def)
+  return _internal_graph_def();
+}
+template <typename ArgT0, typename... ArgT>
+inline void Event::set_graph_def(ArgT0&& arg0, ArgT... args) {
+  if (!_internal_has_graph_def()) {
+    clear_what();
+    set_has_graph_def();
+    _impl_.what_.graph_def_.InitDefault();
+  }
+  _impl_.what_.graph_def_.SetBytes( static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Event.graph_def)
+}
+inline std::string* Event::mutable_graph_def() {
+  std::string* _s = _internal_mutable_graph_def();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Event.graph_def)
+  return _s;
+}
+inline const std::string& Event::_internal_graph_def() const {
+  if (_internal_has_graph_def()) {
+    return _impl_.what_.graph_def_.Get();
+  }
+  return ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited();
+}
+inline void Event::_internal_set_graph_def(const std::string& value) {
+  if (!_internal_has_graph_def()) {
+    clear_what();
+    set_has_graph_def();
+    _impl_.what_.graph_def_.InitDefault();
+  }
+  _impl_.what_.graph_def_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Event::_internal_mutable_graph_def() {
+  if (!_internal_has_graph_def()) {
+    clear_what();
+    set_has_graph_def();
+    _impl_.what_.graph_def_.InitDefault();
+  }
+  return _impl_.what_.graph_def_.Mutable(      GetArenaForAllocation());
+}
+inline std::string* Event::release_graph_def() {
+  // @@protoc_insertion_point(field_release:tensorflow.Event.graph_def)
+  if (_internal_has_graph_def()) {
+    clear_has_what();
+    return _impl_.what_.graph_def_.Release();
+  } else {
+    return nullptr;
+  }
+}
+inline void Event::set_allocated_graph_def(std::string* graph_def) {
+  if (has_what()) {
+    clear_what();
+  }
+  if (graph_def != nullptr) {
+    set_has_graph_def();
+    _impl_.what_.graph_def_.InitAllocated(graph_def, GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Event.graph_def)
+}
+
+// .tensorflow.Summary summary = 5;
+inline bool Event::_internal_has_summary() const {
+  return what_case() == kSummary;
+}
+inline bool Event::has_summary() const {
+  return _internal_has_summary();
+}
+inline void Event::set_has_summary() {
+  _impl_._oneof_case_[0] = kSummary;
+}
+inline void Event::clear_summary() {
+  if (_internal_has_summary()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.what_.summary_;
+    }
+    clear_has_what();
+  }
+}
+inline ::tensorflow::Summary* Event::release_summary() {
+  // @@protoc_insertion_point(field_release:tensorflow.Event.summary)
+  if (_internal_has_summary()) {
+    clear_has_what();
+    ::tensorflow::Summary* temp = _impl_.what_.summary_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.what_.summary_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::Summary& Event::_internal_summary() const {
+  return _internal_has_summary()
+      ? *_impl_.what_.summary_
+      : reinterpret_cast< ::tensorflow::Summary&>(::tensorflow::_Summary_default_instance_);
+}
+inline const ::tensorflow::Summary& Event::summary() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.summary)
+  return _internal_summary();
+}
+inline ::tensorflow::Summary* Event::unsafe_arena_release_summary() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.Event.summary)
+  if (_internal_has_summary()) {
+    clear_has_what();
+    ::tensorflow::Summary* temp = _impl_.what_.summary_;
+    _impl_.what_.summary_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Event::unsafe_arena_set_allocated_summary(::tensorflow::Summary* summary) {
+  clear_what();
+  if (summary) {
+    set_has_summary();
+    _impl_.what_.summary_ = summary;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.Event.summary)
+}
+inline ::tensorflow::Summary* Event::_internal_mutable_summary() {
+  if (!_internal_has_summary()) {
+    clear_what();
+    set_has_summary();
+    _impl_.what_.summary_ = CreateMaybeMessage< ::tensorflow::Summary >(GetArenaForAllocation());
+  }
+  return _impl_.what_.summary_;
+}
+inline ::tensorflow::Summary* Event::mutable_summary() {
+  ::tensorflow::Summary* _msg = _internal_mutable_summary();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Event.summary)
+  return _msg;
+}
+
+// .tensorflow.LogMessage log_message = 6;
+inline bool Event::_internal_has_log_message() const {
+  return what_case() == kLogMessage;
+}
+inline bool Event::has_log_message() const {
+  return _internal_has_log_message();
+}
+inline void Event::set_has_log_message() {
+  _impl_._oneof_case_[0] = kLogMessage;
+}
+inline void Event::clear_log_message() {
+  if (_internal_has_log_message()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.what_.log_message_;
+    }
+    clear_has_what();
+  }
+}
+inline ::tensorflow::LogMessage* Event::release_log_message() {
+  // @@protoc_insertion_point(field_release:tensorflow.Event.log_message)
+  if (_internal_has_log_message()) {
+    clear_has_what();
+    ::tensorflow::LogMessage* temp = _impl_.what_.log_message_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.what_.log_message_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::LogMessage& Event::_internal_log_message() const {
+  return _internal_has_log_message()
+      ? *_impl_.what_.log_message_
+      : reinterpret_cast< ::tensorflow::LogMessage&>(::tensorflow::_LogMessage_default_instance_);
+}
+inline const ::tensorflow::LogMessage& Event::log_message() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.log_message)
+  return _internal_log_message();
+}
+inline ::tensorflow::LogMessage* Event::unsafe_arena_release_log_message() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.Event.log_message)
+  if (_internal_has_log_message()) {
+    clear_has_what();
+    ::tensorflow::LogMessage* temp = _impl_.what_.log_message_;
+    _impl_.what_.log_message_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Event::unsafe_arena_set_allocated_log_message(::tensorflow::LogMessage* log_message) {
+  clear_what();
+  if (log_message) {
+    set_has_log_message();
+    _impl_.what_.log_message_ = log_message;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.Event.log_message)
+}
+inline ::tensorflow::LogMessage* Event::_internal_mutable_log_message() {
+  if (!_internal_has_log_message()) {
+    clear_what();
+    set_has_log_message();
+    _impl_.what_.log_message_ = CreateMaybeMessage< ::tensorflow::LogMessage >(GetArenaForAllocation());
+  }
+  return _impl_.what_.log_message_;
+}
+inline ::tensorflow::LogMessage* Event::mutable_log_message() {
+  ::tensorflow::LogMessage* _msg = _internal_mutable_log_message();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Event.log_message)
+  return _msg;
+}
+
+// .tensorflow.SessionLog session_log = 7;
+inline bool Event::_internal_has_session_log() const {
+  return what_case() == kSessionLog;
+}
+inline bool Event::has_session_log() const {
+  return _internal_has_session_log();
+}
+inline void Event::set_has_session_log() {
+  _impl_._oneof_case_[0] = kSessionLog;
+}
+inline void Event::clear_session_log() {
+  if (_internal_has_session_log()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.what_.session_log_;
+    }
+    clear_has_what();
+  }
+}
+inline ::tensorflow::SessionLog* Event::release_session_log() {
+  // @@protoc_insertion_point(field_release:tensorflow.Event.session_log)
+  if (_internal_has_session_log()) {
+    clear_has_what();
+    ::tensorflow::SessionLog* temp = _impl_.what_.session_log_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.what_.session_log_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::SessionLog& Event::_internal_session_log() const {
+  return _internal_has_session_log()
+      ? *_impl_.what_.session_log_
+      : reinterpret_cast< ::tensorflow::SessionLog&>(::tensorflow::_SessionLog_default_instance_);
+}
+inline const ::tensorflow::SessionLog& Event::session_log() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.session_log)
+  return _internal_session_log();
+}
+inline ::tensorflow::SessionLog* Event::unsafe_arena_release_session_log() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.Event.session_log)
+  if (_internal_has_session_log()) {
+    clear_has_what();
+    ::tensorflow::SessionLog* temp = _impl_.what_.session_log_;
+    _impl_.what_.session_log_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Event::unsafe_arena_set_allocated_session_log(::tensorflow::SessionLog* session_log) {
+  clear_what();
+  if (session_log) {
+    set_has_session_log();
+    _impl_.what_.session_log_ = session_log;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.Event.session_log)
+}
+inline ::tensorflow::SessionLog* Event::_internal_mutable_session_log() {
+  if (!_internal_has_session_log()) {
+    clear_what();
+    set_has_session_log();
+    _impl_.what_.session_log_ = CreateMaybeMessage< ::tensorflow::SessionLog >(GetArenaForAllocation());
+  }
+  return _impl_.what_.session_log_;
+}
+inline ::tensorflow::SessionLog* Event::mutable_session_log() {
+  ::tensorflow::SessionLog* _msg = _internal_mutable_session_log();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Event.session_log)
+  return _msg;
+}
+
+// .tensorflow.TaggedRunMetadata tagged_run_metadata = 8;
+inline bool Event::_internal_has_tagged_run_metadata() const {
+  return what_case() == kTaggedRunMetadata;
+}
+inline bool Event::has_tagged_run_metadata() const {
+  return _internal_has_tagged_run_metadata();
+}
+inline void Event::set_has_tagged_run_metadata() {
+  _impl_._oneof_case_[0] = kTaggedRunMetadata;
+}
+inline void Event::clear_tagged_run_metadata() {
+  if (_internal_has_tagged_run_metadata()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.what_.tagged_run_metadata_;
+    }
+    clear_has_what();
+  }
+}
+inline ::tensorflow::TaggedRunMetadata* Event::release_tagged_run_metadata() {
+  // @@protoc_insertion_point(field_release:tensorflow.Event.tagged_run_metadata)
+  if (_internal_has_tagged_run_metadata()) {
+    clear_has_what();
+    ::tensorflow::TaggedRunMetadata* temp = _impl_.what_.tagged_run_metadata_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.what_.tagged_run_metadata_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::tensorflow::TaggedRunMetadata& Event::_internal_tagged_run_metadata() const {
+  return _internal_has_tagged_run_metadata()
+      ? *_impl_.what_.tagged_run_metadata_
+      : reinterpret_cast< ::tensorflow::TaggedRunMetadata&>(::tensorflow::_TaggedRunMetadata_default_instance_);
+}
+inline const ::tensorflow::TaggedRunMetadata& Event::tagged_run_metadata() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.tagged_run_metadata)
+  return _internal_tagged_run_metadata();
+}
+inline ::tensorflow::TaggedRunMetadata* Event::unsafe_arena_release_tagged_run_metadata() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:tensorflow.Event.tagged_run_metadata)
+  if (_internal_has_tagged_run_metadata()) {
+    clear_has_what();
+    ::tensorflow::TaggedRunMetadata* temp = _impl_.what_.tagged_run_metadata_;
+    _impl_.what_.tagged_run_metadata_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Event::unsafe_arena_set_allocated_tagged_run_metadata(::tensorflow::TaggedRunMetadata* tagged_run_metadata) {
+  clear_what();
+  if (tagged_run_metadata) {
+    set_has_tagged_run_metadata();
+    _impl_.what_.tagged_run_metadata_ = tagged_run_metadata;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:tensorflow.Event.tagged_run_metadata)
+}
+inline ::tensorflow::TaggedRunMetadata* Event::_internal_mutable_tagged_run_metadata() {
+  if (!_internal_has_tagged_run_metadata()) {
+    clear_what();
+    set_has_tagged_run_metadata();
+    _impl_.what_.tagged_run_metadata_ = CreateMaybeMessage< ::tensorflow::TaggedRunMetadata >(GetArenaForAllocation());
+  }
+  return _impl_.what_.tagged_run_metadata_;
+}
+inline ::tensorflow::TaggedRunMetadata* Event::mutable_tagged_run_metadata() {
+  ::tensorflow::TaggedRunMetadata* _msg = _internal_mutable_tagged_run_metadata();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Event.tagged_run_metadata)
+  return _msg;
+}
+
+// bytes meta_graph_def = 9;
+inline bool Event::_internal_has_meta_graph_def() const {
+  return what_case() == kMetaGraphDef;
+}
+inline bool Event::has_meta_graph_def() const {
+  return _internal_has_meta_graph_def();
+}
+inline void Event::set_has_meta_graph_def() {
+  _impl_._oneof_case_[0] = kMetaGraphDef;
+}
+inline void Event::clear_meta_graph_def() {
+  if (_internal_has_meta_graph_def()) {
+    _impl_.what_.meta_graph_def_.Destroy();
+    clear_has_what();
+  }
+}
+inline const std::string& Event::meta_graph_def() const {
+  // @@protoc_insertion_point(field_get:tensorflow.Event.meta_graph_def)
+  return _internal_meta_graph_def();
+}
+template <typename ArgT0, typename... ArgT>
+inline void Event::set_meta_graph_def(ArgT0&& arg0, ArgT... args) {
+  if (!_internal_has_meta_graph_def()) {
+    clear_what();
+    set_has_meta_graph_def();
+    _impl_.what_.meta_graph_def_.InitDefault();
+  }
+  _impl_.what_.meta_graph_def_.SetBytes( static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.Event.meta_graph_def)
+}
+inline std::string* Event::mutable_meta_graph_def() {
+  std::string* _s = _internal_mutable_meta_graph_def();
+  // @@protoc_insertion_point(field_mutable:tensorflow.Event.meta_graph_def)
+  return _s;
+}
+inline const std::string& Event::_internal_meta_graph_def() const {
+  if (_internal_has_meta_graph_def()) {
+    return _impl_.what_.meta_graph_def_.Get();
+  }
+  return ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited();
+}
+inline void Event::_internal_set_meta_graph_def(const std::string& value) {
+  if (!_internal_has_meta_graph_def()) {
+    clear_what();
+    set_has_meta_graph_def();
+    _impl_.what_.meta_graph_def_.InitDefault();
+  }
+  _impl_.what_.meta_graph_def_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Event::_internal_mutable_meta_graph_def() {
+  if (!_internal_has_meta_graph_def()) {
+    clear_what();
+    set_has_meta_graph_def();
+    _impl_.what_.meta_graph_def_.InitDefault();
+  }
+  return _impl_.what_.meta_graph_def_.Mutable(      GetArenaForAllocation());
+}
+inline std::string* Event::release_meta_graph_def() {
+  // @@protoc_insertion_point(field_release:tensorflow.Event.meta_graph_def)
+  if (_internal_has_meta_graph_def()) {
+    clear_has_what();
+    return _impl_.what_.meta_graph_def_.Release();
+  } else {
+    return nullptr;
+  }
+}
+inline void Event::set_allocated_meta_graph_def(std::string* meta_graph_def) {
+  if (has_what()) {
+    clear_what();
+  }
+  if (meta_graph_def != nullptr) {
+    set_has_meta_graph_def();
+    _impl_.what_.meta_graph_def_.InitAllocated(meta_graph_def, GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.Event.meta_graph_def)
+}
+
+inline bool Event::has_what() const {
+  return what_case() != WHAT_NOT_SET;
+}
+inline void Event::clear_has_what() {
+  _impl_._oneof_case_[0] = WHAT_NOT_SET;
+}
+inline Event::WhatCase Event::what_case() const {
+  return Event::WhatCase(_impl_._oneof_case_[0]);
+}
+// -------------------------------------------------------------------
+
+// LogMessage
+
+// .tensorflow.LogMessage.Level level = 1;
+inline void LogMessage::clear_level() {
+  _impl_.level_ = 0;
+}
+inline ::tensorflow::LogMessage_Level LogMessage::_internal_level() const {
+  return static_cast< ::tensorflow::LogMessage_Level >(_impl_.level_);
+}
+inline ::tensorflow::LogMessage_Level LogMessage::level() const {
+  // @@protoc_insertion_point(field_get:tensorflow.LogMessage.level)
+  return _internal_level();
+}
+inline void LogMessage::_internal_set_level(::tensorflow::LogMessage_Level value) {
+  
+  _impl_.level_ = value;
+}
+inline void LogMessage::set_level(::tensorflow::LogMessage_Level value) {
+  _internal_set_level(value);
+  // @@protoc_insertion_point(field_set:tensorflow.LogMessage.level)
+}
+
+// string message = 2;
+inline void LogMessage::clear_message() {
+  _impl_.message_.ClearToEmpty();
+}
+inline const std::string& LogMessage::message() const {
+  // @@protoc_insertion_point(field_get:tensorflow.LogMessage.message)
+  return _internal_message();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void LogMessage::set_message(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.message_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.LogMessage.message)
+}
+inline std::string* LogMessage::mutable_message() {
+  std::string* _s = _internal_mutable_message();
+  // @@protoc_insertion_point(field_mutable:tensorflow.LogMessage.message)
+  return _s;
+}
+inline const std::string& LogMessage::_internal_message() const {
+  return _impl_.message_.Get();
+}
+inline void LogMessage::_internal_set_message(const std::string& value) {
+  
+  _impl_.message_.Set(value, GetArenaForAllocation());
+}
+inline std::string* LogMessage::_internal_mutable_message() {
+  
+  return _impl_.message_.Mutable(GetArenaForAllocation());
+}
+inline std::string* LogMessage::release_message() {
+  // @@protoc_insertion_point(field_release:tensorflow.LogMessage.message)
+  return _impl_.message_.Release();
+}
+inline void LogMessage::set_allocated_message(std::string* message) {
+  if (message != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.message_.SetAllocated(message, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.message_.IsDefault()) {
+    _impl_.message_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.LogMessage.message)
+}
+
+// -------------------------------------------------------------------
+
+// SessionLog
+
+// .tensorflow.SessionLog.SessionStatus status = 1;
+inline void SessionLog::clear_status() {
+  _impl_.status_ = 0;
+}
+inline ::tensorflow::SessionLog_SessionStatus SessionLog::_internal_status() const {
+  return static_cast< ::tensorflow::SessionLog_SessionStatus >(_impl_.status_);
+}
+inline ::tensorflow::SessionLog_SessionStatus SessionLog::status() const {
+  // @@protoc_insertion_point(field_get:tensorflow.SessionLog.status)
+  return _internal_status();
+}
+inline void SessionLog::_internal_set_status(::tensorflow::SessionLog_SessionStatus value) {
+  
+  _impl_.status_ = value;
+}
+inline void SessionLog::set_status(::tensorflow::SessionLog_SessionStatus value) {
+  _internal_set_status(value);
+  // @@protoc_insertion_point(field_set:tensorflow.SessionLog.status)
+}
+
+// string checkpoint_path = 2;
+inline void SessionLog::clear_checkpoint_path() {
+  _impl_.checkpoint_path_.ClearToEmpty();
+}
+inline const std::string& SessionLog::checkpoint_path() const {
+  // @@protoc_insertion_point(field_get:tensorflow.SessionLog.checkpoint_path)
+  return _internal_checkpoint_path();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void SessionLog::set_checkpoint_path(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.checkpoint_path_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.SessionLog.checkpoint_path)
+}
+inline std::string* SessionLog::mutable_checkpoint_path() {
+  std::string* _s = _internal_mutable_checkpoint_path();
+  // @@protoc_insertion_point(field_mutable:tensorflow.SessionLog.checkpoint_path)
+  return _s;
+}
+inline const std::string& SessionLog::_internal_checkpoint_path() const {
+  return _impl_.checkpoint_path_.Get();
+}
+inline void SessionLog::_internal_set_checkpoint_path(const std::string& value) {
+  
+  _impl_.checkpoint_path_.Set(value, GetArenaForAllocation());
+}
+inline std::string* SessionLog::_internal_mutable_checkpoint_path() {
+  
+  return _impl_.checkpoint_path_.Mutable(GetArenaForAllocation());
+}
+inline std::string* SessionLog::release_checkpoint_path() {
+  // @@protoc_insertion_point(field_release:tensorflow.SessionLog.checkpoint_path)
+  return _impl_.checkpoint_path_.Release();
+}
+inline void SessionLog::set_allocated_checkpoint_path(std::string* checkpoint_path) {
+  if (checkpoint_path != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.checkpoint_path_.SetAllocated(checkpoint_path, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.checkpoint_path_.IsDefault()) {
+    _impl_.checkpoint_path_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.SessionLog.checkpoint_path)
+}
+
+// string msg = 3;
+inline void SessionLog::clear_msg() {
+  _impl_.msg_.ClearToEmpty();
+}
+inline const std::string& SessionLog::msg() const {
+  // @@protoc_insertion_point(field_get:tensorflow.SessionLog.msg)
+  return _internal_msg();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void SessionLog::set_msg(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.msg_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.SessionLog.msg)
+}
+inline std::string* SessionLog::mutable_msg() {
+  std::string* _s = _internal_mutable_msg();
+  // @@protoc_insertion_point(field_mutable:tensorflow.SessionLog.msg)
+  return _s;
+}
+inline const std::string& SessionLog::_internal_msg() const {
+  return _impl_.msg_.Get();
+}
+inline void SessionLog::_internal_set_msg(const std::string& value) {
+  
+  _impl_.msg_.Set(value, GetArenaForAllocation());
+}
+inline std::string* SessionLog::_internal_mutable_msg() {
+  
+  return _impl_.msg_.Mutable(GetArenaForAllocation());
+}
+inline std::string* SessionLog::release_msg() {
+  // @@protoc_insertion_point(field_release:tensorflow.SessionLog.msg)
+  return _impl_.msg_.Release();
+}
+inline void SessionLog::set_allocated_msg(std::string* msg) {
+  if (msg != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.msg_.SetAllocated(msg, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.msg_.IsDefault()) {
+    _impl_.msg_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.SessionLog.msg)
+}
+
+// -------------------------------------------------------------------
+
+// TaggedRunMetadata
+
+// string tag = 1;
+inline void TaggedRunMetadata::clear_tag() {
+  _impl_.tag_.ClearToEmpty();
+}
+inline const std::string& TaggedRunMetadata::tag() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TaggedRunMetadata.tag)
+  return _internal_tag();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void TaggedRunMetadata::set_tag(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.tag_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.TaggedRunMetadata.tag)
+}
+inline std::string* TaggedRunMetadata::mutable_tag() {
+  std::string* _s = _internal_mutable_tag();
+  // @@protoc_insertion_point(field_mutable:tensorflow.TaggedRunMetadata.tag)
+  return _s;
+}
+inline const std::string& TaggedRunMetadata::_internal_tag() const {
+  return _impl_.tag_.Get();
+}
+inline void TaggedRunMetadata::_internal_set_tag(const std::string& value) {
+  
+  _impl_.tag_.Set(value, GetArenaForAllocation());
+}
+inline std::string* TaggedRunMetadata::_internal_mutable_tag() {
+  
+  return _impl_.tag_.Mutable(GetArenaForAllocation());
+}
+inline std::string* TaggedRunMetadata::release_tag() {
+  // @@protoc_insertion_point(field_release:tensorflow.TaggedRunMetadata.tag)
+  return _impl_.tag_.Release();
+}
+inline void TaggedRunMetadata::set_allocated_tag(std::string* tag) {
+  if (tag != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.tag_.SetAllocated(tag, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.tag_.IsDefault()) {
+    _impl_.tag_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.TaggedRunMetadata.tag)
+}
+
+// bytes run_metadata = 2;
+inline void TaggedRunMetadata::clear_run_metadata() {
+  _impl_.run_metadata_.ClearToEmpty();
+}
+inline const std::string& TaggedRunMetadata::run_metadata() const {
+  // @@protoc_insertion_point(field_get:tensorflow.TaggedRunMetadata.run_metadata)
+  return _internal_run_metadata();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void TaggedRunMetadata::set_run_metadata(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.run_metadata_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:tensorflow.TaggedRunMetadata.run_metadata)
+}
+inline std::string* TaggedRunMetadata::mutable_run_metadata() {
+  std::string* _s = _internal_mutable_run_metadata();
+  // @@protoc_insertion_point(field_mutable:tensorflow.TaggedRunMetadata.run_metadata)
+  return _s;
+}
+inline const std::string& TaggedRunMetadata::_internal_run_metadata() const {
+  return _impl_.run_metadata_.Get();
+}
+inline void TaggedRunMetadata::_internal_set_run_metadata(const std::string& value) {
+  
+  _impl_.run_metadata_.Set(value, GetArenaForAllocation());
+}
+inline std::string* TaggedRunMetadata::_internal_mutable_run_metadata() {
+  
+  return _impl_.run_metadata_.Mutable(GetArenaForAllocation());
+}
+inline std::string* TaggedRunMetadata::release_run_metadata() {
+  // @@protoc_insertion_point(field_release:tensorflow.TaggedRunMetadata.run_metadata)
+  return _impl_.run_metadata_.Release();
+}
+inline void TaggedRunMetadata::set_allocated_run_metadata(std::string* run_metadata) {
+  if (run_metadata != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.run_metadata_.SetAllocated(run_metadata, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.run_metadata_.IsDefault()) {
+    _impl_.run_metadata_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:tensorflow.TaggedRunMetadata.run_metadata)
+}
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic pop
+#endif  // __GNUC__
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+
+// @@protoc_insertion_point(namespace_scope)
+
+}  // namespace tensorflow
+
+PROTOBUF_NAMESPACE_OPEN
+
+template <> struct is_proto_enum< ::tensorflow::LogMessage_Level> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::tensorflow::LogMessage_Level>() {
+  return ::tensorflow::LogMessage_Level_descriptor();
+}
+template <> struct is_proto_enum< ::tensorflow::SessionLog_SessionStatus> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::tensorflow::SessionLog_SessionStatus>() {
+  return ::tensorflow::SessionLog_SessionStatus_descriptor();
+}
+template <> struct is_proto_enum< ::tensorflow::DataType> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::tensorflow::DataType>() {
+  return ::tensorflow::DataType_descriptor();
+}
+
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+
+#include <google/protobuf/port_undef.inc>
+#endif  // GOOGLE_PROTOBUF_INCLUDED_GOOGLE_PROTOBUF_INCLUDED_tensorboard_2eproto
@@ -11,6 +11,7 @@
 #include "Basics.h"
 #define FORMAT_SPECIALIZE // to get the specialized version of the format routines
 #include "File.h"
+#include "MappedFile.h"
 #include "Config.h"
 #include <string>
 #include <stdint.h>
@@ -123,6 +124,7 @@ void File::Init(const wchar_t* filename, int fileOptions)
     //  - "cmd|" reads from a pipe
     m_pcloseNeeded = false;
     m_seekable = false;
+    m_mappingFailed = false;
     if (m_filename == L"-") // stdin/stdout
     {
         if (writing && reading)
@@ -255,6 +257,27 @@ bool File::IsTextBased()
     return !!(m_options & fileOptionsText);
 }
 
+shared_ptr<MappedFile> File::GetMappedFile()
+{
+    if (m_mappedFile || m_mappingFailed)
+        return m_mappedFile;
+
+    if (m_seekable && !(m_options & fileOptionsWrite) && (m_options & fileOptionsBinary))
+    {
+        try
+        {
+            // copy-on-write, since the users of the mapping (e.g. the parameters of a model) may get updated
+            m_mappedFile = make_shared<MappedFile>(m_filename, /*copyOnWrite=*/true);
+        }
+        catch (const exception& e)
+        {
+            fprintf(stderr, "GetMappedFile: %s Reading the file instead.\n", e.what());
+        }
+    }
+    m_mappingFailed = !m_mappedFile;
+    return m_mappedFile;
+}
+
 // File Destructor
 // closes the file
 // Note: this does not check for errors when the File corresponds to pipe stream. In this case, use Flush() before closing a file you are writing.
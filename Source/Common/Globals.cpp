@@ -4,6 +4,7 @@
 //
 
 #include "Globals.h"
+#include <string>
 #include <unordered_map>
 
 using namespace std;
@@ -16,6 +17,10 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 
     std::atomic<bool> Globals::m_enableShareNodeValueMatrices(true);
     std::atomic<bool> Globals::m_optimizeGradientAccumulation(true);
+    std::atomic<bool> Globals::m_fuseElementwiseNodes(false);
+    std::atomic<bool> Globals::m_planMemoryPerMinibatch(false);
+    std::atomic<bool> Globals::m_useMemoryArena(false);
+    std::atomic<bool> Globals::m_useHugePagesForMemoryArena(false);
 
     // Note: this is a map that transfers the old reader and writer names to
     //       the new naming scheme
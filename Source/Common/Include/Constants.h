@@ -11,4 +11,10 @@
 const size_t DEFAULT_PACK_THRESHOLD_SIZE_IN_KB = 32;
 const size_t DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES = DEFAULT_PACK_THRESHOLD_SIZE_IN_KB * 1024;
 
+// Constants used by the ring and hierarchical implementations of MPIWrapper::AllReduce().
+// Buffers smaller than this are always reduced with MPI_Allreduce.
+const size_t DEFAULT_ALLREDUCE_MIN_SIZE_IN_KB = 1024;
+// Each step of the ring is split into chunks of this size, so that the sum of a chunk overlaps with the transfer of the next ones.
+const size_t DEFAULT_ALLREDUCE_CHUNK_SIZE_IN_KB = 256;
+
 #endif
@@ -26,6 +26,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <future>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -355,6 +356,22 @@ public:
     // resetRNN - flags whether to reset memory cells of RNN. 
     //
     virtual void ForwardPass(const ValueRefs<ElemType>& inputs, ValueRefs<ElemType>& output, bool resetRNN) = 0;
+
+    //
+    // CreateThreadContext - create another evaluator for the same outputs, which shares the model parameters
+    // (read-only) with this one but has its own internal state, so that it can run ForwardPass() concurrently
+    // with this evaluator and with other contexts. Each context must only be used by one thread at a time and
+    // be released by calling Destroy().
+    // Must be called after StartForwardEvaluation(), and not while ForwardPass() runs on this evaluator.
+    //
+    virtual IEvaluateModelExtended<ElemType>* CreateThreadContext() = 0;
+
+    //
+    // ForwardPassBatch - Evaluate several independent sequences in a single minibatch, one sequence per entry of
+    // inputs and outputs, which are laid out like the arguments of ForwardPass(). The sequences may have different
+    // lengths. Every sequence starts with reset RNN state.
+    //
+    virtual void ForwardPassBatch(const std::vector<const Values<ElemType>*>& inputs, const std::vector<Values<ElemType>*>& outputs) = 0;
 };
 
 template <typename ElemType>
@@ -362,4 +379,57 @@ void EVAL_API GetEvalExtended(IEvaluateModelExtended<ElemType>** peval);
 extern "C" EVAL_API void GetEvalExtendedF(IEvaluateModelExtended<float>** peval);
 extern "C" EVAL_API void GetEvalExtendedD(IEvaluateModelExtended<double>** peval);
 
+// ------------------------------------------------------------------------
+// Batching interface
+// ------------------------------------------------------------------------
+
+//
+// Evaluation of requests from many threads concurrently. Requests that arrive within a short time window are
+// evaluated together in one minibatch (with ForwardPassBatch()), which is much more efficient than evaluating
+// single sequences.
+//
+template <typename ElemType>
+class IEvaluateModelBatching
+{
+public:
+    //
+    // The input and output schema of the underlying evaluator.
+    //
+    virtual VariableSchema GetInputSchema() const = 0;
+    virtual VariableSchema GetOutputSchema() const = 0;
+
+    //
+    // ForwardPassAsync - Queue a sequence for evaluation. The arguments are the same as for
+    // IEvaluateModelExtended::ForwardPass(), and must stay valid until the returned future is ready; errors
+    // are reported through the future.
+    // With resetRNN = true, the sequence is batched and evaluated from the initial RNN state. The state left behind
+    // by a minibatch belongs to the sequences of other callers, so a thread that passes resetRNN = false gets its own
+    // evaluator (see IEvaluateModelExtended::CreateThreadContext()), which keeps the RNN state between the calls of
+    // that thread; from then on, all its requests are evaluated there, on the calling thread, and are not batched.
+    // The first resetRNN = false request of a thread has no state to continue, and starts a new sequence.
+    // This method is thread-safe.
+    //
+    virtual std::future<void> ForwardPassAsync(const Values<ElemType>& inputs, Values<ElemType>& outputs, bool resetRNN = true) = 0;
+
+    //
+    // Same as above, but waits for the result.
+    //
+    virtual void ForwardPass(const Values<ElemType>& inputs, Values<ElemType>& outputs, bool resetRNN = true) = 0;
+
+    //
+    // Evaluate the pending requests, stop and free all resources, including the underlying evaluator.
+    //
+    virtual void Destroy() = 0;
+};
+
+//
+// GetEvalBatching - Create a batching evaluator on top of an evaluator on which StartForwardEvaluation() was
+// called; it takes ownership of eval. A minibatch is evaluated once it has maxBatchSize sequences, or once
+// its first request has waited for maxLatencyMicroseconds.
+//
+template <typename ElemType>
+void EVAL_API GetEvalBatching(IEvaluateModelExtended<ElemType>* eval, size_t maxBatchSize, size_t maxLatencyMicroseconds, IEvaluateModelBatching<ElemType>** peval);
+extern "C" EVAL_API void GetEvalBatchingF(IEvaluateModelExtended<float>* eval, size_t maxBatchSize, size_t maxLatencyMicroseconds, IEvaluateModelBatching<float>** peval);
+extern "C" EVAL_API void GetEvalBatchingD(IEvaluateModelExtended<double>* eval, size_t maxBatchSize, size_t maxLatencyMicroseconds, IEvaluateModelBatching<double>** peval);
+
 } } }
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <stdint.h>
+#include <memory>
 #ifdef _WIN32
 #define NOMINMAX
 #include "Windows.h"
@@ -34,6 +35,7 @@ enum FileOptions
     fileOptionsRead = 8,                                        // open in read mode
     fileOptionsWrite = 16,                                      // open in write mode
     fileOptionsSequential = 32,                                 // optimize for sequential reads (allocates big buffer)
+    fileOptionsMappable = 64,                                   // binary, writing: page-align the data of dense matrices, so that readers can memory-map them (see Matrix::Write())
     fileOptionsReadWrite = fileOptionsRead | fileOptionsWrite,  // read/write mode
 };
 
@@ -91,6 +93,8 @@ static void attempt(const FUNCTION& body)
     // msra::util::attempt<FUNCTION> (retries, body);
 }
 
+class MappedFile;
+
 class File
 {
 private:
@@ -99,6 +103,8 @@ private:
     bool m_pcloseNeeded; // was opened with popen(), use pclose() when destructing
     bool m_seekable;     // this stream is seekable
     int m_options;       // FileOptions ored togther
+    std::shared_ptr<MappedFile> m_mappedFile; // created by GetMappedFile() on first use
+    bool m_mappingFailed;                     // GetMappedFile() already failed, don't try again
     void Init(const wchar_t* filename, int fileOptions);
 
 public:
@@ -116,6 +122,11 @@ public:
     void SkipToDelimiter(int delim);
 
     bool IsTextBased();
+    bool IsMappable() const { return (m_options & (fileOptionsMappable | fileOptionsType)) == (fileOptionsMappable | fileOptionsBinary); }
+
+    // A copy-on-write memory mapping of the whole file, for reading data in place instead of through the stream.
+    // Only regular binary files that are opened for reading only can be mapped; otherwise, or if mapping fails, this returns nullptr.
+    std::shared_ptr<MappedFile> GetMappedFile();
 
     bool IsUnicodeBOM(bool skip = false);
     bool IsEOF();
@@ -22,6 +22,22 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static void SetGradientAccumulationOptimization(bool enable) { m_optimizeGradientAccumulation = enable; }
         static bool ShouldOptimizeGradientAccumulation() { return m_optimizeGradientAccumulation; }
 
+        // fuse chains of elementwise nodes into a single pass over the data when compiling a network (CPU only)
+        // Off by default; enabled by the BrainScript option 'fuseElementwiseNodes'.
+        static void SetElementwiseNodeFusion(bool enable) { m_fuseElementwiseNodes = enable; }
+        static bool ShouldFuseElementwiseNodes() { return m_fuseElementwiseNodes; }
+
+        // redo the memory sharing plan of a network once the actual minibatch sizes are known (see MatrixPool::PlanForMinibatch())
+        // Off by default until it is covered by a distributed training test.
+        static void SetMinibatchAwareMemoryPlanning(bool enable) { m_planMemoryPerMinibatch = enable; }
+        static bool ShouldPlanMemoryPerMinibatch() { return m_planMemoryPerMinibatch; }
+
+        // place all CPU node matrices into a single memory arena, optionally backed by huge pages (requires planMemoryPerMinibatch=true; the config readers reject it otherwise)
+        static void SetMemoryArena(bool enable) { m_useMemoryArena = enable; }
+        static bool ShouldUseMemoryArena() { return m_useMemoryArena; }
+        static void SetMemoryArenaHugePages(bool enable) { m_useHugePagesForMemoryArena = enable; }
+        static bool ShouldUseHugePagesForMemoryArena() { return m_useHugePagesForMemoryArena; }
+
         // TODO: Currently the flag is set to false. Should be switched to true after more rigorous testing.
         static bool UseV2Aggregator() { return false; }
 
@@ -34,5 +50,9 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static std::atomic<bool> m_enableShareNodeValueMatrices;
         static std::atomic<bool> m_forceConstantRandomSeed;
         static std::atomic<bool> m_optimizeGradientAccumulation;
+        static std::atomic<bool> m_fuseElementwiseNodes;
+        static std::atomic<bool> m_planMemoryPerMinibatch;
+        static std::atomic<bool> m_useMemoryArena;
+        static std::atomic<bool> m_useHugePagesForMemoryArena;
     };
 }}}
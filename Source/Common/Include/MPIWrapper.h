@@ -32,6 +32,7 @@ typedef enum _MPI_Datatype { MPI_CHAR, MPI_INT, MPI_FLOAT, MPI_DOUBLE, MPI_UNSIG
 #define MPI_STATUSES_IGNORE  (MPI_Status*)1
 #define MPI_STATUS_IGNORE    (MPI_Status*)1
 #define MPI_UNDEFINED        (-32766)
+#define MPI_REQUEST_NULL     ((MPI_Request)0x2c000000)
 
 typedef int MPI_Op;
 typedef int MPI_Request;
@@ -45,6 +46,7 @@ typedef void *MPI_Status;
 #include <memory>
 
 #include "CommonMatrix.h"
+#include "Constants.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -61,6 +63,15 @@ extern int operator||(int rc, const MpiFail &what);
 class MPIWrapper;
 typedef std::shared_ptr<MPIWrapper> MPIWrapperPtr;
 
+// Implementation used by MPIWrapper::AllReduce() to sum float and double buffers, see SetAllReduceAlgorithm()
+enum class AllReduceAlgorithm
+{
+    Mpi,          // MPI_Allreduce, the algorithm is chosen by the MPI library
+    Ring,         // ring reduce-scatter followed by a ring all-gather
+    Hierarchical, // ring reduce-scatter within each host, ring all-reduce of the shards across hosts, ring all-gather within each host
+    Auto          // Hierarchical when running on several hosts with the same number of nodes each, Ring otherwise
+};
+
 extern "C" void GetMpiWrapper(MPIWrapper **mpi);
 
 // Note: This is now a pure interface, so please don't add
@@ -107,6 +118,7 @@ public:
     virtual int Wait(MPI_Request* request, MPI_Status* status) = 0;
     virtual int Waitany(int count, MPI_Request array_of_requests[], int* index, MPI_Status* status) = 0;
     virtual int Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]) = 0;
+    virtual int Testall(int count, MPI_Request array_of_requests[], int* flag, MPI_Status array_of_statuses[]) = 0;
     virtual int Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, /*MPI_Comm comm,*/ MPI_Request* request) = 0;
     virtual int Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Status* status) = 0;
     virtual int Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Request* request) = 0;
@@ -148,6 +160,14 @@ public:
     virtual void AllReduceAsync(double* sendData, double* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const = 0;
     virtual void AllReduceAsync(float* sendData, float* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const = 0;
 
+    // Selects the implementation of the blocking AllReduce() of MPI_SUM for float and double buffers of at least minSizeInBytes.
+    // The ring implementations send the data in chunks of chunkSizeInBytes. Smaller buffers and other ops always use MPI_Allreduce.
+    virtual void SetAllReduceAlgorithm(AllReduceAlgorithm algorithm, size_t minSizeInBytes, size_t chunkSizeInBytes) = 0;
+
+    // allreduce (sum) of several buffers, buffers smaller than fusionSizeInBytes are packed together to be reduced with fewer MPI calls
+    virtual void AllReduceFused(const std::vector<float*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const = 0;
+    virtual void AllReduceFused(const std::vector<double*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const = 0;
+
     virtual void Bcast(size_t* sendData, size_t numElements, size_t srcRank) = 0;
     virtual void Bcast(double* sendData, size_t numElements, size_t srcRank) = 0;
     virtual void Bcast(float* sendData, size_t numElements, size_t srcRank) = 0;
@@ -0,0 +1,57 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include "Basics.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// A mapping of a whole file into memory. The file itself is never modified.
+// Users point into the mapping, and keep it alive through a shared_ptr (e.g. the chunks of the binary reader,
+// or the matrices of a model read from a file written with fileOptionsMappable, see Matrix::Read()).
+// With 'copyOnWrite', the mapped pages may be written to; a page is then copied on its first write, and only
+// the process that wrote it sees the change. Pages that are never written are shared among all processes mapping the file.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::wstring& filename, bool copyOnWrite = false);
+    ~MappedFile();
+
+    const char* Data() const { return m_data; }
+    uint64_t Size() const { return m_size; }
+
+    // only for mappings created with 'copyOnWrite'
+    char* MutableData() const
+    {
+        if (!m_copyOnWrite)
+            LogicError("MappedFile: '%ls' is mapped read-only.", m_filename.c_str());
+        return m_data;
+    }
+
+    // Asks the OS to start reading [offset, offset + size) from disk, so that it is resident when it is parsed.
+    // 'sequential' additionally requests aggressive read-ahead for the range.
+    // These are hints only, failures are ignored (and on Windows 7, which lacks PrefetchVirtualMemory(), it does nothing).
+    void Prefetch(uint64_t offset, uint64_t size, bool sequential) const;
+
+private:
+    std::wstring m_filename;
+    char* m_data;
+    uint64_t m_size;
+    bool m_copyOnWrite;
+#ifdef _WIN32
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#endif
+
+    DISABLE_COPY_AND_MOVE(MappedFile);
+};
+
+typedef std::shared_ptr<MappedFile> MappedFilePtr;
+
+}}}
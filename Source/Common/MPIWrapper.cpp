@@ -33,6 +33,29 @@ class MPIWrapperMpi : public MPIWrapper
     // MPI communicator that reflects the current subset selection
     MPI_Comm m_currentComm;
 
+    // settings and communicators of the ring and hierarchical AllReduce(), see SetAllReduceAlgorithm()
+    AllReduceAlgorithm m_allReduceAlgorithm;
+    size_t m_allReduceMinSizeInBytes;
+    size_t m_allReduceChunkSizeInBytes;
+    MPI_Comm m_ringComm;      // duplicate of m_currentComm, so that the messages of the ring never match other receives
+    MPI_Comm m_intraHostComm; // nodes on the same host
+    MPI_Comm m_interHostComm; // nodes with the same rank within their host
+    bool m_uniformHosts;      // whether all hosts run the same number of nodes, as needed by the hierarchical all-reduce
+
+    void InitAllReduceCommunicators();
+
+    // returns false if the buffer is to be reduced with MPI_Allreduce instead
+    template <class ElemType>
+    bool RingAllReduce(ElemType* sendData, ElemType* receiveData, size_t numElements, MPI_Op op) const;
+    template <class ElemType>
+    void RingReduceScatter(ElemType* data, size_t numElements, MPI_Comm comm) const;
+    template <class ElemType>
+    void RingAllGather(ElemType* data, size_t numElements, MPI_Comm comm) const;
+    template <class ElemType>
+    void RingStep(const ElemType* sendData, size_t numSendElements, ElemType* receiveData, size_t numReceiveElements, ElemType* addBuffer, MPI_Comm comm) const;
+    template <class ElemType>
+    void AllReduceFusedImpl(const std::vector<ElemType*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const;
+
     // MPI_Init() is loading the msmpi.dll. Failing to load the dll will terminate the
     // application.
     int MPI_Init_DL();
@@ -82,6 +105,7 @@ public:
     virtual int Wait(MPI_Request* request, MPI_Status* status);
     virtual int Waitany(int count, MPI_Request array_of_requests[], int* index, MPI_Status* status);
     virtual int Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]);
+    virtual int Testall(int count, MPI_Request array_of_requests[], int* flag, MPI_Status array_of_statuses[]);
     virtual int Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, /*MPI_Comm comm,*/ MPI_Request* request);
     virtual int Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Status* status);
     virtual int Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Request* request);
@@ -116,6 +140,11 @@ public:
     virtual void AllReduceAsync(double* sendData, double* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const;
     virtual void AllReduceAsync(float* sendData, float* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const;
 
+    virtual void SetAllReduceAlgorithm(AllReduceAlgorithm algorithm, size_t minSizeInBytes, size_t chunkSizeInBytes);
+
+    virtual void AllReduceFused(const std::vector<float*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const;
+    virtual void AllReduceFused(const std::vector<double*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const;
+
     virtual void Bcast(size_t* sendData, size_t numElements, size_t srcRank);
     virtual void Bcast(double* sendData, size_t numElements, size_t srcRank);
     virtual void Bcast(float* sendData, size_t numElements, size_t srcRank);
@@ -179,6 +208,7 @@ public:
     virtual int Wait(MPI_Request* request, MPI_Status* status);
     virtual int Waitany(int count, MPI_Request array_of_requests[], int* index, MPI_Status* status);
     virtual int Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]);
+    virtual int Testall(int count, MPI_Request array_of_requests[], int* flag, MPI_Status array_of_statuses[]);
     virtual int Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, /*MPI_Comm comm,*/ MPI_Request* request);
     virtual int Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Status* status);
     virtual int Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, /*MPI_Comm comm,*/ MPI_Request* request);
@@ -213,6 +243,11 @@ public:
     virtual void AllReduceAsync(double* sendData, double* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const;
     virtual void AllReduceAsync(float* sendData, float* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const;
 
+    virtual void SetAllReduceAlgorithm(AllReduceAlgorithm algorithm, size_t minSizeInBytes, size_t chunkSizeInBytes);
+
+    virtual void AllReduceFused(const std::vector<float*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const;
+    virtual void AllReduceFused(const std::vector<double*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const;
+
     virtual void Bcast(size_t* sendData, size_t numElements, size_t srcRank);
     virtual void Bcast(double* sendData, size_t numElements, size_t srcRank);
     virtual void Bcast(float* sendData, size_t numElements, size_t srcRank);
@@ -394,7 +429,14 @@ int MPIWrapper::GetTotalNumberOfMPINodes()
 int MPIWrapperMpi::s_myRank = -1;
 
 MPIWrapperMpi::MPIWrapperMpi()
-    : m_currentComm(MPI_COMM_WORLD)
+    : m_currentComm(MPI_COMM_WORLD),
+      m_allReduceAlgorithm(AllReduceAlgorithm::Mpi),
+      m_allReduceMinSizeInBytes(DEFAULT_ALLREDUCE_MIN_SIZE_IN_KB * 1024),
+      m_allReduceChunkSizeInBytes(DEFAULT_ALLREDUCE_CHUNK_SIZE_IN_KB * 1024),
+      m_ringComm(MPI_COMM_NULL),
+      m_intraHostComm(MPI_COMM_NULL),
+      m_interHostComm(MPI_COMM_NULL),
+      m_uniformHosts(false)
 {
     static bool initialized = false;
     if (initialized)
@@ -604,12 +646,37 @@ void MPIWrapperMpi::RequestNodes(const char *msg, size_t requestednodes /*defaul
         }
     }
 
+    InitAllReduceCommunicators();
+
     fprintf(stderr, "requestnodes [%s]: using %d out of %d MPI nodes on %s (%d requested); we (%d) are %s\n",
         msg, (int)m_numNodesInUse, (int)m_numMPINodes, m_multiHost ? "multiple hosts" : "a single host",
         (int)requestednodes, (int)CurrentNodeRank(), IsIdle() ? "out (idle)" : "in (participating)");
     fflush(stderr);
 }
 
+// Create the communicators used by the ring and hierarchical AllReduce() for the current set of nodes.
+void MPIWrapperMpi::InitAllReduceCommunicators()
+{
+    for (auto comm : { &m_ringComm, &m_intraHostComm, &m_interHostComm })
+    {
+        if (*comm != MPI_COMM_NULL)
+            MPI_Comm_free(comm) || MpiFail("InitAllReduceCommunicators: MPI_Comm_free");
+    }
+
+    MPI_Comm_dup(m_currentComm, &m_ringComm) || MpiFail("InitAllReduceCommunicators: MPI_Comm_dup");
+    MPI_Comm_split_type(m_currentComm, MPI_COMM_TYPE_SHARED, m_myRank, MPI_INFO_NULL, &m_intraHostComm) || MpiFail("InitAllReduceCommunicators: MPI_Comm_split_type");
+
+    int localRank, localSize;
+    MPI_Comm_rank(m_intraHostComm, &localRank) || MpiFail("InitAllReduceCommunicators: MPI_Comm_rank");
+    MPI_Comm_size(m_intraHostComm, &localSize) || MpiFail("InitAllReduceCommunicators: MPI_Comm_size");
+    MPI_Comm_split(m_currentComm, localRank, m_myRank, &m_interHostComm) || MpiFail("InitAllReduceCommunicators: MPI_Comm_split");
+
+    int minLocalSize, maxLocalSize;
+    MPI_Allreduce(&localSize, &minLocalSize, 1, MPI_INT, MPI_MIN, m_currentComm) || MpiFail("InitAllReduceCommunicators: MPI_Allreduce");
+    MPI_Allreduce(&localSize, &maxLocalSize, 1, MPI_INT, MPI_MAX, m_currentComm) || MpiFail("InitAllReduceCommunicators: MPI_Allreduce");
+    m_uniformHosts = (minLocalSize == maxLocalSize);
+}
+
 bool MPIWrapperMpi::IsMultiHost() const
 {
     return m_multiHost;
@@ -651,6 +718,11 @@ int MPIWrapperMpi::Waitall(int count, MPI_Request array_of_requests[], MPI_Statu
     return MPI_Waitall(count, array_of_requests, array_of_statuses);
 }
 
+int MPIWrapperMpi::Testall(int count, MPI_Request array_of_requests[], int* flag, MPI_Status array_of_statuses[])
+{
+    return MPI_Testall(count, array_of_requests, flag, array_of_statuses);
+}
+
 int MPIWrapperMpi::Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Request* request)
 {
     return MPI_Isend(buf, count, datatype, dest, tag, m_currentComm, request);
@@ -797,14 +869,228 @@ void MPIWrapperMpi::AllReduce(int* sendData, int* receiveData, size_t numElement
 
 void MPIWrapperMpi::AllReduce(double* sendData, double* receiveData, size_t numElements, MPI_Op op) const
 {
+    if (RingAllReduce(sendData, receiveData, numElements, op))
+        return;
+
     MPI_Allreduce(sendData, receiveData, (int)numElements, GetDataType(sendData), op, Communicator()) || MpiFail("Allreduce: MPI_Allreduce");
 }
 
 void MPIWrapperMpi::AllReduce(float* sendData, float* receiveData, size_t numElements, MPI_Op op) const
 {
+    if (RingAllReduce(sendData, receiveData, numElements, op))
+        return;
+
     MPI_Allreduce(sendData, receiveData, (int)numElements, GetDataType(sendData), op, Communicator()) || MpiFail("Allreduce: MPI_Allreduce");
 }
 
+void MPIWrapperMpi::SetAllReduceAlgorithm(AllReduceAlgorithm algorithm, size_t minSizeInBytes, size_t chunkSizeInBytes)
+{
+    if (chunkSizeInBytes == 0)
+        InvalidArgument("SetAllReduceAlgorithm: the chunk size must be positive.");
+
+    m_allReduceAlgorithm = algorithm;
+    m_allReduceMinSizeInBytes = minSizeInBytes;
+    m_allReduceChunkSizeInBytes = chunkSizeInBytes;
+}
+
+// Sums with the ring algorithm: the buffer is cut into one segment per node. In the reduce-scatter phase,
+// each node passes a partial sum of one segment to the next node in the ring and adds the segment received
+// from the previous one, so that after N-1 steps each node holds the full sum of one segment. The all-gather
+// phase passes the full sums around the ring in N-1 more steps. Each node sends and receives 2*(N-1)/N times
+// the buffer size, independent of the number of nodes.
+// The hierarchical variant does the reduce-scatter and all-gather within each host, and only the shard of
+// each node crosses the network, in a ring with the nodes of the same local rank on the other hosts.
+template <class ElemType>
+bool MPIWrapperMpi::RingAllReduce(ElemType* sendData, ElemType* receiveData, size_t numElements, MPI_Op op) const
+{
+    if (m_allReduceAlgorithm == AllReduceAlgorithm::Mpi || op != MPI_SUM || m_ringComm == MPI_COMM_NULL ||
+        numElements * sizeof(ElemType) < m_allReduceMinSizeInBytes || m_numNodesInUse < 2)
+    {
+        return false;
+    }
+
+    if (sendData != static_cast<ElemType*>(MPI_IN_PLACE))
+        memcpy(receiveData, sendData, numElements * sizeof(ElemType));
+
+    bool hierarchical = m_uniformHosts && (m_allReduceAlgorithm == AllReduceAlgorithm::Hierarchical ||
+                                           (m_allReduceAlgorithm == AllReduceAlgorithm::Auto && m_multiHost));
+    if (hierarchical)
+    {
+        int localRank, localSize;
+        MPI_Comm_rank(m_intraHostComm, &localRank) || MpiFail("AllReduce: MPI_Comm_rank");
+        MPI_Comm_size(m_intraHostComm, &localSize) || MpiFail("AllReduce: MPI_Comm_size");
+
+        RingReduceScatter(receiveData, numElements, m_intraHostComm);
+
+        // after the reduce-scatter, this node holds the segment after its own rank
+        size_t segment = (localRank + 1) % localSize;
+        size_t begin = numElements * segment / localSize;
+        size_t end = numElements * (segment + 1) / localSize;
+        RingReduceScatter(receiveData + begin, end - begin, m_interHostComm);
+        RingAllGather(receiveData + begin, end - begin, m_interHostComm);
+
+        RingAllGather(receiveData, numElements, m_intraHostComm);
+    }
+    else
+    {
+        RingReduceScatter(receiveData, numElements, m_ringComm);
+        RingAllGather(receiveData, numElements, m_ringComm);
+    }
+
+    return true;
+}
+
+template <class ElemType>
+void MPIWrapperMpi::RingReduceScatter(ElemType* data, size_t numElements, MPI_Comm comm) const
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank) || MpiFail("AllReduce: MPI_Comm_rank");
+    MPI_Comm_size(comm, &size) || MpiFail("AllReduce: MPI_Comm_size");
+
+    // the received segments are added from this buffer; it is allocated once for all steps, with the size of the largest segment
+    std::vector<ElemType> addBuffer((numElements + size - 1) / size);
+
+    // in step s, node r sends its partial sum of segment r-s and adds the one of segment r-s-1 received from node r-1
+    for (int step = 0; step < size - 1; step++)
+    {
+        size_t sendSegment = (rank - step + size) % size;
+        size_t receiveSegment = (rank - step - 1 + 2 * size) % size;
+        size_t sendBegin = numElements * sendSegment / size;
+        size_t receiveBegin = numElements * receiveSegment / size;
+        RingStep(data + sendBegin, numElements * (sendSegment + 1) / size - sendBegin,
+                 data + receiveBegin, numElements * (receiveSegment + 1) / size - receiveBegin, addBuffer.data(), comm);
+    }
+}
+
+template <class ElemType>
+void MPIWrapperMpi::RingAllGather(ElemType* data, size_t numElements, MPI_Comm comm) const
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank) || MpiFail("AllReduce: MPI_Comm_rank");
+    MPI_Comm_size(comm, &size) || MpiFail("AllReduce: MPI_Comm_size");
+
+    // node r starts with the full sum of segment r+1, as left by RingReduceScatter()
+    for (int step = 0; step < size - 1; step++)
+    {
+        size_t sendSegment = (rank - step + 1 + size) % size;
+        size_t receiveSegment = (rank - step + size) % size;
+        size_t sendBegin = numElements * sendSegment / size;
+        size_t receiveBegin = numElements * receiveSegment / size;
+        RingStep(data + sendBegin, numElements * (sendSegment + 1) / size - sendBegin,
+                 data + receiveBegin, numElements * (receiveSegment + 1) / size - receiveBegin, /*addBuffer=*/(ElemType*) nullptr, comm);
+    }
+}
+
+// Send a segment to the next node in the ring while receiving one from the previous node, which is either added
+// to receiveData (if addBuffer, which must hold numReceiveElements, is given to receive it into) or copied into it.
+// The segments are sent in chunks, so that the sum of the chunks received first overlaps with the transfer of the others.
+template <class ElemType>
+void MPIWrapperMpi::RingStep(const ElemType* sendData, size_t numSendElements, ElemType* receiveData, size_t numReceiveElements, ElemType* addBuffer, MPI_Comm comm) const
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank) || MpiFail("AllReduce: MPI_Comm_rank");
+    MPI_Comm_size(comm, &size) || MpiFail("AllReduce: MPI_Comm_size");
+    int next = (rank + 1) % size;
+    int previous = (rank - 1 + size) % size;
+
+    size_t chunkSize = std::max<size_t>(m_allReduceChunkSizeInBytes / sizeof(ElemType), 1);
+    size_t numReceiveChunks = (numReceiveElements + chunkSize - 1) / chunkSize;
+    size_t numSendChunks = (numSendElements + chunkSize - 1) / chunkSize;
+
+    ElemType* receiveTarget = addBuffer ? addBuffer : receiveData;
+
+    MPI_Datatype dataType = GetDataType(receiveData);
+    std::vector<MPI_Request> receiveRequests(numReceiveChunks);
+    for (size_t i = 0; i < numReceiveChunks; i++)
+    {
+        size_t begin = i * chunkSize;
+        MPI_Irecv(receiveTarget + begin, (int)(std::min(begin + chunkSize, numReceiveElements) - begin), dataType, previous, 0, comm, &receiveRequests[i]) || MpiFail("AllReduce: MPI_Irecv");
+    }
+
+    std::vector<MPI_Request> sendRequests(numSendChunks);
+    for (size_t i = 0; i < numSendChunks; i++)
+    {
+        size_t begin = i * chunkSize;
+        MPI_Isend(const_cast<ElemType*>(sendData) + begin, (int)(std::min(begin + chunkSize, numSendElements) - begin), dataType, next, 0, comm, &sendRequests[i]) || MpiFail("AllReduce: MPI_Isend");
+    }
+
+    for (size_t i = 0; i < numReceiveChunks; i++)
+    {
+        int index = MPI_UNDEFINED;
+        MPI_Waitany((int)receiveRequests.size(), receiveRequests.data(), &index, MPI_STATUS_IGNORE) || MpiFail("AllReduce: MPI_Waitany");
+        if (addBuffer)
+        {
+            size_t begin = index * chunkSize;
+            size_t end = std::min(begin + chunkSize, numReceiveElements);
+            for (size_t j = begin; j < end; j++)
+                receiveData[j] += addBuffer[j];
+        }
+    }
+
+    if (!sendRequests.empty())
+        MPI_Waitall((int)sendRequests.size(), sendRequests.data(), MPI_STATUSES_IGNORE) || MpiFail("AllReduce: MPI_Waitall");
+}
+
+// The buffers are reduced in the given order, so all nodes must pass the same sizes in the same order.
+template <class ElemType>
+void MPIWrapperMpi::AllReduceFusedImpl(const std::vector<ElemType*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const
+{
+    if (buffers.size() != numElements.size())
+        InvalidArgument("AllReduceFused: the number of buffers and sizes must match.");
+
+    std::vector<ElemType> fusionBuffer;
+    std::vector<size_t> fused;
+    auto reduceFused = [&]()
+    {
+        if (fused.empty())
+            return;
+
+        fusionBuffer.clear();
+        for (size_t i : fused)
+            fusionBuffer.insert(fusionBuffer.end(), buffers[i], buffers[i] + numElements[i]);
+
+        AllReduce(fusionBuffer.data(), fusionBuffer.size());
+
+        size_t offset = 0;
+        for (size_t i : fused)
+        {
+            memcpy(buffers[i], fusionBuffer.data() + offset, numElements[i] * sizeof(ElemType));
+            offset += numElements[i];
+        }
+        fused.clear();
+    };
+
+    size_t fusedSizeInBytes = 0;
+    for (size_t i = 0; i < buffers.size(); i++)
+    {
+        size_t sizeInBytes = numElements[i] * sizeof(ElemType);
+        if (sizeInBytes >= fusionSizeInBytes)
+        {
+            AllReduce(buffers[i], numElements[i]);
+            continue;
+        }
+
+        if (fusedSizeInBytes + sizeInBytes > fusionSizeInBytes)
+        {
+            reduceFused();
+            fusedSizeInBytes = 0;
+        }
+        fused.push_back(i);
+        fusedSizeInBytes += sizeInBytes;
+    }
+    reduceFused();
+}
+
+void MPIWrapperMpi::AllReduceFused(const std::vector<float*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const
+{
+    AllReduceFusedImpl(buffers, numElements, fusionSizeInBytes);
+}
+
+void MPIWrapperMpi::AllReduceFused(const std::vector<double*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const
+{
+    AllReduceFusedImpl(buffers, numElements, fusionSizeInBytes);
+}
+
 void MPIWrapperMpi::Bcast(size_t* sendData, size_t numElements, size_t srcRank)
 {
     MPI_Bcast(sendData, (int)numElements, GetDataType(sendData), (int)srcRank, Communicator()) || MpiFail("Bcast: MPI_Bcast");
@@ -1034,6 +1320,11 @@ int MPIWrapperEmpty::Waitall(int count, MPI_Request array_of_requests[], MPI_Sta
     return MPI_UNDEFINED;
 }
 
+int MPIWrapperEmpty::Testall(int count, MPI_Request array_of_requests[], int* flag, MPI_Status array_of_statuses[])
+{
+    return MPI_UNDEFINED;
+}
+
 int MPIWrapperEmpty::Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Request* request)
 {
     return MPI_UNDEFINED;
@@ -1185,6 +1476,18 @@ void MPIWrapperEmpty::AllReduceAsync(float *sendData, float *receiveData, size_t
 {
 }
 
+void MPIWrapperEmpty::SetAllReduceAlgorithm(AllReduceAlgorithm algorithm, size_t minSizeInBytes, size_t chunkSizeInBytes)
+{
+}
+
+void MPIWrapperEmpty::AllReduceFused(const std::vector<float*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const
+{
+}
+
+void MPIWrapperEmpty::AllReduceFused(const std::vector<double*>& buffers, const std::vector<size_t>& numElements, size_t fusionSizeInBytes) const
+{
+}
+
 void MPIWrapperEmpty::Bcast(size_t* sendData, size_t numElements, size_t srcRank)
 {
 }
@@ -0,0 +1,159 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+#define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
+#endif
+
+#include "Basics.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#ifdef _WIN32
+#define NOMINMAX
+#include "Windows.h"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::wstring& filename, bool copyOnWrite)
+    : m_filename(filename), m_data(nullptr), m_size(0), m_copyOnWrite(copyOnWrite), m_fileHandle(INVALID_HANDLE_VALUE), m_mappingHandle(nullptr)
+{
+    m_fileHandle = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+        RuntimeError("Error opening file '%ls' for memory mapping: error code %d.", filename.c_str(), (int)GetLastError());
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_fileHandle, &size))
+    {
+        CloseHandle(m_fileHandle);
+        RuntimeError("Error getting the size of file '%ls': error code %d.", filename.c_str(), (int)GetLastError());
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+    if (m_size == 0)
+        return;
+
+    m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle != nullptr)
+        m_data = static_cast<char*>(MapViewOfFile(m_mappingHandle, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+    {
+        int error = (int)GetLastError();
+        if (m_mappingHandle != nullptr)
+            CloseHandle(m_mappingHandle);
+        CloseHandle(m_fileHandle);
+        RuntimeError("Error memory mapping file '%ls': error code %d.", filename.c_str(), error);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mappingHandle != nullptr)
+        CloseHandle(m_mappingHandle);
+    if (m_fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(m_fileHandle);
+}
+
+// PrefetchVirtualMemory() only exists since Windows 8, so it is looked up at runtime; on Windows 7, Prefetch() does nothing.
+// (The range entry is declared here since WIN32_MEMORY_RANGE_ENTRY is only defined when targeting Windows 8.)
+struct MemoryRangeEntry
+{
+    void* VirtualAddress;
+    SIZE_T NumberOfBytes;
+};
+typedef BOOL (WINAPI *PrefetchVirtualMemoryFunction)(HANDLE process, ULONG_PTR numberOfEntries, MemoryRangeEntry* entries, ULONG flags);
+
+static PrefetchVirtualMemoryFunction GetPrefetchVirtualMemory()
+{
+    static const PrefetchVirtualMemoryFunction prefetchVirtualMemory =
+        reinterpret_cast<PrefetchVirtualMemoryFunction>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "PrefetchVirtualMemory"));
+    return prefetchVirtualMemory;
+}
+
+void MappedFile::Prefetch(uint64_t offset, uint64_t size, bool /*sequential*/) const
+{
+    if (m_data == nullptr || size == 0 || offset >= m_size)
+        return;
+
+    auto prefetchVirtualMemory = GetPrefetchVirtualMemory();
+    if (prefetchVirtualMemory == nullptr)
+        return;
+
+    // The whole range is read in large requests anyway, so there is nothing extra to do for sequential access.
+    MemoryRangeEntry range = { m_data + offset, static_cast<SIZE_T>(std::min(size, m_size - offset)) };
+    prefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+#else
+
+MappedFile::MappedFile(const std::wstring& filename, bool copyOnWrite)
+    : m_filename(filename), m_data(nullptr), m_size(0), m_copyOnWrite(copyOnWrite)
+{
+    int fd = open(wtocharpath(filename).c_str(), O_RDONLY);
+    if (fd < 0)
+        RuntimeError("Error opening file '%ls' for memory mapping: %s.", filename.c_str(), strerror(errno));
+
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        int error = errno;
+        close(fd);
+        RuntimeError("Error getting the size of file '%ls': %s.", filename.c_str(), strerror(error));
+    }
+    m_size = static_cast<uint64_t>(status.st_size);
+
+    if (m_size != 0)
+    {
+        // A private mapping shares the page cache with all other mappings of the file until a page is written to.
+        void* data = copyOnWrite ? mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)
+                                 : mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            int error = errno;
+            close(fd);
+            RuntimeError("Error memory mapping file '%ls': %s.", filename.c_str(), strerror(error));
+        }
+        m_data = static_cast<char*>(data);
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr)
+        munmap(m_data, m_size);
+}
+
+void MappedFile::Prefetch(uint64_t offset, uint64_t size, bool sequential) const
+{
+    if (m_data == nullptr || size == 0 || offset >= m_size)
+        return;
+
+    // madvise() wants a page aligned address
+    static const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t begin = offset - offset % pageSize;
+    uint64_t end = std::min(offset + size, m_size);
+    char* address = m_data + begin;
+    if (sequential)
+        madvise(address, end - begin, MADV_SEQUENTIAL);
+    madvise(address, end - begin, MADV_WILLNEED);
+}
+
+#endif
+
+}}}
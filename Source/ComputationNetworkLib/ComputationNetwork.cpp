@@ -47,6 +47,30 @@ vector<MemRequestInfo<double>>& MatrixPool::GetMemRequestInfoVec<double>()
     return m_memRequestInfoDoubleVec;
 }
 
+template <>
+vector<int>& MatrixPool::GetPlanMemoryIds<float>(MemPlan& plan)
+{
+    return plan.memoryIdsFloat;
+}
+
+template <>
+vector<int>& MatrixPool::GetPlanMemoryIds<double>(MemPlan& plan)
+{
+    return plan.memoryIdsDouble;
+}
+
+template <>
+map<pair<DEVICEID_TYPE, bool>, vector<shared_ptr<Matrix<float>>>>& MatrixPool::GetPlanBuffers<float>()
+{
+    return m_planBuffersFloat;
+}
+
+template <>
+map<pair<DEVICEID_TYPE, bool>, vector<shared_ptr<Matrix<double>>>>& MatrixPool::GetPlanBuffers<double>()
+{
+    return m_planBuffersDouble;
+}
+
 // -----------------------------------------------------------------------
 // construction
 // -----------------------------------------------------------------------
@@ -111,8 +135,11 @@ void ComputationNetwork::SaveToFileImpl(const wstring& fileName, const FileOptio
     fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BCN");
 
     // model version
+    size_t modelVersion = CURRENT_CNTK_MODEL_VERSION;
+    for (const auto& nodeIter : m_nameToNodeMap)
+        modelVersion = max(modelVersion, nodeIter.second->GetModelVersionToSave());
     fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BVersion");
-    fstream << (size_t) CURRENT_CNTK_MODEL_VERSION;
+    fstream << modelVersion;
     fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EVersion");
 
     fstream << (size_t) m_nameToNodeMap.size();
@@ -208,8 +235,8 @@ size_t ComputationNetwork::GetModelVersion(File& fstream)
         fstream >> modelVersion;
         fstream.GetMarker(FileMarker::fileMarkerEndSection, L"EVersion");
     }
-    if (modelVersion > CURRENT_CNTK_MODEL_VERSION)
-        InvalidArgument("Read: The model file has a newer format version (%d) than this CNTK version can handle (%d).", (int)modelVersion, (int)CURRENT_CNTK_MODEL_VERSION);
+    if (modelVersion > LATEST_CNTK_MODEL_VERSION)
+        InvalidArgument("Read: The model file has a newer format version (%d) than this CNTK version can handle (%d).", (int)modelVersion, (int)LATEST_CNTK_MODEL_VERSION);
     
     return modelVersion;
 }
@@ -1154,6 +1181,87 @@ void ComputationNetwork::PerformSVDecomposition(const map<wstring, float>& SVDCo
     CompileNetwork();
 }
 
+// ========================================
+// This function performs post-training 8-bit quantization for evaluation on the CPU:
+// each product W * x of a weight matrix W (a LearnableParameter) whose name matches nodeNameRegex becomes an int8
+// QuantizedTimes node. The float weights stay in the network; the new nodes quantize them on their first forward pass.
+// Until they are calibrated (see QuantizedTimesNode::StartCalibration()), they quantize x with per-minibatch ranges.
+// Convolutions are not converted. Returns the number of replaced nodes.
+// ========================================
+template <class ElemType>
+size_t ComputationNetwork::QuantizeTimesNodesToInt8(const wstring& nodeNameRegex)
+{
+    if (m_deviceId != CPUDEVICE)
+        InvalidArgument("QuantizeTimesNodesToInt8: Quantized products are only supported on the CPU.");
+    if (AreMatricesAllocated())
+        LogicError("QuantizeTimesNodesToInt8: Must be called before the network's matrices are allocated.");
+
+    wregex nameFilter(nodeNameRegex);
+    vector<shared_ptr<TimesNode<ElemType>>> timesNodes;
+    for (const auto& n : m_nameToNodeMap)
+    {
+        auto timesNode = dynamic_pointer_cast<TimesNode<ElemType>>(n.second);
+        if (timesNode && regex_match(n.first, nameFilter) && dynamic_pointer_cast<LearnableParameter<ElemType>>(timesNode->GetInputs()[0]))
+            timesNodes.push_back(timesNode);
+    }
+
+    for (const auto& timesNode : timesNodes)
+    {
+        auto quantizedNode = New<QuantizedTimesNode<ElemType>>(m_deviceId, timesNode->NodeName(), 1, 1, timesNode->OutputRank(), timesNode->InferInputRankToMap(), true /*int8*/);
+        ReplaceNode(timesNode->NodeName(), quantizedNode);
+        if (TraceLevel() > 0)
+            fprintf(stderr, "QuantizeTimesNodesToInt8: %ls = Times(%ls, ...) is now an int8 QuantizedTimes.\n", timesNode->NodeName().c_str(), timesNode->GetInputs()[0]->NodeName().c_str());
+    }
+
+    // redo necessary post-processing
+    if (!timesNodes.empty())
+        CompileNetwork();
+    return timesNodes.size();
+}
+
+// ========================================
+// This function frees the float weights that only int8 QuantizedTimes nodes read, after these nodes quantized them,
+// so that an evaluation network only keeps the int8 copies. The network cannot be saved afterwards.
+// Returns the number of released parameters.
+// ========================================
+template <class ElemType>
+size_t ComputationNetwork::ReleaseInt8FloatWeights()
+{
+    // the int8 products by each parameter, and the parameters that are also read by other nodes
+    map<ComputationNodeBasePtr, vector<shared_ptr<QuantizedTimesNode<ElemType>>>> int8Products;
+    set<ComputationNodeBasePtr> otherwiseRead;
+    for (const auto& node : GetAllNodes())
+    {
+        for (size_t i = 0; i < node->GetNumInputs(); i++)
+        {
+            const auto& input = node->GetInputs()[i];
+            if (!dynamic_pointer_cast<LearnableParameter<ElemType>>(input))
+                continue;
+
+            auto quantizedNode = dynamic_pointer_cast<QuantizedTimesNode<ElemType>>(node);
+            if (quantizedNode && quantizedNode->IsInt8() && i == 0)
+                int8Products[input].push_back(quantizedNode);
+            else
+                otherwiseRead.insert(input);
+        }
+    }
+
+    size_t numReleased = 0;
+    for (const auto& products : int8Products)
+    {
+        if (otherwiseRead.find(products.first) != otherwiseRead.end())
+            continue;
+
+        for (const auto& quantizedNode : products.second)
+            quantizedNode->QuantizeWeights();
+        dynamic_pointer_cast<LearnableParameter<ElemType>>(products.first)->Value().Resize(0, 0, 0, false /*growOnly*/);
+        numReleased++;
+        if (TraceLevel() > 0)
+            fprintf(stderr, "ReleaseInt8FloatWeights: Released the float weights %ls, used by %d int8 QuantizedTimes node(s).\n", products.first->NodeName().c_str(), (int) products.second.size());
+    }
+    return numReleased;
+}
+
 // Helper class to form a logical DBN layer while exporting the network (used by SaveToDbnFile)
 class DbnLayer
 {
@@ -1521,6 +1629,8 @@ template void ComputationNetwork::InitLearnableParametersWithBilinearFill<float>
 template void ComputationNetwork::Read<float>(const wstring& fileName);
 template void ComputationNetwork::ReadPersistableParameters<float>(size_t modelVersion, File& fstream, bool create);
 template void ComputationNetwork::PerformSVDecomposition<float>(const map<wstring, float>& SVDConfig, size_t alignedsize);
+template size_t ComputationNetwork::QuantizeTimesNodesToInt8<float>(const wstring& nodeNameRegex);
+template size_t ComputationNetwork::ReleaseInt8FloatWeights<float>();
 template /*static*/ void ComputationNetwork::SetBatchNormalizationTimeConstants<float>(ComputationNetworkPtr net, const ComputationNodeBasePtr& criterionNode, const double normalizationTimeConstant, double& prevNormalizationTimeConstant, double blendTimeConstant, double& prevBlendTimeConstant);
 template void ComputationNetwork::SetSeqParam<float>(ComputationNetworkPtr net, const ComputationNodeBasePtr criterionNode, const double& hsmoothingWeight, const double& frameDropThresh, const bool& doreferencealign,
                                                      const double& amf, const double& lmf, const double& wp, const double& bMMIfactor, const bool& sMBR);
@@ -1530,6 +1640,8 @@ template void ComputationNetwork::InitLearnableParametersWithBilinearFill<double
 template void ComputationNetwork::Read<double>(const wstring& fileName);
 template void ComputationNetwork::ReadPersistableParameters<double>(size_t modelVersion, File& fstream, bool create);
 template void ComputationNetwork::PerformSVDecomposition<double>(const map<wstring, float>& SVDConfig, size_t alignedsize);
+template size_t ComputationNetwork::QuantizeTimesNodesToInt8<double>(const wstring& nodeNameRegex);
+template size_t ComputationNetwork::ReleaseInt8FloatWeights<double>();
 template /*static*/ void ComputationNetwork::SetBatchNormalizationTimeConstants<double>(ComputationNetworkPtr net, const ComputationNodeBasePtr& criterionNode, const double normalizationTimeConstant, double& prevNormalizationTimeConstant, double blendTimeConstant, double& prevBlendTimeConstant);
 template void ComputationNetwork::SetSeqParam<double>(ComputationNetworkPtr net, const ComputationNodeBasePtr criterionNode, const double& hsmoothingWeight, const double& frameDropThresh, const bool& doreferencealign,
                                                       const double& amf, const double& lmf, const double& wp, const double& bMMIfactor, const bool& sMBR);
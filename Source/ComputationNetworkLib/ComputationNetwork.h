@@ -139,7 +139,9 @@ public:
     void PostForwardAndBackProp(const ComputationNodeBasePtr rootNode);
 
     // main entry point for backprop
-    void Backprop(const ComputationNodeBasePtr rootNode);
+    // If given, gradientReady is called for each learnable parameter as soon as its gradient is final,
+    // while the rest of the backprop is still to be done (e.g. to start aggregating it across workers).
+    void Backprop(const ComputationNodeBasePtr rootNode, const std::function<void(const ComputationNodeBasePtr&)>& gradientReady = nullptr);
 
     template <class NODESET> // version that takes multiple nodes
     void TravserseInSortedGlobalEvalOrder(const NODESET& nodes, const std::function<void(const ComputationNodeBasePtr&)>& action)
@@ -165,6 +167,8 @@ public:
                 else
                     node = nullptr;
             }
+            else
+                node = GetFusedElementwiseGroupOrSelf(node);
 
             if (node)
                 action(node);
@@ -198,7 +202,11 @@ public:
                 if (std::find(nodesFrom.begin(), nodesFrom.end(), input) != nodesFrom.end()
                     || nodesToForward.find(input) != nodesToForward.end())
                 {
-                    nodesToForward.insert(node);
+                    // a fused chain is recorded as its head node, which is what its consumers see as their input
+                    if (node->Is<FusedElementwiseFlowControlNode>())
+                        nodesToForward.insert(node->As<FusedElementwiseFlowControlNode>()->GetHead());
+                    else
+                        nodesToForward.insert(node);
                 }
             }
         });
@@ -206,7 +214,7 @@ public:
         // Perform forward on resulting nodes in global evaluation order.
         for (const auto& node : SortByGlobalEvalOrder(nodesToForward))
         {
-            ComputationNetwork::PARTraversalFlowControlNode::ForwardProp(node, FrameRange(nullptr));
+            ComputationNetwork::PARTraversalFlowControlNode::ForwardProp(GetFusedElementwiseGroupOrSelf(node), FrameRange(nullptr));
         }
     }
 
@@ -244,6 +252,11 @@ public:
 
 private:
     size_t ValidateNodes(list<ComputationNodeBasePtr> nodes, bool isFirstPass, bool isFinalValidationPass);
+    void FuseElementwiseNodes();
+    void UnfuseElementwiseNodes(const ComputationNodeBasePtr& member);
+    // the node that executes 'node' in PAR traversal: its FusedElementwiseFlowControlNode if 'node' heads a fused chain, nullptr if it is an intermediate of one, else 'node' itself
+    ComputationNodeBasePtr GetFusedElementwiseGroupOrSelf(const ComputationNodeBasePtr& node) const;
+    bool IsFusedElementwiseIntermediate(const ComputationNodeBasePtr& node) const;
     bool ValidateNode(ComputationNodeBasePtr node, bool isFinalValidationPass) const;
     void MarkValueNonSharableNodes();
     void ChangeNodeInputs(ComputationNodeBasePtr fromNode, ComputationNodeBasePtr toNode);
@@ -262,6 +275,10 @@ public:
     // From the set of nodes extract all nodes which are used as accumulator nodes.
     std::set<ComputationNodeBasePtr> ExtractNodesWhichAccumulateResult(std::set<ComputationNodeBasePtr> nodes);
 
+    // Adapt the memory sharing to the minibatch whose input layouts have just been set. Call once per minibatch, before its
+    // first forward pass (see DataReaderHelpers::GetMinibatchIntoNetwork()); a no-op unless planMemoryPerMinibatch is enabled.
+    void PlanMemoryForMinibatch();
+
 private:
     void PrintMemorySharingStructure(const std::vector<ComputationNodeBasePtr>& nodes);
     void ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap);
@@ -472,6 +489,7 @@ public:
     void AddFeatureNode(ComputationNodeBasePtr featureNode);
     //ComputationNodeBasePtr RemoveFeatureNode(ComputationNodeBasePtr featureNode);
     void SetLearnableNodesBelowLearningRateMultiplier(const float learningRateMultiplier, const ComputationNodeBasePtr& rootNode = nullptr);
+    ComputationNetworkPtr CloneWithSharedParameters() const;
 
     // -----------------------------------------------------------------------
     // node access
@@ -844,6 +862,12 @@ public:
     template <class ElemType>
     void PerformSVDecomposition(const map<wstring, float>& SVDConfig, size_t AlignedSize);
 
+    template <class ElemType>
+    size_t QuantizeTimesNodesToInt8(const std::wstring& nodeNameRegex = L".*");
+
+    template <class ElemType>
+    size_t ReleaseInt8FloatWeights();
+
     template <class ElemType>
     void SaveToDbnFile(ComputationNetworkPtr net, const std::wstring& fileName) const;
 
@@ -1210,6 +1234,71 @@ protected:
         // There is currently no other constructor for inner nested PAR-traversed sub-networks, but there will be.
         PARTraversalFlowControlNode(const std::vector<shared_ptr<SEQTraversalFlowControlNode>>& recurrentInfo, const std::list<ComputationNodeBasePtr>& allNodes);
         // Base::m_nestedNodes contains all top-level nodes, in evaluation order
+
+        // called by Backprop() for each learnable parameter once all nodes consuming it have been backpropagated; set by ComputationNetwork::Backprop()
+        std::function<void(const ComputationNodeBasePtr&)> m_gradientReady;
+    };
+
+    // -----------------------------------------------------------------------
+    // FusedElementwiseFlowControlNode -- FlowControlNode that evaluates a chain of elementwise nodes in a single pass
+    //
+    // Created by FuseElementwiseNodes(). The chain's last node in evaluation order
+    // (the head) is replaced by this node in the PAR traversal, while the other
+    // members (the intermediates) are neither executed nor get any matrices.
+    // ForwardProp() computes the head's value directly from the values of the
+    // leaves (the chain's inputs from outside of it), and Backprop() computes
+    // each leaf's gradient directly from the head's gradient, recomputing the
+    // intermediate values it needs on the fly. Both use
+    // TensorView::DoFusedElementwiseOpOf() with programs compiled from the
+    // members' IFusableElementwiseNode opcodes.
+    // -----------------------------------------------------------------------
+
+    class FusedElementwiseFlowControlNode : public FlowControlNode
+    {
+        typedef FlowControlNode Base;
+
+    public:
+        using Base::m_nestedNodes; // the members, in evaluation order; the head is last
+
+        virtual const std::wstring OperationName() const override
+        {
+            return L"FusedElementwiseFlowControlNode";
+        }
+        virtual void BeginForwardProp() override;
+        virtual void ForwardProp(const FrameRange&) override;
+        virtual void EndForwardProp() override;
+        virtual void PostForwardAndBackProp() override;
+        virtual void BeginBackprop() override {}
+        virtual void BackpropTo(const size_t inputIndex, const FrameRange&) override
+        {
+            NOT_IMPLEMENTED;
+        }
+        virtual void EndBackprop() override {}
+        virtual void Backprop(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop) override;
+        virtual void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool);
+        virtual void ReleaseMatricesAfterForwardProp(MatrixPool& matrixPool);
+        virtual void AllocateGradientMatricesForInputs(MatrixPool& matrixPool);
+        virtual void RequestMatricesBeforeBackprop(MatrixPool& matrixPool);
+        virtual void ReleaseMatricesAfterBackprop(MatrixPool& matrixPool);
+        virtual bool IsOutOfDateWrtInputs() const override;
+
+        const ComputationNodeBasePtr& GetHead() const { return m_nestedNodes.back(); }
+        const std::vector<ComputationNodeBasePtr>& GetLeaves() const { return m_leaves; }
+        bool IsLeafValueUsedInBackprop(size_t leafIndex) const;
+
+    public:
+        FusedElementwiseFlowControlNode(const std::vector<ComputationNodeBasePtr>& members); // members must be in evaluation order
+
+    private:
+        size_t DetermineElementwiseTensorRank() const;
+        template <class ElemType> bool ForwardPropT(const FrameRange& fr);
+        template <class ElemType> bool BackpropT(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop);
+
+        std::vector<ComputationNodeBasePtr> m_leaves;          // inputs of the chain, in order of first use; also the inputs of this node
+        FusedTensorOpProgram m_forwardProgram;                 // leaves -> head value
+        std::vector<FusedTensorOpProgram> m_backwardPrograms;  // [leaf index] (leaves, head gradient) -> gradient contribution to the leaf
+        std::vector<bool> m_leafReceivesGradient;              // [leaf index] false if no gradient flows through the chain into this leaf
+        MatrixBasePtr m_reductionBuffer;                       // gradient contributions for leaves that are broadcast over the head's shape
     };
 
 public:
@@ -1266,10 +1355,12 @@ private:
     std::vector<ComputationNodeBasePtr> m_allRoots;
 
     std::vector<std::shared_ptr<SEQTraversalFlowControlNode>> m_allSEQNodes; // [loopId] cached set of SEQTraversalFlowControlNodes to allow sharing and idempotence of FormRecurrentLoops()
+    std::map<ComputationNodeBasePtr, std::shared_ptr<FusedElementwiseFlowControlNode>> m_fusedElementwiseNodes; // [member node] -> fused chain it belongs to; see FuseElementwiseNodes()
 
     // cache for evaluation ordering:
     bool m_isCompiled; // CompileNetwork has been called
     bool m_areMatricesAllocated; // AllocateAllMatrices has been called
+    std::vector<ComputationNodeBasePtr> m_nodesWithoutMatrices; // fused intermediates that AllocateAllMatrices() did not give any matrices to
 
     // cached network iterations
     std::map<const ComputationNodeBasePtr, std::list<ComputationNodeBasePtr>> m_evalOrders; // [out node] flat depth-first traversal starting from out node
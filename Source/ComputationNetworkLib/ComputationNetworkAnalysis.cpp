@@ -29,7 +29,7 @@ static int GetRecurrenceSteppingDirection(const ComputationNodeBasePtr&);
 // This function analysis the networks for recurrent loops present in the computation of 'rootNode.'
 // This sets/updates:
 //  - m_allSEQNodes
-//  - ComputationNode::m_isPartOfLoop (exposed to outside as IsPartOfLoop())
+//  - ComputationNode::m_containingLoopId (exposed to outside as IsPartOfLoop() and IsPartOfSameLoopAs())
 //  - the cached m_evalOrders[root], reordered to make nodes belonging to the same loop consecutive. TODO: Try not to do that.
 // Is often called before ValidateNetwork() on a root; will be called from inside ValidateNetwork() as well.
 // This function is called for multiple nodes, e.g. eval and training criterion. I.e. it must be able to add to a previous result. E.g. it does not clear the m_visited flags at start.
@@ -340,8 +340,7 @@ void ComputationNetwork::DetermineSCCsR(ComputationNodeBasePtr cur,
                 rInfo2.m_nestedNodes = move(nestedNodes); // TODO: make these two part of the constructor
                 for (auto node : rInfo2.m_nestedNodes)
                 {
-                    node->m_isPartOfLoop = true; // this is the only flag in ComputationNode that escapes FormRecurrentLoops()!
-                    // TODO: ^^ We should instead remember a pointer to our loop sentinel
+                    node->m_containingLoopId = (int)rInfo2.m_loopId; // this is the only state in ComputationNode that escapes FormRecurrentLoops()!
                     node->m_loopId = rInfo2.m_loopId; // Note: m_loopId is only used inside this source file, and only for reordering
                 }
                 rInfo2.m_steppingDirection = DetermineLoopDirection(rInfo2.m_nestedNodes);
@@ -103,6 +103,66 @@ void ComputationNetwork::CopyInputs(const std::wstring fromName, std::wstring to
     CopyNode(*this, fromName, toName, CopyNodeFlags::copyNodeInputLinks);
 }
 
+// Lets a node of a clone made by CloneWithSharedParameters() refer to the value it needs: the original one for
+// parameters, a copy for precomputed statistics, and otherwise its own, which for values from the memory pool
+// (nullptr) is allocated with the clone's matrices. Returns false if the node is not of this ElemType.
+template <class ElemType>
+static bool SetClonedNodeValue(const ComputationNodeBasePtr& fromNode, const ComputationNodeBasePtr& toNode)
+{
+    auto node = dynamic_pointer_cast<ComputationNode<ElemType>>(toNode);
+    if (!node)
+        return false;
+
+    auto& value = node->ValuePtrRef(); // currently shared with fromNode
+    if (!value || fromNode->Is<LearnableParameter<ElemType>>())
+        return true;
+    if (fromNode->RequiresPreCompute())
+        value = make_shared<Matrix<ElemType>>(value->DeepClone());
+    else if (fromNode->IsValueSharable() && value->GetMatrixType() == MatrixType::DENSE)
+        value = nullptr;
+    else
+        value = make_shared<Matrix<ElemType>>(0, 0, value->GetDeviceId(), value->GetMatrixType(), value->GetFormat());
+    return true;
+}
+
+// Creates a copy of this (compiled) network for evaluating it concurrently with this one, e.g. on another thread:
+// the copy shares the values of all learnable parameters with this network, but has its own nodes, activations,
+// MBLayouts and memory pool. The parameters must therefore not be changed while copies exist.
+// This reads the nodes of this network, and must not run concurrently with an evaluation of it.
+ComputationNetworkPtr ComputationNetwork::CloneWithSharedParameters() const
+{
+    VerifyIsCompiled("CloneWithSharedParameters");
+
+    auto clone = make_shared<ComputationNetwork>(m_deviceId);
+    clone->SetTraceLevel(TraceLevel());
+    clone->m_randomSeedOffset = m_randomSeedOffset;
+
+    for (const auto& kv : m_nameToNodeMap)
+    {
+        auto node = kv.second->Duplicate(kv.first, (CopyNodeFlags) (CopyNodeFlags::copyNodeValue | CopyNodeFlags::shareNodeValue));
+        if (!SetClonedNodeValue<float>(kv.second, node) && !SetClonedNodeValue<double>(kv.second, node))
+            LogicError("CloneWithSharedParameters: Unexpected element type of %ls.", kv.second->NodeDescription().c_str());
+        clone->AddNodeToNet(node);
+    }
+
+    for (const auto& kv : m_nameToNodeMap)
+    {
+        const auto& inputs = kv.second->GetInputs();
+        auto node = clone->GetNodeFromName(kv.first);
+        for (size_t i = 0; i < inputs.size(); i++)
+            node->SetInput(i, clone->GetNodeFromName(inputs[i]->NodeName()));
+    }
+
+    auto fromGroups = const_cast<ComputationNetwork*>(this)->GetAllNodeGroups();
+    auto toGroups = clone->GetAllNodeGroups();
+    for (size_t i = 0; i < fromGroups.size(); i++)
+        for (const auto& node : *fromGroups[i])
+            toGroups[i]->push_back(clone->GetNodeFromName(node->NodeName()));
+
+    clone->CompileNetwork();
+    return clone;
+}
+
 // RenameNode - Rename a node to another name
 // nodeNameOrig - original node name
 // nodeNameNew - new node name
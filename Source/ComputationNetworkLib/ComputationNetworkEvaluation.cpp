@@ -11,6 +11,7 @@
 #include "RecurrentNodes.h"
 #include "InputAndParamNodes.h"
 #include "LinearAlgebraNodes.h"
+#include "PerformanceProfiler.h"
 #include <string>
 #include <vector>
 #include <list>
@@ -72,7 +73,8 @@ static bool SetRootGradientToScalarOne(ComputationNodeBasePtr nodep)
 //  - ForwardProp() for eval nodes
 //  - ForwardProp() for the training criterion (which will reuse computation results from the previous step)
 //  - Backprop() for the training criterion
-void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode) // training criterion to compute the gradients for
+void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode, // training criterion to compute the gradients for
+                                  const std::function<void(const ComputationNodeBasePtr&)>& gradientReady)
 {
     if (!Environment().IsTraining())
         LogicError("Backprop: Requires network is to be in training mode.");
@@ -85,7 +87,10 @@ void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode) // trai
     ZeroInputGradients(rootNode);
 
     // backpropagate through the network
-    GetNestedNetwork(rootNode)->Backprop(FrameRange(nullptr), true, true);
+    auto network = dynamic_pointer_cast<PARTraversalFlowControlNode>(GetNestedNetwork(rootNode));
+    network->m_gradientReady = gradientReady;
+    network->Backprop(FrameRange(nullptr), true, true);
+    network->m_gradientReady = nullptr;
 }
 
 void ComputationNetwork::FormNestedNetwork(const ComputationNodeBasePtr& rootNode)
@@ -113,10 +118,26 @@ ComputationNodeBasePtr ComputationNetwork::GetNestedNetwork(const ComputationNod
 
 template<class ElemType> static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient);
 
+// Per-node profiling (see PerformanceProfiler.h). When not enabled, this costs a single check per node.
+// The FLOP estimate is that of the forward pass over the whole minibatch; backprop computes one
+// gradient of similar cost per input that needs it, and a SEQ loop evaluates one time step at a time.
+static void ProfilerNodeTimeEnd(long long stateId, const ComputationNodeBasePtr& node, bool backward, size_t numSteps = 1)
+{
+    double flops = node->ForwardPropFlopsEstimate() / numSteps;
+    if (backward)
+    {
+        size_t numGradients = 0;
+        for (size_t i = 0; i < node->GetNumInputs(); i++)
+            numGradients += node->Input(i)->NeedsGradient() ? 1 : 0;
+        flops *= max(numGradients, (size_t)1);
+    }
+    ProfilerNodeTimeEnd(stateId, node->NodeName().c_str(), node->OperationName().c_str(), backward, flops, (long long)node->AllocatedMatrixBytes());
+}
+
 ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(const std::vector<shared_ptr<SEQTraversalFlowControlNode>>& recurrentInfo, const std::list<ComputationNodeBasePtr>& allNodes /*must be in eval order*/)
 {
     // traverse the network in evaluation order and create a new list that replaces all recurrence by a SEQTraversalFlowControlNode
-    set<shared_ptr<IComputationNode>> loopsSeen; // for consistency check only
+    std::set<shared_ptr<IComputationNode>> loopsSeen; // for consistency check only
     for (auto nodeIter = allNodes.begin(); nodeIter != allNodes.end();)
     {
         shared_ptr<SEQTraversalFlowControlNode> recInfo = FindInRecurrentLoops(recurrentInfo, *nodeIter); // check if this node participates in a recurrent loop
@@ -144,10 +165,16 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
 {
     if (node->IsOutOfDateWrtInputs())
     {
+        bool profile = ProfilerNodeTracingActive();
+        long long profilerState = profile ? ProfilerTimeBegin() : 0;
+
         node->BeginForwardProp();
         node->ForwardProp(fr.WithLayout(node->GetMBLayout()));
         node->EndForwardProp();
 
+        if (profile)
+            ProfilerNodeTimeEnd(profilerState, node, /*backward=*/false);
+
         node->BumpEvalTimeStamp();
 
         // Extreme Tracing, part 1/4
@@ -182,13 +209,23 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
     {
         auto& node = *pnode;
 
+        bool profile = ProfilerNodeTracingActive();
+        long long profilerState = profile ? ProfilerTimeBegin() : 0;
+
         node->BeginBackprop();
         node->Backprop(fr.WithLayout(node->GetMBLayout()), true /*childrenInThisLoop*/, true /*childrenInOuterLoop*/);
         node->EndBackprop();
 
+        if (profile)
+            ProfilerNodeTimeEnd(profilerState, node, /*backward=*/true);
+
         // Extreme Tracing, part 2/4
         if (node->HasEnvironmentPtr() && node->Environment().ShouldDumpNode() && node->NeedsGradient())
             DumpNode<float>(node, /*dumpGradient=*/true) || DumpNode<double>(node, true);
+
+        // in reverse evaluation order, all consumers of a parameter come before it, so its gradient is now final
+        if (m_gradientReady && node->OperationName() == OperationNameOf(LearnableParameter) && node->IsParameterUpdateRequired())
+            m_gradientReady(node);
     }
 }
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) /*override*/
@@ -265,13 +302,19 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
     // for every time step run through all nodes in this particular loop (treat the loop like a little ComputationNetwork)
     // Note: Currently, this is limited to linear-time loops. But nothing stops the iteration below to, e.g., be a 2D iteration over an image
     // if we implement an according FrameRangeIteration.
+    bool profile = ProfilerNodeTracingActive();
     FrameRangeIteration range(GetMBLayout(), m_steppingDirection);
     for (auto t = range.begin(); t != range.end(); t++)
     {
         for (auto& node : m_nestedNodes)
         {
+            long long profilerState = profile ? ProfilerTimeBegin() : 0;
+
             node->ForwardProp(t);
             node->BumpEvalTimeStamp();
+
+            if (profile)
+                ProfilerNodeTimeEnd(profilerState, node, /*backward=*/false, GetMBLayout()->GetNumTimeSteps());
         }
     }
 
@@ -304,15 +347,21 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
     childrenInThisLoop, childrenInOuterLoop;    // TODO: think through what these mean when coming from PAR mode
     const auto& recurrentNodes = m_nestedNodes; // BUGBUG: -ForForward?? Does this mean we can remove non-ForForward?
     auto pMBLayout = recurrentNodes[0]->GetMBLayout();
+    bool profile = ProfilerNodeTracingActive();
     FrameRangeIteration range(pMBLayout, m_steppingDirection);
     for (auto t = range.rbegin(); t != range.rend(); t++) // note: reverse iteration
     {
         for (auto nodeIter2 = recurrentNodes.rbegin(); nodeIter2 != recurrentNodes.rend(); ++nodeIter2)
         {
             auto& node2 = *nodeIter2;
+            long long profilerState = profile ? ProfilerTimeBegin() : 0;
+
             node2->Backprop(t, true /*childrenInThisLoop*/, false /*childrenInOuterLoop*/);
             // The above flags tell Backprop() to skip back-propagation from inside a node into
-            // a node that is outside the loop, which is done later in EndBackprop() in PAR mode.
+            // a node that is outside the loop (or part of another loop), which is done later in EndBackprop() in PAR mode.
+
+            if (profile)
+                ProfilerNodeTimeEnd(profilerState, node2, /*backward=*/true, pMBLayout->GetNumTimeSteps());
         }
     }
 
@@ -329,8 +378,10 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
 // called after last iteration step of ComputeGradient()
 /*virtual*/ void ComputationNetwork::SEQTraversalFlowControlNode::EndBackprop() /*override*/
 {
-    // The following loop handles the case that a node inside the loop back-propagates a gradient into a node outside of the loop.
-    // For efficiency, we perform this outside the loop in PAR mode. E.g., in one LSTM speech setup, we measured 12..14% overall speed-up.
+    // The following loop handles the case that a node inside the loop back-propagates a gradient into a node outside of the loop,
+    // e.g. into the weights of the recurrent projection, or into a node of a preceding loop (as in stacked recurrences).
+    // For efficiency, we perform this outside the loop in PAR mode, i.e. one large GEMM over all time steps instead of one per step.
+    // E.g., in one LSTM speech setup, we measured 12..14% overall speed-up.
     for (auto nodeIter2 = m_nestedNodes.rbegin(); nodeIter2 != m_nestedNodes.rend(); ++nodeIter2)
     {
         auto& node2 = *nodeIter2;
@@ -401,6 +452,306 @@ bool ComputationNetwork::SEQTraversalFlowControlNode::IsOutOfDateWrtInputs() con
     return false;
 }
 
+// -----------------------------------------------------------------------
+// FusedElementwiseFlowControlNode methods -- implements single-pass evaluation of chains of elementwise nodes
+//
+// The members of the chain are described by IFusableElementwiseNode opcodes.
+// These get compiled into FusedTensorOpPrograms whose registers [0, #leaves)
+// hold the leaf values, and in the backward programs, register #leaves holds
+// the head's gradient.
+// -----------------------------------------------------------------------
+
+// append the computation of a member's value to 'program', unless it is already held by a register (memoized in 'registers')
+static size_t CompileFusedValue(const ComputationNodeBasePtr& node, FusedTensorOpProgram& program, map<ComputationNodeBasePtr, size_t>& registers)
+{
+    auto iter = registers.find(node);
+    if (iter != registers.end())
+        return iter->second;
+
+    size_t args[2];
+    for (size_t i = 0; i < node->GetNumInputs(); i++)
+        args[i] = CompileFusedValue(node->GetInputs()[i], program, registers);
+    let op = dynamic_cast<IFusableElementwiseNode&>(*node).FusedForwardOp();
+    size_t result = (node->GetNumInputs() == 1) ? program.AddStep(op, args[0]) : program.AddStep(op, args[0], args[1]);
+    registers[node] = result;
+    return result;
+}
+
+ComputationNetwork::FusedElementwiseFlowControlNode::FusedElementwiseFlowControlNode(const std::vector<ComputationNodeBasePtr>& members)
+{
+    m_nestedNodes = members;
+    let& head = GetHead();
+    SetNodeName(L"Fused_" + head->NodeName());
+    LinkToMBLayout(head->GetMBLayout());
+
+    // the leaves are the inputs from outside of the chain
+    std::set<ComputationNodeBasePtr> memberSet(members.begin(), members.end());
+    for (let& member : members)
+    {
+        if (member->GetNumInputs() < 1 || member->GetNumInputs() > 2)
+            LogicError("FusedElementwiseFlowControlNode: %ls has %d inputs, only unary and binary nodes can be fused.", member->NodeDescription().c_str(), (int) member->GetNumInputs());
+        for (let& input : member->GetInputs())
+        {
+            if (memberSet.find(input) == memberSet.end() && std::find(m_leaves.begin(), m_leaves.end(), input) == m_leaves.end())
+                m_leaves.push_back(input);
+        }
+    }
+    if (m_leaves.size() + 1 > FusedTensorOpMaxInputs) // backward programs also take the head's gradient
+        LogicError("FusedElementwiseFlowControlNode: Chain %ls has too many inputs.", NodeName().c_str());
+    m_inputs = m_leaves; // so that traversals see the data dependencies of this node
+
+    map<ComputationNodeBasePtr, size_t> leafRegisters;
+    for (size_t i = 0; i < m_leaves.size(); i++)
+        leafRegisters[m_leaves[i]] = i;
+
+    // forward: leaves -> head value
+    {
+        auto registers = leafRegisters;
+        m_forwardProgram.numInputs = m_leaves.size();
+        m_forwardProgram.resultRegister = CompileFusedValue(head, m_forwardProgram, registers);
+    }
+
+    // backward: for every leaf, propagate the head's gradient through all members that depend on it
+    // Members are visited in reverse evaluation order, so that the gradient of a member is complete before it is passed on.
+    for (let& leaf : m_leaves)
+    {
+        std::set<ComputationNodeBasePtr> dependsOnLeaf{ leaf };
+        for (let& member : members)
+        {
+            for (let& input : member->GetInputs())
+            {
+                if (dependsOnLeaf.find(input) != dependsOnLeaf.end())
+                    dependsOnLeaf.insert(member);
+            }
+        }
+
+        FusedTensorOpProgram program;
+        program.numInputs = m_leaves.size() + 1;
+        auto registers = leafRegisters;
+        map<ComputationNodeBasePtr, size_t> gradients{ { head, m_leaves.size() } };
+        for (auto iter = members.rbegin(); iter != members.rend(); iter++)
+        {
+            let& member = *iter;
+            let gradient = gradients.find(member);
+            if (gradient == gradients.end())
+                continue;
+            let& fusableMember = dynamic_cast<IFusableElementwiseNode&>(*member);
+            for (size_t i = 0; i < member->GetNumInputs(); i++)
+            {
+                let& input = member->GetInputs()[i];
+                ElementWiseOperator op;
+                int operand;
+                if (dependsOnLeaf.find(input) == dependsOnLeaf.end() || !fusableMember.FusedBackwardOp(i, op, operand))
+                    continue;
+
+                size_t contribution;
+                if (op == ElementWiseOperator::opCopy)
+                    contribution = gradient->second;
+                else if (operand == IFusableElementwiseNode::noOperand)
+                    contribution = program.AddStep(op, gradient->second);
+                else
+                {
+                    let& operandNode = (operand == IFusableElementwiseNode::outputOperand) ? member : member->GetInputs()[operand];
+                    contribution = program.AddStep(op, gradient->second, CompileFusedValue(operandNode, program, registers));
+                }
+
+                let inputGradient = gradients.find(input);
+                if (inputGradient == gradients.end())
+                    gradients[input] = contribution;
+                else
+                    inputGradient->second = program.AddStep(ElementWiseOperator::opSum, inputGradient->second, contribution);
+            }
+        }
+
+        let leafGradient = gradients.find(leaf);
+        m_leafReceivesGradient.push_back(leafGradient != gradients.end());
+        if (leafGradient != gradients.end())
+            program.resultRegister = leafGradient->second;
+        m_backwardPrograms.push_back(program);
+    }
+}
+
+// true if computing the gradient of any leaf reads the value of the given leaf
+bool ComputationNetwork::FusedElementwiseFlowControlNode::IsLeafValueUsedInBackprop(size_t leafIndex) const
+{
+    for (size_t i = 0; i < m_leaves.size(); i++)
+    {
+        if (!m_leafReceivesGradient[i] || !m_leaves[i]->NeedsGradient())
+            continue;
+        let& program = m_backwardPrograms[i];
+        if (program.resultRegister == leafIndex)
+            return true;
+        for (let& step : program.steps)
+        {
+            if (std::find(step.args, step.args + step.numArgs, leafIndex) != step.args + step.numArgs)
+                return true;
+        }
+    }
+    return false;
+}
+
+// same as ComputationNodeBase::DetermineElementwiseTensorRank() across the entire chain
+size_t ComputationNetwork::FusedElementwiseFlowControlNode::DetermineElementwiseTensorRank() const
+{
+    size_t maxRank = GetHead()->GetSampleLayout().GetRank();
+    for (let& node : m_nestedNodes)
+        maxRank = std::max(maxRank, node->GetSampleLayout().GetRank());
+    for (let& leaf : m_leaves)
+        maxRank = std::max(maxRank, leaf->GetSampleLayout().GetRank());
+    return maxRank;
+}
+
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::BeginForwardProp() /*override*/
+{
+    // only the head has a value to update
+    GetHead()->BeginForwardProp();
+}
+
+template <class ElemType>
+bool ComputationNetwork::FusedElementwiseFlowControlNode::ForwardPropT(const FrameRange& fr)
+{
+    let head = dynamic_pointer_cast<ComputationNode<ElemType>>(GetHead());
+    if (!head)
+        return false;
+
+    size_t rank = DetermineElementwiseTensorRank();
+    vector<TensorView<ElemType>> inputs;
+    for (let& leaf : m_leaves)
+        inputs.push_back(leaf->As<ComputationNode<ElemType>>()->ValueTensorFor(rank, fr.AllowBroadcast()));
+    auto result = head->ValueTensorFor(rank, fr);
+    result.DoFusedElementwiseOpOf(0, inputs, m_forwardProgram, 1);
+    return true;
+}
+
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::ForwardProp(const FrameRange& fr) /*override*/
+{
+    if (!ForwardPropT<float>(fr) && !ForwardPropT<double>(fr))
+        LogicError("FusedElementwiseFlowControlNode: %ls is neither ComputationNode<float> nor ComputationNode<double>.", GetHead()->NodeDescription().c_str());
+
+    // the intermediates are logically up to date as well
+    for (let& node : m_nestedNodes)
+        node->BumpEvalTimeStamp();
+}
+
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::EndForwardProp() /*override*/
+{
+    GetHead()->EndForwardProp();
+}
+
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::PostForwardAndBackProp() /*override*/
+{
+    for (let& node : m_nestedNodes)
+        node->PostForwardAndBackProp();
+}
+
+template <class ElemType>
+bool ComputationNetwork::FusedElementwiseFlowControlNode::BackpropT(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop)
+{
+    let head = dynamic_pointer_cast<ComputationNode<ElemType>>(GetHead());
+    if (!head)
+        return false;
+    if (!head->NeedsGradient())
+        return true;
+    head->LazyZeroGradient(head.get()); // see ComputationNode::Backprop()
+
+    size_t rank = DetermineElementwiseTensorRank();
+    vector<TensorView<ElemType>> inputs;
+    for (let& leaf : m_leaves)
+        inputs.push_back(leaf->As<ComputationNode<ElemType>>()->ValueTensorFor(rank, fr.AllowBroadcast()));
+    inputs.push_back(head->GradientTensorFor(rank, fr));
+    let& headShape = inputs.back().GetShape();
+
+    for (size_t i = 0; i < m_leaves.size(); i++)
+    {
+        let leaf = m_leaves[i]->As<ComputationNode<ElemType>>();
+        if (!m_leafReceivesGradient[i] || !leaf->NeedsGradient() ||
+            !((childrenInThisLoop && leaf->IsPartOfSameLoopAs(*head)) || (childrenInOuterLoop && !leaf->IsPartOfSameLoopAs(*head)))) // as in ComputationNode::Backprop()
+            continue;
+
+        // Gradient optimizations are disabled for the leaves (see AllocateAllMatrices()), so this zeroes the gradient if needed.
+        leaf->LazyZeroGradient(this);
+
+        auto leafGradient = leaf->GradientTensorFor(rank, fr.AllowBroadcast());
+        bool reducesInTime = leaf->ReducesInTimeWrt(head);
+        if (!reducesInTime && leafGradient.GetShape().GetDims() == headShape.GetDims())
+        {
+            leafGradient.DoFusedElementwiseOpOf(1, inputs, m_backwardPrograms[i], 1);
+            continue;
+        }
+
+        // the leaf is broadcast over the head: compute the contribution at the head's shape, then reduce it into the leaf's gradient
+        auto buffer = dynamic_pointer_cast<Matrix<ElemType>>(m_reductionBuffer);
+        if (!buffer)
+            m_reductionBuffer = buffer = make_shared<Matrix<ElemType>>(head->GetDeviceId());
+        buffer->Resize(head->Gradient().GetNumRows(), head->Gradient().GetNumCols());
+        TensorView<ElemType> contribution(buffer, TensorShape(headShape.GetDims()));
+        contribution.DoFusedElementwiseOpOf(0, inputs, m_backwardPrograms[i], 1);
+        if (reducesInTime) // zero out the gaps, as Plus etc. do
+            ComputationNode<ElemType>::MaskMissingColumnsToZero(*buffer, head->GetMBLayout(), fr);
+        leafGradient.AddCopyOf(contribution);
+    }
+    return true;
+}
+
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::Backprop(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop) /*override*/
+{
+    if (!BackpropT<float>(fr, childrenInThisLoop, childrenInOuterLoop) && !BackpropT<double>(fr, childrenInThisLoop, childrenInOuterLoop))
+        LogicError("FusedElementwiseFlowControlNode: %ls is neither ComputationNode<float> nor ComputationNode<double>.", GetHead()->NodeDescription().c_str());
+}
+
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) /*override*/
+{
+    GetHead()->RequestMatricesBeforeForwardProp(matrixPool);
+}
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::ReleaseMatricesAfterForwardProp(MatrixPool& matrixPool) /*override*/
+{
+    GetHead()->ReleaseMatricesAfterForwardProp(matrixPool);
+}
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::AllocateGradientMatricesForInputs(MatrixPool& matrixPool) /*override*/
+{
+    for (let& leaf : m_leaves)
+    {
+        if (leaf->NeedsGradient())
+            leaf->RequestMatricesBeforeBackprop(matrixPool);
+    }
+}
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::RequestMatricesBeforeBackprop(MatrixPool& matrixPool) /*override*/
+{
+    GetHead()->RequestMatricesBeforeBackprop(matrixPool);
+}
+/*virtual*/ void ComputationNetwork::FusedElementwiseFlowControlNode::ReleaseMatricesAfterBackprop(MatrixPool& matrixPool) /*override*/
+{
+    GetHead()->ReleaseMatricesAfterBackprop(matrixPool);
+}
+
+// the chain is out of date if any leaf has been updated after the head
+bool ComputationNetwork::FusedElementwiseFlowControlNode::IsOutOfDateWrtInputs() const
+{
+    for (let& leaf : m_leaves)
+    {
+        if (!leaf->IsOlderThan(*GetHead()))
+            return true;
+    }
+    return false;
+}
+
+ComputationNodeBasePtr ComputationNetwork::GetFusedElementwiseGroupOrSelf(const ComputationNodeBasePtr& node) const
+{
+    let iter = m_fusedElementwiseNodes.find(node);
+    if (iter == m_fusedElementwiseNodes.end())
+        return node;
+    else if (iter->second->GetHead() == node)
+        return iter->second;
+    else
+        return nullptr; // intermediates are evaluated by their chain's head
+}
+
+bool ComputationNetwork::IsFusedElementwiseIntermediate(const ComputationNodeBasePtr& node) const
+{
+    let iter = m_fusedElementwiseNodes.find(node);
+    return iter != m_fusedElementwiseNodes.end() && iter->second->GetHead() != node;
+}
+
 // TODO: do this on PARTraversalFlowControlNode
 void ComputationNetwork::ResetEvalTimeStamps()
 {
@@ -461,6 +812,7 @@ void ComputationNetwork::InvalidateCompiledNetwork()
     m_allSEQNodes.clear();
     m_evalOrders.clear();
     m_nestedNetworks.clear();
+    m_fusedElementwiseNodes.clear();
     m_inputValues.clear();
     m_learnableParameters.clear();
 }
@@ -532,7 +884,7 @@ void ComputationNetwork::CompileNetwork()
     ValidateNetwork();
 
     // STEP: Optimize the network.
-    // :)
+    FuseElementwiseNodes();
 
     // STEP: Some final details.
     ResetEvalTimeStamps(); // invalidate all m_value fields. Really belongs into StartEvaluateMinibatchLoop()
@@ -543,6 +895,168 @@ void ComputationNetwork::CompileNetwork()
     m_isCompiled = true;
 }
 
+// give a fused intermediate the matrices it did not get from AllocateAllMatrices(), since it is now executed by itself
+template <class ElemType>
+static bool CreateMatricesForUnfusedNode(const ComputationNodeBasePtr& nodep)
+{
+    let node = dynamic_pointer_cast<ComputationNode<ElemType>>(nodep);
+    if (!node)
+        return false;
+    node->CreateValueMatrixIfNull();
+    if (node->NeedsGradient())
+        node->CreateGradientMatrixIfNull();
+    return true;
+}
+
+// fuse chains of elementwise nodes, such as Sigmoid(W * x + b) .* Tanh(c), into FusedElementwiseFlowControlNodes
+// A chain consists of a head node and all nodes that (transitively) feed only into it. Such intermediates never
+// need to materialize their values or gradients, and the entire chain is executed in a single pass over the data.
+// This is only done for nodes on the CPU outside of recurrent loops, and only as long as no matrices have been allocated,
+// since the memory plan depends on which nodes get executed.
+void ComputationNetwork::FuseElementwiseNodes()
+{
+    if (AreMatricesAllocated())
+    {
+        // The network got recompiled after its matrices were allocated for fused execution; from now on, run those nodes as they are.
+        for (let& node : m_nodesWithoutMatrices)
+            CreateMatricesForUnfusedNode<float>(node) || CreateMatricesForUnfusedNode<double>(node);
+        m_nodesWithoutMatrices.clear();
+        return;
+    }
+    if (!Globals::ShouldFuseElementwiseNodes())
+        return;
+
+    // nodes whose values are visible outside: roots and members of node groups
+    set<ComputationNodeBasePtr> visibleNodes(m_allRoots.begin(), m_allRoots.end());
+    for (let* group : GetAllNodeGroups())
+        visibleNodes.insert(group->begin(), group->end());
+
+    // number of uses of each node as an input
+    map<ComputationNodeBasePtr, size_t> numUses;
+    for (let& iter : m_nameToNodeMap)
+    {
+        for (let& input : iter.second->GetInputs())
+            numUses[input]++;
+    }
+
+    let IsSameType = [](const ComputationNodeBasePtr& a, const ComputationNodeBasePtr& b)
+    {
+        return (dynamic_pointer_cast<ComputationNode<float>>(a) != nullptr) == (dynamic_pointer_cast<ComputationNode<float>>(b) != nullptr);
+    };
+    let IsFusable = [](const ComputationNodeBasePtr& node)
+    {
+        return dynamic_pointer_cast<IFusableElementwiseNode>(node) != nullptr &&
+               node->GetDeviceId() == CPUDEVICE && !node->IsPartOfLoop() && !node->IsValueSparse() && !node->NeedsDynamicValidation();
+    };
+    // inputs of the chain, which must share the head's layout or be broadcast over it
+    let GetLeaves = [](const vector<ComputationNodeBasePtr>& members)
+    {
+        set<ComputationNodeBasePtr> leaves;
+        for (let& member : members)
+        {
+            for (let& input : member->GetInputs())
+            {
+                if (find(members.begin(), members.end(), input) == members.end())
+                    leaves.insert(input);
+            }
+        }
+        return leaves;
+    };
+    const size_t maxNumMembers = 16;
+
+    // grow chains from their heads, visiting candidate heads downstream first
+    let& evalOrder = GetEvalOrder(nullptr);
+    map<ComputationNodeBasePtr, size_t> evalOrderIndex;
+    for (let& node : evalOrder)
+        evalOrderIndex.emplace(node, evalOrderIndex.size());
+    size_t numFusedNodes = 0;
+    vector<shared_ptr<FusedElementwiseFlowControlNode>> chains;
+    for (auto iter = evalOrder.rbegin(); iter != evalOrder.rend(); iter++)
+    {
+        let& head = *iter;
+        if (!IsFusable(head) || m_fusedElementwiseNodes.find(head) != m_fusedElementwiseNodes.end())
+            continue;
+
+        vector<ComputationNodeBasePtr> members{ head };
+        for (size_t k = 0; k < members.size() && members.size() < maxNumMembers; k++)
+        {
+            for (let& input : members[k]->GetInputs())
+            {
+                if (find(members.begin(), members.end(), input) != members.end() ||
+                    !IsFusable(input) || numUses[input] != 1 || visibleNodes.find(input) != visibleNodes.end() ||
+                    m_fusedElementwiseNodes.find(input) != m_fusedElementwiseNodes.end() ||
+                    input->GetMBLayout() != head->GetMBLayout() || !IsSameType(input, head) ||
+                    members.size() >= maxNumMembers)
+                    continue;
+                members.push_back(input);
+                if (GetLeaves(members).size() + 1 > FusedTensorOpMaxInputs) // backward also takes the head's gradient
+                    members.pop_back();
+            }
+        }
+        if (members.size() < 2)
+            continue;
+
+        bool canFuse = true;
+        for (let& leaf : GetLeaves(members))
+        {
+            canFuse &= (!leaf->HasMBLayout() || leaf->GetMBLayout() == head->GetMBLayout()) &&
+                       !leaf->IsValueSparse() && leaf->GetDeviceId() == CPUDEVICE && IsSameType(leaf, head);
+        }
+        if (!canFuse)
+            continue;
+
+        sort(members.begin(), members.end(), [&](const ComputationNodeBasePtr& a, const ComputationNodeBasePtr& b)
+        {
+            return evalOrderIndex[a] < evalOrderIndex[b];
+        });
+        let chain = make_shared<FusedElementwiseFlowControlNode>(members);
+        for (let& member : members)
+            m_fusedElementwiseNodes[member] = chain;
+        chains.push_back(chain);
+        numFusedNodes += members.size();
+    }
+    if (chains.empty())
+        return;
+
+    // replace the chains in the execution plans
+    for (let& iter : m_nestedNetworks)
+    {
+        auto& nestedNodes = iter.second->As<FlowControlNode>()->m_nestedNodes;
+        vector<ComputationNodeBasePtr> newNestedNodes;
+        for (let& node : nestedNodes)
+        {
+            let executedNode = GetFusedElementwiseGroupOrSelf(node);
+            if (executedNode)
+                newNestedNodes.push_back(executedNode);
+        }
+        nestedNodes = move(newNestedNodes);
+    }
+
+    if (TraceLevel() > 0)
+    {
+        fprintf(stderr, "\nFused %d elementwise nodes into %d chains:\n", (int) numFusedNodes, (int) chains.size());
+        for (let& chain : chains)
+            fprintf(stderr, "\t%ls = %d nodes, %d inputs\n", chain->GetHead()->NodeName().c_str(), (int) chain->m_nestedNodes.size(), (int) chain->GetLeaves().size());
+    }
+}
+
+// dissolve the fused chain that the given node is a member of, e.g. because its value is requested as an output after all
+void ComputationNetwork::UnfuseElementwiseNodes(const ComputationNodeBasePtr& member)
+{
+    let chain = m_fusedElementwiseNodes.at(member);
+    for (let& node : chain->m_nestedNodes)
+        m_fusedElementwiseNodes.erase(node);
+
+    // execute the members at the place of the chain; their leaves come before the head in evaluation order
+    for (let& iter : m_nestedNetworks)
+    {
+        auto& nestedNodes = iter.second->As<FlowControlNode>()->m_nestedNodes;
+        let chainIter = find(nestedNodes.begin(), nestedNodes.end(), chain);
+        if (chainIter != nestedNodes.end())
+            nestedNodes.insert(nestedNodes.erase(chainIter), chain->m_nestedNodes.begin(), chain->m_nestedNodes.end());
+    }
+}
+
 // determine the set of all root nodes
 // Roots are nodes that ForwardProp() may be called for.
 //  - training criterion, eval criteria
@@ -987,6 +1501,8 @@ void ComputationNetwork::PrintMemorySharingStructure(const vector<ComputationNod
         set<pair<const MatrixBase*, wstring>> matrixInfo = node->GetMatrixInfo();
         for (const auto& item : matrixInfo) // {value} or {value, gradient}
         {
+            if (!item.first) // fused intermediates have no matrices
+                continue;
             memSharingStructure[item.first].insert(item.second);
             numMatrices++;
         }
@@ -1060,6 +1576,13 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
     if (trainRootNode != nullptr)
         forwardPropRoots.push_back(trainRootNode);
 
+    // requested nodes must have their own values
+    for (auto& rootNode : forwardPropRoots)
+    {
+        if (IsFusedElementwiseIntermediate(rootNode))
+            UnfuseElementwiseNodes(rootNode);
+    }
+
     // Mark all the eval, output and criterion roots as non-shareable
     for (auto& rootNode : forwardPropRoots)
         rootNode->MarkValueNonSharable();
@@ -1100,6 +1623,23 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         }
     }
 
+    // fused chains recompute their intermediates during backprop from the values of their leaves
+    std::unordered_set<ComputationNodeBasePtr> childrenOfFusedNodes;
+    for (const auto& keyValue : m_fusedElementwiseNodes)
+    {
+        const auto& chain = keyValue.second;
+        if (keyValue.first != chain->GetHead())
+            continue;
+        const auto& leaves = chain->GetLeaves();
+        for (size_t i = 0; i < leaves.size(); i++)
+        {
+            if (performingBackPropagation && chain->GetHead()->NeedsGradient() && chain->IsLeafValueUsedInBackprop(i))
+                outputValueNeededDuringBackProp[leaves[i]] = true;
+        }
+        for (const auto& member : chain->m_nestedNodes)
+            childrenOfFusedNodes.insert(member->GetInputs().begin(), member->GetInputs().end());
+    }
+
     // gradient reuse maps
     std::unordered_map<MatrixPool::AliasNodePtr, std::unordered_set<MatrixPool::AliasNodePtr>> gradientReuseChildrenMap;
     std::unordered_map<MatrixPool::AliasNodePtr, MatrixPool::AliasNodePtr> gradientReuseParentMap;
@@ -1107,9 +1647,11 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
     {
         // Indicate on the node that it's parent overwrites its gradient if the node is not part of a loop
         // and has exactly one parent who implements the gradient overwrite optimization
+        // Fused chains accumulate into the gradients of their leaves (their intermediates have none).
         if (Globals::ShouldOptimizeGradientAccumulation() &&
             !keyValue.first->IsPartOfLoop() &&
-            (keyValue.second.size() == 1))
+            (keyValue.second.size() == 1) &&
+            childrenOfFusedNodes.find(keyValue.first) == childrenOfFusedNodes.end())
         {
             auto parent = *keyValue.second.begin();
             auto opt = parent->ImplementsGradientOptimization(keyValue.first.get());
@@ -1150,6 +1692,21 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
             for (auto& loopNode : seqTraversalFlowControlNode->m_nestedNodes)
                 ReleaseMatricesAfterEvalForChildren(loopNode, parentsMap);
         }
+        else if (node->Is<FusedElementwiseFlowControlNode>())
+        {
+            // only the head of a fused chain gets a value
+            auto fusedElementwiseFlowControlNode = node->As<FusedElementwiseFlowControlNode>();
+            const auto& head = fusedElementwiseFlowControlNode->GetHead();
+            head->SetOutputNeededDuringBackprop(outputValueNeededDuringBackProp[head]);
+            fusedElementwiseFlowControlNode->RequestMatricesBeforeForwardProp(m_matrixPool);
+
+            for (auto& member : fusedElementwiseFlowControlNode->m_nestedNodes)
+            {
+                ReleaseMatricesAfterEvalForChildren(member, parentsMap);
+                if (member != head)
+                    m_nodesWithoutMatrices.push_back(member);
+            }
+        }
         else
         {
             node->SetOutputNeededDuringBackprop(outputValueNeededDuringBackProp[node]);
@@ -1237,10 +1794,16 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
                     recInfo->ReleaseMatricesAfterBackprop(m_matrixPool);
                 }
             }
+            else if (IsFusedElementwiseIntermediate(n))
+            {
+                // handled by the head of its chain
+            }
             else
             {
                 // PAR mode: we can allocate and immediately deallocate one by one
-                n->AllocateGradientMatricesForInputs(m_matrixPool);
+                // The head of a fused chain allocates the gradients of the chain's leaves.
+                auto fusedNode = GetFusedElementwiseGroupOrSelf(n);
+                fusedNode->AllocateGradientMatricesForInputs(m_matrixPool);
                 // Root node's information will be used and should not be shared with others, also it's small (1x1)
                 if ((n != trainRootNode) && n->NeedsGradient())
                     n->ReleaseMatricesAfterBackprop(m_matrixPool);
@@ -1251,9 +1814,17 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
     m_matrixPool.OptimizedMemoryAllocation(); 
     m_areMatricesAllocated = true;
 
-    // TO DO: At the time of AllocateAllMatrices we don't know the minibatch size. In theory one may allocate memory again once we start to receive
-    // data from the reader (and the minibatch size is known). For some problems, minibatch size can change constantly, and there needs to be a 
-    // tradeoff in deciding how frequent to run optimized memory allocation. For now, we do it only once at the very beginning for speed concerns. 
+    // Note: At the time of AllocateAllMatrices we don't know the minibatch size. Once we start to receive data from the reader, the memory
+    // sharing is planned again for the actual sizes by PlanMemoryForMinibatch(); plans are cached per (bucketed) minibatch shape.
+    // The plans are made for the sizes of the input layouts, which are set by the reader.
+    std::vector<MBLayoutPtr> inputMBLayouts;
+    for (const auto& node : GetAllNodes())
+    {
+        if (node->IsLeaf() && node->HasMBLayout() &&
+            std::find(inputMBLayouts.begin(), inputMBLayouts.end(), node->GetMBLayout()) == inputMBLayouts.end())
+            inputMBLayouts.push_back(node->GetMBLayout());
+    }
+    m_matrixPool.SetPlanLayouts(inputMBLayouts);
 
     // TO DO: when some matrices are sparse, the memory size request may be wrong. One may need to call OptimizedMemoryAllocation later again 
     // if the requests of sparse allocation and release are re-processed correctly. Future work. 
@@ -1263,11 +1834,41 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         PrintMemorySharingStructure(GetAllNodes());
 }
 
+// Adapt the memory sharing to the minibatch about to be evaluated.
+// AllocateAllMatrices() has to plan the memory sharing without knowing the minibatch size. Once the reader has set the input
+// layouts for a minibatch, the MatrixPool can re-plan it for the actual sizes. This re-points the nodes' matrices, and must
+// therefore only happen between minibatches: the callers that set the input layouts call this once, before the first forward
+// pass of the minibatch; further forward passes of the same minibatch (e.g. of the evaluation nodes and then the criterion)
+// use the same plan.
+void ComputationNetwork::PlanMemoryForMinibatch()
+{
+    if (!m_areMatricesAllocated || !Globals::ShouldPlanMemoryPerMinibatch())
+        return;
+
+    m_matrixPool.SetMemoryArenaMode(Globals::ShouldUseMemoryArena(), Globals::ShouldUseHugePagesForMemoryArena());
+
+    size_t peakBytesBefore, peakBytesAfter;
+    if (m_matrixPool.PlanForMinibatch(peakBytesBefore, peakBytesAfter) && TraceLevel() > 0)
+    {
+        size_t numCols = 0;
+        for (const auto& pMBLayout : m_matrixPool.GetPlanLayouts())
+            numCols = max(numCols, pMBLayout->GetNumCols());
+        fprintf(stderr, "\nMemory plan for minibatch of %d columns: %.1f MB with the initial memory sharing, %.1f MB with re-planned memory sharing (%d plans cached).\n",
+                (int) numCols,
+                peakBytesBefore / 1048576.0, peakBytesAfter / 1048576.0, (int) m_matrixPool.GetNumMemPlans());
+        const auto& arena = m_matrixPool.GetMemArena();
+        if (arena)
+            fprintf(stderr, "Memory arena: %.1f MB%s.\n", arena->Size() / 1048576.0, arena->UsesHugePages() ? ", huge pages" : "");
+    }
+}
+
 void ComputationNetwork::ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap)
 {
     for (int i = 0; i < n->GetNumInputs(); i++)
     {
         ComputationNodeBasePtr pNode = n->GetInputs()[i];
+        if (IsFusedElementwiseIntermediate(pNode)) // has no matrices
+            continue;
         if (!parentsMap[pNode].empty())
         {
             parentsMap[pNode].erase(n);
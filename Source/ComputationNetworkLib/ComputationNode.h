@@ -57,7 +57,9 @@
 #define CNTK_MODEL_VERSION_25 25 // transpose: allow specifying a permutation
 #define CNTK_MODEL_VERSION_26 26 // Update ROI pooling format to match Caffe version.
 #define CNTK_MODEL_VERSION_27 27 // Slice: support stride_multiplier
+#define CNTK_MODEL_VERSION_28 28 // QuantizedTimes: int8 mode with calibrated input range (only written by networks that have such a node)
 #define CURRENT_CNTK_MODEL_VERSION CNTK_MODEL_VERSION_27
+#define LATEST_CNTK_MODEL_VERSION CNTK_MODEL_VERSION_28 // newest version that can be read; see ComputationNodeBase::GetModelVersionToSave()
 
 // helper mode for debugging
 // If TRACK_GAP_NANS is defined then initialize layout gaps to NaN and do NaN checks. Also do detailed logging of node computations.
@@ -71,7 +73,8 @@ enum CopyNodeFlags // flags to be passed to the CopyTo() function
     copyNodeValue          = 1, // copy everything except for the input links
     copyNodeInputLinks     = 2, // copy over input links
     copyNodeAll            = 3, // copy everything
-    copyNodeAcrossNetworks = 4  // allow a cross network child copy
+    copyNodeAcrossNetworks = 4, // allow a cross network child copy
+    shareNodeValue         = 8  // with copyNodeValue: refer to the same value matrix instead of copying it
 };
 
 #pragma region base computation class
@@ -178,12 +181,12 @@ struct ComputationNetworkOwnedNodeState
         : m_needsGradient(false), m_needsDynamicValidation(false), m_valueSharable(true), m_parentGradientOptimization(ParentGradientOptimization::None)
     {
         PurgeStateForFormingRecurrentLoops();
-        m_isPartOfLoop = false;
+        m_containingLoopId = -1;
     }
 
     void CopyTo(ComputationNetworkOwnedNodeState& other) const
     {
-        other.m_isPartOfLoop                  = m_isPartOfLoop;
+        other.m_containingLoopId              = m_containingLoopId;
         other.m_needsGradient                 = m_needsGradient;
         other.m_needsDynamicValidation        = m_needsDynamicValidation;
         other.m_valueSharable                 = m_valueSharable;
@@ -195,7 +198,8 @@ struct ComputationNetworkOwnedNodeState
         other.m_parentGradientOptimization    = m_parentGradientOptimization;
     }
 
-    bool IsPartOfLoop() const { return m_isPartOfLoop; }
+    bool IsPartOfLoop() const { return m_containingLoopId >= 0; }
+    bool IsPartOfSameLoopAs(const ComputationNetworkOwnedNodeState& other) const { return m_containingLoopId == other.m_containingLoopId; } // (also true if neither is part of a loop)
 
     void SetParentGradientOptimization(ParentGradientOptimization opt) { m_parentGradientOptimization = opt; }
     bool ParentGradientOptimized() const { return m_parentGradientOptimization != ParentGradientOptimization::None; }
@@ -228,7 +232,7 @@ protected:                // TODO: should be fully encapsulated here
     ParentGradientOptimization m_parentGradientOptimization; // flag indicating whether the parent of this node overwrites the gradient of this node instead of accumulating to it
 
 private:
-    bool m_isPartOfLoop; // true if this loop is part of a recurrent loop
+    int m_containingLoopId; // id of the recurrent loop this node is part of, or -1
 
 protected:
     // owned by FormRecurrentLoops() and stuff it calls, only used from inside there (FormRecurrentLoops() calls PurgeStateForFormingRecurrentLoops() at its end to make that super-clear)
@@ -383,6 +387,11 @@ public:
         // base class has nothing else to save
     }
 
+    // model version the network has to be saved with for Save() of this node to be readable
+    // Networks are saved with CURRENT_CNTK_MODEL_VERSION, unless one of their nodes uses a feature that only a newer version can
+    // represent; this way, models that do not use such a feature remain readable by older builds.
+    virtual size_t GetModelVersionToSave() const { return CURRENT_CNTK_MODEL_VERSION; }
+
     std::wstring CreateUniqNodeName() const
     {
 #ifdef USE_GUID_AS_NAME
@@ -680,6 +689,10 @@ public:
     virtual double Get00Element() const = 0;
     virtual MatrixBasePtr ValuePtr() const = 0; // for use in readers that pass the agnostic object around
 
+    // rough cost estimates for the per-node profiler (see PerformanceProfiler.h); 0 means unknown
+    virtual double ForwardPropFlopsEstimate() const { return 0; }
+    virtual size_t AllocatedMatrixBytes() const { return 0; }
+
     // TODO: two sets of functions, choose one
     const std::wstring& NodeName() const { return m_nodeName; }
     std::wstring GetName() const { return m_nodeName; }
@@ -1298,7 +1311,9 @@ public:
         if (flags & CopyNodeFlags::copyNodeValue)
         {
             auto node = DownCast(nodeP);
-            if (m_value)
+            if (m_value && (flags & CopyNodeFlags::shareNodeValue))
+                node->m_value = m_value;
+            else if (m_value)
             {
                 node->CreateValueMatrixIfNull();
                 node->m_value->SetValue(*m_value);
@@ -1678,6 +1693,13 @@ public:
     // TODO: Are all these meant to read out a scalar? Then rename and verify dimensions.
     virtual double Get00Element() const override final { return Value().Get00Element(); }
 
+    // default estimate: one operation per output element; nodes with more work per element override this
+    virtual double ForwardPropFlopsEstimate() const override { return m_value ? (double)m_value->GetNumElements() : 0; }
+    virtual size_t AllocatedMatrixBytes() const override
+    {
+        return (m_value ? m_value->BufferSize() : 0) + (m_gradient ? m_gradient->BufferSize() : 0);
+    }
+
     // -----------------------------------------------------------------------
     // dimensions and allocation
     // -----------------------------------------------------------------------
@@ -1943,10 +1965,12 @@ protected:
     {
         if (matrixPtr == nullptr)
         {
+            // mbScale requests are assumed to scale with this node's layout; this only affects how well MatrixPool::PlanForMinibatch() can plan
+            MBLayoutPtr pMBLayout = mbScale ? m_pMBLayout : nullptr;
             if (aliasing)
-                matrixPool.RequestAliasedAllocate<ElemType>(m_deviceId, this, &matrixPtr, matrixSize, mbScale);
+                matrixPool.RequestAliasedAllocate<ElemType>(m_deviceId, this, &matrixPtr, matrixSize, mbScale, pMBLayout);
             else
-                matrixPool.RequestAllocate<ElemType>(m_deviceId, &matrixPtr, matrixSize, mbScale, isWorkSpace);
+                matrixPool.RequestAllocate<ElemType>(m_deviceId, &matrixPtr, matrixSize, mbScale, isWorkSpace, pMBLayout);
         }
     }
 
@@ -2292,6 +2316,29 @@ struct ILateAttachingNode { virtual void LateAttachInputs() = 0; };
 
 struct IRecurrentNode { virtual int GetRecurrenceSteppingDirection() const = 0; };
 
+// =======================================================================
+// IFusableElementwiseNode -- interface implemented by elementwise ComputationNodes
+// whose forward and backward computations are single ElementWiseOperator opcodes,
+// so that chains of them can be evaluated in a single pass over the data
+// (see ComputationNetwork::FuseElementwiseNodes()).
+// =======================================================================
+
+struct IFusableElementwiseNode
+{
+    // operand of a backward op besides the incoming gradient
+    enum : int
+    {
+        noOperand = -2,     // unary backward op, gradient only
+        outputOperand = -1, // this node's output value
+        // >= 0: value of the input with this index
+    };
+    // forward op, applied to all inputs
+    virtual ElementWiseOperator FusedForwardOp() const = 0;
+    // backward op for input 'inputIndex': gradient of input += op(gradient of output[, operand])
+    // Returns false if no gradient flows into the input.
+    virtual bool FusedBackwardOp(size_t inputIndex, ElementWiseOperator& op, int& operand) const = 0;
+};
+
 // =======================================================================
 // IFreezable -- nodes that have parameters that can be frozen
 // e.g. if a trained model is to be used as a fixed feature extractor for another
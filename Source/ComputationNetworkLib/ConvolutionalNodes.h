@@ -336,6 +336,13 @@ public:
         return overwrite ? ParentGradientOptimization::Overwrite : ParentGradientOptimization::None;
     }
 
+    // a multiply-add per kernel element for every output element (every input element if transposed)
+    virtual double ForwardPropFlopsEstimate() const override
+    {
+        size_t numElements = m_transpose ? InputRef(1).Value().GetNumElements() : Value().GetNumElements();
+        return 2.0 * numElements * m_kernelShape.GetNumElements();
+    }
+
 public:
     void Save(File& fstream) const override
     {
@@ -30,7 +30,7 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 // -----------------------------------------------------------------------
 
 template <class ElemType>
-class PlusNode : public BinaryElementWiseNode<ElemType>
+class PlusNode : public BinaryElementWiseNode<ElemType>, public IFusableElementwiseNode
 {
     typedef BinaryElementWiseNode<ElemType> Base; UsingBinaryElementwiseNodeBaseMembers;
     static const std::wstring TypeName() { return L"Plus"; }
@@ -87,6 +87,14 @@ public:
 
         return this->InputMatchesOutput(i) ? ParentGradientOptimization::Reuse : ParentGradientOptimization::Overwrite;
     }
+
+    virtual ElementWiseOperator /*IFusableElementwiseNode::*/ FusedForwardOp() const override { return ElementWiseOperator::opSum; }
+    virtual bool /*IFusableElementwiseNode::*/ FusedBackwardOp(size_t /*inputIndex*/, ElementWiseOperator& op, int& operand) const override
+    {
+        op = ElementWiseOperator::opCopy;
+        operand = IFusableElementwiseNode::noOperand;
+        return true;
+    }
 };
 
 template class PlusNode<float>;
@@ -232,7 +240,7 @@ template class PowNode<double>;
 // -----------------------------------------------------------------------
 
 template <class ElemType>
-class MinusNode : public BinaryElementWiseNode<ElemType>
+class MinusNode : public BinaryElementWiseNode<ElemType>, public IFusableElementwiseNode
 {
     typedef BinaryElementWiseNode<ElemType> Base; UsingBinaryElementwiseNodeBaseMembers;
     static const std::wstring TypeName() { return L"Minus"; }
@@ -283,6 +291,14 @@ public:
         // only left operand can use gradient overwrite optimization
         return (Input(0).get() == input && this->InputMatchesOutput(0)) ? ParentGradientOptimization::Reuse : ParentGradientOptimization::Overwrite;
     }
+
+    virtual ElementWiseOperator /*IFusableElementwiseNode::*/ FusedForwardOp() const override { return ElementWiseOperator::opDifference; }
+    virtual bool /*IFusableElementwiseNode::*/ FusedBackwardOp(size_t inputIndex, ElementWiseOperator& op, int& operand) const override
+    {
+        op = inputIndex == 0 ? ElementWiseOperator::opCopy : ElementWiseOperator::opNegate;
+        operand = IFusableElementwiseNode::noOperand;
+        return true;
+    }
 };
 
 template class MinusNode<float>;
@@ -295,7 +311,7 @@ template class MinusNode<double>;
 // -----------------------------------------------------------------------
 
 template <class ElemType>
-class ElementTimesNode : public BinaryElementWiseNode<ElemType>
+class ElementTimesNode : public BinaryElementWiseNode<ElemType>, public IFusableElementwiseNode
 {
     typedef BinaryElementWiseNode<ElemType> Base;
     UsingBinaryElementwiseNodeBaseMembers;
@@ -327,6 +343,14 @@ public:
         return ParentGradientOptimization::Overwrite;
     }
 
+    virtual ElementWiseOperator /*IFusableElementwiseNode::*/ FusedForwardOp() const override { return ElementWiseOperator::opElementwiseProduct; }
+    virtual bool /*IFusableElementwiseNode::*/ FusedBackwardOp(size_t inputIndex, ElementWiseOperator& op, int& operand) const override
+    {
+        op = ElementWiseOperator::opElementwiseProduct;
+        operand = (int) (1 - inputIndex); // the other input's value
+        return true;
+    }
+
     template <typename classType>
     static void ForwardPropImpl(classType& c, const FrameRange& fr, bool allowBroadcast)
     {
@@ -423,6 +447,13 @@ public:
             m_inferInputRankToMap = NoInferredInputRank;
     }
 
+    // a multiply-add for every element of the left operand, per output sample
+    virtual double ForwardPropFlopsEstimate() const override
+    {
+        size_t outputSampleElements = max(GetSampleLayout().GetNumElements(), (size_t)1);
+        return 2.0 * InputRef(0).GetSampleLayout().GetNumElements() * (Value().GetNumElements() / outputSampleElements);
+    }
+
 protected:
     // if the left argument of the matrix product (A) has a time axis, it can only be applied sample by sample
     // where each sample is treated as a separate matrix object (as a consequence, it then also applies to B and the result as well)
@@ -1091,6 +1122,10 @@ template class TransposeTimesNode<double>;
 // ...
 // bitShift(A|B) - bit shift parameters of quantizers for matrices A and B, see the quantizers for more details. Decreases the maximum range of quantziation by 2^bitShift to prevent integer overflow during BLAS routines.
 // bitShift=0 doesn't change the range; higher bitShift will decrease precision of quantization, but will make BLAS routines less prone to overflow.
+// int8 - post-training 8-bit mode for weights A (a LearnableParameter): A is quantized per output row, and B with a
+// range calibrated on sample data (see Int8QuantizedMultiplier and ComputationNetwork::QuantizeTimesNodesToInt8()).
+// The bit shifts are not used in this mode. Once the weights are quantized with QuantizeWeights(), the product no longer
+// reads the float weights, which can then be released (see ComputationNetwork::ReleaseInt8FloatWeights()).
 // Other parameters - refer to the base multiplication class
 template <class ElemType>
 class QuantizedTimesNode : public TimesNodeBase<ElemType, false>
@@ -1107,17 +1142,43 @@ private:
     size_t m_bitShiftA; 
     size_t m_bitShiftB; 
 
+    // 8-bit mode, and its calibrated range of B (0 if not calibrated)
+    bool m_int8;
+    float m_inputRange;
+
+    // int8 mode: the product only reads the quantized weights, see QuantizeWeights()
+    bool m_usesQuantizedWeightsOnly;
+
+    void CreateQuantizedMultiplier()
+    {
+        if (m_int8)
+        {
+            this->m_pQuantizedMultiplier = make_shared<Int8QuantizedMultiplier<ElemType>>(m_inputRange);
+        }
+        else
+        {
+            shared_ptr<SymmetricQuantizer<ElemType, short>> pQA(new SymmetricQuantizer<ElemType, short>(m_bitShiftA));
+            shared_ptr<SymmetricQuantizer<ElemType, short>> qQB(new SymmetricQuantizer<ElemType, short>(m_bitShiftB));
+            this->m_pQuantizedMultiplier = shared_ptr<QuantizedMultiplier<ElemType>>(new QuantizedMultiplier<ElemType>(pQA, qQB));
+        }
+    }
+
+    Int8QuantizedMultiplier<ElemType>& GetInt8QuantizedMultiplier() const
+    {
+        if (!m_int8)
+            LogicError("%ls %ls operation is not in int8 mode.", NodeName().c_str(), OperationName().c_str());
+        return static_cast<Int8QuantizedMultiplier<ElemType>&>(*this->m_pQuantizedMultiplier);
+    }
+
 public:
-    QuantizedTimesNode(DEVICEID_TYPE deviceId, const wstring& name, size_t bitShiftA = 1, size_t bitShiftB = 1, size_t outputRank = 1, int inferInputRankToMap = Base::NoInferredInputRank)
-        : Base(deviceId, name, outputRank, inferInputRankToMap), m_bitShiftA(bitShiftA), m_bitShiftB(bitShiftB)
+    QuantizedTimesNode(DEVICEID_TYPE deviceId, const wstring& name, size_t bitShiftA = 1, size_t bitShiftB = 1, size_t outputRank = 1, int inferInputRankToMap = Base::NoInferredInputRank, bool int8 = false)
+        : Base(deviceId, name, outputRank, inferInputRankToMap), m_bitShiftA(bitShiftA), m_bitShiftB(bitShiftB), m_int8(int8), m_inputRange(0), m_usesQuantizedWeightsOnly(false)
     {
         // TODO support multiplication on GPUs as well.
         if (deviceId != CPUDEVICE)
             LogicError("Quantized operation is supposed to be used on CPU device only.");
 
-        shared_ptr<SymmetricQuantizer<ElemType, short>> pQA(new SymmetricQuantizer<ElemType, short>(m_bitShiftA));
-        shared_ptr<SymmetricQuantizer<ElemType, short>> qQB(new SymmetricQuantizer<ElemType, short>(m_bitShiftB));
-        this->m_pQuantizedMultiplier = shared_ptr<QuantizedMultiplier<ElemType>>(new QuantizedMultiplier<ElemType>(pQA, qQB));
+        CreateQuantizedMultiplier();
     }
 
     QuantizedTimesNode(const ScriptableObjects::IConfigRecordPtr configp)
@@ -1134,14 +1195,34 @@ public:
             auto node = dynamic_pointer_cast<QuantizedTimesNode<ElemType>>(nodeP);
             node->m_bitShiftA = m_bitShiftA;
             node->m_bitShiftB = m_bitShiftB;
+            node->m_int8 = m_int8;
+            node->m_inputRange = m_inputRange;
+            node->m_usesQuantizedWeightsOnly = m_usesQuantizedWeightsOnly;
+            node->CreateQuantizedMultiplier();
+            if (m_usesQuantizedWeightsOnly) // the copy shares the quantized weights, since the float weights may be gone
+                node->GetInt8QuantizedMultiplier().ShareWeights(GetInt8QuantizedMultiplier());
         }
     }
 
     void Save(File& fstream) const
     {
+        if (m_usesQuantizedWeightsOnly)
+            LogicError("%ls %ls operation: Cannot Save() once the product only uses the quantized weights, since their float weights may have been released.", NodeName().c_str(), OperationName().c_str());
         Base::Save(fstream);
         fstream << m_bitShiftA;
         fstream << m_bitShiftB;
+        if (m_int8)
+        {
+            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BInt8");
+            fstream << m_inputRange;
+            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EInt8");
+        }
+    }
+
+    // the int8 section needs model version 28; without it, the node is saved as by older versions
+    virtual size_t GetModelVersionToSave() const override
+    {
+        return m_int8 ? CNTK_MODEL_VERSION_28 : Base::GetModelVersionToSave();
     }
 
     virtual void Load(File& fstream, size_t modelVersion) override
@@ -1149,10 +1230,39 @@ public:
         Base::Load(fstream, modelVersion);
         fstream >> m_bitShiftA;
         fstream >> m_bitShiftB;
+        m_int8 = modelVersion >= CNTK_MODEL_VERSION_28 && fstream.TryGetMarker(FileMarker::fileMarkerBeginSection, L"BInt8");
+        if (m_int8)
+        {
+            fstream >> m_inputRange;
+            fstream.GetMarker(FileMarker::fileMarkerEndSection, L"EInt8");
+        }
+        CreateQuantizedMultiplier();
+    }
+
+    virtual void /*ComputationNodeBase::*/ Validate(bool isFinalValidationPass) override
+    {
+        Base::Validate(isFinalValidationPass);
+
+        if (isFinalValidationPass && m_int8 && !dynamic_pointer_cast<LearnableParameter<ElemType>>(Input(0)))
+            InvalidArgument("%ls %ls operation in int8 mode requires its first input to be a LearnableParameter.", NodeName().c_str(), OperationName().c_str());
     }
 
     virtual void /*ComputationNode::*/ ForwardProp(const FrameRange& fr) override
     {
+        if (m_usesQuantizedWeightsOnly)
+        {
+            // the float weights may have been released, so the product is not formed on a tensor view of them
+            auto& multiplier = GetInt8QuantizedMultiplier();
+            auto input = InputRef(1).ValueFor(fr);
+            auto output = ValueFor(fr);
+            const size_t rows = multiplier.WeightRows(), inner = multiplier.WeightCols();
+            const size_t cols = input.GetNumElements() / inner;
+            if (input.GetMatrixType() != MatrixType::DENSE || input.GetNumElements() != inner * cols || output.GetNumElements() != rows * cols)
+                LogicError("%ls %ls operation: Products with quantized weights only are supported for dense inputs of %d elements per column.", NodeName().c_str(), OperationName().c_str(), (int) inner);
+            multiplier.Multiply((int) rows, (int) cols, (int) inner, nullptr, input.Data(), output.Data());
+            return;
+        }
+
         if (dynamic_pointer_cast<LearnableParameter<ElemType>>(Input(0)))
             this->m_pQuantizedMultiplier->SetIsAConstant(true);
         if (dynamic_pointer_cast<LearnableParameter<ElemType>>(Input(1)))
@@ -1166,6 +1276,33 @@ public:
         // This operation is intended only for inference
         NOT_IMPLEMENTED;
     }
+
+    bool IsInt8() const { return m_int8; }
+    float InputRange() const { return m_inputRange; }
+
+    // int8 mode: the largest absolute value of B seen by the forward passes between these calls becomes the calibrated range
+    void StartCalibration() { GetInt8QuantizedMultiplier().StartCalibration(); }
+    void EndCalibration()
+    {
+        GetInt8QuantizedMultiplier().EndCalibration();
+        m_inputRange = GetInt8QuantizedMultiplier().InputRange();
+    }
+
+    // int8 mode: memory taken by the quantized weights, 0 before the first forward pass
+    size_t QuantizedWeightBytes() const { return GetInt8QuantizedMultiplier().QuantizedWeightBytes(); }
+
+    // int8 mode: quantizes the weights now, after which the product no longer reads the float weights of the first input
+    void QuantizeWeights()
+    {
+        const auto& shape = InputRef(0).GetSampleLayout();
+        size_t rows = 1;
+        for (size_t i = 0; i < this->OutputRank(); i++)
+            rows *= shape[i];
+        size_t cols = shape.GetNumElements() / rows;
+        GetInt8QuantizedMultiplier().QuantizeWeights((int) rows, (int) cols, InputRef(0).Value().Data());
+        m_usesQuantizedWeightsOnly = true;
+    }
+    bool UsesQuantizedWeightsOnly() const { return m_usesQuantizedWeightsOnly; }
 };
 
 template class QuantizedTimesNode<float>;
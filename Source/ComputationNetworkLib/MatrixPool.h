@@ -9,6 +9,8 @@
 #include <stdexcept>
 #include <vector>
 #include <set>
+#include <map>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -17,6 +19,7 @@
 
 #include "Basics.h"
 #include "Matrix.h"
+#include "MemArena.h"
 #include "ComputationNode.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
@@ -32,13 +35,22 @@ struct MemRequestInfo
     int allocStep;                              // at what step counter memory allocation is requested 
     int releaseStep;                            // at what step counter memory release is requested  
     int memoryId;                               // integer indexing the memory buffer ID 
-    MemRequestInfo(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace, int allocStep)
-        :deviceId(deviceId), matrixSize(matrixSize), mbScale(mbScale), isWorkSpace(isWorkSpace), allocStep(allocStep), releaseStep(INT_MAX), memoryId(-1)
+    MBLayoutPtr pMBLayout;                      // for mbScale requests: the layout whose number of columns the memory scales with (may be null)
+    MemRequestInfo(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace, int allocStep, const MBLayoutPtr& pMBLayout = nullptr)
+        :deviceId(deviceId), matrixSize(matrixSize), mbScale(mbScale), isWorkSpace(isWorkSpace), allocStep(allocStep), releaseStep(INT_MAX), memoryId(-1), pMBLayout(pMBLayout)
     {
         pMatrixPtrs.push_back(pMatrixPtr);
     }
     void SetReleaseStep(int step) { releaseStep = step; }
     void SetMemoryId(int id) { memoryId = id;  }
+
+    // size of this request for the current minibatch, in elements
+    size_t GetActualSize() const
+    {
+        if (!mbScale)
+            return matrixSize;
+        return matrixSize * (pMBLayout ? pMBLayout->GetNumCols() : 1);
+    }
 };
 
 template <class ElemType>
@@ -61,6 +73,22 @@ struct MemAllocInfo
     }
 };
 
+// memory plan computed by the minibatch-aware planner, see MatrixPool::PlanForMinibatch()
+struct MemPlan
+{
+    vector<int> memoryIdsFloat;                 // memory buffer ID of each float request, indexed like the MatrixPool's request vector (-1: not re-planned)
+    vector<int> memoryIdsDouble;                // same for double
+
+    // arena mode only: the region of the arena that each CPU buffer lives in, by (isDouble, isWorkSpace, memory ID)
+    struct ArenaRegion
+    {
+        size_t offset;
+        size_t size;
+    };
+    map<tuple<bool, bool, int>, ArenaRegion> arenaRegions;
+    size_t arenaSize = 0;
+};
+
 // MatrixPool -- class to support memory sharing
 // Despite the gather general name of this class, it is specifically designed to support the memory sharing of ComputationNodes.
 // Note: see #define SUPRESS_MEMSHARING below as for how to temporarily disable memory sharing altogether, for debugging
@@ -78,6 +106,23 @@ protected:
     template <class ElemType>
     vector<MemRequestInfo<ElemType>>& GetMemRequestInfoVec();
 
+    // minibatch-aware planning (see PlanForMinibatch())
+    vector<MBLayoutPtr> m_planLayouts;                                                      // input layouts set by the reader, whose sizes make up the signature (see SetPlanLayouts())
+    map<vector<size_t>, MemPlan> m_memPlans;                                                // cached plans, by bucketed layout signature
+    vector<size_t> m_currentPlanSignature;                                                  // signature of the plan currently applied
+    bool m_hasCurrentPlan;
+    map<pair<DEVICEID_TYPE, bool>, vector<shared_ptr<Matrix<float>>>> m_planBuffersFloat;   // shared matrices by (device, isWorkSpace), indexed by memory ID
+    map<pair<DEVICEID_TYPE, bool>, vector<shared_ptr<Matrix<double>>>> m_planBuffersDouble;
+    bool m_useMemoryArena;                                                                  // arena mode, see SetMemoryArenaMode()
+    bool m_useHugePagesForArena;
+    shared_ptr<MemArena> m_memArena;
+    map<tuple<bool, bool, int, size_t, size_t>, shared_ptr<MemAllocator>> m_arenaAllocators; // by (isDouble, isWorkSpace, memory ID, offset, size), for m_memArena
+
+    template <class ElemType>
+    vector<int>& GetPlanMemoryIds(MemPlan& plan);
+    template <class ElemType>
+    map<pair<DEVICEID_TYPE, bool>, vector<shared_ptr<Matrix<ElemType>>>>& GetPlanBuffers();
+
     // MatrixPool allows a bunch of node to share one matrix
 
     struct AliasInfo
@@ -96,6 +141,11 @@ protected:
 
 public:
 
+    MatrixPool()
+        : m_stepCounter(0), m_hasCurrentPlan(false), m_useMemoryArena(false), m_useHugePagesForArena(false)
+    {
+    }
+
     void Reset()
     {
         m_stepCounter = 0;
@@ -133,11 +183,12 @@ public:
     // global memory allocation optimziation is run to improve memory efficiency 
     // mbScale is another flag indicating if the size of the memory will scale w.r.t. the minibatch size. Unfortunately, at the time of memory
     // request and pointer assignment, we don't known the minibatch size. Thus our memory sharing algorithm is sub-optimal. 
+    // pMBLayout is the layout an mbScale request scales with; it lets PlanForMinibatch() redo the memory sharing once the size is known.
     template <class ElemType>
-    void RequestAllocate(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace)
+    void RequestAllocate(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace, const MBLayoutPtr& pMBLayout = nullptr)
     {
         vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>(); 
-        MemRequestInfo<ElemType> memInfo(deviceId, pMatrixPtr, matrixSize, mbScale, isWorkSpace, m_stepCounter);
+        MemRequestInfo<ElemType> memInfo(deviceId, pMatrixPtr, matrixSize, mbScale, isWorkSpace, m_stepCounter, pMBLayout);
         memInfoVec.push_back(memInfo); 
         m_deviceIDSet.insert(deviceId); 
         m_stepCounter++; 
@@ -151,9 +202,105 @@ public:
         // MatrixPool is not templated, so we call both float and double versions here 
         OptimizedMemoryAllocationFunc<float>(); 
         OptimizedMemoryAllocationFunc<double>();
+
+        // the requests have changed, any plan made for the previous ones is void
+        m_memPlans.clear();
+        m_currentPlanSignature.clear();
+        m_hasCurrentPlan = false;
+        m_planBuffersFloat.clear();
+        m_planBuffersDouble.clear();
+        m_arenaAllocators.clear();
         return; 
     }
 
+    // The layouts whose sizes the plans of PlanForMinibatch() are made for: the layouts of the network's inputs, which the reader
+    // sets before a minibatch is evaluated. Requests on any other layout, i.e. one that a node derives during its forward pass
+    // (e.g. WhereNode), are planned with the size of the largest of these layouts.
+    void SetPlanLayouts(const vector<MBLayoutPtr>& layouts)
+    {
+        m_planLayouts = layouts;
+        m_memPlans.clear();
+        m_currentPlanSignature.clear();
+        m_hasCurrentPlan = false;
+    }
+
+    // Minibatch-aware memory planning.
+    // OptimizedMemoryAllocation() runs before the minibatch size is known, so it can only share memory based on the per-sample
+    // sizes. Once a minibatch has been read, the actual size of every mbScale request follows from its MBLayout. This function
+    // re-solves the assignment of requests to shared matrices for these sizes: best-fit packing of the [allocStep, releaseStep]
+    // intervals, largest request first, into the tightest buffer that is free during the whole interval.
+    // The plans are cached per signature: the number of columns of each plan layout (see SetPlanLayouts()), rounded up to 2^k
+    // or 3*2^(k-1), so that variable-length minibatches do not create a new plan each. The signature only depends on the reader's
+    // layouts, so it does not change while a minibatch is evaluated, not even by several forward passes.
+    // Must only be called between minibatches, since it re-points the requesting matrix pointers to different matrices.
+    // The sharing is correct for any sizes, since it only depends on the lifetimes of the requests; the sizes only decide how
+    // tightly the buffers are packed (and in arena mode, a matrix that grows beyond its region falls back to the heap).
+    // Requests that are never released (releaseStep == INT_MAX, e.g. the gradients of LearnableParameters) are not re-planned: they
+    // keep the matrix assigned by OptimizedMemoryAllocation() for good, since users such as the SGD and the distributed gradient
+    // aggregator hold on to these matrices across minibatches.
+    // Returns true if a new plan was made; in that case peakBytesBefore/After tell the memory the matrices will occupy for this
+    // minibatch with the sharing of OptimizedMemoryAllocation() and with the new plan, respectively.
+    // In arena mode, the buffers on the CPU are moreover placed into one large memory block, the MemArena. Each buffer gets a fixed
+    // offset, such that buffers that are never in use at the same time may occupy the same addresses. Matrices allocate from their
+    // region through a MemArenaRegionAllocator, and fall back to the heap if they grow beyond it.
+    bool PlanForMinibatch(size_t& peakBytesBefore, size_t& peakBytesAfter)
+    {
+        vector<size_t> signature;
+        for (const auto& pMBLayout : m_planLayouts)
+            signature.push_back(BucketNumColumns(pMBLayout->GetNumCols()));
+
+        if (m_hasCurrentPlan && signature == m_currentPlanSignature)
+            return false;
+
+        auto iter = m_memPlans.find(signature);
+        bool isNewPlan = (iter == m_memPlans.end());
+        if (isNewPlan)
+        {
+            MemPlan plan;
+            peakBytesBefore = peakBytesAfter = 0;
+            MakeMemPlanFunc<float>(plan, peakBytesBefore, peakBytesAfter);
+            MakeMemPlanFunc<double>(plan, peakBytesBefore, peakBytesAfter);
+            if (m_useMemoryArena)
+                PlanArena(plan);
+            iter = m_memPlans.insert(make_pair(signature, plan)).first;
+        }
+
+        // the arena only ever grows; matrices still pointing into a previous one keep it alive until they are moved to the new one
+        // (the region allocators are only reused within the same arena, see ApplyMemPlanFunc())
+        if (!m_useMemoryArena)
+        {
+            m_memArena = nullptr;
+            m_arenaAllocators.clear();
+        }
+        else if (iter->second.arenaSize > 0 && (!m_memArena || m_memArena->Size() < iter->second.arenaSize))
+        {
+            m_memArena = make_shared<MemArena>(iter->second.arenaSize, m_useHugePagesForArena);
+            m_arenaAllocators.clear();
+        }
+
+        ApplyMemPlanFunc<float>(iter->second);
+        ApplyMemPlanFunc<double>(iter->second);
+        m_currentPlanSignature = signature;
+        m_hasCurrentPlan = true;
+        return isNewPlan;
+    }
+
+    size_t GetNumMemPlans() const { return m_memPlans.size(); }
+    const vector<MBLayoutPtr>& GetPlanLayouts() const { return m_planLayouts; }
+
+    // Arena mode (CPU only): let PlanForMinibatch() place all CPU buffers into one MemArena, optionally backed by huge pages.
+    void SetMemoryArenaMode(bool enable, bool useHugePages)
+    {
+        if (enable == m_useMemoryArena && useHugePages == m_useHugePagesForArena)
+            return;
+        m_useMemoryArena = enable;
+        m_useHugePagesForArena = useHugePages;
+        m_memPlans.clear(); // plans differ in whether they have arena regions
+        m_hasCurrentPlan = false;
+    }
+
+    const shared_ptr<MemArena>& GetMemArena() const { return m_memArena; }
+
     void SetAliasInfo(
         const unordered_map<AliasNodePtr, unordered_set<AliasNodePtr>>& groupMap,
         const unordered_map<AliasNodePtr, AliasNodePtr>& rootLookupMap)
@@ -203,7 +350,7 @@ public:
     }
 
     template <class ElemType>
-    void RequestAliasedAllocate(DEVICEID_TYPE deviceId, AliasNodePtr node, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale)
+    void RequestAliasedAllocate(DEVICEID_TYPE deviceId, AliasNodePtr node, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, const MBLayoutPtr& pMBLayout = nullptr)
     {
         const auto iter = m_aliasLookup.find(node);
         if (iter == m_aliasLookup.end())
@@ -215,7 +362,7 @@ public:
         {
             // first allocation for the group
             aliasInfo.pMatrixPtr = pMatrixPtr;
-            RequestAllocate(deviceId, pMatrixPtr, matrixSize, mbScale, false);
+            RequestAllocate(deviceId, pMatrixPtr, matrixSize, mbScale, false, pMBLayout);
         }
         else
         {
@@ -386,6 +533,244 @@ private:
             }
         }
     }
+
+    // a CPU buffer to be placed in the arena
+    struct ArenaBlock
+    {
+        tuple<bool, bool, int> key;     // (isDouble, isWorkSpace, memory ID)
+        size_t size;                    // bytes
+        vector<pair<int, int>> occupancy;
+        size_t offset;
+    };
+
+    template <class ElemType>
+    void CollectArenaBlocks(MemPlan& plan, vector<ArenaBlock>& blocks)
+    {
+        vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>();
+        const vector<int>& memoryIds = GetPlanMemoryIds<ElemType>(plan);
+        map<tuple<bool, bool, int>, size_t> blockIndices;
+        for (size_t i = 0; i < memInfoVec.size(); i++)
+        {
+            const auto& memInfo = memInfoVec[i];
+            if (memInfo.deviceId != CPUDEVICE || memoryIds[i] < 0)
+                continue;
+            auto key = make_tuple(std::is_same<ElemType, double>::value, memInfo.isWorkSpace, memoryIds[i]);
+            auto blockIndex = blockIndices.find(key);
+            if (blockIndex == blockIndices.end())
+            {
+                blockIndex = blockIndices.insert(make_pair(key, blocks.size())).first;
+                blocks.push_back(ArenaBlock{ key, 0, vector<pair<int, int>>(), 0 });
+            }
+            auto& block = blocks[blockIndex->second];
+            // same padding as CPUMatrix, then aligned
+            size_t size = AsMultipleOf(AsMultipleOf(GetPlannedSize(memInfo), 2) * sizeof(ElemType), MemArena::Alignment);
+            block.size = max(block.size, size);
+            block.occupancy.push_back(make_pair(memInfo.allocStep, memInfo.releaseStep));
+        }
+    }
+
+    // assign arena offsets to the plan's CPU buffers
+    // Buffers are placed largest first, each at the lowest offset where it does not collide with a buffer that is in use at
+    // the same time. (Buffers of the same plan always have some overlap, but only over a part of their lifetimes.)
+    void PlanArena(MemPlan& plan)
+    {
+        vector<ArenaBlock> blocks;
+        CollectArenaBlocks<float>(plan, blocks);
+        CollectArenaBlocks<double>(plan, blocks);
+        std::stable_sort(blocks.begin(), blocks.end(), [](const ArenaBlock& a, const ArenaBlock& b) { return a.size > b.size; });
+
+        plan.arenaRegions.clear();
+        plan.arenaSize = 0;
+        vector<ArenaBlock*> placed;
+        for (auto& block : blocks)
+        {
+            if (block.size == 0)
+                continue;
+
+            vector<ArenaBlock*> conflicts;
+            for (auto other : placed)
+            {
+                for (const auto& occ : block.occupancy)
+                {
+                    if (CheckOverlap(occ, other->occupancy))
+                    {
+                        conflicts.push_back(other);
+                        break;
+                    }
+                }
+            }
+            std::sort(conflicts.begin(), conflicts.end(), [](ArenaBlock* a, ArenaBlock* b) { return a->offset < b->offset; });
+
+            size_t offset = 0;
+            for (auto other : conflicts)
+            {
+                if (offset + block.size <= other->offset)
+                    break;
+                offset = max(offset, other->offset + other->size);
+            }
+            block.offset = offset;
+            placed.push_back(&block);
+
+            plan.arenaRegions[block.key] = MemPlan::ArenaRegion{ offset, block.size };
+            plan.arenaSize = max(plan.arenaSize, offset + block.size);
+        }
+    }
+
+    // size of a request for the plan: its per-column size times the number of columns of its plan layout, or of the largest
+    // plan layout if it scales with a derived one (see SetPlanLayouts())
+    template <class ElemType>
+    size_t GetPlannedSize(const MemRequestInfo<ElemType>& memInfo) const
+    {
+        if (!memInfo.mbScale || !memInfo.pMBLayout)
+            return memInfo.GetActualSize();
+        if (std::find(m_planLayouts.begin(), m_planLayouts.end(), memInfo.pMBLayout) != m_planLayouts.end())
+            return memInfo.GetActualSize();
+        size_t numCols = 1;
+        for (const auto& pMBLayout : m_planLayouts)
+            numCols = max(numCols, pMBLayout->GetNumCols());
+        return memInfo.matrixSize * numCols;
+    }
+
+    // round a number of columns up to the next 2^k or 3*2^(k-1)
+    static size_t BucketNumColumns(size_t numCols)
+    {
+        size_t bucket = 1;
+        while (bucket < numCols)
+        {
+            if (bucket >= 2 && bucket + bucket / 2 >= numCols)
+                return bucket + bucket / 2;
+            bucket *= 2;
+        }
+        return bucket;
+    }
+
+    // memory occupied by the shared matrices if each one is as large as the largest request assigned to it
+    // (requests without a memory ID are counted as having a matrix of their own)
+    template <class ElemType>
+    size_t ComputePeakBytes(const vector<int>& memoryIds, const vector<size_t>& sizes)
+    {
+        vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>();
+        map<tuple<DEVICEID_TYPE, bool, int>, size_t> bufferSizes;
+        for (size_t i = 0; i < memInfoVec.size(); i++)
+        {
+            int memoryId = memoryIds[i] >= 0 ? memoryIds[i] : -1 - (int) i;
+            auto& bufferSize = bufferSizes[make_tuple(memInfoVec[i].deviceId, memInfoVec[i].isWorkSpace, memoryId)];
+            bufferSize = max(bufferSize, sizes[i]);
+        }
+        size_t numElements = 0;
+        for (const auto& bufferSize : bufferSizes)
+            numElements += bufferSize.second;
+        return numElements * sizeof(ElemType);
+    }
+
+    template <class ElemType>
+    void MakeMemPlanFunc(MemPlan& plan, size_t& peakBytesBefore, size_t& peakBytesAfter)
+    {
+        vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>();
+        vector<int>& memoryIds = GetPlanMemoryIds<ElemType>(plan);
+        memoryIds.assign(memInfoVec.size(), -1);
+
+        vector<size_t> sizes;
+        vector<int> memoryIdsBefore;
+        for (const auto& memInfo : memInfoVec)
+        {
+            sizes.push_back(GetPlannedSize(memInfo));
+            memoryIdsBefore.push_back(memInfo.memoryId);
+        }
+
+        // visit the requests from largest to smallest actual size
+        vector<size_t> order(memInfoVec.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+        std::vector<bool> workspaceFlagVec = {true, false};
+        for (auto& devId : m_deviceIDSet)
+        {
+            for (auto wsFlag : workspaceFlagVec) // as in OptimizedMemoryAllocationFunc(), workspace memory is not shared with the other requests
+            {
+                vector<MemAllocInfo> memAllocInfoVec;
+                for (auto i : order)
+                {
+                    const auto& memInfo = memInfoVec[i];
+                    if (memInfo.deviceId != devId || memInfo.isWorkSpace != wsFlag)
+                        continue;
+                    if (memInfo.releaseStep == INT_MAX) // never released: keeps its matrix (see PlanForMinibatch())
+                        continue;
+
+                    // Since requests come largest first, every buffer can hold the current one; best fit is the smallest free one.
+                    auto occ = make_pair(memInfo.allocStep, memInfo.releaseStep);
+                    auto bestFit = memAllocInfoVec.end();
+                    for (auto iter = memAllocInfoVec.begin(); iter != memAllocInfoVec.end(); iter++)
+                    {
+                        if (!CheckOverlap(occ, iter->occupancy) && (bestFit == memAllocInfoVec.end() || iter->memorySize < bestFit->memorySize))
+                            bestFit = iter;
+                    }
+                    if (bestFit == memAllocInfoVec.end())
+                    {
+                        // IDs are given out in order of decreasing size, so that buffers keep similar sizes across plans
+                        memAllocInfoVec.push_back(MemAllocInfo((int) memAllocInfoVec.size(), sizes[i], vector<pair<int, int>>(1, occ)));
+                        memoryIds[i] = memAllocInfoVec.back().memoryId;
+                    }
+                    else
+                    {
+                        bestFit->occupancy.push_back(occ);
+                        memoryIds[i] = bestFit->memoryId;
+                    }
+                }
+            }
+        }
+
+        peakBytesBefore += ComputePeakBytes<ElemType>(memoryIdsBefore, sizes);
+        peakBytesAfter += ComputePeakBytes<ElemType>(memoryIds, sizes);
+    }
+
+    // re-point all requesting matrix pointers according to the plan
+    // The shared matrices are kept across plans, so that their memory gets reused when switching between plans.
+    template <class ElemType>
+    void ApplyMemPlanFunc(MemPlan& plan)
+    {
+        vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>();
+        const vector<int>& memoryIds = GetPlanMemoryIds<ElemType>(plan);
+        auto& planBuffers = GetPlanBuffers<ElemType>();
+        for (size_t i = 0; i < memInfoVec.size(); i++)
+        {
+            if (memoryIds[i] < 0)
+                continue;
+            auto& buffers = planBuffers[make_pair(memInfoVec[i].deviceId, (bool) memInfoVec[i].isWorkSpace)];
+            if (buffers.size() <= (size_t) memoryIds[i])
+                buffers.resize(memoryIds[i] + 1);
+            auto& matrixPtr = buffers[memoryIds[i]];
+            if (!matrixPtr)
+                matrixPtr = make_shared<Matrix<ElemType>>(memInfoVec[i].deviceId);
+            for (auto pOutMatrixPtr : memInfoVec[i].pMatrixPtrs)
+                *pOutMatrixPtr = matrixPtr;
+        }
+
+        // bind the CPU matrices to their regions of the arena, or back to the heap if they have none in this plan
+        for (auto& buffers : planBuffers)
+        {
+            if (buffers.first.first != CPUDEVICE)
+                continue;
+            for (size_t id = 0; id < buffers.second.size(); id++)
+            {
+                if (!buffers.second[id])
+                    continue;
+                shared_ptr<MemAllocator> allocator;
+                auto region = plan.arenaRegions.find(make_tuple(std::is_same<ElemType, double>::value, buffers.first.second, (int) id));
+                if (m_memArena && region != plan.arenaRegions.end())
+                {
+                    // A buffer that has the same region in several plans keeps its allocator, and with it its memory, when
+                    // switching between them (SetAllocator() is a no-op for the same allocator).
+                    auto& cachedAllocator = m_arenaAllocators[make_tuple(std::is_same<ElemType, double>::value, buffers.first.second, (int) id, region->second.offset, region->second.size)];
+                    if (!cachedAllocator)
+                        cachedAllocator = make_shared<MemArenaRegionAllocator>(m_memArena, region->second.offset, region->second.size);
+                    allocator = cachedAllocator;
+                }
+                buffers.second[id]->SetAllocator(allocator);
+            }
+        }
+    }
 };
 
 }}}
@@ -36,7 +36,7 @@ enum GradientOperationType
 };
 
 template <class ElemType, ElementWiseOperator opForward, ElementWiseOperator opBackward, GradientOperationType opType>
-class UnaryElementWiseWithOpCodeNodeBase : public ComputationNode<ElemType>, public NumInputs<1>, public IdentityTransformerNode
+class UnaryElementWiseWithOpCodeNodeBase : public ComputationNode<ElemType>, public NumInputs<1>, public IdentityTransformerNode, public IFusableElementwiseNode
 {
     typedef ComputationNode<ElemType> Base;
     UsingComputationNodeMembers;
@@ -100,6 +100,16 @@ public:
     }
 
     virtual ParentGradientOptimization ImplementsGradientOptimization(const ComputationNodeBase*) const override { return (opType != noGradient) ? ParentGradientOptimization::Overwrite : ParentGradientOptimization::None; }
+
+    virtual ElementWiseOperator /*IFusableElementwiseNode::*/ FusedForwardOp() const override { return opForward; }
+    virtual bool /*IFusableElementwiseNode::*/ FusedBackwardOp(size_t /*inputIndex*/, ElementWiseOperator& op, int& operand) const override
+    {
+        op = opBackward;
+        operand = (opType == binaryWithOutputGradient) ? IFusableElementwiseNode::outputOperand :
+                  (opType == binaryWithInputGradient)  ? 0 : // the input's value
+                                                         IFusableElementwiseNode::noOperand;
+        return opType != noGradient;
+    }
 };
 
 #define UnaryElementWiseWithOpCodeNodeBaseMembers UsingComputationNodeMembersBoilerplate;
@@ -0,0 +1,194 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CNTKBatchingEval.cpp : Batching front-end for the extended evaluation interface.
+//
+
+#define EVAL_EXPORTS // creating the exports here
+#include "Eval.h"
+#include "CNTKBatchingEval.h"
+#include "Basics.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+template <typename ElemType>
+CNTKBatchingEval<ElemType>::CNTKBatchingEval(IEvaluateModelExtended<ElemType>* eval, size_t maxBatchSize, size_t maxLatencyMicroseconds)
+    : m_eval(eval),
+      m_maxBatchSize(maxBatchSize),
+      m_maxLatency(maxLatencyMicroseconds),
+      m_stopping(false)
+{
+    if (!eval)
+        InvalidArgument("GetEvalBatching: No evaluator given.");
+    if (maxBatchSize == 0)
+        InvalidArgument("GetEvalBatching: The maximum batch size must be greater than 0.");
+
+    m_inputSchema = eval->GetInputSchema();
+    m_outputSchema = eval->GetOutputSchema();
+    m_worker = std::thread(&CNTKBatchingEval<ElemType>::Run, this);
+}
+
+template <typename ElemType>
+std::future<void> CNTKBatchingEval<ElemType>::ForwardPassAsync(const Values<ElemType>& inputs, Values<ElemType>& outputs, bool resetRNN)
+{
+    // The RNN state of the underlying evaluator is that of whatever minibatch was evaluated last, most likely with
+    // the sequences of other callers; so the sequences of a thread that continues the RNN state run on its own context.
+    std::promise<void> contextResult;
+    try
+    {
+        bool created = false;
+        auto context = GetThreadContext(!resetRNN, created);
+        if (context)
+        {
+            // A new context has no state to continue, since the earlier requests of the thread were batched;
+            // its first sequence starts here.
+            context->ForwardPass(inputs, outputs, resetRNN || created);
+            contextResult.set_value();
+            return contextResult.get_future();
+        }
+    }
+    catch (...)
+    {
+        contextResult.set_exception(std::current_exception());
+        return contextResult.get_future();
+    }
+
+    Request request;
+    request.m_inputs = &inputs;
+    request.m_outputs = &outputs;
+    request.m_arrival = std::chrono::steady_clock::now();
+    auto result = request.m_result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping)
+            RuntimeError("ForwardPassAsync() called after Destroy().");
+        m_requests.push_back(std::move(request));
+    }
+    m_requestsChanged.notify_one();
+    return result;
+}
+
+template <typename ElemType>
+IEvaluateModelExtended<ElemType>* CNTKBatchingEval<ElemType>::GetThreadContext(bool create, bool& created)
+{
+    auto thread = std::this_thread::get_id();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto context = m_threadContexts.find(thread);
+        if (context != m_threadContexts.end())
+            return context->second;
+    }
+    if (!create)
+        return nullptr;
+
+    IEvaluateModelExtended<ElemType>* context;
+    {
+        std::lock_guard<std::mutex> lock(m_evalMutex);
+        context = m_eval->CreateThreadContext();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threadContexts[thread] = context;
+    created = true;
+    return context;
+}
+
+template <typename ElemType>
+void CNTKBatchingEval<ElemType>::Run()
+{
+    for (;;)
+    {
+        std::vector<Request> batch;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_requestsChanged.wait(lock, [this] { return m_stopping || !m_requests.empty(); });
+            if (m_requests.empty())
+                return; // stopping, and all requests are done
+
+            auto deadline = m_requests.front().m_arrival + m_maxLatency;
+            m_requestsChanged.wait_until(lock, deadline, [this] { return m_stopping || m_requests.size() >= m_maxBatchSize; });
+            while (!m_requests.empty() && batch.size() < m_maxBatchSize)
+            {
+                batch.push_back(std::move(m_requests.front()));
+                m_requests.pop_front();
+            }
+        }
+        Evaluate(batch);
+    }
+}
+
+template <typename ElemType>
+void CNTKBatchingEval<ElemType>::Evaluate(std::vector<Request>& batch)
+{
+    std::lock_guard<std::mutex> lock(m_evalMutex);
+    if (batch.size() > 1)
+    {
+        std::vector<const Values<ElemType>*> inputs;
+        std::vector<Values<ElemType>*> outputs;
+        for (const auto& request : batch)
+        {
+            inputs.push_back(request.m_inputs);
+            outputs.push_back(request.m_outputs);
+        }
+
+        try
+        {
+            m_eval->ForwardPassBatch(inputs, outputs);
+            for (auto& request : batch)
+                request.m_result.set_value();
+            return;
+        }
+        catch (...)
+        {
+            // Most likely a malformed request; evaluate them one by one, so that only the failing ones fail.
+        }
+    }
+
+    for (auto& request : batch)
+    {
+        try
+        {
+            m_eval->ForwardPass(*request.m_inputs, *request.m_outputs, true);
+            request.m_result.set_value();
+        }
+        catch (...)
+        {
+            request.m_result.set_exception(std::current_exception());
+        }
+    }
+}
+
+template <typename ElemType>
+void CNTKBatchingEval<ElemType>::Destroy()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_requestsChanged.notify_one();
+    m_worker.join();
+
+    for (auto& context : m_threadContexts)
+        context.second->Destroy();
+    m_eval->Destroy();
+    delete this;
+}
+
+template <typename ElemType>
+void EVAL_API GetEvalBatching(IEvaluateModelExtended<ElemType>* eval, size_t maxBatchSize, size_t maxLatencyMicroseconds, IEvaluateModelBatching<ElemType>** peval)
+{
+    *peval = new CNTKBatchingEval<ElemType>(eval, maxBatchSize, maxLatencyMicroseconds);
+}
+
+extern "C" EVAL_API void GetEvalBatchingF(IEvaluateModelExtended<float>* eval, size_t maxBatchSize, size_t maxLatencyMicroseconds, IEvaluateModelBatching<float>** peval)
+{
+    GetEvalBatching(eval, maxBatchSize, maxLatencyMicroseconds, peval);
+}
+extern "C" EVAL_API void GetEvalBatchingD(IEvaluateModelExtended<double>* eval, size_t maxBatchSize, size_t maxLatencyMicroseconds, IEvaluateModelBatching<double>** peval)
+{
+    GetEvalBatching(eval, maxBatchSize, maxLatencyMicroseconds, peval);
+}
+
+template class CNTKBatchingEval<double>;
+template class CNTKBatchingEval<float>;
+}}}
@@ -0,0 +1,78 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CNTKBatchingEval.h - Batching front-end for the extended evaluation interface
+//
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Eval.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// Gathers the requests of concurrent callers, and evaluates them as the parallel sequences of one minibatch
+// on a worker thread. A minibatch is evaluated once it is full, or once its oldest request has waited for
+// the maximum latency; the worker does not wait while a minibatch is being evaluated, so under load the
+// batches grow up to the maximum size by themselves.
+// The sequences that a thread evaluates in parts (with resetRNN = false) are not batched: they run on the calling
+// thread, on a context of that thread (see IEvaluateModelExtended::CreateThreadContext()) that keeps their RNN state.
+template <typename ElemType>
+class CNTKBatchingEval : public IEvaluateModelBatching<ElemType>
+{
+public:
+    CNTKBatchingEval(IEvaluateModelExtended<ElemType>* eval, size_t maxBatchSize, size_t maxLatencyMicroseconds);
+
+    virtual VariableSchema GetInputSchema() const override { return m_inputSchema; }
+    virtual VariableSchema GetOutputSchema() const override { return m_outputSchema; }
+
+    virtual std::future<void> ForwardPassAsync(const Values<ElemType>& inputs, Values<ElemType>& outputs, bool resetRNN) override;
+
+    virtual void ForwardPass(const Values<ElemType>& inputs, Values<ElemType>& outputs, bool resetRNN) override
+    {
+        ForwardPassAsync(inputs, outputs, resetRNN).get();
+    }
+
+    virtual void Destroy() override;
+
+private:
+    struct Request
+    {
+        const Values<ElemType>* m_inputs;
+        Values<ElemType>* m_outputs;
+        std::chrono::steady_clock::time_point m_arrival;
+        std::promise<void> m_result;
+    };
+
+    void Run();
+    void Evaluate(std::vector<Request>& batch);
+
+    // Returns the context of the calling thread, creating it if create is true; nullptr if it has none.
+    IEvaluateModelExtended<ElemType>* GetThreadContext(bool create, bool& created);
+
+    IEvaluateModelExtended<ElemType>* m_eval;
+    const size_t m_maxBatchSize;
+    const std::chrono::microseconds m_maxLatency;
+    VariableSchema m_inputSchema;
+    VariableSchema m_outputSchema;
+
+    // held while m_eval evaluates, or creates a context
+    std::mutex m_evalMutex;
+    std::map<std::thread::id, IEvaluateModelExtended<ElemType>*> m_threadContexts;
+
+    std::mutex m_mutex;
+    std::condition_variable m_requestsChanged;
+    std::deque<Request> m_requests;
+    bool m_stopping;
+    std::thread m_worker;
+};
+
+}}}
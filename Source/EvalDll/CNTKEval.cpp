@@ -37,6 +37,11 @@ void CNTKEvalBase<ElemType>::Init(const std::string& config)
     CPUMatrix<ElemType>::SetNumThreads(nThreads);
 
     Globals::SetShareNodeValueMatrices(m_config(L"shareNodeValueMatrices", true));
+    Globals::SetMinibatchAwareMemoryPlanning(m_config(L"planMemoryPerMinibatch", false));
+    Globals::SetMemoryArena(m_config(L"useMemoryArena", false));
+    if (Globals::ShouldUseMemoryArena() && !Globals::ShouldPlanMemoryPerMinibatch())
+        InvalidArgument("useMemoryArena=true requires planMemoryPerMinibatch=true.");
+    Globals::SetMemoryArenaHugePages(m_config(L"memoryArenaHugePages", false));
 }
 
 
@@ -55,6 +60,14 @@ void CNTKEvalBase<ElemType>::CreateNetwork(const std::string& networkDescription
     {
         LogicError("Unable to construct network from description");
     }
+
+    // post-training int8 quantization of the products by weight matrices; models saved by the "quantize" command are
+    // already quantized and calibrated
+    if (config(L"quantizeToInt8", false))
+        this->m_net->template QuantizeTimesNodesToInt8<ElemType>();
+
+    // the int8 products only need the quantized weights
+    this->m_net->template ReleaseInt8FloatWeights<ElemType>();
 }
 
 
@@ -253,6 +266,7 @@ template<typename ElemType>
 void CNTKEvalExtended<ElemType>::StartForwardEvaluation(const std::vector<wstring>& outputNodeNames)
 {
     m_scopedNetworkOperationMode = make_shared<ScopedNetworkOperationMode>(this->m_net, NetworkOperationMode::inferring);
+    m_outputNodeNames = outputNodeNames;
     m_outputNodes  = this->m_net->OutputNodesByName(outputNodeNames);
     m_inputNodes = this->m_net->InputNodesForOutputs(outputNodeNames);
     // allocate memory for forward computation
@@ -300,6 +314,44 @@ VariableSchema CNTKEvalExtended<ElemType>::GetInputSchema() const
     return inputLayouts;
 }
 
+// Checks an input buffer against the input node, and returns the number of samples in it.
+template<typename ElemType, template<typename> class ValueContainer>
+static size_t GetNumSamples(const ComputationNodeBasePtr& inputNode, MatrixType type, const ValueBuffer<ElemType, ValueContainer>& buffer)
+{
+    size_t numRows = inputNode->GetSampleLayout().GetNumElements();
+
+    if (buffer.m_buffer.data() == nullptr)
+        RuntimeError("Input %ls: Buffer is not allocated.", inputNode->GetName().c_str());
+    if (type == MatrixType::DENSE)
+    {
+        if (buffer.m_buffer.size() % numRows != 0)
+            RuntimeError("Input %ls: Expected input data to be a multiple of %" PRIu64 ", but it is %" PRIu64 ".", 
+                         inputNode->GetName().c_str(), numRows, buffer.m_buffer.size());
+        if (buffer.m_buffer.size() == 0)
+            RuntimeError("Input %ls: Expected at least one element.", inputNode->GetName().c_str());
+    }
+    else if (type == MatrixType::SPARSE)
+    {
+        if (buffer.m_colIndices.data() == nullptr)
+            RuntimeError("Input %ls: Due to sparse input format, expected colIndices array, but was nullptr.", inputNode->GetName().c_str());
+        if (buffer.m_indices.data() == nullptr)
+            RuntimeError("Input %ls: Due to sparse input format, expected Indices array, but was nullptr.", inputNode->GetName().c_str());
+        if (buffer.m_colIndices.size() < 2)
+            RuntimeError("Input %ls: Expected at least one element (2 entries in colIndices array).", inputNode->GetName().c_str());
+        if (buffer.m_colIndices[0] != 0)
+            RuntimeError("Input %ls: First element of column indices must be 0", inputNode->GetName().c_str());
+        if (buffer.m_colIndices[buffer.m_colIndices.size() - 1] != buffer.m_indices.size())
+            RuntimeError("Input %ls: Last element of column indices must be equal to the size of indices (%ld), but was %d", 
+                         inputNode->GetName().c_str(), buffer.m_indices.size(), 
+                         buffer.m_colIndices[buffer.m_colIndices.size() - 1]);
+    }
+
+    int numCols = type == MatrixType::DENSE ? buffer.m_buffer.size() / numRows : buffer.m_colIndices.size() - 1;
+    if (numCols < 1)
+        RuntimeError("Input: the number of column must be greater than or equal to 1.");
+    return numCols;
+}
+
 template<typename ElemType>
 template<template<typename> class ValueContainer>
 void CNTKEvalExtended<ElemType>::ForwardPassT(const std::vector<ValueBuffer<ElemType, ValueContainer> >& inputs, std::vector<ValueBuffer<ElemType, ValueContainer> >& outputs, bool resetRNN)
@@ -323,35 +375,7 @@ void CNTKEvalExtended<ElemType>::ForwardPassT(const std::vector<ValueBuffer<Elem
         auto type = matrix->GetMatrixType();
         size_t numRows = inputNode->GetSampleLayout().GetNumElements();
 
-        if (buffer.m_buffer.data() == nullptr)
-            RuntimeError("Input %ls: Buffer is not allocated.", m_inputNodes[i]->GetName().c_str());
-        if (type == MatrixType::DENSE)
-        {
-            if (buffer.m_buffer.size() % numRows != 0)
-                RuntimeError("Input %ls: Expected input data to be a multiple of %" PRIu64 ", but it is %" PRIu64 ".", 
-                             m_inputNodes[i]->GetName().c_str(), numRows, buffer.m_buffer.size());
-            if (buffer.m_buffer.size() == 0)
-                RuntimeError("Input %ls: Expected at least one element.", m_inputNodes[i]->GetName().c_str());
-        }
-        else if (type == MatrixType::SPARSE)
-        {
-            if (buffer.m_colIndices.data() == nullptr)
-                RuntimeError("Input %ls: Due to sparse input format, expected colIndices array, but was nullptr.", m_inputNodes[i]->GetName().c_str());
-            if (buffer.m_indices.data() == nullptr)
-                RuntimeError("Input %ls: Due to sparse input format, expected Indices array, but was nullptr.", m_inputNodes[i]->GetName().c_str());
-            if (buffer.m_colIndices.size() < 2)
-                RuntimeError("Input %ls: Expected at least one element (2 entries in colIndices array).", m_inputNodes[i]->GetName().c_str());
-            if (buffer.m_colIndices[0] != 0)
-                RuntimeError("Input %ls: First element of column indices must be 0", m_inputNodes[i]->GetName().c_str());
-            if (buffer.m_colIndices[buffer.m_colIndices.size() - 1] != buffer.m_indices.size())
-                RuntimeError("Input %ls: Last element of column indices must be equal to the size of indices (%ld), but was %d", 
-                             m_inputNodes[i]->GetName().c_str(), buffer.m_indices.size(), 
-                             buffer.m_colIndices[buffer.m_colIndices.size() - 1]);
-        }
-
-        int numCols = type == MatrixType::DENSE ? buffer.m_buffer.size() / numRows : buffer.m_colIndices.size() - 1;
-        if (numCols < 1)
-            RuntimeError("Input: the number of column must be greater than or equal to 1.");
+        int numCols = (int)GetNumSamples(inputNode, type, buffer);
         inputNode->GetMBLayout()->Init(1, numCols);
         
         // SentinelValueIndicatingUnspecifedSequenceBeginIdx is used to specify the lower bound of look-back step of recurrent nodes
@@ -371,6 +395,7 @@ void CNTKEvalExtended<ElemType>::ForwardPassT(const std::vector<ValueBuffer<Elem
     }
 
     ComputationNetwork::BumpEvalTimeStamp(m_inputNodes);
+    this->m_net->PlanMemoryForMinibatch();
     this->m_net->ForwardProp(m_outputNodes);
 
     for (size_t i2 = 0; i2 < m_outputNodes.size(); ++i2)
@@ -429,6 +454,153 @@ void CNTKEvalExtended<ElemType>::ForwardPass(const ValueRefs<ElemType>& inputs,
     ForwardPassT(inputs, outputs, resetRNN);
 }
 
+template<typename ElemType>
+void CNTKEvalExtended<ElemType>::ForwardPassBatch(const std::vector<const Values<ElemType>*>& inputs, const std::vector<Values<ElemType>*>& outputs)
+{
+    if (!m_started)
+        RuntimeError("ForwardPassBatch() called before StartForwardEvaluation()");
+
+    const size_t numSequences = inputs.size();
+    if (numSequences == 0 || outputs.size() != numSequences)
+        RuntimeError("Expected inputs and outputs for the same, nonzero number of sequences, but got %d and %d.", (int)inputs.size(), (int)outputs.size());
+
+    for (size_t k = 0; k < numSequences; ++k)
+    {
+        if (inputs[k]->size() != m_inputNodes.size())
+            RuntimeError("Sequence %d: Expected %d inputs, but got %d.", (int)k, (int)m_inputNodes.size(), (int)inputs[k]->size());
+        if (outputs[k]->size() != m_outputNodes.size())
+            RuntimeError("Sequence %d: Expected %d outputs, but got %d.", (int)k, (int)m_outputNodes.size(), (int)outputs[k]->size());
+    }
+
+    // Sequence k goes to parallel sequence k; column t * numSequences + k holds its sample t, shorter sequences are padded with gaps.
+    for (size_t i = 0; i < m_inputNodes.size(); ++i)
+    {
+        auto& inputNode = m_inputNodes[i];
+        auto matrix = dynamic_pointer_cast<Matrix<ElemType>>(inputNode->ValuePtr());
+        auto type = matrix->GetMatrixType();
+        size_t numRows = inputNode->GetSampleLayout().GetNumElements();
+
+        vector<size_t> lengths(numSequences);
+        for (size_t k = 0; k < numSequences; ++k)
+            lengths[k] = GetNumSamples(inputNode, type, (*inputs[k])[i]);
+        size_t numTimeSteps = *std::max_element(lengths.begin(), lengths.end());
+
+        auto pMBLayout = inputNode->GetMBLayout();
+        pMBLayout->Init(numSequences, numTimeSteps);
+        for (size_t k = 0; k < numSequences; ++k)
+        {
+            pMBLayout->AddSequence(k, k, 0, lengths[k]);
+            if (lengths[k] < numTimeSteps)
+                pMBLayout->AddGap(k, lengths[k], numTimeSteps);
+        }
+
+        size_t numCols = numSequences * numTimeSteps;
+        if (type == MatrixType::DENSE)
+        {
+            vector<ElemType> data(numRows * numCols, 0);
+            for (size_t k = 0; k < numSequences; ++k)
+            {
+                const ElemType* sequence = (*inputs[k])[i].m_buffer.data();
+                for (size_t t = 0; t < lengths[k]; ++t)
+                    std::copy(sequence + t * numRows, sequence + (t + 1) * numRows, data.begin() + (t * numSequences + k) * numRows);
+            }
+            matrix->SetValue(numRows, numCols, matrix->GetDeviceId(), data.data(), matrixFlagNormal);
+        }
+        else if (type == MatrixType::SPARSE)
+        {
+            vector<int> colIndices(1, 0), rowIndices;
+            vector<ElemType> values;
+            for (size_t t = 0; t < numTimeSteps; ++t)
+            {
+                for (size_t k = 0; k < numSequences; ++k)
+                {
+                    const auto& buffer = (*inputs[k])[i];
+                    if (t < lengths[k])
+                    {
+                        rowIndices.insert(rowIndices.end(), buffer.m_indices.begin() + buffer.m_colIndices[t], buffer.m_indices.begin() + buffer.m_colIndices[t + 1]);
+                        values.insert(values.end(), buffer.m_buffer.begin() + buffer.m_colIndices[t], buffer.m_buffer.begin() + buffer.m_colIndices[t + 1]);
+                    }
+                    colIndices.push_back((int)rowIndices.size());
+                }
+            }
+            matrix->SetMatrixFromCSCFormat(colIndices.data(), rowIndices.data(), values.data(), values.size(), numRows, numCols);
+        }
+    }
+
+    ComputationNetwork::BumpEvalTimeStamp(m_inputNodes);
+    this->m_net->PlanMemoryForMinibatch();
+    this->m_net->ForwardProp(m_outputNodes);
+
+    // Scatter the output columns back to the sequences.
+    vector<ElemType> data;
+    for (size_t i = 0; i < m_outputNodes.size(); ++i)
+    {
+        auto node = m_outputNodes[i];
+        shared_ptr<Matrix<ElemType>> outputMatrix = dynamic_pointer_cast<Matrix<ElemType>>(node->ValuePtr());
+        size_t numRows = outputMatrix->GetNumRows();
+        data.resize(outputMatrix->GetNumElements());
+        ElemType* dataPtr = data.data();
+        size_t dataSize = data.size();
+        outputMatrix->CopyToArray(dataPtr, dataSize);
+
+        auto pMBLayout = node->GetMBLayout();
+        for (size_t k = 0; k < numSequences; ++k)
+        {
+            auto& vec = (*outputs[k])[i].m_buffer;
+            if (!pMBLayout) // does not depend on the input: the same for all sequences
+            {
+                if (vec.capacity() < data.size())
+                    RuntimeError("Not enough space in output buffer for output '%ls'.", node->GetName().c_str());
+                vec.assign(data.begin(), data.end());
+                continue;
+            }
+
+            auto seq = std::find_if(pMBLayout->GetAllSequences().begin(), pMBLayout->GetAllSequences().end(),
+                                    [k](const MBLayout::SequenceInfo& s) { return s.seqId == k; });
+            if (seq == pMBLayout->GetAllSequences().end())
+                RuntimeError("Output '%ls' has no value for sequence %d.", node->GetName().c_str(), (int)k);
+            size_t numSamples = seq->GetNumTimeSteps();
+            if (vec.capacity() < numSamples * numRows)
+                RuntimeError("Not enough space in output buffer for output '%ls'.", node->GetName().c_str());
+
+            vec.resize(numSamples * numRows);
+            for (size_t t = 0; t < numSamples; ++t)
+            {
+                auto column = data.begin() + pMBLayout->GetColumnIndex(*seq, t) * numRows;
+                std::copy(column, column + numRows, vec.begin() + t * numRows);
+            }
+        }
+    }
+}
+
+template <typename ElemType>
+IEvaluateModelExtended<ElemType>* CNTKEvalExtended<ElemType>::CreateThreadContext()
+{
+    if (!m_started)
+        RuntimeError("CreateThreadContext() called before StartForwardEvaluation().");
+
+    // The context evaluates a copy of the network that refers to the same parameter matrices.
+    auto context = new CNTKEvalExtended<ElemType>();
+    try
+    {
+        context->m_config = this->m_config;
+        context->m_net = this->m_net->CloneWithSharedParameters();
+        context->StartForwardEvaluation(m_outputNodeNames);
+
+        // The inputs are ordered by node, so they may come in a different order in the copy. Callers pass them in
+        // the order of this evaluator's input schema.
+        for (size_t i = 0; i < m_inputNodes.size(); i++)
+            context->m_inputNodes[i] = context->m_net->GetNodeFromName(m_inputNodes[i]->NodeName());
+        context->m_inputMatrices = DataReaderHelpers::RetrieveInputMatrices(context->m_inputNodes);
+    }
+    catch (...)
+    {
+        context->Destroy();
+        throw;
+    }
+    return context;
+}
+
 template <typename ElemType>
 void CNTKEvalExtended<ElemType>::Destroy()
 {
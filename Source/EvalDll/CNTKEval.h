@@ -107,6 +107,10 @@ public:
 
     virtual void ForwardPass(const ValueRefs<ElemType>& inputs, ValueRefs<ElemType>& output, bool resetRNN) override;
 
+    virtual IEvaluateModelExtended<ElemType>* CreateThreadContext() override;
+
+    virtual void ForwardPassBatch(const std::vector<const Values<ElemType>*>& inputs, const std::vector<Values<ElemType>*>& outputs) override;
+
     virtual void Destroy() override;
 
     virtual void CreateNetwork(const std::string& networkDescription) override
@@ -121,6 +125,7 @@ public:
 
 private:
     static VariableLayout ToVariableLayout(const ComputationNodeBasePtr n);
+    std::vector<wstring> m_outputNodeNames;
     std::vector<ComputationNodeBasePtr> m_outputNodes;
     std::shared_ptr<ScopedNetworkOperationMode> m_scopedNetworkOperationMode;
     std::vector<ComputationNodeBasePtr> m_inputNodes;
@@ -27,8 +27,11 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         }
     }
 
+    // The helpers used by BlockMultiplier have internal linkage, so that the copies instantiated in translation units
+    // compiled for AVX2 (see QuantizedOperationsAVX2.cpp) cannot be picked by the linker for the rest of the library.
+
     // Turn a row+col into an absolute offset
-    FORCEINLINE int RowColToOffset(int idxRow, int idxCol, int numCols)
+    static FORCEINLINE int RowColToOffset(int idxRow, int idxCol, int numCols)
     {
         return idxRow * numCols + idxCol;
     }
@@ -78,7 +81,7 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         }
     }
 
-    template<typename ScalarT> ScalarT* CreateAlignedMatrix(int m, int n, ScalarT initVal, int alignment = 64)
+    template<typename ScalarT> static ScalarT* CreateAlignedMatrix(int m, int n, ScalarT initVal, int alignment = 64)
     {
         ScalarT* ret = (ScalarT*)ALIGNED_ALLOC(sizeof(ScalarT) * (m * n), alignment);
 
@@ -98,7 +101,7 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         return ret;
     }
 
-    template<typename ScalarT> void FreeAlignedMatrix(ScalarT* destroyMe)
+    template<typename ScalarT> static void FreeAlignedMatrix(ScalarT* destroyMe)
     {
         ALIGNED_FREE(destroyMe);
     }
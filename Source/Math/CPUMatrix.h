@@ -28,6 +28,8 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 
 double logadd(double x, double y);
 
+template <class ElemType> class CPURNNExecutor;
+
 // To comply with BLAS libraries matrices are stored in ColMajor. However, by default C/C++/C# use RowMajor
 // conversion is need when passing data between CPUMatrix and C++ matrices
 template <class ElemType>
@@ -47,6 +49,8 @@ class MATH_API CPUMatrix : public BaseMatrix<ElemType>
     using Base::m_sob;
     using Base::ShallowCopyFrom;
     using Base::VerifyResizable;
+    using Base::GetAllocator;
+    using Base::SetStorageAllocator;
 
 public:
     using Base::VerifyWritable;
@@ -110,6 +114,9 @@ public:
 
     void AdaDelta(CPUMatrix<ElemType>& gradients, CPUMatrix<ElemType>& functionValues, ElemType learningRate, ElemType rho, ElemType epsilon);
 
+    static void MultiTensorSGDUpdate(const std::vector<CPUMatrix<ElemType>*>& parameters, const std::vector<CPUMatrix<ElemType>*>& gradients,
+                                     const std::vector<CPUMatrix<ElemType>*>& smoothedGradients, const MultiTensorSGDOptions& options);
+
     void Reshape(const size_t numRows, const size_t numCols);
 
 
@@ -121,6 +128,9 @@ public:
     // actually resizes the underlying matrix, doing any allocation as required.
     void Resize(const size_t numRows, const size_t numCols, bool growOnly = true); // by default we only reallocate if need to grow
 
+    // Let all future allocations of this matrix's buffer go through 'allocator' (nullptr for the heap). This releases the current buffer.
+    // Used by the MatrixPool to place node matrices into a memory arena.
+    void SetAllocator(const shared_ptr<MemAllocator>& allocator);
 
     ElemType* CopyToArray() const;                                                 // allocated by the callee but need to be deleted by the caller
     size_t CopyToArray(ElemType*& arrayCopyTo, size_t& currentArraySize) const;    // allocated by the callee but need to be deleted by the caller
@@ -409,12 +419,17 @@ public:
     void BatchNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<ElemType>& scale, double blendFactor, const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev,
                                     CPUMatrix<ElemType>& scaleGrad, CPUMatrix<ElemType>& biasGrad) const;
 
+    void RNNForward(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const struct RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+    void RNNBackwardData(const CPUMatrix<ElemType>& outputDY, const CPUMatrix<ElemType>& paramW, CPUMatrix<ElemType>& outputDX, const struct RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+    void RNNBackwardWeights(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& outputY, CPUMatrix<ElemType>& dw, const struct RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+
 public:
     // This functions do not depend on <ElemType>, i.e. you can call them on any <ElemType>
     static int SetNumThreads(int numThreads);
     static int GetMaxNumThreads();
 
     static void SetCompatibleMode();
+    static void SetCounterBasedRandomGenerator(bool enable);
 
     // static BLAS functions
     static void SVD(const CPUMatrix<ElemType>& A, CPUMatrix<ElemType>& SIGMA, CPUMatrix<ElemType>& U, CPUMatrix<ElemType>& VT, CPUMatrix<ElemType>& W);
@@ -470,6 +485,10 @@ public:
                      const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& regularStrides,
                      const SmallVector<size_t>& reducingOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& reducingStrides);
 
+    void FusedTensorOp(ElemType beta, const std::vector<const CPUMatrix<ElemType>*>& inputs, ElemType alpha, const FusedTensorOpProgram& program,
+                       const std::array<size_t, FusedTensorOpMaxOperands>& offsets,
+                       const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, FusedTensorOpMaxOperands>& regularStrides);
+
     static CPUMatrix<ElemType> Ones(const size_t rows, const size_t cols);
     static CPUMatrix<ElemType> Zeros(const size_t rows, const size_t cols);
     static CPUMatrix<ElemType> Eye(const size_t rows);
@@ -556,8 +575,13 @@ protected:
     size_t LocateColumn(const size_t j) const;
 
 private:
+    mutable std::shared_ptr<CPURNNExecutor<ElemType>> m_rnnExecutor; // for OptimizedRNNStack
+
     void Clear();
 
+    ElemType* NewBuffer(size_t numElements) const;
+    void DeleteBuffer(ElemType* pArray) const;
+
     void ScatterValues(ElemType* indices, ElemType* value, ElemType* data, ElemType alpha, size_t num_indices, size_t rows, size_t cols, size_t indices_step = 1);
 };
 
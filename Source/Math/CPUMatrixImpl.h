@@ -12,6 +12,8 @@
 
 #include "CPUMatrix.h"
 #include "TensorOps.h"
+#include "CPUVectorizedTensorOps.h"
+#include "CPURNN.h"
 #include <assert.h>
 #include <stdexcept>
 #include <omp.h>
@@ -875,7 +877,7 @@ void CPUMatrix<ElemType>::SetValue(const size_t numRows, const size_t numCols, E
     if (matrixFlags & matrixFlagDontOwnBuffer)
     {
         // free previous array allocation if any before overwriting
-        delete[] Buffer();
+        DeleteBuffer(Buffer());
 
         m_numRows = numRows;
         m_numCols = numCols;
@@ -1028,18 +1030,73 @@ void CPUMatrix<ElemType>::SetUniformRandomValue(const ElemType low, const ElemTy
 }
 
 
+// below this number of elements, the counter-based random fills run on the calling thread only
+static const size_t RandomFillMinElementsForParallel = 64 * 1024;
+
+static CPURNGHandle& GetCPURNGHandle(RNGHandle& rngHandle)
+{
+    CPURNGHandle* cpuRNGHandle = dynamic_cast<CPURNGHandle*>(&rngHandle);
+    if (cpuRNGHandle == nullptr)
+        LogicError("rngHandle must be a CPURNGHandle.");
+    return *cpuRNGHandle;
+}
+
+// Calls fn(i, bits, lane) for each i in [0, n), where bits[lane] is random number (offset + i) of the counter-based
+// stream of 'rng', and bits[] is the Philox block that contains it; then advances the stream by 'n'. Each block is
+// computed independently, so the result is the same for any number of threads.
+template <class FN>
+static void ForEachCounterBasedRandom(CPURNGHandle& rng, size_t n, const FN& fn)
+{
+    const uint64_t offset = rng.Offset();
+    const uint64_t firstBlock = offset / 4;
+    const long numBlocks = (long) ((offset + n + 3) / 4 - firstBlock);
+#pragma omp parallel for if (n >= RandomFillMinElementsForParallel)
+    for (long j = 0; j < numBlocks; j++)
+    {
+        const uint64_t block = firstBlock + j;
+        uint32_t bits[4];
+        rng.Philox(block, bits);
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            const uint64_t k = 4 * block + lane;
+            if (k >= offset && k < offset + n)
+                fn((size_t) (k - offset), bits, lane);
+        }
+    }
+    rng.Advance(n);
+}
+
+// random 32 bits -> uniform in [0, 1); float keeps the upper 24 bits so that the result cannot round up to 1
+static inline float UniformFromBits(uint32_t bits, float)
+{
+    return (bits >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline double UniformFromBits(uint32_t bits, double)
+{
+    return bits * (1.0 / 4294967296.0);
+}
+
 template <class ElemType>
 void CPUMatrix<ElemType>::SetUniformRandomValue(RNGHandle& rngHandle, const ElemType low, const ElemType high)
 {
     if (IsEmpty())
         LogicError("SetUniformRandomValue: Matrix is empty.");
 
-    CPURNGHandle* cpuRNGHandle = dynamic_cast<CPURNGHandle*>(&rngHandle);
-    if (cpuRNGHandle == nullptr)
-        LogicError("rngHandle must be a CPURNGHandle.");
+    CPURNGHandle& cpuRNGHandle = GetCPURNGHandle(rngHandle);
+    if (!cpuRNGHandle.IsCounterBased())
+    {
+        boost::random::uniform_real_distribution<ElemType> r(low, high);
+        std::generate(Data(), Data() + GetNumElements(), [&cpuRNGHandle, &r]() {return r(cpuRNGHandle.Generator()); });
+        return;
+    }
 
-    boost::random::uniform_real_distribution<ElemType> r(low, high);
-    std::generate(Data(), Data() + GetNumElements(), [&cpuRNGHandle, &r]() {return r(cpuRNGHandle->Generator()); });
+    ElemType* data = Data();
+    const ElemType range = high - low;
+    ForEachCounterBasedRandom(cpuRNGHandle, GetNumElements(), [=](size_t i, const uint32_t* bits, size_t lane)
+    {
+        data[i] = low + range * UniformFromBits(bits[lane], ElemType());
+    });
 }
 
 template <class ElemType>
@@ -1048,13 +1105,27 @@ void CPUMatrix<ElemType>::SetGaussianRandomValue(RNGHandle& rngHandle, const Ele
     if (IsEmpty())
         LogicError("SetGaussianRandomValue: Matrix is empty.");
 
-    CPURNGHandle* cpuRNGHandle = dynamic_cast<CPURNGHandle*>(&rngHandle);
-    if (cpuRNGHandle == nullptr)
-        LogicError("rngHandle must be a CPURNGHandle.");
-
-    boost::random::normal_distribution<ElemType> r(mean, stdev);
+    CPURNGHandle& cpuRNGHandle = GetCPURNGHandle(rngHandle);
     auto n = AsMultipleOf(GetNumElements(), 2);
-    std::generate(Data(), Data() + n, [&cpuRNGHandle, &r]() {return r(cpuRNGHandle->Generator()); });
+    if (!cpuRNGHandle.IsCounterBased())
+    {
+        boost::random::normal_distribution<ElemType> r(mean, stdev);
+        std::generate(Data(), Data() + n, [&cpuRNGHandle, &r]() {return r(cpuRNGHandle.Generator()); });
+        return;
+    }
+
+    // Box-Muller transform: random numbers 2k and 2k + 1 of the stream (always in the same Philox block) give the cosine
+    // and the sine branch, respectively. The stream advances by an even count, like the GPU version.
+    ElemType* data = Data();
+    ForEachCounterBasedRandom(cpuRNGHandle, n, [=](size_t i, const uint32_t* bits, size_t lane)
+    {
+        const size_t first = lane & ~(size_t) 1;
+        const ElemType u1 = 1 - UniformFromBits(bits[first], ElemType()); // (0, 1]
+        const ElemType u2 = UniformFromBits(bits[first + 1], ElemType());
+        const ElemType radius = stdev * sqrt(-2 * log(u1));
+        const ElemType angle = (ElemType) (2 * 3.14159265358979323846) * u2;
+        data[i] = mean + radius * ((lane & 1) ? sin(angle) : cos(angle));
+    });
 }
 
 template <class ElemType>
@@ -1063,12 +1134,19 @@ void CPUMatrix<ElemType>::SetGumbelRandomValue(RNGHandle& rngHandle, const ElemT
     if (IsEmpty())
         LogicError("SetGumbelRandomValue: Matrix is empty.");
 
-    CPURNGHandle* cpuRNGHandle = dynamic_cast<CPURNGHandle*>(&rngHandle);
-    if (cpuRNGHandle == nullptr)
-        LogicError("rngHandle must be a CPURNGHandle.");
+    CPURNGHandle& cpuRNGHandle = GetCPURNGHandle(rngHandle);
+    if (!cpuRNGHandle.IsCounterBased())
+    {
+        boost::random::uniform_real_distribution<ElemType> r(0, 1);
+        std::generate(Data(), Data() + GetNumElements(), [&cpuRNGHandle, &r, loc, scale]() {return loc - scale * log(-log1p(-r(cpuRNGHandle.Generator()))); });
+        return;
+    }
 
-    boost::random::uniform_real_distribution<ElemType> r(0, 1);
-    std::generate(Data(), Data() + GetNumElements(), [&cpuRNGHandle, &r, loc, scale]() {return loc - scale * log(-log1p(-r(cpuRNGHandle->Generator()))); });
+    ElemType* data = Data();
+    ForEachCounterBasedRandom(cpuRNGHandle, GetNumElements(), [=](size_t i, const uint32_t* bits, size_t lane)
+    {
+        data[i] = loc - scale * log(-log1p(-UniformFromBits(bits[lane], ElemType())));
+    });
 }
 
 
@@ -1162,35 +1240,42 @@ void CPUMatrix<ElemType>::SetUniformRandomMask(const ElemType maskRate, const El
     if (IsEmpty())
         LogicError("SetUniformRandomValue: Matrix is empty.");
 
-    CPURNGHandle* cpuRNGHandle = dynamic_cast<CPURNGHandle*>(&rngHandle);
-    if (cpuRNGHandle == nullptr)
-        LogicError("rngHandle must be a CPURNGHandle.");
-
-    auto& us = *this;
-    boost::random::uniform_real_distribution<ElemType> r(0, 1);
-    long m = (long) GetNumRows(), n = (long) GetNumCols();
-    ElemType v;
-    for (long j = 0; j < n; j++)
+    CPURNGHandle& cpuRNGHandle = GetCPURNGHandle(rngHandle);
+    if (!cpuRNGHandle.IsCounterBased())
     {
-        // four-way unrolling
-        for (long i = 0; i < (m & ~3); i += 4)
-        {
-            v = r(cpuRNGHandle->Generator());
-            us(i, j) = v <= maskRate ? 0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 1, j) = v <= maskRate ? 0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 2, j) = v <= maskRate ? 0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 3, j) = v <= maskRate ? 0 : scaleValue;
-        }
-        // handle remaining stuffs
-        for (long i = m & ~3; i < m; i++)
+        auto& us = *this;
+        boost::random::uniform_real_distribution<ElemType> r(0, 1);
+        long m = (long) GetNumRows(), n = (long) GetNumCols();
+        ElemType v;
+        for (long j = 0; j < n; j++)
         {
-            v = r(cpuRNGHandle->Generator());
-            us(i, j) = v <= maskRate ? 0 : scaleValue;
+            // four-way unrolling
+            for (long i = 0; i < (m & ~3); i += 4)
+            {
+                v = r(cpuRNGHandle.Generator());
+                us(i, j) = v <= maskRate ? 0 : scaleValue;
+                v = r(cpuRNGHandle.Generator());
+                us(i + 1, j) = v <= maskRate ? 0 : scaleValue;
+                v = r(cpuRNGHandle.Generator());
+                us(i + 2, j) = v <= maskRate ? 0 : scaleValue;
+                v = r(cpuRNGHandle.Generator());
+                us(i + 3, j) = v <= maskRate ? 0 : scaleValue;
+            }
+            // handle remaining stuffs
+            for (long i = m & ~3; i < m; i++)
+            {
+                v = r(cpuRNGHandle.Generator());
+                us(i, j) = v <= maskRate ? 0 : scaleValue;
+            }
         }
+        return;
     }
+
+    ElemType* data = Data();
+    ForEachCounterBasedRandom(cpuRNGHandle, GetNumElements(), [=](size_t i, const uint32_t* bits, size_t lane)
+    {
+        data[i] = UniformFromBits(bits[lane], ElemType()) <= maskRate ? 0 : scaleValue;
+    });
 }
 
 template <class ElemType>
@@ -1487,6 +1572,118 @@ void CPUMatrix<ElemType>::AdaDelta(CPUMatrix<ElemType>& gradients, CPUMatrix<Ele
     }
 }
 
+// Fused SGD step over a list of parameters. The elements of all parameters are split into chunks of similar size,
+// which are processed in a single parallel pass that does gradient scaling, clipping, L2 regularization and the
+// (momentum) update at once. This avoids the per-parameter overhead and the repeated memory sweeps of running these
+// as separate operations, which dominate for networks with many small parameters. Clipping by the Frobenius norm
+// needs an additional read-only pass to compute the norms.
+// Without smoothed gradients this is plain SGD. Like the separate operations, it leaves the preprocessed gradients behind.
+template <class ElemType>
+/*static*/ void CPUMatrix<ElemType>::MultiTensorSGDUpdate(const std::vector<CPUMatrix<ElemType>*>& parameters, const std::vector<CPUMatrix<ElemType>*>& gradients,
+                                                          const std::vector<CPUMatrix<ElemType>*>& smoothedGradients, const MultiTensorSGDOptions& options)
+{
+    const size_t numTensors = parameters.size();
+    const bool useSmoothedGradients = !smoothedGradients.empty();
+    if (gradients.size() != numTensors || (useSmoothedGradients && smoothedGradients.size() != numTensors))
+        InvalidArgument("MultiTensorSGDUpdate: The number of parameters, gradients and smoothed gradients does not match.");
+
+    struct Chunk
+    {
+        size_t tensor;
+        size_t begin;
+        size_t end;
+    };
+    const size_t chunkSize = 16384;
+    std::vector<Chunk> chunks;
+    for (size_t t = 0; t < numTensors; t++)
+    {
+        const size_t n = parameters[t]->GetNumElements();
+        if (gradients[t]->GetNumElements() != n || (useSmoothedGradients && smoothedGradients[t]->GetNumElements() != n))
+            InvalidArgument("MultiTensorSGDUpdate: The gradient or smoothed gradient of parameter %d does not match its size.", (int) t);
+        for (size_t begin = 0; begin < n; begin += chunkSize)
+            chunks.push_back({ t, begin, std::min(begin + chunkSize, n) });
+    }
+    const long numChunks = (long) chunks.size();
+
+    const ElemType gradientScale = (ElemType) options.gradientScale;
+    const bool clip = options.clippingThreshold != std::numeric_limits<double>::infinity();
+    const bool truncate = clip && options.clippingWithTruncation;
+    const ElemType thresholdPos = (ElemType) fabs(options.clippingThreshold);
+    const ElemType thresholdNeg = -thresholdPos;
+
+    // norm-based clipping: one factor per parameter, from the norm of its scaled gradient
+    std::vector<ElemType> clipFactors(numTensors, 1);
+    if (clip && !truncate)
+    {
+        std::vector<double> chunkSquares(numChunks);
+#pragma omp parallel for
+        for (long c = 0; c < numChunks; c++)
+        {
+            const ElemType* grad = gradients[chunks[c].tensor]->Data();
+            double sum = 0;
+            for (size_t i = chunks[c].begin; i < chunks[c].end; i++)
+            {
+                const ElemType g = gradientScale * grad[i];
+                sum += g * g;
+            }
+            chunkSquares[c] = sum;
+        }
+
+        // summed up in chunk order, so that the result does not depend on the number of threads
+        std::vector<double> tensorSquares(numTensors, 0);
+        for (long c = 0; c < numChunks; c++)
+            tensorSquares[chunks[c].tensor] += chunkSquares[c];
+        for (size_t t = 0; t < numTensors; t++)
+        {
+            const double norm = sqrt(tensorSquares[t]);
+            if (norm > options.clippingThreshold)
+                clipFactors[t] = (ElemType) (options.clippingThreshold / norm);
+        }
+    }
+
+    const ElemType l2Weight = (ElemType) options.l2RegularizationWeight;
+    const ElemType learnRate = (ElemType) options.learnRatePerSample;
+    const ElemType momentum = (ElemType) options.momentum;
+    const ElemType unitGainLearnRate = ElemType(options.unitGainMomentum ? (1.0 - options.momentum) : 1.0) * learnRate;
+    const bool nesterov = options.nesterov;
+
+#pragma omp parallel for
+    for (long c = 0; c < numChunks; c++)
+    {
+        const Chunk& chunk = chunks[c];
+        ElemType* val = parameters[chunk.tensor]->Data();
+        ElemType* grad = gradients[chunk.tensor]->Data();
+        ElemType* smoothed = useSmoothedGradients ? smoothedGradients[chunk.tensor]->Data() : nullptr;
+        const ElemType clipFactor = clipFactors[chunk.tensor];
+        for (size_t i = chunk.begin; i < chunk.end; i++)
+        {
+            ElemType g = gradientScale * grad[i] * clipFactor;
+            if (truncate)
+            {
+                if (g > thresholdPos)
+                    g = thresholdPos;
+                else if (g < thresholdNeg)
+                    g = thresholdNeg;
+            }
+            if (l2Weight != 0)
+                g += l2Weight * val[i];
+            grad[i] = g;
+
+            if (!useSmoothedGradients)
+                val[i] -= learnRate * g;
+            else
+            {
+                const ElemType sg = momentum * smoothed[i] + unitGainLearnRate * g;
+                smoothed[i] = sg;
+                if (!nesterov)
+                    val[i] -= sg;
+                else
+                    val[i] = val[i] - momentum * sg - unitGainLearnRate * g;
+            }
+        }
+    }
+}
+
 template <class ElemType>
 void CPUMatrix<ElemType>::Reshape(const size_t numRows, const size_t numCols)
 {
@@ -1526,10 +1723,10 @@ void CPUMatrix<ElemType>::Resize(const size_t numRows, const size_t numCols, boo
         ElemType* pArray = nullptr;
         if (numElements > 0)
         {
-            pArray = NewArray<ElemType>(numElements);
+            pArray = NewBuffer(numElements);
         }
         // success: update the object
-        delete[] Buffer();
+        DeleteBuffer(Buffer());
 
         SetBuffer(pArray, numElements * sizeof(ElemType));
         SetSizeAllocated(numElements);
@@ -1541,6 +1738,49 @@ void CPUMatrix<ElemType>::Resize(const size_t numRows, const size_t numCols, boo
     m_numCols         = numCols;
 }
 
+template <class ElemType>
+void CPUMatrix<ElemType>::SetAllocator(const shared_ptr<MemAllocator>& allocator)
+{
+    if (GetAllocator() == allocator)
+        return;
+
+    VerifyResizable(__func__);
+
+    DeleteBuffer(Buffer());
+    SetBuffer(nullptr, 0);
+    SetSizeAllocated(0);
+    SetStorageAllocator(allocator);
+
+    m_sliceViewOffset = 0;
+    m_numRows         = 0;
+    m_numCols         = 0;
+}
+
+// allocate a buffer for Resize(), through the storage's allocator if it has one
+// Unlike NewArray(), an allocator may return memory that is not zero-initialized.
+template <class ElemType>
+ElemType* CPUMatrix<ElemType>::NewBuffer(size_t numElements) const
+{
+    const auto& allocator = GetAllocator();
+    if (!allocator)
+        return NewArray<ElemType>(numElements);
+
+    ElemType* pArray = (ElemType*) allocator->Malloc(AsMultipleOf(numElements, 2) * sizeof(ElemType)); // (same padding as NewArray())
+    if (pArray == nullptr)
+        RuntimeError("CPUMatrix: failed to allocate %d elements.", (int) numElements);
+    return pArray;
+}
+
+template <class ElemType>
+void CPUMatrix<ElemType>::DeleteBuffer(ElemType* pArray) const
+{
+    const auto& allocator = GetAllocator();
+    if (!allocator)
+        delete[] pArray;
+    else if (pArray != nullptr)
+        allocator->Free(pArray);
+}
+
 // allocated by the callee but should be deleted by the caller
 // TODO: change to use STL vector instead
 template <class ElemType>
@@ -4908,6 +5148,34 @@ void CPUMatrix<ElemType>::BatchNormalizationBackward(const CPUMatrix<ElemType>&
     RuntimeError("Batch normalization training on CPU is not yet implemented.");
 }
 
+#pragma region RNN Functions
+
+template <class ElemType>
+void CPUMatrix<ElemType>::RNNForward(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    if (!m_rnnExecutor)
+        m_rnnExecutor = std::make_shared<CPURNNExecutor<ElemType>>(xDim, yDim, rnnAttributes);
+    m_rnnExecutor->ForwardCore(paramW, inputX, *this, numSequencesForFrame, rnnAttributes, reserve, workspace);
+}
+
+template <class ElemType>
+void CPUMatrix<ElemType>::RNNBackwardData(const CPUMatrix<ElemType>& outputDY, const CPUMatrix<ElemType>& paramW, CPUMatrix<ElemType>& outputDX, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    if (!m_rnnExecutor)
+        LogicError("RNNBackwardData called, but RNN executor object is not yet initialized");
+    m_rnnExecutor->BackwardDataCore(*this, outputDY, paramW, outputDX, rnnAttributes, reserve, workspace);
+}
+
+template <class ElemType>
+void CPUMatrix<ElemType>::RNNBackwardWeights(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& outputY, CPUMatrix<ElemType>& dw, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    if (!m_rnnExecutor)
+        LogicError("RNNBackwardWeights called, but RNN executor object is not yet initialized");
+    m_rnnExecutor->BackwardWeightsCore(inputX, outputY, dw, rnnAttributes, reserve, workspace);
+}
+
+#pragma endregion
+
 
 #pragma region Static BLAS Functions
 
@@ -6739,6 +7007,14 @@ int CPUMatrix<ElemType>::GetMaxNumThreads()
     return numThreads;
 }
 
+// Selects the counter-based generator for the RNGHandle-based random fills (dropout masks, random distribution nodes)
+// of the CPU RNG handles created from now on. Off by default, since it changes the random values of existing setups.
+template <class ElemType>
+void CPUMatrix<ElemType>::SetCounterBasedRandomGenerator(bool enable)
+{
+    CPURNGHandle::UseCounterBasedGenerator(enable);
+}
+
 // To ensure Intel MKL calls return the same results on all Intel or Intel compatible CPUs,
 // the function set CBWR compatible mode.
 template <class ElemType>
@@ -6748,6 +7024,8 @@ void CPUMatrix<ElemType>::SetCompatibleMode()
         if (mkl_cbwr_set(MKL_CBWR_COMPATIBLE) != MKL_CBWR_SUCCESS)
             RuntimeError("Could not set MKL compatible mode.");
     #endif
+    // the vectorized TensorOp kernels may approximate transcendentals (if enabled), so results would depend on the CPU's instruction set
+    CPUVectorizedTensorOps::SetInstructionSet(CPUInstructionSet::Scalar);
 }
 
 // =======================================================================
@@ -6927,20 +7205,17 @@ struct TensorOpIteration<ElemType, OPFN, ReductionOp, 3, true /*vectorizable*/,
         size_t K = regularOpDims[0];
         // special-case beta and alpha to allow the compiler to short-circuit it
         if (beta != 0)
-#pragma omp parallel for
-            for (int k = 0; k < (int) K; k++)
+            for (size_t k = 0; k < K; k++)
                 TensorOpIteration<ElemType, OPFN, ReductionOp, 3, true /*vectorizable*/, -1 /*no reduction*/, -1 /*scalar*/>::Loop(beta, array<ElemType*, 3>{pa + k, pb + k, pc + k}, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
         else if (alpha != 1)
-#pragma omp parallel for
-            for (int k = 0; k < (int) K; k++)
+            for (size_t k = 0; k < K; k++)
                 TensorOpIteration<ElemType, OPFN, ReductionOp, 3, true /*vectorizable*/, -1 /*no reduction*/, -1 /*scalar*/>::Loop(0, array<ElemType*, 3>{pa + k, pb + k, pc + k}, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
         else
-#pragma omp parallel for
-            for (int k = 0; k < (int) K; k++)
+            for (size_t k = 0; k < K; k++)
                 TensorOpIteration<ElemType, OPFN, ReductionOp, 3, true /*vectorizable*/, -1 /*no reduction*/, -1 /*scalar*/>::Loop(0, array<ElemType*, 3>{pa + k, pb + k, pc + k}, 1, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
         // TODO: According to Amit, the VS compiler is not able to vectorize into lambdas. Solution: change the lambda to take an N, or to implement the loop inside (with 1 element by default).
-        // TODO: The signedness of k (required for omp) causes an extra sign-extend.
-        // TODO: OMP adds LOTS of overhead. Do we need a guard, a min size when to use it?
+        // Note: This loop is intentionally serial. Threading is done once at the top by TensorOpWithRegularLoopInParallel(),
+        // which hands each thread a slice of the outermost dimension, instead of entering an OMP region per innermost loop.
     }
 };
 // and unary
@@ -6956,16 +7231,13 @@ struct TensorOpIteration<ElemType, OPFN, ReductionOp, 2, true /*vectorizable*/,
         size_t K = regularOpDims[0];
         // special-case beta and alpha to allow the compiler to short-circuit it
         if (beta != 0)
-#pragma omp parallel for
-            for (int k = 0; k < (int) K; k++)
+            for (size_t k = 0; k < K; k++)
                 TensorOpIteration<ElemType, OPFN, ReductionOp, 2, true /*vectorizable*/, -1 /*no reduction*/, -1 /*scalar*/>::Loop(beta, array<ElemType*, 2>{pa + k, pb + k}, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
         else if (alpha != 1)
-#pragma omp parallel for
-            for (int k = 0; k < (int) K; k++)
+            for (size_t k = 0; k < K; k++)
                 TensorOpIteration<ElemType, OPFN, ReductionOp, 2, true /*vectorizable*/, -1 /*no reduction*/, -1 /*scalar*/>::Loop(0, array<ElemType*, 2>{pa + k, pb + k}, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
         else
-#pragma omp parallel for
-            for (int k = 0; k < (int) K; k++)
+            for (size_t k = 0; k < K; k++)
                 TensorOpIteration<ElemType, OPFN, ReductionOp, 2, true /*vectorizable*/, -1 /*no reduction*/, -1 /*scalar*/>::Loop(0, array<ElemType*, 2>{pa + k, pb + k}, 1, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
     }
 };
@@ -7065,6 +7337,177 @@ static void TensorOpWithRegularLoop(ElemType beta, const array<ElemType*, N>& po
     }
 }
 
+// -----------------------------------------------------------------------
+// parallel execution of tensor operations
+// -----------------------------------------------------------------------
+
+// Tensor ops below this many elements (counting both regular and reduced elements) per thread are run single-threaded,
+// since entering an OMP region costs more than the op itself.
+static const size_t TensorOpMinElementsPerThread = 16384;
+
+// determine how many threads to use for a tensor op touching 'numElements' elements
+// This honors CPUMatrix::SetNumThreads(), which sets the OMP default.
+static int TensorOpNumThreads(size_t numElements)
+{
+#ifdef _OPENMP
+    if (omp_in_parallel()) // already inside a parallel region (e.g. called from a parallel loop): don't nest
+        return 1;
+    size_t maxThreads = (size_t) omp_get_max_threads();
+    size_t numThreads = numElements / TensorOpMinElementsPerThread;
+    return (int) max((size_t) 1, min(numThreads, maxThreads));
+#else
+    UNUSED(numElements);
+    return 1;
+#endif
+}
+
+// Parallel reduction of a single output element over reduction index m.
+// The outermost reduction dimension m is split into 'numParts' contiguous slices. Each slice is reduced by the regular
+// serial TensorOpReduction. The partial results are then combined pairwise in a fixed tree order, so that the result
+// only depends on the number of parts, not on the thread scheduling.
+template <class ElemType, typename OPFN, typename ReductionOp, size_t N, int m>
+struct TensorOpParallelReduction
+{
+    static ElemType Loop(const array<ElemType*, N>& pointers, const OPFN& opfn, const ReductionOp& reductionOp,
+                         const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, N>& reducingStrides, int numThreads)
+    {
+        size_t dim = reducingOpDims[(size_t) m];
+        int numParts = (int) min((size_t) numThreads, dim);
+        vector<double> partials(numParts);
+#pragma omp parallel for num_threads(numParts)
+        for (int t = 0; t < numParts; t++)
+        {
+            size_t begin = dim * t / numParts;
+            size_t end = dim * (t + 1) / numParts;
+            SmallVector<size_t> partOpDims = reducingOpDims;
+            partOpDims[(size_t) m] = end - begin;
+            array<ElemType*, N> partPointers = pointers;
+            for (size_t i = 0; i < N - 1; i++) // last pointer (result) is unused in reduction
+                partPointers[i] += (ptrdiff_t) begin * reducingStrides[i][(size_t) m];
+            partials[t] = TensorOpReduction<ElemType, OPFN, ReductionOp, N, m>::Loop(partPointers, opfn, reductionOp, partOpDims, reducingStrides);
+        }
+        // tree-combine the partial results
+        for (int stride = 1; stride < numParts; stride *= 2)
+            for (int t = 0; t + stride < numParts; t += 2 * stride)
+                partials[t] = reductionOp(partials[t], partials[t + stride]);
+        return (ElemType) partials[0];
+    }
+
+    // run the reduction for all output elements
+    //  - if there are at least as many outputs as threads, each thread reduces a contiguous range of the flattened outputs
+    //    serially, in a single OMP region;
+    //  - otherwise, the outputs are visited serially and each one is reduced by Loop() above.
+    static void LoopOverOutputs(ElemType beta, const array<ElemType*, N>& pointers, ElemType alpha, const OPFN& opfn, const ReductionOp& reductionOp,
+                                const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, N>& regularStrides,
+                                const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, N>& reducingStrides, int numThreads)
+    {
+        size_t numOutputs = 1;
+        for (size_t d = 0; d < regularOpDims.size(); d++)
+            numOutputs *= regularOpDims[d];
+
+        if (numOutputs >= (size_t) numThreads)
+        {
+#pragma omp parallel for num_threads(numThreads)
+            for (int t = 0; t < numThreads; t++)
+            {
+                size_t begin = numOutputs * t / numThreads;
+                size_t end = numOutputs * (t + 1) / numThreads;
+                for (size_t j = begin; j < end; j++)
+                {
+                    auto outPointers = OutputPointers(pointers, regularOpDims, regularStrides, j);
+                    StoreOutput(beta, outPointers, alpha, TensorOpReduction<ElemType, OPFN, ReductionOp, N, m>::Loop(outPointers, opfn, reductionOp, reducingOpDims, reducingStrides));
+                }
+            }
+            return;
+        }
+
+        for (size_t j = 0; j < numOutputs; j++)
+        {
+            auto outPointers = OutputPointers(pointers, regularOpDims, regularStrides, j);
+            StoreOutput(beta, outPointers, alpha, Loop(outPointers, opfn, reductionOp, reducingOpDims, reducingStrides, numThreads));
+        }
+    }
+
+private:
+    // locate output element j of the flattened regular dimensions
+    static array<ElemType*, N> OutputPointers(const array<ElemType*, N>& pointers, const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, N>& regularStrides, size_t j)
+    {
+        array<ElemType*, N> outPointers = pointers;
+        for (size_t d = 0; d < regularOpDims.size(); d++)
+        {
+            size_t coord = j % regularOpDims[d];
+            j /= regularOpDims[d];
+            for (size_t i = 0; i < N; i++)
+                outPointers[i] += (ptrdiff_t) coord * regularStrides[i][d];
+        }
+        return outPointers;
+    }
+
+    // scale and combine the reduced value like TensorOpIteration<..., -1> does
+    static void StoreOutput(ElemType beta, const array<ElemType*, N>& outPointers, ElemType alpha, ElemType val)
+    {
+        val *= alpha;
+        auto* pout = outPointers.back();
+        if (beta != 0)
+            val += beta * *pout;
+        *pout = val;
+    }
+};
+
+// tensor operation with k+1 dimensions, distributed over the OMP thread pool
+// Work is split along one dimension only, and each thread runs the regular serial loop on its slice:
+//  - if there are enough output elements, the outermost regular dimension k is split (each thread owns distinct outputs);
+//  - otherwise, if there is a reduction, the flattened outputs are split if there are enough of them, and else the outermost
+//    reduction dimension is split, and partial results are tree-combined.
+// Small ops fall back to TensorOpWithRegularLoop() on the calling thread.
+template <class ElemType, typename OPFN, typename ReductionOp, size_t N, int k>
+static void TensorOpWithRegularLoopInParallel(ElemType beta, const array<ElemType*, N>& pointers, ElemType alpha, const OPFN& opfn, ReductionOp reductionOp,
+                                              const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, N>& regularStrides,
+                                              const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, N>& reducingStrides)
+{
+    size_t numOutputs = 1;
+    for (size_t d = 0; d < regularOpDims.size(); d++)
+        numOutputs *= regularOpDims[d];
+    size_t numReduced = 1;
+    for (size_t d = 0; d < reducingOpDims.size(); d++)
+        numReduced *= reducingOpDims[d];
+
+    int numThreads = TensorOpNumThreads(numOutputs * numReduced);
+    if (numThreads <= 1)
+        return TensorOpWithRegularLoop<ElemType, OPFN, ReductionOp, N, k>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+
+    // split the outermost regular dimension
+    size_t outerDim = k >= 0 ? regularOpDims[(size_t) k] : 1;
+    if (outerDim >= (size_t) numThreads || (outerDim > 1 && reducingOpDims.empty()))
+    {
+        int numParts = (int) min((size_t) numThreads, outerDim);
+#pragma omp parallel for num_threads(numParts)
+        for (int t = 0; t < numParts; t++)
+        {
+            size_t begin = outerDim * t / numParts;
+            size_t end = outerDim * (t + 1) / numParts;
+            SmallVector<size_t> partOpDims = regularOpDims;
+            partOpDims[(size_t) k] = end - begin;
+            array<ElemType*, N> partPointers = pointers;
+            for (size_t i = 0; i < N; i++)
+                partPointers[i] += (ptrdiff_t) begin * regularStrides[i][(size_t) k];
+            TensorOpWithRegularLoop<ElemType, OPFN, ReductionOp, N, k>(beta, partPointers, alpha, opfn, reductionOp, partOpDims, regularStrides, reducingOpDims, reducingStrides);
+        }
+        return;
+    }
+
+    // small outermost regular dimension: split the flattened outputs, or, if too few, the outermost reduction dimension
+    switch (reducingOpDims.size())
+    {
+    case 2:
+        return TensorOpParallelReduction<ElemType, OPFN, ReductionOp, N, 1>::LoopOverOutputs(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides, numThreads);
+    case 1:
+        return TensorOpParallelReduction<ElemType, OPFN, ReductionOp, N, 0>::LoopOverOutputs(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides, numThreads);
+    default: // no reduction and a single output element, or unsupported (will fail inside)
+        return TensorOpWithRegularLoop<ElemType, OPFN, ReductionOp, N, k>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    }
+}
+
 // tensor operation, generalized in number of arguments, operation already provided as a lambda
 // This function now expands into different k.
 template <class ElemType, typename OPFN, typename ReductionOp, size_t N>
@@ -7079,15 +7522,15 @@ static void TensorOpWithFnAndReduction(ElemType beta, array<ElemType*, N> pointe
     switch (dims)
     {
     case 4:
-        return TensorOpWithRegularLoop<ElemType, OPFN, ReductionOp, N, 3>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+        return TensorOpWithRegularLoopInParallel<ElemType, OPFN, ReductionOp, N, 3>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
     case 3:
-        return TensorOpWithRegularLoop<ElemType, OPFN, ReductionOp, N, 2>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+        return TensorOpWithRegularLoopInParallel<ElemType, OPFN, ReductionOp, N, 2>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
     case 2:
-        return TensorOpWithRegularLoop<ElemType, OPFN, ReductionOp, N, 1>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+        return TensorOpWithRegularLoopInParallel<ElemType, OPFN, ReductionOp, N, 1>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
     case 1:
-        return TensorOpWithRegularLoop<ElemType, OPFN, ReductionOp, N, 0>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+        return TensorOpWithRegularLoopInParallel<ElemType, OPFN, ReductionOp, N, 0>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
     case 0:
-        return TensorOpWithRegularLoop<ElemType, OPFN, ReductionOp, N, -1>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+        return TensorOpWithRegularLoopInParallel<ElemType, OPFN, ReductionOp, N, -1>(beta, pointers, alpha, opfn, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
     default:
         LogicError("TensorOp: %d non-flattened input dimensions are not supported.", (int)dims);
     }
@@ -7127,6 +7570,99 @@ static void TensorOpWithFn(ElemType beta, array<ElemType*, N> pointers, ElemType
     }
 }
 
+// -----------------------------------------------------------------------
+// explicitly vectorized innermost loops (CPUVectorizedTensorOps.h)
+// -----------------------------------------------------------------------
+
+// Kernels exist for float only. For other types (and for non-vectorized ops) the lookup yields nullptr.
+static inline VectorizedUnaryTensorOpKernel LookupVectorizedKernel(const array<float*, 2>&, ElementWiseOperator op)
+{
+    return CPUVectorizedTensorOps::GetUnaryKernel(op);
+}
+static inline VectorizedBinaryTensorOpKernel LookupVectorizedKernel(const array<float*, 3>&, ElementWiseOperator op)
+{
+    return CPUVectorizedTensorOps::GetBinaryKernel(op);
+}
+template <class ElemType, size_t N>
+static inline nullptr_t LookupVectorizedKernel(const array<ElemType*, N>&, ElementWiseOperator)
+{
+    return nullptr;
+}
+
+static inline void CallVectorizedKernel(VectorizedUnaryTensorOpKernel kernel, size_t n, const array<float*, 2>& pointers, float alpha, float beta)
+{
+    kernel(n, pointers[0], pointers[1], alpha, beta);
+}
+static inline void CallVectorizedKernel(VectorizedBinaryTensorOpKernel kernel, size_t n, const array<float*, 3>& pointers, float alpha, float beta)
+{
+    kernel(n, pointers[0], pointers[1], pointers[2], alpha, beta);
+}
+template <class ElemType, size_t N>
+static inline void CallVectorizedKernel(nullptr_t, size_t, const array<ElemType*, N>&, ElemType, ElemType)
+{
+}
+
+// Run a tensor op with an explicitly vectorized kernel, if there is one for 'op' and the innermost dimension is contiguous
+// in all operands (and there is no reduction). Returns false if not applicable, in which case nothing has been done.
+// The op is executed row by row (a row = the innermost dimension), with rows or chunks of rows distributed over threads.
+template <class ElemType, size_t N>
+static bool TensorOpWithVectorizedKernel(ElemType beta, array<ElemType*, N> pointers, ElemType alpha, ElementWiseOperator op,
+                                         const array<size_t, N>& offsets,
+                                         const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, N>& regularStrides,
+                                         const SmallVector<size_t>& reducingOpDims)
+{
+    if (!reducingOpDims.empty() || regularOpDims.empty())
+        return false;
+    for (size_t i = 0; i < N; i++)
+    {
+        if (regularStrides[i][0] != 1)
+            return false;
+    }
+    let kernel = LookupVectorizedKernel(pointers, op);
+    if (kernel == nullptr)
+        return false;
+
+    for (size_t i = 0; i < N; i++)
+        pointers[i] += offsets[i];
+    size_t rowLength = regularOpDims[0];
+    size_t numRows = 1;
+    for (size_t d = 1; d < regularOpDims.size(); d++)
+        numRows *= regularOpDims[d];
+
+    // if there are fewer rows than threads, rows are additionally cut into chunks
+    int numThreads = TensorOpNumThreads(rowLength * numRows);
+    const size_t chunkAlignment = 64; // elements; keeps chunk boundaries on cache lines for aligned rows
+    size_t numChunksPerRow = 1;
+    if (numRows < (size_t) numThreads)
+        numChunksPerRow = min((numThreads + numRows - 1) / numRows, (rowLength + chunkAlignment - 1) / chunkAlignment);
+    size_t chunkLength = (rowLength + numChunksPerRow - 1) / numChunksPerRow;
+    chunkLength = (chunkLength + chunkAlignment - 1) / chunkAlignment * chunkAlignment;
+    numChunksPerRow = (rowLength + chunkLength - 1) / chunkLength;
+
+    size_t numTasks = numRows * numChunksPerRow;
+#pragma omp parallel for num_threads(numThreads) if (numThreads > 1)
+    for (long long task = 0; task < (long long) numTasks; task++)
+    {
+        size_t row = (size_t) task / numChunksPerRow;
+        size_t begin = ((size_t) task % numChunksPerRow) * chunkLength;
+        size_t end = min(begin + chunkLength, rowLength);
+        // locate the row
+        array<ElemType*, N> rowPointers = pointers;
+        size_t index = row;
+        for (size_t d = 1; d < regularOpDims.size(); d++)
+        {
+            size_t coord = index % regularOpDims[d];
+            index /= regularOpDims[d];
+            for (size_t i = 0; i < N; i++)
+                rowPointers[i] += (ptrdiff_t) coord * regularStrides[i][d];
+        }
+        for (size_t i = 0; i < N; i++)
+            rowPointers[i] += begin;
+        CallVectorizedKernel(kernel, end - begin, rowPointers, alpha, beta);
+    }
+    return true;
+}
+
 // -----------------------------------------------------------------------
 // entry points from Matrix.cpp; also map op to a lambda
 // -----------------------------------------------------------------------
@@ -7156,6 +7692,8 @@ void CPUMatrix<ElemType>::TensorOp(ElemType beta, const CPUMatrix<ElemType>& a,
                               reductionOp, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides)
 
     array<ElemType*, 2> pointers = {a.Data(), Data()};
+    if (TensorOpWithVectorizedKernel(beta, pointers, alpha, op, offsets, regularOpDims, regularStrides, reducingOpDims))
+        return;
     switch (op)
     {
         ForAllUnaryOps(CaseUnaryTensorOp);
@@ -7184,6 +7722,8 @@ void CPUMatrix<ElemType>::TensorOp(ElemType beta, const CPUMatrix<ElemType>& a,
                               reductionOp, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides)
 
     array<ElemType*, 3> pointers = {a.Data(), b.Data(), Data()};
+    if (TensorOpWithVectorizedKernel(beta, pointers, alpha, op, offsets, regularOpDims, regularStrides, reducingOpDims))
+        return;
     switch (op)
     {
         ForAllBinaryOps(CaseBinaryTensorOp);
@@ -7220,6 +7760,190 @@ void CPUMatrix<ElemType>::TensorOp(ElemType beta, const CPUMatrix<ElemType>& a,
     }
 }
 
+// -----------------------------------------------------------------------
+// fused elementwise programs (FusedTensorOpProgram, see CommonMatrix.h)
+// -----------------------------------------------------------------------
+
+// Programs are executed block by block along the innermost dimension. All registers of a block live in a
+// thread-local scratch buffer, so intermediate results stay in cache and are never written to memory.
+static const size_t FusedTensorOpBlockSize = 256;
+
+// execute one program step on a block of register values (scalar reference version)
+template <class ElemType>
+static void FusedTensorOpStepWithFn(ElementWiseOperator op, size_t n, const ElemType* a, const ElemType* b, const ElemType* c, ElemType* result)
+{
+#define CaseUnaryFusedTensorOpStep(oper)     \
+    case ElementWiseOperator::op##oper:      \
+        for (size_t j = 0; j < n; j++)       \
+            result[j] = Op##oper(a[j]);      \
+        return
+#define CaseBinaryFusedTensorOpStep(oper)    \
+    case ElementWiseOperator::op##oper:      \
+        for (size_t j = 0; j < n; j++)       \
+            result[j] = Op##oper(a[j], b[j]); \
+        return
+#define CaseTernaryFusedTensorOpStep(oper)         \
+    case ElementWiseOperator::op##oper:            \
+        for (size_t j = 0; j < n; j++)             \
+            result[j] = Op##oper(a[j], b[j], c[j]); \
+        return
+
+    switch (op)
+    {
+        ForAllUnaryOps(CaseUnaryFusedTensorOpStep);
+        ForAllBinaryOps(CaseBinaryFusedTensorOpStep);
+        ForAllTernaryOps(CaseTernaryFusedTensorOpStep);
+    default:
+        LogicError("FusedTensorOp: Unknown op code %d.", (int) op);
+    }
+#undef CaseUnaryFusedTensorOpStep
+#undef CaseBinaryFusedTensorOpStep
+#undef CaseTernaryFusedTensorOpStep
+}
+
+// execute one program step, using the explicitly vectorized kernels where available (float only)
+template <class ElemType>
+static inline void RunFusedTensorOpStep(const FusedTensorOpStep& step, size_t n, const ElemType* a, const ElemType* b, const ElemType* c, ElemType* result)
+{
+    FusedTensorOpStepWithFn(step.op, n, a, b, c, result);
+}
+static inline void RunFusedTensorOpStep(const FusedTensorOpStep& step, size_t n, const float* a, const float* b, const float* c, float* result)
+{
+    if (step.numArgs == 1)
+    {
+        let kernel = CPUVectorizedTensorOps::GetUnaryKernel(step.op);
+        if (kernel != nullptr)
+            return kernel(n, a, result, 1, 0);
+    }
+    else if (step.numArgs == 2)
+    {
+        let kernel = CPUVectorizedTensorOps::GetBinaryKernel(step.op);
+        if (kernel != nullptr)
+            return kernel(n, a, b, result, 1, 0);
+    }
+    FusedTensorOpStepWithFn(step.op, n, a, b, c, result);
+}
+
+// store a block of results as alpha * result + beta * output
+template <class ElemType>
+static inline void FusedTensorOpStore(size_t n, const ElemType* result, ElemType* output, ptrdiff_t stride, ElemType alpha, ElemType beta)
+{
+    for (size_t j = 0; j < n; j++)
+    {
+        ElemType& out = output[j * stride];
+        out = beta == 0 ? alpha * result[j] : alpha * result[j] + beta * out; // output is not read if beta == 0
+    }
+}
+static inline void FusedTensorOpStore(size_t n, const float* result, float* output, ptrdiff_t stride, float alpha, float beta)
+{
+    let kernel = stride == 1 ? CPUVectorizedTensorOps::GetUnaryKernel(ElementWiseOperator::opCopy) : nullptr;
+    if (kernel != nullptr)
+        return kernel(n, result, output, alpha, beta);
+    for (size_t j = 0; j < n; j++)
+    {
+        float& out = output[j * stride];
+        out = beta == 0 ? alpha * result[j] : alpha * result[j] + beta * out;
+    }
+}
+
+// execute a FusedTensorOpProgram over all elements of the output
+// Operands [0, inputs.size()) are the inputs, the last operand is the output. There is no reduction.
+// Inputs that are contiguous along the innermost dimension are read in place, others are gathered into their register.
+// A block reads all of its inputs before writing its output, so the output may be one of the inputs.
+template <class ElemType>
+void CPUMatrix<ElemType>::FusedTensorOp(ElemType beta, const vector<const CPUMatrix<ElemType>*>& inputs, ElemType alpha, const FusedTensorOpProgram& program,
+                                        const array<size_t, FusedTensorOpMaxOperands>& offsets,
+                                        const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, FusedTensorOpMaxOperands>& regularStrides)
+{
+    program.Verify(inputs.size());
+
+    const size_t numInputs = inputs.size();
+    const size_t outputIndex = FusedTensorOpMaxOperands - 1;
+    array<ElemType*, FusedTensorOpMaxOperands> pointers;
+    pointers.fill(nullptr);
+    for (size_t i = 0; i < numInputs; i++)
+        pointers[i] = inputs[i]->Data() + offsets[i];
+    pointers[outputIndex] = Data() + offsets[outputIndex];
+
+    // innermost dimension is processed in blocks; all others are rows
+    const size_t rank = regularOpDims.size();
+    const size_t rowLength = rank > 0 ? regularOpDims[0] : 1;
+    size_t numRows = 1;
+    for (size_t d = 1; d < rank; d++)
+        numRows *= regularOpDims[d];
+    if (rowLength == 0 || numRows == 0)
+        return;
+    auto InnerStride = [&](size_t i) -> ptrdiff_t { return rank > 0 ? regularStrides[i][0] : 1; };
+
+    const size_t B = FusedTensorOpBlockSize;
+    const size_t numBlocksPerRow = (rowLength + B - 1) / B;
+    const size_t numTasks = numRows * numBlocksPerRow;
+    const size_t numRegisters = program.GetNumRegisters();
+    // each step touches every element, hence the work scales with the program length
+    int numThreads = TensorOpNumThreads(rowLength * numRows * max(program.steps.size(), (size_t) 1));
+
+#pragma omp parallel num_threads(numThreads) if (numThreads > 1)
+    {
+        vector<ElemType> scratch(numRegisters * B); // this thread's register file
+        vector<const ElemType*> registers(numRegisters);
+#pragma omp for
+        for (long long task = 0; task < (long long) numTasks; task++)
+        {
+            size_t row = (size_t) task / numBlocksPerRow;
+            size_t begin = ((size_t) task % numBlocksPerRow) * B;
+            size_t n = min(B, rowLength - begin);
+
+            // locate the block in all operands
+            array<ElemType*, FusedTensorOpMaxOperands> blockPointers = pointers;
+            size_t index = row;
+            for (size_t d = 1; d < rank; d++)
+            {
+                size_t coord = index % regularOpDims[d];
+                index /= regularOpDims[d];
+                for (size_t i = 0; i < numInputs; i++)
+                    blockPointers[i] += (ptrdiff_t) coord * regularStrides[i][d];
+                blockPointers[outputIndex] += (ptrdiff_t) coord * regularStrides[outputIndex][d];
+            }
+
+            // load the inputs
+            for (size_t i = 0; i < numInputs; i++)
+            {
+                ptrdiff_t stride = InnerStride(i);
+                const ElemType* p = blockPointers[i] + (ptrdiff_t) begin * stride;
+                if (stride == 1)
+                    registers[i] = p;
+                else
+                {
+                    ElemType* r = &scratch[i * B];
+                    if (stride == 0) // broadcasting
+                        std::fill(r, r + n, *p);
+                    else
+                        for (size_t j = 0; j < n; j++)
+                            r[j] = p[j * stride];
+                    registers[i] = r;
+                }
+            }
+
+            // run the program
+            for (size_t k = 0; k < program.steps.size(); k++)
+            {
+                const auto& step = program.steps[k];
+                ElemType* r = &scratch[(numInputs + k) * B];
+                RunFusedTensorOpStep(step, n,
+                                     registers[step.args[0]],
+                                     step.numArgs > 1 ? registers[step.args[1]] : nullptr,
+                                     step.numArgs > 2 ? registers[step.args[2]] : nullptr,
+                                     r);
+                registers[numInputs + k] = r;
+            }
+
+            // store the result
+            ptrdiff_t outputStride = InnerStride(outputIndex);
+            FusedTensorOpStore(n, registers[program.resultRegister], blockPointers[outputIndex] + (ptrdiff_t) begin * outputStride, outputStride, alpha, beta);
+        }
+    }
+}
+
 template <class ElemType>
 int CPUMatrix<ElemType>::Argmin() const
 {
@@ -10,11 +10,14 @@
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+std::atomic<bool> CPURNGHandle::s_useCounterBasedGenerator(false);
+
 CPURNGHandle::CPURNGHandle(int deviceId, uint64_t seed, uint64_t offset)
     : RNGHandle(deviceId),
-    m_generator(seed)
+    m_counterBased(s_useCounterBasedGenerator),
+    m_seed(seed),
+    m_offset(offset)
 {
-    m_generator.discard(offset);
 }
 
 }}}
@@ -8,23 +8,87 @@
 #pragma once
 
 #include "RNGHandle.h"
+#include <atomic>
 #include <memory>
 #include <random>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// The CPU random number generator.
+// By default all random values come from the sequential Generator(). Optionally (see UseCounterBasedGenerator()),
+// the elementwise random fills of CPUMatrix use a counter-based generator instead (Philox4x32-10, Salmon et al., SC'11):
+// random number k of the stream is a pure function of (seed, k), so any element can be computed independently
+// of the others, in parallel, and the result does not depend on the number of threads. The state of the stream
+// is just (seed, offset), which is what the RNG users save in their checkpoints, so restoring it is O(1).
+// The two generators produce different streams, so switching changes e.g. the dropout masks of a training run.
+// Code that draws numbers one by one (e.g. sampling) always uses the sequential Generator().
 class CPURNGHandle : public RNGHandle
 {
 public:
     CPURNGHandle(int deviceId, uint64_t seed, uint64_t offset = 0);
 
+    // selects the generator of the elementwise random fills for handles created from now on
+    static void UseCounterBasedGenerator(bool enable)
+    {
+        s_useCounterBasedGenerator = enable;
+    }
+
+    bool IsCounterBased() const
+    {
+        return m_counterBased;
+    }
+
+    // sequential generator, created on first use
     std::mt19937_64& Generator()
     {
-        return m_generator;
+        if (!m_generator)
+        {
+            m_generator.reset(new std::mt19937_64(m_seed));
+            m_generator->discard(m_offset);
+        }
+        return *m_generator;
+    }
+
+    // counter-based generator: the number of random values consumed so far
+    uint64_t Offset() const
+    {
+        return m_offset;
+    }
+
+    void Advance(uint64_t count)
+    {
+        m_offset += count;
+    }
+
+    // computes the four 32-bit random values number [4 * block, 4 * block + 4) of the counter-based stream
+    void Philox(uint64_t block, uint32_t (&result)[4]) const
+    {
+        uint32_t c0 = (uint32_t) block, c1 = (uint32_t) (block >> 32), c2 = 0, c3 = 0;
+        uint32_t k0 = (uint32_t) m_seed, k1 = (uint32_t) (m_seed >> 32);
+        for (int round = 0; round < 10; round++)
+        {
+            const uint64_t p0 = (uint64_t) 0xD2511F53 * c0;
+            const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2;
+            c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+            c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+            c1 = (uint32_t) p1;
+            c3 = (uint32_t) p0;
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        result[0] = c0;
+        result[1] = c1;
+        result[2] = c2;
+        result[3] = c3;
     }
 
 private:
-    std::mt19937_64 m_generator;
+    static std::atomic<bool> s_useCounterBasedGenerator;
+
+    bool m_counterBased;
+    uint64_t m_seed;
+    uint64_t m_offset;
+    std::unique_ptr<std::mt19937_64> m_generator;
 };
 
 }}}
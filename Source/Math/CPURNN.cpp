@@ -0,0 +1,374 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CPURNN.h"
+#include "TensorOps.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// c = op(a) * op(b) + beta * c on dense column-major buffers, where a is [aRows x aCols] and b is [bRows x bCols]
+template <class ElemType>
+static void Gemm(const ElemType* a, size_t aRows, size_t aCols, bool transposeA, const ElemType* b, size_t bRows, size_t bCols, bool transposeB, ElemType beta, ElemType* c)
+{
+    if (aRows * aCols == 0 || bRows * bCols == 0)
+        return;
+    CPUMatrix<ElemType> matA(aRows, aCols, const_cast<ElemType*>(a), matrixFlagDontOwnBuffer);
+    CPUMatrix<ElemType> matB(bRows, bCols, const_cast<ElemType*>(b), matrixFlagDontOwnBuffer);
+    CPUMatrix<ElemType> matC(transposeA ? aCols : aRows, transposeB ? bRows : bCols, c, matrixFlagDontOwnBuffer);
+    CPUMatrix<ElemType>::MultiplyAndWeightedAdd(1, matA, transposeA, matB, transposeB, beta, matC);
+}
+
+template <class ElemType>
+CPURNNExecutor<ElemType>::CPURNNExecutor(size_t xDim, size_t yDim, const RnnAttributes& rnnAttributes)
+    : m_xDim(xDim), m_yDim(yDim),
+    m_rnnAttributes(rnnAttributes),
+    m_numColumns(0),
+    m_BackwardDataCalledYet(false)
+{
+    if      (m_rnnAttributes.m_recurrentOp == wstring(L"lstm"))    m_cellType = CellType::lstm;
+    else if (m_rnnAttributes.m_recurrentOp == wstring(L"gru"))     m_cellType = CellType::gru;
+    else if (m_rnnAttributes.m_recurrentOp == wstring(L"rnnReLU")) m_cellType = CellType::rnnReLU;
+    else if (m_rnnAttributes.m_recurrentOp == wstring(L"rnnTanh")) m_cellType = CellType::rnnTanh;
+    else InvalidArgument("Unknown cell type '%ls'. Supported values are 'lstm', 'gru', 'rnnReLU', 'rnnTanh'.", m_rnnAttributes.m_recurrentOp.c_str());
+
+    m_numGates = m_cellType == CellType::lstm ? 4 : m_cellType == CellType::gru ? 3 : 1;
+}
+
+template <class ElemType>
+size_t CPURNNExecutor<ElemType>::InputWeightsOffset(size_t pseudoLayer) const
+{
+    const size_t hiddenSize = m_rnnAttributes.m_hiddenSize;
+    size_t offset = 0;
+    for (size_t p = 0; p < pseudoLayer; p++)
+        offset += (LayerInputDim(p / NumDirections()) + hiddenSize) * GatesDim();
+    return offset;
+}
+
+// Runs one direction of one layer over all frames. The input projection of all frames is one matrix product,
+// then each frame adds the recurrent projection of the sequences that continue from the previous frame, and
+// applies the gates elementwise, in parallel over the sequences.
+template <class ElemType>
+void CPURNNExecutor<ElemType>::ForwardPseudoLayer(size_t pseudoLayer, const ElemType* w, const ElemType* x, ElemType* y, size_t yDim, ElemType* reserve, ElemType* workspace)
+{
+    const size_t H = m_rnnAttributes.m_hiddenSize;
+    const size_t G = GatesDim();
+    const size_t numFrames = m_numSequencesForFrame.size();
+    const bool backward = pseudoLayer % NumDirections() == 1;
+    const CellType cellType = m_cellType;
+
+    ElemType* gates  = reserve + GatesOffset(pseudoLayer);
+    ElemType* state  = reserve + StateOffset(pseudoLayer);
+    ElemType* hidden = reserve + HiddenOffset(pseudoLayer);
+    ElemType* yDir   = y + (pseudoLayer % NumDirections()) * H;
+    const ElemType* recurrentWeights = w + RecurrentWeightsOffset(pseudoLayer);
+    const ElemType* inputBias        = w + BiasOffset(pseudoLayer);
+    const ElemType* recurrentBias    = inputBias + G;
+    ElemType* recurrent = workspace; // [G x numSequences] recurrent projection of the current frame
+
+    // input projection of all frames: gates = W x + b_W
+    Gemm(w + InputWeightsOffset(pseudoLayer), LayerInputDim(pseudoLayer / NumDirections()), G, true, x, LayerInputDim(pseudoLayer / NumDirections()), m_numColumns, false, (ElemType)0, gates);
+#pragma omp parallel for
+    for (long j = 0; j < (long)m_numColumns; j++)
+    {
+        for (size_t g = 0; g < G; g++)
+            gates[j * G + g] += inputBias[g];
+    }
+
+    for (size_t step = 0; step < numFrames; step++)
+    {
+        const size_t t = backward ? numFrames - 1 - step : step;
+        const size_t numSequences = m_numSequencesForFrame[t];
+        const size_t numContinuing = NumContinuingSequences(t, backward);
+        const size_t prevColumn = numContinuing > 0 ? m_frameOffsets[PreviousFrame(t, backward)] : 0;
+        const size_t column0 = m_frameOffsets[t];
+
+        // recurrent projection of the sequences that continue; the others start from a zero state
+        Gemm(recurrentWeights, H, G, true, hidden + prevColumn * H, H, numContinuing, false, (ElemType)0, recurrent);
+
+#pragma omp parallel for
+        for (long j = 0; j < (long)numSequences; j++)
+        {
+            const bool continuing = (size_t)j < numContinuing;
+            const size_t column = column0 + j;
+            ElemType* a = gates + column * G;
+            const ElemType* r = recurrent + j * G;
+            auto Recurrent = [&](size_t g) { return (continuing ? r[g] : 0) + recurrentBias[g]; };
+            for (size_t k = 0; k < H; k++)
+            {
+                ElemType h;
+                if (cellType == CellType::lstm)
+                {
+                    const ElemType i = Sigmoid(a[k]         + Recurrent(k));
+                    const ElemType f = Sigmoid(a[H + k]     + Recurrent(H + k));
+                    const ElemType c = tanh(   a[2 * H + k] + Recurrent(2 * H + k));
+                    const ElemType o = Sigmoid(a[3 * H + k] + Recurrent(3 * H + k));
+                    const ElemType cellPrev = continuing ? state[(prevColumn + j) * H + k] : 0;
+                    const ElemType cell = f * cellPrev + i * c;
+                    h = o * tanh(cell);
+                    a[k] = i; a[H + k] = f; a[2 * H + k] = c; a[3 * H + k] = o;
+                    state[column * H + k] = cell;
+                }
+                else if (cellType == CellType::gru)
+                {
+                    const ElemType reset  = Sigmoid(a[k]     + Recurrent(k));
+                    const ElemType update = Sigmoid(a[H + k] + Recurrent(H + k));
+                    const ElemType q = Recurrent(2 * H + k); // the reset gate applies to the recurrent projection including its bias
+                    const ElemType c = tanh(a[2 * H + k] + reset * q);
+                    const ElemType hiddenPrev = continuing ? hidden[(prevColumn + j) * H + k] : 0;
+                    h = (1 - update) * c + update * hiddenPrev;
+                    a[k] = reset; a[H + k] = update; a[2 * H + k] = c;
+                    state[column * H + k] = q;
+                }
+                else
+                {
+                    const ElemType z = a[k] + Recurrent(k);
+                    h = cellType == CellType::rnnTanh ? tanh(z) : z > 0 ? z : 0;
+                    a[k] = h;
+                }
+                hidden[column * H + k] = h;
+                yDir[column * yDim + k] = h;
+            }
+        }
+    }
+}
+
+// Backpropagates through one direction of one layer, in reverse frame order. Stores the gradients of the gates'
+// pre-activations in the workspace for BackwardWeightsCore(); the gradient into the previous frame is one matrix
+// product per frame.
+template <class ElemType>
+void CPURNNExecutor<ElemType>::BackwardDataPseudoLayer(size_t pseudoLayer, const ElemType* w, const ElemType* dy, size_t yDim, ElemType* reserve, ElemType* workspace)
+{
+    const size_t H = m_rnnAttributes.m_hiddenSize;
+    const size_t G = GatesDim();
+    const size_t numFrames = m_numSequencesForFrame.size();
+    const size_t maxNumSequences = numFrames > 0 ? m_numSequencesForFrame[0] : 0;
+    const bool backward = pseudoLayer % NumDirections() == 1;
+    const CellType cellType = m_cellType;
+
+    const ElemType* gates  = reserve + GatesOffset(pseudoLayer);
+    const ElemType* state  = reserve + StateOffset(pseudoLayer);
+    const ElemType* hidden = reserve + HiddenOffset(pseudoLayer);
+    const ElemType* dyDir  = dy + (pseudoLayer % NumDirections()) * H;
+    const ElemType* recurrentWeights = w + RecurrentWeightsOffset(pseudoLayer);
+    ElemType* dGates          = workspace + InputGradientOffset(pseudoLayer);
+    ElemType* dRecurrentGates = workspace + RecurrentGradientOffset(pseudoLayer);
+    ElemType* dHidden = workspace + BackwardTempOffset(); // [H x numSequences] gradient from the frame processed before
+    ElemType* dState  = dHidden + H * maxNumSequences;     // [H x numSequences] same for the LSTM cell state
+
+    size_t numReceiving = 0; // sequences of the current frame that receive a gradient from the frame processed before
+    for (size_t step = 0; step < numFrames; step++)
+    {
+        const size_t t = backward ? step : numFrames - 1 - step;
+        const size_t numSequences = m_numSequencesForFrame[t];
+        const size_t numContinuing = NumContinuingSequences(t, backward);
+        const size_t prevColumn = numContinuing > 0 ? m_frameOffsets[PreviousFrame(t, backward)] : 0;
+        const size_t column0 = m_frameOffsets[t];
+
+#pragma omp parallel for
+        for (long j = 0; j < (long)numSequences; j++)
+        {
+            const bool receiving = (size_t)j < numReceiving;
+            const bool continuing = (size_t)j < numContinuing;
+            const size_t column = column0 + j;
+            const ElemType* a = gates + column * G;
+            ElemType* dz  = dGates + column * G;
+            ElemType* dzr = dRecurrentGates + column * G;
+            for (size_t k = 0; k < H; k++)
+            {
+                const ElemType dh = dyDir[column * yDim + k] + (receiving ? dHidden[j * H + k] : 0);
+                if (cellType == CellType::lstm)
+                {
+                    const ElemType i = a[k], f = a[H + k], c = a[2 * H + k], o = a[3 * H + k];
+                    const ElemType cellPrev = continuing ? state[(prevColumn + j) * H + k] : 0;
+                    const ElemType tanhCell = tanh(state[column * H + k]);
+                    const ElemType dCell = dh * o * (1 - tanhCell * tanhCell) + (receiving ? dState[j * H + k] : 0);
+                    dz[k]         = dCell * c * i * (1 - i);
+                    dz[H + k]     = dCell * cellPrev * f * (1 - f);
+                    dz[2 * H + k] = dCell * i * (1 - c * c);
+                    dz[3 * H + k] = dh * tanhCell * o * (1 - o);
+                    dState[j * H + k] = dCell * f;
+                }
+                else if (cellType == CellType::gru)
+                {
+                    const ElemType reset = a[k], update = a[H + k], c = a[2 * H + k];
+                    const ElemType hiddenPrev = continuing ? hidden[(prevColumn + j) * H + k] : 0;
+                    const ElemType dc = dh * (1 - update) * (1 - c * c);
+                    dz[2 * H + k]  = dc;
+                    dzr[2 * H + k] = dc * reset;
+                    dz[k]     = dzr[k]     = dc * state[column * H + k] * reset * (1 - reset);
+                    dz[H + k] = dzr[H + k] = dh * (hiddenPrev - c) * update * (1 - update);
+                    dHidden[j * H + k] = dh * update;
+                }
+                else
+                {
+                    const ElemType h = a[k];
+                    dz[k] = cellType == CellType::rnnTanh ? dh * (1 - h * h) : h > 0 ? dh : 0;
+                }
+            }
+        }
+
+        // gradient into the previous frame of the continuing sequences (for GRU, added to the direct path through the update gate)
+        Gemm(recurrentWeights, H, G, false, dRecurrentGates + column0 * G, G, numContinuing, false, (ElemType)(cellType == CellType::gru ? 1 : 0), dHidden);
+        numReceiving = numContinuing;
+    }
+}
+
+template <class ElemType>
+void CPURNNExecutor<ElemType>::ForwardCore(
+    const CPUMatrix<ElemType>& weightsW,
+    const CPUMatrix<ElemType>& inputX, CPUMatrix<ElemType>& outputY,
+    const vector<size_t>& numSequencesForFrame,
+    const RnnAttributes& rnnAttributes,
+    CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    // test that the RNN shape is correct
+    if (!(m_rnnAttributes == rnnAttributes))
+        LogicError("RNN Layout has changed during processing");
+
+    if (m_yDim != NumDirections() * m_rnnAttributes.m_hiddenSize)
+        InvalidArgument("CPU RNN ForwardCore: Output leading dimension must be twice hidden size for bidirectional networks");
+
+    m_numSequencesForFrame = numSequencesForFrame;
+    m_frameOffsets.resize(numSequencesForFrame.size());
+    m_numColumns = 0;
+    for (size_t t = 0; t < numSequencesForFrame.size(); t++)
+    {
+        if (t > 0 && numSequencesForFrame[t] > numSequencesForFrame[t - 1])
+            LogicError("CPU RNN ForwardCore: Sequences must be sorted by decreasing length.");
+        m_frameOffsets[t] = m_numColumns;
+        m_numColumns += numSequencesForFrame[t];
+    }
+
+    if (inputX.GetNumRows() != m_xDim || inputX.GetNumCols() != m_numColumns)
+        InvalidArgument("CPU RNN ForwardCore: Input is [%d x %d], but [%d x %d] was expected", (int)inputX.GetNumRows(), (int)inputX.GetNumCols(), (int)m_xDim, (int)m_numColumns);
+
+    const size_t numParameters = BiasOffset(NumPseudoLayers());
+    if (numParameters != weightsW.GetNumElements())
+        InvalidArgument("RNN needs %ld parameters, but %ld were allocated", numParameters, weightsW.GetNumElements());
+
+    const size_t maxNumSequences = numSequencesForFrame.empty() ? 0 : numSequencesForFrame[0];
+    reserve.Resize(LayerOutputOffset(m_rnnAttributes.m_numLayers - 1), 1);
+    workspace.Resize(GatesDim() * maxNumSequences, 1);
+    outputY.RequireSize(m_yDim, m_numColumns);
+
+    const size_t numLayers = m_rnnAttributes.m_numLayers;
+    for (size_t layer = 0; layer < numLayers; layer++)
+    {
+        const ElemType* x = layer == 0 ? inputX.Data() : reserve.Data() + LayerOutputOffset(layer - 1);
+        ElemType* y       = layer == numLayers - 1 ? outputY.Data() : reserve.Data() + LayerOutputOffset(layer);
+        const size_t yDim = layer == numLayers - 1 ? m_yDim : NumDirections() * m_rnnAttributes.m_hiddenSize;
+        for (size_t dir = 0; dir < NumDirections(); dir++)
+            ForwardPseudoLayer(layer * NumDirections() + dir, weightsW.Data(), x, y, yDim, reserve.Data(), workspace.Data());
+    }
+    m_BackwardDataCalledYet = false;
+}
+
+template <class ElemType>
+void CPURNNExecutor<ElemType>::BackwardDataCore(
+    const CPUMatrix<ElemType>& outputY, const CPUMatrix<ElemType>& outputDY, const CPUMatrix<ElemType>& weightsW, CPUMatrix<ElemType>& dx,
+    const RnnAttributes& rnnAttributes,
+    CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    UNUSED(outputY);
+    // test that the RNN shape is correct
+    if (!(m_rnnAttributes == rnnAttributes))
+        LogicError("RNN Layout has changed during processing");
+
+    if (!m_BackwardDataCalledYet)
+    {
+        if (outputDY.GetNumRows() != m_yDim || outputDY.GetNumCols() != m_numColumns)
+            InvalidArgument("CPU RNN BackwardDataCore: Output gradient is [%d x %d], but [%d x %d] was expected", (int)outputDY.GetNumRows(), (int)outputDY.GetNumCols(), (int)m_yDim, (int)m_numColumns);
+
+        const size_t H = m_rnnAttributes.m_hiddenSize;
+        const size_t maxNumSequences = m_numSequencesForFrame.empty() ? 0 : m_numSequencesForFrame[0];
+        workspace.Resize(BackwardTempOffset() + H * max(2 * maxNumSequences, m_numColumns), 1);
+        dx.RequireSize(m_xDim, m_numColumns);
+
+        const size_t numLayers = m_rnnAttributes.m_numLayers;
+        for (size_t layer = numLayers; layer-- > 0;)
+        {
+            const ElemType* dy = layer == numLayers - 1 ? outputDY.Data() : workspace.Data() + LayerOutputGradientOffset(layer);
+            const size_t yDim  = layer == numLayers - 1 ? m_yDim : NumDirections() * H;
+            for (size_t dir = 0; dir < NumDirections(); dir++)
+                BackwardDataPseudoLayer(layer * NumDirections() + dir, weightsW.Data(), dy, yDim, reserve.Data(), workspace.Data());
+
+            // gradient of the layer input, from both directions
+            ElemType* dxLayer = layer == 0 ? dx.Data() : workspace.Data() + LayerOutputGradientOffset(layer - 1);
+            for (size_t dir = 0; dir < NumDirections(); dir++)
+            {
+                const size_t pseudoLayer = layer * NumDirections() + dir;
+                Gemm(weightsW.Data() + InputWeightsOffset(pseudoLayer), LayerInputDim(layer), GatesDim(), false,
+                     workspace.Data() + InputGradientOffset(pseudoLayer), GatesDim(), m_numColumns, false, (ElemType)(dir == 0 ? 0 : 1), dxLayer);
+            }
+        }
+    }
+    m_BackwardDataCalledYet = true;
+}
+
+template <class ElemType>
+void CPURNNExecutor<ElemType>::BackwardWeightsCore(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& outputY, CPUMatrix<ElemType>& dw,
+    const RnnAttributes& rnnAttributes,
+    CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    UNUSED(outputY);
+    // test that the RNN shape is correct
+    if (!(m_rnnAttributes == rnnAttributes))
+        LogicError("RNN Layout has changed during processing");
+    if (!m_BackwardDataCalledYet)
+        LogicError("CPU RNN BackwardWeightsCore: BackwardDataCore must be called first.");
+    if (dw.GetNumElements() != BiasOffset(NumPseudoLayers()))
+        InvalidArgument("RNN needs %ld parameters, but %ld were allocated", BiasOffset(NumPseudoLayers()), dw.GetNumElements());
+
+    // like cudnnRNNBackwardWeights(), this adds to the gradient
+    const size_t H = m_rnnAttributes.m_hiddenSize;
+    const size_t G = GatesDim();
+    for (size_t pseudoLayer = 0; pseudoLayer < NumPseudoLayers(); pseudoLayer++)
+    {
+        const size_t layer = pseudoLayer / NumDirections();
+        const bool backward = pseudoLayer % NumDirections() == 1;
+        const ElemType* x = layer == 0 ? inputX.Data() : reserve.Data() + LayerOutputOffset(layer - 1);
+        const ElemType* hidden = reserve.Data() + HiddenOffset(pseudoLayer);
+        const ElemType* dGates = workspace.Data() + InputGradientOffset(pseudoLayer);
+        const ElemType* dRecurrentGates = workspace.Data() + RecurrentGradientOffset(pseudoLayer);
+
+        Gemm(x, LayerInputDim(layer), m_numColumns, false, dGates, G, m_numColumns, true, (ElemType)1, dw.Data() + InputWeightsOffset(pseudoLayer));
+
+        // gather the hidden state that each column continues from (zero for the first frame of a sequence),
+        // to compute the recurrent weight gradient of all frames as one product
+        ElemType* hiddenPrev = workspace.Data() + BackwardTempOffset();
+        for (size_t t = 0; t < m_numSequencesForFrame.size(); t++)
+        {
+            const size_t numContinuing = NumContinuingSequences(t, backward);
+            ElemType* dst = hiddenPrev + m_frameOffsets[t] * H;
+            if (numContinuing > 0)
+                memcpy(dst, hidden + m_frameOffsets[PreviousFrame(t, backward)] * H, numContinuing * H * sizeof(ElemType));
+            memset(dst + numContinuing * H, 0, (m_numSequencesForFrame[t] - numContinuing) * H * sizeof(ElemType));
+        }
+        Gemm(hiddenPrev, H, m_numColumns, false, dRecurrentGates, G, m_numColumns, true, (ElemType)1, dw.Data() + RecurrentWeightsOffset(pseudoLayer));
+
+        ElemType* dBias = dw.Data() + BiasOffset(pseudoLayer);
+#pragma omp parallel for
+        for (long g = 0; g < (long)G; g++)
+        {
+            ElemType sumInput = 0, sumRecurrent = 0;
+            for (size_t j = 0; j < m_numColumns; j++)
+            {
+                sumInput     += dGates[j * G + g];
+                sumRecurrent += dRecurrentGates[j * G + g];
+            }
+            dBias[g]     += sumInput;
+            dBias[G + g] += sumRecurrent;
+        }
+    }
+}
+
+template class CPURNNExecutor<double>;
+template class CPURNNExecutor<float>;
+
+}}}
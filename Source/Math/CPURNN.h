@@ -0,0 +1,92 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#pragma once
+
+#include "CPUMatrix.h"
+#include "RNNCommon.h"
+#include <vector>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// CPURNNExecutor is the CPU counterpart of CuDnnRNNExecutor. It runs the same stacked LSTM, GRU or
+// plain RNN on the same packed data (time-major, sequences sorted by decreasing length) and the same
+// packed weights, so that a model trained on the GPU can be evaluated or trained on the CPU.
+//
+// The weights use the CUDNN_LINEAR_INPUT layout. With G = 4 (LSTM), 3 (GRU) or 1 (RNN) gates, and one
+// pseudo-layer per layer and direction (forward, then backward):
+//  - first the matrices of all pseudo-layers: G input matrices [hidden x input], then G recurrent
+//    matrices [hidden x hidden], each stored row-major,
+//  - then the biases of all pseudo-layers: G input biases, then G recurrent biases.
+// Gate order is (input, forget, cell, output) for LSTM and (reset, update, new) for GRU.
+//
+// Like the GPU executor, it is attached to the output CPUMatrix object, and keeps the layout of the
+// last forward pass for the backward calls. Activations needed for the backward pass are kept in the
+// reserve; the gate gradients computed by BackwardDataCore() are kept in the workspace until
+// BackwardWeightsCore().
+template <class ElemType>
+class CPURNNExecutor
+{
+public:
+    CPURNNExecutor(size_t xDim, size_t yDim, const RnnAttributes& rnnAttributes);
+
+    void ForwardCore(const CPUMatrix<ElemType>& weightsW, const CPUMatrix<ElemType>& inputX, CPUMatrix<ElemType>& outputY, const vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+    void BackwardWeightsCore(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& outputY, CPUMatrix<ElemType>& dw, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+    void BackwardDataCore(const CPUMatrix<ElemType>& outputY, const CPUMatrix<ElemType>& outputDY, const CPUMatrix<ElemType>& w, CPUMatrix<ElemType>& dx, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+
+private:
+    enum class CellType
+    {
+        lstm,
+        gru,
+        rnnTanh,
+        rnnReLU
+    };
+
+    size_t NumDirections() const { return m_rnnAttributes.m_bidirectional ? 2 : 1; }
+    size_t NumPseudoLayers() const { return m_rnnAttributes.m_numLayers * NumDirections(); }
+    size_t LayerInputDim(size_t layer) const { return layer == 0 ? m_xDim : NumDirections() * m_rnnAttributes.m_hiddenSize; }
+    size_t GatesDim() const { return m_numGates * m_rnnAttributes.m_hiddenSize; }
+
+    // offsets into the weights
+    size_t InputWeightsOffset(size_t pseudoLayer) const;
+    size_t RecurrentWeightsOffset(size_t pseudoLayer) const { return InputWeightsOffset(pseudoLayer) + LayerInputDim(pseudoLayer / NumDirections()) * GatesDim(); }
+    size_t BiasOffset(size_t pseudoLayer) const { return InputWeightsOffset(NumPseudoLayers()) + 2 * GatesDim() * pseudoLayer; }
+
+    // offsets into the reserve: per pseudo-layer the gate activations, the cell state (LSTM) or the
+    // recurrent projection of the new gate (GRU), and the hidden state; then the outputs of all but the top layer
+    size_t PseudoLayerReserveDim() const { return GatesDim() + (m_cellType == CellType::lstm || m_cellType == CellType::gru ? 2 : 1) * m_rnnAttributes.m_hiddenSize; }
+    size_t GatesOffset(size_t pseudoLayer) const { return PseudoLayerReserveDim() * m_numColumns * pseudoLayer; }
+    size_t StateOffset(size_t pseudoLayer) const { return GatesOffset(pseudoLayer) + GatesDim() * m_numColumns; }
+    size_t HiddenOffset(size_t pseudoLayer) const { return GatesOffset(pseudoLayer + 1) - m_rnnAttributes.m_hiddenSize * m_numColumns; }
+    size_t LayerOutputOffset(size_t layer) const { return GatesOffset(NumPseudoLayers()) + NumDirections() * m_rnnAttributes.m_hiddenSize * m_numColumns * layer; }
+
+    // offsets into the workspace for the backward pass: per pseudo-layer the gradient of the gates' input projection,
+    // and for GRU that of their recurrent projection; then the gradients of all but the top layer output
+    size_t InputGradientOffset(size_t pseudoLayer) const { return (m_cellType == CellType::gru ? 2 : 1) * GatesDim() * m_numColumns * pseudoLayer; }
+    size_t RecurrentGradientOffset(size_t pseudoLayer) const { return m_cellType == CellType::gru ? InputGradientOffset(pseudoLayer) + GatesDim() * m_numColumns : InputGradientOffset(pseudoLayer); }
+    size_t LayerOutputGradientOffset(size_t layer) const { return InputGradientOffset(NumPseudoLayers()) + NumDirections() * m_rnnAttributes.m_hiddenSize * m_numColumns * layer; }
+    size_t BackwardTempOffset() const { return LayerOutputGradientOffset(m_rnnAttributes.m_numLayers - 1); }
+
+    // the previous frame of a direction, and the number of sequences of frame t that continue from it
+    bool HasPreviousFrame(size_t t, bool backward) const { return backward ? t + 1 < m_numSequencesForFrame.size() : t > 0; }
+    size_t PreviousFrame(size_t t, bool backward) const { return backward ? t + 1 : t - 1; }
+    size_t NumContinuingSequences(size_t t, bool backward) const { return !HasPreviousFrame(t, backward) ? 0 : backward ? m_numSequencesForFrame[t + 1] : m_numSequencesForFrame[t]; }
+
+    void ForwardPseudoLayer(size_t pseudoLayer, const ElemType* w, const ElemType* x, ElemType* y, size_t yDim, ElemType* reserve, ElemType* workspace);
+    void BackwardDataPseudoLayer(size_t pseudoLayer, const ElemType* w, const ElemType* dy, size_t yDim, ElemType* reserve, ElemType* workspace);
+
+    size_t m_xDim, m_yDim;
+    RnnAttributes m_rnnAttributes;
+    CellType m_cellType;
+    size_t m_numGates;
+
+    // layout of the last forward pass
+    vector<size_t> m_numSequencesForFrame;
+    vector<size_t> m_frameOffsets;
+    size_t m_numColumns;
+    bool m_BackwardDataCalledYet;
+};
+
+}}}
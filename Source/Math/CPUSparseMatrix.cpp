@@ -1438,6 +1438,293 @@ void CPUSparseMatrix<ElemType>::AdaDelta(CPUMatrix<ElemType>& c, CPUMatrix<ElemT
     }
 }
 
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::FSAdagrad(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample,
+                                          ElemType momentum, ElemType adaWeight, ElemType adaMul, bool unitGainMomentum,
+                                          CPUMatrix<double>* lastUpdateSteps, double currentStep)
+{
+    size_t numColsNeeded = 2 * GetNumCols();
+    auto unitGainFactor = ElemType(unitGainMomentum ? (1.0 - momentum) : 1.0);
+
+    if (c.IsEmpty() || (c.GetNumCols() < numColsNeeded))
+    {
+        c.RequireSize(GetNumRows(), numColsNeeded);
+        c.SetValue(0.0);
+    }
+
+    if (c.GetNumRows() != GetNumRows() || c.GetNumCols() != numColsNeeded)
+        LogicError("The matrix gradients does not have expected dimensions.");
+
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    double* steps = GetLastUpdateSteps(lastUpdateSteps);
+
+    size_t n = GetNumElements();
+    size_t len = GetNumRows();
+    const ElemType* grad = Data();
+    ElemType* smoothAda = c.Data();
+    ElemType* smoothMom = c.Data() + n;
+    ElemType* val = functionValues.Data();
+
+    // the columns of the blocks are distinct, so they can be updated in parallel
+#pragma omp parallel for
+    for (long j = 0; j < (long) GetBlockSize(); j++)
+    {
+        size_t col = GetBlockIds()[j] - GetBlockIdShift();
+        size_t denseStart = col * len;
+        size_t start = j * len;
+
+        // the dense update decays both accumulators with a zero gradient in the steps the column was absent from
+        ElemType momDecay = 1, adaDecay = 1;
+        double skipped = steps ? SkipSteps(steps, col, currentStep) : 0;
+        if (skipped > 0)
+        {
+            momDecay = (ElemType) pow((double) momentum, skipped);
+            adaDecay = (ElemType) pow((double) adaWeight, skipped);
+        }
+
+        for (size_t i = 0; i < len; i++)
+        {
+            size_t denseIndex = denseStart + i;
+            ElemType g = grad[start + i];
+            smoothAda[denseIndex] *= adaDecay;
+            if (momentum > 0.0f)
+                smoothMom[denseIndex] *= momDecay;
+            ElemType adaSqr = adaWeight * smoothAda[denseIndex] + (1.0f - adaWeight) * g * g;
+            smoothAda[denseIndex] = adaSqr;
+            if (adaSqr != 0.0f)
+            {
+                ElemType w = adaMul * ((ElemType) 1.0 / sqrt(adaSqr));
+                if (w > 10.0f)
+                    w = 10.0f;
+                g *= w;
+            }
+
+            if (momentum > 0.0f)
+            {
+                g = momentum * smoothMom[denseIndex] + unitGainFactor * g;
+                smoothMom[denseIndex] = g;
+            }
+
+            val[denseIndex] -= g * learnRatePerSample;
+        }
+    }
+}
+
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::Adam(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample,
+                                     ElemType momentum, ElemType adaWeight, ElemType adaMul, ElemType epsilon, bool unitGainMomentum, bool adamax,
+                                     CPUMatrix<double>* lastUpdateSteps, double currentStep)
+{
+    size_t numColsNeeded = 2 * GetNumCols();
+    auto unitGainFactor = ElemType(unitGainMomentum ? (1.0 - momentum) : 1.0);
+
+    if (c.IsEmpty() || (c.GetNumCols() < numColsNeeded))
+    {
+        c.RequireSize(GetNumRows(), numColsNeeded);
+        c.SetValue(0.0);
+    }
+
+    if (c.GetNumRows() != GetNumRows() || c.GetNumCols() != numColsNeeded)
+        LogicError("The matrix gradients does not have expected dimensions.");
+
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    double* steps = GetLastUpdateSteps(lastUpdateSteps);
+
+    size_t n = GetNumElements();
+    size_t len = GetNumRows();
+    const ElemType* grad = Data();
+    ElemType* smoothAda = c.Data();
+    ElemType* smoothMom = c.Data() + n;
+    ElemType* val = functionValues.Data();
+
+#pragma omp parallel for
+    for (long j = 0; j < (long) GetBlockSize(); j++)
+    {
+        size_t col = GetBlockIds()[j] - GetBlockIdShift();
+        size_t denseStart = col * len;
+        size_t start = j * len;
+
+        // Apply the decay of the moments of the steps the column was absent from, as the dense update does
+        // with a zero gradient (moments of a column that was never updated are still zero).
+        ElemType momDecay = 1, adaDecay = 1;
+        double skipped = steps ? SkipSteps(steps, col, currentStep) : 0;
+        if (skipped > 0)
+        {
+            momDecay = (ElemType) pow((double) momentum, skipped);
+            adaDecay = (ElemType) pow((double) adaWeight, skipped);
+        }
+
+        for (size_t i = 0; i < len; i++)
+        {
+            size_t denseIndex = denseStart + i;
+            ElemType g = grad[start + i];
+            smoothAda[denseIndex] *= adaDecay;
+            smoothMom[denseIndex] *= momDecay;
+            ElemType ada;
+            if (!adamax)
+            {
+                ElemType adaSqr = adaWeight * smoothAda[denseIndex] + (1.0f - adaWeight) * g * g;
+                smoothAda[denseIndex] = adaSqr;
+                ada = sqrt(adaSqr);
+            }
+            else
+                ada = smoothAda[denseIndex] = std::max(adaWeight * smoothAda[denseIndex], abs(g));
+
+            ElemType w = adaMul * (ElemType)(1.0 / (ada + epsilon));
+            g = momentum * smoothMom[denseIndex] + unitGainFactor * g;
+            smoothMom[denseIndex] = g;
+            val[denseIndex] -= g * w * learnRatePerSample;
+        }
+    }
+}
+
+// Like CPUMatrix::RmsProp(), the gradient values are replaced by the scaled update. The average multiplier is taken
+// over the elements of the blocks only.
+template <class ElemType>
+ElemType CPUSparseMatrix<ElemType>::RmsProp(CPUMatrix<ElemType>& c,
+                                            ElemType RMS_GAMMA,
+                                            ElemType RMS_WGT_INC,
+                                            ElemType RMS_WGT_MAX,
+                                            ElemType RMS_WGT_DEC,
+                                            ElemType RMS_WGT_MIN,
+                                            const bool needAveMultiplier,
+                                            const bool initialized,
+                                            CPUMatrix<double>* lastUpdateSteps,
+                                            double currentStep)
+{
+    const ElemType floor = 1e-6f;
+
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    double* lastSteps = GetLastUpdateSteps(lastUpdateSteps);
+
+    size_t n = GetNumElements();
+    size_t len = GetNumRows();
+    ElemType* curr_grad = Data();
+
+    if (c.IsEmpty() || c.GetNumCols() < GetNumCols() * 3 || !initialized)
+    {
+        c.RequireSize(GetNumRows(), GetNumCols() * 3);
+        c.SetValue(0.0);
+
+        ElemType* avars = c.Data();         // accumulated variances for RMS scaling
+        ElemType* steps = c.Data() + 2 * n; // current step size
+
+        // initialize moving average of gradient-squared (zero for the columns without gradient)
+        for (size_t j = 0; j < GetBlockSize(); j++)
+        {
+            size_t denseStart = (GetBlockIds()[j] - GetBlockIdShift()) * len;
+            for (size_t i = 0; i < len; i++)
+                avars[denseStart + i] = curr_grad[j * len + i] * curr_grad[j * len + i];
+        }
+
+        // initialize starting step size
+        for (long i = 0; i < n; i++)
+            steps[i] = ElemType(0.02);
+
+        // all columns start from the initial state of the previous step, so that the absent ones get the decay of the
+        // zero gradient the dense update applies to them in this step
+        if (lastSteps)
+            std::fill(lastSteps, lastSteps + GetNumCols(), currentStep - 1);
+    }
+
+    if (c.GetNumRows() != GetNumRows() || c.GetNumCols() != GetNumCols() * 3)
+        LogicError("The matrix gradients does not have expected dimensions.");
+
+    ElemType* avars = c.Data();         // accumulated variances for RMS scaling
+    ElemType* signs = c.Data() + n;     // sign of previous gradient
+    ElemType* steps = c.Data() + 2 * n; // current step size
+
+    ElemType ONE_MINUS_GAMMA = ElemType(1.0) - RMS_GAMMA;
+    ElemType aveMultiplier = 0;
+#pragma omp parallel for reduction(+ : aveMultiplier)
+    for (long j = 0; j < (long) GetBlockSize(); j++)
+    {
+        size_t col = GetBlockIds()[j] - GetBlockIdShift();
+        size_t denseStart = col * len;
+        size_t start = j * len;
+
+        // With a zero gradient, the dense update decays the variances, shrinks the step sizes (down to RMS_WGT_MIN),
+        // and clears the signs in the steps the column was absent from. Unlike in SkipSteps(), a last step of 0 is the
+        // step before the first one here, since the initialization above sets the last steps of all columns.
+        double skipped = 0;
+        if (lastSteps)
+        {
+            skipped = currentStep - lastSteps[col] - 1;
+            lastSteps[col] = currentStep;
+        }
+        if (skipped > 0)
+        {
+            ElemType avarsDecay = (ElemType) pow((double) RMS_GAMMA, skipped);
+            ElemType stepsDecay = (ElemType) pow((double) RMS_WGT_DEC, skipped);
+            for (size_t i = 0; i < len; i++)
+            {
+                avars[denseStart + i] *= avarsDecay;
+                steps[denseStart + i] = std::max(steps[denseStart + i] * stepsDecay, RMS_WGT_MIN);
+                signs[denseStart + i] = 0;
+            }
+        }
+
+        for (size_t i = 0; i < len; i++)
+        {
+            size_t denseIndex = denseStart + i;
+            ElemType g = curr_grad[start + i];
+            avars[denseIndex] = RMS_GAMMA * avars[denseIndex] + ONE_MINUS_GAMMA * (g * g);
+            const int grad_sign = (ElemType(0) < g) - (g < ElemType(0));
+
+            if (signs[denseIndex] * grad_sign > 0)
+                steps[denseIndex] = std::min(steps[denseIndex] * RMS_WGT_INC, RMS_WGT_MAX);
+            else
+                steps[denseIndex] = std::max(steps[denseIndex] * RMS_WGT_DEC, RMS_WGT_MIN);
+
+            ElemType a = steps[denseIndex] / sqrt(avars[denseIndex] + floor);
+            curr_grad[start + i] *= a;
+            signs[denseIndex] = (ElemType) grad_sign;
+
+            if (needAveMultiplier)
+                aveMultiplier += a;
+        }
+    }
+
+    size_t nz = GetBlockSize() * len;
+    if (needAveMultiplier && nz > 0)
+        return aveMultiplier / nz;
+    else
+        return 1;
+}
+
+template <class ElemType>
+double* CPUSparseMatrix<ElemType>::GetLastUpdateSteps(CPUMatrix<double>* lastUpdateSteps) const
+{
+    if (!lastUpdateSteps)
+        return nullptr;
+
+    if (lastUpdateSteps->IsEmpty())
+    {
+        lastUpdateSteps->RequireSize(1, GetNumCols());
+        lastUpdateSteps->SetValue(0.0);
+    }
+
+    if (lastUpdateSteps->GetNumRows() != 1 || lastUpdateSteps->GetNumCols() != GetNumCols())
+        LogicError("The matrix of last update steps does not have expected dimensions.");
+
+    return lastUpdateSteps->Data();
+}
+
+template <class ElemType>
+/*static*/ double CPUSparseMatrix<ElemType>::SkipSteps(double* steps, size_t col, double currentStep)
+{
+    // the state of a column that was never updated is still the initial one
+    double skipped = steps[col] > 0 ? currentStep - steps[col] - 1 : 0;
+    steps[col] = currentStep;
+    return skipped;
+}
+
 template <class ElemType>
 CPUSparseMatrix<ElemType>& CPUSparseMatrix<ElemType>::InplaceTruncateTop(const ElemType threshold)
 {
@@ -233,6 +233,31 @@ public:
     ElemType Adagrad(CPUMatrix<ElemType>& c, const bool needAveMultiplier);
     void AdaDelta(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learningRate, ElemType rho, ElemType epsilon);
 
+    // Lazy updates for block sparse gradients: only the columns present in the gradient are updated, i.e. the
+    // smoothed state and the model of the other columns are left as they are, instead of decaying them with a zero gradient.
+    // The smoothed state 'c' has the same layout as for the dense CPUMatrix versions.
+    //
+    // The bias corrections 'adaMul' of Adam and FSAdaGrad come from the global step count, as in the dense versions. That is
+    // only right if the state of a column is as decayed as in the dense update, so, given 'lastUpdateSteps' (1 x number of columns, zero-initialized when empty), the decay of the steps a column was absent from
+    // since its last update is applied, with the current decay rates, when it is next present, and 'currentStep' is recorded
+    // for it. The smoothed state then matches the dense update; only the model moves less, since the dense update also
+    // applies the momentum in the steps a column is absent from. Without 'lastUpdateSteps', the state of absent columns
+    // is not decayed at all.
+    void FSAdagrad(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample, ElemType momentum, ElemType adaWeight, ElemType adaMul, bool unitGainMomentum,
+                   CPUMatrix<double>* lastUpdateSteps, double currentStep);
+    void Adam(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample, ElemType momentum, ElemType adaWeight, ElemType adaMul, ElemType epsilon, bool unitGainMomentum, bool adamax,
+              CPUMatrix<double>* lastUpdateSteps, double currentStep);
+    // RmsProp has no bias correction, but its step sizes shrink in the steps a column is absent from, which is applied as above.
+    ElemType RmsProp(CPUMatrix<ElemType>& c, ElemType RMS_GAMMA, ElemType RMS_WGT_INC, ElemType RMS_WGT_MAX, ElemType RMS_WGT_DEC, ElemType RMS_WGT_MIN, const bool needAveMultiplier, const bool initialized,
+                     CPUMatrix<double>* lastUpdateSteps, double currentStep);
+
+private:
+    // Validates 'lastUpdateSteps' of the lazy updates above and allocates it when empty; returns nullptr if not given.
+    double* GetLastUpdateSteps(CPUMatrix<double>* lastUpdateSteps) const;
+
+    // Number of steps the given column was absent from since its last update, and records 'currentStep' as its last update.
+    static double SkipSteps(double* steps, size_t col, double currentStep);
+
 public:
     CPUSparseMatrix<ElemType>& InplaceTruncateTop(const ElemType threshold);
     CPUSparseMatrix<ElemType>& InplaceTruncateBottom(const ElemType threshold);
@@ -0,0 +1,158 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUVectorizedTensorOps.cpp : runtime selection of the explicitly vectorized TensorOp kernels
+//
+// This file is compiled for the baseline instruction set. It must not use AVX2/AVX-512 itself.
+//
+
+#include "stdafx.h"
+#include "CPUVectorizedTensorOps.h"
+#include <atomic>
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+static CPUInstructionSet DetectInstructionSet()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    if (maxLeaf < 7)
+        return CPUInstructionSet::Scalar;
+    __cpuid(info, 1);
+    bool hasFMA     = (info[2] & (1 << 12)) != 0;
+    bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+    bool hasAVX     = (info[2] & (1 << 28)) != 0;
+    if (!hasFMA || !hasOSXSAVE || !hasAVX)
+        return CPUInstructionSet::Scalar;
+    // the OS must save the YMM (bits 1, 2) and for AVX-512 also the opmask and ZMM (bits 5, 6, 7) registers
+    unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6)
+        return CPUInstructionSet::Scalar;
+    __cpuidex(info, 7, 0);
+    bool hasAVX2    = (info[1] & (1 << 5)) != 0;
+    bool hasAVX512F = (info[1] & (1 << 16)) != 0;
+    if (hasAVX512F && (xcr0 & 0xe6) == 0xe6)
+        return CPUInstructionSet::AVX512;
+    return hasAVX2 ? CPUInstructionSet::AVX2 : CPUInstructionSet::Scalar;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    // __builtin_cpu_supports() also checks that the OS has enabled the register state
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return CPUInstructionSet::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return CPUInstructionSet::AVX2;
+    return CPUInstructionSet::Scalar;
+#else
+    return CPUInstructionSet::Scalar;
+#endif
+}
+
+static std::atomic<int> s_instructionSet(-1); // -1 = not yet determined
+
+/*static*/ CPUInstructionSet CPUVectorizedTensorOps::GetSupportedInstructionSet()
+{
+    static const CPUInstructionSet supportedInstructionSet = DetectInstructionSet();
+    return supportedInstructionSet;
+}
+
+/*static*/ CPUInstructionSet CPUVectorizedTensorOps::GetInstructionSet()
+{
+    int instructionSet = s_instructionSet;
+    if (instructionSet < 0)
+    {
+        instructionSet = (int) GetSupportedInstructionSet();
+        s_instructionSet = instructionSet;
+    }
+    return (CPUInstructionSet) instructionSet;
+}
+
+/*static*/ CPUInstructionSet CPUVectorizedTensorOps::SetInstructionSet(CPUInstructionSet instructionSet)
+{
+    if ((int) instructionSet > (int) GetSupportedInstructionSet())
+        instructionSet = GetSupportedInstructionSet();
+    s_instructionSet = (int) instructionSet;
+    return instructionSet;
+}
+
+static std::atomic<bool> s_approximateTranscendentals(false);
+
+/*static*/ void CPUVectorizedTensorOps::SetApproximateTranscendentals(bool enable)
+{
+    s_approximateTranscendentals = enable;
+}
+
+/*static*/ bool CPUVectorizedTensorOps::ShouldApproximateTranscendentals()
+{
+    return s_approximateTranscendentals;
+}
+
+// must match the ops marked 'approximate' in CPUVectorizedTensorOpsImpl.h
+/*static*/ bool CPUVectorizedTensorOps::IsApproximate(ElementWiseOperator op)
+{
+    switch (op)
+    {
+    case ElementWiseOperator::opExp:
+    case ElementWiseOperator::opLog:
+    case ElementWiseOperator::opTanh:
+    case ElementWiseOperator::opSigmoid:
+    case ElementWiseOperator::opStableSigmoid:
+    case ElementWiseOperator::opExponentialLinearUnit:
+    case ElementWiseOperator::opElementwiseProductWithLogDerivativeFromOutput:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*static*/ VectorizedUnaryTensorOpKernel CPUVectorizedTensorOps::GetUnaryKernel(ElementWiseOperator op)
+{
+    if (IsApproximate(op) && !ShouldApproximateTranscendentals())
+        return nullptr;
+    return GetUnaryKernel(op, GetInstructionSet());
+}
+
+/*static*/ VectorizedBinaryTensorOpKernel CPUVectorizedTensorOps::GetBinaryKernel(ElementWiseOperator op)
+{
+    if (IsApproximate(op) && !ShouldApproximateTranscendentals())
+        return nullptr;
+    return GetBinaryKernel(op, GetInstructionSet());
+}
+
+/*static*/ VectorizedUnaryTensorOpKernel CPUVectorizedTensorOps::GetUnaryKernel(ElementWiseOperator op, CPUInstructionSet instructionSet)
+{
+    if ((int) instructionSet > (int) GetSupportedInstructionSet())
+        return nullptr;
+    switch (instructionSet)
+    {
+    case CPUInstructionSet::AVX512:
+        return GetUnaryKernelAVX512(op);
+    case CPUInstructionSet::AVX2:
+        return GetUnaryKernelAVX2(op);
+    default:
+        return nullptr;
+    }
+}
+
+/*static*/ VectorizedBinaryTensorOpKernel CPUVectorizedTensorOps::GetBinaryKernel(ElementWiseOperator op, CPUInstructionSet instructionSet)
+{
+    if ((int) instructionSet > (int) GetSupportedInstructionSet())
+        return nullptr;
+    switch (instructionSet)
+    {
+    case CPUInstructionSet::AVX512:
+        return GetBinaryKernelAVX512(op);
+    case CPUInstructionSet::AVX2:
+        return GetBinaryKernelAVX2(op);
+    default:
+        return nullptr;
+    }
+}
+
+}}}
@@ -0,0 +1,71 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Explicitly vectorized (AVX2/AVX-512) innermost loops for CPU TensorOps.
+//
+// The generic TensorOp code in CPUMatrixImpl.h relies on the compiler to auto-vectorize the per-element lambdas,
+// which it does not do for transcendentals (exp(), log(), tanh(), ...). The kernels declared here process whole
+// contiguous rows with SIMD instructions. Kernels for the transcendentals use polynomial approximations. Their results
+// differ from the generic code by up to 1e-6 relative to max(1, |result|), so they are only used if explicitly enabled
+// (SetApproximateTranscendentals(), BrainScript 'cpuApproximateTranscendentals'); by default those ops take the generic code.
+//
+// The instruction set is selected at runtime via CPUID. Only the translation units that contain the kernels
+// (CPUVectorizedTensorOpsAVX2.cpp, CPUVectorizedTensorOpsAVX512.cpp) are compiled for the wider instruction sets,
+// so the binary still runs on CPUs without them.
+//
+
+#pragma once
+
+#include "CommonMatrix.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// c[i] = beta * c[i] + alpha * op(a[i]) for i in [0, n). 'c' is not read if beta == 0, and may be the same as 'a'.
+typedef void (*VectorizedUnaryTensorOpKernel)(size_t n, const float* a, float* c, float alpha, float beta);
+// c[i] = beta * c[i] + alpha * op(a[i], b[i]) for i in [0, n)
+typedef void (*VectorizedBinaryTensorOpKernel)(size_t n, const float* a, const float* b, float* c, float alpha, float beta);
+
+enum class CPUInstructionSet
+{
+    Scalar, // no explicitly vectorized kernels; the generic TensorOp code is used
+    AVX2,   // AVX2 + FMA, 8 floats per vector
+    AVX512  // AVX-512F, 16 floats per vector
+};
+
+class MATH_API CPUVectorizedTensorOps
+{
+public:
+    // the instruction set used for the kernels (initially the best one this CPU supports)
+    static CPUInstructionSet GetInstructionSet();
+    // restrict the kernels to the given instruction set; requests beyond what the CPU supports are clamped
+    // Use CPUInstructionSet::Scalar to get results that are identical across machines (e.g. CPUMatrix::SetCompatibleMode()).
+    static CPUInstructionSet SetInstructionSet(CPUInstructionSet instructionSet);
+    // the best instruction set supported by this CPU and OS, determined once with CPUID
+    static CPUInstructionSet GetSupportedInstructionSet();
+
+    // allow the kernels of ops that approximate transcendentals (see IsApproximate()); off by default
+    static void SetApproximateTranscendentals(bool enable);
+    static bool ShouldApproximateTranscendentals();
+    // true for the ops whose kernels approximate transcendentals (exp, log, tanh, sigmoid, ...)
+    static bool IsApproximate(ElementWiseOperator op);
+
+    // Get the kernel for 'op' for the current instruction set, or nullptr if 'op' is not vectorized or is approximate
+    // and approximations are not enabled.
+    // Arithmetic ops (copy, sum, product, max, relu, ...) produce results identical to the generic code.
+    static VectorizedUnaryTensorOpKernel GetUnaryKernel(ElementWiseOperator op);
+    static VectorizedBinaryTensorOpKernel GetBinaryKernel(ElementWiseOperator op);
+
+    // same as above for an explicit instruction set, regardless of SetApproximateTranscendentals() (for testing)
+    static VectorizedUnaryTensorOpKernel GetUnaryKernel(ElementWiseOperator op, CPUInstructionSet instructionSet);
+    static VectorizedBinaryTensorOpKernel GetBinaryKernel(ElementWiseOperator op, CPUInstructionSet instructionSet);
+
+private:
+    // implemented in the per-instruction-set translation units
+    static VectorizedUnaryTensorOpKernel GetUnaryKernelAVX2(ElementWiseOperator op);
+    static VectorizedBinaryTensorOpKernel GetBinaryKernelAVX2(ElementWiseOperator op);
+    static VectorizedUnaryTensorOpKernel GetUnaryKernelAVX512(ElementWiseOperator op);
+    static VectorizedBinaryTensorOpKernel GetBinaryKernelAVX512(ElementWiseOperator op);
+};
+
+}}}
@@ -0,0 +1,76 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUVectorizedTensorOpsAVX2.cpp : AVX2 + FMA kernels for CPUVectorizedTensorOps.h
+//
+// This file is compiled with AVX2 and FMA enabled (-mavx2 -mfma -ffp-contract=off, see Makefile), and its code is only
+// called after CPUID has confirmed support. Do not include stdafx.h or call inline functions from other headers here,
+// since the linker could pick this file's AVX2 copy of them for the rest of the library.
+//
+
+#include "CPUVectorizedTensorOpsImpl.h"
+#include <immintrin.h>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+namespace {
+
+struct AVX2
+{
+    typedef __m256 Vec;
+    typedef __m256 Mask;
+    static const size_t Width = 8;
+
+    static inline Vec Load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void Store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    static inline Vec Set1(float x) { return _mm256_set1_ps(x); }
+
+    static inline Vec Add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static inline Vec Sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    static inline Vec Mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    static inline Vec Div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+    static inline Vec Min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    static inline Vec Max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    static inline Vec Sqrt(Vec a) { return _mm256_sqrt_ps(a); }
+    static inline Vec Floor(Vec a) { return _mm256_floor_ps(a); }
+    static inline Vec Neg(Vec a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static inline Vec Abs(Vec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static inline Vec FMA(Vec a, Vec b, Vec c) { return _mm256_fmadd_ps(a, b, c); }
+
+    static inline Mask Greater(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static inline Mask GreaterEqual(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static inline Mask Less(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static inline Mask LessEqual(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static inline Mask Equal(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static inline Mask NotEqual(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+    static inline Mask IsNaN(Vec a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+    static inline Vec Select(Mask m, Vec ifTrue, Vec ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, m); }
+
+    static inline Vec Pow2n(Vec n)
+    {
+        __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+    }
+    static inline Vec Frexp(Vec x, Vec& e)
+    {
+        __m256i xi = _mm256_castps_si256(x);
+        e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(xi, 23), _mm256_set1_epi32(126)));
+        __m256i mi = _mm256_or_si256(_mm256_and_si256(xi, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f000000));
+        return _mm256_castsi256_ps(mi);
+    }
+};
+
+} // anonymous namespace
+
+/*static*/ VectorizedUnaryTensorOpKernel CPUVectorizedTensorOps::GetUnaryKernelAVX2(ElementWiseOperator op)
+{
+    return GetVectorizedUnaryKernel<AVX2>(op);
+}
+
+/*static*/ VectorizedBinaryTensorOpKernel CPUVectorizedTensorOps::GetBinaryKernelAVX2(ElementWiseOperator op)
+{
+    return GetVectorizedBinaryKernel<AVX2>(op);
+}
+
+}}}
@@ -0,0 +1,77 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUVectorizedTensorOpsAVX512.cpp : AVX-512F kernels for CPUVectorizedTensorOps.h
+//
+// This file is compiled with AVX-512F enabled (-mavx512f -ffp-contract=off, see Makefile), and its code is only
+// called after CPUID has confirmed support. Do not include stdafx.h or call inline functions from other headers here,
+// since the linker could pick this file's AVX-512 copy of them for the rest of the library.
+//
+
+#include "CPUVectorizedTensorOpsImpl.h"
+#include <immintrin.h>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+namespace {
+
+// Note: Only AVX-512F instructions are used (no AVX-512DQ), hence the float bit operations go through integer vectors.
+struct AVX512
+{
+    typedef __m512 Vec;
+    typedef __mmask16 Mask;
+    static const size_t Width = 16;
+
+    static inline Vec Load(const float* p) { return _mm512_loadu_ps(p); }
+    static inline void Store(float* p, Vec v) { _mm512_storeu_ps(p, v); }
+    static inline Vec Set1(float x) { return _mm512_set1_ps(x); }
+
+    static inline Vec Add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+    static inline Vec Sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+    static inline Vec Mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+    static inline Vec Div(Vec a, Vec b) { return _mm512_div_ps(a, b); }
+    static inline Vec Min(Vec a, Vec b) { return _mm512_min_ps(a, b); }
+    static inline Vec Max(Vec a, Vec b) { return _mm512_max_ps(a, b); }
+    static inline Vec Sqrt(Vec a) { return _mm512_sqrt_ps(a); }
+    static inline Vec Floor(Vec a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static inline Vec Neg(Vec a) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_set1_epi32(0x80000000))); }
+    static inline Vec Abs(Vec a) { return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(0x7fffffff))); }
+    static inline Vec FMA(Vec a, Vec b, Vec c) { return _mm512_fmadd_ps(a, b, c); }
+
+    static inline Mask Greater(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static inline Mask GreaterEqual(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static inline Mask Less(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static inline Mask LessEqual(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static inline Mask Equal(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static inline Mask NotEqual(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+    static inline Mask IsNaN(Vec a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+    static inline Vec Select(Mask m, Vec ifTrue, Vec ifFalse) { return _mm512_mask_blend_ps(m, ifFalse, ifTrue); }
+
+    static inline Vec Pow2n(Vec n)
+    {
+        __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+    }
+    static inline Vec Frexp(Vec x, Vec& e)
+    {
+        __m512i xi = _mm512_castps_si512(x);
+        e = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(xi, 23), _mm512_set1_epi32(126)));
+        __m512i mi = _mm512_or_si512(_mm512_and_si512(xi, _mm512_set1_epi32(0x007fffff)), _mm512_set1_epi32(0x3f000000));
+        return _mm512_castsi512_ps(mi);
+    }
+};
+
+} // anonymous namespace
+
+/*static*/ VectorizedUnaryTensorOpKernel CPUVectorizedTensorOps::GetUnaryKernelAVX512(ElementWiseOperator op)
+{
+    return GetVectorizedUnaryKernel<AVX512>(op);
+}
+
+/*static*/ VectorizedBinaryTensorOpKernel CPUVectorizedTensorOps::GetBinaryKernelAVX512(ElementWiseOperator op)
+{
+    return GetVectorizedBinaryKernel<AVX512>(op);
+}
+
+}}}
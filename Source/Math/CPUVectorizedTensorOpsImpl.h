@@ -0,0 +1,329 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Kernels for CPUVectorizedTensorOps.h, templated on the instruction set.
+//
+// Include this only from a translation unit that is compiled for the instruction set it instantiates the kernels with.
+// That translation unit defines the instruction-set traits struct 'ISA' in an anonymous namespace, so that none of
+// the instantiated code can be shared with (and picked by the linker for) code compiled for the baseline. It provides:
+//  - types Vec (a vector of floats) and Mask (result of a comparison), and the number of floats per vector Width
+//  - Load/Store (unaligned), Set1
+//  - Add, Sub, Mul, Div, Sqrt, Floor, Neg, Abs, FMA (a * b + c)
+//  - comparisons Greater, GreaterEqual, Less, LessEqual, Equal (ordered), NotEqual (unordered), IsNaN, and Select
+//  - Pow2n(n) = 2^n for integer-valued n in [-126, 127]
+//  - Frexp(x, e): split a normalized positive x into mantissa in [0.5, 1) and exponent e, like frexp()
+//
+// Note: The arithmetic ops here mirror the expressions in TensorOps.h operation by operation, so that results are
+// identical to the generic code. Translation units including this must be compiled without floating-point contraction,
+// since fusing the a * alpha + beta * c epilogue into an FMA would change the rounding.
+//
+
+#pragma once
+
+#include "CPUVectorizedTensorOps.h"
+#include <string.h>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+namespace {
+
+// -----------------------------------------------------------------------
+// transcendentals
+//
+// These are the Cephes single-precision approximations, which are accurate to about 1 ulp within their reduced ranges.
+// -----------------------------------------------------------------------
+
+// exp(x) for all floats, including overflow to inf and gradual underflow to 0
+template <class ISA>
+static inline typename ISA::Vec ExpV(typename ISA::Vec x)
+{
+    typedef typename ISA::Vec Vec;
+    // clamp so that the scale 2^n below stays within 2 x (2^-75...2^65); the clamped range still covers overflow and underflow
+    Vec xc = ISA::Min(ISA::Max(x, ISA::Set1(-104.0f)), ISA::Set1(89.0f));
+    // range reduction: x = n * log(2) + r, |r| <= log(2)/2; log(2) is split into two parts for extra precision
+    Vec n = ISA::Floor(ISA::FMA(xc, ISA::Set1(1.44269504088896341f), ISA::Set1(0.5f)));
+    Vec r = ISA::FMA(n, ISA::Set1(-0.693359375f), xc);
+    r = ISA::FMA(n, ISA::Set1(2.12194440e-4f), r);
+    // exp(r) = 1 + r + r^2 * P(r)
+    Vec p = ISA::Set1(1.9875691500E-4f);
+    p = ISA::FMA(p, r, ISA::Set1(1.3981999507E-3f));
+    p = ISA::FMA(p, r, ISA::Set1(8.3334519073E-3f));
+    p = ISA::FMA(p, r, ISA::Set1(4.1665795894E-2f));
+    p = ISA::FMA(p, r, ISA::Set1(1.6666665459E-1f));
+    p = ISA::FMA(p, r, ISA::Set1(5.0000001201E-1f));
+    Vec y = ISA::Add(ISA::FMA(p, ISA::Mul(r, r), r), ISA::Set1(1.0f));
+    // scale by 2^n in two steps, so that results near overflow and in the denormal range come out right
+    Vec n1 = ISA::Floor(ISA::Mul(n, ISA::Set1(0.5f)));
+    Vec n2 = ISA::Sub(n, n1);
+    y = ISA::Mul(ISA::Mul(y, ISA::Pow2n(n1)), ISA::Pow2n(n2));
+    return ISA::Select(ISA::IsNaN(x), x, y);
+}
+
+// log(x) for normalized positive x, +inf, and NaN
+template <class ISA>
+static inline typename ISA::Vec LogV(typename ISA::Vec x)
+{
+    typedef typename ISA::Vec Vec;
+    Vec e;
+    Vec m = ISA::Frexp(x, e);
+    // move the mantissa into [sqrt(1/2), sqrt(2)), and subtract 1
+    auto isSmall = ISA::Less(m, ISA::Set1(0.707106781186547524f));
+    e = ISA::Sub(e, ISA::Select(isSmall, ISA::Set1(1.0f), ISA::Set1(0.0f)));
+    Vec r = ISA::Sub(ISA::Add(m, ISA::Select(isSmall, m, ISA::Set1(0.0f))), ISA::Set1(1.0f));
+    // log(1 + r) = r - r^2/2 + r^3 * P(r)
+    Vec z = ISA::Mul(r, r);
+    Vec p = ISA::Set1(7.0376836292E-2f);
+    p = ISA::FMA(p, r, ISA::Set1(-1.1514610310E-1f));
+    p = ISA::FMA(p, r, ISA::Set1(1.1676998740E-1f));
+    p = ISA::FMA(p, r, ISA::Set1(-1.2420140846E-1f));
+    p = ISA::FMA(p, r, ISA::Set1(1.4249322787E-1f));
+    p = ISA::FMA(p, r, ISA::Set1(-1.6668057665E-1f));
+    p = ISA::FMA(p, r, ISA::Set1(2.0000714765E-1f));
+    p = ISA::FMA(p, r, ISA::Set1(-2.4999993993E-1f));
+    p = ISA::FMA(p, r, ISA::Set1(3.3333331174E-1f));
+    Vec y = ISA::Mul(ISA::Mul(p, r), z);
+    y = ISA::FMA(e, ISA::Set1(-2.12194440e-4f), y);
+    y = ISA::FMA(z, ISA::Set1(-0.5f), y);
+    y = ISA::Add(r, y);
+    y = ISA::FMA(e, ISA::Set1(0.693359375f), y);
+    y = ISA::Select(ISA::Equal(x, ISA::Set1(INFINITY)), x, y);
+    return ISA::Select(ISA::IsNaN(x), x, y);
+}
+
+// tanh(x): odd polynomial for small |x|, 1 - 2 / (exp(2|x|) + 1) otherwise
+template <class ISA>
+static inline typename ISA::Vec TanhV(typename ISA::Vec x)
+{
+    typedef typename ISA::Vec Vec;
+    Vec z = ISA::Mul(x, x);
+    Vec p = ISA::Set1(-5.70498872745E-3f);
+    p = ISA::FMA(p, z, ISA::Set1(2.06390887954E-2f));
+    p = ISA::FMA(p, z, ISA::Set1(-5.37397155531E-2f));
+    p = ISA::FMA(p, z, ISA::Set1(1.33314422036E-1f));
+    p = ISA::FMA(p, z, ISA::Set1(-3.33332819422E-1f));
+    Vec ySmall = ISA::FMA(ISA::Mul(p, z), x, x);
+    Vec ax = ISA::Abs(x);
+    Vec yLarge = ISA::Sub(ISA::Set1(1.0f), ISA::Div(ISA::Set1(2.0f), ISA::Add(ExpV<ISA>(ISA::Add(ax, ax)), ISA::Set1(1.0f))));
+    yLarge = ISA::Select(ISA::Less(x, ISA::Set1(0.0f)), ISA::Neg(yLarge), yLarge);
+    return ISA::Select(ISA::Less(ax, ISA::Set1(0.625f)), ySmall, yLarge);
+}
+
+// -----------------------------------------------------------------------
+// vectorized ElementWiseOperators
+//
+// One struct per op, mirroring DefUnaryOp/DefBinaryOp in TensorOps.h.
+// -----------------------------------------------------------------------
+
+#pragma push_macro("DefVectorizedUnaryOp")
+#define DefVectorizedUnaryOp(op, expr)                                  \
+    struct VectorizedOp##op                                             \
+    {                                                                   \
+        template <class ISA>                                            \
+        static inline typename ISA::Vec Apply(typename ISA::Vec a)      \
+        {                                                               \
+            typedef typename ISA::Vec Vec;                              \
+            const Vec zero = ISA::Set1(0.0f), one = ISA::Set1(1.0f);    \
+            UNUSED(zero); UNUSED(one);                                  \
+            return expr;                                                \
+        }                                                               \
+    }
+
+// exact
+DefVectorizedUnaryOp(Copy, a);
+DefVectorizedUnaryOp(Negate, ISA::Neg(a));
+DefVectorizedUnaryOp(Abs, ISA::Abs(a));
+DefVectorizedUnaryOp(Floor, ISA::Floor(a));
+DefVectorizedUnaryOp(Sqr, ISA::Mul(a, a));
+DefVectorizedUnaryOp(Sqrt, ISA::Sqrt(ISA::Select(ISA::Greater(a, zero), a, zero)));
+DefVectorizedUnaryOp(Reciprocal, ISA::Select(ISA::Equal(a, zero), zero, ISA::Div(one, a)));
+DefVectorizedUnaryOp(LinearRectifier, ISA::Select(ISA::Greater(a, zero), a, zero));
+// approximate (see CPUVectorizedTensorOps::IsApproximate())
+DefVectorizedUnaryOp(Exp, ExpV<ISA>(a));
+DefVectorizedUnaryOp(Log, ISA::Select(ISA::Less(a, ISA::Set1(EPS_IN_LOG)), ISA::Set1(LOG_OF_EPS_IN_LOG), LogV<ISA>(a)));
+DefVectorizedUnaryOp(Tanh, TanhV<ISA>(a));
+DefVectorizedUnaryOp(Sigmoid, ISA::Div(one, ISA::Add(ExpV<ISA>(ISA::Neg(a)), one)));
+DefVectorizedUnaryOp(StableSigmoid, ([&] { Vec q = ExpV<ISA>(ISA::Neg(ISA::Abs(a))); return ISA::Div(ISA::Select(ISA::Greater(a, zero), one, q), ISA::Add(one, q)); })());
+DefVectorizedUnaryOp(ExponentialLinearUnit, ISA::Select(ISA::GreaterEqual(a, zero), a, ISA::Sub(ExpV<ISA>(a), one)));
+
+#pragma pop_macro("DefVectorizedUnaryOp")
+
+#define ForAllVectorizedUnaryOps(Macro) \
+    Macro(Copy);                        \
+    Macro(Negate);                      \
+    Macro(Abs);                         \
+    Macro(Floor);                       \
+    Macro(Sqr);                         \
+    Macro(Sqrt);                        \
+    Macro(Reciprocal);                  \
+    Macro(LinearRectifier);             \
+    Macro(Exp);                         \
+    Macro(Log);                         \
+    Macro(Tanh);                        \
+    Macro(Sigmoid);                     \
+    Macro(StableSigmoid);               \
+    Macro(ExponentialLinearUnit);
+
+#pragma push_macro("DefVectorizedBinaryOp")
+#define DefVectorizedBinaryOp(op, expr)                                                  \
+    struct VectorizedOp##op                                                              \
+    {                                                                                    \
+        template <class ISA>                                                             \
+        static inline typename ISA::Vec Apply(typename ISA::Vec a, typename ISA::Vec b) \
+        {                                                                                \
+            typedef typename ISA::Vec Vec;                                               \
+            const Vec zero = ISA::Set1(0.0f), one = ISA::Set1(1.0f);                     \
+            UNUSED(zero); UNUSED(one);                                                   \
+            return expr;                                                                 \
+        }                                                                                \
+    }
+
+// exact
+DefVectorizedBinaryOp(CopyIf, ISA::Select(ISA::NotEqual(a, zero), b, zero));
+DefVectorizedBinaryOp(CopyIfNot, ISA::Select(ISA::Equal(a, zero), b, zero));
+DefVectorizedBinaryOp(Sum, ISA::Add(a, b));
+DefVectorizedBinaryOp(Difference, ISA::Sub(a, b));
+DefVectorizedBinaryOp(ElementwiseProduct, ISA::Mul(a, b));
+DefVectorizedBinaryOp(Max, ISA::Select(ISA::Greater(a, b), a, b));
+DefVectorizedBinaryOp(Min, ISA::Select(ISA::Less(a, b), a, b));
+DefVectorizedBinaryOp(Equal, ISA::Select(ISA::Equal(a, b), one, zero));
+DefVectorizedBinaryOp(NotEqual, ISA::Select(ISA::NotEqual(a, b), one, zero));
+DefVectorizedBinaryOp(Greater, ISA::Select(ISA::Greater(a, b), one, zero));
+DefVectorizedBinaryOp(Less, ISA::Select(ISA::Less(a, b), one, zero));
+DefVectorizedBinaryOp(GreaterEqual, ISA::Select(ISA::GreaterEqual(a, b), one, zero));
+DefVectorizedBinaryOp(LessEqual, ISA::Select(ISA::LessEqual(a, b), one, zero));
+DefVectorizedBinaryOp(MaskNegative, ISA::Select(ISA::GreaterEqual(b, zero), a, zero));
+DefVectorizedBinaryOp(ElementwiseProductWithSigmoidDerivativeFromOutput, ISA::Mul(a, ISA::Mul(b, ISA::Sub(one, b))));
+DefVectorizedBinaryOp(ElementwiseProductWithTanhDerivativeFromOutput, ISA::Mul(a, ISA::Sub(one, ISA::Mul(b, b))));
+DefVectorizedBinaryOp(ElementwiseProductWithLinearRectifierDerivativeFromOutput, ISA::Select(ISA::Greater(b, zero), a, zero));
+DefVectorizedBinaryOp(SqrOfDifference, ISA::Mul(ISA::Sub(a, b), ISA::Sub(a, b)));
+DefVectorizedBinaryOp(ElementwiseProductWithExponentialLinearUnitDerivativeFromOutput, ISA::Select(ISA::GreaterEqual(b, zero), a, ISA::Mul(a, ISA::Add(one, b))));
+// approximate (see CPUVectorizedTensorOps::IsApproximate())
+DefVectorizedBinaryOp(ElementwiseProductWithLogDerivativeFromOutput, ISA::Mul(a, ExpV<ISA>(ISA::Neg(b))));
+
+#pragma pop_macro("DefVectorizedBinaryOp")
+
+#define ForAllVectorizedBinaryOps(Macro)                                     \
+    Macro(CopyIf);                                                           \
+    Macro(CopyIfNot);                                                        \
+    Macro(Sum);                                                              \
+    Macro(Difference);                                                       \
+    Macro(ElementwiseProduct);                                               \
+    Macro(Max);                                                              \
+    Macro(Min);                                                              \
+    Macro(Equal);                                                            \
+    Macro(NotEqual);                                                         \
+    Macro(Greater);                                                          \
+    Macro(Less);                                                             \
+    Macro(GreaterEqual);                                                     \
+    Macro(LessEqual);                                                        \
+    Macro(MaskNegative);                                                     \
+    Macro(ElementwiseProductWithSigmoidDerivativeFromOutput);                \
+    Macro(ElementwiseProductWithTanhDerivativeFromOutput);                   \
+    Macro(ElementwiseProductWithLinearRectifierDerivativeFromOutput);        \
+    Macro(SqrOfDifference);                                                  \
+    Macro(ElementwiseProductWithExponentialLinearUnitDerivativeFromOutput);  \
+    Macro(ElementwiseProductWithLogDerivativeFromOutput);
+
+// -----------------------------------------------------------------------
+// kernels: loop over a contiguous row
+//
+// The epilogue is the same as in TensorOpIteration<..., -1>: val = op(...) * alpha, plus beta * c if beta != 0.
+// The tail is run through a full-width scratch vector, so that all elements see the same arithmetic.
+// -----------------------------------------------------------------------
+
+template <class ISA, class OP>
+static void VectorizedUnaryKernel(size_t n, const float* a, float* c, float alpha, float beta)
+{
+    typedef typename ISA::Vec Vec;
+    const size_t W = ISA::Width;
+    const Vec valpha = ISA::Set1(alpha);
+    const Vec vbeta = ISA::Set1(beta);
+    size_t i = 0;
+    if (beta != 0)
+    {
+        for (; i + W <= n; i += W)
+            ISA::Store(c + i, ISA::Add(ISA::Mul(OP::template Apply<ISA>(ISA::Load(a + i)), valpha), ISA::Mul(vbeta, ISA::Load(c + i))));
+    }
+    else
+    {
+        for (; i + W <= n; i += W)
+            ISA::Store(c + i, ISA::Mul(OP::template Apply<ISA>(ISA::Load(a + i)), valpha));
+    }
+    if (i < n)
+    {
+        float ta[W] = { 0 }, tc[W] = { 0 };
+        memcpy(ta, a + i, (n - i) * sizeof(float));
+        if (beta != 0)
+            memcpy(tc, c + i, (n - i) * sizeof(float));
+        VectorizedUnaryKernel<ISA, OP>(W, ta, tc, alpha, beta);
+        memcpy(c + i, tc, (n - i) * sizeof(float));
+    }
+}
+
+template <class ISA, class OP>
+static void VectorizedBinaryKernel(size_t n, const float* a, const float* b, float* c, float alpha, float beta)
+{
+    typedef typename ISA::Vec Vec;
+    const size_t W = ISA::Width;
+    const Vec valpha = ISA::Set1(alpha);
+    const Vec vbeta = ISA::Set1(beta);
+    size_t i = 0;
+    if (beta != 0)
+    {
+        for (; i + W <= n; i += W)
+            ISA::Store(c + i, ISA::Add(ISA::Mul(OP::template Apply<ISA>(ISA::Load(a + i), ISA::Load(b + i)), valpha), ISA::Mul(vbeta, ISA::Load(c + i))));
+    }
+    else
+    {
+        for (; i + W <= n; i += W)
+            ISA::Store(c + i, ISA::Mul(OP::template Apply<ISA>(ISA::Load(a + i), ISA::Load(b + i)), valpha));
+    }
+    if (i < n)
+    {
+        float ta[W] = { 0 }, tb[W] = { 0 }, tc[W] = { 0 };
+        memcpy(ta, a + i, (n - i) * sizeof(float));
+        memcpy(tb, b + i, (n - i) * sizeof(float));
+        if (beta != 0)
+            memcpy(tc, c + i, (n - i) * sizeof(float));
+        VectorizedBinaryKernel<ISA, OP>(W, ta, tb, tc, alpha, beta);
+        memcpy(c + i, tc, (n - i) * sizeof(float));
+    }
+}
+
+// map an ElementWiseOperator to its kernel for instruction set ISA, or nullptr if not vectorized
+template <class ISA>
+static VectorizedUnaryTensorOpKernel GetVectorizedUnaryKernel(ElementWiseOperator op)
+{
+#define CaseVectorizedUnaryOp(oper)   \
+    case ElementWiseOperator::op##oper: \
+        return &VectorizedUnaryKernel<ISA, VectorizedOp##oper>
+
+    switch (op)
+    {
+        ForAllVectorizedUnaryOps(CaseVectorizedUnaryOp);
+    default:
+        return nullptr;
+    }
+#undef CaseVectorizedUnaryOp
+}
+
+template <class ISA>
+static VectorizedBinaryTensorOpKernel GetVectorizedBinaryKernel(ElementWiseOperator op)
+{
+#define CaseVectorizedBinaryOp(oper)  \
+    case ElementWiseOperator::op##oper: \
+        return &VectorizedBinaryKernel<ISA, VectorizedOp##oper>
+
+    switch (op)
+    {
+        ForAllVectorizedBinaryOps(CaseVectorizedBinaryOp);
+    default:
+        return nullptr;
+    }
+#undef CaseVectorizedBinaryOp
+}
+
+} // anonymous namespace
+
+}}}
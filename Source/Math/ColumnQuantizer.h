@@ -2,6 +2,7 @@
 #define __COLUMN_QUANTIZER_H__
 #include "ValueQuantizer.h"
 #include <math.h>
+#include <algorithm>
 
 #pragma warning(disable : 4127) // conditional expression is constant
 
@@ -76,6 +77,64 @@ public:
         }
     }
 
+    // CPU versions of Quantize() and Unquantize() that produce/consume the same interleaved layout.
+    // Instead of looping over QWords, they loop over the bit slots within the QWords: slot k of all QWords holds
+    // the consecutive rows [k * numQWordsPerCol, (k + 1) * numQWordsPerCol), so the inner loops access memory
+    // contiguously and without data-dependent branches on the bit position, which lets the compiler vectorize them.
+    template <bool ZeroThresholdFor1Bit>
+    void QuantizeContiguous(const ElemType* inMat, const ElemType* inResidual, long M, size_t j, QWord* qColBits, ElemType* outResidual) const
+    {
+        const size_t numQWordsPerCol = QWordsPerCol(M);
+        const size_t colOffset = ColMIDX(0, j, M);
+        const ElemType* inCol = inMat + colOffset;
+        const ElemType* inResidualCol = inResidual + colOffset;
+        ElemType* outResidualCol = outResidual + colOffset;
+
+        for (size_t iQWord = 0; iQWord < numQWordsPerCol; iQWord++)
+            qColBits[iQWord] = 0;
+
+        size_t rowBegin = 0;
+        for (size_t k = 0; (k < QWordNumBits) && (rowBegin < (size_t) M); k += valQ.NBits(), rowBegin += numQWordsPerCol)
+        {
+            const size_t numRows = std::min(numQWordsPerCol, (size_t) M - rowBegin);
+            const ElemType* in = inCol + rowBegin;
+            const ElemType* inRes = inResidualCol + rowBegin;
+            ElemType* outRes = outResidualCol + rowBegin;
+            for (size_t iQWord = 0; iQWord < numRows; iQWord++)
+            {
+                ElemType val = in[iQWord] + inRes[iQWord];
+                QWordVal qval = valQ.template Quantize<ZeroThresholdFor1Bit>(val);
+                outRes[iQWord] = val - valQ.Unquantize(qval);
+                qColBits[iQWord] |= qval << k;
+            }
+        }
+    }
+
+    void UnquantizeContiguous(ElemType* outMat, long M, size_t j, const QWord* qColBits, bool add) const
+    {
+        const size_t numQWordsPerCol = QWordsPerCol(M);
+        ElemType* outCol = outMat + ColMIDX(0, j, M);
+        // (rangeend MUST be a power of two; for the full QWord case it is 0, so the mask keeps all bits)
+        const QWordVal bitmask = valQ.QuanRangeEnd() - 1;
+
+        size_t rowBegin = 0;
+        for (size_t k = 0; (k < QWordNumBits) && (rowBegin < (size_t) M); k += valQ.NBits(), rowBegin += numQWordsPerCol)
+        {
+            const size_t numRows = std::min(numQWordsPerCol, (size_t) M - rowBegin);
+            ElemType* out = outCol + rowBegin;
+            if (add)
+            {
+                for (size_t iQWord = 0; iQWord < numRows; iQWord++)
+                    out[iQWord] = valQ.Unquantize((qColBits[iQWord] >> k) & bitmask) + out[iQWord];
+            }
+            else
+            {
+                for (size_t iQWord = 0; iQWord < numRows; iQWord++)
+                    out[iQWord] = valQ.Unquantize((qColBits[iQWord] >> k) & bitmask);
+            }
+        }
+    }
+
     // workaround for not being able to declare a default argument for lambda parameters
     template <bool ZeroThresholdFor1Bit>
     static cudacode void ComputeRangeStatColj(const ElemType* inMat, const ElemType* inResidual, long M, size_t j, size_t bits, ElemType& lower, ElemType& upper)
@@ -132,7 +191,7 @@ public:
                 // quantize
                 size_t ij = ColMIDX(i, colIdx, M);
                 ElemType val = inMat[ij] + inResidual[ij];
-                QWordVal qval = valQ.Quantize<ZeroThresholdFor1Bit>(val);
+                QWordVal qval = valQ.template Quantize<ZeroThresholdFor1Bit>(val);
 
                 // compute residual
                 ElemType uval = valQ.Unquantize(qval);
@@ -15,11 +15,14 @@
 
 #include "Basics.h"
 #include "basetypes.h"
+#include "MemAllocator.h"
 #include <string>
 #include <stdint.h>
 #include <memory>
 #include <unordered_map>
 #include <map>
+#include <vector>
+#include <limits>
 
 #pragma warning( disable: 4251 )
 typedef unsigned char byte;
@@ -185,6 +188,85 @@ enum ElementWiseOperator
     Macro(ElementwiseProductWithPowExponentDerivative); \
     Macro(ElementwiseProductWithPowBaseDerivative);
 
+// -----------------------------------------------------------------------
+// FusedTensorOpProgram -- a chain of elementwise ops to be executed in a single pass
+// over the data (TensorView::DoFusedElementwiseOpOf()).
+// The program operates on registers. Registers [0, numInputs) hold the input
+// tensors; step k writes register numInputs + k. Each step may only read
+// registers that have been written before. The result is resultRegister.
+// -----------------------------------------------------------------------
+
+static const size_t FusedTensorOpMaxInputs = 8;                               // max number of input tensors of a fused program
+static const size_t FusedTensorOpMaxOperands = FusedTensorOpMaxInputs + 1;    // inputs + output
+static const size_t FusedTensorOpMaxRegisters = 64;                           // max number of inputs + steps
+
+struct FusedTensorOpStep
+{
+    ElementWiseOperator op;
+    size_t numArgs; // 1, 2, or 3
+    size_t args[3]; // register indices
+};
+
+struct FusedTensorOpProgram
+{
+    size_t numInputs = 0;
+    std::vector<FusedTensorOpStep> steps;
+    size_t resultRegister = 0;
+
+    size_t GetNumRegisters() const { return numInputs + steps.size(); }
+
+    // append a step and return the register that holds its result
+    size_t AddStep(ElementWiseOperator op, size_t arg0)                           { return AppendStep(op, 1, arg0, 0, 0); }
+    size_t AddStep(ElementWiseOperator op, size_t arg0, size_t arg1)              { return AppendStep(op, 2, arg0, arg1, 0); }
+    size_t AddStep(ElementWiseOperator op, size_t arg0, size_t arg1, size_t arg2) { return AppendStep(op, 3, arg0, arg1, arg2); }
+
+    // check that the program is well-formed for the given number of input tensors
+    void Verify(size_t numInputTensors) const
+    {
+        if (numInputTensors != numInputs || numInputs > FusedTensorOpMaxInputs)
+            InvalidArgument("FusedTensorOpProgram: Program expects %d inputs (at most %d are supported), but %d were given.", (int) numInputs, (int) FusedTensorOpMaxInputs, (int) numInputTensors);
+        if (GetNumRegisters() > FusedTensorOpMaxRegisters)
+            InvalidArgument("FusedTensorOpProgram: Program has %d registers, at most %d are supported.", (int) GetNumRegisters(), (int) FusedTensorOpMaxRegisters);
+        for (size_t k = 0; k < steps.size(); k++)
+        {
+            if (steps[k].numArgs < 1 || steps[k].numArgs > 3)
+                LogicError("FusedTensorOpProgram: Step %d has an invalid number of arguments.", (int) k);
+            for (size_t j = 0; j < steps[k].numArgs; j++)
+                if (steps[k].args[j] >= numInputs + k)
+                    LogicError("FusedTensorOpProgram: Step %d reads register %d before it is written.", (int) k, (int) steps[k].args[j]);
+        }
+        if (resultRegister >= GetNumRegisters())
+            LogicError("FusedTensorOpProgram: Result register %d does not exist.", (int) resultRegister);
+    }
+
+private:
+    size_t AppendStep(ElementWiseOperator op, size_t numArgs, size_t arg0, size_t arg1, size_t arg2)
+    {
+        FusedTensorOpStep step = { op, numArgs, { arg0, arg1, arg2 } };
+        steps.push_back(step);
+        return resultRegister = GetNumRegisters() - 1;
+    }
+};
+
+// -----------------------------------------------------------------------
+// MultiTensorSGDOptions -- hyperparameters of a fused SGD step over many
+// parameters at once, see Matrix::MultiTensorSGDUpdate(). The gradient of
+// each parameter is scaled, clipped and L2-regularized, and then applied
+// like SGDUpdate(), MomentumSGDUpdate() or NesterovAcceleratedMomentumSGDUpdate().
+// -----------------------------------------------------------------------
+
+struct MultiTensorSGDOptions
+{
+    double gradientScale = 1.0;                                              // e.g. 1/minibatchSize for mean gradients
+    double clippingThreshold = std::numeric_limits<double>::infinity();     // per parameter, applied to the scaled gradient
+    bool clippingWithTruncation = true;                                      // truncate each element instead of limiting the Frobenius norm
+    double l2RegularizationWeight = 0.0;
+    double learnRatePerSample = 0.0;
+    double momentum = 0.0;                                                   // only used with smoothed gradients
+    bool unitGainMomentum = true;
+    bool nesterov = false;
+};
+
 // -----------------------------------------------------------------------
 // various enums to describe
 // -----------------------------------------------------------------------
@@ -263,7 +345,13 @@ public:
         {
             if (m_computeDevice < 0)
             {
-                delete[] m_pArray;
+                if (m_allocator)
+                {
+                    if (m_pArray != nullptr)
+                        m_allocator->Free(m_pArray);
+                }
+                else
+                    delete[] m_pArray;
                 m_pArray = nullptr;
                 m_nzValues = nullptr;
 
@@ -322,6 +410,9 @@ protected:
     void SetBuffer(ElemType* pArray, size_t alloc, bool external = false) { m_pArray = pArray; m_totalBufferSizeAllocated = alloc; m_externalBuffer = external; }
 
     size_t BufferSizeAllocated() const { return m_totalBufferSizeAllocated; }
+
+    const std::shared_ptr<MemAllocator>& GetAllocator() const { return m_allocator; }
+    void SetAllocator(const std::shared_ptr<MemAllocator>& allocator) { m_allocator = allocator; }
     
     size_t GetBlockSize() const { return m_blockSize; }
     void SetBlockSize(size_t blockSize) { m_blockSize = blockSize; }
@@ -387,6 +478,7 @@ protected:
         m_compIndex                = nullptr; // begin ids of col/row in CSC/CSR format
         m_blockIds                 = nullptr; // block ids
         m_blockIdShift             = 0; // used to get efficient slice, actual col = blockIds[j] - m_blockIdShift
+        m_allocator                = nullptr;
     }
 
 protected:
@@ -402,6 +494,7 @@ protected:
     size_t m_numCols;
     size_t m_elemSizeAllocated;
     ElemType* m_pArray;
+    std::shared_ptr<MemAllocator> m_allocator; // if set, the dense CPU buffer m_pArray is allocated and freed through this, see CPUMatrix::SetAllocator()
 
     // **************************
     // GPUSparseMatrix variables
@@ -462,6 +555,8 @@ public:
             LogicError("%s: Cannot resize the matrix because it is externally owned.", function);
     }
 
+    bool IsResizable() const { return m_sob.unique() && !m_sob->HasExternalBuffer(); }
+
     // same as VerifyResizable() except for the error message. Could be folded into one.
     void VerifyMigratable(const char* function) const
     {
@@ -523,6 +618,9 @@ protected:
     ElemType* Buffer() const { return m_sob->Buffer(); }
     void SetBuffer(ElemType* parray, size_t alloc, bool external = false) { m_sob->SetBuffer(parray, alloc, external); }
 
+    const std::shared_ptr<MemAllocator>& GetAllocator() const { return m_sob->GetAllocator(); }
+    void SetStorageAllocator(const std::shared_ptr<MemAllocator>& allocator) { m_sob->SetAllocator(allocator); }
+
     
     size_t GetBlockSize() const { return m_sob->GetBlockSize(); }
     void SetBlockSize(size_t blockSize) { m_sob->SetBlockSize(blockSize); }
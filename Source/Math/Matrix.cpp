@@ -12,6 +12,8 @@
 #include "GPUMatrix.h"
 #include "GPUSparseMatrix.h"
 #include "File.h"
+#include "MappedFile.h"
+#include "MemArena.h"
 #include <assert.h>
 #include <math.h>
 #include "GPUWatcher.h" // bring in this class as well so that it gets exported from this DLL
@@ -634,15 +636,22 @@ void Matrix<ElemType>::Read(File& stream)
             M.SetDataLocation(GPU, SPARSE);
         }
     }
+    else if (type == 'a')
+        M.ReadMappable(stream);
     else
-        LogicError("Read: Input file corrupt (invalid matrix type field 0x%02d, should be 'f' or 'd').", type);
+        LogicError("Read: Input file corrupt (invalid matrix type field 0x%02d, should be 'd', 's' or 'a').", type);
 }
 
 template <class ElemType>
 void Matrix<ElemType>::Write(File& stream) const
 {
     const Matrix<ElemType>& M = *this;
-    if (M.GetMatrixType() == MatrixType::DENSE)
+    if (M.GetMatrixType() == MatrixType::DENSE && stream.IsMappable())
+    {
+        stream << 'a';
+        M.WriteMappable(stream);
+    }
+    else if (M.GetMatrixType() == MatrixType::DENSE)
     {
         stream << 'd';
         if (M.GetDeviceId() < 0)
@@ -660,6 +669,104 @@ void Matrix<ElemType>::Write(File& stream) const
     }
 }
 
+// The page-aligned dense format, written instead of 'd' if the stream was opened with fileOptionsMappable:
+//   'a' BMAT <elsize> <numRows> <numCols> <dataOffset> <dataBytes> <zeros> <data> <zeros> EMAT
+// The data starts at byte dataOffset of the file, and is padded to dataBytes; both are multiples of the page size.
+// Reading it into a CPU matrix costs no copy: the matrix' buffer is the data in a copy-on-write mapping of the file
+// (served by a MappedFileRegionAllocator), which is only paged in when it is touched, and whose pages are shared by
+// all processes that read the same file until they write to them.
+static const size_t c_mappableAlignment = 4096;
+
+template <class ElemType>
+void Matrix<ElemType>::ReadMappable(File& stream)
+{
+    stream.GetMarker(fileMarkerBeginSection, std::wstring(L"BMAT"));
+    size_t elsize, numRows, numCols, dataOffset, dataBytes;
+    stream >> elsize >> numRows >> numCols >> dataOffset >> dataBytes;
+    if (sizeof(ElemType) != elsize)
+        RuntimeError("Template argument size doesn't match those in file");
+    const size_t numBytes = numRows * numCols * sizeof(ElemType);
+    if (numBytes > dataBytes)
+        LogicError("Read: Input file corrupt (matrix of %d x %d elements does not fit into %d bytes).", (int) numRows, (int) numCols, (int) dataBytes);
+
+    if (GetDeviceId() < 0)
+    {
+        if (!m_CPUMatrix)
+            m_CPUMatrix = make_shared<CPUMatrix<ElemType>>();
+        SetDataLocation(CPU, DENSE);
+
+        // Views onto the matrix (and external buffers) must keep pointing to its buffer, so then we read into it instead.
+        auto mappedFile = numBytes > 0 && m_CPUMatrix->IsResizable() ? stream.GetMappedFile() : nullptr;
+        if (mappedFile)
+        {
+            auto allocator = make_shared<MappedFileRegionAllocator>(mappedFile, dataOffset, dataBytes);
+            m_CPUMatrix->SetAllocator(allocator);
+            m_CPUMatrix->Resize(numRows, numCols);
+            if (!allocator->IsRegionInUse()) // (if the region was too small, the allocator fell back to the heap)
+                mappedFile = nullptr;
+        }
+        else
+            m_CPUMatrix->RequireSize(numRows, numCols);
+
+        if (!mappedFile && numBytes > 0)
+        {
+            stream.SetPosition(dataOffset);
+            freadOrDie(m_CPUMatrix->Data(), 1, numBytes, stream);
+        }
+    }
+    else
+    {
+        std::vector<ElemType> data(numRows * numCols);
+        if (numBytes > 0)
+        {
+            stream.SetPosition(dataOffset);
+            freadOrDie(data.data(), 1, numBytes, stream);
+        }
+        if (!m_GPUMatrix)
+            m_GPUMatrix = make_shared<GPUMatrix<ElemType>>(GetDeviceId());
+        m_GPUMatrix->SetValue(numRows, numCols, GetDeviceId(), data.data(), matrixFlagNormal);
+        SetDataLocation(GPU, DENSE);
+    }
+
+    stream.SetPosition(dataOffset + dataBytes);
+    stream.GetMarker(fileMarkerEndSection, std::wstring(L"EMAT"));
+}
+
+static void WriteZeros(File& stream, size_t numBytes)
+{
+    static const char zeros[c_mappableAlignment] = { 0 };
+    while (numBytes > 0)
+    {
+        size_t n = min(numBytes, sizeof(zeros));
+        fwriteOrDie(zeros, 1, n, stream);
+        numBytes -= n;
+    }
+}
+
+template <class ElemType>
+void Matrix<ElemType>::WriteMappable(File& stream) const
+{
+    stream.PutMarker(fileMarkerBeginSection, std::wstring(L"BMAT"));
+    const size_t numBytes = GetNumElements() * sizeof(ElemType);
+    const size_t dataBytes = AsMultipleOf(numBytes, c_mappableAlignment);
+    stream << sizeof(ElemType) << GetNumRows() << GetNumCols();
+    // the data begins at the first page boundary after the two offsets written next
+    const size_t dataOffset = AsMultipleOf((size_t) stream.GetPosition() + 2 * sizeof(size_t), c_mappableAlignment);
+    stream << dataOffset << dataBytes;
+    WriteZeros(stream, dataOffset - stream.GetPosition());
+
+    if (GetDeviceId() < 0)
+        fwriteOrDie(m_CPUMatrix->Data(), 1, numBytes, stream);
+    else
+    {
+        std::unique_ptr<ElemType[]> data(CopyToArray());
+        fwriteOrDie(data.get(), 1, numBytes, stream);
+    }
+
+    WriteZeros(stream, dataBytes - numBytes);
+    stream.PutMarker(fileMarkerEndSection, std::wstring(L"EMAT"));
+}
+
 #pragma endregion Constructors, destructors and other static matrix builders
 
 #pragma region Basic Operators
@@ -1760,7 +1867,8 @@ ElemType Matrix<ElemType>::Adagrad(Matrix<ElemType>& gradients, const bool needA
 //  - the model itself
 template <class ElemType>
 void Matrix<ElemType>::FSAdagradUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>& functionValues, const double targetAdagradAvDenom_x_sqrtAdagradSqrFrames,
-                                       const double learnRatePerSample, const double meanMomentum, const double varMomentum, bool unitGainMomentum)
+                                       const double learnRatePerSample, const double meanMomentum, const double varMomentum, bool unitGainMomentum,
+                                       Matrix<double>* lastUpdateSteps, double currentStep)
 {
     DISPATCH_MATRIX_ON_FLAG(&gradients, &gradients,
         { 
@@ -1775,7 +1883,15 @@ void Matrix<ElemType>::FSAdagradUpdate(Matrix<ElemType>& gradients, Matrix<ElemT
                                    (ElemType)targetAdagradAvDenom_x_sqrtAdagradSqrFrames, unitGainMomentum);
             SetDataLocation(GPU); 
         },
-        { NOT_IMPLEMENTED; },
+        {
+            if (lastUpdateSteps && lastUpdateSteps->GetDeviceId() != CPUDEVICE)
+                InvalidArgument("FSAdagradUpdate: The last update steps must be on the CPU.");
+            gradients.m_CPUSparseMatrix->FSAdagrad(*m_CPUMatrix, *functionValues.m_CPUMatrix,
+                                                   (ElemType)learnRatePerSample, (ElemType)meanMomentum, (ElemType)varMomentum,
+                                                   (ElemType)targetAdagradAvDenom_x_sqrtAdagradSqrFrames, unitGainMomentum,
+                                                   lastUpdateSteps ? lastUpdateSteps->m_CPUMatrix.get() : nullptr, currentStep);
+            SetDataLocation(CPU);
+        },
         {
             gradients.m_GPUSparseMatrix->FSAdagrad(*m_GPUMatrix, *functionValues.m_GPUMatrix, 
                                                    (ElemType)learnRatePerSample, (ElemType)meanMomentum, (ElemType)varMomentum,
@@ -1792,7 +1908,8 @@ void Matrix<ElemType>::FSAdagradUpdate(Matrix<ElemType>& gradients, Matrix<ElemT
 ///
 template <class ElemType>
 void Matrix<ElemType>::AdamUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>& functionValues, const double smoothedCount,
-    const double learnRatePerSample, const double meanMomentum, const double varMomentum, const double epsilon, bool unitGainMomentum, bool adamax)
+    const double learnRatePerSample, const double meanMomentum, const double varMomentum, const double epsilon, bool unitGainMomentum, bool adamax,
+    Matrix<double>* lastUpdateSteps)
 {
     // Bias correction
     let biasCorrection = adamax? (ElemType)(1. / (1- pow(meanMomentum, smoothedCount))) : (ElemType)(sqrt(1- pow(varMomentum, smoothedCount))/(1- pow(meanMomentum, smoothedCount)));
@@ -1810,7 +1927,13 @@ void Matrix<ElemType>::AdamUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>&
         biasCorrection, (ElemType)epsilon, unitGainMomentum, adamax);
         SetDataLocation(GPU);
     },
-    { NOT_IMPLEMENTED; },
+    { if (lastUpdateSteps && lastUpdateSteps->GetDeviceId() != CPUDEVICE)
+          InvalidArgument("AdamUpdate: The last update steps must be on the CPU.");
+      gradients.m_CPUSparseMatrix->Adam(*m_CPUMatrix, *functionValues.m_CPUMatrix,
+        (ElemType)learnRatePerSample, (ElemType)meanMomentum,
+        (ElemType)varMomentum, biasCorrection, (ElemType)epsilon, unitGainMomentum, adamax,
+        lastUpdateSteps ? lastUpdateSteps->m_CPUMatrix.get() : nullptr, smoothedCount);
+        SetDataLocation(CPU); },
     { gradients.m_GPUSparseMatrix->Adam(*m_GPUMatrix, *functionValues.m_GPUMatrix, 
         (ElemType)learnRatePerSample, (ElemType)meanMomentum, 
         (ElemType)varMomentum, biasCorrection, (ElemType)epsilon, unitGainMomentum, adamax); 
@@ -1827,14 +1950,19 @@ ElemType Matrix<ElemType>::RmsProp(Matrix<ElemType>& gradients,
                                    ElemType RMS_WGT_DEC,
                                    ElemType RMS_WGT_MIN,
                                    const bool needAveMultiplier,
-                                   const bool initialized)
+                                   const bool initialized,
+                                   Matrix<double>* lastUpdateSteps,
+                                   double currentStep)
 {
     DecideAndMoveToRightDevice(*this, gradients);
 
     DISPATCH_MATRIX_ON_FLAG(&gradients, &gradients,
         { return m_CPUMatrix->RmsProp(*gradients.m_CPUMatrix, RMS_GAMMA, RMS_WGT_INC, RMS_WGT_MAX, RMS_WGT_DEC, RMS_WGT_MIN, needAveMultiplier, initialized); SetDataLocation(CPU); },
         { return m_GPUMatrix->RmsProp(*gradients.m_GPUMatrix, RMS_GAMMA, RMS_WGT_INC, RMS_WGT_MAX, RMS_WGT_DEC, RMS_WGT_MIN, needAveMultiplier, initialized); SetDataLocation(GPU); },
-        { NOT_IMPLEMENTED; },
+        { if (lastUpdateSteps && lastUpdateSteps->GetDeviceId() != CPUDEVICE)
+              InvalidArgument("RmsProp: The last update steps must be on the CPU.");
+          return gradients.m_CPUSparseMatrix->RmsProp(*m_CPUMatrix, RMS_GAMMA, RMS_WGT_INC, RMS_WGT_MAX, RMS_WGT_DEC, RMS_WGT_MIN, needAveMultiplier, initialized,
+                                                      lastUpdateSteps ? lastUpdateSteps->m_CPUMatrix.get() : nullptr, currentStep); SetDataLocation(CPU); },
         { return gradients.m_GPUSparseMatrix->RmsProp(*m_GPUMatrix, RMS_GAMMA, RMS_WGT_INC, RMS_WGT_MAX, RMS_WGT_DEC, RMS_WGT_MIN, needAveMultiplier, initialized); SetDataLocation(GPU); });
     // Note: Since both 'this' and gradients are changed, we must call SetDataLocation() on 'this' as well.
 }
@@ -1853,6 +1981,27 @@ void Matrix<ElemType>::AdaDeltaUpdate(Matrix<ElemType>& gradients,
     { return gradients.m_GPUSparseMatrix->AdaDelta(*m_GPUMatrix, *functionValues.m_GPUMatrix, learningRate, rho, epsilon); SetDataLocation(GPU); });
 }
 
+// Fused update of many parameters, see CPUMatrix::MultiTensorSGDUpdate(). It is only implemented for dense CPU matrices;
+// callers fall back to the per-parameter updates above otherwise.
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::MultiTensorSGDUpdate(const vector<Matrix<ElemType>*>& parameters, const vector<Matrix<ElemType>*>& gradients,
+                                                       const vector<Matrix<ElemType>*>& smoothedGradients, const MultiTensorSGDOptions& options)
+{
+    let GetCPUMatrices = [](const vector<Matrix<ElemType>*>& matrices)
+    {
+        vector<CPUMatrix<ElemType>*> cpuMatrices;
+        for (const auto& matrix : matrices)
+        {
+            if (matrix->GetDeviceId() != CPUDEVICE || matrix->GetMatrixType() != MatrixType::DENSE)
+                NOT_IMPLEMENTED;
+            cpuMatrices.push_back(matrix->m_CPUMatrix.get());
+        }
+        return cpuMatrices;
+    };
+
+    CPUMatrix<ElemType>::MultiTensorSGDUpdate(GetCPUMatrices(parameters), GetCPUMatrices(gradients), GetCPUMatrices(smoothedGradients), options);
+}
+
 template <class ElemType>
 void Matrix<ElemType>::Reshape(const size_t numRows, const size_t numCols)
 {
@@ -1883,6 +2032,13 @@ void Matrix<ElemType>::Resize(const size_t numRows, const size_t numCols, const
 #endif
 }
 
+template <class ElemType>
+void Matrix<ElemType>::SetAllocator(const shared_ptr<MemAllocator>& allocator)
+{
+    if (GetMatrixType() == MatrixType::DENSE && GetCurrentMatrixLocation() == CurrentDataLocation::CPU)
+        m_CPUMatrix->SetAllocator(allocator);
+}
+
 template <class ElemType>
 Matrix<ElemType> Matrix<ElemType>::RepMat(const Matrix<ElemType>& frmMat, const size_t rowRatio, const size_t colRatio)
 {
@@ -4802,7 +4958,7 @@ void Matrix<ElemType>::RNNForward(const Matrix<ElemType> &inputX, const Matrix<E
 
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            m_CPUMatrix->RNNForward(*(inputX.m_CPUMatrix), *(paramW.m_CPUMatrix), xDim, yDim, numSequencesForFrame, rnnAttributes, *(reserve.m_CPUMatrix), *(workspace.m_CPUMatrix)),
                             m_GPUMatrix->RNNForward(*(inputX.m_GPUMatrix), *(paramW.m_GPUMatrix), xDim, yDim, numSequencesForFrame, rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
@@ -4817,7 +4973,7 @@ void Matrix<ElemType>::RNNBackwardData(const Matrix<ElemType>& outputDY, const M
     workspace._transferToDevice(GetDeviceId());
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            m_CPUMatrix->RNNBackwardData(*(outputDY.m_CPUMatrix), *(paramW.m_CPUMatrix), *(outputDX.m_CPUMatrix), rnnAttributes, *(reserve.m_CPUMatrix), *(workspace.m_CPUMatrix)),
                             m_GPUMatrix->RNNBackwardData(*(outputDY.m_GPUMatrix), *(paramW.m_GPUMatrix), *(outputDX.m_GPUMatrix), rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
@@ -4832,7 +4988,7 @@ void Matrix<ElemType>::RNNBackwardWeights(const Matrix<ElemType>& inputX, const
     workspace._transferToDevice(GetDeviceId());
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            m_CPUMatrix->RNNBackwardWeights(*(inputX.m_CPUMatrix), *(outputY.m_CPUMatrix), *(dw.m_CPUMatrix), rnnAttributes, *(reserve.m_CPUMatrix), *(workspace.m_CPUMatrix)),
                             m_GPUMatrix->RNNBackwardWeights(*(inputX.m_GPUMatrix), *(outputY.m_GPUMatrix), *(dw.m_GPUMatrix), rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
@@ -6061,6 +6217,31 @@ void Matrix<ElemType>::TensorArgOp(const Matrix<ElemType>& a, ElementWiseOperato
         NOT_IMPLEMENTED);
 }
 
+// Fused elementwise programs are only implemented for the CPU. TensorView::DoFusedElementwiseOpOf() runs them step by step on other devices.
+template <class ElemType>
+void Matrix<ElemType>::FusedTensorOp(ElemType beta, const vector<const Matrix<ElemType>*>& inputs, ElemType alpha, const FusedTensorOpProgram& program,
+                                     const array<size_t, FusedTensorOpMaxOperands>& offsets,
+                                     const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, FusedTensorOpMaxOperands>& regularStrides)
+{
+    VerifyIsDense(*this);
+    vector<const CPUMatrix<ElemType>*> cpuInputs;
+    for (const auto& input : inputs)
+    {
+        VerifyIsDense(*input);
+        if (input->GetDeviceId() != GetDeviceId())
+            LogicError("FusedTensorOp: All operands must be on the same device.");
+        if (GetDeviceId() == CPUDEVICE)
+            cpuInputs.push_back(input->m_CPUMatrix.get());
+    }
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+        this,
+        m_CPUMatrix->FusedTensorOp(beta, cpuInputs, alpha, program, offsets, regularOpDims, regularStrides),
+        NOT_IMPLEMENTED,
+        NOT_IMPLEMENTED,
+        NOT_IMPLEMENTED);
+}
+
 //template class Matrix<short>;
 template class Matrix<float>;
 template class Matrix<double>;
@@ -209,21 +209,33 @@ public:
     void NesterovAcceleratedMomentumSGDUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>& smoothedGradients, ElemType learnRatePerSample, ElemType momentum, bool unitGainMomentum = true);
 
     ElemType Adagrad(Matrix<ElemType>& gradients, const bool needAveMultiplier);
+    // lastUpdateSteps, currentStep: per-column state of the lazy update for block sparse gradients on the CPU, see CPUSparseMatrix::Adam(); ignored otherwise
     void FSAdagradUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>& functionValues, const double targetAdagradAvDenom_x_sqrtAdagradSqrFrames,
-                         const double learnRatePerSample, const double meanMomentum, const double varMomentum, bool unitGainMomentum = true);
+                         const double learnRatePerSample, const double meanMomentum, const double varMomentum, bool unitGainMomentum = true,
+                         Matrix<double>* lastUpdateSteps = nullptr, double currentStep = 0);
 
+    // lastUpdateSteps: as above, with smoothedCount as the current step
     void AdamUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>& functionValues, const double smoothedCount,
-        const double learnRatePerSample, const double meanMomentum, const double varMomentum, const double epsilon, bool unitGainMomentum = true, bool adamax = false);
+        const double learnRatePerSample, const double meanMomentum, const double varMomentum, const double epsilon, bool unitGainMomentum = true, bool adamax = false,
+        Matrix<double>* lastUpdateSteps = nullptr);
 
-    ElemType RmsProp(Matrix<ElemType>& gradients, ElemType RMS_GAMMA, ElemType RMS_WGT_INC, ElemType RMS_WGT_MAX, ElemType RMS_WGT_DEC, ElemType RMS_WGT_MIN, const bool needAveMultiplier, const bool initialized);
+    // lastUpdateSteps, currentStep: as for FSAdagradUpdate()
+    ElemType RmsProp(Matrix<ElemType>& gradients, ElemType RMS_GAMMA, ElemType RMS_WGT_INC, ElemType RMS_WGT_MAX, ElemType RMS_WGT_DEC, ElemType RMS_WGT_MIN, const bool needAveMultiplier, const bool initialized,
+                     Matrix<double>* lastUpdateSteps = nullptr, double currentStep = 0);
 
     void AdaDeltaUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>& functionvalues, ElemType learningRatePerSample, ElemType rho, ElemType epsilon);
 
+    // fused SGD, momentum SGD or Nesterov update of many parameters at once; plain SGD if smoothedGradients is empty
+    static void MultiTensorSGDUpdate(const std::vector<Matrix<ElemType>*>& parameters, const std::vector<Matrix<ElemType>*>& gradients,
+                                     const std::vector<Matrix<ElemType>*>& smoothedGradients, const MultiTensorSGDOptions& options);
+
     void Resize(const size_t numRows, const size_t numCols, const size_t numNZElemToReserve = 10000, bool growOnly = true); // by default we only reallocate if need to grow
     void Resize(const Matrix<ElemType>& other) // TODO: Should this carry over numNZElemToReserve for sparse matrices?
     {
         Resize(other.GetNumRows(), other.GetNumCols());
     }
+    // route future allocations of a dense CPU matrix through 'allocator' (see CPUMatrix::SetAllocator()); a no-op for other matrices
+    void SetAllocator(const shared_ptr<MemAllocator>& allocator);
     void VerifySize(size_t rows, size_t cols)
     {
         m_baseMatrix->VerifySize(rows, cols);
@@ -624,10 +636,22 @@ public:
                      const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& regularStrides,
                      const SmallVector<size_t>& reducingOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& reducingStrides);
 
+    // execute a FusedTensorOpProgram in a single pass; operand slots beyond inputs.size() are unused, the output is the last one
+    void FusedTensorOp(ElemType beta, const std::vector<const Matrix<ElemType>*>& inputs, ElemType alpha, const FusedTensorOpProgram& program,
+                       const std::array<size_t, FusedTensorOpMaxOperands>& offsets,
+                       const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, FusedTensorOpMaxOperands>& regularStrides);
+
 public:
     void Read(File& stream);
     void Write(File& stream) const;
 
+private:
+    // page-aligned dense format of files written with fileOptionsMappable
+    void ReadMappable(File& stream);
+    void WriteMappable(File& stream) const;
+
+public:
+
     Matrix<ElemType>& Shift(const Matrix<ElemType>& a, int shift);
 
     Matrix<ElemType>& AssignElementProductOfWithShiftNeg(const Matrix<ElemType>& a, const Matrix<ElemType>& b, size_t shift, size_t negnumber);
@@ -1,12 +1,67 @@
 #include "stdafx.h"
 #include "MatrixQuantizerCPU.h"
+#include <algorithm>
+#include <omp.h>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// below this number of elements, the columns are quantized on the calling thread only
+static const size_t MinElementsForParallelQuantization = 64 * 1024;
+
+template <class ElemType>
+MatrixQuantizerCPU<ElemType>::MatrixQuantizerCPU(bool useAsync)
+    : MatrixQuantizerImpl<ElemType>(CPUDEVICE), m_useAsync(useAsync), m_stopping(false)
+{
+    if (m_useAsync)
+        m_worker = std::thread(&MatrixQuantizerCPU<ElemType>::RunWorker, this, std::max(1, omp_get_max_threads() / 2));
+}
+
+template <class ElemType>
+MatrixQuantizerCPU<ElemType>::~MatrixQuantizerCPU()
+{
+    // the queued tasks reference matrices owned by the caller; they are run before the worker stops
+    if (m_worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_tasksAvailable.notify_one();
+        m_worker.join();
+    }
+}
+
+template <class ElemType>
+std::future<void> MatrixQuantizerCPU<ElemType>::Post(std::function<void()> task)
+{
+    std::packaged_task<void()> packagedTask(std::move(task));
+    auto result = packagedTask.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(packagedTask));
+    }
+    m_tasksAvailable.notify_one();
+    return result;
+}
+
 template <class ElemType>
-MatrixQuantizerCPU<ElemType>::MatrixQuantizerCPU()
-    : MatrixQuantizerImpl<ElemType>(CPUDEVICE)
+void MatrixQuantizerCPU<ElemType>::RunWorker(int numOMPThreads)
 {
+    // the thread's OpenMP setting applies to all parallel regions of the tasks it runs
+    omp_set_num_threads(numOMPThreads);
+    for (;;)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_tasksAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty())
+                return; // stopping, and all tasks are done
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task(); // an exception is stored in the task's future
+    }
 }
 
 template <class ElemType>
@@ -16,6 +71,20 @@ void MatrixQuantizerCPU<ElemType>::QuantizeAsync(const Matrix<ElemType>& inMatri
     // TODO: Support transferring the quantization output to a quantized matrix on the GPU
     assert(outQMatrix.GetDeviceId() == CPUDEVICE);
 
+    if (!m_useAsync)
+        return Quantize(inMatrix, inResidual, outQMatrix, outResidual, zeroThresholdFor1Bit);
+
+    // only one quantization can be in flight
+    WaitQuantizeAsyncDone();
+    m_quantizeTask = Post([&inMatrix, &inResidual, &outQMatrix, &outResidual, zeroThresholdFor1Bit]()
+    {
+        Quantize(inMatrix, inResidual, outQMatrix, outResidual, zeroThresholdFor1Bit);
+    });
+}
+
+template <class ElemType>
+void MatrixQuantizerCPU<ElemType>::Quantize(const Matrix<ElemType>& inMatrix, const Matrix<ElemType>& inResidual, QuantizedMatrix<ElemType>& outQMatrix, Matrix<ElemType>& outResidual, bool zeroThresholdFor1Bit)
+{
     size_t nBits = outQMatrix.GetNumBits();
 
     size_t nRow = inMatrix.GetNumRows();
@@ -27,45 +96,38 @@ void MatrixQuantizerCPU<ElemType>::QuantizeAsync(const Matrix<ElemType>& inMatri
     assert((outResidual.GetNumRows() == nRow) && (outResidual.GetNumCols() == nCol));
 
     const size_t ldNbits = ValueQuantizer<ElemType>::ld(nBits);
-#ifdef QUANTUSEPPL
-    Concurrency::parallel_for((size_t) 0, us.cols(), [&](size_t j)
-#else
-    for (size_t j = 0; j < nCol; j++)
-#endif
+    const ElemType* inData = inMatrix.Data();
+    const ElemType* inResidualData = inResidual.Data();
+    ElemType* outResidualData = outResidual.Data();
+
+    // the columns are independent, so they are distributed over the threads
+#pragma omp parallel for if (nRow * nCol >= MinElementsForParallelQuantization && nCol > 1)
+    for (long j = 0; j < (long) nCol; j++)
     {
         auto& qcol = *(outQMatrix.GetQuantizedColumn(j));
         if (zeroThresholdFor1Bit)
         {
             // Explicit use of 'template' keyword is needed to compile with GCC
-            ColumnQuantizer<ElemType>::template ComputeRangeStatColj<true>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, nBits, qcol.lower, qcol.upper);
+            ColumnQuantizer<ElemType>::template ComputeRangeStatColj<true>(inData, inResidualData, (long) nRow, j, nBits, qcol.lower, qcol.upper);
+            ColumnQuantizer<ElemType> q(ldNbits, qcol.lower, qcol.upper);
+            q.template QuantizeContiguous<true>(inData, inResidualData, (long) nRow, j, qcol.bits, outResidualData);
         }
         else
         {
             // Explicit use of 'template' keyword is needed to compile with GCC
-            ColumnQuantizer<ElemType>::template ComputeRangeStatColj<false>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, nBits, qcol.lower, qcol.upper);
-        }
-
-        ColumnQuantizer<ElemType> q(ldNbits, qcol.lower, qcol.upper);
-        if (zeroThresholdFor1Bit)
-        {
-            // Explicit use of 'template' keyword is needed to compile with GCC
-            q.template Quantize<true>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, qcol.bits, outResidual.Data());
-        }
-        else
-        {
-            // Explicit use of 'template' keyword is needed to compile with GCC
-            q.template Quantize<false>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, qcol.bits, outResidual.Data());
+            ColumnQuantizer<ElemType>::template ComputeRangeStatColj<false>(inData, inResidualData, (long) nRow, j, nBits, qcol.lower, qcol.upper);
+            ColumnQuantizer<ElemType> q(ldNbits, qcol.lower, qcol.upper);
+            q.template QuantizeContiguous<false>(inData, inResidualData, (long) nRow, j, qcol.bits, outResidualData);
         }
     }
-#ifdef QUANTUSEPPL
-    );
-#endif
 }
 
 template <class ElemType>
 void MatrixQuantizerCPU<ElemType>::WaitQuantizeAsyncDone()
 {
-    // TODO: Currently this is a no-op since the actual quantization is synchronous
+    // get() rethrows any exception of the background task
+    if (m_quantizeTask.valid())
+        m_quantizeTask.get();
 }
 
 // unquantize an entire matrix, calling unquantize() for each column
@@ -76,6 +138,20 @@ void MatrixQuantizerCPU<ElemType>::UnquantizeAsync(QuantizedMatrix<ElemType>& in
     assert(inQMatrix.GetDeviceId() == CPUDEVICE);
     assert(outMatrix.GetDeviceId() == CPUDEVICE);
 
+    if (!m_useAsync)
+        return Unquantize(inQMatrix, outMatrix, add);
+
+    // only one unquantization can be in flight
+    WaitUnquantizeAsyncDone();
+    m_unquantizeTask = Post([&inQMatrix, &outMatrix, add]()
+    {
+        Unquantize(inQMatrix, outMatrix, add);
+    });
+}
+
+template <class ElemType>
+void MatrixQuantizerCPU<ElemType>::Unquantize(QuantizedMatrix<ElemType>& inQMatrix, Matrix<ElemType>& outMatrix, bool add)
+{
     size_t nBits = inQMatrix.GetNumBits();
     size_t nRow = inQMatrix.GetNumRows();
     size_t nCol = inQMatrix.GetNumCols();
@@ -84,25 +160,22 @@ void MatrixQuantizerCPU<ElemType>::UnquantizeAsync(QuantizedMatrix<ElemType>& in
     assert((outMatrix.GetNumRows() == nRow) && (outMatrix.GetNumCols() == nCol));
 
     const size_t ldNbits = ValueQuantizer<ElemType>::ld(nBits);
-#ifdef QUANTUSEPPL
-    Concurrency::parallel_for((size_t) 0, us.cols(), [&](size_t j)
-#else
-    for (size_t j = 0; j < nCol; j++)
-#endif
+    ElemType* outData = outMatrix.Data();
+
+#pragma omp parallel for if (nRow * nCol >= MinElementsForParallelQuantization && nCol > 1)
+    for (long j = 0; j < (long) nCol; j++)
     {
         const auto& qcol = *(inQMatrix.GetQuantizedColumn(j));
         ColumnQuantizer<ElemType> q(ldNbits, qcol.lower, qcol.upper);
-        q.Unquantize(outMatrix.Data(), (long) nRow, j, qcol.bits, add);
+        q.UnquantizeContiguous(outData, (long) nRow, j, qcol.bits, add);
     }
-#ifdef QUANTUSEPPL
-    );
-#endif
 }
 
 template <class ElemType>
 void MatrixQuantizerCPU<ElemType>::WaitUnquantizeAsyncDone()
 {
-    // TODO: Currently this is a no-op since the actual quantization is synchronous
+    if (m_unquantizeTask.valid())
+        m_unquantizeTask.get();
 }
 
 //The explicit instantiation part will make the linker happy
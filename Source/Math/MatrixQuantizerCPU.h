@@ -4,6 +4,12 @@
 #include "ColumnQuantizer.h"
 #include "QuantizedMatrix.h"
 #include "CPUMatrix.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
 
 #ifdef _WIN32
 #ifdef MATH_EXPORTS
@@ -18,11 +24,16 @@
 namespace Microsoft { namespace MSR { namespace CNTK {
 
 //see dbn::matrix quantizer
+// The columns are quantized in parallel on the OpenMP threads. With 'useAsync', the quantization runs on a worker thread
+// owned by the quantizer, and the matrices passed to QuantizeAsync()/UnquantizeAsync() must not be accessed until the
+// corresponding Wait...AsyncDone() returns. The worker lives as long as the quantizer, so that OpenMP keeps reusing its
+// thread team, and it uses half of the caller's OpenMP threads, leaving the others to the computation it overlaps with.
 template <class ElemType>
 class MatrixQuantizerCPU final : public MatrixQuantizerImpl<ElemType>
 {
 public:
-    MatrixQuantizerCPU();
+    MatrixQuantizerCPU(bool useAsync = false);
+    ~MatrixQuantizerCPU();
 
     // Disallow copy construction and assignment
     MatrixQuantizerCPU(const MatrixQuantizerCPU&) = delete;
@@ -33,5 +44,23 @@ public:
 
     void UnquantizeAsync(QuantizedMatrix<ElemType>& inQMatrix, Matrix<ElemType>& outMatrix, bool add = false) override;
     void WaitUnquantizeAsyncDone() override;
+
+private:
+    static void Quantize(const Matrix<ElemType>& inMatrix, const Matrix<ElemType>& inResidual, QuantizedMatrix<ElemType>& outQMatrix, Matrix<ElemType>& outResidual, bool zeroThresholdFor1Bit);
+    static void Unquantize(QuantizedMatrix<ElemType>& inQMatrix, Matrix<ElemType>& outMatrix, bool add);
+
+    // queue a task for the worker thread
+    std::future<void> Post(std::function<void()> task);
+    void RunWorker(int numOMPThreads);
+
+    bool m_useAsync;
+    std::future<void> m_quantizeTask;
+    std::future<void> m_unquantizeTask;
+
+    std::mutex m_mutex;
+    std::condition_variable m_tasksAvailable;
+    std::deque<std::packaged_task<void()>> m_tasks;
+    bool m_stopping;
+    std::thread m_worker;
 };
 } } }
@@ -21,7 +21,7 @@ template <class ElemType>
     }
     else
     {
-        return new MatrixQuantizerCPU<ElemType>();
+        return new MatrixQuantizerCPU<ElemType>(useAsync);
     }
 }
 
@@ -15,6 +15,7 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 class MATH_API MemAllocator
 {
 public:
+    virtual ~MemAllocator() {}
     virtual void* Malloc(size_t size) = 0;
     virtual void Free(void* p) = 0;
 };
@@ -0,0 +1,146 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "Basics.h"
+#include "MemArena.h"
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// ---------------------------------------------------------------------------
+// MemArena
+// ---------------------------------------------------------------------------
+
+static const size_t c_hugePageSize = 2 * 1024 * 1024;
+
+MemArena::MemArena(size_t size, bool useHugePages)
+    : m_data(nullptr), m_size(0), m_usesHugePages(false)
+{
+    if (size == 0)
+        return;
+
+#ifdef _WIN32
+    if (useHugePages && GetLargePageMinimum() > 0)
+    {
+        // requires the SeLockMemoryPrivilege; if we don't have it, fall back to regular pages
+        size_t largePageSize = GetLargePageMinimum();
+        size_t largeSize = (size + largePageSize - 1) / largePageSize * largePageSize;
+        m_data = (char*) VirtualAlloc(nullptr, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (m_data)
+        {
+            m_size = largeSize;
+            m_usesHugePages = true;
+            return;
+        }
+    }
+    m_data = (char*) VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!m_data)
+        RuntimeError("MemArena: failed to allocate %.1f MB.", size / 1048576.0);
+    m_size = size;
+#else
+    if (useHugePages)
+    {
+        size = (size + c_hugePageSize - 1) / c_hugePageSize * c_hugePageSize;
+#ifdef MAP_HUGETLB
+        // explicit huge pages, if the system has reserved some
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            m_data = (char*) p;
+            m_size = size;
+            m_usesHugePages = true;
+            return;
+        }
+#endif
+    }
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        RuntimeError("MemArena: failed to allocate %.1f MB.", size / 1048576.0);
+    m_data = (char*) p;
+    m_size = size;
+#ifdef MADV_HUGEPAGE
+    // otherwise ask for transparent huge pages
+    if (useHugePages)
+        m_usesHugePages = (madvise(m_data, m_size, MADV_HUGEPAGE) == 0);
+#endif
+#endif
+}
+
+MemArena::~MemArena()
+{
+    if (!m_data)
+        return;
+#ifdef _WIN32
+    VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+    munmap(m_data, m_size);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// RegionAllocator
+// ---------------------------------------------------------------------------
+
+void* RegionAllocator::Malloc(size_t size)
+{
+    if (!m_isInUse && size <= m_size)
+    {
+        m_isInUse = true;
+        return m_region;
+    }
+    return new char[size];
+}
+
+void RegionAllocator::Free(void* p)
+{
+    if (p == m_region)
+    {
+        if (!m_isInUse)
+            LogicError("RegionAllocator: region freed twice.");
+        m_isInUse = false;
+    }
+    else
+        delete[] (char*) p;
+}
+
+// ---------------------------------------------------------------------------
+// MemArenaRegionAllocator
+// ---------------------------------------------------------------------------
+
+static char* ArenaRegion(const std::shared_ptr<MemArena>& arena, size_t offset, size_t size)
+{
+    if (offset % MemArena::Alignment != 0 || offset + size > arena->Size())
+        InvalidArgument("MemArenaRegionAllocator: region [%llu, %llu) is misaligned or outside the arena of %llu bytes.", (unsigned long long) offset, (unsigned long long) (offset + size), (unsigned long long) arena->Size());
+    return arena->Data() + offset;
+}
+
+MemArenaRegionAllocator::MemArenaRegionAllocator(const std::shared_ptr<MemArena>& arena, size_t offset, size_t size)
+    : RegionAllocator(ArenaRegion(arena, offset, size), size), m_arena(arena)
+{
+}
+
+// ---------------------------------------------------------------------------
+// MappedFileRegionAllocator
+// ---------------------------------------------------------------------------
+
+static char* MappedFileRegion(const std::shared_ptr<MappedFile>& file, size_t offset, size_t size)
+{
+    if (offset + size > file->Size())
+        InvalidArgument("MappedFileRegionAllocator: region [%llu, %llu) is outside the file of %llu bytes.", (unsigned long long) offset, (unsigned long long) (offset + size), (unsigned long long) file->Size());
+    return file->MutableData() + offset;
+}
+
+MappedFileRegionAllocator::MappedFileRegionAllocator(const std::shared_ptr<MappedFile>& file, size_t offset, size_t size)
+    : RegionAllocator(MappedFileRegion(file, offset, size), size), m_file(file)
+{
+}
+
+}}}
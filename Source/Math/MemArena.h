@@ -0,0 +1,86 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// MemArena.h -- one large CPU memory block that is carved into fixed regions, each serving the buffer of one matrix;
+// likewise for the regions of a memory-mapped file
+//
+
+#pragma once
+
+#include "MemAllocator.h"
+#include <memory>
+#include <stddef.h>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+class MappedFile;
+
+// MemArena -- a single, page-aligned block of CPU memory, optionally backed by huge pages
+// The arena itself does no bookkeeping; the caller (the MatrixPool's planner) decides which region goes to which matrix.
+class MATH_API MemArena
+{
+public:
+    MemArena(size_t size, bool useHugePages);
+    ~MemArena();
+
+    char* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+    bool UsesHugePages() const { return m_usesHugePages; }
+
+    // alignment of the regions handed out by the planner
+    static const size_t Alignment = 64;
+
+private:
+    MemArena(const MemArena&) = delete;
+    MemArena& operator=(const MemArena&) = delete;
+
+    char* m_data;
+    size_t m_size;          // bytes mapped
+    bool m_usesHugePages;   // true if huge pages were actually obtained
+};
+
+// RegionAllocator -- MemAllocator for the buffer of a single matrix, serving a fixed region of a larger block of memory
+// Allocations that do not fit into the region, or are made while the region is in use, fall back to the heap. A region is
+// therefore always safe to use, even if the planned size was an underestimate.
+// Not thread-safe; a matrix storage object is not either.
+class MATH_API RegionAllocator : public MemAllocator
+{
+public:
+    void* Malloc(size_t size) override;
+    void Free(void* p) override;
+
+    size_t GetRegionSize() const { return m_size; }
+    bool IsRegionInUse() const { return m_isInUse; }
+
+protected:
+    RegionAllocator(char* region, size_t size) : m_region(region), m_size(size), m_isInUse(false) { }
+
+private:
+    char* m_region;
+    size_t m_size;
+    bool m_isInUse;
+};
+
+// MemArenaRegionAllocator -- RegionAllocator serving [offset, offset + size) of a MemArena
+class MATH_API MemArenaRegionAllocator : public RegionAllocator
+{
+public:
+    MemArenaRegionAllocator(const std::shared_ptr<MemArena>& arena, size_t offset, size_t size);
+
+private:
+    std::shared_ptr<MemArena> m_arena; // keeps the arena alive as long as a matrix may still point into it
+};
+
+// MappedFileRegionAllocator -- RegionAllocator serving [offset, offset + size) of a copy-on-write mapped file
+// The first allocation of a matrix with this allocator returns the file's data in place, see Matrix::Read().
+class MATH_API MappedFileRegionAllocator : public RegionAllocator
+{
+public:
+    MappedFileRegionAllocator(const std::shared_ptr<MappedFile>& file, size_t offset, size_t size);
+
+private:
+    std::shared_ptr<MappedFile> m_file; // keeps the mapping alive as long as a matrix may still point into it
+};
+
+}}}
@@ -0,0 +1,66 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// QuantizedGemm on top of BlockMultiplier, templated on the block handler (SSE or AVX2 kernels).
+//
+// Include this only from a translation unit that is compiled for the instruction set of the block handler it
+// instantiates. The implementation lives in an anonymous namespace, so that none of the instantiated code can be
+// shared with (and picked by the linker for) code compiled for the baseline.
+//
+
+#pragma once
+
+#include "QuantizedOperations.h"
+#include "BlockMultiplier.h"
+#include <stdexcept>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+namespace {
+
+template <class BlockHandlerT>
+class BlockQuantizedGemm : public QuantizedGemm
+{
+    typedef BlockMultiplier<BlockHandlerT> Multiplier;
+
+    Multiplier m_multiplier;
+    short* m_preparedB; // B rewritten in block order, owned by us
+    int m_k, m_n;
+
+public:
+    BlockQuantizedGemm()
+        : m_multiplier(omp_get_max_threads()), m_preparedB(nullptr), m_k(0), m_n(0)
+    {
+    }
+
+    ~BlockQuantizedGemm()
+    {
+        if (m_preparedB)
+            Multiplier::FreeMatrix(m_preparedB);
+    }
+
+    virtual void PrepareB(const short* B, int k, int n) override
+    {
+        if (m_preparedB)
+            Multiplier::FreeMatrix(m_preparedB);
+        m_preparedB = nullptr; // (in case PrepareB() throws)
+        m_preparedB = m_multiplier.PrepareB(const_cast<short*>(B), k, n);
+        m_k = k;
+        m_n = n;
+    }
+
+    virtual void Multiply(const short* A, int m, int k, int n, int32_t* C) override
+    {
+        if (!m_preparedB || k != m_k || n != m_n)
+            throw std::logic_error("QuantizedGemm::Multiply: the dimensions do not match the prepared B matrix.");
+
+        // MultiplyMatrices() accumulates into C
+        memset(C, 0, sizeof(int32_t) * m * n);
+        m_multiplier.MultiplyMatrices(const_cast<short*>(A), m, k, m_preparedB, n, C);
+    }
+};
+
+}
+
+}}}
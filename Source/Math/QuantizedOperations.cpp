@@ -0,0 +1,82 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// QuantizedOperations.cpp : runtime selection of the integer GEMM kernels for the quantized multipliers, and the SSE kernels
+//
+// This file is compiled for the baseline instruction set. It must not use AVX2 itself.
+//
+
+#include "stdafx.h"
+#include "QuantizedGemmImpl.h"
+#include <smmintrin.h>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+QuantizedGemm::~QuantizedGemm()
+{
+}
+
+/*static*/ std::unique_ptr<QuantizedGemm> QuantizedGemm::Create(CPUInstructionSet instructionSet)
+{
+    if ((int) instructionSet > (int) CPUVectorizedTensorOps::GetSupportedInstructionSet())
+        instructionSet = CPUVectorizedTensorOps::GetSupportedInstructionSet();
+    if (instructionSet >= CPUInstructionSet::AVX2)
+        return std::unique_ptr<QuantizedGemm>(NewAVX2());
+    return std::unique_ptr<QuantizedGemm>(NewSSE());
+}
+
+/*static*/ std::unique_ptr<QuantizedGemm> QuantizedGemm::Create()
+{
+    return Create(CPUVectorizedTensorOps::GetInstructionSet());
+}
+
+/*static*/ QuantizedGemm* QuantizedGemm::NewSSE()
+{
+    return new BlockQuantizedGemm<BlockHandlerSSE>();
+}
+
+/*static*/ void Int8Gemm::Multiply(const int8_t* A, const int8_t* B, int m, int n, int k, int32_t* C, CPUInstructionSet instructionSet)
+{
+    if ((int) instructionSet > (int) CPUVectorizedTensorOps::GetSupportedInstructionSet())
+        instructionSet = CPUVectorizedTensorOps::GetSupportedInstructionSet();
+    if (instructionSet >= CPUInstructionSet::AVX2)
+        MultiplyAVX2(A, B, m, n, k, C);
+    else
+        MultiplySSE(A, B, m, n, k, C);
+}
+
+/*static*/ void Int8Gemm::Multiply(const int8_t* A, const int8_t* B, int m, int n, int k, int32_t* C)
+{
+    Multiply(A, B, m, n, k, C, CPUVectorizedTensorOps::GetInstructionSet());
+}
+
+// sum_l a[l] * b[l], 16 elements per step: sign-extend to 16 bits, multiply and add adjacent pairs into 32 bits
+static int32_t DotProductSSE(const int8_t* a, const int8_t* b, int k)
+{
+    __m128i sum = _mm_setzero_si128();
+    int l = 0;
+    for (; l + 16 <= k; l += 16)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i*) (a + l));
+        __m128i vb = _mm_loadu_si128((const __m128i*) (b + l));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_cvtepi8_epi16(va), _mm_cvtepi8_epi16(vb)));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_cvtepi8_epi16(_mm_srli_si128(va, 8)), _mm_cvtepi8_epi16(_mm_srli_si128(vb, 8))));
+    }
+    sum = _mm_hadd_epi32(sum, sum);
+    sum = _mm_hadd_epi32(sum, sum);
+    int32_t result = _mm_cvtsi128_si32(sum);
+    for (; l < k; l++)
+        result += a[l] * b[l];
+    return result;
+}
+
+/*static*/ void Int8Gemm::MultiplySSE(const int8_t* A, const int8_t* B, int m, int n, int k, int32_t* C)
+{
+#pragma omp parallel for if ((int64_t) m * n * k >= 65536)
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            C[i + (size_t) j * m] = DotProductSSE(A + (size_t) i * k, B + (size_t) j * k, k);
+}
+
+}}}
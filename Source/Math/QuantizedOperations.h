@@ -4,9 +4,57 @@
 //
 #pragma once
 #include "Quantizers.h"
+#include "CPUVectorizedTensorOps.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdint.h>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// Product of 16-bit integer matrices, C[m,n] = A[m,k] * B[k,n], with all matrices in row-major order and 32-bit
+// results. It is implemented with BlockMultiplier, which rewrites B into its block order once in PrepareB(), so that
+// multiplying by the same B repeatedly (e.g. by a weight matrix) does not pay for that again.
+class MATH_API QuantizedGemm
+{
+public:
+    virtual ~QuantizedGemm();
+
+    // rewrite B[k,n] for the following calls to Multiply()
+    virtual void PrepareB(const short* B, int k, int n) = 0;
+    // C[m,n] = A[m,k] * B[k,n] with the prepared B; C is overwritten
+    virtual void Multiply(const short* A, int m, int k, int n, int32_t* C) = 0;
+
+    // Create the implementation for the given instruction set: AVX2 kernels for CPUInstructionSet::AVX2 and above,
+    // SSE kernels otherwise. Requests beyond what the CPU supports are clamped.
+    static std::unique_ptr<QuantizedGemm> Create(CPUInstructionSet instructionSet);
+    // same for the instruction set currently selected for the CPU kernels (CPUVectorizedTensorOps::GetInstructionSet())
+    static std::unique_ptr<QuantizedGemm> Create();
+
+private:
+    // implemented in the per-instruction-set translation units
+    static QuantizedGemm* NewSSE();
+    static QuantizedGemm* NewAVX2();
+};
+
+// Product of 8-bit integer matrices with 32-bit results, C[i + j*m] = sum_l A[i*k + l] * B[j*k + l] for A[m,k] in
+// row-major and B[k,n] in column-major order, i.e. the rows of A and the columns of B are contiguous, and C[m,n] is in
+// column-major order. This is the layout of a weight matrix that was transposed once when it was quantized, times
+// CNTK's (column-major) activations.
+// Values are expected in [-127, 127], so that sums of pairs of products can not overflow in 16-bit lanes.
+class MATH_API Int8Gemm
+{
+public:
+    // C is overwritten; with AVX2 kernels for CPUInstructionSet::AVX2 and above, SSE kernels otherwise
+    static void Multiply(const int8_t* A, const int8_t* B, int m, int n, int k, int32_t* C, CPUInstructionSet instructionSet);
+    // same for the instruction set currently selected for the CPU kernels
+    static void Multiply(const int8_t* A, const int8_t* B, int m, int n, int k, int32_t* C);
+
+private:
+    static void MultiplySSE(const int8_t* A, const int8_t* B, int m, int n, int k, int32_t* C);
+    static void MultiplyAVX2(const int8_t* A, const int8_t* B, int m, int n, int k, int32_t* C);
+};
+
 
 // Quantized product of two dense matrices A and B, where each matrix has its own quantizer.
 // This class handles quantization of both matrices, product and de-quantization of the result.
@@ -29,9 +77,27 @@ class QuantizedMultiplier
 
     bool m_firstPass;
 
+    // The integer product, created on first use. Only its right-hand side can be prepared ahead of time, so it is
+    // applied to whichever of A and B is constant (see Multiply()); m_preparedOperand tells which one that currently
+    // is (0 = A, 1 = B, -1 = none).
+    std::unique_ptr<QuantizedGemm> m_pGemm;
+    int m_preparedOperand;
+
+    // row-major copies of A or B, as needed, and the integer result
+    vector<short> m_transposed;
+    vector<int32_t> m_result;
+
+    // dst[c,r] = src[r,c], with src a row-major [rows,cols] matrix
+    static void Transpose(const short* src, int rows, int cols, short* dst)
+    {
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+                dst[c * rows + r] = src[r * cols + c];
+    }
+
 public: 
     QuantizedMultiplier(shared_ptr<QuantizerBase<ElemType, short>> pQuantizerA, bool isAConstant, shared_ptr<QuantizerBase<ElemType, short>> pQuantizerB, bool isBConstant) :
-        m_pQuantizerA(pQuantizerA), m_pQuantizerB(pQuantizerB), m_isAConstant(isAConstant), m_isBConstant(isBConstant), m_firstPass(true)
+        m_pQuantizerA(pQuantizerA), m_pQuantizerB(pQuantizerB), m_isAConstant(isAConstant), m_isBConstant(isBConstant), m_firstPass(true), m_preparedOperand(-1)
     {
         if (isAConstant && isBConstant)
             LogicError("Quantized multiplication is applied to two constant matrices -- it is highly inefficient. Better approach is to replace the operation with the resulting matrix.");
@@ -40,19 +106,22 @@ public:
         QuantizedMultiplier(pQuantizerA, false, pQuantizerB, false)
     {
     };
+    virtual ~QuantizedMultiplier() {}
 
     // A[m,k]*B[k,n] = C[m,n]
-    void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C)
+    virtual void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C)
     {
         // Quantize
-        if (!m_isAConstant || m_firstPass)
+        bool isAUpdated = !m_isAConstant || m_firstPass;
+        if (isAUpdated)
         {
             m_pMatA.resize(m*k);
             ArrayRef<short> refMatA(m_pMatA.data(), m_pMatA.size());
             m_pQuantizerA->Quantize(ArrayRef<ElemType>(A, m_pMatA.size()), refMatA);
         }
         
-        if (!m_isBConstant || m_firstPass)
+        bool isBUpdated = !m_isBConstant || m_firstPass;
+        if (isBUpdated)
         {
             m_pMatB.resize(n*k);
             ArrayRef<short> refMatB(m_pMatB.data(), m_pMatB.size());
@@ -62,22 +131,47 @@ public:
         m_firstPass = false;
 
         // Do multiply
-        // Naive inefficient product, just for demonstation
-        // TODO: replace with an efficient version, e.g. IPG, block multiplier, Eigen, gemmlowp, etc.
-        for (size_t i = 0; i < m; i++)
-            for (size_t j = 0; j < n; j++)
+        if (!m_pGemm)
+            m_pGemm = QuantizedGemm::Create();
+        int mn = m*n;
+        m_result.resize(mn);
+
+        // CNTK is using column-major storage, and the column-major storage of a matrix is the row-major storage of its
+        // transpose. So normally we compute C^T[n,m] = B^T[n,k] * A^T[k,m] directly on the quantized matrices, with A
+        // (typically the weights) prepared as the right-hand side, and get C in column-major order.
+        // If B is the constant one instead, we compute C[m,n] = A[m,k] * B[k,n] on row-major copies of A and B,
+        // so that B can be prepared once, and transpose the result.
+        if (m_isBConstant && !m_isAConstant)
+        {
+            if (isBUpdated || m_preparedOperand != 1)
             {
-                int dotProduct=0;
-                for (size_t l = 0; l < k; l++)
-                {
-                    // CNTK is using column-major storage
-                    dotProduct += m_pMatA[i + l*m] * m_pMatB[l + k*j];
-                }
-                C[i + j*m] = (ElemType)dotProduct;
+                m_transposed.resize(n*k);
+                Transpose(m_pMatB.data(), n, k, m_transposed.data());
+                m_pGemm->PrepareB(m_transposed.data(), k, n);
+                m_preparedOperand = 1;
             }
+            m_transposed.resize(m*k);
+            Transpose(m_pMatA.data(), k, m, m_transposed.data());
+            m_pGemm->Multiply(m_transposed.data(), m, k, n, m_result.data());
+
+            for (int i = 0; i < m; i++)
+                for (int j = 0; j < n; j++)
+                    C[i + j*m] = (ElemType)m_result[i*n + j];
+        }
+        else
+        {
+            if (isAUpdated || m_preparedOperand != 0)
+            {
+                m_pGemm->PrepareB(m_pMatA.data(), k, m);
+                m_preparedOperand = 0;
+            }
+            m_pGemm->Multiply(m_pMatB.data(), n, k, m, m_result.data());
+
+            for (int i = 0; i < mn; i++)
+                C[i] = (ElemType)m_result[i];
+        }
 
         // De-quantize
-        int mn = m*n;
         m_pQuantizerB->Dequantize(C, C, mn);
         m_pQuantizerA->Dequantize(C, C, mn);
     }
@@ -86,4 +180,142 @@ public:
     void SetIsBConstant(bool v) { m_isBConstant = v; }
 };
 
+// Post-training 8-bit quantization of the product A[m,k] * B[k,n] of a constant weight matrix A and activations B.
+// The weights are quantized once, with one scale per output row (channel), absmax(row) / 127. The activations are
+// quantized with a single scale, range / 127, where the range is calibrated ahead of time (by SetInputRange(), or as
+// the largest absolute value seen between StartCalibration() and EndCalibration()); activations beyond it are clipped.
+// Without a calibrated range, the largest absolute value of each minibatch is used.
+template <class ElemType>
+class Int8QuantizedMultiplier : public QuantizedMultiplier<ElemType>
+{
+    typedef QuantizedMultiplier<ElemType> Base;
+
+    // the weights in row-major order, and the scale of each row; copies of the multiplier share them
+    struct Weights
+    {
+        vector<int8_t> m_values;
+        vector<float> m_scales;
+        int m_rows, m_cols;
+    };
+    shared_ptr<const Weights> m_weights;
+
+    // placeholders for the quantized activations and the integer product
+    vector<int8_t> m_input;
+    vector<int32_t> m_result;
+
+    float m_inputRange; // 0 if not calibrated
+    bool m_isCalibrating;
+    float m_observedInputRange;
+
+    static int8_t Round(ElemType v)
+    {
+        if (v > 127)
+            return 127;
+        if (v < -127)
+            return -127;
+        return (int8_t) (v >= 0 ? v + (ElemType) 0.5 : v - (ElemType) 0.5);
+    }
+
+    static ElemType AbsMax(const ElemType* data, size_t size)
+    {
+        ElemType absMax = 0;
+        for (size_t i = 0; i < size; i++)
+            absMax = std::max(absMax, (ElemType) fabs(data[i]));
+        return absMax;
+    }
+
+public:
+    Int8QuantizedMultiplier(float inputRange = 0) :
+        Base(nullptr, true, nullptr, false), m_inputRange(inputRange), m_isCalibrating(false), m_observedInputRange(0)
+    {
+    }
+
+    // A[m,k] in column-major order
+    void QuantizeWeights(int m, int k, const ElemType* A)
+    {
+        auto weights = make_shared<Weights>();
+        weights->m_values.resize((size_t) m * k);
+        weights->m_scales.resize(m);
+        for (int i = 0; i < m; i++)
+        {
+            ElemType absMax = 0;
+            for (int l = 0; l < k; l++)
+                absMax = std::max(absMax, (ElemType) fabs(A[i + (size_t) l * m]));
+            float scale = absMax > 0 ? (float) absMax / 127 : 1.0f;
+            ElemType invScale = (ElemType) (1 / scale);
+            for (int l = 0; l < k; l++)
+                weights->m_values[(size_t) i * k + l] = Round(A[i + (size_t) l * m] * invScale);
+            weights->m_scales[i] = scale;
+        }
+        weights->m_rows = m;
+        weights->m_cols = k;
+        m_weights = weights;
+    }
+
+    // A[m,k]*B[k,n] = C[m,n], with A the weights; A is only read if the weights of these dimensions are not quantized yet
+    virtual void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C) override
+    {
+        if (!m_weights || m != m_weights->m_rows || k != m_weights->m_cols)
+        {
+            if (!A)
+                LogicError("Int8QuantizedMultiplier: The weights of the product [%d x %d] are not quantized.", m, k);
+            QuantizeWeights(m, k, A);
+        }
+
+        size_t inputSize = (size_t) k * n;
+        float range = m_inputRange;
+        if (m_isCalibrating || range <= 0)
+        {
+            ElemType absMax = AbsMax(B, inputSize);
+            if (m_isCalibrating)
+                m_observedInputRange = std::max(m_observedInputRange, (float) absMax);
+            range = (float) absMax;
+        }
+        float inputScale = range > 0 ? range / 127 : 1.0f;
+        ElemType invInputScale = (ElemType) (1 / inputScale);
+
+        m_input.resize(inputSize);
+        for (size_t i = 0; i < inputSize; i++)
+            m_input[i] = Round(B[i] * invInputScale);
+
+        m_result.resize((size_t) m * n);
+        Int8Gemm::Multiply(m_weights->m_values.data(), m_input.data(), m, n, k, m_result.data());
+
+        // De-quantize
+        for (int j = 0; j < n; j++)
+            for (int i = 0; i < m; i++)
+                C[i + (size_t) j * m] = (ElemType) (m_result[i + (size_t) j * m] * m_weights->m_scales[i] * inputScale);
+    }
+
+    // Calibration of the activation range: between these calls, the product runs with per-minibatch ranges, and the
+    // largest one becomes the calibrated range.
+    void StartCalibration()
+    {
+        m_isCalibrating = true;
+        m_observedInputRange = 0;
+    }
+    void EndCalibration()
+    {
+        m_isCalibrating = false;
+        if (m_observedInputRange > 0)
+            m_inputRange = m_observedInputRange;
+    }
+
+    float InputRange() const { return m_inputRange; }
+    void SetInputRange(float inputRange) { m_inputRange = inputRange; }
+
+    // the weights are quantized again on the next call, e.g. after they were changed
+    void InvalidateWeights() { m_weights = nullptr; }
+
+    // uses the quantized weights of another multiplier, without copying them
+    void ShareWeights(const Int8QuantizedMultiplier& other) { m_weights = other.m_weights; }
+
+    bool AreWeightsQuantized() const { return m_weights != nullptr; }
+    int WeightRows() const { return m_weights ? m_weights->m_rows : 0; }
+    int WeightCols() const { return m_weights ? m_weights->m_cols : 0; }
+
+    // memory taken by the quantized weights and their scales, 0 before the first product
+    size_t QuantizedWeightBytes() const { return m_weights ? m_weights->m_values.size() * sizeof(int8_t) + m_weights->m_scales.size() * sizeof(float) : 0; }
+};
+
 }}}
\ No newline at end of file
@@ -0,0 +1,66 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// QuantizedOperationsAVX2.cpp : AVX2 integer GEMM kernels for the quantized multipliers
+//
+// This file is compiled with AVX2 enabled (-mavx2, see Makefile), and its code is only used after CPUID has confirmed
+// support. Do not include stdafx.h or call inline functions from other headers here, since the linker could pick this
+// file's AVX2 copy of them for the rest of the library.
+//
+
+#ifndef SUPPORT_AVX2
+#define SUPPORT_AVX2 // makes BlockMultiplier.h include the AVX2 block handler
+#endif
+#include "QuantizedGemmImpl.h"
+#include <immintrin.h>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+/*static*/ QuantizedGemm* QuantizedGemm::NewAVX2()
+{
+    return new BlockQuantizedGemm<BlockHandlerAVX>();
+}
+
+namespace {
+
+// sum_l a[l] * b[l], 32 elements per step (see DotProductSSE())
+int32_t DotProductAVX2(const int8_t* a, const int8_t* b, int k)
+{
+    __m256i sum0 = _mm256_setzero_si256();
+    __m256i sum1 = _mm256_setzero_si256();
+    int l = 0;
+    for (; l + 32 <= k; l += 32)
+    {
+        sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a + l))),
+                                                         _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (b + l)))));
+        sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a + l + 16))),
+                                                         _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (b + l + 16)))));
+    }
+    if (l + 16 <= k)
+    {
+        sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a + l))),
+                                                         _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (b + l)))));
+        l += 16;
+    }
+    sum0 = _mm256_add_epi32(sum0, sum1);
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sum0), _mm256_extracti128_si256(sum0, 1));
+    sum = _mm_hadd_epi32(sum, sum);
+    sum = _mm_hadd_epi32(sum, sum);
+    int32_t result = _mm_cvtsi128_si32(sum);
+    for (; l < k; l++)
+        result += a[l] * b[l];
+    return result;
+}
+
+}
+
+/*static*/ void Int8Gemm::MultiplyAVX2(const int8_t* A, const int8_t* B, int m, int n, int k, int32_t* C)
+{
+#pragma omp parallel for if ((int64_t) m * n * k >= 65536)
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            C[i + (size_t) j * m] = DotProductAVX2(A + (size_t) i * k, B + (size_t) j * k, k);
+}
+
+}}}
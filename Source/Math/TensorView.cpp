@@ -285,6 +285,55 @@ void TensorView<ElemType>::DoTernaryOpOf(ElemType beta, const TensorView& a, con
     GetSOB().TensorOp(beta, a.GetSOB(), b.GetSOB(), c.GetSOB(), alpha, op, reductionOp, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
 }
 
+template <class ElemType>
+void TensorView<ElemType>::DoFusedElementwiseOpOf(ElemType beta, const vector<TensorView>& inputs, const FusedTensorOpProgram& program, ElemType alpha)
+{
+    program.Verify(inputs.size());
+
+    // prepare all tensor descriptor information as needed for execution
+    // Operand slots not used by the program replicate the output, which does not affect dimension flattening.
+    const size_t N = FusedTensorOpMaxOperands;
+    array<TensorShape, N> shapes;
+    for (size_t i = 0; i < N; i++)
+        shapes[i] = i < inputs.size() ? inputs[i].GetShape() : GetShape();
+    array<size_t, N> offsets;
+    array<SmallVector<ptrdiff_t>, N> regularStrides, reducingStrides;
+    SmallVector<size_t> regularOpDims, reducingOpDims;
+    PrepareTensorOperands<ElemType, N>(shapes, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+
+    if (reducingOpDims.size() > 0)
+        InvalidArgument("DoFusedElementwiseOpOf: Fused elementwise operations cannot reduce, but output shape %s is smaller than the operation shape.", string(GetShape()).c_str());
+
+    bool isOnCPU = GetSOB().GetDeviceId() == CPUDEVICE;
+    for (const auto& input : inputs)
+        isOnCPU &= input.GetSOB().GetDeviceId() == CPUDEVICE;
+
+    if (isOnCPU)
+    {
+        vector<const Matrix<ElemType>*> matrices;
+        for (const auto& input : inputs)
+            matrices.push_back(&input.GetSOB());
+        GetSOB().FusedTensorOp(beta, matrices, alpha, program, offsets, regularOpDims, regularStrides);
+        return;
+    }
+
+    // other devices: execute step by step, with a temporary of the output's (dense) shape for each step
+    TensorShape tempShape(GetShape().GetDims());
+    vector<TensorView> registers(inputs);
+    for (const auto& step : program.steps)
+    {
+        TensorView temp(make_shared<Matrix<ElemType>>(tempShape.GetNumElements(), 1, GetSOB().GetDeviceId()), tempShape);
+        switch (step.numArgs)
+        {
+        case 1: temp.DoUnaryOpOf  (0, registers[step.args[0]],                                                     1, step.op, ElementWiseOperator::opSum); break;
+        case 2: temp.DoBinaryOpOf (0, registers[step.args[0]], registers[step.args[1]],                            1, step.op, ElementWiseOperator::opSum); break;
+        case 3: temp.DoTernaryOpOf(0, registers[step.args[0]], registers[step.args[1]], registers[step.args[2]],   1, step.op, ElementWiseOperator::opSum); break;
+        }
+        registers.push_back(temp);
+    }
+    DoUnaryOpOf(beta, registers[program.resultRegister], alpha, ElementWiseOperator::opCopy, ElementWiseOperator::opSum);
+}
+
 template <class ElemType>
 void TensorView<ElemType>::DoArgReductionOpOf(const TensorView& a, ElementWiseOperator reductionOp)
 {
@@ -134,6 +134,15 @@ public:
     void DoBinaryOpOf (ElemType beta, const TensorView& a, const TensorView& b,                      ElemType alpha, ElementWiseOperator op, ElementWiseOperator reductionOp);
     void DoTernaryOpOf(ElemType beta, const TensorView& a, const TensorView& b, const TensorView& c, ElemType alpha, ElementWiseOperator op, ElementWiseOperator reductionOp);
 
+    // -------------------------------------------------------------------
+    // fused elementwise operations
+    // Evaluates a FusedTensorOpProgram (see CommonMatrix.h) over the inputs in a single pass, without materializing
+    // intermediate results, and stores beta * this + alpha * result. Inputs can broadcast, but there is no reduction.
+    // On the CPU, this is a single traversal; on other devices, the program is executed step by step.
+    // -------------------------------------------------------------------
+
+    void DoFusedElementwiseOpOf(ElemType beta, const std::vector<TensorView>& inputs, const FusedTensorOpProgram& program, ElemType alpha);
+
     // -------------------------------------------------------------------
     // arg based operations
     // -------------------------------------------------------------------
@@ -19,6 +19,9 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <stdio.h>
 #ifndef CPUONLY
 #include <cuda_runtime_api.h>
@@ -67,6 +70,8 @@ static const FixedEventDesc c_fixedEvtDesc[profilerEvtMax] = {
     { "", profilerEvtSeparator, false },                            // profilerSepSpace2
 
     { "Prefetch Minibatch", profilerEvtTime, false },               // profilerEvtPrefetchMinibatch
+    { "Wait for Chunk", profilerEvtTime, false },                   // profilerEvtWaitForChunk
+    { "Load Chunk", profilerEvtTime, false },                       // profilerEvtLoadChunk
 };
 
 
@@ -92,6 +97,38 @@ struct CustomEventRecord
 };
 
 
+//
+// Per-node profiling: one record per node event for the trace, and the totals per node and pass for the summary.
+//
+struct NodeEventRecord
+{
+    int             nodeIndex;    // index into ProfilerState::nodes
+    bool            backward;
+    unsigned int    threadId;
+    long long       beginClock;
+    long long       endClock;
+    double          flops;
+    long long       bytes;
+};
+
+struct NodePassRecord
+{
+    int             cnt;          // event count
+    long long       sum;          // time (ticks)
+    long long       min;
+    long long       max;
+    double          flops;        // sum over all events
+    long long       bytes;        // max over all events
+};
+
+struct NodeRecord
+{
+    std::wstring    nodeName;
+    std::wstring    operationName;
+    NodePassRecord  passes[2];    // forward, backward
+};
+
+
 //
 // Global state of the profiler
 //
@@ -107,6 +144,11 @@ struct ProfilerState
     unsigned long long      customEventBufferBytes;      // Number of bytes allocated for the custom event buffer
     unsigned long long      customEventOffset;           // Offset to current place in buffer
     unique_ptr<char[]>      customEventBuffer;           // Pointer to custom event buffer
+    bool                    nodeTracing;                 // Record per-node events of the network traversal
+    bool                    nodeEventBufferFull;         // Node events are limited to customEventBufferBytes, too
+    std::vector<NodeEventRecord> nodeEvents;             // Node events for the trace
+    std::vector<NodeRecord> nodes;                       // Totals per node for the summary
+    std::unordered_map<std::wstring, int> nodeIndices;   // Node name -> index into nodes
 };
 
 
@@ -124,6 +166,8 @@ void FormatTimeStr(char* str, size_t strLen, double value);
 void FormatThroughputStr(char* str, size_t strLen, double value);
 void FormatBytesStr(char* str, size_t strLen, long long bytes);
 void ProfilerGenerateDetailFile(const std::wstring& fileName);
+void ProfilerGenerateNodeReport(const std::wstring& fileName, struct tm* timeInfo);
+void ProfilerGenerateTraceFile(const std::wstring& fileName);
 
 
 double TicksToSeconds(long long ticks)
@@ -166,6 +210,9 @@ void PERF_PROFILER_API ProfilerInit(const std::wstring& profilerDir, const unsig
     g_profilerState->syncGpu = syncGpu;
     g_profilerState->enabled = false;
 
+    g_profilerState->nodeTracing = false;
+    g_profilerState->nodeEventBufferFull = false;
+
     if (_wmkdir(g_profilerState->profilerDir.c_str()) == -1 && errno != EEXIST)
     {
         RuntimeError("Error: ProfilerInit: Cannot create directory <%ls>.\n", g_profilerState->profilerDir.c_str());
@@ -342,6 +389,88 @@ void PERF_PROFILER_API ProfilerThroughputEnd(const long long stateId, const int
 }
 
 
+//
+// Per-node profiling of the network traversal.
+//
+void PERF_PROFILER_API ProfilerEnableNodeTracing(bool enable)
+{
+    // A nullptr state indicates that the profiler is globally disabled, and not initialized
+    if (g_profilerState == nullptr)
+        return;
+
+    g_profilerState->nodeTracing = enable;
+}
+
+
+bool PERF_PROFILER_API ProfilerNodeTracingActive()
+{
+    return g_profilerState != nullptr && g_profilerState->enabled && g_profilerState->nodeTracing;
+}
+
+
+void PERF_PROFILER_API ProfilerNodeTimeEnd(const long long stateId, const wchar_t* nodeName, const wchar_t* operationName,
+    const bool backward, const double flops, const long long bytes)
+{
+    // A nullptr state indicates that the profiler is globally disabled, and not initialized
+    if (g_profilerState == nullptr)
+        return;
+
+    ProfilerSyncGpu();
+    long long endClock = Clock::GetTimeStamp();
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    if (!g_profilerState->enabled || !g_profilerState->nodeTracing)
+        return;
+
+    auto iter = g_profilerState->nodeIndices.find(nodeName);
+    if (iter == g_profilerState->nodeIndices.end())
+    {
+        NodeRecord node = {};
+        node.nodeName = nodeName;
+        node.operationName = operationName;
+        g_profilerState->nodes.push_back(node);
+        iter = g_profilerState->nodeIndices.insert(std::make_pair(std::wstring(nodeName), (int)g_profilerState->nodes.size() - 1)).first;
+    }
+    int nodeIndex = iter->second;
+
+    // the totals are always kept, also when the trace is full
+    long long delta = endClock - stateId;
+    auto& pass = g_profilerState->nodes[nodeIndex].passes[backward ? 1 : 0];
+    if (pass.cnt == 0)
+    {
+        pass.min = delta;
+        pass.max = delta;
+    }
+    pass.min = std::min(delta, pass.min);
+    pass.max = std::max(delta, pass.max);
+    pass.sum += delta;
+    pass.flops += flops;
+    pass.bytes = std::max(bytes, pass.bytes);
+    pass.cnt++;
+
+    if ((g_profilerState->nodeEvents.size() + 1) * sizeof(NodeEventRecord) > g_profilerState->customEventBufferBytes)
+    {
+        if (!g_profilerState->nodeEventBufferFull)
+        {
+            fprintf(stderr, "Warning: Performance Profiler: Node event buffer is full, no more node events will be traced.\n");
+            g_profilerState->nodeEventBufferFull = true;
+        }
+        return;
+    }
+
+    NodeEventRecord eventRecord;
+    eventRecord.nodeIndex = nodeIndex;
+    eventRecord.backward = backward;
+    eventRecord.threadId = GetThreadId();
+    eventRecord.beginClock = stateId;
+    eventRecord.endClock = endClock;
+    eventRecord.flops = flops;
+    eventRecord.bytes = bytes;
+    g_profilerState->nodeEvents.push_back(eventRecord);
+}
+
+
 //
 // Generate reports and release all resources.
 //
@@ -366,6 +495,16 @@ void PERF_PROFILER_API ProfilerClose()
     fileName = g_profilerState->profilerDir + L"/" + std::wstring(timeStr) + L"_detail_" + g_profilerState->logSuffix + L".csv";
     ProfilerGenerateDetailFile(fileName);
 
+    // Generate per-node summary and the trace of all events
+    if (!g_profilerState->nodes.empty())
+    {
+        fileName = g_profilerState->profilerDir + L"/" + std::wstring(timeStr) + L"_nodes_" + g_profilerState->logSuffix + L".txt";
+        ProfilerGenerateNodeReport(fileName, timeInfo);
+
+        fileName = g_profilerState->profilerDir + L"/" + std::wstring(timeStr) + L"_trace_" + g_profilerState->logSuffix + L".json";
+        ProfilerGenerateTraceFile(fileName);
+    }
+
     g_profilerState.reset();
 }
 
@@ -555,6 +694,165 @@ void ProfilerGenerateDetailFile(const std::wstring& fileName)
 }
 
 
+//
+// Generate per-node summary report, sorted by the total time of each node and pass.
+//
+void ProfilerGenerateNodeReport(const std::wstring& fileName, struct tm* timeInfo)
+{
+    FILE* f = _wfopen(fileName.c_str(), L"wt");
+    if (f == NULL)
+    {
+        RuntimeError("Error: ProfilerGenerateNodeReport: Cannot create file <%ls>.\n", fileName.c_str());
+    }
+
+    fprintfOrDie(f, "CNTK Performance Profiler Node Report\n\n");
+    char timeStr[32];
+    strftime(timeStr, sizeof(timeStr), "%Y/%m/%d %H:%M:%S", timeInfo);
+    fprintfOrDie(f, "Time Stamp: %s\n\n", timeStr);
+
+    const auto& nodes = g_profilerState->nodes;
+    std::vector<std::pair<int, int>> entries; // (node index, pass)
+    long long totalTicks = 0;
+    for (int nodeIdx = 0; nodeIdx < (int)nodes.size(); nodeIdx++)
+    {
+        for (int pass = 0; pass < 2; pass++)
+        {
+            if (nodes[nodeIdx].passes[pass].cnt > 0)
+            {
+                entries.push_back(std::make_pair(nodeIdx, pass));
+                // nested nodes of recurrent loops are also contained in the time of their loop
+                if (nodes[nodeIdx].operationName != L"SEQTraversalFlowControlNode")
+                    totalTicks += nodes[nodeIdx].passes[pass].sum;
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [&nodes](const std::pair<int, int>& a, const std::pair<int, int>& b)
+    {
+        return nodes[a.first].passes[a.second].sum > nodes[b.first].passes[b.second].sum;
+    });
+
+    fprintfOrDie(f, "Pass.... ...........Total ............Mean .............Min .............Max ...........Count ..Time ..GFLOP/s .........Bytes Node (Operation)\n\n");
+
+    for (const auto& entry : entries)
+    {
+        const auto& node = nodes[entry.first];
+        const auto& pass = node.passes[entry.second];
+        char str[32];
+
+        fprintfOrDie(f, "%-8s ", entry.second == 0 ? "Forward" : "Backward");
+
+        double sum = TicksToSeconds(pass.sum);
+        FormatTimeStr(str, sizeof(str), sum);
+        fprintfOrDie(f, "%s ", str);
+
+        FormatTimeStr(str, sizeof(str), sum / pass.cnt);
+        fprintfOrDie(f, "%s ", str);
+
+        FormatTimeStr(str, sizeof(str), TicksToSeconds(pass.min));
+        fprintfOrDie(f, "%s ", str);
+
+        FormatTimeStr(str, sizeof(str), TicksToSeconds(pass.max));
+        fprintfOrDie(f, "%s ", str);
+
+        fprintfOrDie(f, "%16d ", pass.cnt);
+        fprintfOrDie(f, "%5.1f%% ", totalTicks > 0 ? 100.0 * pass.sum / totalTicks : 0.0);
+        fprintfOrDie(f, "%9.2f ", sum > 0 ? pass.flops / sum / 1e9 : 0.0);
+        fprintfOrDie(f, "%14lld ", pass.bytes);
+        fprintfOrDie(f, "%ls (%ls)\n", node.nodeName.c_str(), node.operationName.c_str());
+    }
+
+    fclose(f);
+}
+
+
+//
+// Chrome trace helpers: strings are written as JSON, time stamps in microseconds.
+//
+void WriteJsonString(FILE* f, const std::string& str)
+{
+    std::string escaped = "\"";
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char buf[8];
+            sprintf_s(buf, sizeof(buf), "\\u%04x", (unsigned int)(unsigned char)c);
+            escaped += buf;
+        }
+        else
+            escaped += c;
+    }
+    escaped += '"';
+    fprintfOrDie(f, "%s", escaped.c_str());
+}
+
+double TicksToMicroseconds(long long ticks)
+{
+    return 1e6 * TicksToSeconds(ticks);
+}
+
+
+//
+// Generate the trace of all node events and custom events in the Chrome trace event format,
+// which can be loaded into chrome://tracing. The custom events include the fixed events.
+//
+void ProfilerGenerateTraceFile(const std::wstring& fileName)
+{
+    FILE* f = _wfopen(fileName.c_str(), L"wt");
+    if (f == NULL)
+    {
+        RuntimeError("Error: ProfilerGenerateTraceFile: Cannot create file <%ls>.\n", fileName.c_str());
+    }
+
+    fprintfOrDie(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+
+    char* eventPtr = g_profilerState->customEventBuffer.get();
+    while (eventPtr < (g_profilerState->customEventBuffer.get() + g_profilerState->customEventOffset))
+    {
+        char* descriptionStr = eventPtr;
+        eventPtr += strlen(descriptionStr) + 1;
+
+        CustomEventRecord* eventRecord = (CustomEventRecord*)eventPtr;
+        eventPtr += sizeof(CustomEventRecord);
+
+        fprintfOrDie(f, "%s{\"name\":", first ? "" : ",\n");
+        WriteJsonString(f, descriptionStr);
+        fprintfOrDie(f, ",\"cat\":\"profiler\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            eventRecord->threadId, TicksToMicroseconds(eventRecord->beginClock),
+            TicksToMicroseconds(eventRecord->endClock - eventRecord->beginClock));
+        first = false;
+    }
+
+    std::vector<std::string> nodeNames, operationNames;
+    for (const auto& node : g_profilerState->nodes)
+    {
+        nodeNames.push_back(msra::strfun::utf8(node.nodeName));
+        operationNames.push_back(msra::strfun::utf8(node.operationName));
+    }
+
+    for (const auto& eventRecord : g_profilerState->nodeEvents)
+    {
+        fprintfOrDie(f, "%s{\"name\":", first ? "" : ",\n");
+        WriteJsonString(f, nodeNames[eventRecord.nodeIndex]);
+        fprintfOrDie(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"operation\":",
+            eventRecord.backward ? "backward" : "forward", eventRecord.threadId, TicksToMicroseconds(eventRecord.beginClock),
+            TicksToMicroseconds(eventRecord.endClock - eventRecord.beginClock));
+        WriteJsonString(f, operationNames[eventRecord.nodeIndex]);
+        fprintfOrDie(f, ",\"flops\":%.0f,\"bytes\":%lld}}", eventRecord.flops, eventRecord.bytes);
+        first = false;
+    }
+
+    fprintfOrDie(f, "\n]}\n");
+    fclose(f);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Scoped helpers.
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,15 @@
 // and ProfilerThroughputEnd() calls should be used. The throughput APIs can only be used
 // with fixed events.
 //
+// Per-node profiling
+//
+// Calling ProfilerEnableNodeTracing() after ProfilerInit() makes the ComputationNetwork record one
+// event per node and forward/backward pass, with its wall time, a rough FLOP estimate and the bytes of
+// its value and gradient matrices. Nodes inside recurrent loops are recorded once per time step.
+// ProfilerClose() then additionally writes all events as a Chrome trace (JSON, for chrome://tracing),
+// and a summary of the nodes sorted by their total time. Without node tracing, the network only
+// calls ProfilerNodeTracingActive() once per node and pass.
+//
 // CNTK specifics
 //
 // The profiler is turned off during the very first epoch to avoid polluting profile data with
@@ -73,6 +82,8 @@ enum ProfilerEvents
 
     // Data reader events
     profilerEvtPrefetchMinibatch,           // Prefetching the next minibatch in a background thread
+    profilerEvtWaitForChunk,                // Waiting for a chunk the randomizer needs (prefetched or not)
+    profilerEvtLoadChunk,                   // Loading a chunk from the deserializer (on an I/O thread when prefetching)
 
     profilerEvtMax
 };
@@ -122,6 +133,16 @@ long long PERF_PROFILER_API ProfilerThroughputBegin();
 void PERF_PROFILER_API ProfilerThroughputEnd(const long long stateId, const int eventId, const long long bytes);
 
 
+//
+// Per-node profiling of the network traversal, see above.
+// ProfilerNodeTimeEnd() records a node event that started at ProfilerTimeBegin().
+//
+void PERF_PROFILER_API ProfilerEnableNodeTracing(bool enable);
+bool PERF_PROFILER_API ProfilerNodeTracingActive();
+void PERF_PROFILER_API ProfilerNodeTimeEnd(const long long stateId, const wchar_t* nodeName, const wchar_t* operationName,
+    const bool backward, const double flops, const long long bytes);
+
+
 //
 // Generate reports and release all resources.
 //
@@ -70,6 +70,9 @@ BinaryChunkDeserializer::BinaryChunkDeserializer(const BinaryConfigHelper& helpe
     SetTraceLevel(helper.GetTraceLevel());
 
     Initialize(helper.GetRename(), helper.GetElementType());
+
+    if (helper.ShouldUseMemoryMapping())
+        MapFile();
 }
 
 
@@ -154,6 +157,18 @@ void BinaryChunkDeserializer::Initialize(const std::map<std::wstring, std::wstri
     ReadChunkTable(m_file);
 }
 
+void BinaryChunkDeserializer::MapFile()
+{
+    m_mappedFile = make_shared<MappedFile>(m_filename);
+
+    // The chunk table was read from the file, make sure all chunks lie within the mapping.
+    if (m_numChunks > 0 && (uint64_t)m_chunkTable->GetOffset(m_numChunks) > m_mappedFile->Size())
+        RuntimeError("The chunk table of '%ls' refers to data beyond the end of the file.", m_filename.c_str());
+
+    if (m_traceLevel > 1)
+        fprintf(stderr, "Memory mapped '%ls' (%" PRIu64 " bytes).\n", m_filename.c_str(), m_mappedFile->Size());
+}
+
 std::vector<ChunkInfo> BinaryChunkDeserializer::ChunkInfos()
 {
     assert(m_chunkTable);
@@ -178,10 +193,15 @@ void BinaryChunkDeserializer::SequenceInfosForChunk(ChunkIdType chunkId, std::ve
     auto numberOfSequences = m_chunkTable->GetNumSequences(chunkId);
     unique_ptr<uint32_t[]> numSamplesPerSequence(new uint32_t[numberOfSequences]);
 
-    // Seek to the start of the chunk
-    CNTKBinaryFileHelper::SeekOrDie(m_file, offset, SEEK_SET);
-    // read 'numberOfSequences' unsigned ints
-    CNTKBinaryFileHelper::ReadOrDie(numSamplesPerSequence.get(), sizeof(uint32_t), numberOfSequences, m_file);
+    if (m_mappedFile)
+        memcpy(numSamplesPerSequence.get(), m_mappedFile->Data() + offset, sizeof(uint32_t) * numberOfSequences);
+    else
+    {
+        // Seek to the start of the chunk
+        CNTKBinaryFileHelper::SeekOrDie(m_file, offset, SEEK_SET);
+        // read 'numberOfSequences' unsigned ints
+        CNTKBinaryFileHelper::ReadOrDie(numSamplesPerSequence.get(), sizeof(uint32_t), numberOfSequences, m_file);
+    }
 
     auto startId = m_chunkTable->GetStartIndex(chunkId);
     for (decltype(numberOfSequences) i = 0; i < numberOfSequences; i++)
@@ -218,6 +238,16 @@ unique_ptr<byte[]> BinaryChunkDeserializer::ReadChunk(ChunkIdType chunkId)
 
 ChunkPtr BinaryChunkDeserializer::GetChunk(ChunkIdType chunkId)
 {
+    if (m_mappedFile)
+    {
+        // Chunks are usually requested ahead of time by the prefetching randomizer, so start reading in the
+        // pages now instead of faulting them in one by one while the chunk is parsed.
+        uint64_t offset = m_chunkTable->GetDataStartOffset(chunkId);
+        uint64_t size = m_chunkTable->GetChunkSize(chunkId);
+        m_mappedFile->Prefetch(offset, size, size >= s_sequentialAccessChunkSize);
+        return make_shared<BinaryDataChunk>(chunkId, m_chunkTable->GetNumSequences(chunkId), m_mappedFile, offset, m_deserializers);
+    }
+
     // Read the chunk into memory
     unique_ptr<byte[]> buffer = ReadChunk(chunkId);
 
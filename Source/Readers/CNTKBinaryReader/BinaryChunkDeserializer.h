@@ -10,9 +10,13 @@
 #include "CorpusDescriptor.h"
 #include "BinaryDataChunk.h"
 #include "BinaryDataDeserializer.h"
+#include "MappedFile.h"
 
 namespace CNTK {
 
+using Microsoft::MSR::CNTK::MappedFile;
+using Microsoft::MSR::CNTK::MappedFilePtr;
+
 // Chunk meta-info: byte offset in the inputfile, number of sequences and samples in the chunk.
 struct BinaryChunkInfo 
 {
@@ -108,6 +112,9 @@ private:
     // Reads a chunk from disk into buffer
     unique_ptr<byte[]> ReadChunk(ChunkIdType chunkId);
 
+    // Maps the input file into memory, chunks are then handed out without reading them into buffers.
+    void MapFile();
+
     BinaryChunkDeserializer(const wstring& filename);
 
     void SetTraceLevel(unsigned int traceLevel);
@@ -122,6 +129,9 @@ private:
     ChunkTablePtr m_chunkTable;
     void* m_chunkBuffer;
 
+    // The memory mapped input file (null, unless memory mapping is enabled).
+    MappedFilePtr m_mappedFile;
+
     
     uint32_t m_numChunks;
     uint32_t m_numInputs;
@@ -130,6 +140,9 @@ private:
 
     static const uint32_t s_currentVersion = 1;
 
+    // Mapped chunks of at least this size are read with sequential access advice.
+    static const uint64_t s_sequentialAccessChunkSize = 32 * 1024 * 1024;
+
     friend class CNTKBinaryReaderTestRunner;
 
 
@@ -10,9 +10,12 @@
 #include "CorpusDescriptor.h"
 #include "BinaryChunkDeserializer.h"
 #include "BinaryDataDeserializer.h"
+#include "MappedFile.h"
 
 namespace CNTK {
 
+using Microsoft::MSR::CNTK::MappedFilePtr;
+
 class BinaryDataChunk : public Chunk, public std::enable_shared_from_this<Chunk>
 {
 public:
@@ -23,6 +26,22 @@ public:
         : m_chunkId(chunkId),
         m_numSequences(numSequences), 
         m_buffer(std::move(buffer)), 
+        m_chunkData(m_buffer.get()),
+        m_deserializers(deserializer)
+    { }
+
+    // A chunk that is not read into a buffer, but points into the memory mapped input file.
+    // The sequences hand out pointers into the mapping, which the chunk keeps alive.
+    explicit BinaryDataChunk(ChunkIdType chunkId,
+        size_t numSequences,
+        MappedFilePtr file,
+        uint64_t dataOffset,
+        std::vector<BinaryDataDeserializerPtr> deserializer)
+        : m_chunkId(chunkId),
+        m_numSequences(numSequences),
+        m_mappedFile(file),
+        // The mapping is read-only, sequence data is never written to.
+        m_chunkData(reinterpret_cast<byte*>(const_cast<char*>(file->Data() + dataOffset))),
         m_deserializers(deserializer)
     { }
 
@@ -59,7 +78,7 @@ protected:
         size_t bytesProcessed = 0;
         // Now call all of the deserializers on the chunk, in order
         for (size_t i = 0; i < m_deserializers.size(); i++)
-            bytesProcessed += m_deserializers[i]->GetSequenceDataForChunk(m_numSequences, m_buffer.get() + bytesProcessed, m_data[i]);
+            bytesProcessed += m_deserializers[i]->GetSequenceDataForChunk(m_numSequences, m_chunkData + bytesProcessed, m_data[i]);
     }
 
     // chunk id (copied from the descriptor)
@@ -72,6 +91,12 @@ protected:
     // This is the actual chunk read from disk. We will call back to the deserializer for it to be deserialized
     unique_ptr<byte[]> m_buffer;
 
+    // The input file, if the chunk is memory mapped instead of read into m_buffer.
+    MappedFilePtr m_mappedFile;
+
+    // Start of the chunk data, in m_buffer or in the mapped file.
+    byte* m_chunkData;
+
     // This is the deserializer who knows how to interpret the m_data chunk that we read in
     std::vector<BinaryDataDeserializerPtr> m_deserializers;
     
@@ -45,6 +45,9 @@ CNTKBinaryReader::CNTKBinaryReader(const ConfigParameters& config)
                 << window 
                 << configHelper.UseSampleBasedRandomizationWindow() ? " samples" : " chunks";
             int verbosity = config(L"verbosity", 0);
+            auto prefetchConfig = GetChunkPrefetchConfigurationFromConfig(config);
+            // Mapped chunks are created without touching the shared file handle, so they can be loaded concurrently.
+            prefetchConfig.m_concurrentLoads = configHelper.ShouldUseMemoryMapping() && !configHelper.ShouldKeepDataInMemory();
             m_sequenceEnumerator = make_shared<BlockRandomizer>(
                 verbosity, /* verbosity */
                 window,  /* randomizationRangeInSamples */
@@ -53,7 +56,8 @@ CNTKBinaryReader::CNTKBinaryReader(const ConfigParameters& config)
                 false, /* multithreadedGetNextSequences */
                  0, /*maxNumberOfInvalidSequences */
                 configHelper.UseSampleBasedRandomizationWindow() /*sampleBasedRandomizationWindow */,
-                GetRandomSeed(config) /*seedOffset*/);
+                GetRandomSeed(config) /*seedOffset*/,
+                prefetchConfig);
         }
         else
         {
@@ -47,7 +47,8 @@ CNTKTextFormatReader::CNTKTextFormatReader(const ConfigParameters& config)
                                                                 /*multithreadedGetNextSequences =*/ false,
                                                                 /*maxNumberOfInvalidSequences =*/ 0,
                                                                 /*sampleBasedRandomizationWindow =*/ configHelper.UseSampleBasedRandomizationWindow(),
-                                                                /*seedOffset =*/ GetRandomSeed(config));
+                                                                /*seedOffset =*/ GetRandomSeed(config),
+                                                                /*prefetchConfig =*/ GetChunkPrefetchConfigurationFromConfig(config));
         }
         else
         {
@@ -125,6 +125,8 @@ TextConfigHelper::TextConfigHelper(const ConfigParameters& config)
     m_maxErrors = config(L"maxErrors", 0);
     m_traceLevel = config(L"traceLevel", 1);
     m_chunkSizeBytes = config(L"chunkSizeInBytes", g_32MB); // 32 MB by default
+    m_numIndexingThreads = config(L"numIndexingThreads", (size_t)0); // by default, large files are indexed using all cores
+    m_cacheIndex = config(L"cacheIndex", false);
     m_keepDataInMemory = config(L"keepDataInMemory", false);
     m_frameMode = config(L"frameMode", false);
 
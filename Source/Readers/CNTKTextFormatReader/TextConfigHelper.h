@@ -37,6 +37,12 @@ public:
 
     size_t GetChunkSize() const { return m_chunkSizeBytes; }
 
+    // Number of threads used to build the index of the input file (0: one per core).
+    size_t GetNumIndexingThreads() const { return m_numIndexingThreads; }
+
+    // Keep the index of the input file in a sidecar file (see IndexCache).
+    bool ShouldCacheIndex() const { return m_cacheIndex; }
+
     bool ShouldKeepDataInMemory() const { return m_keepDataInMemory; }
 
     bool IsInFrameMode() const { return m_frameMode; }
@@ -57,6 +63,8 @@ private:
     unsigned int m_maxErrors;
     unsigned int m_traceLevel;
     size_t m_chunkSizeBytes; // chunks size in bytes
+    size_t m_numIndexingThreads;
+    bool m_cacheIndex;
     bool m_keepDataInMemory; // if true the whole dataset is kept in memory
     bool m_frameMode; // if true, the maximum expected sequence length in the dataset is one sample.
 };
@@ -10,6 +10,7 @@
 #include "Indexer.h"
 #include "TextParser.h"
 #include "TextReaderConstants.h"
+#include "TextReaderScanning.h"
 
 #define isSign(c) ((c == '-' || c == '+'))
 #define isE(c) ((c == 'e' || c == 'E'))
@@ -66,6 +67,8 @@ TextParser(corpus, helper.GetFilePath(), helper.GetStreams(), primary)
     SetTraceLevel(helper.GetTraceLevel());
     SetMaxAllowedErrors(helper.GetMaxAllowedErrors());
     SetChunkSize(helper.GetChunkSize());
+    SetNumIndexingThreads(helper.GetNumIndexingThreads());
+    SetCacheIndex(helper.ShouldCacheIndex());
     SetSkipSequenceIds(helper.ShouldSkipSequenceIds());
 
     Initialize();
@@ -91,6 +94,8 @@ TextParser<ElemType>::TextParser(CorpusDescriptorPtr corpus, const std::wstring&
     m_hadWarnings(false),
     m_numAllowedErrors(0),
     m_skipSequenceIds(false),
+    m_numIndexingThreads(1),
+    m_cacheIndex(false),
     m_numRetries(5),
     m_corpus(corpus)
 {
@@ -184,6 +189,10 @@ void TextParser<ElemType>::Initialize()
         }
 
         m_indexer = make_unique<Indexer>(m_file, m_primary, m_skipSequenceIds, NAME_PREFIX, m_chunkSizeBytes, mainStreamAlias);
+        if (m_numIndexingThreads != 1)
+            m_indexer->SetParallelism(m_filename, m_numIndexingThreads);
+        if (m_cacheIndex)
+            m_indexer->SetIndexCache(m_filename);
         m_indexer->Build(m_corpus);
     });
 
@@ -927,14 +936,15 @@ void TextParser<ElemType>::SkipToNextValue(size_t& bytesToRead)
 {
     while (bytesToRead && CanRead())
     {
-        char c = *m_pos;
         // skip everything until we hit either a value delimiter, an input marker or the end of row.
-        if (isValueDelimiter(c) || c == NAME_PREFIX || c == ROW_DELIMITER)
+        const char* end = m_pos + min(bytesToRead, static_cast<size_t>(m_bufferEnd - m_pos));
+        const char* found = FindFirstOf(m_pos, end, SPACE_CHAR, TAB_CHAR, NAME_PREFIX, ROW_DELIMITER);
+        bytesToRead -= found - m_pos;
+        m_pos = found;
+        if (found != end)
         {
             return;
         }
-        ++m_pos;
-        --bytesToRead;
     }
 }
 
@@ -943,20 +953,30 @@ void TextParser<ElemType>::SkipToNextInput(size_t& bytesToRead)
 {
     while (bytesToRead && CanRead())
     {
-        char c = *m_pos;
         // skip everything until we hit either an input marker or the end of row.
-        if (c == NAME_PREFIX || c == ROW_DELIMITER)
+        const char* end = m_pos + min(bytesToRead, static_cast<size_t>(m_bufferEnd - m_pos));
+        const char* found = FindFirstOf(m_pos, end, NAME_PREFIX, ROW_DELIMITER, NAME_PREFIX, ROW_DELIMITER);
+        bytesToRead -= found - m_pos;
+        m_pos = found;
+        if (found != end)
         {
             return;
         }
-        ++m_pos;
-        --bytesToRead;
     }
 }
 
 template <class ElemType>
 bool TextParser<ElemType>::TryReadUint64(size_t& value, size_t& bytesToRead)
 {
+    // fast path for a value that is followed by a delimiter within the buffer
+    const char* end = TryParseUint64(m_pos, m_pos + min(bytesToRead, static_cast<size_t>(m_bufferEnd - m_pos)), value);
+    if (end)
+    {
+        bytesToRead -= end - m_pos;
+        m_pos = end;
+        return true;
+    }
+
     value = 0;
     bool found = false;
     while (bytesToRead && CanRead())
@@ -1027,6 +1047,16 @@ bool TextParser<ElemType>::TryReadUint64(size_t& value, size_t& bytesToRead)
 template <class ElemType>
 bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRead)
 {
+    // Fast path for a well-formed number that is followed by a delimiter within the buffer (bit-identical to
+    // the state machine below). Everything else, including errors, goes through the state machine.
+    const char* end = TryParseRealNumber(m_pos, m_pos + min(bytesToRead, static_cast<size_t>(m_bufferEnd - m_pos)), value);
+    if (end)
+    {
+        bytesToRead -= end - m_pos;
+        m_pos = end;
+        return true;
+    }
+
     State state = State::Init;
     double coefficient = .0, number = .0, divider = .0;
     bool negative = false;
@@ -1282,6 +1312,18 @@ void TextParser<ElemType>::SetChunkSize(size_t size)
     m_chunkSizeBytes = size;
 }
 
+template <class ElemType>
+void TextParser<ElemType>::SetNumIndexingThreads(size_t numThreads)
+{
+    m_numIndexingThreads = numThreads;
+}
+
+template <class ElemType>
+void TextParser<ElemType>::SetCacheIndex(bool cacheIndex)
+{
+    m_cacheIndex = cacheIndex;
+}
+
 template <class ElemType>
 void TextParser<ElemType>::SetNumRetries(unsigned int numRetries)
 {
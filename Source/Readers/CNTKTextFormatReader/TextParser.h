@@ -133,6 +133,8 @@ private:
     bool m_hadWarnings;
     unsigned int m_numAllowedErrors;
     bool m_skipSequenceIds;
+    size_t m_numIndexingThreads; // number of threads used by the indexer (0: one per core)
+    bool m_cacheIndex;           // keep the index in a sidecar file of the input
     unsigned int m_numRetries; // specifies the number of times an unsuccessful
                                // file operation should be repeated (default value is 5).
 
@@ -204,6 +206,10 @@ private:
 
     void SetChunkSize(size_t size);
 
+    void SetNumIndexingThreads(size_t numThreads);
+
+    void SetCacheIndex(bool cacheIndex);
+
     void SetNumRetries(unsigned int numRetries);
 
     friend class CNTKTextFormatReaderTestRunner<ElemType>;
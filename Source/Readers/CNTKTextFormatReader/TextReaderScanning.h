@@ -0,0 +1,158 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CNTK_TEXT_READER_SSE2
+#endif
+#include "TextReaderConstants.h"
+
+// Fast paths for the TextParser, operating on a contiguous range of the input buffer.
+// They only succeed if the token they look at ends within the range; otherwise (and on malformed input)
+// they fail without consuming anything, and the parser falls back to its character-by-character path,
+// which handles buffer refills and reports errors.
+
+namespace CNTK {
+
+// Returns a pointer to the first character in [begin, end) that equals one of c0..c3 (or end, if there is none).
+// Scans 16 characters at a time where SSE2 is available.
+inline const char* FindFirstOf(const char* begin, const char* end, char c0, char c1, char c2, char c3)
+{
+    const char* p = begin;
+#ifdef CNTK_TEXT_READER_SSE2
+    const __m128i v0 = _mm_set1_epi8(c0), v1 = _mm_set1_epi8(c1), v2 = _mm_set1_epi8(c2), v3 = _mm_set1_epi8(c3);
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i match = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, v0), _mm_cmpeq_epi8(chunk, v1)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(chunk, v2), _mm_cmpeq_epi8(chunk, v3)));
+        int mask = _mm_movemask_epi8(match);
+        if (mask != 0)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return p + index;
+#else
+            return p + __builtin_ctz(mask);
+#endif
+        }
+    }
+#endif
+    for (; p != end; ++p)
+    {
+        char c = *p;
+        if (c == c0 || c == c1 || c == c2 || c == c3)
+            return p;
+    }
+    return end;
+}
+
+// Parses an unsigned decimal integer at the beginning of [begin, end).
+// Returns a pointer to the character following it, or nullptr if there are no digits, the value overflows,
+// or the digits extend to the end of the range.
+inline const char* TryParseUint64(const char* begin, const char* end, size_t& value)
+{
+    size_t result = 0;
+    const char* p = begin;
+    for (; p != end && '0' <= *p && *p <= '9'; ++p)
+    {
+        size_t temp = result;
+        result = result * 10 + (*p - '0');
+        if (temp > result)
+            return nullptr;
+    }
+    if (p == begin || p == end)
+        return nullptr;
+    value = result;
+    return p;
+}
+
+// Parses a real number at the beginning of [begin, end).
+// This performs exactly the same arithmetic, in the same order, as TextParser::TryReadRealNumber(),
+// so that results are bit-identical to it. Returns a pointer to the character following the number,
+// or nullptr if the number is malformed or extends to the end of the range.
+template <class ElemType>
+inline const char* TryParseRealNumber(const char* begin, const char* end, ElemType& value)
+{
+    const char* p = begin;
+    auto isDigit = [](char c) { return '0' <= c && c <= '9'; };
+
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    if (p == end || !isDigit(*p))
+        return nullptr;
+
+    double number = (*p++ - '0');
+    while (p != end && isDigit(*p))
+        number = number * 10 + (*p++ - '0');
+    if (p == end)
+        return nullptr;
+
+    double coefficient;
+    if (*p == '.')
+    {
+        if (++p == end)
+            return nullptr;
+        if (!isDigit(*p))
+        {
+            value = static_cast<ElemType>(negative ? -number : number);
+            return p;
+        }
+
+        coefficient = number;
+        number = (*p++ - '0');
+        double divider = 10;
+        while (p != end && isDigit(*p))
+        {
+            number = number * 10 + (*p++ - '0');
+            divider *= 10;
+        }
+        if (p == end)
+            return nullptr;
+
+        coefficient += (number / divider);
+        if (*p != 'e' && *p != 'E')
+        {
+            value = static_cast<ElemType>(negative ? -coefficient : coefficient);
+            return p;
+        }
+        if (negative)
+            coefficient = -coefficient;
+    }
+    else if (*p == 'e' || *p == 'E')
+        coefficient = negative ? -number : number;
+    else
+    {
+        value = static_cast<ElemType>(negative ? -number : number);
+        return p;
+    }
+
+    // exponent: optional sign and a nonempty sequence of digits
+    ++p;
+    negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    if (p == end || !isDigit(*p))
+        return nullptr;
+
+    number = (*p++ - '0');
+    while (p != end && isDigit(*p))
+        number = number * 10 + (*p++ - '0');
+    if (p == end)
+        return nullptr;
+
+    double exponent = negative ? -number : number;
+    value = static_cast<ElemType>(coefficient * pow(10.0, exponent));
+    return p;
+}
+
+}
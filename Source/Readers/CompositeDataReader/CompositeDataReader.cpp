@@ -17,6 +17,7 @@
 #include "NoRandomizer.h"
 #include "FramePacker.h"
 #include "SequencePacker.h"
+#include "BucketingSequencePacker.h"
 #include "TruncatedBpttPacker.h"
 #include "CorpusDescriptor.h"
 #include "ConfigUtil.h"
@@ -148,7 +149,8 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
 
         bool shouldPrefetch = true;
         m_sequenceEnumerator = std::make_shared<BlockRandomizer>(verbosity, randomizationWindow, deserializer, shouldPrefetch, 
-            multiThreadedDeserialization, maxErrors, sampleBasedRandomizationWindow, GetRandomSeed(config));
+            multiThreadedDeserialization, maxErrors, sampleBasedRandomizationWindow, GetRandomSeed(config),
+            GetChunkPrefetchConfigurationFromConfig(config));
     }
     else
     {
@@ -181,13 +183,27 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
             m_corpus);
         break;
     case PackingMode::sequence:
-        m_packer = std::make_shared<SequencePacker>(
-            m_sequenceEnumerator,
-            outputStreams,
-            numAlternatingBuffers,
-            localTimeline,
-            m_corpus);
+    {
+        // Number of minibatches to read ahead and group by sequence length, 0 means no bucketing.
+        size_t bucketingWindow = config(L"bucketingWindow", 0);
+        if (bucketingWindow > 0 && !isActionWrite)
+            m_packer = std::make_shared<BucketingSequencePacker>(
+                m_sequenceEnumerator,
+                outputStreams,
+                bucketingWindow,
+                numAlternatingBuffers,
+                localTimeline,
+                m_corpus,
+                verbosity);
+        else
+            m_packer = std::make_shared<SequencePacker>(
+                m_sequenceEnumerator,
+                outputStreams,
+                numAlternatingBuffers,
+                localTimeline,
+                m_corpus);
         break;
+    }
     case PackingMode::truncated:
     {
         // Currently BPTT does not support sparse format as output.
@@ -119,7 +119,8 @@ HTKMLFReader::HTKMLFReader(const ConfigParameters& readerConfig)
             /*multithreadedGetNextSequences =*/ false, // default
             /*maxNumberOfInvalidSequences =*/ 0, // default
             /*sampleBasedRandomizationWindow =*/ true, // default
-            GetRandomSeed(readerConfig));
+            GetRandomSeed(readerConfig),
+            GetChunkPrefetchConfigurationFromConfig(readerConfig));
     }
     else if (AreEqualIgnoreCase(readMethod, std::wstring(L"none")))
     {
@@ -302,6 +302,7 @@ MLFDeserializer::MLFDeserializer(CorpusDescriptorPtr corpus, const ConfigParamet
     // Same behavior as for the old deserializer - keep almost all in memory,
     // because there are a lot of none aligned sets.
     m_chunkSizeBytes = cfg(L"chunkSizeInBytes", g_64MB);
+    m_cacheIndex = cfg(L"cacheIndex", false);
 
     ConfigParameters input = cfg("input");
     auto inputName = input.GetMemberIds().front();
@@ -346,6 +347,7 @@ MLFDeserializer::MLFDeserializer(CorpusDescriptorPtr corpus, const ConfigParamet
     // Same behavior as for the old deserializer - keep almost all in memory,
     // because there are a lot of none aligned sets.
     m_chunkSizeBytes = labelConfig(L"chunkSizeInBytes", g_64MB);
+    m_cacheIndex = labelConfig(L"cacheIndex", false);
 
     wstring precision = labelConfig(L"precision", L"float");;
     m_elementType = AreEqualIgnoreCase(precision, L"float") ? DataType::Float : DataType::Double;
@@ -384,6 +386,8 @@ void MLFDeserializer::InitializeChunkInfos(CorpusDescriptorPtr corpus, const Con
         {
             auto file = shared_ptr<FILE>(fopenOrDie(path, L"rbS"), [](FILE *f) { if (f) fclose(f); });
             indexer = make_shared<MLFIndexer>(file.get(), m_frameMode, m_chunkSizeBytes);
+            if (m_cacheIndex)
+                indexer->SetIndexCache(path);
             indexer->Build(corpus);
         });
 
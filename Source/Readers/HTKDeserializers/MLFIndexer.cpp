@@ -8,6 +8,7 @@
 #include "MLFIndexer.h"
 #include "MLFUtils.h"
 #include "ReaderUtil.h"
+#include "IndexCache.h"
 
 namespace CNTK {
 
@@ -18,12 +19,20 @@ namespace CNTK {
         m_file(file),
         m_fileOffsetStart(0),
         m_done(false),
-        m_index(chunkSize, true, frameMode)
+        m_index(chunkSize, true, frameMode),
+        m_frameMode(frameMode)
     {
         if (!m_file)
             RuntimeError("Input file not open for reading");
     }
 
+    void MLFIndexer::SetIndexCache(const std::wstring& filename)
+    {
+        char configuration[128];
+        sprintf(configuration, "MLF frameMode=%d chunkSize=%zu", (int)m_frameMode, m_index.m_maxChunkSize);
+        m_cache = make_shared<IndexCache>(filename, configuration);
+    }
+
     void MLFIndexer::RefillBuffer()
     {
         if (m_done)
@@ -98,6 +107,19 @@ namespace CNTK {
         if (!m_index.IsEmpty())
             return;
 
+        uint64_t flags;
+        if (m_cache && m_cache->TryLoad(m_index, corpus, flags))
+            return;
+
+        BuildFromFile(corpus);
+
+        if (m_cache)
+            m_cache->Save(m_index, corpus, 0, m_skippedKeys);
+    }
+
+    void MLFIndexer::BuildFromFile(CorpusDescriptorPtr corpus)
+    {
+
         m_index.Reserve(filesize(m_file));
 
         RefillBuffer(); // read the first block of data
@@ -108,6 +130,8 @@ namespace CNTK {
         State currentState = State::Header;
         vector<boost::iterator_range<char*>> lines, tokens;
         bool isValid = true;                    // Flag indicating whether the current sequence is valid.
+        bool hasKey = false;                    // Flag indicating whether the key of the current sequence was registered with the corpus.
+        size_t numberOfSequences = 0;           // Number of sequences added to the index so far.
         size_t lastNonEmptyString = 0;          // Needed to parse information about last frame
         size_t sequenceStartOffset = 0;         // Offset in file where current sequence starts.
         while (!m_done)
@@ -138,7 +162,7 @@ namespace CNTK {
                         continue;
 
                     sequenceStartOffset = m_fileOffsetStart + lines[i].begin() - m_buffer.data();
-                    isValid = TryParseSequenceKey(lines[i], id, corpus->KeyToId);
+                    isValid = hasKey = TryParseSequenceKey(lines[i], id, corpus->KeyToId);
                     currentState = State::UtteranceFrames;
                 }
                 break;
@@ -173,9 +197,16 @@ namespace CNTK {
                     }
 
                     if (isValid)
+                    {
                         m_index.AddSequence(SequenceDescriptor{ id, numberOfSamples }, sequenceStartOffset, sequenceEndOffset);
+                        numberOfSequences++;
+                    }
                     else
+                    {
                         fprintf(stderr, "WARNING: Cannot parse the utterance '%s' at offset (%" PRIu64 ")\n", corpus->IdToKey(id).c_str(), sequenceStartOffset);
+                        if (hasKey) // the cache has to register the key as well, so that the ids of the following keys match
+                            m_skippedKeys.push_back(make_pair(numberOfSequences, id));
+                    }
                     currentState = State::UtteranceKey; // Let's try the next one.
                 }
                 break;
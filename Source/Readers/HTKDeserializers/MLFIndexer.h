@@ -19,6 +19,10 @@ namespace CNTK {
 
         void Build(CorpusDescriptorPtr corpus);
 
+        // Keeps the index in a sidecar file of the MLF file (filename), and loads it from there
+        // instead of parsing the MLF if it is up to date (see IndexCache).
+        void SetIndexCache(const std::wstring& filename);
+
         // Returns input data index (chunk and sequence metadata)
         const Index& GetIndex() const { return m_index; }
 
@@ -39,9 +43,15 @@ namespace CNTK {
         std::string m_lastPartialLineInBuffer;    // Partial string from the previous read of m_buffer.
 
         Index m_index;
+        bool m_frameMode;
+        std::shared_ptr<IndexCache> m_cache;      // null if the index is not cached
+        std::vector<std::pair<size_t, size_t>> m_skippedKeys; // ids of the keys of invalid utterances, with the number of sequences before each (see IndexCache::Save())
 
         std::string m_lastNonEmptyLine;           // Last non empty estring, used for parsing sequence length.
 
+        // Builds the index from the MLF file (Build() without the cache).
+        void BuildFromFile(CorpusDescriptorPtr corpus);
+
         // fills up the buffer with data from file, all previously buffered data
         // will be overwritten.
         void RefillBuffer();
@@ -13,9 +13,28 @@
 
 #include "DataReader.h"
 #include "ExceptionCapture.h"
+#include "PerformanceProfiler.h"
 
 namespace CNTK {
 
+// Rough size of a sample in memory, used to keep the prefetched chunks within the memory budget.
+// Sparse streams are assumed to have one non-zero value per sample.
+static size_t EstimateBytesPerSample(const std::vector<StreamInformation>& streams)
+{
+    size_t result = 0;
+    for (const auto& stream : streams)
+    {
+        size_t elementSize = stream.m_elementType == DataType::Unknown ? sizeof(float) : DataTypeSize(stream.m_elementType);
+        if (stream.m_storageFormat != StorageFormat::Dense)
+            result += elementSize + sizeof(SparseIndexType);
+        else if (!stream.m_sampleLayout.IsUnknown() && !stream.m_sampleLayout.HasUnboundDimension())
+            result += elementSize * stream.m_sampleLayout.TotalSize();
+        else
+            result += elementSize;
+    }
+    return std::max<size_t>(result, 1);
+}
+
 BlockRandomizer::BlockRandomizer(
     int verbosity,
     size_t randomizationRange,
@@ -24,7 +43,8 @@ BlockRandomizer::BlockRandomizer(
     bool multithreadedGetNextSequence,
     size_t maxNumberOfInvalidSequences,
     bool sampleBasedRandomizationWindow,
-    size_t seedOffset)
+    size_t seedOffset,
+    const ChunkPrefetchConfiguration& prefetchConfig)
     : m_verbosity(verbosity),
       m_deserializer(deserializer),
       m_sweep(SIZE_MAX),
@@ -34,15 +54,15 @@ BlockRandomizer::BlockRandomizer(
       m_sweepSizeInSamples(0),
       m_chunkRandomizer(std::make_shared<ChunkRandomizer>(deserializer, randomizationRange, sampleBasedRandomizationWindow)),
       m_multithreadedGetNextSequences(multithreadedGetNextSequence),
-      m_prefetchedChunk(ChunkIdMax),
+      m_maxChunksToPrefetch(prefetchConfig.m_maxChunks),
       m_cleaner(maxNumberOfInvalidSequences),
       m_seedOffset(seedOffset)
 {
     assert(deserializer != nullptr);
 
-    m_launchType = shouldPrefetch ? launch::async : launch::deferred;
-
     m_streams = m_deserializer->StreamInfos();
+    if (shouldPrefetch)
+        m_prefetcher = std::make_unique<ChunkPrefetcher>(m_deserializer, prefetchConfig, EstimateBytesPerSample(m_streams));
     m_sequenceRandomizer = std::make_shared<SequenceRandomizer>(verbosity, m_deserializer, m_chunkRandomizer);
 
     // Calculate total number of samples.
@@ -234,8 +254,7 @@ std::pair<size_t, size_t> BlockRandomizer::LoadSequenceData(size_t globalSampleC
     }
 
     // Now it is safe to start the new chunk prefetch.
-    ChunkIdType chunkToPrefetchNext = GetChunkToPrefetch(windowRange);
-    Prefetch(chunkToPrefetchNext);
+    Prefetch(windowRange);
 
     return { numGlobalSamples, numLocalSamples };
 }
@@ -395,31 +414,12 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
         }
 
         auto const& chunk = m_chunkRandomizer->GetRandomizedChunks()[i];
-        if (chunk.m_original->m_id == m_prefetchedChunk && m_prefetch.valid())
-        {
-            // Taking prefetched chunk.
-            m_chunks[chunk.m_original->m_id] = m_prefetch.get();
-            if (m_verbosity >= Information)
-                fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in prefetched chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
-                chunk.m_chunkId,
-                chunk.m_original->m_id,
-                ++numLoadedChunks);
-        }
-        else
-        {
-            // Make sure we have no outstanding prefetches.
-            if (m_prefetch.valid())
-            {
-                m_prefetch.wait();
-            }
-
-            m_chunks[chunk.m_original->m_id] = m_deserializer->GetChunk(chunk.m_original->m_id);
-            if (m_verbosity >= Information)
-                fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in randomized chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
-                chunk.m_chunkId,
-                chunk.m_original->m_id,
-                ++numLoadedChunks);
-        }
+        m_chunks[chunk.m_original->m_id] = GetChunk(chunk.m_original->m_id);
+        if (m_verbosity >= Information)
+            fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in randomized chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
+            chunk.m_chunkId,
+            chunk.m_original->m_id,
+            ++numLoadedChunks);
     }
 
     if (m_verbosity >= Notification)
@@ -429,42 +429,44 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
                 m_chunkRandomizer->GetRandomizedChunks()[windowRange.m_end - 1].m_chunkId);
 }
 
-// Identifies chunk id that should be prefetched.
-ChunkIdType BlockRandomizer::GetChunkToPrefetch(const ClosedOpenChunkInterval& windowRange)
+// Gets the chunk, waiting for it if it is still being prefetched.
+ChunkPtr BlockRandomizer::GetChunk(ChunkIdType chunkId)
+{
+    // Time spent here is time the training loop is stalled on io.
+    Microsoft::MSR::CNTK::ScopeProfile profile(Microsoft::MSR::CNTK::profilerEvtWaitForChunk);
+    return m_prefetcher ? m_prefetcher->Get(chunkId) : m_deserializer->GetChunk(chunkId);
+}
+
+// Identifies chunks that should be prefetched, in the order they will be needed.
+std::vector<std::pair<ChunkIdType, size_t>> BlockRandomizer::GetChunksToPrefetch(const ClosedOpenChunkInterval& windowRange)
 {
-    ChunkIdType toBePrefetched = ChunkIdMax;
-    auto current = windowRange.m_end;
-    while (current < m_chunkRandomizer->GetRandomizedChunks().size())
+    std::vector<std::pair<ChunkIdType, size_t>> toBePrefetched;
+    const auto& chunks = m_chunkRandomizer->GetRandomizedChunks();
+    for (auto current = windowRange.m_end; current < chunks.size() && toBePrefetched.size() < m_maxChunksToPrefetch; ++current)
     {
-        const auto& chunk = m_chunkRandomizer->GetRandomizedChunks()[current];
+        const auto& chunk = chunks[current];
         if (chunk.m_chunkId % m_config.m_numberOfWorkers == m_config.m_workerRank &&
             m_chunks.find(chunk.m_original->m_id) == m_chunks.end())
         {
-            toBePrefetched = chunk.m_original->m_id;
-            break;
+            toBePrefetched.push_back(std::make_pair(chunk.m_original->m_id, (size_t)chunk.m_original->m_numberOfSamples));
         }
-        ++current;
     }
     return toBePrefetched;
 }
 
-// Performs io prefetch of the specified chunk if needed.
-void BlockRandomizer::Prefetch(ChunkIdType chunkId)
+// Schedules io prefetch of the chunks following the window.
+void BlockRandomizer::Prefetch(const ClosedOpenChunkInterval& windowRange)
 {
-    // Start new prefetch if necessary.
-    if (m_prefetchedChunk != chunkId && chunkId != ChunkIdMax)
-    {
-        // Wait to make sure there is no outstanding prefetches.
-        if (m_prefetch.valid())
-        {
-            m_prefetch.wait();
-        }
+    if (!m_prefetcher)
+        return;
 
-        m_prefetchedChunk = chunkId;
-        m_prefetch = std::async(m_launchType, [this, chunkId]() { return m_deserializer->GetChunk(chunkId); });
+    auto chunks = GetChunksToPrefetch(windowRange);
+    m_prefetcher->Schedule(chunks);
 
-        if (m_verbosity >= Debug)
-            fprintf(stderr, "BlockRandomizer::Prefetch: prefetching original chunk: %u\n", chunkId);
+    if (m_verbosity >= Debug)
+    {
+        for (const auto& chunk : chunks)
+            fprintf(stderr, "BlockRandomizer::Prefetch: prefetching original chunk: %u\n", chunk.first);
     }
 }
 
@@ -12,7 +12,7 @@
 #include "ChunkRandomizer.h"
 #include "SequenceRandomizer.h"
 #include "ReaderUtil.h"
-#include <future>
+#include "ChunkPrefetcher.h"
 
 namespace CNTK {
 
@@ -44,7 +44,8 @@ public:
         bool multithreadedGetNextSequences = false,
         size_t maxNumberOfInvalidSequences = 0, // per worker
         bool sampleBasedRandomizationWindow = true,
-        size_t seedOffset = 0);
+        size_t seedOffset = 0,
+        const ChunkPrefetchConfiguration& prefetchConfig = ChunkPrefetchConfiguration());
 
     // Starts a new epoch.
     virtual void StartEpoch(const EpochConfiguration& config) override;
@@ -63,14 +64,6 @@ public:
     // Returns current position in the global timeline. The returned value is in samples.
     std::map<std::wstring, size_t> GetState() override;
 
-    ~BlockRandomizer()
-    {
-        if (m_prefetch.valid())
-        {
-            m_prefetch.wait();
-        }
-    }
-
     void SetState(const std::map<std::wstring, size_t>& state) override;
 
     void SetConfiguration(const ReaderConfiguration& config) override;
@@ -97,11 +90,15 @@ private:
     // Prepares a new sweep if needed.
     void PrepareNewSweepIfNeeded(size_t samplePosition);
 
-    // Performs io prefetch of the specified chunk if needed.
-    void Prefetch(ChunkIdType chunkId);
+    // Schedules io prefetch of the chunks following the given window.
+    void Prefetch(const ClosedOpenChunkInterval& windowRange);
+
+    // Returns the candidates for the prefetch following the given range, in randomized order,
+    // as pairs of original chunk id and number of samples.
+    std::vector<std::pair<ChunkIdType, size_t>> GetChunksToPrefetch(const ClosedOpenChunkInterval& windowRange);
 
-    // Returns next candidate for the prefetch in the given range.
-    ChunkIdType GetChunkToPrefetch(const ClosedOpenChunkInterval& windowRange);
+    // Gets the chunk from the prefetcher or the deserializer.
+    ChunkPtr GetChunk(ChunkIdType chunkId);
 
     // Global sample position on the timeline.
     size_t m_globalSamplePosition;
@@ -153,12 +150,9 @@ private:
 
     int m_verbosity;
 
-    // Prefetch future.
-    std::future<ChunkPtr> m_prefetch;
-    // Whether to have async or deferred prefetch.
-    launch m_launchType;
-    // Prefetched original chunk id.
-    ChunkIdType m_prefetchedChunk;
+    // Loads upcoming chunks on io threads, null if prefetch is disabled.
+    std::unique_ptr<ChunkPrefetcher> m_prefetcher;
+    size_t m_maxChunksToPrefetch;
 
     // Current loaded chunks.
     ClosedOpenChunkInterval m_currentWindowRange;
@@ -0,0 +1,397 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+#define _SCL_SECURE_NO_WARNINGS
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include "BucketingSequencePacker.h"
+
+namespace CNTK {
+
+using namespace Microsoft::MSR::CNTK;
+
+// Keys of the window of the pending minibatches in the packer state, see BucketingSequencePacker::GetState().
+const static wchar_t* g_bucketingWindowStart = L"bucketingWindowStart";
+const static wchar_t* g_bucketingWindowGlobalMinibatchSize = L"bucketingWindowGlobalMinibatchSize";
+const static wchar_t* g_bucketingWindowLocalMinibatchSize = L"bucketingWindowLocalMinibatchSize";
+const static wchar_t* g_bucketingWindowWorkerRank = L"bucketingWindowWorkerRank";
+const static wchar_t* g_bucketingWindowNumberOfWorkers = L"bucketingWindowNumberOfWorkers";
+const static wchar_t* g_bucketingWindowReturnedSequences = L"bucketingWindowReturnedSequences";
+
+// Sequences returned by the deserializers usually point into the memory of their chunk, which is only
+// guaranteed to be alive until the next call to the randomizer. The sequences of the window are therefore
+// copied into the following owning sequences.
+struct BufferedDenseSequenceData : DenseSequenceData
+{
+    const void* GetDataBuffer() override
+    {
+        return m_buffer.data();
+    }
+
+    const NDShape& GetSampleShape() override
+    {
+        return m_sampleShape;
+    }
+
+    std::vector<char> m_buffer;
+    NDShape m_sampleShape;
+};
+
+struct BufferedSparseSequenceData : SparseSequenceData
+{
+    const void* GetDataBuffer() override
+    {
+        return m_buffer.data();
+    }
+
+    const NDShape& GetSampleShape() override
+    {
+        return m_sampleShape;
+    }
+
+    std::vector<char> m_buffer;
+    std::vector<SparseIndexType> m_indexBuffer;
+    NDShape m_sampleShape;
+};
+
+BucketingSequencePacker::BucketingSequencePacker(
+    SequenceEnumeratorPtr sequenceEnumerator,
+    const std::vector<StreamInformation>& streams,
+    size_t bucketingWindow,
+    size_t numberOfBuffers,
+    bool useLocalTimeline,
+    CorpusDescriptorPtr corpus,
+    int verbosity) :
+    SequencePacker(sequenceEnumerator, streams, numberOfBuffers, useLocalTimeline, corpus),
+    m_bucketingWindow(bucketingWindow),
+    m_windowStartPosition(0),
+    m_windowGlobalMinibatchSize(0),
+    m_windowLocalMinibatchSize(0),
+    m_windowWorkerRank(0),
+    m_windowNumberOfWorkers(0),
+    m_windowReturnedSequences(0),
+    m_numberOfSamples(0),
+    m_numberOfColumns(0),
+    m_numberOfColumnsWithoutBucketing(0),
+    m_numberOfMinibatches(0),
+    m_epochStarted(false),
+    m_verbosity(verbosity)
+{
+    if (m_bucketingWindow == 0)
+        InvalidArgument("Bucketing window of the sequence packer should be at least one minibatch.");
+}
+
+void BucketingSequencePacker::SetConfiguration(const ReaderConfiguration& config, const std::vector<MemoryProviderPtr>& memoryProviders)
+{
+    SequencePacker::SetConfiguration(config, memoryProviders);
+
+    // The pending minibatches stay valid for a different minibatch size, but not for a different partition
+    // of the data between the workers.
+    if (m_config.m_workerRank != m_windowWorkerRank || m_config.m_numberOfWorkers != m_windowNumberOfWorkers)
+        m_pending.clear();
+    else
+        SplitPendingMinibatches();
+}
+
+void BucketingSequencePacker::Reset()
+{
+    m_pending.clear();
+    m_numberOfSamples = 0;
+    m_numberOfColumns = 0;
+    m_numberOfColumnsWithoutBucketing = 0;
+    m_numberOfMinibatches = 0;
+    m_epochStarted = false;
+}
+
+Minibatch BucketingSequencePacker::ReadMinibatch()
+{
+    if (!m_epochStarted)
+    {
+        m_epochStartTime = std::chrono::steady_clock::now();
+        m_epochStarted = true;
+    }
+
+    if (m_pending.empty())
+        FillPendingMinibatches(m_globalMinibatchSizeInSamples, m_localMinibatchSizeInSamples);
+
+    assert(!m_pending.empty());
+    Sequences sequences = std::move(m_pending.front());
+    m_pending.pop_front();
+    if (!sequences.m_data.empty())
+        m_windowReturnedSequences += sequences.m_data.front().size();
+
+    auto minibatch = PackSequences(sequences);
+    if (!minibatch.m_data.empty())
+    {
+        const auto& layout = minibatch.m_data.front()->m_layout;
+        m_numberOfSamples += layout->GetActualNumSamples();
+        m_numberOfColumns += layout->GetNumCols();
+        m_numberOfMinibatches++;
+    }
+
+    if (minibatch.m_endOfEpoch)
+        ReportStatistics();
+
+    return minibatch;
+}
+
+SequenceDataPtr BucketingSequencePacker::CopySequence(const SequenceDataPtr& sequence, size_t streamIndex)
+{
+    const auto& stream = m_inputStreamDescriptions[streamIndex];
+    const char* source = (const char*)sequence->GetDataBuffer();
+    size_t elementSize = DataTypeSize(stream.m_elementType);
+
+    SequenceDataPtr result;
+    if (stream.m_storageFormat == StorageFormat::Dense)
+    {
+        auto dense = std::make_shared<BufferedDenseSequenceData>();
+        dense->m_sampleShape = sequence->GetSampleShape();
+        dense->m_buffer.assign(source, source + sequence->m_numberOfSamples * dense->m_sampleShape.TotalSize() * elementSize);
+        result = dense;
+    }
+    else if (stream.m_storageFormat == StorageFormat::SparseCSC)
+    {
+        auto sparseSequence = static_pointer_cast<SparseSequenceData>(sequence);
+        auto sparse = std::make_shared<BufferedSparseSequenceData>();
+        sparse->m_sampleShape = sequence->GetSampleShape();
+        sparse->m_buffer.assign(source, source + sparseSequence->m_totalNnzCount * elementSize);
+        sparse->m_indexBuffer.assign(sparseSequence->m_indices, sparseSequence->m_indices + sparseSequence->m_totalNnzCount);
+        sparse->m_indices = sparse->m_indexBuffer.data();
+        sparse->m_nnzCounts = sparseSequence->m_nnzCounts;
+        sparse->m_totalNnzCount = sparseSequence->m_totalNnzCount;
+        result = sparse;
+    }
+    else
+    {
+        RuntimeError("Storage type %d is not supported.", (int)stream.m_storageFormat);
+    }
+
+    result->m_numberOfSamples = sequence->m_numberOfSamples;
+    result->m_elementType = sequence->m_elementType;
+    result->m_isValid = sequence->m_isValid;
+    result->m_key = sequence->m_key;
+    return result;
+}
+
+size_t BucketingSequencePacker::SequenceLength(const Sequences& sequences, size_t index)
+{
+    size_t length = 0;
+    for (const auto& stream : sequences.m_data)
+        length = std::max<size_t>(length, stream[index]->m_numberOfSamples);
+    return length;
+}
+
+void BucketingSequencePacker::FillPendingMinibatches(size_t globalMinibatchSize, size_t localMinibatchSize)
+{
+    auto state = m_sequenceEnumerator->GetState();
+    m_windowStartPosition = state[g_minibatchSourcePosition];
+    m_windowGlobalMinibatchSize = globalMinibatchSize;
+    m_windowLocalMinibatchSize = localMinibatchSize;
+    m_windowWorkerRank = m_config.m_workerRank;
+    m_windowNumberOfWorkers = m_config.m_numberOfWorkers;
+    m_windowReturnedSequences = 0;
+
+    // Collect the sequences of the window. The window stops at the end of a sweep or epoch,
+    // so that the flags can be set on the last repacked minibatch.
+    Sequences window;
+    size_t maxMinibatchSize = 0;
+    for (size_t i = 0; i < m_bucketingWindow; ++i)
+    {
+        auto sequences = m_sequenceEnumerator->GetNextSequences(globalMinibatchSize, localMinibatchSize);
+        window.m_endOfSweep |= sequences.m_endOfSweep;
+        window.m_endOfEpoch |= sequences.m_endOfEpoch;
+
+        if (!sequences.m_data.empty() && !sequences.m_data.front().empty())
+        {
+            if (window.m_data.empty())
+                window.m_data.resize(sequences.m_data.size());
+
+            size_t minibatchSize = 0;
+            for (size_t j = 0; j < sequences.m_data.front().size(); ++j)
+                minibatchSize += SequenceLength(sequences, j);
+            maxMinibatchSize = std::max(maxMinibatchSize, minibatchSize);
+
+            // The layout the base packer would have produced, for the statistics.
+            m_numberOfColumnsWithoutBucketing += CreateMBLayout(sequences.m_data.front())->GetNumCols();
+
+            for (size_t streamIndex = 0; streamIndex < sequences.m_data.size(); ++streamIndex)
+            {
+                for (const auto& sequence : sequences.m_data[streamIndex])
+                    window.m_data[streamIndex].push_back(CopySequence(sequence, streamIndex));
+            }
+        }
+
+        if (sequences.m_endOfSweep || sequences.m_endOfEpoch)
+            break;
+    }
+
+    if (window.m_data.empty())
+    {
+        m_pending.push_back(std::move(window));
+        return;
+    }
+
+    // Sort by length, the keys make the order deterministic for sequences of the same length.
+    const auto& primary = window.m_data.front();
+    std::vector<size_t> order(primary.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<size_t> lengths(primary.size());
+    for (size_t i = 0; i < primary.size(); ++i)
+        lengths[i] = SequenceLength(window, i);
+
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        return lengths[a] != lengths[b] ? lengths[a] < lengths[b] : primary[a]->m_key.m_sequence < primary[b]->m_key.m_sequence;
+    });
+
+    // Cut the sorted sequences into minibatches of at most maxMinibatchSize samples. Sequences longer
+    // than the minibatch size are returned by the randomizer alone, and are kept alone here.
+    maxMinibatchSize = std::min(maxMinibatchSize, localMinibatchSize);
+    std::vector<Sequences> buckets;
+    size_t bucketSize = 0;
+    for (auto index : order)
+    {
+        if (buckets.empty() || bucketSize + lengths[index] > maxMinibatchSize)
+        {
+            buckets.push_back(Sequences());
+            buckets.back().m_data.resize(window.m_data.size());
+            bucketSize = 0;
+        }
+
+        for (size_t streamIndex = 0; streamIndex < window.m_data.size(); ++streamIndex)
+            buckets.back().m_data[streamIndex].push_back(window.m_data[streamIndex][index]);
+        bucketSize += lengths[index];
+    }
+
+    // Shuffle the minibatches. The seed depends only on the content of the window, so that
+    // the order is reproducible for the same randomization.
+    std::mt19937_64 rng(primary[order.front()]->m_key.m_sequence + m_config.m_workerRank);
+    for (size_t i = buckets.size(); i > 1; --i)
+        std::swap(buckets[i - 1], buckets[rng() % i]);
+
+    buckets.back().m_endOfSweep = window.m_endOfSweep;
+    buckets.back().m_endOfEpoch = window.m_endOfEpoch;
+    for (auto& b : buckets)
+        m_pending.push_back(std::move(b));
+}
+
+void BucketingSequencePacker::SplitPendingMinibatches()
+{
+    std::deque<Sequences> pending;
+    for (auto& minibatch : m_pending)
+    {
+        if (minibatch.m_data.empty())
+        {
+            pending.push_back(std::move(minibatch));
+            continue;
+        }
+
+        // A single sequence longer than the minibatch size stays alone, as in FillPendingMinibatches().
+        size_t firstPart = pending.size();
+        size_t partSize = 0;
+        for (size_t i = 0; i < minibatch.m_data.front().size(); ++i)
+        {
+            size_t length = SequenceLength(minibatch, i);
+            if (pending.size() == firstPart || partSize + length > m_localMinibatchSizeInSamples)
+            {
+                pending.push_back(Sequences());
+                pending.back().m_data.resize(minibatch.m_data.size());
+                partSize = 0;
+            }
+
+            for (size_t streamIndex = 0; streamIndex < minibatch.m_data.size(); ++streamIndex)
+                pending.back().m_data[streamIndex].push_back(minibatch.m_data[streamIndex][i]);
+            partSize += length;
+        }
+
+        pending.back().m_endOfSweep = minibatch.m_endOfSweep;
+        pending.back().m_endOfEpoch = minibatch.m_endOfEpoch;
+    }
+
+    m_pending.swap(pending);
+}
+
+void BucketingSequencePacker::DropPendingSequences(size_t numberOfSequences)
+{
+    while (numberOfSequences > 0 && !m_pending.empty())
+    {
+        auto& front = m_pending.front();
+        size_t size = front.m_data.empty() ? 0 : front.m_data.front().size();
+        if (size > numberOfSequences)
+        {
+            for (auto& stream : front.m_data)
+                stream.erase(stream.begin(), stream.begin() + numberOfSequences);
+            break;
+        }
+
+        numberOfSequences -= size;
+        m_pending.pop_front();
+    }
+}
+
+// The state is the randomizer position after the window of the pending minibatches. While there are pending
+// minibatches, it also describes the window, so that SetState() can repack it again.
+std::map<std::wstring, size_t> BucketingSequencePacker::GetState()
+{
+    auto state = m_sequenceEnumerator->GetState();
+    if (!m_pending.empty())
+    {
+        state[g_bucketingWindowStart] = m_windowStartPosition;
+        state[g_bucketingWindowGlobalMinibatchSize] = m_windowGlobalMinibatchSize;
+        state[g_bucketingWindowLocalMinibatchSize] = m_windowLocalMinibatchSize;
+        state[g_bucketingWindowWorkerRank] = m_windowWorkerRank;
+        state[g_bucketingWindowNumberOfWorkers] = m_windowNumberOfWorkers;
+        state[g_bucketingWindowReturnedSequences] = m_windowReturnedSequences;
+    }
+    return state;
+}
+
+void BucketingSequencePacker::SetState(const std::map<std::wstring, size_t>& state)
+{
+    Reset();
+
+    // Without a window, or if the workers changed since it was read, continue reading at the randomizer position.
+    auto windowStart = state.find(g_bucketingWindowStart);
+    if (windowStart == state.end() ||
+        state.at(g_bucketingWindowWorkerRank) != m_config.m_workerRank ||
+        state.at(g_bucketingWindowNumberOfWorkers) != m_config.m_numberOfWorkers)
+    {
+        m_sequenceEnumerator->SetState(state);
+        return;
+    }
+
+    // Read and repack the window again: this gives the same pending minibatches, because the window
+    // is read with the same minibatch size and its order depends only on its content.
+    auto enumeratorState = state;
+    enumeratorState[g_minibatchSourcePosition] = windowStart->second;
+    m_sequenceEnumerator->SetState(enumeratorState);
+    FillPendingMinibatches(state.at(g_bucketingWindowGlobalMinibatchSize), state.at(g_bucketingWindowLocalMinibatchSize));
+
+    size_t returnedSequences = state.at(g_bucketingWindowReturnedSequences);
+    DropPendingSequences(returnedSequences);
+    m_windowReturnedSequences = returnedSequences;
+    SplitPendingMinibatches();
+}
+
+void BucketingSequencePacker::ReportStatistics() const
+{
+    if (!m_verbosity || m_numberOfColumns == 0)
+        return;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_epochStartTime).count();
+    fprintf(stderr, "BucketingSequencePacker: %" PRIu64 " samples in %" PRIu64 " minibatches, padding %.2f%% (%.2f%% without bucketing), %.1f samples/sec\n",
+        m_numberOfSamples,
+        m_numberOfMinibatches,
+        100.0 * (m_numberOfColumns - m_numberOfSamples) / m_numberOfColumns,
+        100.0 * (m_numberOfColumnsWithoutBucketing - m_numberOfSamples) / m_numberOfColumnsWithoutBucketing,
+        seconds > 0 ? m_numberOfSamples / seconds : 0.0);
+}
+
+}
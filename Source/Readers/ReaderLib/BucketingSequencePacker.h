@@ -0,0 +1,102 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <deque>
+#include <chrono>
+#include "SequencePacker.h"
+
+namespace CNTK {
+
+// A sequence packer that reduces the number of gaps in the minibatch layout.
+// It reads the sequences of several minibatches ahead (the bucketing window), sorts them by length
+// and repacks them into minibatches of similar length sequences, so that parallel sequences of a
+// minibatch end at about the same time step. The order in which the resulting minibatches are returned
+// is shuffled.
+//
+// Only the order of sequences inside the window changes: which sequences belong to this worker and to
+// which sweep/epoch is still defined by the underlying randomizer, because the window never spans an
+// end of sweep or epoch. Each repacked minibatch is not bigger (in samples) than the biggest minibatch
+// read from the randomizer within the window, nor than the local minibatch size. The sequences of the window are copied, because their
+// chunks can be released by the randomizer before the sequences are packed.
+//
+// The repacked minibatches that have not been returned yet survive a change of the minibatch size (they are split if they
+// became too big), and are part of the state: restoring a state reads the window again and skips the sequences already returned.
+class BucketingSequencePacker : public SequencePacker
+{
+public:
+    BucketingSequencePacker(
+        SequenceEnumeratorPtr sequenceEnumerator,
+        const std::vector<StreamInformation>& streams,
+        size_t bucketingWindow,
+        size_t numberOfBuffers = 2,
+        bool useLocalTimeline = false,
+        CorpusDescriptorPtr corpus = nullptr,
+        int verbosity = 0);
+
+    Minibatch ReadMinibatch() override;
+
+    void SetConfiguration(const ReaderConfiguration& config, const std::vector<MemoryProviderPtr>& memoryProviders) override;
+
+    // Drops the sequences read ahead.
+    void Reset() override;
+
+    std::map<std::wstring, size_t> GetState() override;
+    void SetState(const std::map<std::wstring, size_t>& state) override;
+
+    // Statistics of the current epoch.
+    size_t NumberOfSamples() const { return m_numberOfSamples; }
+    size_t NumberOfPaddedSamples() const { return m_numberOfColumns - m_numberOfSamples; }
+    size_t NumberOfPaddedSamplesWithoutBucketing() const { return m_numberOfColumnsWithoutBucketing - m_numberOfSamples; }
+
+private:
+    // Reads up to m_bucketingWindow minibatches of the given size from the randomizer and repacks them into m_pending.
+    void FillPendingMinibatches(size_t globalMinibatchSize, size_t localMinibatchSize);
+
+    // Splits the pending minibatches that are bigger than the local minibatch size, keeping the order of the sequences.
+    void SplitPendingMinibatches();
+
+    // Drops the given number of sequences from the front of m_pending.
+    void DropPendingSequences(size_t numberOfSequences);
+
+    // Copies a sequence of the given stream into memory owned by the sequence.
+    SequenceDataPtr CopySequence(const SequenceDataPtr& sequence, size_t streamIndex);
+
+    // The length of a sequence, used both for sorting and for the minibatch size.
+    static size_t SequenceLength(const Sequences& sequences, size_t index);
+
+    // Prints the padding statistics of the epoch, if the reader verbosity is not 0.
+    void ReportStatistics() const;
+
+    // Number of minibatches to read ahead.
+    size_t m_bucketingWindow;
+
+    // Repacked minibatches that have not been returned yet.
+    std::deque<Sequences> m_pending;
+
+    // Where the window of m_pending was read, so that it can be read again when a state is restored:
+    // the randomizer position at its start, the minibatch size and workers it was read with,
+    // and the number of its sequences that have been returned.
+    size_t m_windowStartPosition;
+    size_t m_windowGlobalMinibatchSize;
+    size_t m_windowLocalMinibatchSize;
+    size_t m_windowWorkerRank;
+    size_t m_windowNumberOfWorkers;
+    size_t m_windowReturnedSequences;
+
+    size_t m_numberOfSamples;
+    size_t m_numberOfColumns;
+    size_t m_numberOfColumnsWithoutBucketing;
+    size_t m_numberOfMinibatches;
+    bool m_epochStarted;
+    std::chrono::steady_clock::time_point m_epochStartTime;
+
+    int m_verbosity;
+};
+
+typedef std::shared_ptr<BucketingSequencePacker> BucketingSequencePackerPtr;
+
+}
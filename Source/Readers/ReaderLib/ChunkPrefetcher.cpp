@@ -0,0 +1,173 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "ChunkPrefetcher.h"
+#include <algorithm>
+#include <set>
+#include "PerformanceProfiler.h"
+
+namespace CNTK {
+
+using namespace Microsoft::MSR::CNTK;
+
+ChunkPrefetcher::ChunkPrefetcher(DataDeserializerPtr deserializer, const ChunkPrefetchConfiguration& config, size_t bytesPerSample)
+    : m_deserializer(deserializer),
+      m_config(config),
+      m_bytesPerSample(bytesPerSample),
+      m_bytes(0),
+      m_stop(false)
+{
+    if (m_config.m_maxChunks == 0)
+        InvalidArgument("The number of chunks to prefetch must be greater than zero.");
+
+    // Loads are serialized by default, so one thread is all it takes.
+    size_t numThreads = m_config.m_concurrentLoads ? m_config.m_maxChunks : 1;
+    for (size_t i = 0; i < numThreads; ++i)
+        m_threads.emplace_back([this]() { Run(); });
+}
+
+ChunkPrefetcher::~ChunkPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_workAvailable.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+void ChunkPrefetcher::Schedule(const std::vector<std::pair<ChunkIdType, size_t>>& chunks)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Drop what is not needed any more.
+    std::set<ChunkIdType> wanted;
+    for (size_t i = 0; i < chunks.size() && i < m_config.m_maxChunks; ++i)
+        wanted.insert(chunks[i].first);
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (it->second.m_state == State::Loading || wanted.find(it->first) != wanted.end())
+        {
+            ++it;
+            continue;
+        }
+
+        if (it->second.m_state == State::Queued)
+            m_queue.erase(std::find(m_queue.begin(), m_queue.end(), it->first));
+        m_bytes -= it->second.m_bytes;
+        it = m_entries.erase(it);
+    }
+
+    // Queue new ones, in order, as long as there is room.
+    bool added = false;
+    for (const auto& chunk : chunks)
+    {
+        if (m_entries.size() >= m_config.m_maxChunks)
+            break;
+
+        if (m_entries.find(chunk.first) != m_entries.end())
+            continue;
+
+        size_t bytes = chunk.second * m_bytesPerSample;
+        if (m_config.m_memoryBudget != 0 && !m_entries.empty() && m_bytes + bytes > m_config.m_memoryBudget)
+            break;
+
+        m_entries[chunk.first] = Entry{ State::Queued, bytes, nullptr, nullptr };
+        m_queue.push_back(chunk.first);
+        m_bytes += bytes;
+        added = true;
+    }
+
+    lock.unlock();
+    if (added)
+        m_workAvailable.notify_all();
+}
+
+ChunkPtr ChunkPrefetcher::Get(ChunkIdType chunkId)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(chunkId);
+    if (it == m_entries.end() || it->second.m_state == State::Queued)
+    {
+        // Not started yet, load it right here instead of waiting for a thread to pick it up.
+        if (it != m_entries.end())
+        {
+            m_queue.erase(std::find(m_queue.begin(), m_queue.end(), chunkId));
+            m_bytes -= it->second.m_bytes;
+            m_entries.erase(it);
+        }
+        lock.unlock();
+        return Load(chunkId);
+    }
+
+    m_chunkLoaded.wait(lock, [&]() { return it->second.m_state == State::Loaded; });
+
+    ChunkPtr chunk = it->second.m_chunk;
+    std::exception_ptr error = it->second.m_error;
+    m_bytes -= it->second.m_bytes;
+    m_entries.erase(it);
+    lock.unlock();
+
+    if (error)
+        std::rethrow_exception(error);
+    return chunk;
+}
+
+size_t ChunkPrefetcher::NumberOfChunks()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+ChunkPtr ChunkPrefetcher::Load(ChunkIdType chunkId)
+{
+    ScopeProfile profile(profilerEvtLoadChunk);
+    if (m_config.m_concurrentLoads)
+        return m_deserializer->GetChunk(chunkId);
+
+    std::lock_guard<std::mutex> lock(m_deserializerMutex);
+    return m_deserializer->GetChunk(chunkId);
+}
+
+void ChunkPrefetcher::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_workAvailable.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_stop)
+            return;
+
+        ChunkIdType chunkId = m_queue.front();
+        m_queue.pop_front();
+        m_entries[chunkId].m_state = State::Loading;
+        lock.unlock();
+
+        ChunkPtr chunk;
+        std::exception_ptr error;
+        try
+        {
+            chunk = Load(chunkId);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        // Entries that are loading are never removed, except by Get() once they are loaded.
+        auto& entry = m_entries[chunkId];
+        entry.m_chunk = chunk;
+        entry.m_error = error;
+        entry.m_state = State::Loaded;
+        m_chunkLoaded.notify_all();
+    }
+}
+
+}
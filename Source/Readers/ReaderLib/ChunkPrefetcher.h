@@ -0,0 +1,85 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DataDeserializer.h"
+#include "ReaderUtil.h"
+
+namespace CNTK {
+
+// Loads chunks of a deserializer ahead of time on a dedicated pool of I/O threads.
+// The randomizer tells the prefetcher which chunks it is going to need next (in the order it needs them),
+// and takes them out once it needs them, waiting for loads that are still in flight.
+// At most 'm_maxChunks' chunks are prefetched (queued, being loaded, or loaded but not yet taken) at any time,
+// and their estimated size stays within the memory budget, except for the first one.
+class ChunkPrefetcher
+{
+public:
+    // 'bytesPerSample' is used to estimate the memory a chunk takes, given its number of samples.
+    ChunkPrefetcher(DataDeserializerPtr deserializer, const ChunkPrefetchConfiguration& config, size_t bytesPerSample);
+
+    // Waits for all loads in flight.
+    ~ChunkPrefetcher();
+
+    // Sets the chunks to prefetch next, as pairs of original chunk id and number of samples, in the order they are needed.
+    // Prefetched chunks that are not in the list any more are dropped, unless their load is in flight.
+    void Schedule(const std::vector<std::pair<ChunkIdType, size_t>>& chunks);
+
+    // Returns the chunk, waiting if it is still being loaded, and removes it from the prefetcher.
+    // Chunks that have not been prefetched are loaded on the calling thread.
+    ChunkPtr Get(ChunkIdType chunkId);
+
+    // Number of chunks prefetched at the moment.
+    size_t NumberOfChunks();
+
+private:
+    enum class State
+    {
+        Queued,
+        Loading,
+        Loaded
+    };
+
+    struct Entry
+    {
+        State m_state;
+        size_t m_bytes;
+        ChunkPtr m_chunk;
+        std::exception_ptr m_error;
+    };
+
+    void Run();
+
+    ChunkPtr Load(ChunkIdType chunkId);
+
+    DataDeserializerPtr m_deserializer;
+    ChunkPrefetchConfiguration m_config;
+    size_t m_bytesPerSample;
+
+    std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_chunkLoaded;
+    std::map<ChunkIdType, Entry> m_entries;
+    std::deque<ChunkIdType> m_queue;
+    size_t m_bytes;
+    bool m_stop;
+
+    // Serializes calls to the deserializer, unless it supports concurrent loads.
+    std::mutex m_deserializerMutex;
+
+    std::vector<std::thread> m_threads;
+
+    DISABLE_COPY_AND_MOVE(ChunkPrefetcher);
+};
+
+}
@@ -48,6 +48,12 @@ public:
         return m_numericSequenceKeys;
     }
 
+    // True if symbolic sequence keys are mapped to ids by hashing (and cannot be mapped back).
+    bool IsHashingSequenceKeys() const
+    {
+        return m_useHash;
+    }
+
     // By default include all sequences.
     CorpusDescriptor(bool numericSequenceKeys, bool useHash = false)
         : m_includeAll(true), m_numericSequenceKeys(numericSequenceKeys), m_useHash(useHash)
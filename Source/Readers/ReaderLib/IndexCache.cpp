@@ -0,0 +1,313 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+#include "IndexCache.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "fileutil.h"
+
+namespace CNTK {
+
+using namespace std;
+
+// Cache file layout (native byte order):
+//     header:  magic (8 bytes), version (uint32), payload size (uint64), payload checksum (uint64)
+//     payload: input path, input size, input modification time, configuration, key mode, flags,
+//              number of sequences, and for each sequence: key, number of samples, file offset, size in bytes,
+//              number of skipped keys, and for each: number of sequences preceding it, key (symbolic keys only)
+// Strings are stored as uint32 length followed by the characters.
+static const char s_magic[8] = { 'C', 'N', 'T', 'K', 'I', 'D', 'X', '\0' };
+static const uint32_t s_version = 2;
+static const size_t s_headerSize = sizeof(s_magic) + sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+enum : uint8_t
+{
+    NumericKeys = 0,  // sequence ids are stored as numbers (numeric or hashed keys)
+    SymbolicKeys = 1, // the symbolic keys are stored, and mapped to ids by the corpus on load
+};
+
+// FNV-1a
+static uint64_t Checksum(const char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+class CacheWriter
+{
+    vector<char>& m_data;
+
+public:
+    CacheWriter(vector<char>& data) : m_data(data) {}
+
+    template <class T>
+    void Write(const T& value)
+    {
+        const char* p = reinterpret_cast<const char*>(&value);
+        m_data.insert(m_data.end(), p, p + sizeof(T));
+    }
+
+    void Write(const string& value)
+    {
+        Write(static_cast<uint32_t>(value.size()));
+        m_data.insert(m_data.end(), value.begin(), value.end());
+    }
+};
+
+// Reads from a memory block, fails instead of reading beyond its end.
+class CacheReader
+{
+    const char* m_current;
+    const char* m_end;
+
+public:
+    CacheReader(const char* begin, const char* end) : m_current(begin), m_end(end) {}
+
+    template <class T>
+    bool Read(T& value)
+    {
+        if (static_cast<size_t>(m_end - m_current) < sizeof(T))
+            return false;
+        memcpy(&value, m_current, sizeof(T));
+        m_current += sizeof(T);
+        return true;
+    }
+
+    bool Read(string& value)
+    {
+        uint32_t size;
+        if (!Read(size) || static_cast<size_t>(m_end - m_current) < size)
+            return false;
+        value.assign(m_current, size);
+        m_current += size;
+        return true;
+    }
+
+    bool AtEnd() const { return m_current == m_end; }
+};
+
+// Gets size and modification time of a file, returns false if it does not exist.
+static bool GetFileStatus(const wstring& path, uint64_t& size, int64_t& modificationTime)
+{
+#ifdef _WIN32
+    struct _stat64 status;
+    if (_wstat64(path.c_str(), &status) != 0)
+        return false;
+    modificationTime = static_cast<int64_t>(status.st_mtime);
+#else
+    struct stat status;
+    if (stat(wtocharpath(path).c_str(), &status) != 0)
+        return false;
+    modificationTime = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+    size = static_cast<uint64_t>(status.st_size);
+    return true;
+}
+
+IndexCache::IndexCache(const wstring& inputPath, const string& configuration)
+    : m_inputPath(inputPath),
+      m_cachePath(inputPath + L".cntkidx"),
+      m_configuration(configuration),
+      m_inputSize(0),
+      m_inputModificationTime(0)
+{
+    // Taken before the input is indexed, so that a file that changes while being indexed results in a stale cache.
+    m_inputExists = GetFileStatus(m_inputPath, m_inputSize, m_inputModificationTime);
+}
+
+uint8_t IndexCache::KeyMode(const CorpusDescriptorPtr& corpus)
+{
+    return corpus->IsNumericSequenceKeys() || corpus->IsHashingSequenceKeys() ? NumericKeys : SymbolicKeys;
+}
+
+bool IndexCache::TryLoad(Index& index, CorpusDescriptorPtr corpus, uint64_t& flags) const
+{
+    if (!m_inputExists || !index.IsEmpty() || !fexists(m_cachePath))
+        return false;
+
+    // read the whole cache in one go
+    vector<char> data;
+    {
+        auto file = shared_ptr<FILE>(_wfopen(m_cachePath.c_str(), L"rb"), [](FILE* f) { if (f) fclose(f); });
+        if (!file)
+            return false;
+        int64_t size = filesize(file.get());
+        if (size < (int64_t)s_headerSize)
+            return false;
+        data.resize(static_cast<size_t>(size));
+        if (fread(data.data(), 1, data.size(), file.get()) != data.size())
+            return false;
+    }
+
+    CacheReader header(data.data(), data.data() + s_headerSize);
+    char magic[sizeof(s_magic)];
+    uint32_t version;
+    uint64_t payloadSize, checksum;
+    if (!header.Read(magic) || memcmp(magic, s_magic, sizeof(s_magic)) != 0 ||
+        !header.Read(version) || version != s_version ||
+        !header.Read(payloadSize) || payloadSize != data.size() - s_headerSize ||
+        !header.Read(checksum) || checksum != Checksum(data.data() + s_headerSize, payloadSize))
+    {
+        fprintf(stderr, "WARNING: Ignoring invalid index cache '%ls', rebuilding the index.\n", m_cachePath.c_str());
+        return false;
+    }
+
+    CacheReader payload(data.data() + s_headerSize, data.data() + data.size());
+    string inputPath, configuration;
+    uint64_t inputSize, numberOfSequences;
+    int64_t inputModificationTime;
+    uint8_t keyMode;
+    if (!payload.Read(inputPath) || !payload.Read(inputSize) || !payload.Read(inputModificationTime) ||
+        !payload.Read(configuration) || !payload.Read(keyMode) || !payload.Read(flags) ||
+        !payload.Read(numberOfSequences))
+        return false;
+
+    if (inputPath != msra::strfun::utf8(m_inputPath) || inputSize != m_inputSize ||
+        inputModificationTime != m_inputModificationTime || configuration != m_configuration ||
+        keyMode != KeyMode(corpus))
+        return false; // stale
+
+    // Parse everything before touching the index or the corpus.
+    struct CachedSequence
+    {
+        size_t m_id;
+        uint32_t m_numberOfSamples;
+        uint64_t m_offset;
+        uint32_t m_size;
+    };
+    vector<CachedSequence> sequences;
+    vector<string> keys;
+    if (numberOfSequences > payloadSize) // each sequence takes several bytes, this is a corrupted count
+        return false;
+    sequences.resize(static_cast<size_t>(numberOfSequences));
+    if (keyMode == SymbolicKeys)
+        keys.resize(sequences.size());
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+        auto& s = sequences[i];
+        uint64_t id = 0;
+        bool ok = keyMode == SymbolicKeys ? payload.Read(keys[i]) : payload.Read(id);
+        if (!ok || !payload.Read(s.m_numberOfSamples) || !payload.Read(s.m_offset) || !payload.Read(s.m_size) ||
+            s.m_offset + s.m_size > m_inputSize)
+            return false;
+        s.m_id = static_cast<size_t>(id);
+    }
+
+    uint64_t numberOfSkippedKeys;
+    if (!payload.Read(numberOfSkippedKeys) || numberOfSkippedKeys > payloadSize)
+        return false;
+    vector<pair<uint64_t, string>> skippedKeys(static_cast<size_t>(numberOfSkippedKeys));
+    for (size_t i = 0; i < skippedKeys.size(); ++i)
+    {
+        auto& k = skippedKeys[i];
+        if (!payload.Read(k.first) || !payload.Read(k.second) || k.first > sequences.size() ||
+            (i > 0 && k.first < skippedKeys[i - 1].first))
+            return false;
+    }
+    if (!payload.AtEnd())
+        return false;
+
+    // Replaying the sequences reproduces the chunks of the original index, since the chunk size is part of the configuration.
+    // The skipped keys are registered in between, where indexing the input registered them.
+    auto skippedKey = skippedKeys.begin();
+    for (size_t i = 0; i <= sequences.size(); ++i)
+    {
+        for (; skippedKey != skippedKeys.end() && skippedKey->first == i; ++skippedKey)
+            corpus->KeyToId(skippedKey->second);
+        if (i == sequences.size())
+            break;
+
+        const auto& s = sequences[i];
+        size_t id = keyMode == SymbolicKeys ? corpus->KeyToId(keys[i]) : s.m_id;
+        index.AddSequence(SequenceDescriptor{ id, s.m_numberOfSamples }, s.m_offset, s.m_offset + s.m_size);
+    }
+    return true;
+}
+
+void IndexCache::Save(const Index& index, CorpusDescriptorPtr corpus, uint64_t flags, const vector<pair<size_t, size_t>>& skippedKeys) const
+{
+    if (!m_inputExists)
+        return;
+
+    uint64_t numberOfSequences = 0;
+    for (const auto& chunk : index.Chunks())
+        numberOfSequences += chunk.Sequences().size();
+
+    uint8_t keyMode = KeyMode(corpus);
+    vector<char> data(s_headerSize);
+    CacheWriter payload(data);
+    payload.Write(msra::strfun::utf8(m_inputPath));
+    payload.Write(m_inputSize);
+    payload.Write(m_inputModificationTime);
+    payload.Write(m_configuration);
+    payload.Write(keyMode);
+    payload.Write(flags);
+    payload.Write(numberOfSequences);
+    for (const auto& chunk : index.Chunks())
+    {
+        for (const auto& sequence : chunk.Sequences())
+        {
+            if (keyMode == SymbolicKeys)
+                payload.Write(corpus->IdToKey(sequence.m_key));
+            else
+                payload.Write(static_cast<uint64_t>(sequence.m_key));
+            payload.Write(sequence.m_numberOfSamples);
+            payload.Write(static_cast<uint64_t>(chunk.m_offset + sequence.OffsetInChunk()));
+            payload.Write(sequence.SizeInBytes());
+        }
+    }
+
+    // numeric and hashed keys are not registered with the corpus, so only symbolic ones need to be replayed
+    if (keyMode == SymbolicKeys)
+    {
+        payload.Write(static_cast<uint64_t>(skippedKeys.size()));
+        for (const auto& k : skippedKeys)
+        {
+            payload.Write(static_cast<uint64_t>(k.first));
+            payload.Write(corpus->IdToKey(k.second));
+        }
+    }
+    else
+        payload.Write(static_cast<uint64_t>(0));
+
+    uint64_t payloadSize = data.size() - s_headerSize;
+    uint64_t checksum = Checksum(data.data() + s_headerSize, payloadSize);
+    char* p = data.data();
+    memcpy(p, s_magic, sizeof(s_magic)), p += sizeof(s_magic);
+    memcpy(p, &s_version, sizeof(s_version)), p += sizeof(s_version);
+    memcpy(p, &payloadSize, sizeof(payloadSize)), p += sizeof(payloadSize);
+    memcpy(p, &checksum, sizeof(checksum));
+
+    // Write to a temporary file first and rename it, so that concurrent readers (e.g. other workers
+    // of a distributed job) never see a partially written cache.
+    wstring temporaryPath = m_cachePath + L"." + to_wstring(GetCurrentProcessId()) + L".tmp";
+    FILE* file = _wfopen(temporaryPath.c_str(), L"wb");
+    if (!file)
+    {
+        fprintf(stderr, "WARNING: Cannot write the index cache '%ls'.\n", m_cachePath.c_str());
+        return;
+    }
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    written = fclose(file) == 0 && written;
+    try
+    {
+        if (!written)
+            RuntimeError("error writing file '%ls'", temporaryPath.c_str());
+        renameOrDie(temporaryPath, m_cachePath);
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "WARNING: Cannot write the index cache '%ls': %s\n", m_cachePath.c_str(), e.what());
+        _wunlink(temporaryPath.c_str());
+    }
+}
+
+}
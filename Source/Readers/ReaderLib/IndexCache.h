@@ -0,0 +1,56 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Indexer.h"
+
+namespace CNTK {
+
+// Persists an Index in a sidecar file next to the input file (<input>.cntkidx), so that repeated runs
+// do not have to scan the whole input again.
+// The cache is keyed by the path, size and modification time of the input, and by a description of the
+// indexer configuration. A cache that does not match, or that is truncated or corrupted, is ignored
+// (and overwritten by the next Save()).
+class IndexCache
+{
+public:
+    // 'configuration' describes everything besides the input file that the index depends on,
+    // e.g. the indexer type and its settings.
+    IndexCache(const std::wstring& inputPath, const std::string& configuration);
+
+    // Fills the (empty) index from the cache, returns false if there is no valid cache.
+    // Symbolic sequence keys are registered with the corpus in the same order as indexing the input would.
+    // 'flags' returns the value passed to Save().
+    bool TryLoad(Index& index, CorpusDescriptorPtr corpus, uint64_t& flags) const;
+
+    // Writes the index to the cache, together with indexer specific flags.
+    // 'skippedKeys' are the ids of keys that indexing registered with the corpus for sequences it then left out of the index
+    // (e.g. invalid utterances), each with the number of sequences in the index before it; TryLoad() registers them again.
+    // Failures (e.g. a read-only input directory) are reported as warnings only.
+    void Save(const Index& index, CorpusDescriptorPtr corpus, uint64_t flags,
+              const std::vector<std::pair<size_t, size_t>>& skippedKeys = std::vector<std::pair<size_t, size_t>>()) const;
+
+    const std::wstring& CachePath() const { return m_cachePath; }
+
+private:
+    // Returns how sequence keys are stored in the cache for the given corpus.
+    static uint8_t KeyMode(const CorpusDescriptorPtr& corpus);
+
+    std::wstring m_inputPath;
+    std::wstring m_cachePath;
+    std::string m_configuration;
+    uint64_t m_inputSize;
+    int64_t m_inputModificationTime;
+    bool m_inputExists;
+
+    DISABLE_COPY_AND_MOVE(IndexCache);
+};
+
+}
@@ -9,6 +9,9 @@
 #include "Indexer.h"
 #include <boost/utility/string_ref.hpp>
 #include <boost/algorithm/string.hpp>
+#include <thread>
+#include "ExceptionCapture.h"
+#include "IndexCache.h"
 
 using std::string;
 
@@ -20,13 +23,32 @@ Indexer::Indexer(FILE* file, bool primary, bool skipSequenceIds, char streamPref
     m_file(file),
     m_hasSequenceIds(!skipSequenceIds),
     m_index(chunkSize, primary),
-    m_mainStream(mainStream)
+    m_mainStream(mainStream),
+    m_numThreads(1),
+    m_minBytesPerThread(0),
+    m_bufferSize(bufferSize)
 {
     if (m_file == nullptr)
         RuntimeError("Input file not open for reading");
     m_fileSize = filesize(file);
 }
 
+void Indexer::SetParallelism(const std::wstring& filename, size_t numThreads, size_t minBytesPerThread)
+{
+    m_filename = filename;
+    m_numThreads = numThreads != 0 ? numThreads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    m_minBytesPerThread = std::max<size_t>(minBytesPerThread, 1);
+}
+
+void Indexer::SetIndexCache(const std::wstring& filename)
+{
+    // everything that changes the index, except for 'primary' which only affects the key lookup built after loading
+    char configuration[256];
+    sprintf(configuration, "CNTKTextFormat skipSequenceIds=%d streamPrefix=%d chunkSize=%zu mainStream=",
+            (int)!m_hasSequenceIds, (int)m_streamPrefix, m_index.m_maxChunkSize);
+    m_cache = std::make_shared<IndexCache>(filename, configuration + m_mainStream);
+}
+
 void Indexer::BuildFromLines()
 {
     m_hasSequenceIds = false;
@@ -59,6 +81,23 @@ void Indexer::Build(CorpusDescriptorPtr corpus)
         return;
     }
 
+    uint64_t hasSequenceIds;
+    if (m_cache && m_cache->TryLoad(m_index, corpus, hasSequenceIds))
+    {
+        m_hasSequenceIds = hasSequenceIds != 0;
+        m_index.MapSequenceKeyToLocation();
+        fsetpos(m_file, m_fileSize); // where indexing would have left it
+        return;
+    }
+
+    BuildFromFile(corpus);
+
+    if (m_cache)
+        m_cache->Save(m_index, corpus, m_hasSequenceIds);
+}
+
+void Indexer::BuildFromFile(CorpusDescriptorPtr corpus)
+{
     // Create a lambda to read symbolic or numeric sequence ids,
     // depending on what the corpus expects.
     std::function<bool(size_t&)> tryGetSequenceId;
@@ -85,7 +124,17 @@ void Indexer::Build(CorpusDescriptorPtr corpus)
             RuntimeError("Corpus expects non-numeric sequence keys present but the input file does not have them."
                 "Please use the configuration to enable numeric keys instead.");
 
-        BuildFromLines();
+        if (GetNumRanges(m_buffer.GetFileOffset()) > 1)
+            BuildInParallel(corpus, m_buffer.GetFileOffset(), /*fromLines=*/true);
+        else
+            BuildFromLines();
+        m_index.MapSequenceKeyToLocation();
+        return;
+    }
+
+    if (GetNumRanges(m_buffer.GetFileOffset()) > 1)
+    {
+        BuildInParallel(corpus, m_buffer.GetFileOffset(), /*fromLines=*/false);
         m_index.MapSequenceKeyToLocation();
         return;
     }
@@ -131,6 +180,213 @@ void Indexer::Build(CorpusDescriptorPtr corpus)
     m_index.MapSequenceKeyToLocation();
 }
 
+size_t Indexer::GetNumRanges(int64_t dataStart) const
+{
+    if (m_filename.empty() || m_numThreads <= 1)
+        return 1;
+    size_t maxRanges = static_cast<size_t>(m_fileSize - dataStart) / m_minBytesPerThread;
+    return std::max<size_t>(std::min(m_numThreads, maxRanges), 1);
+}
+
+void Indexer::BuildInParallel(CorpusDescriptorPtr corpus, int64_t dataStart, bool fromLines)
+{
+    if (fromLines)
+        m_hasSequenceIds = false;
+
+    size_t numRanges = GetNumRanges(dataStart);
+    int64_t rangeSize = (m_fileSize - dataStart + numRanges - 1) / numRanges;
+    std::vector<IndexedRange> ranges(numRanges);
+
+    ExceptionCapture capture;
+#pragma omp parallel for schedule(static, 1) num_threads((int) numRanges)
+    for (int i = 0; i < (int) numRanges; ++i)
+    {
+        capture.SafeRun([this, corpus, dataStart, rangeSize, fromLines, &ranges](int i)
+        {
+            int64_t begin = dataStart + i * rangeSize;
+            int64_t end = std::min(begin + rangeSize, m_fileSize);
+            IndexRange(corpus, dataStart, begin, end, fromLines, ranges[i]);
+        }, i);
+    }
+    capture.RethrowIfHappened();
+
+    // The ranges are merged in file order, so that the chunks come out exactly as with a single pass.
+    if (fromLines)
+    {
+        size_t lineNumber = 0;
+        for (size_t i = 0; i < numRanges; ++i)
+        {
+            const auto& lineOffsets = ranges[i].m_lineOffsets;
+            for (size_t j = 0; j < lineOffsets.size(); ++j, ++lineNumber)
+            {
+                int64_t lineEnd = m_fileSize;
+                if (j + 1 < lineOffsets.size())
+                    lineEnd = lineOffsets[j + 1];
+                else
+                {
+                    for (size_t k = i + 1; k < numRanges; ++k)
+                    {
+                        if (!ranges[k].m_lineOffsets.empty())
+                        {
+                            lineEnd = ranges[k].m_lineOffsets.front();
+                            break;
+                        }
+                    }
+                }
+                m_index.AddSequence(SequenceDescriptor{ lineNumber, 1 }, lineOffsets[j], lineEnd);
+            }
+        }
+    }
+    else
+    {
+        bool hasSequence = false;
+        size_t previousId = 0;
+        int64_t sequenceOffset = 0;
+        uint32_t numberOfSamples = 0;
+        for (const auto& range : ranges)
+        {
+            for (const auto& run : range.m_runs)
+            {
+                size_t id = 0;
+                if (run.m_hasId)
+                    id = corpus->IsNumericSequenceKeys() ? run.m_id : corpus->KeyToId(run.m_key);
+
+                if (!hasSequence)
+                {
+                    if (!run.m_hasId)
+                        RuntimeError("Expected a sequence id at the offset %" PRIi64 ", none was found.", run.m_offset);
+                    hasSequence = true;
+                }
+                else if (!run.m_hasId || id == previousId)
+                {
+                    numberOfSamples += run.m_numberOfSamples;
+                    continue;
+                }
+                else
+                    m_index.AddSequence(SequenceDescriptor{ previousId, numberOfSamples }, sequenceOffset, run.m_offset);
+
+                sequenceOffset = run.m_offset;
+                previousId = id;
+                numberOfSamples = run.m_numberOfSamples;
+            }
+        }
+
+        m_index.AddSequence(SequenceDescriptor{ previousId, numberOfSamples }, sequenceOffset, m_fileSize);
+    }
+
+    // leave the file where the sequential pass would have left it
+    fsetpos(m_file, m_fileSize);
+}
+
+void Indexer::IndexRange(CorpusDescriptorPtr corpus, int64_t dataStart, int64_t begin, int64_t end, bool fromLines, IndexedRange& range) const
+{
+    auto file = std::shared_ptr<FILE>(fopenOrDie(m_filename, L"rbS"), [](FILE* f) { if (f) fclose(f); });
+
+    // A range owns the lines that start within it. Unless it is the first one, it starts reading one byte early
+    // to find out whether its first byte begins a line.
+    int64_t bufferOffset = begin > dataStart ? begin - 1 : begin; // file offset of buffer[0]
+    fsetpos(file.get(), bufferOffset);
+    bool synchronized = begin == dataStart;
+    int64_t lineOffset = begin;
+
+    bool numericKeys = corpus->IsNumericSequenceKeys();
+    auto processLine = [&](const char* line, size_t length, bool terminated)
+    {
+        if (fromLines)
+        {
+            range.m_lineOffsets.push_back(lineOffset);
+            return;
+        }
+
+        // the same as TryGetNumericSequenceId()/TryGetSymbolicSequenceId() and SkipLineWithCheck(), on a complete line
+        size_t pos = 0;
+        size_t id = 0;
+        if (numericKeys)
+        {
+            for (; pos < length && isdigit(line[pos]); ++pos)
+            {
+                size_t temp = id;
+                id = id * 10 + (line[pos] - '0');
+                if (temp > id)
+                    RuntimeError("Overflow while reading a numeric sequence id (%zu-bit value).", sizeof(id));
+            }
+        }
+        else
+        {
+            while (pos < length && !isspace(line[pos]))
+                ++pos;
+        }
+
+        // (an id that is not followed by anything, not even a newline, does not count)
+        bool hasId = pos > 0 && (pos < length || terminated);
+        uint32_t isSample = m_mainStream.empty() || boost::string_ref(line + pos, length - pos).find(m_mainStream) != boost::string_ref::npos;
+        auto& runs = range.m_runs;
+        if (!runs.empty() && (!hasId || (numericKeys ? runs.back().m_id == id : runs.back().m_key.compare(0, string::npos, line, pos) == 0)))
+            runs.back().m_numberOfSamples += isSample;
+        else
+            runs.push_back(SequenceRun{ lineOffset, isSample, hasId, id, numericKeys ? string() : string(line, pos) });
+    };
+
+    std::vector<char> buffer(m_bufferSize);
+    size_t filled = 0;
+    for (;;)
+    {
+        if (filled == buffer.size()) // a line longer than the buffer
+            buffer.resize(2 * buffer.size());
+        size_t bytesRead = fread(buffer.data() + filled, 1, buffer.size() - filled, file.get());
+        if (ferror(file.get()))
+            RuntimeError("Could not read from the input file.");
+        bool eof = bytesRead == 0;
+        filled += bytesRead;
+
+        size_t pos = 0;
+        if (!synchronized)
+        {
+            auto newLine = (const char*)memchr(buffer.data(), g_rowDelimiter, filled);
+            if (!newLine)
+            {
+                if (eof || bufferOffset + (int64_t)filled >= end)
+                    return; // no line starts in this range
+                bufferOffset += filled;
+                filled = 0;
+                continue;
+            }
+            pos = newLine - buffer.data() + 1;
+            lineOffset = bufferOffset + pos;
+            synchronized = true;
+        }
+        else
+            pos = static_cast<size_t>(lineOffset - bufferOffset);
+
+        while (lineOffset < end)
+        {
+            auto newLine = (const char*)memchr(buffer.data() + pos, g_rowDelimiter, filled - pos);
+            if (!newLine)
+            {
+                if (eof && pos < filled) // last line, not terminated by a newline
+                {
+                    processLine(buffer.data() + pos, filled - pos, /*terminated=*/false);
+                    pos = filled;
+                    lineOffset = bufferOffset + pos;
+                }
+                break;
+            }
+
+            processLine(buffer.data() + pos, newLine - buffer.data() - pos, /*terminated=*/true);
+            pos = newLine - buffer.data() + 1;
+            lineOffset = bufferOffset + pos;
+        }
+
+        if (eof || lineOffset >= end)
+            return;
+
+        // keep the partial line
+        memmove(buffer.data(), buffer.data() + pos, filled - pos);
+        bufferOffset += pos;
+        filled -= pos;
+    }
+}
+
 void Indexer::SkipLine()
 {
     while (!m_buffer.Eof())
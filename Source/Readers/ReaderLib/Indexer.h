@@ -13,6 +13,8 @@
 
 namespace CNTK {
 
+class IndexCache;
+
 // Sequence metadata that allows indexing a sequence in a binary file.
 struct SequenceDescriptor
 {
@@ -206,7 +208,34 @@ public:
         return m_mainStream;
     }
 
+    // Enables building the index with several threads, each of which opens the file (filename) again and indexes
+    // a byte range of at least minBytesPerThread bytes. numThreads == 0 uses one thread per core.
+    // The resulting index is the same as the one built by a single thread.
+    void SetParallelism(const std::wstring& filename, size_t numThreads, size_t minBytesPerThread = 64 * 1024 * 1024);
+
+    // Keeps the index in a sidecar file of the input file (filename), and loads it from there
+    // instead of scanning the input if it is up to date (see IndexCache).
+    void SetIndexCache(const std::wstring& filename);
+
 private:
+    // Consecutive lines of a byte range that belong to the same sequence (parallel mode only).
+    struct SequenceRun
+    {
+        int64_t m_offset;           // file offset of the first line
+        uint32_t m_numberOfSamples;
+        bool m_hasId;               // false for lines at the start of a range that have no sequence id,
+                                    // they continue the last sequence of the previous range
+        size_t m_id;                // numeric sequence id
+        std::string m_key;          // symbolic sequence id
+    };
+
+    // Lines or sequences found in one byte range of the input (parallel mode only).
+    struct IndexedRange
+    {
+        std::vector<int64_t> m_lineOffsets; // when treating each line as a sequence
+        std::vector<SequenceRun> m_runs;    // otherwise
+    };
+
     FILE* m_file;
     int64_t m_fileSize;
     MemoryBuffer m_buffer;
@@ -244,6 +273,26 @@ private:
     // the corresponding sequence id.
     void BuildFromLines();
 
+    // Builds the index from the input file (Build() without the cache).
+    void BuildFromFile(CorpusDescriptorPtr corpus);
+
+    // Number of byte ranges to split [dataStart, fileSize) into for parallel indexing, 1 if indexing sequentially.
+    size_t GetNumRanges(int64_t dataStart) const;
+
+    // Same as BuildFromLines() (fromLines == true) or the sequence id based indexing of Build(),
+    // but with the data split into byte ranges that are indexed concurrently and then merged.
+    void BuildInParallel(CorpusDescriptorPtr corpus, int64_t dataStart, bool fromLines);
+
+    // Indexes the lines that start within [begin, end).
+    void IndexRange(CorpusDescriptorPtr corpus, int64_t dataStart, int64_t begin, int64_t end, bool fromLines, IndexedRange& range) const;
+
+    std::wstring m_filename;    // input file, required for parallel indexing
+    size_t m_numThreads;
+    size_t m_minBytesPerThread;
+    size_t m_bufferSize;
+
+    std::shared_ptr<IndexCache> m_cache; // null if the index is not cached
+
     DISABLE_COPY_AND_MOVE(Indexer);
 };
 
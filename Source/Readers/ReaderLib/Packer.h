@@ -20,6 +20,12 @@ public:
     // Flushes the internal state of the packer.
     virtual void Reset() {};
 
+    // Returns the state of the packer, which includes the state of its sequence enumerator.
+    virtual std::map<std::wstring, size_t> GetState() = 0;
+
+    // Restores a state returned by GetState().
+    virtual void SetState(const std::map<std::wstring, size_t>& state) = 0;
+
     virtual Minibatch ReadMinibatch() = 0;
     virtual std::vector<StreamInformation> GetStreamDescriptions() = 0;
 
@@ -16,6 +16,19 @@ namespace CNTK {
 // A base class for Packers.
 class PackerBase : public Packer
 {
+public:
+    // By default the packer keeps nothing read ahead across minibatches, so its state is the state of the sequence enumerator.
+    std::map<std::wstring, size_t> GetState() override
+    {
+        return m_sequenceEnumerator->GetState();
+    }
+
+    void SetState(const std::map<std::wstring, size_t>& state) override
+    {
+        m_sequenceEnumerator->SetState(state);
+        Reset();
+    }
+
 protected:
 
     struct StreamBuffer
@@ -55,6 +55,9 @@ void ReaderBase::StartEpoch(const EpochConfiguration& config, const std::map<std
 
     m_sequenceEnumerator->StartEpoch(config);
     m_packer->SetConfiguration(config, m_memoryProviders);
+
+    // Sequences the packer has read ahead belong to the previous position.
+    m_packer->Reset();
 }
 
 Minibatch ReaderBase::ReadMinibatch()
@@ -65,13 +68,12 @@ Minibatch ReaderBase::ReadMinibatch()
 
 std::map<std::wstring, size_t> ReaderBase::GetState()
 {
-    return m_sequenceEnumerator->GetState();
+    return m_packer->GetState();
 }
 
 void ReaderBase::SetState(const std::map<std::wstring, size_t>& state)
 {
-    m_sequenceEnumerator->SetState(state);
-    m_packer->Reset();
+    m_packer->SetState(state);
 }
 
 void ReaderBase::SetConfiguration(const ReaderConfiguration& config, const std::map<std::wstring, int>&)
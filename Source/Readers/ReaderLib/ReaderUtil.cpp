@@ -5,6 +5,7 @@
 
 #include "Config.h"
 #include "DataReader.h"
+#include "ReaderUtil.h"
 
 namespace CNTK {
     using namespace Microsoft::MSR::CNTK;
@@ -35,4 +36,14 @@ namespace CNTK {
         return randomizeAuto;
     }
 
+    ChunkPrefetchConfiguration GetChunkPrefetchConfigurationFromConfig(const ConfigParameters& config)
+    {
+        ChunkPrefetchConfiguration result;
+        result.m_maxChunks = config(L"prefetchChunks", result.m_maxChunks);
+        result.m_memoryBudget = config(L"prefetchMemoryBudgetInBytes", result.m_memoryBudget);
+        if (result.m_maxChunks == 0)
+            InvalidArgument("'prefetchChunks' must be greater than zero.");
+        return result;
+    }
+
 }
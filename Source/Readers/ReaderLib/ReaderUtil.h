@@ -14,6 +14,21 @@ namespace CNTK {
 
 size_t GetRandomizationWindowFromConfig(const Microsoft::MSR::CNTK::ConfigParameters& config);
 
+// Configuration of chunk prefetching in the BlockRandomizer.
+struct ChunkPrefetchConfiguration
+{
+    // Maximum number of chunks that are prefetched at a time.
+    size_t m_maxChunks = 1;
+
+    // Maximum estimated size of the prefetched chunks in bytes, 0 means no limit.
+    size_t m_memoryBudget = 0;
+
+    // Whether the deserializer supports concurrent GetChunk() calls. If so, up to m_maxChunks chunks are loaded in parallel.
+    bool m_concurrentLoads = false;
+};
+
+ChunkPrefetchConfiguration GetChunkPrefetchConfigurationFromConfig(const Microsoft::MSR::CNTK::ConfigParameters& config);
+
 inline size_t GetRandomSeed(const Microsoft::MSR::CNTK::ConfigParameters& config)
 {
     return config(L"randomizationSeed", size_t(0));
@@ -120,6 +120,9 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         // BUGBUG: We should discount gaps.
         actualMBSize = net->DetermineActualMBSizeFromFeatures();
 
+        // the input layouts are set now; adapt the memory sharing to them once, before any forward pass of this minibatch
+        net->PlanMemoryForMinibatch();
+
         return true;
     }
 
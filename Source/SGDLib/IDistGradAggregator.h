@@ -19,6 +19,18 @@ public:
     // Returns a boolean indicating if any samples were processed
     virtual bool AggregateGradients(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool resetState) = 0;
 
+    // Whether the aggregator can start aggregating a gradient during the backprop, see GradientReady()
+    virtual bool OverlapsBackprop() const
+    {
+        return false;
+    }
+
+    // Called during the backprop as soon as the given gradient is final, if OverlapsBackprop().
+    // gradientIndex is the position of the gradient in the vector passed to AggregateGradients().
+    // The aggregation started here is completed by the next AggregateGradients() call.
+    virtual void GradientReady(size_t /*gradientIndex*/, Matrix<ElemType>* /*gradient*/)
+    {}
+
     size_t NumProc()
     {
         return m_mpi->NumNodesInUse();
@@ -6,6 +6,7 @@
 #include "PostComputingActions.h"
 
 #include "TrainingNodes.h"
+#include "LinearAlgebraNodes.h"
 #include "ProgressTracing.h"
 #include "DataReaderHelpers.h"
 #include "SimpleDistGradAggregator.h"
@@ -154,6 +155,79 @@ void PostComputingActions<ElemType>::BatchNormalizationStatistics(IDataReader *
     return;
 }
 
+template <class ElemType>
+void PostComputingActions<ElemType>::Int8QuantizationCalibration(IDataReader* dataReader, const vector<wstring>& evalNodeNames,
+    const wstring newModelPath, const size_t mbSize, const int iters)
+{
+    ScopedNetworkOperationMode modeGuard(m_net, NetworkOperationMode::inferring);
+
+    let evalNodes = m_net->GetEvalNodesWithName(evalNodeNames);
+
+    // find the int8 nodes that the eval nodes depend on
+    std::vector<shared_ptr<QuantizedTimesNode<ElemType>>> quantizedNodes;
+    std::set<ComputationNodeBasePtr> quantizedNodesLogged;
+    for (auto& evalNode : evalNodes)
+    {
+        for (auto& node : m_net->GetEvalOrder(evalNode))
+        {
+            let quantizedNode = dynamic_pointer_cast<QuantizedTimesNode<ElemType>>(node);
+            if (quantizedNode && quantizedNode->IsInt8() && quantizedNodesLogged.insert(node).second)
+            {
+                quantizedNode->StartCalibration();
+                quantizedNodes.push_back(quantizedNode);
+            }
+        }
+    }
+    if (quantizedNodes.empty())
+        InvalidArgument("Int8QuantizationCalibration: The eval nodes do not depend on any int8 QuantizedTimes node.");
+
+    m_net->AllocateAllMatrices(evalNodes, std::vector<ComputationNodeBasePtr>(), nullptr);
+
+    auto& featureNodes = m_net->FeatureNodes();
+    StreamMinibatchInputs inputMatrices;
+    for (auto& node : featureNodes)
+        inputMatrices.AddInput(node->NodeName(), node->ValuePtr(), node->GetMBLayout(), node->GetSampleLayout());
+
+    bool useParallelTrain = (m_mpi != nullptr);
+    bool useDistributedMBReading = useParallelTrain && m_enableDistributedMBReading && dataReader->SupportsDistributedMBRead();
+
+    m_net->StartEvaluateMinibatchLoop(evalNodes);
+
+    if (useDistributedMBReading)
+        dataReader->StartDistributedMinibatchLoop(mbSize, 0, m_mpi->CurrentNodeRank(), m_mpi->NumNodesInUse(), inputMatrices.GetStreamDescriptions(), mbSize * iters);
+    else
+        dataReader->StartMinibatchLoop(mbSize, 0, inputMatrices.GetStreamDescriptions(), mbSize * iters);
+
+    // all nodes are calibrated in the same forward passes, since the ranges are maxima rather than averages,
+    // and upstream int8 nodes only need to be representative, not final
+    int iter = 0;
+    for (; iter < iters; iter++)
+    {
+        size_t actualMBSize = 0;
+        bool wasDataRead = DataReaderHelpers::GetMinibatchIntoNetwork<ElemType>(*dataReader, m_net,
+            nullptr, useDistributedMBReading, useParallelTrain, inputMatrices, actualMBSize, m_mpi);
+        if (!wasDataRead)
+            break;
+
+        ComputationNetwork::BumpEvalTimeStamp(featureNodes);
+        m_net->ForwardProp(evalNodes);
+    }
+    if (iter == 0)
+        LogicError("DataRead Failure in int8 quantization calibration");
+
+    dataReader->DataEnd();
+
+    for (auto& quantizedNode : quantizedNodes)
+    {
+        quantizedNode->EndCalibration();
+        LOGPRINTF(stderr, "Calibrated int8 input range --> %ls: %.6g\n", quantizedNode->GetName().c_str(), quantizedNode->InputRange());
+    }
+
+    // save model
+    if (!useParallelTrain || m_mpi->CurrentNodeRank() == m_mpi->MainNodeRank())
+        m_net->Save(newModelPath);
+}
+
 template class PostComputingActions<float>;
 template class PostComputingActions<double>;
 
@@ -52,6 +52,12 @@ public:
     void BatchNormalizationStatistics(IDataReader* dataReader, const vector<wstring>& evalNodeNames, const wstring newModelPath, 
         const size_t mbSize, const int iters = 30);
 
+    // Calibrates the input ranges of the int8 QuantizedTimes nodes (see ComputationNetwork::QuantizeTimesNodesToInt8())
+    // below the eval nodes: runs forward passes over 'iters' minibatches, freezes the largest absolute input value seen
+    // by each node as its range, and saves the model.
+    void Int8QuantizationCalibration(IDataReader* dataReader, const vector<wstring>& evalNodeNames, const wstring newModelPath,
+        const size_t mbSize, const int iters = 30);
+
 private:
     ComputationNetworkPtr m_net;
     MPIWrapperPtr m_mpi;
@@ -334,6 +334,8 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
     auto& learnableNodes = net->LearnableParameterNodes(criterionNodes[0]);
     list<Matrix<ElemType>> smoothedGradients;
     vector<double> smoothedCounts; // currently used by FSAdaGradUpdate()
+    m_lastUpdateSteps.clear();
+    m_numParameterUpdates = 0;
     size_t numParameters = 0;
 
     vector<wstring> nodesToUpdateDescriptions; // for logging only
@@ -347,6 +349,7 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
                                                      node->Value().GetNumCols(),
                                                      net->GetDeviceId()));
         smoothedCounts.push_back(0);
+        m_lastUpdateSteps.push_back(Matrix<double>(CPUDEVICE));
         if (node->IsParameterUpdateRequired())
         {
             nodesToUpdateDescriptions.push_back(node->NodeDescription() + L" : [" + msra::strfun::utf16(string(node->GetSampleLayout())) + L"]");
@@ -1032,6 +1035,16 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
     }
 
     std::vector<Matrix<ElemType>*> learnParamsGradients;
+    // index of each parameter's gradient in learnParamsGradients, for the aggregation overlapped with the backprop
+    std::unordered_map<ComputationNodeBasePtr, size_t> gradientIndexOfNode;
+    for (const auto& node : learnableNodes)
+    {
+        if (node->IsParameterUpdateRequired())
+        {
+            size_t index = gradientIndexOfNode.size();
+            gradientIndexOfNode[node] = index;
+        }
+    }
     Profiler profiler(m_numMBsToCUDAProfile);
 
     // resetting this, so profiling is performed for one epoch only
@@ -1253,7 +1266,20 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                 // ===========================================================
 
                 if (learnRatePerSample > 0.01 * m_minLearnRate) // only compute gradient when learning rate is large enough
-                    net->Backprop(criterionNodes[0]);
+                {
+                    // when the aggregator supports it, the aggregation of each gradient starts as soon as its backprop is done
+                    if (useGradientAggregation && actualNumSubminibatches == 1 && m_distGradAgg->OverlapsBackprop())
+                    {
+                        net->Backprop(criterionNodes[0], [this, &gradientIndexOfNode](const ComputationNodeBasePtr& node)
+                        {
+                            auto index = gradientIndexOfNode.find(node);
+                            if (index != gradientIndexOfNode.end())
+                                m_distGradAgg->GradientReady(index->second, &dynamic_pointer_cast<ComputationNode<ElemType>>(node)->Gradient());
+                        });
+                    }
+                    else
+                        net->Backprop(criterionNodes[0]);
+                }
 
                 // house-keeping for sub-minibatching
                 if (actualNumSubminibatches > 1)
@@ -1379,9 +1405,11 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
             if (numSamplesInMinibatch != aggregateNumSamples)
                 fprintf(stderr, "SGD: using true #samples %d instead of MB size %d\n", (int)numSamplesInMinibatch, (int)aggregateNumSamples);
 #endif
+            m_numParameterUpdates++;
             auto smoothedGradientIter = smoothedGradients.begin();
             auto smoothedCountIter = smoothedCounts.begin();
-            for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++, smoothedGradientIter++, smoothedCountIter++)
+            auto lastUpdateStepsIter = m_lastUpdateSteps.begin();
+            for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++, smoothedGradientIter++, smoothedCountIter++, lastUpdateStepsIter++)
             {
                 ComputationNodeBasePtr node = *nodeIter;
                 if (node->IsParameterUpdateRequired())
@@ -1398,6 +1426,7 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                     UpdateWeights(dynamic_pointer_cast<ComputationNode<ElemType>>(node)->Value(),
                                   dynamic_pointer_cast<ComputationNode<ElemType>>(node)->Gradient(),
                                   *smoothedGradientIter, *smoothedCountIter,
+                                  *lastUpdateStepsIter, (double) m_numParameterUpdates,
                                   nodeDependentLearningRatePerSample, momentumPerSample,
                                   numSamplesInMinibatch,
                                   m_L2RegWeight * nodeDependentRegMultiplier, m_L1RegWeight * nodeDependentRegMultiplier,
@@ -2286,9 +2315,12 @@ void SGD<ElemType>::InitDistGradAgg(int numEvalNodes, int numGradientBits, int d
         if (Globals::UseV2Aggregator()) // Currently used to check V2 against baselines.
             m_distGradAgg = std::make_shared<V2SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, deviceId, m_syncStatsTrace, ::CNTK::MPICommunicator(m_packThresholdSizeInBytes));
         else
-            m_distGradAgg = std::make_shared<SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, deviceId, m_syncStatsTrace, m_packThresholdSizeInBytes);
+            m_distGradAgg = std::make_shared<SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, deviceId, m_syncStatsTrace, m_packThresholdSizeInBytes, m_overlapGradientAggregation);
     }
 
+    if (m_overlapGradientAggregation && !m_distGradAgg->OverlapsBackprop())
+        fprintf(stderr, "WARNING: overlapGradientAggregation is only supported for non-quantized, non-buffered aggregation of gradients on the CPU, it will be ignored.\n");
+
     m_gradHeader.reset(DistGradHeader::Create(numEvalNodes), [](DistGradHeader* ptr) { DistGradHeader::Destroy(ptr); });
 }
 
@@ -2336,6 +2368,7 @@ void SGD<ElemType>::InitModelAggregationHandler(int traceLevel, DEVICEID_TYPE de
 template <class ElemType>
 void SGD<ElemType>::UpdateWeights(Matrix<ElemType>& functionValues, Matrix<ElemType>& gradientValues,
                                   Matrix<ElemType>& smoothedGradientValues, double& smoothedCount,
+                                  Matrix<double>& lastUpdateSteps, const double currentStep,
                                   const double learnRatePerSample, const double momentumPerSample,
                                               size_t actualMBSize,
                                   const double L2RegWeight, const double L1RegWeight,
@@ -2410,13 +2443,15 @@ void SGD<ElemType>::UpdateWeights(Matrix<ElemType>& functionValues, Matrix<ElemT
 
         smoothedGradientValues.FSAdagradUpdate(
                                          gradientValues, functionValues, targetAdagradAvDenom_x_sqrtAdagradSqrFrames,
-                                         learnRatePerSample, momentum, varMomentum);
+                                         learnRatePerSample, momentum, varMomentum, true /*unitGainMomentum*/,
+                                         &lastUpdateSteps, currentStep);
     }
     else if (adpType == GradientsUpdateType::RmsProp)
     {
         double aveMultiplier = smoothedGradientValues.RmsProp(gradientValues, (ElemType) m_rpi.gamma,
                                                         (ElemType) m_rpi.inc, (ElemType) m_rpi.max,
-                                                        (ElemType) m_rpi.dec, (ElemType) m_rpi.min, needAveMultiplier, true);
+                                                        (ElemType) m_rpi.dec, (ElemType) m_rpi.min, needAveMultiplier, true,
+                                                        &lastUpdateSteps, currentStep);
         Matrix<ElemType>::ScaleAndAdd((ElemType)(-learnRatePerSample / aveMultiplier), gradientValues, functionValues);
     }
 
@@ -2510,6 +2545,12 @@ void SGD<ElemType>::SaveCheckPointInfo(const size_t epoch, const size_t totalSam
 
             fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECount");
 
+            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BLastUpdateSteps");
+            fstream << m_numParameterUpdates;
+            for (const auto& lastUpdateSteps : m_lastUpdateSteps)
+                fstream << lastUpdateSteps;
+            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ELastUpdateSteps");
+
             if (m_saveBestModelPerCriterion)
             {
                 fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BCriteria");
@@ -2619,6 +2660,21 @@ void SGD<ElemType>::LoadCheckPointInfo(const size_t epochNumber,
     else // deal with legacy checkpoints
         std::fill(smoothedCounts.begin(), smoothedCounts.end(), static_cast<double>(minibatchSize));
 
+    // optional: without it, the columns absent from the gradients before the checkpoint was taken are not decayed for the steps they missed
+    if (fstream.TryGetMarker(FileMarker::fileMarkerBeginSection, L"BLastUpdateSteps"))
+    {
+        fstream >> m_numParameterUpdates;
+        for (auto& lastUpdateSteps : m_lastUpdateSteps)
+            fstream >> lastUpdateSteps;
+        fstream.GetMarker(FileMarker::fileMarkerEndSection, L"ELastUpdateSteps");
+    }
+    else
+    {
+        m_numParameterUpdates = 0;
+        for (auto& lastUpdateSteps : m_lastUpdateSteps)
+            lastUpdateSteps.Resize(0, 0);
+    }
+
     if (fstream.TryGetMarker(FileMarker::fileMarkerBeginSection, L"BCriteria"))
     {
         int32_t criteriaSize = 0;
@@ -3119,6 +3175,7 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
     m_numGradientBits = vector<int>{8 * (int)sizeofElemType}; // means no quantization
     m_zeroThresholdFor1Bit = true;
     m_bufferedAsyncGradientAggregation = false;
+    m_overlapGradientAggregation = false;
     m_enableDistributedMBReading = false;
     m_parallelizationStartEpochNum = 0;
     m_modelAggregationBlockSize = 0; 
@@ -3152,6 +3209,7 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
             m_numGradientBits = configDataParallelSGD(L"gradientBits", ConfigRecordType::Array(intargvector(vector<int>{defaultGradientBits})));
             m_zeroThresholdFor1Bit = configDataParallelSGD(L"useZeroThresholdFor1BitQuantization", true);
             m_bufferedAsyncGradientAggregation = configDataParallelSGD(L"useBufferedAsyncGradientAggregation", false);
+            m_overlapGradientAggregation = configDataParallelSGD(L"overlapGradientAggregation", false);
             for (size_t i = 0; i < m_numGradientBits.size(); i++)
             {
                 if (m_numGradientBits[i] < 1 || m_numGradientBits[i] > defaultGradientBits)
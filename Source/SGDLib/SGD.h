@@ -292,6 +292,7 @@ protected:
     // Data parallel SGD training parameters
     intargvector m_numGradientBits;
     bool m_bufferedAsyncGradientAggregation;
+    bool m_overlapGradientAggregation;
     bool m_zeroThresholdFor1Bit;
 
     // Parallel training related with MA / BM
@@ -360,6 +361,7 @@ public:
           m_traceNodeNamesCategory(configSGD(L"traceNodeNamesCategory", ConfigRecordType::Array(stringargvector()))),
           m_traceNodeNamesSparse  (configSGD(L"traceNodeNamesSparse",   ConfigRecordType::Array(stringargvector()))),
           m_prevChosenMinibatchSize(0),
+          m_numParameterUpdates(0),
           m_lastFinishedEpochTrainLoss(0.0),
           m_distGradAgg(nullptr),
           m_gradHeader(nullptr)
@@ -516,8 +518,11 @@ protected:
     void InitModelAggregationHandler(int traceLevel, DEVICEID_TYPE devID);
 public:
     // UpdateWeights() - actual weight update, implementing various update rules
+    // lastUpdateSteps, currentStep: per-column state of the lazy FSAdaGrad and RmsProp updates of block sparse gradients
+    // on the CPU, see CPUSparseMatrix::FSAdagrad()
     void UpdateWeights(Matrix<ElemType>& functionValues, Matrix<ElemType>& gradientValues,
                        Matrix<ElemType>& smoothedGradient, double& smoothedCount,
+                       Matrix<double>& lastUpdateSteps, const double currentStep,
                        const double learnRatePerSample, const double momentumPerSample,
                        size_t actualMBSize,
                        const double L2RegWeight, const double L1RegWeight,
@@ -588,6 +593,12 @@ protected:
     std::vector<std::wstring> m_traceNodeNamesSparse;
 
     size_t m_prevChosenMinibatchSize;
+
+    // The step of the last update of each column of each learnable parameter (in the order of the smoothed gradients; only
+    // allocated for block sparse gradients on the CPU), and the number of updates so far. Saved in the checkpoint.
+    std::list<Matrix<double>> m_lastUpdateSteps;
+    size_t m_numParameterUpdates;
+
     double m_lastFinishedEpochTrainLoss;
 
     std::shared_ptr<IDistGradAggregator<ElemType>> m_distGradAgg;
@@ -23,9 +23,11 @@ class SimpleDistGradAggregator : public IDistGradAggregator<ElemType>
     UsingIDistGradAggregatorMembers;
 
 public:
-    SimpleDistGradAggregator(const MPIWrapperPtr& mpi, bool useAsyncAggregation, int deviceId, int syncStatsTrace, size_t packThresholdSizeInBytes = DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES)
+    SimpleDistGradAggregator(const MPIWrapperPtr& mpi, bool useAsyncAggregation, int deviceId, int syncStatsTrace, size_t packThresholdSizeInBytes = DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES, bool overlapWithBackprop = false)
         : IDistGradAggregator<ElemType>(mpi), m_useAsyncAggregation(useAsyncAggregation), m_initialized(false), m_bufferedGradHeader(nullptr), m_syncStatsTrace(syncStatsTrace),
-        m_iterationCount(0), m_nccl(deviceId, mpi), m_packThresholdSizeInBytes(packThresholdSizeInBytes)
+        m_iterationCount(0), m_nccl(deviceId, mpi), m_packThresholdSizeInBytes(packThresholdSizeInBytes),
+        // Overlapping is currently only done for gradients in CPU memory, where they are final as soon as their backprop returns
+        m_overlapWithBackprop(overlapWithBackprop && !useAsyncAggregation && deviceId == CPUDEVICE), m_nextBucketToStart(0), m_numBucketsStartedInBackprop(0)
     {}
 
     ~SimpleDistGradAggregator()
@@ -37,6 +39,49 @@ public:
             DistGradHeader::Destroy(m_bufferedGradHeader);
     }
 
+    bool OverlapsBackprop() const override
+    {
+        return m_overlapWithBackprop;
+    }
+
+    // Start the all-reduce of the buckets that are complete with this gradient.
+    void GradientReady(size_t gradientIndex, Matrix<ElemType>* gradient) override
+    {
+        if (!m_overlapWithBackprop)
+            return;
+
+        // The first time, only record the order in which the gradients become ready, the buckets are formed from it
+        if (!m_initialized)
+        {
+            m_gradientReadyOrder.push_back(gradientIndex);
+            return;
+        }
+
+        if (gradientIndex >= m_bucketOfGradient.size())
+            LogicError("SimpleDistGradAggregator: Gradient index %d is out of range.", (int)gradientIndex);
+
+        // The buckets are formed by gradient index; the matrix is taken from the current call, since it may have been
+        // replaced since the buckets were formed.
+        m_bucketGradients[gradientIndex] = gradient;
+        auto& bucket = m_buckets[m_bucketOfGradient[gradientIndex]];
+        bucket.m_numReady++;
+        assert(bucket.m_numReady <= bucket.m_gradientIndices.size());
+
+        if (m_nextBucketToStart == 0 && bucket.m_numReady == 1)
+            m_backpropOverlapTimer.Start();
+
+        size_t numStarted = m_nextBucketToStart;
+        StartReadyBuckets();
+        m_numBucketsStartedInBackprop += m_nextBucketToStart - numStarted;
+
+        // Let MPI make progress on the reductions in flight while the backprop goes on
+        if (m_nextBucketToStart > 0)
+        {
+            int completed;
+            m_mpi->Testall((int)m_bucketRequests.size(), m_bucketRequests.data(), &completed, MPI_STATUSES_IGNORE) || MpiFail("MPI_Testall");
+        }
+    }
+
     // Aggregate the gradient matrices across all nodes
     bool AggregateGradients(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool resetState) override
     {
@@ -44,7 +89,12 @@ public:
         bool showSyncPerfStats = (m_syncStatsTrace > 0) && ((m_iterationCount % m_syncStatsTrace) == 0);
         m_iterationCount++;
 
-        if (m_useAsyncAggregation)
+        if (m_overlapWithBackprop)
+        {
+            AggregateGradientsOverlapped(gradients, headerCPU, showSyncPerfStats);
+            return (headerCPU->numSamples != 0);
+        }
+        else if (m_useAsyncAggregation)
         {
             // If we are performing async gradient aggregation, let's wait for the pending gradient aggregation to finish
             // then swap the contents of the buffered gradients and the new gradient matrices and fire an async aggreagation
@@ -153,8 +203,19 @@ private:
 
     void ResetState(const std::vector<Matrix<ElemType>*>& gradients, int numEvalNodes, bool resetState)
     {
+        if (!m_initialized && m_overlapWithBackprop)
+        {
+            m_initialized = true;
+            InitializeBuckets(gradients);
+
+            if (m_mpi->IsMainNode())
+            {
+                for (size_t i = 0; i < NumProc() - 1; ++i)
+                    m_recvHeaders.push_back(DistGradHeader::Create(numEvalNodes));
+            }
+        }
         // When called the first time let's setup the intermediateCPU buffers for gradient aggregation if needed
-        if (!m_initialized)
+        else if (!m_initialized)
         {
             m_initialized = true;
             int deviceId = gradients[0]->GetDeviceId();
@@ -438,6 +499,212 @@ private:
         }
     }
 
+    // Group the gradients into buckets that are reduced together, in the order in which the gradients become ready.
+    // All workers must start the reductions in the same order, so the order seen by the main node is used by all.
+    void InitializeBuckets(const std::vector<Matrix<ElemType>*>& gradients)
+    {
+        for (size_t i = 0; i < gradients.size(); i++)
+        {
+            if (gradients[i]->GetMatrixType() != DENSE)
+                RuntimeError("Gradient aggregation for sparse gradient matrices is currently unsupported!");
+        }
+
+        // Gradients that were not seen in the first backprop (e.g. if this worker had no data) go last
+        std::vector<size_t> order;
+        std::vector<bool> ordered(gradients.size(), false);
+        for (size_t i : m_gradientReadyOrder)
+        {
+            if (i < gradients.size() && !ordered[i])
+            {
+                order.push_back(i);
+                ordered[i] = true;
+            }
+        }
+        for (size_t i = 0; i < gradients.size(); i++)
+        {
+            if (!ordered[i])
+                order.push_back(i);
+        }
+        m_gradientReadyOrder.clear();
+
+        m_mpi->Bcast(order.data(), order.size(), m_mpi->MainNodeRank());
+
+        // Gradients not larger than the pack threshold are packed into a continuous buffer with their neighbors,
+        // bigger ones are reduced in place
+        size_t bucketSizeInBytes = 0;
+        m_bucketOfGradient.assign(gradients.size(), 0);
+        for (size_t i : order)
+        {
+            size_t sizeInBytes = sizeof(ElemType) * gradients[i]->GetNumElements();
+            bool packed = sizeInBytes <= m_packThresholdSizeInBytes;
+            if (m_buckets.empty() || !packed || !m_buckets.back().m_packed || bucketSizeInBytes + sizeInBytes > m_packThresholdSizeInBytes)
+            {
+                m_buckets.push_back(GradientBucket());
+                m_buckets.back().m_packed = packed;
+                bucketSizeInBytes = 0;
+            }
+
+            m_buckets.back().m_gradientIndices.push_back(i);
+            m_bucketOfGradient[i] = m_buckets.size() - 1;
+            bucketSizeInBytes += sizeInBytes;
+        }
+
+        for (auto& bucket : m_buckets)
+        {
+            // A single gradient does not need to be copied
+            if (bucket.m_gradientIndices.size() == 1)
+                bucket.m_packed = false;
+
+            if (bucket.m_packed)
+            {
+                size_t numElements = 0;
+                for (size_t i : bucket.m_gradientIndices)
+                    numElements += gradients[i]->GetNumElements();
+                bucket.m_buffer.reset(new Matrix<ElemType>(1, numElements, gradients[0]->GetDeviceId()));
+            }
+        }
+
+        m_bucketGradients = gradients;
+        m_bucketRequests.assign(m_buckets.size(), MPI_REQUEST_NULL);
+    }
+
+    // Start the all-reduce of the next buckets, as long as all their gradients are ready
+    void StartReadyBuckets()
+    {
+        while (m_nextBucketToStart < m_buckets.size() && m_buckets[m_nextBucketToStart].m_numReady == m_buckets[m_nextBucketToStart].m_gradientIndices.size())
+        {
+            auto& bucket = m_buckets[m_nextBucketToStart];
+            ElemType* reductionBuffer;
+            size_t numElements;
+            if (bucket.m_packed)
+            {
+                size_t offset = 0;
+                for (size_t i : bucket.m_gradientIndices)
+                {
+                    auto gradient = m_bucketGradients[i];
+                    bucket.m_buffer->ColumnSlice(offset, gradient->GetNumElements()).AssignValuesOf(gradient->Reshaped(1, gradient->GetNumElements()));
+                    offset += gradient->GetNumElements();
+                }
+                reductionBuffer = bucket.m_buffer->Data();
+                numElements = bucket.m_buffer->GetNumElements();
+            }
+            else
+            {
+                reductionBuffer = m_bucketGradients[bucket.m_gradientIndices.front()]->Data();
+                numElements = m_bucketGradients[bucket.m_gradientIndices.front()]->GetNumElements();
+            }
+
+            m_mpi->Iallreduce(MPI_IN_PLACE, reductionBuffer, (int)numElements, MPIWrapper::GetDataType(reductionBuffer), MPI_SUM, &m_bucketRequests[m_nextBucketToStart]) || MpiFail("MPI_Iallreduce");
+            m_nextBucketToStart++;
+        }
+    }
+
+    void AggregateGradientsOverlapped(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool showSyncPerfStats)
+    {
+        if (gradients.size() != m_bucketOfGradient.size())
+            LogicError("SimpleDistGradAggregator: The number of gradients to aggregate changed.");
+
+        // The reductions started in the backprop work on the matrices given to GradientReady(), the others on these
+        for (size_t b = 0; b < m_nextBucketToStart; b++)
+        {
+            for (size_t i : m_buckets[b].m_gradientIndices)
+            {
+                if (m_bucketGradients[i] != gradients[i])
+                    LogicError("SimpleDistGradAggregator: Gradient %d to aggregate is not the matrix that was reported ready in the backprop.", (int)i);
+            }
+        }
+        m_bucketGradients = gradients;
+
+        // Time the backprop had to hide the reductions started in it
+        double overlapTime = 0;
+        if (m_nextBucketToStart > 0)
+        {
+            m_backpropOverlapTimer.Stop();
+            overlapTime = m_backpropOverlapTimer.ElapsedSeconds();
+        }
+
+        Timer aggregationTimer;
+        aggregationTimer.Start();
+
+        size_t numGradMatrices = gradients.size();
+        if (headerCPU->numSamples == 0)
+        {
+            // No backprop was done, so no reduction was started. The gradients of the current node should be zero'd
+            assert(m_nextBucketToStart == 0);
+            for (size_t i = 0; i < numGradMatrices; ++i)
+                gradients[i]->SetValue(0);
+        }
+
+        // Start the reductions that were not started in the backprop
+        for (auto& bucket : m_buckets)
+            bucket.m_numReady = bucket.m_gradientIndices.size();
+        StartReadyBuckets();
+
+        // Initiate receive of the header on the main node
+        std::vector<MPI_Request> recvHeaderRequests(NumProc() - 1);
+        if (m_mpi->IsMainNode())
+        {
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int source = (j >= MyRank()) ? (j + 1) : j;
+                // We use a tag of 'numGradMatrices' for the pre-aggregation header
+                m_mpi->Irecv(m_recvHeaders[j], m_recvHeaders[j]->Size(), MPI_CHAR, source, numGradMatrices, &(recvHeaderRequests[j])) || MpiFail("MPI_Irecv");
+            }
+        }
+
+        // Send the headers from all nodes but the main node
+        MPI_Request sendHeaderRequest;
+        if (!m_mpi->IsMainNode())
+            m_mpi->Isend(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank(), numGradMatrices, &sendHeaderRequest) || MpiFail("MPI_Isend");
+
+        // On the main node wait for the headers to arrive and aggregate
+        if (m_mpi->IsMainNode())
+        {
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int idx = MPI_UNDEFINED;
+                m_mpi->Waitany(recvHeaderRequests.size(), recvHeaderRequests.data(), &idx, MPI_STATUS_IGNORE) || MpiFail("MPI_Waitany");
+                if (idx == MPI_UNDEFINED)
+                    break;
+
+                headerCPU->Aggregate(m_recvHeaders[idx], true);
+            }
+        }
+
+        // Broadcast the aggregated header to all nodes
+        m_mpi->Bcast(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank());
+
+        // Wait for the reductions and copy the packed gradients back
+        m_mpi->Waitall((int)m_bucketRequests.size(), m_bucketRequests.data(), MPI_STATUSES_IGNORE) || MpiFail("MPI_Waitall");
+        for (auto& bucket : m_buckets)
+        {
+            if (bucket.m_packed)
+            {
+                size_t offset = 0;
+                for (size_t i : bucket.m_gradientIndices)
+                {
+                    gradients[i]->AssignValuesOf(bucket.m_buffer->ColumnSlice(offset, gradients[i]->GetNumElements()).Reshaped(gradients[i]->GetNumRows(), gradients[i]->GetNumCols()));
+                    offset += gradients[i]->GetNumElements();
+                }
+            }
+            bucket.m_numReady = 0;
+        }
+
+        // Wait for completion of the async send requests
+        if (!m_mpi->IsMainNode())
+            m_mpi->Wait(&sendHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+
+        aggregationTimer.Stop();
+        if (showSyncPerfStats)
+        {
+            fprintf(stderr, "Overlapped gradient aggregation: %d of %d buckets started during backprop, overlapped with %.6g s of backprop, then waited %.6g s\n",
+                    (int)m_numBucketsStartedInBackprop, (int)m_buckets.size(), overlapTime, aggregationTimer.ElapsedSeconds());
+        }
+
+        m_nextBucketToStart = 0;
+        m_numBucketsStartedInBackprop = 0;
+    }
+
 private:
     std::unique_ptr<CUDAPageLockedMemAllocator> m_allocator;
 
@@ -471,5 +738,26 @@ private:
     bool m_initialized;
 
     NcclComm m_nccl;
+
+    // Gradients grouped for reduction during the backprop, see GradientReady()
+    struct GradientBucket
+    {
+        GradientBucket() : m_packed(false), m_numReady(0) {}
+
+        std::vector<size_t> m_gradientIndices;
+        bool m_packed;                               // whether the gradients are copied into m_buffer to be reduced together
+        std::unique_ptr<Matrix<ElemType>> m_buffer;
+        size_t m_numReady;                           // number of gradients of the bucket that are final in the current iteration
+    };
+
+    const bool m_overlapWithBackprop;
+    std::vector<size_t> m_gradientReadyOrder;            // order seen in the first backprop, before the buckets are formed
+    std::vector<GradientBucket> m_buckets;
+    std::vector<size_t> m_bucketOfGradient;              // bucket of each gradient, by its index in the gradients to aggregate
+    std::vector<Matrix<ElemType>*> m_bucketGradients;    // current matrix of each gradient
+    std::vector<MPI_Request> m_bucketRequests;
+    size_t m_nextBucketToStart;                          // buckets are started strictly in order, so that all workers start the same reductions
+    size_t m_numBucketsStartedInBackprop;
+    Timer m_backpropOverlapTimer;
 };
 } } }
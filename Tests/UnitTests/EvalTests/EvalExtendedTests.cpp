@@ -7,6 +7,9 @@
 #include "ComputationNode.h"
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -415,5 +418,396 @@ BOOST_AUTO_TEST_CASE(EvalRNNTest)
     eval->Destroy();
 }
 
+// A model with two inputs and a learnable parameter, for the thread context tests
+std::string ThreadContextTestModel(size_t inputDim, size_t hiddenDim)
+{
+    return
+        "deviceId = -1 \n"
+        "precision = \"float\" \n"
+        "traceLevel = 0 \n"
+        "run=NDLNetworkBuilder \n"
+        "NDLNetworkBuilder=[ \n"
+        "i1 = Input(" + std::to_string(inputDim) + ") \n"
+        "i2 = Input(" + std::to_string(inputDim) + ") \n"
+        "W1 = Parameter(" + std::to_string(hiddenDim) + ", " + std::to_string(inputDim) + ", init=\"uniform\", initValueScale=1) \n"
+        "W2 = Parameter(" + std::to_string(hiddenDim) + ", " + std::to_string(inputDim) + ", init=\"uniform\", initValueScale=1) \n"
+        "W3 = Parameter(1, " + std::to_string(hiddenDim) + ", init=\"uniform\", initValueScale=1) \n"
+        "h = Tanh(Plus(Times(W1, i1), Times(W2, i2))) \n"
+        "o1 = Times(W3, h, tag=\"output\") \n"
+        "FeatureNodes = (i1:i2) \n"
+        "] \n";
+}
+
+Values<float> ThreadContextTestInput(VariableSchema& inputLayouts, size_t numSamples, int seed)
+{
+    Values<float> inputBuffer = inputLayouts.CreateBuffers<float>({ numSamples, numSamples });
+    for (size_t k = 0; k < inputBuffer.size(); k++)
+        for (size_t i = 0; i < inputLayouts[k].m_numElements * numSamples; i++)
+            inputBuffer[k].m_buffer.push_back((float)((seed * 31 + k * 7 + i) % 13) / 13 - 0.5f);
+    return inputBuffer;
+}
+
+BOOST_AUTO_TEST_CASE(EvalThreadContextTest)
+{
+    VariableSchema inputLayouts;
+    VariableSchema outputLayouts;
+    IEvaluateModelExtended<float>* eval = SetupNetworkAndGetLayouts(ThreadContextTestModel(8, 16), inputLayouts, outputLayouts);
+    BOOST_REQUIRE_EQUAL(inputLayouts.size(), 2);
+
+    // the expected outputs, from the evaluator itself
+    const int numThreads = 4, numInputs = 8;
+    std::vector<Values<float>> inputs;
+    std::vector<std::vector<float>> expected;
+    for (int n = 0; n < numInputs; n++)
+    {
+        inputs.push_back(ThreadContextTestInput(inputLayouts, 3, n));
+        Values<float> outputBuffer = outputLayouts.CreateBuffers<float>({ 3 });
+        eval->ForwardPass(inputs.back(), outputBuffer);
+        expected.push_back(outputBuffer[0].m_buffer);
+    }
+
+    // the contexts, running concurrently with each other and with the evaluator itself
+    std::vector<IEvaluateModelExtended<float>*> contexts{ eval };
+    for (int t = 1; t < numThreads; t++)
+        contexts.push_back(contexts.back()->CreateThreadContext()); // contexts can be created from contexts
+    for (int t = 1; t < numThreads; t++)
+    {
+        BOOST_REQUIRE(contexts[t]->GetInputSchema()[0].m_name == inputLayouts[0].m_name);
+        BOOST_REQUIRE(contexts[t]->GetInputSchema()[1].m_name == inputLayouts[1].m_name);
+    }
+
+    std::vector<int> mismatches(numThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back([&, t]
+        {
+            Values<float> outputBuffer = outputLayouts.CreateBuffers<float>({ 3 });
+            for (int iteration = 0; iteration < 50; iteration++)
+            {
+                int n = (t + iteration) % numInputs;
+                contexts[t]->ForwardPass(inputs[n], outputBuffer);
+                if (outputBuffer[0].m_buffer != expected[n])
+                    mismatches[t]++;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int t = 0; t < numThreads; t++)
+        BOOST_CHECK_MESSAGE(mismatches[t] == 0, "Thread " << t << " computed " << mismatches[t] << " wrong outputs");
+
+    for (int t = numThreads - 1; t > 0; t--)
+        contexts[t]->Destroy();
+
+    // contexts are only available after StartForwardEvaluation()
+    IEvaluateModelExtended<float>* notStarted;
+    GetEvalExtendedF(&notStarted);
+    notStarted->CreateNetwork(ThreadContextTestModel(8, 16));
+    BOOST_REQUIRE_THROW(notStarted->CreateThreadContext(), std::exception);
+    notStarted->Destroy();
+
+    eval->Destroy();
+}
+
+// Throughput of concurrent evaluation with one thread context per thread, all sharing one model.
+// To run it, use --run_test=EvalTestSuite/EvalThreadContextThroughput.
+BOOST_AUTO_TEST_CASE(EvalThreadContextThroughput, *boost::unit_test::disabled())
+{
+    VariableSchema inputLayouts;
+    VariableSchema outputLayouts;
+    IEvaluateModelExtended<float>* eval = SetupNetworkAndGetLayouts(ThreadContextTestModel(512, 1024), inputLayouts, outputLayouts);
+    const size_t numSamples = 1;
+    const int requestsPerThread = 2000;
+    Values<float> input = ThreadContextTestInput(inputLayouts, numSamples, 0);
+
+    fprintf(stderr, "%8s %18s %10s\n", "Threads", "Requests/second", "Speedup");
+    double singleThreadThroughput = 0;
+    for (int numThreads = 1; numThreads <= (int)std::max(1u, std::thread::hardware_concurrency()); numThreads *= 2)
+    {
+        std::vector<IEvaluateModelExtended<float>*> contexts{ eval };
+        for (int t = 1; t < numThreads; t++)
+            contexts.push_back(eval->CreateThreadContext());
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++)
+        {
+            threads.emplace_back([&, t]
+            {
+                Values<float> outputBuffer = outputLayouts.CreateBuffers<float>({ numSamples });
+                for (int i = 0; i < requestsPerThread; i++)
+                    contexts[t]->ForwardPass(input, outputBuffer);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double throughput = numThreads * requestsPerThread / seconds;
+        if (numThreads == 1)
+            singleThreadThroughput = throughput;
+        fprintf(stderr, "%8d %18.1f %9.2fx\n", numThreads, throughput, throughput / singleThreadThroughput);
+
+        for (int t = 1; t < numThreads; t++)
+            contexts[t]->Destroy();
+    }
+
+    eval->Destroy();
+}
+
+// A small recurrent model: o1 = W * i1 + PastValue(o1)
+std::string RecurrentBatchTestModel()
+{
+    return
+        "deviceId = -1 \n"
+        "precision = \"float\" \n"
+        "traceLevel = 0 \n"
+        "run=NDLNetworkBuilder \n"
+        "NDLNetworkBuilder=[ \n"
+        "i1 = Input(3) \n"
+        "W = Parameter(2, 3, init=\"uniform\", initValueScale=1) \n"
+        "dh = PastValue(2, o1, timeStep=1) \n"
+        "o1 = Plus(Times(W, i1), dh, tag=\"output\") \n"
+        "FeatureNodes = (i1) \n"
+        "] \n";
+}
+
+Values<float> RecurrentBatchTestInput(size_t length, int seed)
+{
+    Values<float> input(1);
+    for (size_t i = 0; i < 3 * length; i++)
+        input[0].m_buffer.push_back((float)((seed * 5 + i) % 7) - 3);
+    return input;
+}
+
+void CheckSameOutputs(const Values<float>& expected, const Values<float>& actual)
+{
+    BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        BOOST_REQUIRE_EQUAL(expected[i].m_buffer.size(), actual[i].m_buffer.size());
+        for (size_t j = 0; j < expected[i].m_buffer.size(); j++)
+            BOOST_CHECK_SMALL(expected[i].m_buffer[j] - actual[i].m_buffer[j], 1e-4f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(EvalForwardPassBatchTest)
+{
+    VariableSchema inputLayouts;
+    VariableSchema outputLayouts;
+    IEvaluateModelExtended<float>* eval = SetupNetworkAndGetLayouts(RecurrentBatchTestModel(), inputLayouts, outputLayouts);
+
+    // sequences of different lengths, evaluated alone and in one minibatch
+    const std::vector<size_t> lengths{ 3, 1, 5, 2 };
+    std::vector<Values<float>> inputs, expected, outputs;
+    std::vector<const Values<float>*> inputRefs;
+    std::vector<Values<float>*> outputRefs;
+    for (size_t k = 0; k < lengths.size(); k++)
+    {
+        inputs.push_back(RecurrentBatchTestInput(lengths[k], (int)k));
+        expected.push_back(outputLayouts.CreateBuffers<float>({ lengths[k] }));
+        eval->ForwardPass(inputs[k], expected[k]);
+        outputs.push_back(outputLayouts.CreateBuffers<float>({ lengths[k] }));
+    }
+    for (size_t k = 0; k < lengths.size(); k++)
+    {
+        inputRefs.push_back(&inputs[k]);
+        outputRefs.push_back(&outputs[k]);
+    }
+
+    eval->ForwardPassBatch(inputRefs, outputRefs);
+    for (size_t k = 0; k < lengths.size(); k++)
+        CheckSameOutputs(expected[k], outputs[k]);
+
+    // the outputs must have room for the whole sequence
+    outputs[2] = outputLayouts.CreateBuffers<float>({ 1 });
+    BOOST_REQUIRE_THROW(eval->ForwardPassBatch(inputRefs, outputRefs), std::exception);
+
+    eval->Destroy();
+}
+
+BOOST_AUTO_TEST_CASE(EvalForwardPassBatchSparseTest)
+{
+    std::string modelDefinition =
+        "deviceId = -1 \n"
+        "precision = \"float\" \n"
+        "traceLevel = 1 \n"
+        "run=NDLNetworkBuilder \n"
+        "NDLNetworkBuilder=[ \n"
+        "i1 = SparseInput(3) \n"
+        "o1 = Times(Constant(2, rows=1, cols=3), i1, tag=\"output\") \n"
+        "FeatureNodes = (i1) \n"
+        "] \n";
+
+    VariableSchema inputLayouts;
+    VariableSchema outputLayouts;
+    IEvaluateModelExtended<float>* eval = SetupNetworkAndGetLayouts(modelDefinition, inputLayouts, outputLayouts);
+
+    Values<float> input1(1), input2(1);
+    input1[0].m_buffer = { 1, 2, 3, 5, 6 };
+    input1[0].m_indices = { 0, 2, 2, 1, 2 };
+    input1[0].m_colIndices = { 0, 2, 2, 5 };
+    input2[0].m_buffer = { 4 };
+    input2[0].m_indices = { 1 };
+    input2[0].m_colIndices = { 0, 1 };
+
+    auto output1 = outputLayouts.CreateBuffers<float>({ 3 });
+    auto output2 = outputLayouts.CreateBuffers<float>({ 1 });
+    eval->ForwardPassBatch({ &input1, &input2 }, { &output1, &output2 });
+
+    std::vector<float> expected1{ 6, 0, 28 }, expected2{ 8 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(output1[0].m_buffer.begin(), output1[0].m_buffer.end(), expected1.begin(), expected1.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(output2[0].m_buffer.begin(), output2[0].m_buffer.end(), expected2.begin(), expected2.end());
+
+    eval->Destroy();
+}
+
+BOOST_AUTO_TEST_CASE(EvalBatchingTest)
+{
+    VariableSchema inputLayouts;
+    VariableSchema outputLayouts;
+    IEvaluateModelExtended<float>* eval = SetupNetworkAndGetLayouts(RecurrentBatchTestModel(), inputLayouts, outputLayouts);
+
+    const int numThreads = 8, requestsPerThread = 20;
+    std::vector<Values<float>> inputs, expected;
+    for (int n = 0; n < numThreads; n++)
+    {
+        inputs.push_back(RecurrentBatchTestInput(1 + n % 4, n));
+        expected.push_back(outputLayouts.CreateBuffers<float>({ 4 }));
+        eval->ForwardPass(inputs[n], expected[n]);
+    }
+
+    // each sequence continued by itself
+    std::vector<Values<float>> expectedContinued;
+    for (int n = 0; n < numThreads; n++)
+    {
+        auto start = outputLayouts.CreateBuffers<float>({ 4 });
+        expectedContinued.push_back(outputLayouts.CreateBuffers<float>({ 4 }));
+        eval->ForwardPass(inputs[n], start, true);
+        eval->ForwardPass(inputs[n], expectedContinued[n], false);
+    }
+
+    IEvaluateModelBatching<float>* batching;
+    GetEvalBatchingF(eval, 4, 2000, &batching);
+    BOOST_REQUIRE_EQUAL(batching->GetInputSchema().size(), 1);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<Values<float>>> results(numThreads);
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back([&, t]
+        {
+            for (int i = 0; i < requestsPerThread; i++)
+            {
+                results[t].push_back(outputLayouts.CreateBuffers<float>({ 4 }));
+                batching->ForwardPass(inputs[t], results[t].back());
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (int t = 0; t < numThreads; t++)
+        for (const auto& result : results[t])
+            CheckSameOutputs(expected[t], result);
+
+    // a malformed request fails alone
+    Values<float> malformed(1);
+    malformed[0].m_buffer = { 1, 2 };
+    auto output1 = outputLayouts.CreateBuffers<float>({ 4 }), output2 = outputLayouts.CreateBuffers<float>({ 4 });
+    auto result1 = batching->ForwardPassAsync(malformed, output1);
+    auto result2 = batching->ForwardPassAsync(inputs[3], output2);
+    BOOST_REQUIRE_THROW(result1.get(), std::exception);
+    result2.get();
+    CheckSameOutputs(expected[3], output2);
+
+    // threads that continue their sequences get their own context, while the others are still batched
+    threads.clear();
+    std::vector<std::vector<Values<float>>> continued(numThreads);
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back([&, t]
+        {
+            for (int i = 0; i < requestsPerThread; i++)
+            {
+                results[t][i] = outputLayouts.CreateBuffers<float>({ 4 });
+                if (t % 2 == 0)
+                {
+                    batching->ForwardPass(inputs[t], results[t][i]);
+                    continue;
+                }
+
+                // the first resetRNN = false request of the thread starts its sequence
+                continued[t].push_back(outputLayouts.CreateBuffers<float>({ 4 }));
+                batching->ForwardPass(inputs[t], results[t][i], i > 0);
+                batching->ForwardPass(inputs[t], continued[t].back(), false);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int t = 0; t < numThreads; t++)
+    {
+        for (const auto& result : results[t])
+            CheckSameOutputs(expected[t], result);
+        for (const auto& result : continued[t])
+            CheckSameOutputs(expectedContinued[t], result);
+    }
+
+    batching->Destroy(); // also destroys eval
+}
+
+// Throughput and latency of the batching evaluator under load from concurrent clients, each sending
+// single-sample requests back to back, for several batching windows; a window of 0 with batch size 1 is
+// the unbatched baseline.
+// To run it, use --run_test=EvalTestSuite/EvalBatchingThroughput.
+BOOST_AUTO_TEST_CASE(EvalBatchingThroughput, *boost::unit_test::disabled())
+{
+    const size_t settings[][2] = { { 1, 0 }, { 8, 200 }, { 32, 500 }, { 64, 2000 } }; // batch size, latency window (us)
+    const int numClients = 32, requestsPerClient = 200;
+
+    fprintf(stderr, "%10s %10s %18s %12s %12s %12s\n", "Batch", "Window(us)", "Requests/second", "p50 (us)", "p99 (us)", "max (us)");
+    for (const auto& setting : settings)
+    {
+        VariableSchema inputLayouts;
+        VariableSchema outputLayouts;
+        IEvaluateModelExtended<float>* eval = SetupNetworkAndGetLayouts(ThreadContextTestModel(512, 1024), inputLayouts, outputLayouts);
+        Values<float> input = ThreadContextTestInput(inputLayouts, 1, 0);
+        IEvaluateModelBatching<float>* batching;
+        GetEvalBatchingF(eval, setting[0], setting[1], &batching);
+
+        std::vector<std::vector<double>> latencies(numClients);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> clients;
+        for (int c = 0; c < numClients; c++)
+        {
+            clients.emplace_back([&, c]
+            {
+                auto output = outputLayouts.CreateBuffers<float>({ 1 });
+                for (int i = 0; i < requestsPerClient; i++)
+                {
+                    auto requestStart = std::chrono::steady_clock::now();
+                    batching->ForwardPass(input, output);
+                    latencies[c].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - requestStart).count());
+                }
+            });
+        }
+        for (auto& client : clients)
+            client.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<double> all;
+        for (const auto& l : latencies)
+            all.insert(all.end(), l.begin(), l.end());
+        std::sort(all.begin(), all.end());
+        fprintf(stderr, "%10d %10d %18.1f %12.1f %12.1f %12.1f\n", (int)setting[0], (int)setting[1], all.size() / seconds,
+                all[all.size() / 2], all[all.size() * 99 / 100], all.back());
+
+        batching->Destroy();
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }}}}
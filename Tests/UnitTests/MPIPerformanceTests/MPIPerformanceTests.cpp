@@ -0,0 +1,128 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// MPIPerformanceTests.cpp : Measures the all-reduce implementations of MPIWrapper for a range of message sizes.
+//
+// Usage: mpiexec -n <nodes> mpiperformancetests [maxSizeInMB [iterations]]
+//
+#include "Basics.h"
+#include "MPIWrapper.h"
+#include <chrono>
+#include <vector>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+static const char* AlgorithmName(AllReduceAlgorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case AllReduceAlgorithm::Mpi:          return "mpi";
+    case AllReduceAlgorithm::Ring:         return "ring";
+    case AllReduceAlgorithm::Hierarchical: return "hierarchical";
+    default:                               return "auto";
+    }
+}
+
+// fill the buffer such that the sum over all nodes is known
+static void FillBuffer(vector<float>& buffer, size_t rank)
+{
+    for (size_t i = 0; i < buffer.size(); i++)
+        buffer[i] = (float)(rank + 1 + i % 7);
+}
+
+static size_t CountErrors(const vector<float>& buffer, size_t numNodes)
+{
+    size_t errors = 0;
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        if (buffer[i] != (float)(numNodes * (numNodes + 1) / 2 + numNodes * (i % 7)))
+            errors++;
+    }
+    return errors;
+}
+
+// Seconds per call, the slowest node counts
+template <class F>
+static double Time(const MPIWrapperPtr& mpi, size_t iterations, F f)
+{
+    f(); // warm up
+    mpi->WaitAll();
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+        f();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count() / iterations;
+    mpi->AllReduce(&seconds, 1, MPI_MAX);
+    return seconds;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxSizeInMB = argc > 1 ? atoi(argv[1]) : 64;
+    size_t iterations = argc > 2 ? atoi(argv[2]) : 10;
+
+    auto mpi = MPIWrapper::GetInstance(true /*create*/);
+    size_t rank = mpi->CurrentNodeRank();
+    size_t numNodes = mpi->NumNodesInUse();
+    bool print = mpi->IsMainNode();
+    size_t errors = 0;
+
+    if (print)
+    {
+        fprintf(stderr, "All-reduce of float buffers over %d nodes on %s, %d iterations\n", (int)numNodes, mpi->IsMultiHost() ? "multiple hosts" : "a single host", (int)iterations);
+        fprintf(stderr, "%12s %14s %12s %14s %14s\n", "size [KB]", "algorithm", "time [ms]", "algbw [GB/s]", "busbw [GB/s]");
+    }
+
+    for (size_t sizeInBytes = 4 * 1024; sizeInBytes <= maxSizeInMB * 1024 * 1024; sizeInBytes *= 4)
+    {
+        vector<float> buffer(sizeInBytes / sizeof(float));
+        for (auto algorithm : { AllReduceAlgorithm::Mpi, AllReduceAlgorithm::Ring, AllReduceAlgorithm::Hierarchical })
+        {
+            mpi->SetAllReduceAlgorithm(algorithm, 0, DEFAULT_ALLREDUCE_CHUNK_SIZE_IN_KB * 1024);
+
+            FillBuffer(buffer, rank);
+            mpi->AllReduce(buffer.data(), buffer.size());
+            errors += CountErrors(buffer, numNodes);
+
+            double seconds = Time(mpi, iterations, [&]() { mpi->AllReduce(buffer.data(), buffer.size()); });
+            // the bus bandwidth is the rate at which each node sends, 2*(N-1)/N times the buffer size for an optimal all-reduce
+            double algorithmBandwidth = sizeInBytes / seconds / 1e9;
+            if (print)
+                fprintf(stderr, "%12d %14s %12.3f %14.3f %14.3f\n", (int)(sizeInBytes / 1024), AlgorithmName(algorithm), seconds * 1000,
+                        algorithmBandwidth, algorithmBandwidth * 2 * (numNodes - 1) / numNodes);
+        }
+    }
+
+    // many small buffers, as the gradients of the biases of a network, reduced one by one and fused
+    mpi->SetAllReduceAlgorithm(AllReduceAlgorithm::Mpi, DEFAULT_ALLREDUCE_MIN_SIZE_IN_KB * 1024, DEFAULT_ALLREDUCE_CHUNK_SIZE_IN_KB * 1024);
+    const size_t numSmallBuffers = 1024;
+    vector<vector<float>> smallBuffers(numSmallBuffers, vector<float>(256));
+    vector<float*> smallBufferPointers;
+    vector<size_t> smallBufferSizes;
+    for (auto& smallBuffer : smallBuffers)
+    {
+        FillBuffer(smallBuffer, rank);
+        smallBufferPointers.push_back(smallBuffer.data());
+        smallBufferSizes.push_back(smallBuffer.size());
+    }
+    mpi->AllReduceFused(smallBufferPointers, smallBufferSizes, DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES);
+    for (auto& smallBuffer : smallBuffers)
+        errors += CountErrors(smallBuffer, numNodes);
+
+    double separateSeconds = Time(mpi, iterations, [&]()
+    {
+        for (auto& smallBuffer : smallBuffers)
+            mpi->AllReduce(smallBuffer.data(), smallBuffer.size());
+    });
+    double fusedSeconds = Time(mpi, iterations, [&]() { mpi->AllReduceFused(smallBufferPointers, smallBufferSizes, DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES); });
+    if (print)
+        fprintf(stderr, "%d buffers of 1 KB: %.3f ms separately, %.3f ms fused into %d KB buffers\n", (int)numSmallBuffers, separateSeconds * 1000, fusedSeconds * 1000, (int)DEFAULT_PACK_THRESHOLD_SIZE_IN_KB);
+
+    mpi->AllReduce(&errors, 1);
+    if (print)
+        fprintf(stderr, errors == 0 ? "All results are correct.\n" : "%d wrong results!\n", (int)errors);
+
+    mpi->Finalize();
+    return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
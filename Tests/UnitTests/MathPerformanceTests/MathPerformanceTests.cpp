@@ -11,10 +11,15 @@
 #include "CPUMatrix.h"
 #include "TensorView.h"
 #include "Sequences.h"
+#include "QuantizedMatrix.h"
+#include "MatrixQuantizerImpl.h"
+#include "File.h"
 #include <chrono>
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <functional>
+#include <random>
 
 using namespace Microsoft::MSR::CNTK;
 using namespace std;
@@ -279,6 +284,192 @@ struct TensorTest
     }
 };
 
+// measure how CPU TensorView ops scale with the number of threads
+//  - elementwise binary op, elementwise unary op (transcendental), broadcasting, and reductions (to a vector and to a scalar)
+//  - wall-clock time is measured, since clock() would add up the CPU time of all threads
+template <class ElemType>
+void TensorOpThreadScalingTest(int count)
+{
+    mt19937 rng(0);
+    uniform_real_distribution<float> nd(-1, 1);
+    auto CreateTensor = [&](TensorShape shape) -> TensorView<ElemType>
+    {
+        vector<ElemType> init(shape.GetNumElements());
+        generate(begin(init), end(init), [&] { return nd(rng); });
+        return TensorView<ElemType>(make_shared<Matrix<ElemType>>(init.size(), 1, init.data(), CPUDEVICE), shape);
+    };
+
+    let layerShape = TensorShape{ 2048, 1024 };
+    let a = CreateTensor(layerShape);
+    let b = CreateTensor(layerShape);
+    let bias = CreateTensor(TensorShape(2048));
+    auto c = CreateTensor(layerShape);
+    auto biasGrad = CreateTensor(TensorShape(2048));
+    auto scalar = CreateTensor(TensorShape(1));
+
+    let maxNumThreads = CPUMatrix<ElemType>::GetMaxNumThreads();
+    for (int numThreads = 1; ; numThreads = min(2 * numThreads, maxNumThreads))
+    {
+        CPUMatrix<ElemType>::SetNumThreads(numThreads);
+        cout << "TensorOp with " << numThreads << " threads on [" << string(layerShape) << "]:" << endl;
+
+        let TimeIt = [count](const char* what, const function<void()>& fn)
+        {
+            fn(); // warm up
+            auto t_start = chrono::high_resolution_clock::now();
+            for (int i = 0; i < count; ++i)
+                fn();
+            auto t_end = chrono::high_resolution_clock::now();
+            cout << "  " << what << ": " << chrono::duration<double, milli>(t_end - t_start).count() / count << " ms" << endl;
+        };
+        TimeIt("c = a + b        ", [&] { c.AssignSumOf(a, b); });
+        TimeIt("c = sigmoid(a)   ", [&] { c.AssignSigmoidOf(a); });
+        TimeIt("c = a + bias     ", [&] { c.AssignSumOf(a, bias); });
+        TimeIt("biasGrad += sum(a)", [&] { biasGrad.DoCopyOf(1, a, 1); });
+        TimeIt("scalar = sum(a)  ", [&] { scalar.DoUnaryOpOf(0, a, 1, ElementWiseOperator::opCopy, ElementWiseOperator::opSum); });
+
+        if (numThreads == maxNumThreads)
+            break;
+    }
+    CPUMatrix<ElemType>::SetNumThreads(maxNumThreads);
+}
+
+// measure the throughput of the CPU gradient quantizer (quantize + unquantize, as done for each aggregation)
+// for each supported bit width, and how it scales with the number of threads
+template <class ElemType>
+void QuantizerThroughputTest(int count)
+{
+    const size_t numRows = 2048, numCols = 1024;
+    Matrix<ElemType> gradient = Matrix<ElemType>::RandomUniform(numRows, numCols, CPUDEVICE, -1, 1, 2017);
+    Matrix<ElemType> residual(numRows, numCols, CPUDEVICE);
+    Matrix<ElemType> aggregated(numRows, numCols, CPUDEVICE);
+    residual.SetValue(0);
+    aggregated.SetValue(0);
+    std::unique_ptr<MatrixQuantizerImpl<ElemType>> quantizer(MatrixQuantizerImpl<ElemType>::Create(CPUDEVICE, false /*useAsync*/));
+
+    let maxNumThreads = CPUMatrix<ElemType>::GetMaxNumThreads();
+    for (size_t numBits = 1; numBits <= 8 * sizeof(ElemType); numBits *= 2)
+    {
+        QuantizedMatrix<ElemType> quantized(numRows, numCols, numBits, CPUDEVICE);
+        for (int numThreads = 1; ; numThreads = min(2 * numThreads, maxNumThreads))
+        {
+            CPUMatrix<ElemType>::SetNumThreads(numThreads);
+            let QuantizeAndUnquantize = [&]
+            {
+                quantizer->QuantizeAsync(gradient, residual, quantized, residual, false /*zeroThresholdFor1Bit*/);
+                quantizer->WaitQuantizeAsyncDone();
+                quantizer->UnquantizeAsync(quantized, aggregated, true /*add*/);
+                quantizer->WaitUnquantizeAsyncDone();
+            };
+            QuantizeAndUnquantize(); // warm up
+            auto t_start = chrono::high_resolution_clock::now();
+            for (int i = 0; i < count; ++i)
+                QuantizeAndUnquantize();
+            auto t_end = chrono::high_resolution_clock::now();
+            let seconds = chrono::duration<double>(t_end - t_start).count() / count;
+            cout << "Quantizer " << numBits << " bits, " << numThreads << " threads on [" << numRows << " x " << numCols << "]: "
+                 << seconds * 1000 << " ms, " << numRows * numCols * sizeof(ElemType) / seconds / (1024 * 1024) << " MB/s" << endl;
+
+            if (numThreads == maxNumThreads)
+                break;
+        }
+    }
+    CPUMatrix<ElemType>::SetNumThreads(maxNumThreads);
+}
+
+// Adam step of an embedding [dim x vocabSize] with a block sparse gradient (lazy, only the looked-up columns)
+// against the same step with the gradient densified (every column, incl. the decay of the untouched ones).
+template <class ElemType>
+void SparseAdamVocabSizeTest(int count)
+{
+    const size_t dim = 128, minibatchSize = 256;
+    for (size_t vocabSize : { 10000, 100000, 1000000 })
+    {
+        // one-hot input [vocabSize x minibatchSize] in CSC format, with random words
+        mt19937 rng(2017);
+        uniform_int_distribution<size_t> word(0, vocabSize - 1);
+        vector<CPUSPARSE_INDEX_TYPE> colStarts(minibatchSize + 1), rows(minibatchSize);
+        vector<ElemType> values(minibatchSize, 1);
+        for (size_t j = 0; j < minibatchSize; j++)
+        {
+            colStarts[j] = (CPUSPARSE_INDEX_TYPE) j;
+            rows[j] = (CPUSPARSE_INDEX_TYPE) word(rng);
+        }
+        colStarts[minibatchSize] = (CPUSPARSE_INDEX_TYPE) minibatchSize;
+        Matrix<ElemType> input(vocabSize, minibatchSize, CPUDEVICE, MatrixType::SPARSE, matrixFormatSparseCSC);
+        input.SetMatrixFromCSCFormat(colStarts.data(), rows.data(), values.data(), minibatchSize, vocabSize, minibatchSize);
+
+        // gradient of the embedding = outputGradient * input^T
+        Matrix<ElemType> outputGradient = Matrix<ElemType>::RandomGaussian(dim, minibatchSize, CPUDEVICE, 0, 1, 2017);
+        Matrix<ElemType> sparseGradient(dim, vocabSize, CPUDEVICE, MatrixType::SPARSE, matrixFormatSparseBlockCol);
+        Matrix<ElemType>::MultiplyAndAdd(outputGradient, false, input, true, sparseGradient);
+        Matrix<ElemType> denseGradient(sparseGradient.DeepClone());
+        denseGradient.SwitchToMatrixType(MatrixType::DENSE, matrixFormatDense, true);
+
+        Matrix<ElemType> model = Matrix<ElemType>::RandomGaussian(dim, vocabSize, CPUDEVICE, 0, 1, 2018);
+        for (bool sparse : { false, true })
+        {
+            Matrix<ElemType> smoothedGradient(CPUDEVICE);
+            auto& gradient = sparse ? sparseGradient : denseGradient;
+            smoothedGradient.AdamUpdate(gradient, model, 1, 0.001, 0.9, 0.999, 1e-8); // warm up, allocates the state
+            auto t_start = chrono::high_resolution_clock::now();
+            for (int i = 0; i < count; ++i)
+                smoothedGradient.AdamUpdate(gradient, model, i + 2, 0.001, 0.9, 0.999, 1e-8);
+            auto t_end = chrono::high_resolution_clock::now();
+            cout << (sparse ? "Lazy sparse" : "Dense") << " Adam on [" << dim << " x " << vocabSize << "]: "
+                 << chrono::duration<double>(t_end - t_start).count() / count * 1000 << " ms" << endl;
+        }
+    }
+}
+
+// Time to read the parameters of a model (a number of [1024 x 1024] matrices) from a file in the regular format
+// and in the page-aligned format written with fileOptionsMappable, and then to touch all of them once.
+// The file is in the OS file cache in both cases, so this measures the copies, not the disk.
+template <class ElemType>
+void ModelLoadTest(int count)
+{
+    const size_t dim = 1024;
+    for (size_t numMatrices : { 4, 16, 64 })
+    {
+        Matrix<ElemType> parameter = Matrix<ElemType>::RandomUniform(dim, dim, CPUDEVICE, -1, 1, 2017);
+        for (bool mappable : { false, true })
+        {
+            const wstring fileName = mappable ? L"ModelLoadTest.mappable.bin" : L"ModelLoadTest.bin";
+            {
+                File file(fileName, fileOptionsBinary | fileOptionsWrite | (mappable ? fileOptionsMappable : 0));
+                for (size_t i = 0; i < numMatrices; i++)
+                    file << parameter;
+            }
+            double loadTime = 0, touchTime = 0;
+            for (int k = 0; k < count; ++k)
+            {
+                vector<Matrix<ElemType>> parameters;
+                auto t_start = chrono::high_resolution_clock::now();
+                {
+                    File file(fileName, fileOptionsBinary | fileOptionsRead);
+                    for (size_t i = 0; i < numMatrices; i++)
+                    {
+                        parameters.emplace_back(CPUDEVICE);
+                        file >> parameters.back();
+                    }
+                }
+                auto t_loaded = chrono::high_resolution_clock::now();
+                ElemType sum = 0;
+                for (auto& p : parameters)
+                    sum += p.SumOfElements();
+                auto t_end = chrono::high_resolution_clock::now();
+                loadTime += chrono::duration<double>(t_loaded - t_start).count();
+                touchTime += chrono::duration<double>(t_end - t_loaded).count();
+                if (sum == 12345) // (keep the sum alive)
+                    cout << ".";
+            }
+            cout << (mappable ? "Mapped" : "Read") << " model of " << numMatrices * dim * dim * sizeof(ElemType) / (1024 * 1024) << " MB: load "
+                 << loadTime / count * 1000 << " ms, first pass over the parameters " << touchTime / count * 1000 << " ms" << endl;
+            _wunlink(fileName.c_str());
+        }
+    }
+}
+
 template <class ElemType>
 void MandSTest(int count, int devId)
 {
@@ -340,6 +531,19 @@ int wmain()
 {
     // MandSTest<float>(100, 2);
 
+    cout << endl << "********************TensorOp thread scaling TEST********************" << endl;
+    TensorOpThreadScalingTest<float>(20);
+
+    cout << endl << "********************CPU gradient quantizer TEST********************" << endl;
+    QuantizerThroughputTest<float>(10);
+    QuantizerThroughputTest<double>(10);
+
+    cout << endl << "********************Sparse Adam vs. vocabulary size TEST********************" << endl;
+    SparseAdamVocabSizeTest<float>(10);
+
+    cout << endl << "********************Read vs. mapped model load TEST********************" << endl;
+    ModelLoadTest<float>(5);
+
     /*cout<<endl<<"********************Matrix SquareMultiplyAndWeightedAdd10TimesAvg TEST********************"<<endl;
     SquareMultiplyAndAdd10TimesAvgTest<float>(4096,10);
 
@@ -4,6 +4,7 @@
 //
 #include "stdafx.h"
 #include "../../../Source/Math/CPUMatrix.h"
+#include <boost/random/uniform_real_distribution.hpp>
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -918,6 +919,73 @@ BOOST_FIXTURE_TEST_CASE(CPUMatrixSeedingDouble, RandomSeedFixture)
     BOOST_CHECK(m1.IsEqualTo(m2));
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUMatrixCounterBasedRNG, RandomSeedFixture)
+{
+    // known answer of Philox4x32-10 for a zero counter and key
+    CPURNGHandle zeroHandle(CPUDEVICE, 0);
+    uint32_t bits[4];
+    zeroHandle.Philox(0, bits);
+    BOOST_CHECK_EQUAL(bits[0], 0x6627e8d5u);
+    BOOST_CHECK_EQUAL(bits[1], 0xe169c58du);
+    BOOST_CHECK_EQUAL(bits[2], 0xbc57ac4cu);
+    BOOST_CHECK_EQUAL(bits[3], 0x9b00dbd8u);
+
+    const uint64_t seed = 4711;
+    const int maxNumThreads = CPUMatrix<float>::GetMaxNumThreads();
+
+    // by default, the random fills draw from the sequential Mersenne Twister stream
+    CPUMatrix<double> sequential(5, 7);
+    CPURNGHandle sequentialHandle(CPUDEVICE, seed, 3);
+    sequential.SetUniformRandomValue(sequentialHandle, -1, 1);
+    BOOST_CHECK(!sequentialHandle.IsCounterBased());
+    std::mt19937_64 generator(seed);
+    generator.discard(3);
+    boost::random::uniform_real_distribution<double> uniform(-1, 1);
+    for (size_t k = 0; k < sequential.GetNumElements(); k++)
+        BOOST_CHECK_EQUAL(sequential.Data()[k], uniform(generator));
+
+    CPUMatrix<float>::SetCounterBasedRandomGenerator(true);
+    auto resetGenerator = MakeScopeExit([]() { CPUMatrix<float>::SetCounterBasedRandomGenerator(false); });
+
+    // the result must not depend on the number of threads
+    CPUMatrix<float> m1(513, 257);
+    CPUMatrix<float> m2(513, 257);
+    CPUMatrix<float>::SetNumThreads(1);
+    CPURNGHandle handle1(CPUDEVICE, seed);
+    m1.SetUniformRandomMask(0.3f, 2.0f, handle1);
+    CPUMatrix<float>::SetNumThreads(maxNumThreads);
+    CPURNGHandle handle2(CPUDEVICE, seed);
+    m2.SetUniformRandomMask(0.3f, 2.0f, handle2);
+    BOOST_CHECK(m1.IsEqualTo(m2));
+    BOOST_CHECK_EQUAL(handle1.Offset(), m1.GetNumElements());
+
+    // about 30% of the values are masked, the others are scaled
+    size_t numMasked = 0;
+    foreach_coord (i, j, m1)
+    {
+        BOOST_CHECK(m1(i, j) == 0.0f || m1(i, j) == 2.0f);
+        numMasked += m1(i, j) == 0.0f;
+    }
+    BOOST_CHECK_CLOSE((double) numMasked / m1.GetNumElements(), 0.3, 2);
+
+    // a handle restored from (seed, offset) continues the stream, also at an offset that is not a multiple of the block size
+    CPUMatrix<double> first(7, 3);
+    CPUMatrix<double> second(100, 100);
+    CPUMatrix<double> restored(100, 100);
+    CPURNGHandle continued(CPUDEVICE, seed);
+    first.SetUniformRandomValue(continued, -1, 1);
+    second.SetGaussianRandomValue(continued, 1, 2);
+    CPURNGHandle restoredHandle(CPUDEVICE, seed, first.GetNumElements());
+    restored.SetGaussianRandomValue(restoredHandle, 1, 2);
+    BOOST_CHECK(second.IsEqualTo(restored));
+    BOOST_CHECK_EQUAL(continued.Offset(), restoredHandle.Offset());
+
+    // Gaussian moments
+    BOOST_CHECK_CLOSE(second.SumOfElements() / second.GetNumElements(), 1.0, 5);
+    second -= 1;
+    BOOST_CHECK_CLOSE(second.FrobeniusNorm() / sqrt((double) second.GetNumElements()), 2.0, 2);
+}
+
 BOOST_FIXTURE_TEST_CASE(CPUMatrixAdam, RandomSeedFixture)
 {
     CPUMatrix<double> adamMatrix;
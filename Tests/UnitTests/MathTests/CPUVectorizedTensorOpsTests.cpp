@@ -0,0 +1,190 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Compares the explicitly vectorized CPU TensorOp kernels against the scalar reference in TensorOps.h.
+//
+#include "stdafx.h"
+#include <random>
+#include "../../../Source/Math/CPUVectorizedTensorOps.h"
+#include "../../../Source/Math/TensorOps.h"
+#include "../../../Source/Math/CPUMatrix.h"
+#include "../../../Source/Math/TensorView.h"
+
+using namespace Microsoft::MSR::CNTK;
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+namespace
+{
+    // inputs: special values, then random values covering the interesting ranges; odd length to exercise the tail
+    void CreateInputs(vector<float>& a, vector<float>& b)
+    {
+        const float specials[] = { 0.0f, -0.0f, 1e-38f, 1e-37f, 1e-30f, INFINITY, -INFINITY, NAN, 88.7f, 88.8f, -87.0f, -103.0f, -110.0f,
+                                   1e-4f, -1e-4f, 0.624f, 0.626f, 9.0f, -9.0f, 20.0f };
+        for (float x : specials)
+        {
+            a.push_back(x);
+            b.push_back(-x);
+        }
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> linear(-20, 20), logarithmic(-30, 30);
+        for (size_t i = 0; i < 10001; i++)
+        {
+            a.push_back(i % 2 ? linear(rng) : exp(logarithmic(rng)));
+            b.push_back(linear(rng));
+        }
+    }
+
+    // exact ops must match bit by bit; approximate ones within 'tolerance', relative to max(1, |reference|)
+    void CheckResults(const char* what, CPUInstructionSet instructionSet, const vector<float>& inputs, const vector<float>& reference, const vector<float>& result, double tolerance)
+    {
+        size_t numMismatches = 0;
+        for (size_t i = 0; i < reference.size(); i++)
+        {
+            float r = reference[i], v = result[i];
+            bool same = (std::isnan(r) && std::isnan(v)) || r == v ||
+                        (std::isfinite(r) && fabs(r - v) <= tolerance * max(1.0, (double) fabs(r)));
+            if (!same && numMismatches++ < 5)
+                fprintf(stderr, "%s (instruction set %d): op(%.9g) = %.9g, expected %.9g\n", what, (int) instructionSet, inputs[i], v, r);
+        }
+        BOOST_CHECK_EQUAL(numMismatches, 0);
+    }
+
+    vector<CPUInstructionSet> SupportedInstructionSets()
+    {
+        vector<CPUInstructionSet> result;
+        for (auto instructionSet : { CPUInstructionSet::AVX2, CPUInstructionSet::AVX512 })
+        {
+            if ((int) instructionSet <= (int) CPUVectorizedTensorOps::GetSupportedInstructionSet())
+                result.push_back(instructionSet);
+        }
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(CPUVectorizedTensorOpsTests)
+
+BOOST_AUTO_TEST_CASE(UnaryOpsMatchScalarReference)
+{
+    vector<float> a, b;
+    CreateInputs(a, b);
+    const float alpha = 2, beta = 0.5f, initialValue = 7;
+
+    for (auto instructionSet : SupportedInstructionSets())
+    {
+#define TestUnaryOp(oper, tolerance)                                                                           \
+        {                                                                                                      \
+            auto kernel = CPUVectorizedTensorOps::GetUnaryKernel(ElementWiseOperator::op##oper, instructionSet); \
+            BOOST_REQUIRE(kernel != nullptr);                                                                  \
+            BOOST_CHECK_EQUAL(CPUVectorizedTensorOps::IsApproximate(ElementWiseOperator::op##oper), tolerance != 0); \
+            vector<float> result(a.size(), initialValue), reference(a.size());                                 \
+            kernel(a.size(), a.data(), result.data(), alpha, beta);                                            \
+            for (size_t i = 0; i < a.size(); i++)                                                              \
+            {                                                                                                  \
+                float val = Op##oper(a[i]);                                                                    \
+                val *= alpha;                                                                                  \
+                val += beta * initialValue;                                                                    \
+                reference[i] = val;                                                                            \
+            }                                                                                                  \
+            CheckResults(#oper, instructionSet, a, reference, result, tolerance);                              \
+        }
+
+        TestUnaryOp(Copy, 0);
+        TestUnaryOp(Negate, 0);
+        TestUnaryOp(Abs, 0);
+        TestUnaryOp(Floor, 0);
+        TestUnaryOp(Sqr, 0);
+        TestUnaryOp(Sqrt, 0);
+        TestUnaryOp(Reciprocal, 0);
+        TestUnaryOp(LinearRectifier, 0);
+        TestUnaryOp(Exp, 1e-6);
+        TestUnaryOp(Log, 1e-6);
+        TestUnaryOp(Tanh, 1e-6);
+        TestUnaryOp(Sigmoid, 1e-6);
+        TestUnaryOp(StableSigmoid, 1e-6);
+        TestUnaryOp(ExponentialLinearUnit, 1e-6);
+#undef TestUnaryOp
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BinaryOpsMatchScalarReference)
+{
+    vector<float> a, b;
+    CreateInputs(a, b);
+    const float alpha = 1, beta = 0;
+
+    for (auto instructionSet : SupportedInstructionSets())
+    {
+#define TestBinaryOp(oper, tolerance)                                                                           \
+        {                                                                                                       \
+            auto kernel = CPUVectorizedTensorOps::GetBinaryKernel(ElementWiseOperator::op##oper, instructionSet); \
+            BOOST_REQUIRE(kernel != nullptr);                                                                   \
+            BOOST_CHECK_EQUAL(CPUVectorizedTensorOps::IsApproximate(ElementWiseOperator::op##oper), tolerance != 0); \
+            vector<float> result(a.size(), NAN), reference(a.size()); /* must not be read since beta == 0 */    \
+            kernel(a.size(), a.data(), b.data(), result.data(), alpha, beta);                                   \
+            for (size_t i = 0; i < a.size(); i++)                                                               \
+                reference[i] = Op##oper(a[i], b[i]) * alpha;                                                    \
+            CheckResults(#oper, instructionSet, a, reference, result, tolerance);                               \
+        }
+
+        TestBinaryOp(CopyIf, 0);
+        TestBinaryOp(CopyIfNot, 0);
+        TestBinaryOp(Sum, 0);
+        TestBinaryOp(Difference, 0);
+        TestBinaryOp(ElementwiseProduct, 0);
+        TestBinaryOp(Max, 0);
+        TestBinaryOp(Min, 0);
+        TestBinaryOp(Equal, 0);
+        TestBinaryOp(NotEqual, 0);
+        TestBinaryOp(Greater, 0);
+        TestBinaryOp(Less, 0);
+        TestBinaryOp(GreaterEqual, 0);
+        TestBinaryOp(LessEqual, 0);
+        TestBinaryOp(MaskNegative, 0);
+        TestBinaryOp(ElementwiseProductWithSigmoidDerivativeFromOutput, 0);
+        TestBinaryOp(ElementwiseProductWithTanhDerivativeFromOutput, 0);
+        TestBinaryOp(ElementwiseProductWithLinearRectifierDerivativeFromOutput, 0);
+        TestBinaryOp(SqrOfDifference, 0);
+        TestBinaryOp(ElementwiseProductWithExponentialLinearUnitDerivativeFromOutput, 0);
+        TestBinaryOp(ElementwiseProductWithLogDerivativeFromOutput, 1e-6);
+#undef TestBinaryOp
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TensorViewUsesVectorizedKernels)
+{
+    // bias addition with broadcasting and in-place sigmoid, through TensorView, with and without the vectorized kernels
+    auto Run = [](CPUInstructionSet instructionSet) -> vector<float>
+    {
+        CPUVectorizedTensorOps::SetInstructionSet(instructionSet);
+        std::mt19937 rng(2);
+        std::uniform_real_distribution<float> nd(-5, 5);
+        vector<float> input(1000 * 37), bias(1000);
+        generate(input.begin(), input.end(), [&] { return nd(rng); });
+        generate(bias.begin(), bias.end(), [&] { return nd(rng); });
+        let inputSOB = make_shared<Matrix<float>>(input.size(), 1, input.data(), CPUDEVICE);
+        let biasSOB = make_shared<Matrix<float>>(bias.size(), 1, bias.data(), CPUDEVICE);
+        let resultSOB = make_shared<Matrix<float>>(input.size(), 1, CPUDEVICE);
+        TensorView<float> result(resultSOB, TensorShape(1000, 37));
+        result.AssignSumOf(TensorView<float>(inputSOB, TensorShape(1000, 37)), TensorView<float>(biasSOB, TensorShape(1000)));
+        result.AssignSigmoidOf(result);
+        unique_ptr<float[]> values(resultSOB->CopyToArray());
+        return vector<float>(values.get(), values.get() + input.size());
+    };
+
+    let supportedInstructionSet = CPUVectorizedTensorOps::GetSupportedInstructionSet();
+    let reference = Run(CPUInstructionSet::Scalar);
+    // by default the sigmoid takes the generic code, so the result is exact
+    let result = Run(supportedInstructionSet);
+    CheckResults("Sigmoid(Sum)", supportedInstructionSet, reference, reference, result, 0);
+    // with approximate transcendentals within the tolerance of the Sigmoid kernel
+    CPUVectorizedTensorOps::SetApproximateTranscendentals(true);
+    let approximateResult = Run(supportedInstructionSet);
+    CPUVectorizedTensorOps::SetApproximateTranscendentals(false);
+    CPUVectorizedTensorOps::SetInstructionSet(supportedInstructionSet);
+    CheckResults("Sigmoid(Sum)", supportedInstructionSet, reference, reference, approximateResult, 1e-6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
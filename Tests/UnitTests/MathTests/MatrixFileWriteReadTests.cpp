@@ -70,6 +70,59 @@ BOOST_FIXTURE_TEST_CASE(MatrixFileWriteRead, RandomSeedFixture)
     BOOST_CHECK(matrixSparseRead.IsEqualTo(matrixSparseCopy, c_epsilonFloatE5));
 }
 
+BOOST_FIXTURE_TEST_CASE(MatrixFileWriteReadMappable, RandomSeedFixture)
+{
+    // odd sizes, so that neither the data nor the stream position after it is aligned by chance
+    Matrix<float> matrix1 = Matrix<float>::RandomUniform(43, 10, CPUDEVICE, -26.3f, 30.2f, IncrementCounter());
+    Matrix<float> matrix2 = Matrix<float>::RandomUniform(1027, 3, CPUDEVICE, -26.3f, 30.2f, IncrementCounter());
+    Matrix<float> matrixEmpty(0, 5, CPUDEVICE);
+
+    std::wstring fileName(L"MMappable.bin");
+    {
+        File file(fileName, fileOptionsBinary | fileOptionsWrite | fileOptionsMappable);
+        file << matrix1 << 42 << matrix2 << matrixEmpty;
+    }
+
+    Matrix<float> matrix1Read(CPUDEVICE), matrix2Read(CPUDEVICE), matrixEmptyRead(CPUDEVICE);
+    int value;
+    {
+        File file(fileName, fileOptionsBinary | fileOptionsRead);
+        file >> matrix1Read >> value >> matrix2Read >> matrixEmptyRead;
+        BOOST_CHECK_EQUAL(file.Size(), file.GetPosition());
+    }
+
+    // the matrices stay valid after the file is closed
+    BOOST_CHECK_EQUAL(42, value);
+    BOOST_CHECK(matrix1Read.IsEqualTo(matrix1, 0.0f));
+    BOOST_CHECK(matrix2Read.IsEqualTo(matrix2, 0.0f));
+    BOOST_CHECK_EQUAL(0, matrixEmptyRead.GetNumRows());
+    BOOST_CHECK_EQUAL(5, matrixEmptyRead.GetNumCols());
+
+    // served in place from the mapping
+    BOOST_CHECK_EQUAL(0, (size_t) matrix1Read.Data() % 4096);
+    BOOST_CHECK_EQUAL(0, (size_t) matrix2Read.Data() % 4096);
+
+    // writing to a mapped matrix does not change the file, and it can still be resized
+    matrix1Read.SetValue(1.0f);
+    matrix2Read.Resize(2000, 3);
+    matrix2Read.SetValue(2.0f);
+    {
+        File file(fileName, fileOptionsBinary | fileOptionsRead);
+        file >> matrix1Read >> value >> matrix2Read;
+    }
+    BOOST_CHECK(matrix1Read.IsEqualTo(matrix1, 0.0f));
+    BOOST_CHECK(matrix2Read.IsEqualTo(matrix2, 0.0f));
+
+    // a matrix whose buffer is shared with a view is read into that buffer instead
+    Matrix<float> matrixShared(43, 10, CPUDEVICE);
+    Matrix<float> view = matrixShared.ColumnSlice(0, 10);
+    {
+        File file(fileName, fileOptionsBinary | fileOptionsRead);
+        file >> matrixShared;
+    }
+    BOOST_CHECK(view.IsEqualTo(matrix1, 0.0f));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(GPUMatrixSuite)
@@ -4,6 +4,8 @@
 //
 #include "stdafx.h"
 #include <math.h>
+#include <algorithm>
+#include <memory>
 #ifdef _WIN32
 #include <crtdefs.h>
 #endif 
@@ -26,30 +28,30 @@ public:
     SingleMatrix matG;
     SingleMatrix matGsparseBSC;
 
-    MatrixLearnerFixture() :
-        matSG(c_deviceIdZero),
-        matSGsparse(c_deviceIdZero),
-        matM(c_deviceIdZero),
-        matMsparse(c_deviceIdZero),
-        matG(c_deviceIdZero),
-        matGsparseBSC(c_deviceIdZero)
+    MatrixLearnerFixture(DEVICEID_TYPE deviceId = c_deviceIdZero) :
+        matSG(deviceId),
+        matSGsparse(deviceId),
+        matM(deviceId),
+        matMsparse(deviceId),
+        matG(deviceId),
+        matGsparseBSC(deviceId)
     {
         // smoothed gradient
-        matSG = SingleMatrix::RandomGaussian(dim1, dim2, c_deviceIdZero, -1.0f, 1.0f, IncrementCounter());
+        matSG = SingleMatrix::RandomGaussian(dim1, dim2, deviceId, -1.0f, 1.0f, IncrementCounter());
         matSGsparse = SingleMatrix(matSG.DeepClone());
 
         // model
-        matM = SingleMatrix::RandomGaussian(dim1, dim2, c_deviceIdZero, -1.0f, 1.0f, IncrementCounter());
+        matM = SingleMatrix::RandomGaussian(dim1, dim2, deviceId, -1.0f, 1.0f, IncrementCounter());
         matMsparse = SingleMatrix(matM.DeepClone());
 
         // generates gradient
-        SingleMatrix matG1(c_deviceIdZero);
-        matG1.AssignTruncateBottomOf(Matrix<float>::RandomUniform(dim2, dim3, c_deviceIdZero, -300.0f, 0.1f, IncrementCounter()), 0);
+        SingleMatrix matG1(deviceId);
+        matG1.AssignTruncateBottomOf(Matrix<float>::RandomUniform(dim2, dim3, deviceId, -300.0f, 0.1f, IncrementCounter()), 0);
 
         SingleMatrix matG1sparseCSC(matG1.DeepClone());
         matG1sparseCSC.SwitchToMatrixType(MatrixType::SPARSE, matrixFormatSparseCSC, true);
 
-        SingleMatrix matG2 = SingleMatrix::RandomGaussian(dim1, dim3, c_deviceIdZero, -1.0f, 1.0f, IncrementCounter());
+        SingleMatrix matG2 = SingleMatrix::RandomGaussian(dim1, dim3, deviceId, -1.0f, 1.0f, IncrementCounter());
 
         SingleMatrix::MultiplyAndWeightedAdd(1, matG2, false, matG1, true, 0, matG);
 
@@ -72,6 +74,56 @@ public:
     }
 };
 
+// Same data on the CPU, for the lazy sparse learners which only update the columns present in the gradient.
+class MatrixLearnerCPUFixture : public MatrixLearnerFixture
+{
+public:
+    MatrixLearnerCPUFixture() : MatrixLearnerFixture(CPUDEVICE)
+    {
+    }
+
+    // columns of the dense gradient that are all zero, i.e. not present in the block sparse gradient
+    std::vector<size_t> AbsentColumns()
+    {
+        std::unique_ptr<float[]> g(matG.CopyToArray());
+        std::vector<size_t> absent;
+        for (size_t j = 0; j < dim2; j++)
+        {
+            if (std::all_of(g.get() + j * dim1, g.get() + (j + 1) * dim1, [](float v) { return v == 0; }))
+                absent.push_back(j);
+        }
+        return absent;
+    }
+
+    static bool ColumnsEqual(const SingleMatrix& a, const SingleMatrix& b, const std::vector<size_t>& columns)
+    {
+        for (size_t j : columns)
+        {
+            if (!a.ColumnSlice(j, 1).IsEqualTo(b.ColumnSlice(j, 1), 0))
+                return false;
+        }
+        return true;
+    }
+
+    // a gradient in which only the columns in [begin, end) are present, as block sparse and as dense matrix
+    void GradientWithColumns(size_t begin, size_t end, SingleMatrix& dense, SingleMatrix& sparse)
+    {
+        SingleMatrix g1t = SingleMatrix::RandomUniform(dim3, dim2, CPUDEVICE, -0.01f, 0.01f, IncrementCounter());
+        for (size_t j = 0; j < dim2; j++)
+        {
+            if (j < begin || j >= end)
+                g1t.SetColumn(0.0f, j);
+        }
+        SingleMatrix g1 = g1t.Transpose();
+        SingleMatrix g2 = SingleMatrix::RandomGaussian(dim1, dim3, CPUDEVICE, 0.0f, 1.0f, IncrementCounter());
+
+        SingleMatrix::MultiplyAndWeightedAdd(1, g2, false, g1, true, 0, dense);
+        g1.SwitchToMatrixType(MatrixType::SPARSE, matrixFormatSparseCSC, true);
+        sparse.SwitchToMatrixType(MatrixType::SPARSE, matrixFormatSparseBlockCol, false);
+        SingleMatrix::MultiplyAndAdd(g2, false, g1, true, sparse);
+    }
+};
+
 namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
 
 BOOST_AUTO_TEST_SUITE(MatrixLearnerSuite)
@@ -114,5 +166,260 @@ BOOST_FIXTURE_TEST_CASE(AdaDeltaSparse, MatrixLearnerFixture)
     });
 }
 
+// tests the lazy CPU sparse learners: starting from an empty state, the columns absent from the gradient are not
+// changed by the dense update either, so both must agree
+BOOST_FIXTURE_TEST_CASE(AdamSparseCPU, MatrixLearnerCPUFixture)
+{
+    for (bool adamax : {false, true})
+    {
+        SingleMatrix matState(CPUDEVICE), matStateSparse(CPUDEVICE);
+        SingleMatrix model(matM.DeepClone()), modelSparse(matM.DeepClone());
+        for (size_t step = 1; step <= 3; step++)
+        {
+            matState.AdamUpdate(matG, model, (double) step, 0.01, 0.9, 0.999, 1e-8, true, adamax);
+            matStateSparse.AdamUpdate(matGsparseBSC, modelSparse, (double) step, 0.01, 0.9, 0.999, 1e-8, true, adamax);
+        }
+
+        BOOST_CHECK(matState.IsEqualTo(matStateSparse, c_epsilonFloatE5));
+        BOOST_CHECK(model.IsEqualTo(modelSparse, c_epsilonFloatE5));
+    }
+}
+
+// With the last update steps, the moments of a column absent from some steps are decayed for them when it is present
+// again, so that they match the dense update, whose bias correction assumes that.
+BOOST_FIXTURE_TEST_CASE(AdamSparseCPUSkippedSteps, MatrixLearnerCPUFixture)
+{
+    // the first half of the columns is present in steps 1 and 3, the second half in steps 2 and 3
+    std::vector<SingleMatrix> dense, sparse;
+    const size_t columns[3][2] = { { 0, dim2 / 2 }, { dim2 / 2, dim2 }, { 0, dim2 } };
+    for (const auto& c : columns)
+    {
+        dense.push_back(SingleMatrix(CPUDEVICE));
+        sparse.push_back(SingleMatrix(CPUDEVICE));
+        GradientWithColumns(c[0], c[1], dense.back(), sparse.back());
+    }
+
+    for (bool adamax : { false, true })
+    {
+        SingleMatrix matState(CPUDEVICE), matStateSparse(CPUDEVICE), matStateSparseNoSteps(CPUDEVICE);
+        SingleMatrix model(matM.DeepClone()), modelSparse(matM.DeepClone()), modelSparseNoSteps(matM.DeepClone());
+        Matrix<double> lastUpdateSteps(CPUDEVICE);
+        for (size_t step = 1; step <= 3; step++)
+        {
+            matState.AdamUpdate(dense[step - 1], model, (double) step, 0.01, 0.9, 0.999, 1e-8, true, adamax);
+            matStateSparse.AdamUpdate(sparse[step - 1], modelSparse, (double) step, 0.01, 0.9, 0.999, 1e-8, true, adamax, &lastUpdateSteps);
+            matStateSparseNoSteps.AdamUpdate(sparse[step - 1], modelSparseNoSteps, (double) step, 0.01, 0.9, 0.999, 1e-8, true, adamax);
+        }
+
+        BOOST_CHECK(matState.IsEqualTo(matStateSparse, c_epsilonFloatE5));
+        BOOST_CHECK(!matState.IsEqualTo(matStateSparseNoSteps, c_epsilonFloatE5));
+        BOOST_CHECK(lastUpdateSteps.GetNumCols() == dim2);
+        std::unique_ptr<double[]> steps(lastUpdateSteps.CopyToArray());
+        BOOST_CHECK(std::all_of(steps.get(), steps.get() + dim2, [](double s) { return s == 3; }));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(FSAdagradSparseCPU, MatrixLearnerCPUFixture)
+{
+    SingleMatrix matState(CPUDEVICE), matStateSparse(CPUDEVICE);
+    for (size_t step = 1; step <= 3; step++)
+    {
+        matState.FSAdagradUpdate(matG, matM, 0.5, 0.0001, 1.0, 0.9, true);
+        matStateSparse.FSAdagradUpdate(matGsparseBSC, matMsparse, 0.5, 0.0001, 1.0, 0.9, true);
+    }
+
+    BOOST_CHECK(matState.IsEqualTo(matStateSparse, c_epsilonFloatE5));
+    BOOST_CHECK(matM.IsEqualTo(matMsparse, c_epsilonFloatE5));
+}
+
+// as AdamSparseCPUSkippedSteps, for the accumulators of FSAdaGrad
+BOOST_FIXTURE_TEST_CASE(FSAdagradSparseCPUSkippedSteps, MatrixLearnerCPUFixture)
+{
+    std::vector<SingleMatrix> dense, sparse;
+    const size_t columns[3][2] = { { 0, dim2 / 2 }, { dim2 / 2, dim2 }, { 0, dim2 } };
+    for (const auto& c : columns)
+    {
+        dense.push_back(SingleMatrix(CPUDEVICE));
+        sparse.push_back(SingleMatrix(CPUDEVICE));
+        GradientWithColumns(c[0], c[1], dense.back(), sparse.back());
+    }
+
+    SingleMatrix matState(CPUDEVICE), matStateSparse(CPUDEVICE), matStateSparseNoSteps(CPUDEVICE);
+    SingleMatrix model(matM.DeepClone()), modelSparse(matM.DeepClone()), modelSparseNoSteps(matM.DeepClone());
+    Matrix<double> lastUpdateSteps(CPUDEVICE);
+    for (size_t step = 1; step <= 3; step++)
+    {
+        matState.FSAdagradUpdate(dense[step - 1], model, 0.5, 0.0001, 0.9, 0.9, true);
+        matStateSparse.FSAdagradUpdate(sparse[step - 1], modelSparse, 0.5, 0.0001, 0.9, 0.9, true, &lastUpdateSteps, (double) step);
+        matStateSparseNoSteps.FSAdagradUpdate(sparse[step - 1], modelSparseNoSteps, 0.5, 0.0001, 0.9, 0.9, true);
+    }
+
+    BOOST_CHECK(matState.IsEqualTo(matStateSparse, c_epsilonFloatE5));
+    BOOST_CHECK(!matState.IsEqualTo(matStateSparseNoSteps, c_epsilonFloatE5));
+}
+
+// as AdamSparseCPUSkippedSteps, for the variances and step sizes of RmsProp; the scaled gradients of the last step,
+// in which all columns are present, then match the dense update
+BOOST_FIXTURE_TEST_CASE(RmsPropSparseCPUSkippedSteps, MatrixLearnerCPUFixture)
+{
+    std::vector<SingleMatrix> dense, sparse;
+    const size_t columns[4][2] = { { 0, dim2 }, { 0, dim2 / 2 }, { dim2 / 2, dim2 }, { 0, dim2 } };
+    for (const auto& c : columns)
+    {
+        dense.push_back(SingleMatrix(CPUDEVICE));
+        sparse.push_back(SingleMatrix(CPUDEVICE));
+        GradientWithColumns(c[0], c[1], dense.back(), sparse.back());
+    }
+
+    SingleMatrix matState(CPUDEVICE), matStateSparse(CPUDEVICE);
+    Matrix<double> lastUpdateSteps(CPUDEVICE);
+    for (size_t step = 1; step <= 4; step++)
+    {
+        matState.RmsProp(dense[step - 1], 0.99f, 1.2f, 10.0f, 0.75f, 0.1f, false, step > 1);
+        matStateSparse.RmsProp(sparse[step - 1], 0.99f, 1.2f, 10.0f, 0.75f, 0.1f, false, step > 1, &lastUpdateSteps, (double) step);
+    }
+
+    SingleMatrix scaledSparse(sparse.back().DeepClone());
+    scaledSparse.SwitchToMatrixType(MatrixType::DENSE, matrixFormatDense, true);
+    BOOST_CHECK(dense.back().IsEqualTo(scaledSparse, c_epsilonFloatE4));
+    BOOST_CHECK(matState.IsEqualTo(matStateSparse, c_epsilonFloatE4));
+}
+
+// as RmsPropSparseCPUSkippedSteps, with the second half of the columns absent from the first step, in which the
+// dense update already shrinks their step sizes
+BOOST_FIXTURE_TEST_CASE(RmsPropSparseCPUAbsentInFirstStep, MatrixLearnerCPUFixture)
+{
+    std::vector<SingleMatrix> dense, sparse;
+    const size_t columns[3][2] = { { 0, dim2 / 2 }, { 0, dim2 / 2 }, { 0, dim2 } };
+    for (const auto& c : columns)
+    {
+        dense.push_back(SingleMatrix(CPUDEVICE));
+        sparse.push_back(SingleMatrix(CPUDEVICE));
+        GradientWithColumns(c[0], c[1], dense.back(), sparse.back());
+    }
+
+    SingleMatrix matState(CPUDEVICE), matStateSparse(CPUDEVICE);
+    Matrix<double> lastUpdateSteps(CPUDEVICE);
+    for (size_t step = 1; step <= 3; step++)
+    {
+        matState.RmsProp(dense[step - 1], 0.99f, 1.2f, 10.0f, 0.75f, 0.1f, false, step > 1);
+        matStateSparse.RmsProp(sparse[step - 1], 0.99f, 1.2f, 10.0f, 0.75f, 0.1f, false, step > 1, &lastUpdateSteps, (double) step);
+    }
+
+    SingleMatrix scaledSparse(sparse.back().DeepClone());
+    scaledSparse.SwitchToMatrixType(MatrixType::DENSE, matrixFormatDense, true);
+    BOOST_CHECK(dense.back().IsEqualTo(scaledSparse, c_epsilonFloatE4));
+    BOOST_CHECK(matState.IsEqualTo(matStateSparse, c_epsilonFloatE4));
+}
+
+BOOST_FIXTURE_TEST_CASE(RmsPropSparseCPU, MatrixLearnerCPUFixture)
+{
+    // the dense step sizes of absent columns still decay, so only the scaled gradients are compared
+    SingleMatrix matState(CPUDEVICE), matStateSparse(CPUDEVICE);
+    matState.RmsProp(matG, 0.99f, 1.2f, 10.0f, 0.75f, 0.1f, true, false);
+    float avgSparse = matStateSparse.RmsProp(matGsparseBSC, 0.99f, 1.2f, 10.0f, 0.75f, 0.1f, true, false);
+
+    SingleMatrix scaledSparse(matGsparseBSC.DeepClone());
+    scaledSparse.SwitchToMatrixType(MatrixType::DENSE, matrixFormatDense, true);
+    BOOST_CHECK(matG.IsEqualTo(scaledSparse, c_epsilonFloatE4));
+    BOOST_CHECK(avgSparse > 0);
+}
+
+// the state and model of columns without gradient must be left alone, whatever their current values
+BOOST_FIXTURE_TEST_CASE(LazySparseCPUUntouchedColumns, MatrixLearnerCPUFixture)
+{
+    auto absent = AbsentColumns();
+    BOOST_REQUIRE(!absent.empty() && absent.size() < dim2);
+
+    SingleMatrix state = SingleMatrix::RandomGaussian(dim1, 2 * dim2, CPUDEVICE, 0.0f, 1.0f, IncrementCounter());
+    state.InplaceAbs();
+    SingleMatrix stateBefore(state.DeepClone());
+
+    state.AdamUpdate(matGsparseBSC, matMsparse, 10.0, 0.01, 0.9, 0.999, 1e-8, true, false);
+    BOOST_CHECK(ColumnsEqual(matM, matMsparse, absent));
+    BOOST_CHECK(ColumnsEqual(stateBefore, state, absent));
+    BOOST_CHECK(!matM.IsEqualTo(matMsparse, 0));
+
+    state.SetValue(stateBefore);
+    state.FSAdagradUpdate(matGsparseBSC, matMsparse, 0.5, 0.0001, 1.0, 0.9, true);
+    BOOST_CHECK(ColumnsEqual(matM, matMsparse, absent));
+    BOOST_CHECK(ColumnsEqual(stateBefore, state, absent));
+}
+
+// tests the fused update of several parameters against the separate operations done per parameter by the learners
+BOOST_FIXTURE_TEST_CASE(MultiTensorSGDUpdateCPU, RandomSeedFixture)
+{
+    // small and large parameters, the latter are split into several chunks
+    const std::vector<std::pair<size_t, size_t>> shapes = { { 1, 1 }, { 7, 1 }, { 128, 3 }, { 300, 200 }, { 1, 65 }, { 129, 130 } };
+    const size_t minibatchSize = 32;
+
+    for (int updateType = 0; updateType < 3; updateType++) // SGD, momentum, Nesterov
+    for (int clipping = 0; clipping < 3; clipping++)      // none, truncation, norm
+    for (bool useMeanGradient : { false, true })
+    {
+        MultiTensorSGDOptions options;
+        options.gradientScale = useMeanGradient ? 1.0 / minibatchSize : 1.0;
+        const size_t mbScale = useMeanGradient ? 1 : minibatchSize;
+        if (clipping > 0)
+            options.clippingThreshold = 0.05 * mbScale;
+        options.clippingWithTruncation = clipping == 1;
+        options.l2RegularizationWeight = 0.001 * mbScale;
+        options.learnRatePerSample = 0.01;
+        options.momentum = 0.9;
+        options.unitGainMomentum = updateType == 1;
+        options.nesterov = updateType == 2;
+
+        std::vector<SingleMatrix> parameters, gradients, smoothedGradients;
+        std::vector<SingleMatrix> refParameters, refGradients, refSmoothedGradients;
+        for (const auto& shape : shapes)
+        {
+            parameters.push_back(SingleMatrix::RandomGaussian(shape.first, shape.second, CPUDEVICE, 0.0f, 1.0f, IncrementCounter()));
+            gradients.push_back(SingleMatrix::RandomGaussian(shape.first, shape.second, CPUDEVICE, 0.0f, 1.0f, IncrementCounter()));
+            smoothedGradients.push_back(SingleMatrix::RandomGaussian(shape.first, shape.second, CPUDEVICE, 0.0f, 0.1f, IncrementCounter()));
+            refParameters.push_back(parameters.back().DeepClone());
+            refGradients.push_back(gradients.back().DeepClone());
+            refSmoothedGradients.push_back(smoothedGradients.back().DeepClone());
+        }
+
+        std::vector<SingleMatrix*> parameterPtrs, gradientPtrs, smoothedGradientPtrs;
+        for (size_t t = 0; t < shapes.size(); t++)
+        {
+            parameterPtrs.push_back(&parameters[t]);
+            gradientPtrs.push_back(&gradients[t]);
+            if (updateType > 0)
+                smoothedGradientPtrs.push_back(&smoothedGradients[t]);
+        }
+        SingleMatrix::MultiTensorSGDUpdate(parameterPtrs, gradientPtrs, smoothedGradientPtrs, options);
+
+        for (size_t t = 0; t < shapes.size(); t++)
+        {
+            auto& gradient = refGradients[t];
+            auto& parameter = refParameters[t];
+            if (useMeanGradient)
+                SingleMatrix::Scale(1.0f / minibatchSize, gradient);
+            if (clipping == 1)
+                gradient.InplaceTruncate((float) options.clippingThreshold);
+            else if (clipping == 2)
+            {
+                double norm = gradient.FrobeniusNorm();
+                if (norm > options.clippingThreshold)
+                    gradient *= (float) (options.clippingThreshold / norm);
+            }
+            SingleMatrix::ScaleAndAdd((float) options.l2RegularizationWeight, parameter, gradient);
+
+            if (updateType == 0)
+                parameter.SGDUpdate(gradient, (float) options.learnRatePerSample);
+            else if (updateType == 1)
+                parameter.MomentumSGDUpdate(gradient, refSmoothedGradients[t], (float) options.learnRatePerSample, (float) options.momentum, options.unitGainMomentum);
+            else
+                parameter.NesterovAcceleratedMomentumSGDUpdate(gradient, refSmoothedGradients[t], (float) options.learnRatePerSample, (float) options.momentum, options.unitGainMomentum);
+
+            BOOST_CHECK(parameters[t].IsEqualTo(parameter, c_epsilonFloatE5));
+            BOOST_CHECK(gradients[t].IsEqualTo(gradient, c_epsilonFloatE5));
+            BOOST_CHECK(smoothedGradients[t].IsEqualTo(refSmoothedGradients[t], c_epsilonFloatE5));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }}}}
@@ -246,7 +246,8 @@ static void TestRunQuantization(
     int seed,
     int numIterations,
     int deviceId,
-    bool zeroThresholdFor1Bit)
+    bool zeroThresholdFor1Bit,
+    bool useAsync)
 {
     auto verifyAllZerosFunc = [](const Matrix<ElemType>& matrix)
     {
@@ -262,7 +263,7 @@ static void TestRunQuantization(
     std::unique_ptr<MemAllocator> allocator(deviceId == CPUDEVICE ? nullptr : new CUDAPageLockedMemAllocator(deviceId));
 
     Matrix<ElemType> inMatrix(numRows, numCols, deviceId);
-    std::unique_ptr<MatrixQuantizerImpl<ElemType>> quantizer(MatrixQuantizerImpl<ElemType>::Create(deviceId, false /*useAsync*/));
+    std::unique_ptr<MatrixQuantizerImpl<ElemType>> quantizer(MatrixQuantizerImpl<ElemType>::Create(deviceId, useAsync));
     Matrix<ElemType> residueMatrix(numRows, numCols, deviceId);
 
     // Verify that the initial residue is comprised of all zeros
@@ -379,7 +380,7 @@ static void TestRunQuantization(
 }
 
 template <typename ElemType>
-static void TestQuantization(int deviceId, size_t numRows, size_t numCols, float rangeLow, float rangeHigh, int seed, int numIterations)
+static void TestQuantization(int deviceId, size_t numRows, size_t numCols, float rangeLow, float rangeHigh, int seed, int numIterations, bool useAsync = false)
 {
     // Test quantization for all power of 2 bit sizes
     const auto maxNumBits = 8 * sizeof(ElemType);
@@ -396,7 +397,7 @@ static void TestQuantization(int deviceId, size_t numRows, size_t numCols, float
                 continue;
             }
 
-            TestRunQuantization<ElemType>(numBits, numRows, numCols, rangeLow, rangeHigh, seed, numIterations, deviceId, zeroThresholdFor1Bit);
+            TestRunQuantization<ElemType>(numBits, numRows, numCols, rangeLow, rangeHigh, seed, numIterations, deviceId, zeroThresholdFor1Bit, useAsync);
         }
     }
 }
@@ -471,6 +472,15 @@ BOOST_FIXTURE_TEST_CASE(CPUMatrix1BitQuantizeDouble, RandomSeedFixture)
     TestQuantization<double>(CPUDEVICE, 100, 50, -0.5f, +0.5f, 2915, 5);
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUMatrix1BitQuantizeAsync, RandomSeedFixture)
+{
+    // Large enough for the columns to be quantized in parallel
+    TestQuantization<float>(CPUDEVICE, 737, 373, -0.5f, +0.5f, 2915, 3, true /*useAsync*/);
+    TestQuantization<float>(CPUDEVICE, 1, 135, -0.5f, +0.5f, 2615, 3, true /*useAsync*/);
+    TestQuantization<double>(CPUDEVICE, 737, 373, -1.0f, +2.05f, 2415, 3, true /*useAsync*/);
+    TestQuantization<double>(CPUDEVICE, 489, 1, -0.5f, +0.5f, 2515, 3, true /*useAsync*/);
+}
+
 /*
         Original test cases were using these parameter:
 
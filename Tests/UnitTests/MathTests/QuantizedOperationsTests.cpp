@@ -5,6 +5,7 @@
 #include "stdafx.h"
 #include "../../../Source/Math/QuantizedOperations.h"
 #include "../../../Source/Math/Helpers.h"
+#include <random>
 
 using namespace Microsoft::MSR::CNTK;
 namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
@@ -50,6 +51,185 @@ BOOST_FIXTURE_TEST_CASE(MultiplyIntToShort, RandomSeedFixture)
         BOOST_CHECK_EQUAL(round(C_upd[i]), C_expected_upd[i]);
 }
 
+// Naive product of row-major integer matrices, C[m,n] = A[m,k] * B[k,n].
+static vector<int32_t> ReferenceIntProduct(const vector<short>& A, const vector<short>& B, int m, int k, int n)
+{
+    vector<int32_t> C(m * n, 0);
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            for (int l = 0; l < k; l++)
+                C[i * n + j] += A[i * k + l] * B[l * n + j];
+    return C;
+}
+
+BOOST_AUTO_TEST_CASE(QuantizedGemmMatchesReference)
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> values(-63, 63);
+    auto RandomMatrix = [&](int rows, int cols)
+    {
+        vector<short> result(rows * cols);
+        for (auto& v : result)
+            v = (short) values(rng);
+        return result;
+    };
+
+    vector<CPUInstructionSet> instructionSets = { CPUInstructionSet::Scalar };
+    if ((int) CPUVectorizedTensorOps::GetSupportedInstructionSet() >= (int) CPUInstructionSet::AVX2)
+        instructionSets.push_back(CPUInstructionSet::AVX2);
+
+    // [m, k, n]: k = 249 hits all kernel block sizes (128 + 64 + 32 + 16 + 8 + 1), m = 8 uses the four-row kernels
+    const int sizes[][3] = { { 1, 249, 7 }, { 8, 128, 8 }, { 7, 249, 5 }, { 8, 249, 3 }, { 4, 3, 9 } };
+    for (auto instructionSet : instructionSets)
+    {
+        auto gemm = QuantizedGemm::Create(instructionSet);
+        for (const auto& size : sizes)
+        {
+            int m = size[0], k = size[1], n = size[2];
+            auto B = RandomMatrix(k, n);
+            gemm->PrepareB(B.data(), k, n);
+
+            // multiply twice by the same prepared B, with different A
+            for (int pass = 0; pass < 2; pass++)
+            {
+                auto A = RandomMatrix(m, k);
+                vector<int32_t> C(m * n, -1);
+                gemm->Multiply(A.data(), m, k, n, C.data());
+                auto expected = ReferenceIntProduct(A, B, m, k, n);
+                BOOST_CHECK_EQUAL_COLLECTIONS(C.begin(), C.end(), expected.begin(), expected.end());
+            }
+        }
+
+        vector<int32_t> C(4);
+        vector<short> A(4);
+        BOOST_CHECK_THROW(gemm->Multiply(A.data(), 1, 4, 4, C.data()), std::logic_error); // doesn't match the last prepared B
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(MultiplyWithEitherConstantOperand, RandomSeedFixture)
+{
+    // The product is computed differently depending on which operand is constant; all must match the float product
+    // up to the quantization error, and each other exactly. (bitShift 4 keeps the 131-term dot products within int32.)
+    const int m = 37, n = 5, k = 131;
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> values(-1, 1);
+    vector<float> A(m * k), B(k * n);
+    for (auto& v : A)
+        v = values(rng);
+    for (auto& v : B)
+        v = values(rng);
+
+    vector<float> expected(m * n, 0);
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            for (int l = 0; l < k; l++)
+                expected[i + j * m] += A[i + l * m] * B[l + j * k];
+
+    vector<float> reference;
+    for (int mode = 0; mode < 3; mode++)
+    {
+        shared_ptr<QuantizerBase<float, short>> quantA(new SymmetricQuantizer<float, short>(4));
+        shared_ptr<QuantizerBase<float, short>> quantB(new SymmetricQuantizer<float, short>(4));
+        QuantizedMultiplier<float> mult(quantA, mode == 0, quantB, mode == 1);
+        vector<float> C(m * n);
+        for (int pass = 0; pass < 2; pass++)
+        {
+            mult.Multiply(m, n, k, A.data(), B.data(), C.data());
+            for (size_t i = 0; i < C.size(); i++)
+                BOOST_CHECK_SMALL(C[i] - expected[i], 0.02f);
+            if (reference.empty())
+                reference = C;
+            else
+                BOOST_CHECK(C == reference);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Int8GemmMatchesReference)
+{
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> values(-127, 127);
+    auto RandomMatrix = [&](int rows, int cols)
+    {
+        vector<int8_t> result;
+        result.reserve(rows * cols);
+        for (int i = 0; i < rows * cols; i++)
+            result.push_back((int8_t) values(rng));
+        return result;
+    };
+
+    vector<CPUInstructionSet> instructionSets = { CPUInstructionSet::Scalar };
+    if ((int) CPUVectorizedTensorOps::GetSupportedInstructionSet() >= (int) CPUInstructionSet::AVX2)
+        instructionSets.push_back(CPUInstructionSet::AVX2);
+
+    // [m, k, n]: k covers the 32- and 16-element steps and the scalar tail; the last one is large enough to run in parallel
+    const int sizes[][3] = { { 1, 7, 1 }, { 5, 16, 3 }, { 7, 61, 4 }, { 3, 32, 1 }, { 64, 300, 9 } };
+    for (auto instructionSet : instructionSets)
+    {
+        for (const auto& size : sizes)
+        {
+            int m = size[0], k = size[1], n = size[2];
+            auto A = RandomMatrix(m, k); // row-major
+            auto B = RandomMatrix(k, n); // column-major
+            vector<int32_t> C(m * n, -1), expected(m * n, 0);
+            Int8Gemm::Multiply(A.data(), B.data(), m, n, k, C.data(), instructionSet);
+            for (int i = 0; i < m; i++)
+                for (int j = 0; j < n; j++)
+                    for (int l = 0; l < k; l++)
+                        expected[i + j * m] += A[i * k + l] * B[j * k + l];
+            BOOST_CHECK_EQUAL_COLLECTIONS(C.begin(), C.end(), expected.begin(), expected.end());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Int8MultiplierMatchesFloatProduct)
+{
+    const int m = 37, n = 5, k = 131;
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> values(-1, 1);
+    vector<float> A(m * k), B(k * n);
+    for (auto& v : A)
+        v = values(rng);
+    for (int i = 0; i < m; i++) // rows of very different magnitudes, which per-row scales handle
+        for (int l = 0; l < k; l++)
+            A[i + l * m] *= (float) (i + 1);
+    for (auto& v : B)
+        v = values(rng);
+
+    vector<float> expected(m * n, 0);
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            for (int l = 0; l < k; l++)
+                expected[i + j * m] += A[i + l * m] * B[l + j * k];
+
+    Int8QuantizedMultiplier<float> mult;
+    BOOST_CHECK_EQUAL(mult.QuantizedWeightBytes(), 0);
+    vector<float> C(m * n);
+
+    // dynamic input range, then calibrated, then with the weights already quantized
+    mult.StartCalibration();
+    mult.Multiply(m, n, k, A.data(), B.data(), C.data());
+    mult.EndCalibration();
+    float absMax = 0;
+    for (auto v : B)
+        absMax = std::max(absMax, fabs(v));
+    BOOST_CHECK_EQUAL(mult.InputRange(), absMax);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        mult.Multiply(m, n, k, A.data(), B.data(), C.data());
+        for (int i = 0; i < m; i++)
+            for (int j = 0; j < n; j++)
+                BOOST_CHECK_SMALL(C[i + j * m] - expected[i + j * m], 0.1f * (i + 1));
+    }
+    BOOST_CHECK_EQUAL(mult.QuantizedWeightBytes(), m * k + m * sizeof(float));
+
+    // inputs beyond the calibrated range are clipped
+    mult.SetInputRange(0.5f);
+    vector<float> ones(k * n, 1.0f), halves(k * n, 0.5f), clipped(m * n);
+    mult.Multiply(m, n, k, A.data(), ones.data(), C.data());
+    mult.Multiply(m, n, k, A.data(), halves.data(), clipped.data());
+    BOOST_CHECK(C == clipped);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -85,6 +85,73 @@ BOOST_AUTO_TEST_CASE(BiasGradient2)
     });
 }
 
+BOOST_AUTO_TEST_CASE(MultiThreadedElementwiseAndBroadcasting)
+{
+    Test::TensorTest<float> tensorTester;
+
+    tensorTester.OneTensorThreadingTest("elementwise addition", 1e-8, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.BroadcastingTest(TensorShape{ 512, 256 }, TensorShape{ 512, 256 }, deviceId);
+    });
+    tensorTester.OneTensorThreadingTest("bias addition (broadcasting)", 1e-8, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.BroadcastingTest(TensorShape{ 28, 28, 128, 32 }, TensorShape{ 1, 1, 128 }, deviceId);
+    });
+}
+
+BOOST_AUTO_TEST_CASE(MultiThreadedReduction)
+{
+    Test::TensorTest<float> tensorTester;
+
+    // many outputs: split along the regular dimension
+    tensorTester.OneTensorThreadingTest("bias gradient (reduction)", 1e-4, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.BiasGradientTest(TensorShape{ 2048, 1024 }, TensorShape(2048), deviceId);
+    });
+    // many outputs, but an outermost regular dimension smaller than the number of threads: split the flattened outputs
+    tensorTester.OneTensorThreadingTest("bias gradient (reduction)", 1e-4, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.BiasGradientTest(TensorShape{ 1000, 64, 2 }, TensorShape{ 1000, 1, 2 }, deviceId);
+    });
+    // few outputs: split along the reduction dimension, partial results are tree-combined
+    tensorTester.OneTensorThreadingTest("bias gradient (reduction)", 1e-2, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.BiasGradientTest(TensorShape{ 256, 256, 64, 32 }, TensorShape{ 1, 1, 64 }, deviceId);
+    });
+    tensorTester.OneTensorThreadingTest("sum to scalar", 1e-2, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.ReductionToScalarTest(TensorShape{ 1024, 1024 }, ElementWiseOperator::opSum, deviceId);
+    });
+    tensorTester.OneTensorThreadingTest("max to scalar", 0, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.ReductionToScalarTest(TensorShape{ 1024, 1024 }, ElementWiseOperator::opMax, deviceId);
+    });
+}
+
+BOOST_AUTO_TEST_CASE(FusedElementwiseOps)
+{
+    Test::TensorTest<float> tensorTester;
+
+    // fused single-pass execution on the CPU must match the op-by-op computation
+    for (let& shapes : vector<pair<TensorShape, TensorShape>>{ { TensorShape{ 512, 256 }, TensorShape(512) }, { TensorShape{ 3, 1000 }, TensorShape{ 1, 1000 } } })
+    {
+        let resultFused = tensorTester.FusedElementwiseTest(shapes.first, shapes.second, true, CPUDEVICE);
+        let resultReference = tensorTester.FusedElementwiseTest(shapes.first, shapes.second, false, CPUDEVICE);
+        BOOST_CHECK(resultFused.GetSOB().IsEqualTo(resultReference.GetSOB(), 1e-5f));
+    }
+
+    tensorTester.OneTensorThreadingTest("fused elementwise ops", 0, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.FusedElementwiseTest(TensorShape{ 512, 256 }, TensorShape(512), true, deviceId);
+    });
+
+    // the GPU executes the program step by step
+    tensorTester.OneTensorTest("fused elementwise ops", 1e-5, [&tensorTester](DEVICEID_TYPE deviceId)
+    {
+        return tensorTester.FusedElementwiseTest(TensorShape{ 512, 256 }, TensorShape(512), true, deviceId);
+    });
+}
+
 BOOST_AUTO_TEST_CASE(ColumnSliceMultAndAdd)
 {
     ColumnSliceMultAndAddTest<float>(2048, 2048, 256, 0);
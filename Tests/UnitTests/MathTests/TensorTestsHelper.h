@@ -38,6 +38,24 @@ struct TensorTest
         BOOST_CHECK(resultGPU.GetSOB().IsEqualTo(resultCPU.GetSOB(), (ElemType)tolerance));
     }
 
+    // run one test on the CPU single-threaded and with all threads and verify they are the same
+    template<typename FN>
+    void OneTensorThreadingTest(const char* what, double tolerance, const FN& fn)
+    {
+        fprintf(stderr, "===== Tensor threading test '%s'\n", what);
+
+        let maxNumThreads = CPUMatrix<ElemType>::GetMaxNumThreads();
+        CPUMatrix<ElemType>::SetNumThreads(1);
+        let resultSerial = fn(CPUDEVICE);
+        CPUMatrix<ElemType>::SetNumThreads(maxNumThreads);
+        let resultParallel = fn(CPUDEVICE);
+
+        resultSerial.GetSOB().Print("single-threaded result", 0, 7, 0, 9);
+        resultParallel.GetSOB().Print("multi-threaded result", 0, 7, 0, 9);
+
+        BOOST_CHECK(resultSerial.GetSOB().IsEqualTo(resultParallel.GetSOB(), (ElemType)tolerance));
+    }
+
     // helper to create a randomly initialized tensor object
     TensorView<ElemType> CreateTensor(TensorShape shape, int randomSeed, DEVICEID_TYPE deviceId, bool isResult = false)
     {
@@ -75,6 +93,16 @@ struct TensorTest
         return bias;
     }
 
+    // test full reduction to a scalar
+    TensorView<ElemType> ReductionToScalarTest(TensorShape layerShape, ElementWiseOperator reductionOp, DEVICEID_TYPE deviceId)
+    {
+        int randomSeed = 1;
+        let  input = CreateTensor(layerShape, randomSeed++, deviceId);
+        auto result = CreateTensor(TensorShape(1), randomSeed++, deviceId, true);
+        result.DoUnaryOpOf(0, input, 1, ElementWiseOperator::opCopy, reductionOp);
+        return result;
+    }
+
     // test broadcast summation gradient
     TensorView<ElemType> BroadcastingTest(TensorShape layerShape, TensorShape biasShape, DEVICEID_TYPE deviceId)
     {
@@ -87,6 +115,36 @@ struct TensorTest
         result.AssignSumOf(input, bias);
         return result;
     }
+
+    // test fused elementwise program (LSTM-style gate): result += Sigmoid(input + bias) .* Tanh(other)
+    // If 'fused' is false, the same is computed op by op, for reference.
+    TensorView<ElemType> FusedElementwiseTest(TensorShape layerShape, TensorShape biasShape, bool fused, DEVICEID_TYPE deviceId)
+    {
+        int randomSeed = 1;
+        let  input = CreateTensor(layerShape, randomSeed++, deviceId);
+        let  bias = CreateTensor(biasShape, randomSeed++, deviceId);
+        let  other = CreateTensor(layerShape, randomSeed++, deviceId);
+        auto result = CreateTensor(layerShape, randomSeed++, deviceId, true);
+        if (fused)
+        {
+            FusedTensorOpProgram program;
+            program.numInputs = 3;
+            let gate = program.AddStep(ElementWiseOperator::opSigmoid, program.AddStep(ElementWiseOperator::opSum, 0, 1));
+            let value = program.AddStep(ElementWiseOperator::opTanh, 2);
+            program.AddStep(ElementWiseOperator::opElementwiseProduct, gate, value);
+            result.DoFusedElementwiseOpOf(1, vector<TensorView<ElemType>>{ input, bias, other }, program, 1);
+        }
+        else
+        {
+            TensorView<ElemType> gate(make_shared<Matrix<ElemType>>(layerShape.GetNumElements(), 1, deviceId), layerShape);
+            TensorView<ElemType> value(make_shared<Matrix<ElemType>>(layerShape.GetNumElements(), 1, deviceId), layerShape);
+            gate.AssignSumOf(input, bias);
+            gate.AssignSigmoidOf(gate);
+            value.AssignTanhOf(other);
+            result.AddElementwiseProductOf(gate, value);
+        }
+        return result;
+    }
 };
 
 template <class ElemType>
@@ -0,0 +1,202 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/ComputationNetworkLib/ComputationNetwork.h"
+#include "../../../Source/ComputationNetworkLib/ComputationNetworkBuilder.h"
+#include "Globals.h"
+#include "TestHelpers.h"
+#include <cmath>
+#include <memory>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+// A chain of elementwise nodes with two broadcast parameters, followed by a reduction:
+//     Wx = W * x
+//     e = Sigmoid(Wx + b) .* Tanh(Wx - d)
+//     criterion = SumElements(e)
+// With fusion, Plus, Sigmoid, Minus and Tanh are intermediates of a chain headed by e, with the leaves Wx, b and d.
+struct ElementwiseChainNetwork
+{
+    static const size_t inputDim = 3, hiddenDim = 4, numSequences = 2, numTimeSteps = 5;
+
+    ComputationNetworkPtr m_net;
+    shared_ptr<ComputationNode<double>> m_input, m_w, m_b, m_d, m_inputProjection, m_plus, m_sigmoid, m_minus, m_tanh, m_product, m_criterion;
+
+    // 'outputs' are nodes of the chain that are tagged as outputs and whose values are requested from AllocateAllMatrices()
+    ElementwiseChainNetwork(bool fuse, const vector<wstring>& outputs = {})
+    {
+        m_net = make_shared<ComputationNetwork>(c_deviceId);
+        ComputationNetworkBuilder<double> builder(*m_net);
+        m_input = builder.CreateInputNode(L"x", inputDim);
+        m_w = builder.CreateLearnableParameter(L"W", hiddenDim, inputDim);
+        m_b = builder.CreateLearnableParameter(L"b", hiddenDim, 1);
+        m_d = builder.CreateLearnableParameter(L"d", hiddenDim, 1);
+
+        m_inputProjection = builder.Times(m_w, m_input, 1, L"Wx");
+        m_plus = builder.Plus(m_inputProjection, m_b, L"plus");
+        m_sigmoid = builder.Sigmoid(m_plus, L"sigmoid");
+        m_minus = builder.Minus(m_inputProjection, m_d, L"minus");
+        m_tanh = builder.Tanh(m_minus, L"tanh");
+        m_product = builder.ElementTimes(m_sigmoid, m_tanh, L"e");
+        m_criterion = builder.Sum(m_product, L"criterion");
+
+        m_net->AddToNodeGroup(L"feature", m_input);
+        m_net->AddToNodeGroup(L"criterion", m_criterion);
+        vector<ComputationNodeBasePtr> outputNodes;
+        for (const auto& name : outputs)
+        {
+            outputNodes.push_back(m_net->GetNodeFromName(name));
+            m_net->AddToNodeGroup(L"output", outputNodes.back());
+        }
+
+        bool wasFusing = Globals::ShouldFuseElementwiseNodes();
+        Globals::SetElementwiseNodeFusion(fuse);
+        m_net->CompileNetwork();
+        Globals::SetElementwiseNodeFusion(wasFusing);
+
+        m_net->AllocateAllMatrices({}, outputNodes, m_criterion);
+        m_net->StartEvaluateMinibatchLoop(ComputationNodeBasePtr(m_criterion));
+
+        SetSinusoidalValue(m_w->Value(), hiddenDim, inputDim, 0.5, 0.9, 0.4);
+        SetSinusoidalValue(m_b->Value(), hiddenDim, 1, 0.3, 1.1, 2.0);
+        SetSinusoidalValue(m_d->Value(), hiddenDim, 1, -0.4, 0.6, 1.2);
+    }
+
+    bool IsFused() const
+    {
+        // fused intermediates get no matrices
+        return !m_sigmoid->ValuePtr() && !m_tanh->ValuePtr();
+    }
+
+    void ForwardProp(const ComputationNodeBasePtr& root)
+    {
+        auto pMBLayout = m_net->GetMBLayoutPtrOfNetwork();
+        pMBLayout->Init(numSequences, numTimeSteps);
+        for (size_t s = 0; s < numSequences; s++)
+            pMBLayout->AddSequence(s, s, 0, numTimeSteps);
+
+        SetSinusoidalValue(m_input->Value(), inputDim, numSequences * numTimeSteps, 2.0, 0.35, 0.7);
+
+        ComputationNetwork::BumpEvalTimeStamp({ m_input, m_w, m_b, m_d });
+        m_net->ForwardProp(root);
+    }
+
+    // the value of the chain's output is copied before the backprop, which may reuse its matrix
+    void ForwardAndBackprop()
+    {
+        ScopedNetworkOperationMode modeGuard(m_net, NetworkOperationMode::training);
+        ForwardProp(m_criterion);
+        m_productValue.SetValue(m_product->Value());
+        m_net->Backprop(m_criterion);
+    }
+
+    Matrix<double> m_productValue = Matrix<double>(c_deviceId);
+};
+
+static void CheckMatricesAreClose(const Matrix<double>& a, const Matrix<double>& b, const char* what)
+{
+    BOOST_REQUIRE_EQUAL(a.GetNumRows(), b.GetNumRows());
+    BOOST_REQUIRE_EQUAL(a.GetNumCols(), b.GetNumCols());
+    for (size_t j = 0; j < a.GetNumCols(); j++)
+    {
+        for (size_t i = 0; i < a.GetNumRows(); i++)
+        {
+            BOOST_CHECK_MESSAGE(fabs(a(i, j) - b(i, j)) <= 1e-12 * max(1.0, fabs(b(i, j))),
+                                what << "(" << i << ", " << j << "): " << a(i, j) << " != " << b(i, j));
+        }
+    }
+}
+
+// compare the criterion, the chain's output, and the gradients of the chain's leaves and of all parameters
+static void CheckSameResults(const ElementwiseChainNetwork& fused, const ElementwiseChainNetwork& reference)
+{
+    CheckMatricesAreClose(fused.m_criterion->Value(), reference.m_criterion->Value(), "criterion");
+    CheckMatricesAreClose(fused.m_productValue, reference.m_productValue, "e");
+    CheckMatricesAreClose(fused.m_inputProjection->Gradient(), reference.m_inputProjection->Gradient(), "gradient of Wx");
+    CheckMatricesAreClose(fused.m_w->Gradient(), reference.m_w->Gradient(), "gradient of W");
+    CheckMatricesAreClose(fused.m_b->Gradient(), reference.m_b->Gradient(), "gradient of b");
+    CheckMatricesAreClose(fused.m_d->Gradient(), reference.m_d->Gradient(), "gradient of d");
+}
+
+BOOST_AUTO_TEST_SUITE(ElementwiseFusionTests)
+
+BOOST_AUTO_TEST_CASE(FusedChainMatchesUnfusedNetwork)
+{
+    ElementwiseChainNetwork fused(true), reference(false);
+    BOOST_CHECK(fused.IsFused());
+    BOOST_CHECK(!reference.IsFused());
+
+    // run twice, so that the second pass sees the state the first one left in the reused matrices
+    for (size_t pass = 0; pass < 2; pass++)
+    {
+        fused.ForwardAndBackprop();
+        reference.ForwardAndBackprop();
+        CheckSameResults(fused, reference);
+    }
+
+    // and the fused gradients of the parameters are the right ones
+    for (const auto& parameter : { fused.m_w, fused.m_b, fused.m_d })
+    {
+        CheckGradientByFiniteDifferences(parameter, [&fused]()
+        {
+            fused.ForwardProp(fused.m_criterion);
+            return fused.m_criterion->Value().Get00Element();
+        });
+    }
+}
+
+// an intermediate that is tagged as an output is visible outside its chain, and the network runs unfused
+BOOST_AUTO_TEST_CASE(RequestedIntermediateIsNotFused)
+{
+    ElementwiseChainNetwork network(true, { L"sigmoid" }), reference(false, { L"sigmoid" });
+    BOOST_CHECK(!network.IsFused());
+
+    network.ForwardAndBackprop();
+    reference.ForwardAndBackprop();
+    CheckSameResults(network, reference);
+    CheckMatricesAreClose(network.m_sigmoid->Value(), reference.m_sigmoid->Value(), "sigmoid");
+}
+
+// Adding a node that consumes an intermediate and recompiling after the matrices have been allocated runs the former
+// intermediates by themselves, with their own matrices.
+BOOST_AUTO_TEST_CASE(RecompileAfterAddingNodes)
+{
+    ElementwiseChainNetwork fused(true), reference(false);
+    fused.ForwardAndBackprop();
+    reference.ForwardAndBackprop();
+    CheckSameResults(fused, reference);
+
+    vector<shared_ptr<ComputationNode<double>>> tanhSums;
+    for (auto network : { &fused, &reference })
+    {
+        ComputationNetworkBuilder<double> builder(*network->m_net);
+        auto tanhSum = builder.Sum(network->m_tanh, L"tanhSum");
+        network->m_net->CompileNetwork();
+        tanhSum->CreateValueMatrixIfNull();
+        network->m_net->StartEvaluateMinibatchLoop(ComputationNodeBasePtr(tanhSum));
+        tanhSums.push_back(tanhSum);
+    }
+    BOOST_CHECK(!fused.IsFused());
+
+    fused.ForwardAndBackprop();
+    reference.ForwardAndBackprop();
+    CheckSameResults(fused, reference);
+
+    fused.ForwardProp(tanhSums[0]);
+    reference.ForwardProp(tanhSums[1]);
+    CheckMatricesAreClose(tanhSums[0]->Value(), tanhSums[1]->Value(), "tanhSum");
+    CheckMatricesAreClose(fused.m_tanh->Value(), reference.m_tanh->Value(), "tanh");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
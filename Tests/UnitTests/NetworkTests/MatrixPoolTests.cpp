@@ -0,0 +1,294 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/ComputationNetworkLib/ComputationNetwork.h"
+#include "../../../Source/ComputationNetworkLib/ComputationNetworkBuilder.h"
+#include "../../../Source/ComputationNetworkLib/ReshapingNodes.h"
+#include "Globals.h"
+#include <cmath>
+#include <memory>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+BOOST_AUTO_TEST_SUITE(MatrixPoolTests)
+
+// Three requests: 'a' (10 per column of a short layout) and 'c' (400, not minibatch-scaled) live at the same time,
+// 'b' (5 per column of a long layout) lives after both. Per-sample sizes make 'a' and 'b' share memory;
+// with the actual sizes, 'b' should share with the much larger 'c' instead.
+BOOST_AUTO_TEST_CASE(PlanForMinibatchUsesActualSizes)
+{
+    auto shortLayout = make_shared<MBLayout>(1, 1, L"short");
+    auto longLayout = make_shared<MBLayout>(1, 100, L"long");
+
+    MatrixPool pool;
+    pool.Reset();
+    shared_ptr<Matrix<float>> a, b, c;
+    pool.RequestAllocate<float>(c_deviceId, &a, 10, /*mbScale=*/true, /*isWorkSpace=*/false, shortLayout);
+    pool.RequestAllocate<float>(c_deviceId, &c, 400, /*mbScale=*/false, /*isWorkSpace=*/false);
+    pool.RequestRelease<float>(&a);
+    pool.RequestRelease<float>(&c);
+    pool.RequestAllocate<float>(c_deviceId, &b, 5, /*mbScale=*/true, /*isWorkSpace=*/false, longLayout);
+    pool.RequestRelease<float>(&b);
+    pool.OptimizedMemoryAllocation();
+    pool.SetPlanLayouts({ shortLayout, longLayout });
+
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(a != c);
+
+    size_t peakBytesBefore, peakBytesAfter;
+    BOOST_CHECK(pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    BOOST_CHECK_EQUAL(peakBytesBefore, (500 + 400) * sizeof(float));
+    BOOST_CHECK_EQUAL(peakBytesAfter, (500 + 10) * sizeof(float));
+    BOOST_CHECK(b == c);
+    BOOST_CHECK(a != c);
+
+    // same shape: nothing to do
+    BOOST_CHECK(!pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    BOOST_CHECK(b == c);
+
+    // when 'b' gets small, the best fit for it is 'a'
+    longLayout->Init(1, 1);
+    BOOST_CHECK(pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(a != c);
+    BOOST_CHECK_EQUAL(pool.GetNumMemPlans(), 2);
+
+    // going back to the first shape reuses the cached plan and its matrices
+    longLayout->Init(1, 100);
+    BOOST_CHECK(!pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    BOOST_CHECK(b == c);
+    BOOST_CHECK(a != c);
+
+    // column counts in the same bucket (97..128) share a plan
+    longLayout->Init(1, 120);
+    BOOST_CHECK(!pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    BOOST_CHECK_EQUAL(pool.GetNumMemPlans(), 2);
+}
+
+// A request that is never released (like the gradient of a LearnableParameter) keeps its matrix across plans,
+// even where the initial sharing put it together with a request whose best fit changes with the minibatch size.
+BOOST_AUTO_TEST_CASE(PlanForMinibatchKeepsNeverReleasedMatrices)
+{
+    auto layout = make_shared<MBLayout>(1, 1, L"layout");
+
+    MatrixPool pool;
+    pool.Reset();
+    shared_ptr<Matrix<float>> a, b, gradient;
+    pool.RequestAllocate<float>(c_deviceId, &a, 10, /*mbScale=*/true, /*isWorkSpace=*/false, layout);
+    pool.RequestRelease<float>(&a);
+    pool.RequestAllocate<float>(c_deviceId, &b, 20, /*mbScale=*/true, /*isWorkSpace=*/false, layout);
+    pool.RequestRelease<float>(&b);
+    pool.RequestAllocate<float>(c_deviceId, &gradient, 100, /*mbScale=*/false, /*isWorkSpace=*/false);
+    pool.OptimizedMemoryAllocation();
+    pool.SetPlanLayouts({ layout });
+
+    BOOST_CHECK(a == gradient);
+    BOOST_CHECK(b == gradient);
+    auto gradientMatrix = gradient;
+
+    size_t peakBytesBefore, peakBytesAfter;
+    for (size_t numCols : { 1, 100, 1 })
+    {
+        layout->Init(1, numCols);
+        pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter);
+        BOOST_CHECK(gradient == gradientMatrix);
+        BOOST_CHECK(a != gradient);
+        BOOST_CHECK(b != gradient);
+    }
+    BOOST_CHECK_EQUAL(pool.GetNumMemPlans(), 2);
+}
+
+// In arena mode, a float and a double buffer that are never in use at the same time get the same place in the arena.
+BOOST_AUTO_TEST_CASE(PlanForMinibatchPlacesBuffersInArena)
+{
+    auto layout = make_shared<MBLayout>(1, 10, L"layout");
+
+    MatrixPool pool;
+    pool.Reset();
+    pool.SetMemoryArenaMode(/*enable=*/true, /*useHugePages=*/false);
+    shared_ptr<Matrix<float>> a;
+    shared_ptr<Matrix<double>> d;
+    pool.RequestAllocate<float>(c_deviceId, &a, 10, /*mbScale=*/true, /*isWorkSpace=*/false, layout);
+    pool.RequestRelease<float>(&a);
+    pool.RequestAllocate<double>(c_deviceId, &d, 10, /*mbScale=*/true, /*isWorkSpace=*/false, layout);
+    pool.RequestRelease<double>(&d);
+    pool.OptimizedMemoryAllocation();
+    pool.SetPlanLayouts({ layout });
+
+    size_t peakBytesBefore, peakBytesAfter;
+    BOOST_CHECK(pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    auto arena = pool.GetMemArena();
+    BOOST_REQUIRE(arena != nullptr);
+    BOOST_CHECK_GE(arena->Size(), 10 * 10 * sizeof(double));
+    BOOST_CHECK_LT(arena->Size(), 10 * 10 * (sizeof(float) + sizeof(double)));
+
+    a->Resize(10, 10);
+    d->Resize(10, 10);
+    BOOST_CHECK_EQUAL((void*) a->Data(), (void*) arena->Data());
+    BOOST_CHECK_EQUAL((void*) d->Data(), (void*) arena->Data());
+
+    // larger than planned: falls back to the heap
+    d->Resize(10, 100);
+    BOOST_CHECK_NE((void*) d->Data(), (void*) arena->Data());
+
+    // switching arena mode off moves the matrices back to the heap
+    pool.SetMemoryArenaMode(/*enable=*/false, /*useHugePages=*/false);
+    BOOST_CHECK(pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    BOOST_CHECK(pool.GetMemArena() == nullptr);
+    a->Resize(10, 10);
+    BOOST_CHECK_NE((void*) a->Data(), (void*) arena->Data());
+}
+
+// A buffer that gets the same arena region in two plans keeps its memory when switching between them.
+BOOST_AUTO_TEST_CASE(PlanForMinibatchKeepsArenaRegionsAcrossPlans)
+{
+    auto layout = make_shared<MBLayout>(1, 1, L"layout");
+
+    MatrixPool pool;
+    pool.Reset();
+    pool.SetMemoryArenaMode(/*enable=*/true, /*useHugePages=*/false);
+    shared_ptr<Matrix<float>> a, c;
+    pool.RequestAllocate<float>(c_deviceId, &c, 10000, /*mbScale=*/false, /*isWorkSpace=*/false);
+    pool.RequestAllocate<float>(c_deviceId, &a, 10, /*mbScale=*/true, /*isWorkSpace=*/false, layout);
+    pool.RequestRelease<float>(&a);
+    pool.RequestRelease<float>(&c);
+    pool.OptimizedMemoryAllocation();
+    pool.SetPlanLayouts({ layout });
+
+    size_t peakBytesBefore, peakBytesAfter;
+    layout->Init(1, 10);
+    BOOST_CHECK(pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    c->Resize(100, 100);
+    c->SetValue(3.0f);
+    const float* data = c->Data();
+
+    layout->Init(1, 1);
+    BOOST_CHECK(pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+    BOOST_CHECK_EQUAL(pool.GetNumMemPlans(), 2);
+    BOOST_CHECK_EQUAL(c->Data(), data);
+    BOOST_CHECK_EQUAL(c->GetNumElements(), 10000);
+    BOOST_CHECK_EQUAL(c->Get00Element(), 3.0f);
+}
+
+// A request on a layout that a node derives from the input during its forward pass (here: one column per two input columns)
+// is planned with the size of the input layout. The plan only depends on the input layout: a forward pass that changes the
+// size of the derived layout does not make the next call select another plan within the same minibatch.
+BOOST_AUTO_TEST_CASE(PlanForMinibatchWithDerivedLayout)
+{
+    auto inputLayout = make_shared<MBLayout>(1, 1, L"input");
+    auto derivedLayout = make_shared<MBLayout>(1, 1, L"derived");
+
+    MatrixPool pool;
+    pool.Reset();
+    shared_ptr<Matrix<float>> a, b;
+    pool.RequestAllocate<float>(c_deviceId, &a, 10, /*mbScale=*/true, /*isWorkSpace=*/false, inputLayout);
+    pool.RequestAllocate<float>(c_deviceId, &b, 4, /*mbScale=*/true, /*isWorkSpace=*/false, derivedLayout);
+    pool.RequestRelease<float>(&a);
+    pool.RequestRelease<float>(&b);
+    pool.OptimizedMemoryAllocation();
+    pool.SetPlanLayouts({ inputLayout });
+
+    // sequence length of consecutive minibatches, and whether a new plan is expected (the buckets are 12 and 48)
+    size_t peakBytesBefore, peakBytesAfter;
+    const vector<pair<size_t, bool>> minibatches = { { 10, true }, { 40, true }, { 40, false }, { 10, false }, { 12, false } };
+    for (const auto& minibatch : minibatches)
+    {
+        const size_t T = minibatch.first;
+        inputLayout->Init(1, T);
+        BOOST_CHECK_EQUAL(pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter), minibatch.second);
+        if (minibatch.second)
+            BOOST_CHECK_EQUAL(peakBytesAfter, (10 * T + 4 * T) * sizeof(float));
+        auto planned = make_pair(a, b);
+
+        // forward pass, then planning again within the same minibatch: nothing changes
+        derivedLayout->Init(1, T / 2);
+        a->Resize(10, T);
+        b->Resize(4, T / 2);
+        BOOST_CHECK(!pool.PlanForMinibatch(peakBytesBefore, peakBytesAfter));
+        BOOST_CHECK(a == planned.first);
+        BOOST_CHECK(b == planned.second);
+    }
+    BOOST_CHECK_EQUAL(pool.GetNumMemPlans(), 2);
+}
+
+// Two forward passes in one minibatch, the evaluation node and then the criterion, through nodes on the layout of a Where():
+//     t = Tanh(Gather(cond, x))
+//     eval = SumElements(t)
+//     criterion = SumElements(t .* t)
+// The second pass reuses t from the first one, so its matrix must not be re-pointed between the passes.
+BOOST_AUTO_TEST_CASE(PlanForMinibatchWithTwoForwardPassesThroughDerivedLayout)
+{
+    const size_t inputDim = 3, numSequences = 2;
+
+    bool wasPlanning = Globals::ShouldPlanMemoryPerMinibatch();
+    Globals::SetMinibatchAwareMemoryPlanning(true);
+
+    auto net = make_shared<ComputationNetwork>(c_deviceId);
+    ComputationNetworkBuilder<double> builder(*net);
+    auto x = builder.CreateInputNode(L"x", inputDim);
+    auto cond = builder.CreateInputNode(L"cond", 1);
+    auto where = net->AddNodeToNetAndAttachInputs(New<WhereNode<double>>(c_deviceId, L"where"), { cond });
+    auto index = net->AddNodeToNetAndAttachInputs(New<PackedIndexNode<double>>(c_deviceId, L"index"), { x, where });
+    auto gather = net->AddNodeToNetAndAttachInputs(New<GatherPackedNode<double>>(c_deviceId, L"gather"), { index, x });
+    auto t = builder.Tanh(gather, L"t");
+    auto eval = builder.Sum(t, L"eval");
+    auto criterion = builder.Sum(builder.ElementTimes(t, t, L"tt"), L"criterion");
+    net->AddToNodeGroup(L"feature", x);
+    net->AddToNodeGroup(L"feature", cond);
+    net->AddToNodeGroup(L"evaluation", eval);
+    net->AddToNodeGroup(L"criterion", criterion);
+    net->CompileNetwork();
+    net->AllocateAllMatrices({ eval }, {}, criterion);
+    net->StartEvaluateMinibatchLoop(vector<ComputationNodeBasePtr>{ eval, criterion });
+
+    for (size_t numTimeSteps : { 6, 20, 6, 40 })
+    {
+        auto pMBLayout = net->GetMBLayoutPtrOfNetwork();
+        pMBLayout->Init(numSequences, numTimeSteps);
+        for (size_t s = 0; s < numSequences; s++)
+            pMBLayout->AddSequence(s, s, 0, numTimeSteps);
+
+        // every third column is dropped by the Where()
+        const size_t numCols = numSequences * numTimeSteps;
+        vector<double> xData(inputDim * numCols), condData(numCols);
+        double expectedEval = 0, expectedCriterion = 0;
+        for (size_t j = 0; j < numCols; j++)
+        {
+            condData[j] = j % 3 != 0 ? 1 : 0;
+            for (size_t i = 0; i < inputDim; i++)
+            {
+                xData[j * inputDim + i] = sin(0.3 * (j * inputDim + i) + numTimeSteps);
+                if (condData[j])
+                {
+                    expectedEval += tanh(xData[j * inputDim + i]);
+                    expectedCriterion += tanh(xData[j * inputDim + i]) * tanh(xData[j * inputDim + i]);
+                }
+            }
+        }
+        x->Value().SetValue(inputDim, numCols, c_deviceId, xData.data());
+        cond->Value().SetValue(1, numCols, c_deviceId, condData.data());
+        ComputationNetwork::BumpEvalTimeStamp({ x, cond });
+
+        net->PlanMemoryForMinibatch();
+        net->ForwardProp(ComputationNodeBasePtr(eval));
+        net->ForwardProp(ComputationNodeBasePtr(criterion));
+
+        BOOST_CHECK_CLOSE(eval->Value().Get00Element(), expectedEval, 1e-8);
+        BOOST_CHECK_CLOSE(criterion->Value().Get00Element(), expectedCriterion, 1e-8);
+    }
+
+    Globals::SetMinibatchAwareMemoryPlanning(wasPlanning);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
@@ -0,0 +1,153 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/ComputationNetworkLib/ComputationNetwork.h"
+#include "../../../Source/ComputationNetworkLib/ComputationNetworkBuilder.h"
+#include "PerformanceProfiler.h"
+#include "TestHelpers.h"
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+// Returns the lines of the only file in dir whose name ends with suffix, and its path.
+static vector<string> ReadProfilerFile(const boost::filesystem::path& dir, const string& suffix, boost::filesystem::path& path)
+{
+    vector<boost::filesystem::path> found;
+    for (boost::filesystem::directory_iterator it(dir), end; it != end; ++it)
+    {
+        string name = it->path().filename().string();
+        if (name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            found.push_back(it->path());
+    }
+    BOOST_REQUIRE_EQUAL(found.size(), 1);
+    path = found.front();
+
+    vector<string> lines;
+    ifstream file(path.string());
+    for (string line; getline(file, line);)
+        lines.push_back(line);
+    return lines;
+}
+
+BOOST_AUTO_TEST_SUITE(NodeProfilerTests)
+
+// Profiles the forward and backward passes of
+//     h = Tanh(W * x)
+//     criterion = SumElements(h)
+// and checks the rows of the node report and the Chrome trace.
+BOOST_AUTO_TEST_CASE(NodeReportAndTrace)
+{
+    const size_t inputDim = 3, hiddenDim = 4, numSequences = 2, numTimeSteps = 5, numMinibatches = 3;
+
+    auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("NodeProfilerTests-%%%%-%%%%");
+    ProfilerInit(dir.wstring(), 1024 * 1024, L"test", false);
+    ProfilerEnable(true);
+    ProfilerEnableNodeTracing(true);
+    BOOST_REQUIRE(ProfilerNodeTracingActive());
+
+    {
+        auto net = make_shared<ComputationNetwork>(c_deviceId);
+        ComputationNetworkBuilder<double> builder(*net);
+        auto x = builder.CreateInputNode(L"x", inputDim);
+        auto w = builder.CreateLearnableParameter(L"W", hiddenDim, inputDim);
+        auto h = builder.Tanh(builder.Times(w, x, 1, L"Wx"), L"h");
+        auto criterion = builder.Sum(h, L"criterion");
+        net->AddToNodeGroup(L"feature", x);
+        net->AddToNodeGroup(L"criterion", criterion);
+        net->CompileNetwork();
+        net->AllocateAllMatrices({}, {}, criterion);
+        net->StartEvaluateMinibatchLoop(ComputationNodeBasePtr(criterion));
+        SetSinusoidalValue(w->Value(), hiddenDim, inputDim, 0.5, 0.9, 0.4);
+
+        ScopedNetworkOperationMode modeGuard(net, NetworkOperationMode::training);
+        for (size_t i = 0; i < numMinibatches; i++)
+        {
+            auto pMBLayout = net->GetMBLayoutPtrOfNetwork();
+            pMBLayout->Init(numSequences, numTimeSteps);
+            for (size_t s = 0; s < numSequences; s++)
+                pMBLayout->AddSequence(s, s, 0, numTimeSteps);
+            SetSinusoidalValue(x->Value(), inputDim, numSequences * numTimeSteps, 2.0, 0.35, 0.7 + i);
+            ComputationNetwork::BumpEvalTimeStamp({ x, w });
+
+            net->ForwardProp(ComputationNodeBasePtr(criterion));
+            net->Backprop(ComputationNodeBasePtr(criterion));
+        }
+    }
+    ProfilerClose();
+
+    // one row per node and pass, with the count of the events and the operation
+    boost::filesystem::path reportPath;
+    auto report = ReadProfilerFile(dir, "_nodes_test.txt", reportPath);
+    map<string, size_t> counts; // "<pass> <node> (<operation>)" -> count
+    for (const auto& line : report)
+    {
+        // the columns of the times contain a unit, so the row is read from its end:
+        // ... count share GFLOP/s bytes node (operation)
+        istringstream row(line);
+        vector<string> columns{ istream_iterator<string>(row), istream_iterator<string>() };
+        if (columns.size() < 7 || (columns[0] != "Forward" && columns[0] != "Backward"))
+            continue;
+
+        size_t n = columns.size();
+        BOOST_CHECK(stoll(columns[n - 3]) > 0);
+        counts[columns[0] + " " + columns[n - 2] + " " + columns[n - 1]] = stoul(columns[n - 6]);
+    }
+    const map<string, size_t> expectedCounts = {
+        { "Forward Wx (Times)", numMinibatches },
+        { "Forward h (Tanh)", numMinibatches },
+        { "Forward criterion (SumElements)", numMinibatches },
+        { "Backward Wx (Times)", numMinibatches },
+        { "Backward h (Tanh)", numMinibatches },
+        { "Backward criterion (SumElements)", numMinibatches },
+    };
+    for (const auto& expected : expectedCounts)
+    {
+        BOOST_CHECK_MESSAGE(counts.find(expected.first) != counts.end(), "no row for " << expected.first);
+        if (counts.find(expected.first) != counts.end())
+            BOOST_CHECK_EQUAL(counts[expected.first], expected.second);
+    }
+
+    // the trace is valid JSON, with one complete event per node and pass
+    boost::filesystem::path tracePath;
+    ReadProfilerFile(dir, "_trace_test.json", tracePath);
+    boost::property_tree::ptree trace;
+    BOOST_REQUIRE_NO_THROW(boost::property_tree::read_json(tracePath.string(), trace));
+    map<string, size_t> eventCounts; // "<category> <node>" -> count
+    for (const auto& event : trace.get_child("traceEvents"))
+    {
+        BOOST_CHECK_EQUAL(event.second.get<string>("ph"), "X");
+        BOOST_CHECK(event.second.get<double>("dur") >= 0);
+        string category = event.second.get<string>("cat");
+        if (category == "forward" || category == "backward")
+        {
+            BOOST_CHECK(!event.second.get<string>("args.operation").empty());
+            eventCounts[category + " " + event.second.get<string>("name")]++;
+        }
+    }
+    for (string node : { "Wx", "h", "criterion" })
+    {
+        BOOST_CHECK_EQUAL(eventCounts["forward " + node], numMinibatches);
+        BOOST_CHECK_EQUAL(eventCounts["backward " + node], numMinibatches);
+    }
+
+    boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
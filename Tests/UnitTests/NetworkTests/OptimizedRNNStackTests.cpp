@@ -0,0 +1,229 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/ComputationNetworkLib/ComputationNetwork.h"
+#include "../../../Source/ComputationNetworkLib/ComputationNetworkBuilder.h"
+#include "../../../Source/ComputationNetworkLib/RNNNodes.h"
+#include "TestHelpers.h"
+#include <memory>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+// An OptimizedRNNStack over a learnable projection of the input, on sequences of different lengths:
+//     rnn = OptimizedRNNStack(W, P * x)
+//     criterion = SumElements(rnn .* C)
+// Optionally with the same LSTM unrolled from elementary nodes, as BrainScript's LSTMP does it, on a copy of the projection:
+//     h = o .* Tanh(cell), cell = f .* PastValue(cell) + i .* Tanh(...), ...
+//     criterion = SumElements(rnn .* C) + SumElements(h .* C)
+struct RNNStackTestNetwork
+{
+    static const size_t inputDim = 4, hiddenDim = 3, numParallelSequences = 3, numTimeSteps = 5;
+
+    ComputationNetworkPtr m_net;
+    RnnAttributes m_attributes;
+    shared_ptr<ComputationNode<double>> m_input, m_projection, m_weights, m_rnn;
+    shared_ptr<ComputationNode<double>> m_unrolledProjection, m_unrolledOutput;
+    // input weights, recurrent weights, input biases and recurrent biases of the input, forget, cell and output gates
+    shared_ptr<ComputationNode<double>> m_unrolledWeights[4][4];
+    vector<ComputationNodeBasePtr> m_parameters;
+    ComputationNodeBasePtr m_criterion;
+    vector<size_t> m_sequenceLengths;
+    double m_inputPhase;
+
+    // 'inputPhase' selects the input data (see ForwardProp())
+    RNNStackTestNetwork(const wstring& recurrentOp, size_t numLayers, bool bidirectional, bool withUnrolledLSTM = false, double inputPhase = 1.6)
+        : m_attributes(bidirectional, numLayers, hiddenDim, recurrentOp, -1), m_sequenceLengths({ 5, 3, 4 }), m_inputPhase(inputPhase)
+    {
+        m_net = make_shared<ComputationNetwork>(c_deviceId);
+        ComputationNetworkBuilder<double> builder(*m_net);
+        const size_t outputDim = (bidirectional ? 2 : 1) * hiddenDim;
+        let numParameters = m_attributes.GetNumParameters(inputDim);
+
+        m_input = builder.CreateInputNode(L"x", inputDim);
+        m_projection = builder.CreateLearnableParameter(L"P", inputDim, inputDim);
+        m_weights = builder.CreateLearnableParameter(L"W", numParameters.first, numParameters.second);
+        auto scale = builder.CreateLearnableParameter(L"C", outputDim, 1);
+        scale->SetLearningRateMultiplier(0);
+        m_rnn = m_net->AddNodeToNetAndAttachInputs(New<OptimizedRNNStackNode<double>>(c_deviceId, L"rnn", bidirectional, numLayers, hiddenDim, recurrentOp),
+                                                   { m_weights, builder.Times(m_projection, m_input, 1, L"Px") });
+        auto rnnCriterion = builder.Sum(builder.ElementTimes(m_rnn, scale, L"rnnC"), L"rnnCriterion");
+        m_criterion = rnnCriterion;
+        m_parameters = { m_input, m_projection, m_weights, scale };
+
+        if (withUnrolledLSTM)
+        {
+            m_unrolledProjection = builder.CreateLearnableParameter(L"P2", inputDim, inputDim);
+            auto x = builder.Times(m_unrolledProjection, m_input, 1, L"P2x");
+            auto hiddenDelay = builder.PastValue(nullptr, 0.0f, hiddenDim, 1, L"hiddenDelay");
+            auto cellDelay = builder.PastValue(nullptr, 0.0f, hiddenDim, 1, L"cellDelay");
+            m_parameters.push_back(m_unrolledProjection);
+
+            shared_ptr<ComputationNode<double>> gates[4];
+            for (size_t g = 0; g < 4; g++)
+            {
+                auto& w = m_unrolledWeights[g];
+                w[0] = builder.CreateLearnableParameter(msra::strfun::wstrprintf(L"W%d", (int)g), hiddenDim, inputDim);
+                w[1] = builder.CreateLearnableParameter(msra::strfun::wstrprintf(L"R%d", (int)g), hiddenDim, hiddenDim);
+                w[2] = builder.CreateLearnableParameter(msra::strfun::wstrprintf(L"bW%d", (int)g), hiddenDim, 1);
+                w[3] = builder.CreateLearnableParameter(msra::strfun::wstrprintf(L"bR%d", (int)g), hiddenDim, 1);
+                m_parameters.insert(m_parameters.end(), { w[0], w[1], w[2], w[3] });
+                auto z = builder.Plus(builder.Plus(builder.Times(w[0], x), w[2]), builder.Plus(builder.Times(w[1], hiddenDelay), w[3]));
+                gates[g] = g == 2 ? builder.Tanh(z) : builder.Sigmoid(z);
+            }
+            auto cell = builder.Plus(builder.ElementTimes(gates[1], cellDelay), builder.ElementTimes(gates[0], gates[2]), L"cell");
+            m_unrolledOutput = builder.ElementTimes(gates[3], builder.Tanh(cell), L"h");
+            hiddenDelay->AttachInputs({ m_unrolledOutput });
+            cellDelay->AttachInputs({ cell });
+
+            auto unrolledCriterion = builder.Sum(builder.ElementTimes(m_unrolledOutput, scale, L"hC"), L"unrolledCriterion");
+            m_criterion = builder.Plus(rnnCriterion, unrolledCriterion, L"criterion");
+        }
+
+        m_net->AddToNodeGroup(L"feature", m_input);
+        m_net->AddToNodeGroup(L"criterion", m_criterion);
+        m_net->CompileNetwork();
+        m_net->AllocateAllMatrices({}, {}, m_criterion);
+        m_net->StartEvaluateMinibatchLoop(m_criterion);
+
+        Init(m_projection, 0.6, 0.9);
+        Init(m_weights, 0.5, 0.37);
+        Init(scale, 1.0, 0.7);
+        if (withUnrolledLSTM)
+        {
+            Init(m_unrolledProjection, 0.6, 0.9);
+            ForEachUnrolledWeight([](double& unrolled, double& packed) { unrolled = packed; });
+        }
+    }
+
+    static void Init(const shared_ptr<ComputationNode<double>>& parameter, double scale, double frequency)
+    {
+        auto& value = parameter->Value();
+        SetSinusoidalValue(value, value.GetNumRows(), value.GetNumCols(), scale, frequency, 1.0);
+    }
+
+    // Calls f(unrolled, packed) for each pair of corresponding unrolled and packed LSTM parameters. The packed
+    // parameters hold the four [hidden x input] input matrices row-major, then the four recurrent matrices,
+    // then the four input biases and the four recurrent biases.
+    template <class F>
+    void ForEachUnrolledWeight(F f, bool gradients = false)
+    {
+        auto Get = [gradients](const shared_ptr<ComputationNode<double>>& node) -> Matrix<double>& { return gradients ? node->Gradient() : node->Value(); };
+        double* packed = Get(m_weights).Data();
+        const size_t inputWeights = 0, recurrentWeights = 4 * hiddenDim * inputDim;
+        const size_t inputBiases = recurrentWeights + 4 * hiddenDim * hiddenDim, recurrentBiases = inputBiases + 4 * hiddenDim;
+        for (size_t g = 0; g < 4; g++)
+        {
+            auto& w = m_unrolledWeights[g];
+            for (size_t h = 0; h < hiddenDim; h++)
+            {
+                for (size_t i = 0; i < inputDim; i++)
+                    f(Get(w[0]).Data()[h + i * hiddenDim], packed[inputWeights + (g * hiddenDim + h) * inputDim + i]);
+                for (size_t i = 0; i < hiddenDim; i++)
+                    f(Get(w[1]).Data()[h + i * hiddenDim], packed[recurrentWeights + (g * hiddenDim + h) * hiddenDim + i]);
+                f(Get(w[2]).Data()[h], packed[inputBiases + g * hiddenDim + h]);
+                f(Get(w[3]).Data()[h], packed[recurrentBiases + g * hiddenDim + h]);
+            }
+        }
+    }
+
+    double ForwardProp()
+    {
+        auto pMBLayout = m_net->GetMBLayoutPtrOfNetwork();
+        pMBLayout->Init(numParallelSequences, numTimeSteps);
+        for (size_t s = 0; s < numParallelSequences; s++)
+        {
+            pMBLayout->AddSequence(s, s, 0, m_sequenceLengths[s]);
+            pMBLayout->AddGap(s, m_sequenceLengths[s], numTimeSteps);
+        }
+
+        SetSinusoidalValue(m_input->Value(), inputDim, numParallelSequences * numTimeSteps, 1.0, 0.3, m_inputPhase);
+
+        ComputationNetwork::BumpEvalTimeStamp(m_parameters);
+        m_net->ForwardProp(m_criterion);
+        return m_criterion->As<ComputationNode<double>>()->Value().Get00Element();
+    }
+
+    // checks the gradients of the packed weights and of the input projection against central differences
+    // The gradients are recomputed for each parameter, since the forward passes of the check of one may
+    // overwrite the gradient of the other, when its matrix is shared with the value of a node.
+    void CheckGradientsByFiniteDifferences()
+    {
+        for (const auto& parameter : { m_weights, m_projection })
+        {
+            ForwardProp();
+            m_net->Backprop(m_criterion);
+            CheckGradientByFiniteDifferences(parameter, [this]() { return ForwardProp(); });
+        }
+    }
+};
+
+BOOST_AUTO_TEST_SUITE(OptimizedRNNStackTests)
+
+// The CPU implementation of OptimizedRNNStack with an LSTM cell computes the same output and the same gradients
+// as the LSTM unrolled from elementary nodes.
+BOOST_AUTO_TEST_CASE(LSTMMatchesUnrolledLSTM)
+{
+    RNNStackTestNetwork network(L"lstm", 1, false, /*withUnrolledLSTM=*/true);
+    ScopedNetworkOperationMode modeGuard(network.m_net, NetworkOperationMode::training);
+
+    network.ForwardProp();
+    network.m_net->Backprop(network.m_criterion);
+
+    const auto& output = network.m_rnn->Value();
+    const auto& unrolledOutput = network.m_unrolledOutput->Value();
+    for (size_t s = 0; s < RNNStackTestNetwork::numParallelSequences; s++)
+    {
+        for (size_t t = 0; t < network.m_sequenceLengths[s]; t++)
+        {
+            size_t j = t * RNNStackTestNetwork::numParallelSequences + s;
+            for (size_t i = 0; i < RNNStackTestNetwork::hiddenDim; i++)
+                BOOST_CHECK_SMALL(output(i, j) - unrolledOutput(i, j), 1e-12);
+        }
+    }
+
+    network.ForEachUnrolledWeight([](double& unrolled, double& packed) { BOOST_CHECK_SMALL(unrolled - packed, 1e-12); }, /*gradients=*/true);
+
+    // the gradient into the input of the stack
+    const auto& projectionGradient = network.m_projection->Gradient();
+    const auto& unrolledProjectionGradient = network.m_unrolledProjection->Gradient();
+    for (size_t i = 0; i < projectionGradient.GetNumElements(); i++)
+        BOOST_CHECK_SMALL(projectionGradient.Data()[i] - unrolledProjectionGradient.Data()[i], 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(GradientsMatchFiniteDifferences)
+{
+    struct
+    {
+        const wchar_t* recurrentOp;
+        size_t numLayers;
+        bool bidirectional;
+        double inputPhase;
+    } configurations[] = {
+        { L"lstm", 2, true, 1.6 },
+        { L"gru", 1, false, 0.3 },
+        { L"gru", 2, true, 2.2 },
+        { L"rnnTanh", 2, false, 4.0 },
+        { L"rnnReLU", 1, true, 0.9 },
+    };
+
+    for (const auto& configuration : configurations)
+    {
+        BOOST_TEST_MESSAGE("Testing " << msra::strfun::utf8(configuration.recurrentOp) << ", " << configuration.numLayers << " layers, bidirectional " << configuration.bidirectional);
+        RNNStackTestNetwork network(configuration.recurrentOp, configuration.numLayers, configuration.bidirectional, /*withUnrolledLSTM=*/false, configuration.inputPhase);
+        ScopedNetworkOperationMode modeGuard(network.m_net, NetworkOperationMode::training);
+        network.CheckGradientsByFiniteDifferences();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
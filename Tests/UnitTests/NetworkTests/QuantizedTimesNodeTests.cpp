@@ -0,0 +1,256 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/ComputationNetworkLib/ComputationNetwork.h"
+#include "../../../Source/ComputationNetworkLib/ComputationNetworkBuilder.h"
+#include "../../../Source/ComputationNetworkLib/LinearAlgebraNodes.h"
+#include "../../../Source/ComputationNetworkLib/InputAndParamNodes.h"
+#include "TestHelpers.h"
+#include <chrono>
+#include <memory>
+#include <random>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+// Quantized operations run on CPU only.
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+// Extends a node to provide access to protected members.
+template <class NodeType>
+class ForwardPropNodeTest : public NodeType
+{
+public:
+    template <class... Args>
+    ForwardPropNodeTest(const wstring& name, Args&&... args) : NodeType(c_deviceId, name, forward<Args>(args)...) {}
+
+    using NodeType::Validate;
+
+    void ForwardPass()
+    {
+        this->CreateValueMatrixIfNull();
+        FrameRange fr(this->GetMBLayout());
+        this->BeginForwardProp();
+        this->ForwardProp(fr);
+        this->EndForwardProp();
+    }
+};
+
+// W * x for a weight matrix W[outputDim, inputDim] and a minibatch of inputs x, with the float, the quantized and the
+// int8 quantized product
+struct TimesNodeTestNetwork
+{
+    shared_ptr<LearnableParameter<float>> m_weights;
+    shared_ptr<DummyNodeTest<float>> m_input;
+    shared_ptr<ForwardPropNodeTest<TimesNode<float>>> m_times;
+    shared_ptr<ForwardPropNodeTest<QuantizedTimesNode<float>>> m_quantizedTimes;
+    shared_ptr<ForwardPropNodeTest<QuantizedTimesNode<float>>> m_int8Times;
+
+    TimesNodeTestNetwork(size_t outputDim, size_t inputDim, size_t minibatchSize)
+    {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> values(-1, 1);
+        vector<float> weights(outputDim * inputDim), input(inputDim * minibatchSize);
+        for (auto& v : weights)
+            v = values(rng);
+        for (auto& v : input)
+            v = values(rng);
+
+        m_weights = make_shared<LearnableParameter<float>>(c_deviceId, L"W", outputDim, inputDim);
+        m_weights->Value().SetValue(outputDim, inputDim, c_deviceId, weights.data());
+        m_input = make_shared<DummyNodeTest<float>>(c_deviceId, minibatchSize, SmallVector<size_t>{ inputDim }, input);
+
+        m_times = make_shared<ForwardPropNodeTest<TimesNode<float>>>(L"Times");
+        m_times->AttachInputs({ m_weights, m_input });
+        m_times->Validate(true);
+
+        // The int16 products are summed in 32 bits; a bit shift of 3 for each operand leaves enough headroom for
+        // the dot products of these random inputs, a shift of 1 does not.
+        m_quantizedTimes = make_shared<ForwardPropNodeTest<QuantizedTimesNode<float>>>(L"QuantizedTimes", 3 /*bitShiftA*/, 3 /*bitShiftB*/);
+        m_quantizedTimes->AttachInputs({ m_weights, m_input });
+        m_quantizedTimes->Validate(true);
+
+        m_int8Times = make_shared<ForwardPropNodeTest<QuantizedTimesNode<float>>>(L"Int8Times", 1, 1, 1, TimesNode<float>::NoInferredInputRank, true /*int8*/);
+        m_int8Times->AttachInputs({ m_weights, m_input });
+        m_int8Times->Validate(true);
+    }
+};
+
+BOOST_AUTO_TEST_SUITE(QuantizedTimesNodeTests)
+
+BOOST_AUTO_TEST_CASE(QuantizedTimesNodeMatchesTimesNode)
+{
+    // an input dimension that is not a multiple of the kernel block sizes, and a minibatch that is not a multiple of 4
+    const size_t outputDim = 37, inputDim = 131, minibatchSize = 7;
+    TimesNodeTestNetwork network(outputDim, inputDim, minibatchSize);
+
+    network.m_times->ForwardPass();
+    // twice, the second time with the prepared weights
+    for (int pass = 0; pass < 2; pass++)
+    {
+        network.m_quantizedTimes->ForwardPass();
+        BOOST_REQUIRE_EQUAL(network.m_quantizedTimes->Value().GetNumElements(), outputDim * minibatchSize);
+        BOOST_REQUIRE_MESSAGE(AreEqual(network.m_times->Value().Data(), network.m_quantizedTimes->Value().Data(), outputDim * minibatchSize, 0.02f),
+                              "QuantizedTimes output differs from Times output by more than the quantization error");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Int8QuantizedTimesNodeMatchesTimesNode)
+{
+    const size_t outputDim = 37, inputDim = 131, minibatchSize = 7;
+    TimesNodeTestNetwork network(outputDim, inputDim, minibatchSize);
+    network.m_times->ForwardPass();
+
+    // calibrate on the same minibatch, so that the range is the input's largest absolute value
+    network.m_int8Times->StartCalibration();
+    network.m_int8Times->ForwardPass();
+    network.m_int8Times->EndCalibration();
+    BOOST_CHECK_GT(network.m_int8Times->InputRange(), 0.0f);
+    BOOST_CHECK_LE(network.m_int8Times->InputRange(), 1.0f);
+
+    network.m_int8Times->ForwardPass();
+    BOOST_REQUIRE_MESSAGE(AreEqual(network.m_times->Value().Data(), network.m_int8Times->Value().Data(), outputDim * minibatchSize, 0.1f),
+                          "int8 QuantizedTimes output differs from Times output by more than the quantization error");
+    BOOST_CHECK_EQUAL(network.m_int8Times->QuantizedWeightBytes(), outputDim * inputDim + outputDim * sizeof(float));
+
+    // int8 mode needs constant weights
+    auto notWeights = make_shared<ForwardPropNodeTest<QuantizedTimesNode<float>>>(L"Int8Times2", 1, 1, 1, TimesNode<float>::NoInferredInputRank, true /*int8*/);
+    notWeights->AttachInputs({ network.m_times, network.m_input });
+    BOOST_CHECK_THROW(notWeights->Validate(true), std::invalid_argument);
+}
+
+// Once the weights are quantized, the product does not read the float weights any more, also in a copy of the node.
+BOOST_AUTO_TEST_CASE(Int8QuantizedTimesNodeWithReleasedFloatWeights)
+{
+    const size_t outputDim = 37, inputDim = 131, minibatchSize = 7;
+    TimesNodeTestNetwork network(outputDim, inputDim, minibatchSize);
+    network.m_int8Times->ForwardPass();
+    vector<float> expected(network.m_int8Times->Value().Data(), network.m_int8Times->Value().Data() + outputDim * minibatchSize);
+
+    network.m_int8Times->QuantizeWeights();
+    BOOST_CHECK(network.m_int8Times->UsesQuantizedWeightsOnly());
+    network.m_weights->Value().Resize(0, 0, 0, false /*growOnly*/);
+
+    auto copy = make_shared<ForwardPropNodeTest<QuantizedTimesNode<float>>>(L"Int8TimesCopy");
+    network.m_int8Times->CopyTo(copy, L"Int8TimesCopy", CopyNodeFlags::copyNodeValue);
+    copy->AttachInputs({ network.m_weights, network.m_input });
+    copy->Validate(true);
+
+    for (const auto& node : { network.m_int8Times, copy })
+    {
+        node->ForwardPass();
+        BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), node->Value().Data(), node->Value().Data() + outputDim * minibatchSize);
+    }
+    BOOST_CHECK_EQUAL(copy->QuantizedWeightBytes(), network.m_int8Times->QuantizedWeightBytes());
+
+    const wstring fileName = L"Int8QuantizedTimesNodeWithReleasedFloatWeights.bin";
+    {
+        File file(fileName, fileOptionsBinary | fileOptionsWrite);
+        BOOST_CHECK_THROW(network.m_int8Times->Save(file), std::logic_error);
+    }
+    _wunlink(fileName.c_str());
+}
+
+// Only the weights that no other node reads are released.
+BOOST_AUTO_TEST_CASE(ReleaseInt8FloatWeights)
+{
+    const size_t outputDim = 4, inputDim = 3;
+    auto net = make_shared<ComputationNetwork>(c_deviceId);
+    ComputationNetworkBuilder<float> builder(*net);
+    auto x = builder.CreateInputNode(L"x", inputDim);
+    auto w1 = builder.CreateLearnableParameter(L"W1", outputDim, inputDim);
+    auto w2 = builder.CreateLearnableParameter(L"W2", outputDim, inputDim);
+    auto y1 = builder.Times(w1, x, 1, L"y1");
+    auto y2 = builder.Times(w2, x, 1, L"y2");
+    auto z = builder.Plus(builder.Plus(y1, y2, L"y"), builder.ElementTimes(w2, w2, L"w2Squared"), L"z");
+    net->AddToNodeGroup(L"feature", x);
+    net->AddToNodeGroup(L"output", z);
+    net->CompileNetwork();
+    SetSinusoidalValue(w1->Value(), outputDim, inputDim, 0.5, 0.9, 0.4);
+    SetSinusoidalValue(w2->Value(), outputDim, inputDim, 0.3, 1.1, 2.0);
+
+    BOOST_REQUIRE_EQUAL(net->QuantizeTimesNodesToInt8<float>(), 2);
+    BOOST_CHECK_EQUAL(net->ReleaseInt8FloatWeights<float>(), 1);
+    BOOST_CHECK_EQUAL(w1->Value().GetNumElements(), 0);
+    BOOST_CHECK_EQUAL(w2->Value().GetNumElements(), outputDim * inputDim);
+    BOOST_CHECK(dynamic_pointer_cast<QuantizedTimesNode<float>>(net->GetNodeFromName(L"y1"))->UsesQuantizedWeightsOnly());
+    BOOST_CHECK(!dynamic_pointer_cast<QuantizedTimesNode<float>>(net->GetNodeFromName(L"y2"))->UsesQuantizedWeightsOnly());
+}
+
+// Only int8 nodes need model version 28; other QuantizedTimes nodes are saved as before, also within a version 28 model.
+BOOST_AUTO_TEST_CASE(Int8QuantizedTimesNodeSaveLoad)
+{
+    TimesNodeTestNetwork network(4, 3, 2);
+    network.m_int8Times->StartCalibration();
+    network.m_int8Times->ForwardPass();
+    network.m_int8Times->EndCalibration();
+    BOOST_CHECK_EQUAL(network.m_quantizedTimes->GetModelVersionToSave(), CURRENT_CNTK_MODEL_VERSION);
+    BOOST_CHECK_EQUAL(network.m_int8Times->GetModelVersionToSave(), CNTK_MODEL_VERSION_28);
+
+    const wstring fileName = L"QuantizedTimesNodeSaveLoad.bin";
+    {
+        File file(fileName, fileOptionsBinary | fileOptionsWrite);
+        network.m_quantizedTimes->Save(file);
+        file << wstring(L"next");
+        network.m_int8Times->Save(file);
+        file << wstring(L"next");
+    }
+
+    for (size_t modelVersion : { (size_t) CURRENT_CNTK_MODEL_VERSION, (size_t) CNTK_MODEL_VERSION_28 })
+    {
+        File file(fileName, fileOptionsBinary | fileOptionsRead);
+        auto quantizedTimes = make_shared<ForwardPropNodeTest<QuantizedTimesNode<float>>>(L"QuantizedTimes");
+        quantizedTimes->Load(file, modelVersion);
+        BOOST_CHECK(!quantizedTimes->IsInt8());
+        wstring next;
+        file >> next;
+        BOOST_CHECK(next == L"next");
+        if (modelVersion < CNTK_MODEL_VERSION_28)
+            continue;
+
+        auto int8Times = make_shared<ForwardPropNodeTest<QuantizedTimesNode<float>>>(L"Int8Times");
+        int8Times->Load(file, modelVersion);
+        BOOST_CHECK(int8Times->IsInt8());
+        BOOST_CHECK_EQUAL(int8Times->InputRange(), network.m_int8Times->InputRange());
+        file >> next;
+        BOOST_CHECK(next == L"next");
+    }
+    _wunlink(fileName.c_str());
+}
+
+// Latency of the float and the quantized product for typical inference sizes.
+// To run it, use --run_test=QuantizedTimesNodeTests/QuantizedTimesNodeLatency.
+BOOST_AUTO_TEST_CASE(QuantizedTimesNodeLatency, *boost::unit_test::disabled())
+{
+    const size_t sizes[][3] = { { 512, 512, 1 }, { 512, 512, 16 }, { 2048, 512, 1 }, { 2048, 512, 16 }, { 1024, 1024, 64 } };
+    const int iterations = 200;
+    auto MeasureMicroseconds = [&](function<void()> forward)
+    {
+        forward(); // warm up (and prepare the quantized weights)
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            forward();
+        return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / iterations;
+    };
+
+    fprintf(stderr, "%-22s %14s %14s %8s %14s %8s\n", "[output, input, MB]", "Times (us)", "Quantized (us)", "Speedup", "Int8 (us)", "Speedup");
+    for (const auto& size : sizes)
+    {
+        TimesNodeTestNetwork network(size[0], size[1], size[2]);
+        double timesLatency = MeasureMicroseconds([&] { network.m_times->ForwardPass(); });
+        double quantizedLatency = MeasureMicroseconds([&] { network.m_quantizedTimes->ForwardPass(); });
+        double int8Latency = MeasureMicroseconds([&] { network.m_int8Times->ForwardPass(); });
+        fprintf(stderr, "[%5d, %5d, %5d]    %14.1f %14.1f %7.2fx %14.1f %7.2fx\n", (int) size[0], (int) size[1], (int) size[2],
+                timesLatency, quantizedLatency, timesLatency / quantizedLatency, int8Latency, timesLatency / int8Latency);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
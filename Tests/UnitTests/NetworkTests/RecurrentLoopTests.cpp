@@ -0,0 +1,109 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/ComputationNetworkLib/ComputationNetwork.h"
+#include "../../../Source/ComputationNetworkLib/ComputationNetworkBuilder.h"
+#include "TestHelpers.h"
+#include <memory>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+// Two stacked recurrences, where the second loop consumes the output of the first loop directly:
+//     h1 = Tanh(W1 * x + H1 * PastValue(h1))
+//     h2 = Tanh(h1 + H2 * PastValue(h2))
+//     criterion = SumElements(h2)
+struct StackedRecurrenceNetwork
+{
+    static const size_t inputDim = 3, hiddenDim = 4, numSequences = 2, numTimeSteps = 5;
+
+    ComputationNetworkPtr m_net;
+    shared_ptr<ComputationNode<double>> m_input, m_w1, m_h1, m_h2, m_inputProjection, m_plus1, m_plus2, m_output1;
+    ComputationNodeBasePtr m_criterion;
+
+    StackedRecurrenceNetwork()
+    {
+        m_net = make_shared<ComputationNetwork>(c_deviceId);
+        ComputationNetworkBuilder<double> builder(*m_net);
+        m_input = builder.CreateInputNode(L"x", inputDim);
+        m_w1 = builder.CreateLearnableParameter(L"W1", hiddenDim, inputDim);
+        m_h1 = builder.CreateLearnableParameter(L"H1", hiddenDim, hiddenDim);
+        m_h2 = builder.CreateLearnableParameter(L"H2", hiddenDim, hiddenDim);
+
+        auto delay1 = builder.PastValue(nullptr, 0.1f, hiddenDim, 1, L"delay1");
+        m_inputProjection = builder.Times(m_w1, m_input, 1, L"W1x");
+        m_plus1 = builder.Plus(m_inputProjection, builder.Times(m_h1, delay1, 1, L"H1d"), L"plus1");
+        m_output1 = builder.Tanh(m_plus1, L"h1");
+        delay1->AttachInputs({ m_output1 });
+
+        auto delay2 = builder.PastValue(nullptr, 0.1f, hiddenDim, 1, L"delay2");
+        m_plus2 = builder.Plus(m_output1, builder.Times(m_h2, delay2, 1, L"H2d"), L"plus2");
+        auto output2 = builder.Tanh(m_plus2, L"h2");
+        delay2->AttachInputs({ output2 });
+        m_criterion = builder.Sum(output2, L"criterion");
+
+        m_net->AddToNodeGroup(L"feature", m_input);
+        m_net->AddToNodeGroup(L"criterion", m_criterion);
+        m_net->CompileNetwork();
+        m_net->AllocateAllMatrices({}, {}, m_criterion);
+        m_net->StartEvaluateMinibatchLoop(m_criterion);
+
+        SetSinusoidalValue(m_w1->Value(), hiddenDim, inputDim, 0.5, 0.7, 1.0);
+        SetSinusoidalValue(m_h1->Value(), hiddenDim, hiddenDim, 0.3, 1.3, 0.2);
+        SetSinusoidalValue(m_h2->Value(), hiddenDim, hiddenDim, 0.4, 0.45, 2.5);
+    }
+
+    double ForwardProp()
+    {
+        auto pMBLayout = m_net->GetMBLayoutPtrOfNetwork();
+        pMBLayout->Init(numSequences, numTimeSteps);
+        for (size_t s = 0; s < numSequences; s++)
+            pMBLayout->AddSequence(s, s, 0, numTimeSteps);
+
+        SetSinusoidalValue(m_input->Value(), inputDim, numSequences * numTimeSteps, 1.0, 0.3, 1.6);
+
+        ComputationNetwork::BumpEvalTimeStamp({ m_input, m_w1, m_h1, m_h2 });
+        m_net->ForwardProp(m_criterion);
+        return m_criterion->As<ComputationNode<double>>()->Value().Get00Element();
+    }
+};
+
+BOOST_AUTO_TEST_SUITE(RecurrentLoopTests)
+
+BOOST_AUTO_TEST_CASE(InputProjectionIsEvaluatedOutsideTheLoop)
+{
+    StackedRecurrenceNetwork network;
+
+    // the input projection does not depend on the recurrence, and is computed once for all time steps
+    BOOST_CHECK(!network.m_inputProjection->IsPartOfLoop());
+    BOOST_CHECK(network.m_plus1->IsPartOfLoop());
+    BOOST_CHECK(network.m_plus2->IsPartOfLoop());
+    BOOST_CHECK(network.m_plus1->IsPartOfSameLoopAs(*network.m_output1));
+    BOOST_CHECK(!network.m_plus2->IsPartOfSameLoopAs(*network.m_output1));
+}
+
+// The gradient from the second loop into the first one is propagated after the second loop, over all time steps at once.
+// Compare the resulting parameter gradients of the first loop to finite differences.
+BOOST_AUTO_TEST_CASE(GradientIntoPrecedingLoopMatchesFiniteDifferences)
+{
+    StackedRecurrenceNetwork network;
+    ScopedNetworkOperationMode modeGuard(network.m_net, NetworkOperationMode::training);
+
+    network.ForwardProp();
+    network.m_net->Backprop(network.m_criterion);
+
+    for (const auto& parameter : { network.m_w1, network.m_h1 })
+        CheckGradientByFiniteDifferences(parameter, [&network]() { return network.ForwardProp(); });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
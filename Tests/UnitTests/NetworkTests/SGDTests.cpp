@@ -0,0 +1,93 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/SGDLib/SGD.h"
+#include <memory>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+static const float c_epsilonFloatE5 = 0.00001f;
+
+static const size_t c_dim = 16;
+static const size_t c_numColumns = 24;
+
+// An SGD<float> with the given gradUpdateType, without momentum. Only used to call UpdateWeights().
+static shared_ptr<SGD<float>> CreateSGD(const string& gradUpdateType)
+{
+    ConfigParameters config;
+    config.Insert("modelPath", "SGDTests.dnn");
+    config.Insert("learningRatesPerSample", "0.01");
+    config.Insert("momentumPerSample", "0");
+    config.Insert("gradUpdateType", gradUpdateType);
+    return make_shared<SGD<float>>(config);
+}
+
+// The gradient of a c_dim x c_numColumns parameter with only columns [begin, end) present, as a dense matrix and as a
+// block sparse one (the format of the gradient of an embedding with sparse input).
+static void GradientWithColumns(size_t begin, size_t end, unsigned long seed, Matrix<float>& dense, Matrix<float>& sparse)
+{
+    auto inputT = Matrix<float>::RandomUniform(4, c_numColumns, c_deviceId, -1.0f, 1.0f, seed);
+    for (size_t j = 0; j < c_numColumns; j++)
+    {
+        if (j < begin || j >= end)
+            inputT.SetColumn(0.0f, j);
+    }
+    Matrix<float> input = inputT.Transpose();
+    auto outputGradient = Matrix<float>::RandomGaussian(c_dim, 4, c_deviceId, 0.0f, 1.0f, seed + 1);
+
+    Matrix<float>::MultiplyAndWeightedAdd(1, outputGradient, false, input, true, 0, dense);
+    input.SwitchToMatrixType(MatrixType::SPARSE, matrixFormatSparseCSC, true);
+    sparse.SwitchToMatrixType(MatrixType::SPARSE, matrixFormatSparseBlockCol, false);
+    Matrix<float>::MultiplyAndAdd(outputGradient, false, input, true, sparse);
+}
+
+BOOST_AUTO_TEST_SUITE(SGDTests)
+
+// The state of the lazy sparse FSAdaGrad and RmsProp updates passed through SGD::UpdateWeights() must match the dense
+// update when columns are absent from some of the gradients: the first half of the columns is present in steps 1, 2
+// and 4, the second half in steps 1, 3 and 4.
+BOOST_AUTO_TEST_CASE(UpdateWeightsSparseSkippedColumns)
+{
+    const size_t columns[4][2] = { { 0, c_numColumns }, { 0, c_numColumns / 2 }, { c_numColumns / 2, c_numColumns }, { 0, c_numColumns } };
+
+    for (const string gradUpdateType : { "fsAdagrad", "rmsProp" })
+    {
+        auto sgd = CreateSGD(gradUpdateType);
+
+        auto initialModel = Matrix<float>::RandomUniform(c_dim, c_numColumns, c_deviceId, -0.1f, 0.1f, 7);
+        Matrix<float> model(initialModel.DeepClone()), modelSparse(initialModel.DeepClone());
+        Matrix<float> state(Matrix<float>::Zeros(c_dim, c_numColumns, c_deviceId)), stateSparse(Matrix<float>::Zeros(c_dim, c_numColumns, c_deviceId));
+        double count = 0, countSparse = 0;
+        Matrix<double> lastUpdateSteps(c_deviceId), lastUpdateStepsSparse(c_deviceId);
+
+        for (size_t step = 1; step <= 4; step++)
+        {
+            Matrix<float> gradient(c_deviceId), gradientSparse(c_deviceId);
+            GradientWithColumns(columns[step - 1][0], columns[step - 1][1], (unsigned long) (10 * step), gradient, gradientSparse);
+
+            sgd->UpdateWeights(model, gradient, state, count, lastUpdateSteps, (double) step,
+                               0.01, 0, /*actualMBSize=*/4, 0, 0, /*needAveMultiplier=*/false, /*useNesterovMomentum=*/false);
+            sgd->UpdateWeights(modelSparse, gradientSparse, stateSparse, countSparse, lastUpdateStepsSparse, (double) step,
+                               0.01, 0, /*actualMBSize=*/4, 0, 0, /*needAveMultiplier=*/false, /*useNesterovMomentum=*/false);
+        }
+
+        // the steps are only kept for the sparse gradients
+        BOOST_CHECK_EQUAL(lastUpdateSteps.GetNumElements(), 0);
+        BOOST_CHECK_EQUAL(lastUpdateStepsSparse.GetNumCols(), c_numColumns);
+        BOOST_CHECK(state.IsEqualTo(stateSparse, c_epsilonFloatE5));
+        BOOST_CHECK(model.IsEqualTo(modelSparse, c_epsilonFloatE5));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
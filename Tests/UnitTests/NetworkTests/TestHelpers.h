@@ -6,6 +6,8 @@
 #pragma once
 
 #include "ComputationNode.h"
+#include <boost/test/unit_test.hpp>
+#include <cmath>
 #include <vector>
 
 namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
@@ -41,4 +43,35 @@ public:
 
     void SetMinibatch(size_t minibatchSize, SmallVector<size_t> sampleDimensions, std::vector<ElemType>& data);
 };
+
+// Sets a matrix to scale * sin(phase + frequency * i), with i the index of the element in column-major order: smooth,
+// deterministic test data. Each test picks its own scale, frequency and phase, so that tests do not all run on the same values.
+template <class ElemType>
+void SetSinusoidalValue(Matrix<ElemType>& value, size_t numRows, size_t numCols, double scale, double frequency, double phase)
+{
+    std::vector<ElemType> data(numRows * numCols);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (ElemType) (scale * sin(phase + frequency * i));
+    value.SetValue(numRows, numCols, value.GetDeviceId(), data.data());
+}
+
+// Compares the gradient of a parameter, as left by the last Backprop(), element by element to the central differences
+// of the criterion returned by forwardProp().
+template <class F>
+void CheckGradientByFiniteDifferences(const shared_ptr<ComputationNode<double>>& parameter, F forwardProp, double epsilon = 1e-6, double tolerance = 1e-6)
+{
+    Matrix<double> gradient = parameter->Gradient().DeepClone();
+    double* value = parameter->Value().Data();
+    for (size_t i = 0; i < gradient.GetNumElements(); i++)
+    {
+        double original = value[i];
+        value[i] = original + epsilon;
+        double plus = forwardProp();
+        value[i] = original - epsilon;
+        double minus = forwardProp();
+        value[i] = original;
+
+        BOOST_CHECK_SMALL(gradient.Data()[i] - (plus - minus) / (2 * epsilon), tolerance);
+    }
+}
 } } } }
\ No newline at end of file
@@ -131,6 +131,70 @@ BOOST_AUTO_TEST_CASE(CNTKBinaryReader_50x20_jagged_sequences_sparse)
         true);
 };
 
+// Same as above, with the chunks pointing into the memory mapped input files
+BOOST_AUTO_TEST_CASE(CNTKBinaryReader_MNIST_dense_memory_mapped)
+{
+    HelperRunReaderTest<double>(
+        testDataPath() + "/Config/CNTKBinaryReader/test.cntk",
+        testDataPath() + "/Control/CNTKTextFormatReader/MNIST_dense.txt",
+        testDataPath() + "/Control/CNTKBinaryReader/MNIST_dense_memory_mapped_Output.txt",
+        "MNIST",
+        "reader",
+        1000, // epoch size
+        1000,  // mb size
+        1,   // num epochs
+        1,
+        1,
+        0,
+        1,
+        false,
+        false,
+        true,
+        { L"useMemoryMapping=true" });
+};
+
+BOOST_AUTO_TEST_CASE(CNTKBinaryReader_10x10_dense_memory_mapped)
+{
+    HelperRunReaderTest<float>(
+        testDataPath() + "/Config/CNTKBinaryReader/test.cntk",
+        testDataPath() + "/Control/CNTKTextFormatReader/10x10_dense.txt",
+        testDataPath() + "/Control/CNTKBinaryReader/10x10_dense_memory_mapped_Output.txt",
+        "10x10_dense",
+        "reader",
+        100, // epoch size
+        100,  // mb size
+        1,  // num epochs
+        1,
+        0, // no labels
+        0,
+        1,
+        false,
+        false,
+        true,
+        { L"useMemoryMapping=true" });
+};
+
+BOOST_AUTO_TEST_CASE(CNTKBinaryReader_50x20_jagged_sequences_sparse_memory_mapped)
+{
+    HelperRunReaderTest<float>(
+        testDataPath() + "/Config/CNTKBinaryReader/test.cntk",
+        testDataPath() + "/Control/CNTKTextFormatReader/50x20_jagged_sequences_sparse.txt",
+        testDataPath() + "/Control/CNTKBinaryReader/50x20_jagged_sequences_sparse_memory_mapped_Output.txt",
+        "50x20_jagged_sequences_sparse",
+        "reader",
+        564,  // epoch size
+        564,  // mb size 
+        1,  // num epochs
+        1,
+        0,
+        0,
+        1,
+        true,
+        false,
+        true,
+        { L"useMemoryMapping=true" });
+};
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } } } }
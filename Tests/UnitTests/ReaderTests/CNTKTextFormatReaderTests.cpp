@@ -16,6 +16,9 @@
 #include <boost/scope_exit.hpp>
 #include "Common/ReaderTestHelper.h"
 #include "TextParser.h"
+#include "TextReaderScanning.h"
+#include <chrono>
+#include <random>
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -1057,6 +1060,199 @@ BOOST_AUTO_TEST_CASE(CNTKTextFormatReaderNoFirstMinibatchData)
         2);
 };
 
+// The character-by-character number parsing of TextParser::TryReadRealNumber() for a terminated,
+// well-formed number, as a reference for the fast path. Returns the length of the number, 0 if malformed.
+template <class ElemType>
+static size_t ReferenceParseRealNumber(const string& s, ElemType& value)
+{
+    enum { Init, Sign, IntegralPart, Period, FractionalPart, TheLetterE, ExponentSign, Exponent } state = Init;
+    double coefficient = .0, number = .0, divider = .0;
+    bool negative = false;
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        char c = s[i];
+        bool digit = '0' <= c && c <= '9', sign = c == '-' || c == '+', e = c == 'e' || c == 'E';
+        switch (state)
+        {
+        case Init:
+            if (digit) { state = IntegralPart; number = (c - '0'); }
+            else if (sign) { state = Sign; negative = (c == '-'); }
+            else return 0;
+            break;
+        case Sign:
+            if (!digit) return 0;
+            state = IntegralPart; number = (c - '0');
+            break;
+        case IntegralPart:
+            if (digit) number = number * 10 + (c - '0');
+            else if (c == '.') state = Period;
+            else if (e) { state = TheLetterE; coefficient = (negative) ? -number : number; number = 0; }
+            else { value = static_cast<ElemType>((negative) ? -number : number); return i; }
+            break;
+        case Period:
+            if (digit) { state = FractionalPart; coefficient = number; number = (c - '0'); divider = 10; }
+            else { value = static_cast<ElemType>((negative) ? -number : number); return i; }
+            break;
+        case FractionalPart:
+            if (digit) { number = number * 10 + (c - '0'); divider *= 10; }
+            else if (e)
+            {
+                state = TheLetterE;
+                coefficient += (number / divider);
+                if (negative) coefficient = -coefficient;
+            }
+            else { coefficient += (number / divider); value = static_cast<ElemType>((negative) ? -coefficient : coefficient); return i; }
+            break;
+        case TheLetterE:
+            if (digit) { state = Exponent; negative = false; number = (c - '0'); }
+            else if (sign) { state = ExponentSign; negative = (c == '-'); }
+            else return 0;
+            break;
+        case ExponentSign:
+            if (!digit) return 0;
+            state = Exponent; number = (c - '0');
+            break;
+        case Exponent:
+            if (digit) number = number * 10 + (c - '0');
+            else { value = static_cast<ElemType>(coefficient * pow(10.0, (negative) ? -number : number)); return i; }
+            break;
+        }
+    }
+    return 0; // not terminated
+}
+
+template <class ElemType>
+static void CheckFastRealNumberParsing(const string& number, const string& terminator)
+{
+    string s = number + terminator;
+    ElemType expected = 0, actual = 0;
+    size_t expectedLength = ReferenceParseRealNumber(s, expected);
+    const char* end = TryParseRealNumber(s.data(), s.data() + s.size(), actual);
+    if (expectedLength == 0)
+    {
+        BOOST_CHECK_MESSAGE(end == nullptr, "'" << s << "' should not be parsed");
+        return;
+    }
+
+    BOOST_REQUIRE_MESSAGE(end != nullptr, "'" << s << "' should be parsed");
+    BOOST_CHECK_EQUAL(end - s.data(), expectedLength);
+    BOOST_CHECK_MESSAGE(memcmp(&expected, &actual, sizeof(ElemType)) == 0, "'" << s << "': " << expected << " vs. " << actual);
+
+    // a number that extends to the end of the range is left to the slow path
+    BOOST_CHECK(TryParseRealNumber(s.data(), s.data() + expectedLength, actual) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_fast_number_parsing)
+{
+    vector<string> numbers { "0", "-0", "+0", "1", "-123", "45.", "6.78", "-6.78", "9.10e-11", "1e5", "-1E+5", "1.5e", "1.e5",
+        "3.40282347e+38", "1.17549435e-38", "2.2250738585072014e-308", "1.7976931348623157e308", "123456789012345678901234567890",
+        "0.1000000000000000055511151231257827", "4.9406564584124654e-324", "1e400", "1e-400", "00012.5000", ".5", "-", "+.", "e5",
+        "1e+", "1e-", "--1", "1..2", "1.2.3", "0x10" };
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> digits(0, 9), length(1, 20), exponent(-45, 45), choice(0, 3);
+    for (int i = 0; i < 20000; ++i)
+    {
+        string number = choice(rng) == 0 ? "-" : (choice(rng) == 0 ? "+" : "");
+        for (int j = length(rng); j > 0; --j)
+            number += char('0' + digits(rng));
+        if (choice(rng) != 0)
+        {
+            number += '.';
+            for (int j = length(rng) - 1; j > 0; --j)
+                number += char('0' + digits(rng));
+        }
+        if (choice(rng) == 0)
+            number += (choice(rng) < 2 ? "e" : "E") + to_string(exponent(rng));
+        numbers.push_back(number);
+    }
+
+    for (const auto& number : numbers)
+    {
+        for (const auto& terminator : { " ", "|", "\n", "\t", ":", "x" })
+        {
+            CheckFastRealNumberParsing<float>(number, terminator);
+            CheckFastRealNumberParsing<double>(number, terminator);
+        }
+    }
+
+    size_t value = 0;
+    string s = "18446744073709551615:";
+    BOOST_CHECK(TryParseUint64(s.data(), s.data() + s.size(), value) == s.data() + s.size() - 1);
+    BOOST_CHECK_EQUAL(value, SIZE_MAX);
+    s = "18446744073709551616:";
+    BOOST_CHECK(TryParseUint64(s.data(), s.data() + s.size(), value) == nullptr);
+    s = "123";
+    BOOST_CHECK(TryParseUint64(s.data(), s.data() + s.size(), value) == nullptr);
+    s = ":1";
+    BOOST_CHECK(TryParseUint64(s.data(), s.data() + s.size(), value) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_delimiter_scanning)
+{
+    std::mt19937 rng(2);
+    const string alphabet = "0123456789.e-abc|: \t\n";
+    std::uniform_int_distribution<size_t> character(0, alphabet.size() - 1);
+    std::uniform_int_distribution<int> sparse(0, 40);
+    for (int i = 0; i < 2000; ++i)
+    {
+        // mostly long runs without a delimiter, at all lengths and alignments
+        string s(i % 67, 'x');
+        for (auto& c : s)
+            if (sparse(rng) == 0)
+                c = alphabet[character(rng)];
+        for (size_t offset = 0; offset < std::min<size_t>(s.size(), 3); ++offset)
+        {
+            const char* begin = s.data() + offset;
+            const char* end = s.data() + s.size();
+            const string delimiters = "| \t\n";
+            BOOST_CHECK(FindFirstOf(begin, end, ' ', '\t', '|', '\n') == std::find_first_of(begin, end, delimiters.begin(), delimiters.end()));
+            const string inputDelimiters = "|\n";
+            BOOST_CHECK(FindFirstOf(begin, end, '|', '\n', '|', '\n') == std::find_first_of(begin, end, inputDelimiters.begin(), inputDelimiters.end()));
+        }
+    }
+}
+
+// Parsing throughput on dense input. Run explicitly with
+// --run_test=ReaderTestSuite/CNTKTextFormatReader_parsing_benchmark.
+BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_parsing_benchmark, *boost::unit_test::disabled())
+{
+    vector<StreamDescriptor> streams(2);
+    streams[0].m_alias = "features";
+    streams[0].m_name = L"features";
+    streams[0].m_storageFormat = StorageFormat::Dense;
+    streams[0].m_sampleDimension = 100;
+    streams[1].m_alias = "labels";
+    streams[1].m_name = L"labels";
+    streams[1].m_storageFormat = StorageFormat::SparseCSC;
+    streams[1].m_sampleDimension = 1000;
+
+    string filename = "parsing_benchmark.txt";
+    {
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> value(-10, 10);
+        std::uniform_int_distribution<int> label(0, 999);
+        FILE* file = fopen(filename.c_str(), "w");
+        for (int i = 0; i < 100000; ++i)
+        {
+            fprintf(file, "%d |features", i);
+            for (int j = 0; j < 100; ++j)
+                fprintf(file, " %.6g", value(rng));
+            fprintf(file, " |labels %d:1\n", label(rng));
+        }
+        fclose(file);
+    }
+    double megabytes = boost::filesystem::file_size(filename) / (1024.0 * 1024.0);
+
+    CNTKTextFormatReaderTestRunner<float> testRunner(filename, streams, 0);
+    auto start = std::chrono::steady_clock::now();
+    testRunner.LoadChunk();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "Parsed %.1f MB in %.3f s: %.1f MB/s\n", megabytes, seconds, megabytes / seconds);
+
+    boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } } } }
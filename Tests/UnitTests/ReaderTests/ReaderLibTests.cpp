@@ -12,10 +12,15 @@
 #include "CorpusDescriptor.h"
 #include "FramePacker.h"
 #include "SequencePacker.h"
+#include "BucketingSequencePacker.h"
 #include "TruncatedBpttPacker.h"
 #include "CudaMemoryProvider.h"
 #include "HeapMemoryProvider.h"
 #include "MemoryBuffer.h"
+#include "Indexer.h"
+#include "IndexCache.h"
+#include <chrono>
+#include <thread>
 
 #pragma warning(push)
 // disable warning about possible mod 0 operation in uniform_int_distribution
@@ -470,6 +475,149 @@ void TestRandomization(EpochConfiguration& epochConfiguration, DataDeserializerP
     }
 }
 
+// Mock deserializer that records the chunks it loads, and fails to load a given chunk.
+class RecordingDeserializer : public MockDeserializer
+{
+    mutex m_mutex;
+    vector<ChunkIdType> m_loadedChunks;
+
+public:
+    ChunkIdType m_failingChunk = ChunkIdMax;
+
+    RecordingDeserializer(size_t numChunks, size_t numSequencesPerChunks, const vector<float>& data)
+        : MockDeserializer(numChunks, numSequencesPerChunks, data)
+    {
+    }
+
+    ChunkPtr GetChunk(ChunkIdType chunkId) override
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_loadedChunks.push_back(chunkId);
+        }
+        if (chunkId == m_failingChunk)
+            throw runtime_error("Cannot load chunk.");
+        return MockDeserializer::GetChunk(chunkId);
+    }
+
+    vector<ChunkIdType> LoadedChunks()
+    {
+        lock_guard<mutex> lock(m_mutex);
+        vector<ChunkIdType> result = m_loadedChunks;
+        sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+static float FirstValue(const ChunkPtr& chunk, size_t sequenceId)
+{
+    vector<SequenceDataPtr> sequence;
+    chunk->GetSequence(sequenceId, sequence);
+    return *(const float*)sequence[0]->GetDataBuffer();
+}
+
+BOOST_AUTO_TEST_CASE(ChunkPrefetcherLoadsScheduledChunks)
+{
+    vector<float> data(20);
+    iota(data.begin(), data.end(), 0.0f);
+    auto deserializer = make_shared<RecordingDeserializer>(10, 2, data);
+
+    ChunkPrefetchConfiguration config;
+    config.m_maxChunks = 3;
+    config.m_concurrentLoads = true;
+    ChunkPrefetcher prefetcher(deserializer, config, sizeof(float));
+
+    // only the first three are prefetched
+    prefetcher.Schedule({ { 4, 2 }, { 7, 2 }, { 1, 2 }, { 3, 2 } });
+    BOOST_CHECK_EQUAL(prefetcher.NumberOfChunks(), 3u);
+    BOOST_CHECK_EQUAL(FirstValue(prefetcher.Get(7), 14), 14.0f);
+    BOOST_CHECK_EQUAL(FirstValue(prefetcher.Get(4), 8), 8.0f);
+    BOOST_CHECK_EQUAL(FirstValue(prefetcher.Get(1), 2), 2.0f);
+    BOOST_CHECK_EQUAL(prefetcher.NumberOfChunks(), 0u);
+    vector<ChunkIdType> expected { 1, 4, 7 };
+    auto loaded = deserializer->LoadedChunks();
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), loaded.begin(), loaded.end());
+
+    // chunks that were not scheduled are loaded on demand
+    BOOST_CHECK_EQUAL(FirstValue(prefetcher.Get(3), 6), 6.0f);
+    BOOST_CHECK_EQUAL(deserializer->LoadedChunks().size(), 4u);
+
+    // load errors are reported to the caller of Get()
+    deserializer->m_failingChunk = 5;
+    prefetcher.Schedule({ { 5, 2 } });
+    BOOST_CHECK_THROW(prefetcher.Get(5), runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkPrefetcherRespectsMemoryBudget)
+{
+    vector<float> data(20);
+    iota(data.begin(), data.end(), 0.0f);
+    auto deserializer = make_shared<RecordingDeserializer>(10, 2, data);
+
+    ChunkPrefetchConfiguration config;
+    config.m_maxChunks = 5;
+    config.m_memoryBudget = 5 * sizeof(float); // room for two chunks of two samples
+    ChunkPrefetcher prefetcher(deserializer, config, sizeof(float));
+
+    prefetcher.Schedule({ { 0, 2 }, { 1, 2 }, { 2, 2 }, { 3, 2 } });
+    BOOST_CHECK_EQUAL(prefetcher.NumberOfChunks(), 2u);
+
+    // at least one chunk is prefetched even if it exceeds the budget
+    prefetcher.Get(0);
+    prefetcher.Get(1);
+    prefetcher.Schedule({ { 9, 100 } });
+    BOOST_CHECK_EQUAL(prefetcher.NumberOfChunks(), 1u);
+    BOOST_CHECK_EQUAL(FirstValue(prefetcher.Get(9), 18), 18.0f);
+}
+
+// Prefetching several chunks ahead must not change the order of sequences.
+BOOST_AUTO_TEST_CASE(BlockRandomizerWithDeepPrefetch)
+{
+    vector<float> data(40);
+    iota(data.begin(), data.end(), 0.0f);
+    auto deserializer = make_shared<MockDeserializer>(20, 2, data);
+
+    auto read = [&](const ChunkPrefetchConfiguration& config, bool prefetch)
+    {
+        BlockRandomizer randomizer(0, 2, deserializer, prefetch, false, 0, /*sampleBasedRandomizationWindow =*/ false, 0, config);
+        EpochConfiguration epochConfiguration;
+        epochConfiguration.m_numberOfWorkers = 1;
+        epochConfiguration.m_workerRank = 0;
+        epochConfiguration.m_minibatchSizeInSamples = 0;
+        epochConfiguration.m_totalEpochSizeInSamples = data.size() * 2;
+        epochConfiguration.m_epochIndex = 0;
+        randomizer.StartEpoch(epochConfiguration);
+
+        vector<float> result;
+        for (;;)
+        {
+            Sequences sequences = randomizer.GetNextSequences(3, 3);
+            if (!sequences.m_data.empty())
+                for (const auto& s : sequences.m_data[0])
+                    result.push_back(*(const float*)s->GetDataBuffer());
+            if (sequences.m_endOfEpoch)
+                break;
+        }
+        return result;
+    };
+
+    auto expected = read(ChunkPrefetchConfiguration(), /*prefetch =*/ false);
+    BOOST_CHECK_EQUAL(expected.size(), data.size() * 2);
+
+    ChunkPrefetchConfiguration config;
+    config.m_maxChunks = 4;
+    auto actual = read(config, /*prefetch =*/ true);
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+
+    config.m_concurrentLoads = true;
+    actual = read(config, /*prefetch =*/ true);
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+
+    config.m_memoryBudget = 1;
+    actual = read(config, /*prefetch =*/ true);
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+}
+
 BOOST_AUTO_TEST_CASE(TestChunkBasedRandomization)
 {
     auto num_chunks = 10;
@@ -1521,6 +1669,267 @@ BOOST_AUTO_TEST_CASE(MemoryBufferFullLineWithoutLastCR)
     remove("test.tmp");
 }
 
+// Writes a text format file with numberOfSequences sequences of 1 to 4 lines each.
+static void WriteTextFormatFile(const char* filename, size_t numberOfSequences, bool numericKeys, bool withBOM = false)
+{
+    FILE* file = fopen(filename, "wb");
+    if (withBOM)
+        fputs("\xEF\xBB\xBF", file);
+    for (size_t i = 0; i < numberOfSequences; ++i)
+    {
+        string key = numericKeys ? to_string(i) : "utt_" + to_string(i % 7) + "_" + to_string(i);
+        for (size_t j = 0; j <= i % 4; ++j)
+        {
+            // the labels are only given on the first line of a sequence; some continuation lines omit the id
+            if (j == 2 && i % 3 == 0)
+                fprintf(file, "|features %zu %zu\n", i, j);
+            else if (j == 0)
+                fprintf(file, "%s\t|features %zu %zu |labels 1\n", key.c_str(), i, j);
+            else
+                fprintf(file, "%s |features %zu %zu\n", key.c_str(), i, j);
+        }
+    }
+    fclose(file);
+}
+
+static void WriteLinesFile(const char* filename, size_t numberOfLines, bool terminateLastLine)
+{
+    FILE* file = fopen(filename, "wb");
+    for (size_t i = 0; i < numberOfLines; ++i)
+        fprintf(file, "|features %zu%s", i * 37, (i + 1 < numberOfLines || terminateLastLine) ? "\n" : "");
+    fclose(file);
+}
+
+static void CheckSameIndex(const Index& expected, const Index& actual)
+{
+    BOOST_REQUIRE_EQUAL(expected.Chunks().size(), actual.Chunks().size());
+    for (size_t i = 0; i < expected.Chunks().size(); ++i)
+    {
+        const auto& e = expected.Chunks()[i];
+        const auto& a = actual.Chunks()[i];
+        BOOST_CHECK_EQUAL(e.m_offset, a.m_offset);
+        BOOST_CHECK_EQUAL(e.SizeInBytes(), a.SizeInBytes());
+        BOOST_CHECK_EQUAL(e.NumSamples(), a.NumSamples());
+        BOOST_REQUIRE_EQUAL(e.Sequences().size(), a.Sequences().size());
+        for (size_t j = 0; j < e.Sequences().size(); ++j)
+        {
+            BOOST_CHECK_EQUAL(e.Sequences()[j].m_key, a.Sequences()[j].m_key);
+            BOOST_CHECK_EQUAL(e.Sequences()[j].m_numberOfSamples, a.Sequences()[j].m_numberOfSamples);
+            BOOST_CHECK_EQUAL(e.Sequences()[j].OffsetInChunk(), a.Sequences()[j].OffsetInChunk());
+            BOOST_CHECK_EQUAL(e.Sequences()[j].SizeInBytes(), a.Sequences()[j].SizeInBytes());
+        }
+    }
+    BOOST_CHECK(expected.m_keyToSequenceInChunk == actual.m_keyToSequenceInChunk);
+}
+
+// Indexes the file sequentially and with several thread counts, using tiny byte ranges so that
+// range boundaries fall at every possible position within the lines.
+static void CheckParallelIndexing(const char* filename, bool numericKeys, bool skipSequenceIds, const string& mainStream, size_t chunkSize)
+{
+    auto build = [&](size_t numThreads)
+    {
+        FILE* file = fopen(filename, "rb");
+        auto indexer = make_shared<Indexer>(file, /*primary=*/false, skipSequenceIds, '|', chunkSize, mainStream);
+        if (numThreads > 1)
+            indexer->SetParallelism(wstring(filename, filename + strlen(filename)), numThreads, /*minBytesPerThread=*/1);
+        indexer->Build(make_shared<CorpusDescriptor>(numericKeys));
+        BOOST_CHECK_EQUAL(_ftelli64(file), filesize(file));
+        fclose(file);
+        return indexer;
+    };
+
+    auto expected = build(1);
+    for (size_t numThreads : { 2, 3, 8, 61 })
+    {
+        auto actual = build(numThreads);
+        BOOST_CHECK_EQUAL(expected->HasSequenceIds(), actual->HasSequenceIds());
+        CheckSameIndex(expected->GetIndex(), actual->GetIndex());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ParallelIndexerNumericKeys)
+{
+    WriteTextFormatFile("index.tmp", 50, /*numericKeys=*/true);
+    CheckParallelIndexing("index.tmp", true, false, "", 512);
+    CheckParallelIndexing("index.tmp", true, false, "labels", 256);
+    WriteTextFormatFile("index.tmp", 50, /*numericKeys=*/true, /*withBOM=*/true);
+    CheckParallelIndexing("index.tmp", true, false, "", SIZE_MAX);
+    remove("index.tmp");
+}
+
+BOOST_AUTO_TEST_CASE(ParallelIndexerSymbolicKeys)
+{
+    WriteTextFormatFile("index.tmp", 50, /*numericKeys=*/false);
+    CheckParallelIndexing("index.tmp", false, false, "", 512);
+    CheckParallelIndexing("index.tmp", false, false, "labels", 1);
+    remove("index.tmp");
+}
+
+BOOST_AUTO_TEST_CASE(ParallelIndexerLines)
+{
+    WriteLinesFile("index.tmp", 100, /*terminateLastLine=*/true);
+    CheckParallelIndexing("index.tmp", true, false, "", 512);
+    WriteLinesFile("index.tmp", 100, /*terminateLastLine=*/false);
+    CheckParallelIndexing("index.tmp", true, false, "", 100);
+    WriteTextFormatFile("index.tmp", 50, /*numericKeys=*/true);
+    CheckParallelIndexing("index.tmp", true, /*skipSequenceIds=*/true, "", 512);
+    remove("index.tmp");
+}
+
+static shared_ptr<Indexer> BuildCachedIndex(const char* filename, CorpusDescriptorPtr corpus)
+{
+    FILE* file = fopen(filename, "rb");
+    auto indexer = make_shared<Indexer>(file, /*primary=*/false, false, '|', 256);
+    indexer->SetIndexCache(wstring(filename, filename + strlen(filename)));
+    indexer->Build(corpus);
+    fclose(file);
+    return indexer;
+}
+
+BOOST_AUTO_TEST_CASE(IndexCacheRoundTrip)
+{
+    for (bool numericKeys : { true, false })
+    {
+        remove("index.tmp.cntkidx");
+        WriteTextFormatFile("index.tmp", 50, numericKeys);
+        auto built = BuildCachedIndex("index.tmp", make_shared<CorpusDescriptor>(numericKeys));
+        BOOST_REQUIRE(fexists(L"index.tmp.cntkidx"));
+
+        // a fresh corpus gets the same ids for the symbolic keys
+        Index loaded(256, /*primary=*/false);
+        uint64_t hasSequenceIds = 0;
+        IndexCache cache(L"index.tmp", "CNTKTextFormat skipSequenceIds=0 streamPrefix=124 chunkSize=256 mainStream=");
+        BOOST_REQUIRE(cache.TryLoad(loaded, make_shared<CorpusDescriptor>(numericKeys), hasSequenceIds));
+        BOOST_CHECK_EQUAL(hasSequenceIds, 1);
+        loaded.MapSequenceKeyToLocation();
+        CheckSameIndex(built->GetIndex(), loaded);
+
+        // the indexer uses it as well
+        CheckSameIndex(built->GetIndex(), BuildCachedIndex("index.tmp", make_shared<CorpusDescriptor>(numericKeys))->GetIndex());
+
+        // different configuration
+        Index other(256, false);
+        IndexCache otherCache(L"index.tmp", "CNTKTextFormat skipSequenceIds=0 streamPrefix=124 chunkSize=512 mainStream=");
+        BOOST_CHECK(!otherCache.TryLoad(other, make_shared<CorpusDescriptor>(numericKeys), hasSequenceIds));
+        BOOST_CHECK(other.IsEmpty());
+    }
+    remove("index.tmp");
+    remove("index.tmp.cntkidx");
+}
+
+BOOST_AUTO_TEST_CASE(IndexCacheDetectsStaleAndCorruptedCaches)
+{
+    remove("index.tmp.cntkidx");
+    WriteTextFormatFile("index.tmp", 50, true);
+    BuildCachedIndex("index.tmp", make_shared<CorpusDescriptor>(true));
+
+    // the input changes: the cache is not used, and rewritten
+    WriteTextFormatFile("index.tmp", 60, true);
+    FILE* input = fopen("index.tmp", "rb");
+    auto expected = make_shared<Indexer>(input, false, false, '|', 256);
+    expected->Build(make_shared<CorpusDescriptor>(true));
+    fclose(input);
+    CheckSameIndex(expected->GetIndex(), BuildCachedIndex("index.tmp", make_shared<CorpusDescriptor>(true))->GetIndex());
+    {
+        Index loaded(256, false);
+        uint64_t flags;
+        IndexCache cache(L"index.tmp", "CNTKTextFormat skipSequenceIds=0 streamPrefix=124 chunkSize=256 mainStream=");
+        BOOST_CHECK(cache.TryLoad(loaded, make_shared<CorpusDescriptor>(true), flags));
+    }
+
+    // corrupted or truncated caches are rebuilt
+    for (bool truncate : { false, true })
+    {
+        FILE* file = fopen("index.tmp.cntkidx", "r+b");
+        int64_t size = filesize(file);
+        if (truncate)
+        {
+            vector<char> data(size / 2);
+            BOOST_REQUIRE_EQUAL(fread(data.data(), 1, data.size(), file), data.size());
+            fclose(file);
+            file = fopen("index.tmp.cntkidx", "wb");
+            fwrite(data.data(), 1, data.size(), file);
+        }
+        else
+        {
+            fseek(file, (long)(size - 10), SEEK_SET);
+            fputc(0x5A, file);
+        }
+        fclose(file);
+
+        Index loaded(256, false);
+        uint64_t flags;
+        IndexCache cache(L"index.tmp", "CNTKTextFormat skipSequenceIds=0 streamPrefix=124 chunkSize=256 mainStream=");
+        BOOST_CHECK(!cache.TryLoad(loaded, make_shared<CorpusDescriptor>(true), flags));
+        BOOST_CHECK(loaded.IsEmpty());
+        CheckSameIndex(expected->GetIndex(), BuildCachedIndex("index.tmp", make_shared<CorpusDescriptor>(true))->GetIndex());
+        BOOST_CHECK(cache.TryLoad(loaded, make_shared<CorpusDescriptor>(true), flags));
+    }
+
+    remove("index.tmp");
+    remove("index.tmp.cntkidx");
+}
+
+// Keys that indexing registered with the corpus for sequences it left out (e.g. invalid MLF utterances) are registered
+// again on load, so that the ids of all later keys are those of a fresh scan.
+BOOST_AUTO_TEST_CASE(IndexCacheReplaysSkippedKeys)
+{
+    remove("index.tmp.cntkidx");
+    WriteTextFormatFile("index.tmp", 50, /*numericKeys=*/false);
+
+    auto corpus = make_shared<CorpusDescriptor>(/*numericSequenceKeys=*/false);
+    size_t first = corpus->KeyToId("first");
+    size_t skipped = corpus->KeyToId("skipped");
+    size_t second = corpus->KeyToId("second");
+    Index index(256, /*primary=*/false);
+    index.AddSequence(SequenceDescriptor{ first, 1 }, 0, 10);
+    index.AddSequence(SequenceDescriptor{ second, 1 }, 10, 20);
+    IndexCache cache(L"index.tmp", "test");
+    cache.Save(index, corpus, 0, { make_pair((size_t) 1, skipped) });
+
+    auto freshCorpus = make_shared<CorpusDescriptor>(/*numericSequenceKeys=*/false);
+    Index loaded(256, /*primary=*/false);
+    uint64_t flags;
+    BOOST_REQUIRE(cache.TryLoad(loaded, freshCorpus, flags));
+    loaded.MapSequenceKeyToLocation();
+    BOOST_CHECK_EQUAL(freshCorpus->KeyToId("first"), first);
+    BOOST_CHECK_EQUAL(freshCorpus->KeyToId("skipped"), skipped);
+    BOOST_CHECK_EQUAL(freshCorpus->KeyToId("second"), second);
+    BOOST_CHECK_EQUAL(loaded.Chunks().front().Sequences().back().m_key, second);
+
+    remove("index.tmp");
+    remove("index.tmp.cntkidx");
+}
+
+// Index build time against file size, sequential vs. one thread per core. Run explicitly with
+// --run_test=ReaderLibTests/ParallelIndexerBenchmark, it writes files of more than 1 GB.
+BOOST_AUTO_TEST_CASE(ParallelIndexerBenchmark, *boost::unit_test::disabled())
+{
+    for (size_t numberOfSequences : { 250000, 1000000, 4000000, 16000000 })
+    {
+        WriteTextFormatFile("index_benchmark.tmp", numberOfSequences, /*numericKeys=*/true);
+        FILE* file = fopen("index_benchmark.tmp", "rb");
+        double fileSizeMB = filesize(file) / (1024.0 * 1024.0);
+
+        double seconds[2];
+        for (size_t numThreads : { 1, 0 })
+        {
+            rewind(file);
+            auto start = std::chrono::steady_clock::now();
+            Indexer indexer(file, /*primary=*/true, false, '|', 32 * 1024 * 1024);
+            if (numThreads != 1)
+                indexer.SetParallelism(L"index_benchmark.tmp", numThreads, 16 * 1024 * 1024);
+            indexer.Build(make_shared<CorpusDescriptor>(true));
+            seconds[numThreads == 1 ? 0 : 1] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        fclose(file);
+
+        fprintf(stderr, "Indexing %8.1f MB: %7.3f s with 1 thread, %7.3f s with %u threads (%.1fx)\n",
+                fileSizeMB, seconds[0], seconds[1], std::thread::hardware_concurrency(), seconds[0] / seconds[1]);
+    }
+    remove("index_benchmark.tmp");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(PackerTests)
@@ -2079,6 +2488,148 @@ BOOST_AUTO_TEST_CASE(SequencePackerSmallChunksWithSequences)
     }
 }
 
+BOOST_AUTO_TEST_CASE(BucketingSequencePackerWithSequences)
+{
+    size_t chunkSizeInSamples = 998;
+    size_t sweepNumberOfSamples = 21335;
+    uint32_t maxSequenceLength = 30;
+    size_t randomizationWindow = chunkSizeInSamples * 5;
+    size_t bucketingWindow = 8;
+
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, maxSequenceLength);
+
+    {
+        auto blockRandomizer = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true);
+        PackerPtr packer = std::make_shared<BucketingSequencePacker>(blockRandomizer, deserializer->StreamInfos(), bucketingWindow, 1, true);
+
+        CheckPackerOnDataSet(packer, blockRandomizer, deserializer, 1, sweepNumberOfSamples * 2, 2, sweepNumberOfSamples, 64, false);
+        CheckPackerOnDataSet(packer, blockRandomizer, deserializer, 5, sweepNumberOfSamples * 2 / 5, 2, sweepNumberOfSamples, 64, false);
+
+        CheckPackerOnDataSet(packer, blockRandomizer, deserializer, 1, sweepNumberOfSamples * 2, 2, sweepNumberOfSamples, 33, false);
+        CheckPackerOnDataSet(packer, blockRandomizer, deserializer, 5, sweepNumberOfSamples * 2 / 5, 2, sweepNumberOfSamples, 31, false);
+    }
+
+    {
+        auto noRandomizer = make_shared<NoRandomizer>(deserializer, true);
+        PackerPtr packer = std::make_shared<BucketingSequencePacker>(noRandomizer, deserializer->StreamInfos(), bucketingWindow, 1, true);
+
+        CheckPackerOnDataSet(packer, noRandomizer, deserializer, 1, sweepNumberOfSamples * 2, 2, sweepNumberOfSamples, 64, false);
+        CheckPackerOnDataSet(packer, noRandomizer, deserializer, 5, sweepNumberOfSamples * 2 / 5, 2, sweepNumberOfSamples, 31, false);
+    }
+
+    // Grouping by length should reduce the number of gaps in the layout.
+    {
+        auto blockRandomizer = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true);
+        auto packer = std::make_shared<BucketingSequencePacker>(blockRandomizer, deserializer->StreamInfos(), bucketingWindow, 1, true);
+
+        EpochConfiguration config;
+        config.m_numberOfWorkers = 1;
+        config.m_workerRank = 0;
+        config.m_minibatchSizeInSamples = 256;
+        config.m_truncationSize = 0;
+        config.m_epochIndex = 0;
+        config.m_totalEpochSizeInSamples = sweepNumberOfSamples;
+
+        packer->SetConfiguration(config, std::vector<MemoryProviderPtr> { std::make_shared<HeapMemoryProvider>() });
+        blockRandomizer->StartEpoch(config);
+
+        size_t numberOfSamples = 0;
+        while (true)
+        {
+            auto minibatch = packer->ReadMinibatch();
+            if (!minibatch.m_data.empty())
+            {
+                BOOST_REQUIRE(minibatch.m_data.front()->m_layout->GetActualNumSamples() <= config.m_minibatchSizeInSamples);
+                numberOfSamples += minibatch.m_data.front()->m_layout->GetActualNumSamples();
+            }
+
+            if (minibatch.m_endOfEpoch)
+                break;
+        }
+
+        BOOST_REQUIRE_EQUAL(numberOfSamples, sweepNumberOfSamples);
+        BOOST_REQUIRE_EQUAL(packer->NumberOfSamples(), sweepNumberOfSamples);
+        BOOST_REQUIRE(packer->NumberOfPaddedSamples() * 3 < packer->NumberOfPaddedSamplesWithoutBucketing() * 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BucketingSequencePackerChangingMinibatchSize)
+{
+    size_t chunkSizeInSamples = 998;
+    size_t sweepNumberOfSamples = 21335;
+    uint32_t maxSequenceLength = 30;
+    size_t randomizationWindow = chunkSizeInSamples * 5;
+    size_t bucketingWindow = 8;
+
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, maxSequenceLength);
+    auto blockRandomizer = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true);
+    auto packer = std::make_shared<BucketingSequencePacker>(blockRandomizer, deserializer->StreamInfos(), bucketingWindow, 1, true);
+    std::vector<MemoryProviderPtr> memoryProviders { std::make_shared<HeapMemoryProvider>() };
+
+    EpochConfiguration config;
+    config.m_numberOfWorkers = 1;
+    config.m_workerRank = 0;
+    config.m_minibatchSizeInSamples = 256;
+    config.m_truncationSize = 0;
+    config.m_epochIndex = 0;
+    config.m_totalEpochSizeInSamples = sweepNumberOfSamples;
+
+    packer->SetConfiguration(config, memoryProviders);
+    blockRandomizer->StartEpoch(config);
+
+    // Appends the keys of the sequences of the next minibatch, returns whether it ends the epoch.
+    auto readMinibatch = [&](size_t minibatchSize, std::vector<size_t>& keys)
+    {
+        auto minibatch = packer->ReadMinibatch();
+        if (!minibatch.m_data.empty())
+        {
+            auto layout = minibatch.m_data.front()->m_layout;
+            BOOST_REQUIRE(layout->GetActualNumSamples() <= minibatchSize);
+
+            auto data = (float*)minibatch.m_data.front()->m_data;
+            for (const auto& s : layout->GetAllSequences())
+            {
+                if (s.seqId != GAP_SEQUENCE_ID)
+                    keys.push_back((size_t)data[layout->GetNumParallelSequences() * s.tBegin + s.s]);
+            }
+        }
+        return minibatch.m_endOfEpoch;
+    };
+
+    // Read a part of the bucketing window...
+    std::vector<size_t> keys;
+    for (size_t i = 0; i < 3; ++i)
+        BOOST_REQUIRE(!readMinibatch(config.m_minibatchSizeInSamples, keys));
+
+    // ...then switch to a smaller minibatch size, which splits the pending minibatches.
+    ReaderConfiguration smallerConfig = config;
+    smallerConfig.m_minibatchSizeInSamples = 64;
+    blockRandomizer->SetConfiguration(smallerConfig);
+    packer->SetConfiguration(smallerConfig, memoryProviders);
+
+    // The state describes the pending window besides the randomizer position.
+    auto state = packer->GetState();
+    BOOST_REQUIRE(state.size() > 1);
+
+    std::vector<size_t> remainingKeys;
+    while (!readMinibatch(smallerConfig.m_minibatchSizeInSamples, remainingKeys));
+
+    // No sequence of the sweep is lost or returned twice.
+    std::vector<size_t> allKeys(keys);
+    allKeys.insert(allKeys.end(), remainingKeys.begin(), remainingKeys.end());
+    std::sort(allKeys.begin(), allKeys.end());
+    std::vector<size_t> expected;
+    for (const auto& s : deserializer->Corpus())
+        expected.push_back(s.first);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(expected.begin(), expected.end(), allKeys.begin(), allKeys.end());
+
+    // Restoring the state returns the same remaining sequences in the same order.
+    packer->SetState(state);
+    std::vector<size_t> restoredKeys;
+    while (!readMinibatch(smallerConfig.m_minibatchSizeInSamples, restoredKeys));
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(remainingKeys.begin(), remainingKeys.end(), restoredKeys.begin(), restoredKeys.end());
+}
+
 BOOST_AUTO_TEST_CASE(TestTruncatedBpttPacker)
 {
     size_t chunkSizeInSamples = 100;
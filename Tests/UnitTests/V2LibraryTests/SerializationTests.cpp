@@ -733,6 +733,30 @@ void TestLegacyModelSaving(const DeviceDescriptor& device)
     }
 }
 
+void TestMappableLegacyModelLoading(const DeviceDescriptor& device)
+{
+    auto inputVar = InputVariable({ 2 }, false, DataType::Float, L"features");
+    auto classifierOutput = BuildFFClassifierNet(inputVar, 3, device);
+
+    const wchar_t* modelFile = L"ff.mappable.legacy.model";
+    Internal::SaveAsLegacyModel(classifierOutput, modelFile, /*mappable =*/ true);
+    auto reloadedClassifierOutput = Function::Load(modelFile, device);
+
+    std::unordered_map<std::wstring, Parameter> reloadedParameters;
+    for (const auto& parameter : reloadedClassifierOutput->Parameters())
+        reloadedParameters.insert({ parameter.Uid(), parameter });
+
+    BOOST_TEST((reloadedParameters.size() == classifierOutput->Parameters().size()));
+    for (const auto& parameter : classifierOutput->Parameters())
+    {
+        auto reloadedParameter = reloadedParameters.find(parameter.Uid());
+        if (reloadedParameter == reloadedParameters.end())
+            BOOST_ERROR("TestMappableLegacyModelLoading: a parameter is missing from the reloaded function.");
+        else if (!AreEqual(parameter.Value(), reloadedParameter->second.Value()))
+            BOOST_ERROR("TestMappableLegacyModelLoading: original and reloaded parameters are not identical.");
+    }
+}
+
 void TestThatExceptionsAreRaisedForNonExistentPaths()
 {
     VerifyException([]() {
@@ -1022,6 +1046,11 @@ BOOST_AUTO_TEST_CASE(LegacyModelSavingInCPU)
     TestLegacyModelSaving(DeviceDescriptor::CPUDevice());
 }
 
+BOOST_AUTO_TEST_CASE(MappableLegacyModelLoadingInCPU)
+{
+    TestMappableLegacyModelLoading(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_CASE(CheckpointingWithStatefulNodesInCPU)
 {
     TestCheckpointingWithStatefulNodes(DeviceDescriptor::CPUDevice());
@@ -1081,6 +1110,12 @@ BOOST_AUTO_TEST_CASE(LegacyModelSavingInGPU)
         TestLegacyModelSaving(DeviceDescriptor::GPUDevice(0));
 }
 
+BOOST_AUTO_TEST_CASE(MappableLegacyModelLoadingInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestMappableLegacyModelLoading(DeviceDescriptor::GPUDevice(0));
+}
+
 BOOST_AUTO_TEST_CASE(CheckpointingWithStatefulNodesInGPU)
 {
     if (ShouldRunOnGpu())
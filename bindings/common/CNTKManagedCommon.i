@@ -368,11 +368,17 @@ IGNORE_FUNCTION CNTK::Internal::EnableForwardValuesSharing;
 IGNORE_FUNCTION CNTK::Internal::DisableForwardValuesSharing;
 IGNORE_FUNCTION CNTK::Internal::EnableGradientAccumulationOptimization;
 IGNORE_FUNCTION CNTK::Internal::DisableGradientAccumulationOptimization;
+IGNORE_FUNCTION CNTK::Internal::EnableCounterBasedCPURandomGenerator;
+IGNORE_FUNCTION CNTK::Internal::DisableCounterBasedCPURandomGenerator;
+IGNORE_FUNCTION CNTK::Internal::EnableApproximateCPUTranscendentals;
+IGNORE_FUNCTION CNTK::Internal::DisableApproximateCPUTranscendentals;
 %ignore CNTK::Internal::DefaultProfilerBufferSize;
 IGNORE_FUNCTION CNTK::Internal::StartProfiler;
 IGNORE_FUNCTION CNTK::Internal::StopProfiler;
 IGNORE_FUNCTION CNTK::Internal::EnableProfiler;
 IGNORE_FUNCTION CNTK::Internal::DisableProfiler;
+IGNORE_FUNCTION CNTK::Internal::EnableNodeProfiler;
+IGNORE_FUNCTION CNTK::Internal::DisableNodeProfiler;
 IGNORE_FUNCTION CNTK::Internal::AreEquivalent;
 IGNORE_FUNCTION CNTK::Internal::AreEqual;
 IGNORE_FUNCTION CNTK::Internal::PrintBuiltInfo;
@@ -81,7 +81,7 @@ At every stop the following information is given:
 ''' % DEBUG_USAGE
 
 
-def save_as_legacy_model(root_op, filename):
+def save_as_legacy_model(root_op, filename, mappable=False):
     '''
     Save the network of ``root_op`` in ``filename``.
     For debugging purposes only, very likely to be deprecated in the future.
@@ -89,8 +89,11 @@ def save_as_legacy_model(root_op, filename):
     Args:
         root_op (:class:`~cntk.ops.functions.Function`): op of the graph to save
         filename (str): filename to store the model in.
+        mappable (bool, default False): store the parameters page-aligned, so
+         that loading the model on the CPU maps them from the file instead of
+         reading them.
     '''
-    cntk_py.save_as_legacy_model(root_op, filename)
+    cntk_py.save_as_legacy_model(root_op, filename, mappable)
 
 
 class _DebugState(object):
@@ -41,3 +41,20 @@ def disable_profiler():
     cntk_py.disable_profiler()
 
 
+def enable_node_profiler():
+    '''
+    Enable timing of the forward and backward pass of every node in addition
+    to the regular profiler events. Takes effect while the profiler is enabled;
+    :func:`stop_profiler` then also writes a per-node summary and a trace that
+    can be loaded into ``chrome://tracing``.
+    '''
+    cntk_py.enable_node_profiler()
+
+
+def disable_node_profiler():
+    '''
+    Disable timing of individual nodes.
+    '''
+    cntk_py.disable_node_profiler()
+
+